@@ -30,8 +30,10 @@
 //
 // Introduces compiled materials and highlights differences between different compilation modes.
 
+#include <cstring>
 #include <iomanip>
 #include <iostream>
+#include <set>
 #include <sstream>
 #include <string>
 #include <algorithm>
@@ -298,6 +300,156 @@ void generate_hlsl(
     std::cout << code_hlsl->get_code() << std::endl;
 }
 
+// Translates the given compiled materials into one CUDA PTX link unit, splitting the optimized
+// code into at most the given number of partitions for code generation.
+const mi::neuraylib::ITarget_code* generate_cuda_ptx_link_unit(
+    mi::neuraylib::ITransaction* transaction,
+    mi::neuraylib::IMdl_backend_api* mdl_backend_api,
+    mi::neuraylib::IMdl_execution_context* context,
+    const std::vector<std::string>& compiled_material_names,
+    const char* num_codegen_partitions)
+{
+    mi::base::Handle<mi::neuraylib::IMdl_backend> be_cuda_ptx(
+        mdl_backend_api->get_backend(mi::neuraylib::IMdl_backend_api::MB_CUDA_PTX));
+    check_success(be_cuda_ptx.is_valid_interface());
+
+    check_success(be_cuda_ptx->set_option( "num_texture_spaces", "16") == 0);
+    check_success(be_cuda_ptx->set_option( "sm_version", "50") == 0);
+    check_success(
+        be_cuda_ptx->set_option( "num_codegen_partitions", num_codegen_partitions) == 0);
+
+    mi::base::Handle<mi::neuraylib::ILink_unit> link_unit(
+        be_cuda_ptx->create_link_unit( transaction, context));
+    check_success(print_messages( context));
+
+    for (size_t i = 0; i < compiled_material_names.size(); ++i) {
+        mi::base::Handle<const mi::neuraylib::ICompiled_material> compiled_material(
+            transaction->access<mi::neuraylib::ICompiled_material>(
+                compiled_material_names[i].c_str()));
+        check_success(compiled_material.is_valid_interface());
+
+        // the base function names must be unique within the link unit
+        std::string prefix = "material_" + std::to_string(i) + "_";
+        std::string names[] = {
+            prefix + "init", prefix + "scattering", prefix + "emission",
+            prefix + "thin_walled", prefix + "cutout_opacity" };
+        mi::neuraylib::Target_function_description descs[] = {
+            mi::neuraylib::Target_function_description( "init", names[0].c_str()),
+            mi::neuraylib::Target_function_description( "surface.scattering", names[1].c_str()),
+            mi::neuraylib::Target_function_description( "surface.emission.emission",
+                names[2].c_str()),
+            mi::neuraylib::Target_function_description( "thin_walled", names[3].c_str()),
+            mi::neuraylib::Target_function_description( "geometry.cutout_opacity",
+                names[4].c_str()) };
+
+        check_success(link_unit->add_material(
+            compiled_material.get(), descs, sizeof( descs) / sizeof( descs[0]), context) == 0);
+        check_success(print_messages( context));
+    }
+
+    const mi::neuraylib::ITarget_code* code_cuda_ptx
+        = be_cuda_ptx->translate_link_unit( link_unit.get(), context);
+    check_success(print_messages( context));
+    check_success(code_cuda_ptx);
+    return code_cuda_ptx;
+}
+
+// Returns the names of all functions and variables visible outside of the given PTX code.
+std::set<std::string> get_visible_ptx_symbols( const char* code)
+{
+    std::set<std::string> symbols;
+    std::istringstream lines( code);
+    std::string line;
+    while (std::getline( lines, line)) {
+        if (line.compare( 0, 9, ".visible ") != 0)
+            continue;
+
+        size_t pos = line.find( ".func ");
+        if (pos == std::string::npos)
+            pos = line.find( ".entry ");
+        if (pos != std::string::npos) {
+            // skip the directive and the return value parameter, if any
+            pos = line.find_first_not_of( ' ', line.find( ' ', pos));
+            if (pos != std::string::npos && line[pos] == '(') {
+                pos = line.find( ')', pos);
+                if (pos != std::string::npos)
+                    pos = line.find_first_not_of( ' ', pos + 1);
+            }
+            if (pos != std::string::npos)
+                symbols.insert( line.substr( pos, line.find_first_of( " \t(", pos) - pos));
+        } else {
+            // a variable: the name precedes the array size, the initializer, or the semicolon
+            std::string decl = line.substr( 0, line.find_first_of( "[=;"));
+            size_t last = decl.find_last_not_of( " \t");
+            size_t first = decl.find_last_of( " \t", last);
+            symbols.insert( decl.substr( first + 1, last - first));
+        }
+    }
+    return symbols;
+}
+
+// Checks that generating the PTX code of a link unit with several materials in parallel
+// partitions yields the same functions, resources, data, and visible symbols as generating it
+// in one piece.
+void check_cuda_ptx_partitioning(
+    mi::neuraylib::ITransaction* transaction,
+    mi::neuraylib::IMdl_backend_api* mdl_backend_api,
+    mi::neuraylib::IMdl_execution_context* context,
+    const std::vector<std::string>& compiled_material_names)
+{
+    mi::base::Handle<const mi::neuraylib::ITarget_code> unsplit(
+        generate_cuda_ptx_link_unit(
+            transaction, mdl_backend_api, context, compiled_material_names, "1"));
+    mi::base::Handle<const mi::neuraylib::ITarget_code> split(
+        generate_cuda_ptx_link_unit(
+            transaction, mdl_backend_api, context, compiled_material_names, "4"));
+
+    mi::Size n = unsplit->get_callable_function_count();
+    check_success(split->get_callable_function_count() == n);
+    for (mi::Size i = 0; i < n; ++i) {
+        check_success(
+            strcmp( split->get_callable_function( i), unsplit->get_callable_function( i)) == 0);
+        check_success(
+            split->get_callable_function_kind( i) == unsplit->get_callable_function_kind( i));
+        check_success(strcmp(
+            split->get_callable_function_prototype(
+                i, mi::neuraylib::ITarget_code::SL_PTX),
+            unsplit->get_callable_function_prototype(
+                i, mi::neuraylib::ITarget_code::SL_PTX)) == 0);
+        check_success(split->get_callable_function_argument_block_index( i)
+            == unsplit->get_callable_function_argument_block_index( i));
+    }
+
+    check_success(split->get_texture_count() == unsplit->get_texture_count());
+    for (mi::Size i = 0, m = unsplit->get_texture_count(); i < m; ++i) {
+        const char* split_name = split->get_texture( i);
+        const char* unsplit_name = unsplit->get_texture( i);
+        check_success((split_name == nullptr) == (unsplit_name == nullptr));
+        check_success(!split_name || strcmp( split_name, unsplit_name) == 0);
+    }
+
+    check_success(split->get_argument_block_count() == unsplit->get_argument_block_count());
+
+    check_success(split->get_ro_data_segment_count() == unsplit->get_ro_data_segment_count());
+    for (mi::Size i = 0, m = unsplit->get_ro_data_segment_count(); i < m; ++i) {
+        mi::Size size = unsplit->get_ro_data_segment_size( i);
+        check_success(split->get_ro_data_segment_size( i) == size);
+        check_success(memcmp( split->get_ro_data_segment_data( i),
+            unsplit->get_ro_data_segment_data( i), size) == 0);
+    }
+
+    // splitting must neither drop functions nor expose internal functions or variables
+    std::set<std::string> symbols = get_visible_ptx_symbols( unsplit->get_code());
+    check_success(get_visible_ptx_symbols( split->get_code()) == symbols);
+    for (mi::Size i = 0; i < n; ++i)
+        check_success(symbols.count( unsplit->get_callable_function( i)) == 1);
+
+    std::cout << "Generated CUDA PTX code for " << compiled_material_names.size()
+              << " materials with and without partitions: " << n << " functions, "
+              << symbols.size() << " visible symbols, identical interface." << std::endl
+              << std::endl;
+}
+
 
 void usage( char const *prog_name)
 {
@@ -438,6 +590,12 @@ int MAIN_UTF8(int argc, char* argv[])
                 transaction.get(), mdl_backend_api.get(), context.get(),
                 class_compilation_name.c_str(),
                 options.expr_path.c_str(), "tint");
+
+            // Compare the PTX code of a link unit with both materials generated with and
+            // without splitting it for parallel code generation.
+            check_cuda_ptx_partitioning(
+                transaction.get(), mdl_backend_api.get(), context.get(),
+                { instance_compilation_name, class_compilation_name });
         }
 
         transaction->commit();
@@ -447,6 +447,7 @@ struct Options {
     bool fold_ternary_on_df;
     bool enable_auxiliary_output;
     bool use_adapt_normal;
+    bool use_alias_tables;
     unsigned int res_x, res_y;
     unsigned int iterations;
     unsigned int samples_per_iteration;
@@ -474,6 +475,7 @@ struct Options {
     , fold_ternary_on_df(false)
     , enable_auxiliary_output(true)
     , use_adapt_normal(false)
+    , use_alias_tables(false)
     , res_x(1024)
     , res_y(1024)
     , iterations(4096)
@@ -1022,7 +1024,8 @@ static void render_scene(
     // Scope for material context resources
     {
         // Prepare the needed data of all target codes for the GPU
-        Material_gpu_context material_gpu_context(options.enable_derivatives);
+        Material_gpu_context material_gpu_context(
+            options.enable_derivatives, options.use_alias_tables);
         if (!material_gpu_context.prepare_target_code_data(
                 transaction.get(), image_api.get(), target_code.get(), arg_block_indices))
             terminate();
@@ -1978,6 +1981,8 @@ static void usage(const char *name)
         << "--nocc                      don't use class-compilation\n"
         << "--noaux                     don't generate code for albedo and normal buffers\n"
         << "--an                        use adapt normal function\n"
+        << "--alias_tables              sample measured BSDFs and light profiles with alias\n"
+        << "                            tables instead of binary searches in their CDFs\n"
         << "--gui_scale <factor>        GUI scaling factor (default: 1.0)\n"
         << "--res <res_x> <res_y>       resolution (default: 1024x1024)\n"
         << "--hdr <filename>            HDR environment map "
@@ -2080,6 +2085,8 @@ int MAIN_UTF8(int argc, char* argv[])
                 options.enable_derivatives = true;
             } else if (strcmp(opt, "--fold_ternary_on_df") == 0) {
                 options.fold_ternary_on_df = true;
+            } else if (strcmp(opt, "--alias_tables") == 0) {
+                options.use_alias_tables = true;
             } else if (strcmp(opt, "-v") == 0 || strcmp(opt, "--version") == 0) {
                 print_version_and_exit = true;
             } else {
@@ -30,6 +30,8 @@
 //
 // Simple CPU renderer using compiled BSDFs with a material parameter editor GUI.
 
+#include <algorithm>
+#include <chrono>
 #include <iomanip>
 #include <iostream>
 #define _USE_MATH_DEFINES
@@ -398,10 +400,19 @@ struct Options
     // Whether normals should be adapted.
     bool use_adapt_normal;
 
+    // Whether measured BSDFs and light profiles should be sampled with alias tables.
+    bool use_alias_tables;
+
     // Whether derivative support should be enabled.
     // This example does not support derivatives in combination with the custom texture runtime.
     bool enable_derivatives;
 
+    // Number of shading points for the BSDF throughput benchmark, 0 to render instead.
+    size_t bench_samples;
+
+    // Maximum number of threads for the BSDF throughput benchmark.
+    unsigned bench_threads;
+
     // Material to use.
     std::string material_name;
 
@@ -422,7 +433,10 @@ struct Options
         , use_class_compilation(false)
         , use_custom_tex_runtime(false)
         , use_adapt_normal(false)
+        , use_alias_tables(false)
         , enable_derivatives(false)
+        , bench_samples(0)
+        , bench_threads(std::max(std::thread::hardware_concurrency(), 1u))
     {}
 };
 
@@ -1000,6 +1014,7 @@ void generate_native(
     const char* compiled_material_name,
     bool use_custom_tex_runtime,
     bool use_adapt_normal,
+    bool use_alias_tables,
     bool enable_derivatives)
 {
     Timing timing("generate target code");
@@ -1109,6 +1124,9 @@ void generate_native(
     if (use_adapt_normal)
         check_success(be_native->set_option("use_renderer_adapt_normal", "on") == 0);
 
+    if (use_alias_tables)
+        check_success(be_native->set_option("use_alias_tables", "on") == 0);
+
 #ifdef ADD_EXTRA_TIMERS
     std::chrono::steady_clock::time_point t5 = std::chrono::steady_clock::now();
 #endif
@@ -1647,6 +1665,189 @@ void render_scene(
     }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// BSDF Throughput Benchmark
+///////////////////////////////////////////////////////////////////////////////
+
+// Runs the given workload and returns the number of shading points processed per second.
+template <typename F>
+double measure_throughput(size_t num_samples, size_t num_runs, F const &workload)
+{
+    workload(); // warm-up
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t run = 0; run < num_runs; ++run)
+        workload();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return double(num_samples * num_runs) / std::max(elapsed.count(), 1e-9);
+}
+
+// Random shading points on the sphere, seen from outside, with the input data for BSDF sampling
+// and evaluation.
+struct Bench_shading_points
+{
+    std::vector<Isect_info> points;
+    std::vector<mi::neuraylib::Shading_state_material> states;
+    std::vector<mi::neuraylib::Bsdf_sample_data> sample_data;
+    std::vector<mi::neuraylib::Bsdf_evaluate_data<mi::neuraylib::DF_HSM_NONE>> eval_data;
+
+    Bench_shading_points(Render_context &rc, size_t num_samples, unsigned seed)
+        : points(num_samples)
+        , states(num_samples, rc.shading_state)
+        , sample_data(num_samples)
+        , eval_data(num_samples)
+    {
+        for (size_t i = 0; i < num_samples; ++i)
+        {
+            const float z = 1.f - 2.f * rnd(seed);
+            const float r = sqrtf(std::max(0.f, 1.f - z * z));
+            const float phi = 2.f * Constants.PI * rnd(seed);
+            const mi::Float32_3 dir(r * cosf(phi), r * sinf(phi), z);
+
+            Render_context::Ray ray;
+            ray.p0 = rc.sphere.center + dir * (2.f * rc.sphere.radius);
+            ray.dir = -dir;
+            check_success(rc.isect(ray, rc.sphere, points[i]));
+
+            mi::neuraylib::Shading_state_material &state = states[i];
+            state.position = points[i].pos;
+            state.normal = points[i].normal;
+            state.geom_normal = points[i].normal;
+            state.text_coords = &points[i].uvw;
+            state.tangent_u = &points[i].tan_u;
+            state.tangent_v = &points[i].tan_v;
+
+            mi::neuraylib::Bsdf_sample_data &sample = sample_data[i];
+            sample.ior1 = mi::Float32_3(1.0f);
+            sample.ior2 = mi::Float32_3(MI_NEURAYLIB_BSDF_USE_MATERIAL_IOR);
+            sample.k1 = dir;
+            sample.xi.x = rnd(seed);
+            sample.xi.y = rnd(seed);
+            sample.xi.z = rnd(seed);
+            sample.xi.w = rnd(seed);
+
+            mi::neuraylib::Bsdf_evaluate_data<mi::neuraylib::DF_HSM_NONE> &eval = eval_data[i];
+            eval.ior1 = mi::Float32_3(1.0f);
+            eval.ior2 = mi::Float32_3(MI_NEURAYLIB_BSDF_USE_MATERIAL_IOR);
+            eval.k1 = dir;
+            eval.k2 = rc.omni_light.dir;
+        }
+    }
+
+    // Runs the BSDF init and sample functions for all shading points.
+    void sample(const Render_context &rc, mi::Size bsdf_function_index)
+    {
+        for (size_t i = 0, n = states.size(); i < n; ++i)
+        {
+            rc.target_code->execute_bsdf_init(
+                bsdf_function_index, states[i], rc.tex_handler, nullptr);
+            rc.target_code->execute_bsdf_sample(
+                bsdf_function_index + 1, &sample_data[i], states[i], rc.tex_handler, nullptr);
+        }
+    }
+
+    // Runs the BSDF init and evaluate functions for all shading points.
+    void evaluate(const Render_context &rc, mi::Size bsdf_function_index)
+    {
+        for (size_t i = 0, n = states.size(); i < n; ++i)
+        {
+            rc.target_code->execute_bsdf_init(
+                bsdf_function_index, states[i], rc.tex_handler, nullptr);
+            rc.target_code->execute_bsdf_evaluate(
+                bsdf_function_index + 2, &eval_data[i], states[i], rc.tex_handler, nullptr);
+        }
+    }
+};
+
+// Measures the BSDF execution functions of the target code on a single thread. Every shading
+// point runs the BSDF init function followed by either the sample or the evaluate function.
+void benchmark_bsdf(Render_context &rc, size_t num_samples)
+{
+    const size_t num_runs = 8;
+
+    const mi::Size init_index = rc.surface_bsdf_function_index;
+
+    Bench_shading_points sp(rc, num_samples, tea(16, 0, 0));
+
+    std::cout << "BSDF throughput on a single thread, " << num_samples << " shading points:\n";
+
+    const double sample_rate = measure_throughput(num_samples, num_runs,
+        [&]() { sp.sample(rc, init_index); });
+    const double eval_rate = measure_throughput(num_samples, num_runs,
+        [&]() { sp.evaluate(rc, init_index); });
+
+    std::cout << std::fixed << std::setprecision(2)
+        << "  sample " << std::setw(8) << sample_rate * 1e-6 << " M/s,"
+        << "  evaluate " << std::setw(8) << eval_rate * 1e-6 << " M/s\n";
+
+    // The sample weights estimate the directional albedo. Their variance only depends on the
+    // PDF, which allows to compare different sampling methods (e.g. with --alias_tables).
+    double weight_sum = 0.0, weight_sqr_sum = 0.0;
+    for (const mi::neuraylib::Bsdf_sample_data &sample : sp.sample_data)
+    {
+        double weight = 0.0;
+        if (sample.event_type != mi::neuraylib::BSDF_EVENT_ABSORB)
+            weight = (sample.bsdf_over_pdf.x + sample.bsdf_over_pdf.y + sample.bsdf_over_pdf.z)
+                / 3.0;
+        weight_sum += weight;
+        weight_sqr_sum += weight * weight;
+    }
+    const double weight_mean = weight_sum / double(num_samples);
+    const double weight_variance = weight_sqr_sum / double(num_samples) - weight_mean * weight_mean;
+    std::cout << std::setprecision(4)
+        << "  sample weights: mean " << weight_mean << ", variance " << weight_variance << "\n"
+        << std::setprecision(2) << std::endl;
+}
+
+// Measures the scaling of the scalar BSDF execution functions with the number of threads.
+// All threads shade against the same target code and textures, so for textured materials
+// this mostly measures concurrent texel lookups in the native texture runtime (unless the
+// custom texture runtime is used).
+void benchmark_bsdf_threads(Render_context &rc, size_t num_samples, unsigned num_threads)
+{
+    const size_t num_runs = 8;
+    const mi::Size init_index = rc.surface_bsdf_function_index;
+
+    std::cout << "BSDF sample throughput with 1 to " << num_threads << " threads, "
+        << num_samples << " shading points per thread:\n";
+
+    // powers of two up to the requested number of threads
+    std::vector<unsigned> thread_counts;
+    for (unsigned n = 1; n < num_threads; n *= 2)
+        thread_counts.push_back(n);
+    thread_counts.push_back(num_threads);
+
+    double single_thread_rate = 0.0;
+    for (unsigned n : thread_counts)
+    {
+        // every thread works on its own shading points
+        std::vector<Bench_shading_points> thread_points;
+        thread_points.reserve(n);
+        for (unsigned t = 0; t < n; ++t)
+            thread_points.emplace_back(rc, num_samples, tea(16, t, 1));
+
+        auto run_threads = [&]() {
+            std::vector<std::thread> threads;
+            for (unsigned t = 0; t < n; ++t)
+                threads.push_back(std::thread([&, t]() {
+                    thread_points[t].sample(rc, init_index);
+                }));
+            for (unsigned t = 0; t < n; ++t)
+                threads[t].join();
+        };
+
+        const double rate = measure_throughput(n * num_samples, num_runs, run_threads);
+        if (n == 1)
+            single_thread_rate = rate;
+
+        std::cout << std::fixed << std::setprecision(2)
+            << "  " << std::setw(3) << n << " threads: " << std::setw(8) << rate * 1e-6
+            << " M/s (" << rate / single_thread_rate << "x)\n";
+    }
+    std::cout << std::endl;
+}
+
 // Save current result image to disk
 static void save_screenshot(
     const mi::Float32_3* image_buffer,
@@ -1681,12 +1882,17 @@ void usage(char const *prog_name)
         << "  --cc                   use class compilation\n"
         << "  --cr                   use custom texture runtime\n"
         << "  --an                   use adapt normal function\n"
+        << "  --alias_tables         sample measured BSDFs and light profiles with alias tables\n"
         << "  --nogui                don't open interactive display\n"
         << "  --spp                  samples per pixel (default: 100) for output image when nogui\n"
         << "  -o <outputfile>        image file to write result to\n"
         << "                         (default: example_native.png)\n"
         << "  -oaux                  output albedo and normal auxiliary buffers.\n"
         << "  -p|--mdl_path <path>   mdl search path, can occur multiple times\n"
+        << "  --bench <n>            measure the BSDF throughput with <n> shading\n"
+        << "                         points instead of rendering\n"
+        << "  --bench_threads <n>    maximum number of threads for --bench\n"
+        << "                         (default: number of hardware threads)\n"
         << "\n"
         << "Viewport controls:\n"
         << "  Mouse               Camera rotation, zoom\n"
@@ -1717,6 +1923,14 @@ int MAIN_UTF8(int argc, char *argv[])
             {
                 options.no_gui = true;
             }
+            else if (strcmp(opt, "--bench") == 0 && i < argc - 1)
+            {
+                options.bench_samples = std::max(atoi(argv[++i]), 1);
+            }
+            else if (strcmp(opt, "--bench_threads") == 0 && i < argc - 1)
+            {
+                options.bench_threads = std::max(atoi(argv[++i]), 1);
+            }
             else if (strcmp(opt, "--spp") == 0 && i < argc - 1)
             {
                 options.iterations = std::max(atoi(argv[++i]), 1);
@@ -1777,6 +1991,10 @@ int MAIN_UTF8(int argc, char *argv[])
             {
                 options.use_adapt_normal = true;
             }
+            else if (strcmp(opt, "--alias_tables") == 0)
+            {
+                options.use_alias_tables = true;
+            }
             else if ((strcmp(opt, "--mdl_path") == 0 || strcmp(opt, "-p") == 0) &&
                 i < argc - 1)
             {
@@ -1895,6 +2113,7 @@ int MAIN_UTF8(int argc, char *argv[])
                 compilation_name.c_str(),
                 options.use_custom_tex_runtime,
                 options.use_adapt_normal,
+                options.use_alias_tables,
                 options.enable_derivatives);
         }
 
@@ -2015,8 +2234,14 @@ int MAIN_UTF8(int argc, char *argv[])
         rc.cam.focal = 1.0f / tanf(options.cam_fov * Constants.PI / 360.f);
         rc.update_camera(phi, theta, base_dist, window_context.zoom);
 
+        // measure BSDF throughput only?
+        if (options.bench_samples > 0)
+        {
+            benchmark_bsdf(rc, options.bench_samples);
+            benchmark_bsdf_threads(rc, options.bench_samples, options.bench_threads);
+        }
         // render to image?
-        if (options.no_gui)
+        else if (options.no_gui)
         {
             window_width = options.res_x;
             window_height = options.res_y;
@@ -0,0 +1,353 @@
+/******************************************************************************
+ * Copyright (c) 2022, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+
+// examples/mdl_sdk/images/example_images.cpp
+//
+// Measures the throughput of image processing in the MDL SDK: the creation of mipmaps, the
+// decoding of images, and the loading of UDIM sets.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "example_shared.h"
+
+#ifdef MI_PLATFORM_WINDOWS
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+#ifdef MI_PLATFORM_MACOSX
+#include <mach/mach.h>
+#endif
+
+// Returns the current resident memory of the process in bytes (0 if not available).
+size_t get_current_memory()
+{
+#if defined(MI_PLATFORM_WINDOWS)
+    PROCESS_MEMORY_COUNTERS counters;
+    if( !GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters)))
+        return 0;
+    return counters.WorkingSetSize;
+#elif defined(MI_PLATFORM_MACOSX)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if( task_info( mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t) &info, &count)
+        != KERN_SUCCESS)
+        return 0;
+    return info.resident_size;
+#else
+    FILE* file = fopen( "/proc/self/statm", "r");
+    if( !file)
+        return 0;
+    unsigned long size = 0;
+    unsigned long resident = 0;
+    int result = fscanf( file, "%lu %lu", &size, &resident);
+    fclose( file);
+    return result == 2 ? size_t( resident) * size_t( sysconf( _SC_PAGESIZE)) : 0;
+#endif
+}
+
+// Returns the peak resident memory of the process in bytes (0 if not available).
+size_t get_peak_memory()
+{
+#if defined(MI_PLATFORM_WINDOWS)
+    PROCESS_MEMORY_COUNTERS counters;
+    if( !GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters)))
+        return 0;
+    return counters.PeakWorkingSetSize;
+#else
+    struct rusage usage;
+    if( getrusage( RUSAGE_SELF, &usage) != 0)
+        return 0;
+#ifdef MI_PLATFORM_MACOSX
+    return size_t( usage.ru_maxrss);        // bytes
+#else
+    return size_t( usage.ru_maxrss) * 1024; // kilobytes
+#endif
+#endif
+}
+
+// Fills an RGBA canvas with a pattern that does not compress too well.
+void fill_pattern( mi::neuraylib::ICanvas* canvas)
+{
+    mi::Uint32 resolution_x = canvas->get_resolution_x();
+    mi::Uint32 resolution_y = canvas->get_resolution_y();
+    mi::base::Handle<mi::neuraylib::ITile> tile( canvas->get_tile());
+    mi::Uint8* data = static_cast<mi::Uint8*>( tile->get_data());
+    for( mi::Uint32 y = 0; y < resolution_y; ++y)
+        for( mi::Uint32 x = 0; x < resolution_x; ++x) {
+            mi::Uint8* pixel = data + 4 * (size_t( y) * resolution_x + x);
+            pixel[0] = mi::Uint8( x ^ y);
+            pixel[1] = mi::Uint8( x * 7 + y * 3);
+            pixel[2] = mi::Uint8( (x * y) >> 4);
+            pixel[3] = 255;
+        }
+}
+
+// Measures the creation of all miplevels of canvases of various pixel types and resolutions.
+void benchmark_mipmaps( mi::neuraylib::INeuray* neuray, mi::Uint32 max_resolution)
+{
+    mi::base::Handle<mi::neuraylib::IImage_api> image_api(
+        neuray->get_api_component<mi::neuraylib::IImage_api>());
+
+    const char* pixel_types[] = { "Rgba", "Rgb_16", "Color", "Float32" };
+
+    std::cout << "Benchmarking mipmap creation:" << std::endl;
+    for( mi::Uint32 resolution = 1024; resolution <= max_resolution; resolution *= 2)
+        for( const char* pixel_type: pixel_types) {
+
+            mi::base::Handle<mi::neuraylib::ICanvas> canvas(
+                image_api->create_canvas( pixel_type, resolution, resolution));
+            check_success( canvas.is_valid_interface());
+
+            // Use a gamma value different from 1.0 to include the conversion to linear space.
+            auto start = std::chrono::steady_clock::now();
+            mi::base::Handle<mi::IArray> mipmaps( image_api->create_mipmaps( canvas.get(), 2.2f));
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+            check_success( mipmaps.is_valid_interface());
+
+            double pixels = double( resolution) * double( resolution);
+            std::cout << "    " << resolution << "x" << resolution << " " << pixel_type << ": "
+                      << mipmaps->get_length() << " levels in " << elapsed.count() * 1e3
+                      << " ms, " << pixels / elapsed.count() / 1e6 << " M pixels/s" << std::endl;
+        }
+    std::cout << std::endl;
+}
+
+// Measures the decoding of images in various formats from memory buffers.
+//
+// Besides the throughput, the peak memory during decoding is reported, relative to the size of the
+// decoded canvas. Since the peak memory is tracked per process, the growth of the peak is only
+// known if a decoder exceeds the previous peak; otherwise an upper bound is reported.
+void benchmark_decode( mi::neuraylib::INeuray* neuray, mi::Uint32 resolution)
+{
+    mi::base::Handle<mi::neuraylib::IImage_api> image_api(
+        neuray->get_api_component<mi::neuraylib::IImage_api>());
+
+    mi::base::Handle<mi::neuraylib::ICanvas> canvas(
+        image_api->create_canvas( "Rgba", resolution, resolution));
+    check_success( canvas.is_valid_interface());
+    fill_pattern( canvas.get());
+
+    // Encode all buffers upfront, such that the encoders do not affect the peak memory below.
+    const char* formats[] = { "png", "jpg", "tif", "exr" };
+    std::vector<std::pair<const char*, mi::base::Handle<mi::neuraylib::IBuffer>>> buffers;
+    for( const char* format: formats) {
+        if( !image_api->supports_format_for_encoding( format)
+            || !image_api->supports_format_for_decoding( format))
+            continue;
+        mi::base::Handle<mi::neuraylib::IBuffer> buffer(
+            image_api->create_buffer_from_canvas( canvas.get(), format, "Rgba", "100"));
+        check_success( buffer.is_valid_interface());
+        buffers.emplace_back( format, buffer);
+    }
+    canvas = nullptr;
+
+    double pixels = double( resolution) * double( resolution);
+    double mib = 1024.0 * 1024.0;
+
+    std::cout << "Benchmarking image decoding (" << resolution << "x" << resolution
+              << " pixels):" << std::endl;
+    for( const auto& entry: buffers) {
+
+        size_t current = get_current_memory();
+        size_t previous_peak = get_peak_memory();
+
+        auto start = std::chrono::steady_clock::now();
+        mi::base::Handle<mi::neuraylib::ICanvas> decoded(
+            image_api->create_canvas_from_buffer( entry.second.get(), entry.first));
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        check_success( decoded.is_valid_interface());
+
+        size_t peak = get_peak_memory();
+        mi::base::Handle<const mi::neuraylib::ITile> tile( decoded->get_tile());
+        double canvas_size = double( tile->get_resolution_x()) * tile->get_resolution_y()
+            * image_api->get_components_per_pixel( tile->get_type())
+            * image_api->get_bytes_per_component( tile->get_type());
+
+        std::cout << "    " << entry.first << " (" << entry.second->get_data_size() / mib
+                  << " MiB encoded): " << elapsed.count() * 1e3 << " ms, "
+                  << pixels / elapsed.count() / 1e6 << " M pixels/s";
+        if( current > 0 && peak > 0) {
+            double growth = double( std::max( peak, current) - current);
+            std::cout << ", peak memory " << (peak > previous_peak ? "" : "<= ")
+                      << growth / mib << " MiB (" << growth / canvas_size
+                      << "x the decoded canvas)";
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+// Accesses the pixels of all uvtiles of frame 0 of an image, and returns the number of pixels.
+//
+// Lazily loaded images only read the file headers in reset_file(), the pixel data is decoded
+// when the tiles of a canvas are requested.
+mi::Size touch_pixels( const mi::neuraylib::IImage* image)
+{
+    mi::Size pixels = 0;
+    for( mi::Size i = 0, n = image->get_frame_length( 0); i < n; ++i) {
+        mi::base::Handle<const mi::neuraylib::ICanvas> canvas( image->get_canvas( 0, i, 0));
+        check_success( canvas.is_valid_interface());
+        for( mi::Uint32 z = 0; z < canvas->get_layers_size(); ++z) {
+            mi::base::Handle<const mi::neuraylib::ITile> tile( canvas->get_tile( z));
+            check_success( tile.is_valid_interface() && tile->get_data());
+            pixels += mi::Size( tile->get_resolution_x()) * tile->get_resolution_y();
+        }
+    }
+    return pixels;
+}
+
+// Measures the loading and decoding of a 10x10 UDIM set, compared to loading and decoding its
+// uvtiles one by one.
+//
+// The uvtiles are written as PNG files into the current working directory and removed afterwards.
+void benchmark_udim( mi::neuraylib::INeuray* neuray, mi::Uint32 resolution)
+{
+    mi::base::Handle<mi::neuraylib::IImage_api> image_api(
+        neuray->get_api_component<mi::neuraylib::IImage_api>());
+    mi::base::Handle<mi::neuraylib::IMdl_impexp_api> mdl_impexp_api(
+        neuray->get_api_component<mi::neuraylib::IMdl_impexp_api>());
+    mi::base::Handle<mi::neuraylib::IDatabase> database(
+        neuray->get_api_component<mi::neuraylib::IDatabase>());
+    mi::base::Handle<mi::neuraylib::IScope> scope( database->get_global_scope());
+
+    mi::base::Handle<mi::neuraylib::ICanvas> canvas(
+        image_api->create_canvas( "Rgba", resolution, resolution));
+    check_success( canvas.is_valid_interface());
+    fill_pattern( canvas.get());
+
+    // Write the uvtiles 1001 to 1100.
+    const mi::Uint32 n = 10;
+    std::vector<std::string> filenames;
+    for( mi::Uint32 v = 0; v < n; ++v)
+        for( mi::Uint32 u = 0; u < n; ++u) {
+            std::string filename
+                = "example_images_udim." + std::to_string( 1001 + u + 10 * v) + ".png";
+            check_success( mdl_impexp_api->export_canvas( filename.c_str(), canvas.get()) == 0);
+            filenames.push_back( filename);
+        }
+
+    double pixels = double( n * n) * double( resolution) * double( resolution);
+
+    std::cout << "Benchmarking UDIM loading (" << n << "x" << n << " uvtiles of "
+              << resolution << "x" << resolution << " pixels):" << std::endl;
+    {
+        mi::base::Handle<mi::neuraylib::ITransaction> transaction( scope->create_transaction());
+
+        // Load and decode every uvtile as an image of its own, i.e., one after the other.
+        auto start = std::chrono::steady_clock::now();
+        for( const std::string& filename: filenames) {
+            mi::base::Handle<mi::neuraylib::IImage> image(
+                transaction->create<mi::neuraylib::IImage>( "Image"));
+            check_success( image->reset_file( filename.c_str()) == 0);
+            check_success( touch_pixels( image.get()) == mi::Size( resolution) * resolution);
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "    single images: " << elapsed.count() * 1e3 << " ms, "
+                  << pixels / elapsed.count() / 1e6 << " M pixels/s" << std::endl;
+
+        // Load and decode all uvtiles as one UDIM set, the uvtiles are decoded in parallel by
+        // reset_file(), such that accessing the pixels afterwards finds them already decoded.
+        start = std::chrono::steady_clock::now();
+        mi::base::Handle<mi::neuraylib::IImage> image(
+            transaction->create<mi::neuraylib::IImage>( "Image"));
+        check_success( image->reset_file( "example_images_udim.<UDIM>.png") == 0);
+        check_success( image->get_frame_length( 0) == n * n);
+        check_success( touch_pixels( image.get()) == mi::Size( pixels));
+        elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "    UDIM set:      " << elapsed.count() * 1e3 << " ms, "
+                  << pixels / elapsed.count() / 1e6 << " M pixels/s" << std::endl;
+
+        transaction->abort();
+    }
+    std::cout << std::endl;
+
+    for( const std::string& filename: filenames)
+        std::remove( filename.c_str());
+}
+
+int MAIN_UTF8( int argc, char* argv[])
+{
+    // Parse command line options
+    mi::Uint32 max_resolution = 2048;
+    mi::Uint32 decode_resolution = 4096;
+    mi::Uint32 udim_resolution = 1024;
+    for( int i = 1; i < argc; ++i) {
+        if( strcmp( argv[i], "--mipmaps") == 0 && i < argc - 1) {
+            max_resolution = std::max( atoi( argv[++i]), 1024);
+        } else if( strcmp( argv[i], "--decode") == 0 && i < argc - 1) {
+            decode_resolution = std::max( atoi( argv[++i]), 1);
+        } else if( strcmp( argv[i], "--udim") == 0 && i < argc - 1) {
+            udim_resolution = std::max( atoi( argv[++i]), 1);
+        } else {
+            std::cout << "Usage: example_images [--mipmaps <max_resolution>] "
+                      << "[--decode <resolution>] [--udim <uvtile_resolution>]" << std::endl;
+            exit_failure( "Unknown option \"%s\".", argv[i]);
+        }
+    }
+
+    // Access the MDL SDK
+    mi::base::Handle<mi::neuraylib::INeuray> neuray( mi::examples::mdl::load_and_get_ineuray());
+    if( !neuray.is_valid_interface())
+        exit_failure( "Failed to load the SDK.");
+
+    // Configure the MDL SDK
+    if( !mi::examples::mdl::configure( neuray.get()))
+        exit_failure( "Failed to initialize the SDK.");
+
+    // Start the MDL SDK
+    mi::Sint32 ret = neuray->start();
+    if( ret != 0)
+        exit_failure( "Failed to initialize the SDK. Result code: %d", ret);
+
+    benchmark_mipmaps( neuray.get(), max_resolution);
+    benchmark_decode( neuray.get(), decode_resolution);
+    benchmark_udim( neuray.get(), udim_resolution);
+
+    // Shut down the MDL SDK
+    if( neuray->shutdown() != 0)
+        exit_failure( "Failed to shutdown the SDK.");
+
+    // Unload the MDL SDK
+    neuray = nullptr;
+    if( !mi::examples::mdl::unload())
+        exit_failure( "Failed to unload the SDK.");
+
+    exit_success();
+}
+
+// Convert command line arguments to UTF8 on Windows
+COMMANDLINE_TO_UTF8
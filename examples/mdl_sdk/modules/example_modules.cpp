@@ -30,8 +30,14 @@
 //
 // Loads an MDL module and inspects it contents.
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <iostream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "example_shared.h"
 
@@ -274,8 +280,163 @@ void load_module( mi::neuraylib::INeuray* neuray)
     transaction->commit();
 }
 
-int MAIN_UTF8( int /*argc*/, char* /*argv*/[])
+// Measures the throughput of concurrent access() and release() calls on the function definitions
+// of the module loaded by load_module(). Each thread uses its own transaction.
+void benchmark_access( mi::neuraylib::INeuray* neuray, mi::Uint32 max_threads)
 {
+    const mi::Size iterations = 2000;
+
+    mi::base::Handle<mi::neuraylib::IDatabase> database(
+        neuray->get_api_component<mi::neuraylib::IDatabase>());
+    mi::base::Handle<mi::neuraylib::IScope> scope( database->get_global_scope());
+
+    // Collect the DB names of all function definitions of the module.
+    std::vector<std::string> names;
+    {
+        mi::base::Handle<mi::neuraylib::ITransaction> transaction( scope->create_transaction());
+        mi::base::Handle<const mi::neuraylib::IModule> module(
+            transaction->access<mi::neuraylib::IModule>( "mdl::nvidia::sdk_examples::tutorials"));
+        check_success( module.is_valid_interface());
+        for( mi::Size i = 0, n = module->get_function_count(); i < n; ++i)
+            names.push_back( module->get_function( i));
+        transaction->commit();
+    }
+    check_success( !names.empty());
+
+    // Run with 1, 2, 4, ... threads, and finally with the requested number of threads.
+    std::vector<mi::Uint32> thread_counts;
+    for( mi::Uint32 n = 1; n < max_threads; n *= 2)
+        thread_counts.push_back( n);
+    thread_counts.push_back( max_threads);
+
+    std::cout << "Benchmarking access/release of " << names.size()
+              << " function definitions:" << std::endl;
+    for( mi::Uint32 num_threads: thread_counts) {
+
+        auto worker = [&]() {
+            mi::base::Handle<mi::neuraylib::ITransaction> transaction(
+                scope->create_transaction());
+            for( mi::Size i = 0; i < iterations; ++i)
+                for( const std::string& name: names) {
+                    mi::base::Handle<const mi::neuraylib::IFunction_definition> definition(
+                        transaction->access<mi::neuraylib::IFunction_definition>( name.c_str()));
+                    check_success( definition.is_valid_interface());
+                }
+            transaction->commit();
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for( mi::Uint32 t = 0; t < num_threads; ++t)
+            threads.emplace_back( worker);
+        for( std::thread& thread: threads)
+            thread.join();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        double accesses = double( num_threads) * double( iterations) * double( names.size());
+        std::cout << "    " << num_threads << " thread(s): "
+                  << accesses / elapsed.count() / 1e6 << " M accesses/s" << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+// Measures the throughput of concurrent name lookups via access() while another thread keeps
+// storing new named elements and committing its transactions. Each reader thread uses its own transaction.
+void benchmark_lookups( mi::neuraylib::INeuray* neuray, mi::Uint32 max_threads)
+{
+    const mi::Size iterations = 2000;
+
+    mi::base::Handle<mi::neuraylib::IDatabase> database(
+        neuray->get_api_component<mi::neuraylib::IDatabase>());
+    mi::base::Handle<mi::neuraylib::IScope> scope( database->get_global_scope());
+
+    // Collect the DB names of all function definitions of the module.
+    std::vector<std::string> names;
+    {
+        mi::base::Handle<mi::neuraylib::ITransaction> transaction( scope->create_transaction());
+        mi::base::Handle<const mi::neuraylib::IModule> module(
+            transaction->access<mi::neuraylib::IModule>( "mdl::nvidia::sdk_examples::tutorials"));
+        check_success( module.is_valid_interface());
+        for( mi::Size i = 0, n = module->get_function_count(); i < n; ++i)
+            names.push_back( module->get_function( i));
+        transaction->commit();
+    }
+    check_success( !names.empty());
+
+    // Run with 1, 2, 4, ... threads, and finally with the requested number of threads.
+    std::vector<mi::Uint32> thread_counts;
+    for( mi::Uint32 n = 1; n < max_threads; n *= 2)
+        thread_counts.push_back( n);
+    thread_counts.push_back( max_threads);
+
+    std::cout << "Benchmarking name lookups of " << names.size()
+              << " function definitions with a concurrent writer:" << std::endl;
+    mi::Size next_element = 0;
+    for( mi::Uint32 num_threads: thread_counts) {
+
+        // The writer stores one new named element per transaction until the readers are done.
+        std::atomic<bool> readers_done( false);
+        mi::Size commits = 0;
+        auto writer = [&]() {
+            while( !readers_done) {
+                mi::base::Handle<mi::neuraylib::ITransaction> transaction(
+                    scope->create_transaction());
+                mi::base::Handle<mi::neuraylib::IImage> image(
+                    transaction->create<mi::neuraylib::IImage>( "Image"));
+                std::string name = "benchmark_lookups_image_" + std::to_string( next_element++);
+                check_success( transaction->store( image.get(), name.c_str()) == 0);
+                transaction->commit();
+                ++commits;
+            }
+        };
+
+        auto reader = [&]() {
+            mi::base::Handle<mi::neuraylib::ITransaction> transaction(
+                scope->create_transaction());
+            for( mi::Size i = 0; i < iterations; ++i)
+                for( const std::string& name: names) {
+                    mi::base::Handle<const mi::base::IInterface> element(
+                        transaction->access( name.c_str()));
+                    check_success( element.is_valid_interface());
+                }
+            transaction->commit();
+        };
+
+        std::thread writer_thread( writer);
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads;
+        for( mi::Uint32 t = 0; t < num_threads; ++t)
+            threads.emplace_back( reader);
+        for( std::thread& thread: threads)
+            thread.join();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        readers_done = true;
+        writer_thread.join();
+
+        double lookups = double( num_threads) * double( iterations) * double( names.size());
+        std::cout << "    " << num_threads << " thread(s): "
+                  << lookups / elapsed.count() / 1e6 << " M lookups/s, "
+                  << commits / elapsed.count() << " commits/s" << std::endl;
+    }
+    std::cout << std::endl;
+}
+
+int MAIN_UTF8( int argc, char* argv[])
+{
+    // Parse command line options
+    mi::Uint32 bench_threads = 0;
+    bool track_elements = false;
+    for( int i = 1; i < argc; ++i) {
+        if( strcmp( argv[i], "--bench") == 0 && i < argc - 1) {
+            bench_threads = std::max( atoi( argv[++i]), 1);
+        } else if( strcmp( argv[i], "--track") == 0) {
+            track_elements = true;
+        } else {
+            std::cout << "Usage: example_modules [--bench <threads>] [--track]" << std::endl;
+            exit_failure( "Unknown option \"%s\".", argv[i]);
+        }
+    }
+
     // Access the MDL SDK
     mi::base::Handle<mi::neuraylib::INeuray> neuray(mi::examples::mdl::load_and_get_ineuray());
     if (!neuray.is_valid_interface())
@@ -285,6 +446,14 @@ int MAIN_UTF8( int /*argc*/, char* /*argv*/[])
     if (!mi::examples::mdl::configure(neuray.get()))
         exit_failure("Failed to initialize the SDK.");
 
+    // Tracking of DB elements in use by the API is disabled by default in release builds.
+    if( bench_threads > 0) {
+        mi::base::Handle<mi::neuraylib::IDebug_configuration> debug_configuration(
+            neuray->get_api_component<mi::neuraylib::IDebug_configuration>());
+        debug_configuration->set_option(
+            track_elements ? "db_element_tracking=1" : "db_element_tracking=0");
+    }
+
     // Start the MDL SDK
     mi::Sint32 ret = neuray->start();
     if (ret != 0)
@@ -293,6 +462,12 @@ int MAIN_UTF8( int /*argc*/, char* /*argv*/[])
     // Load an MDL module and dump its contents
     load_module( neuray.get());
 
+    // Optionally, measure the throughput of concurrent DB accesses
+    if( bench_threads > 0) {
+        benchmark_access( neuray.get(), bench_threads);
+        benchmark_lookups( neuray.get(), bench_threads);
+    }
+
     // Shut down the MDL SDK
     if (neuray->shutdown() != 0)
         exit_failure("Failed to shutdown the SDK.");
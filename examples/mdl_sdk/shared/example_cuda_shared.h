@@ -70,6 +70,9 @@ struct Texture
     float3               inv_size;           // the inverse values of the size of the texture
 };
 
+// Entry of an alias table for sampling a discrete distribution in constant time.
+typedef mi::neuraylib::Alias_table_entry Alias_entry;
+
 // Structure representing an MDL bsdf measurement.
 struct Mbsdf
 {
@@ -79,6 +82,7 @@ struct Mbsdf
             has_data[i] = 0u;
             eval_data[i] = 0;
             sample_data[i] = 0;
+            alias_data[i] = 0;
             albedo_data[i] = 0;
             this->max_albedo[i] = 0.0f;
             angular_resolution[i] = make_uint2(0u, 0u);
@@ -104,6 +108,7 @@ struct Mbsdf
     cudaTextureObject_t eval_data[2];           // uses filter mode cudaFilterModeLinear
     float               max_albedo[2];          // max albedo used to limit the multiplier
     float*              sample_data[2];         // CDFs for sampling a BSDF measurement
+    Alias_entry*        alias_data[2];          // optional alias tables for the CDFs above
     float*              albedo_data[2];         // max albedo for each theta (isotropic)
 
     uint2           angular_resolution[2];      // size of the dataset, needed for texel access
@@ -122,7 +127,8 @@ struct Lightprofile
         float               candela_multiplier = 0.0f,
         float               total_power = 0.0f,
         cudaTextureObject_t eval_data = 0,
-        float               *cdf_data = nullptr)
+        float               *cdf_data = nullptr,
+        Alias_entry         *alias_data = nullptr)
     : angular_resolution(angular_resolution)
     , inv_angular_resolution(make_float2(
         1.0f / float(angular_resolution.x),
@@ -134,6 +140,7 @@ struct Lightprofile
     , total_power(total_power)
     , eval_data(eval_data)
     , cdf_data(cdf_data)
+    , alias_data(alias_data)
     {
         theta_phi_inv_delta.x = theta_phi_delta.x ? (1.f / theta_phi_delta.x) : 0.f;
         theta_phi_inv_delta.y = theta_phi_delta.y ? (1.f / theta_phi_delta.y) : 0.f;
@@ -149,6 +156,7 @@ struct Lightprofile
 
     cudaTextureObject_t eval_data;          // normalized data sampled on grid
     float*              cdf_data;           // CDFs for sampling a light profile
+    Alias_entry*        alias_data;         // optional alias tables for the CDFs above
 };
 
 // Structure representing the resources used by the generated code of a target code.
@@ -382,6 +390,9 @@ template<> struct Resource_deleter<Mbsdf> {
             if (res.has_data[i] != 0u) {
                 check_cuda_success(cudaDestroyTextureObject(res.eval_data[i]));
                 check_cuda_success(cuMemFree(reinterpret_cast<CUdeviceptr>(res.sample_data[i])));
+                if (res.alias_data[i])
+                    check_cuda_success(
+                        cuMemFree(reinterpret_cast<CUdeviceptr>(res.alias_data[i])));
                 check_cuda_success(cuMemFree(reinterpret_cast<CUdeviceptr>(res.albedo_data[i])));
             }
         }
@@ -392,6 +403,8 @@ template<> struct Resource_deleter<Lightprofile> {
     void operator()(Lightprofile res) {
         if (res.cdf_data)
             check_cuda_success(cuMemFree((CUdeviceptr)res.cdf_data));
+        if (res.alias_data)
+            check_cuda_success(cuMemFree((CUdeviceptr)res.alias_data));
     }
 };
 
@@ -509,8 +522,9 @@ CUdeviceptr gpu_mem_dup(Resource_container<T,C> const &cont)
 class Material_gpu_context
 {
 public:
-    Material_gpu_context(bool enable_derivatives)
+    Material_gpu_context(bool enable_derivatives, bool use_alias_tables = false)
         : m_enable_derivatives(enable_derivatives)
+        , m_use_alias_tables(use_alias_tables)
         , m_device_target_code_data_list(0)
         , m_device_target_argument_block_list(0)
     {
@@ -605,6 +619,9 @@ private:
     // If true, mipmaps will be generated for all 2D textures.
     bool m_enable_derivatives;
 
+    // If true, alias tables are built for sampling BSDF measurements and light profiles.
+    bool m_use_alias_tables;
+
     // The device pointer of the target code data list.
     Resource_handle<CUdeviceptr> m_device_target_code_data_list;
 
@@ -858,8 +875,19 @@ bool Material_gpu_context::prepare_texture(
 
 namespace
 {
+    // Copies the alias tables provided by the target code to the GPU.
+    Alias_entry* copy_alias_tables_to_gpu(const mi::neuraylib::IBuffer* alias_tables)
+    {
+        CUdeviceptr alias_obj = 0;
+        check_cuda_success(cuMemAlloc(&alias_obj, alias_tables->get_data_size()));
+        check_cuda_success(cuMemcpyHtoD(
+            alias_obj, alias_tables->get_data(), alias_tables->get_data_size()));
+        return reinterpret_cast<Alias_entry*>(alias_obj);
+    }
+
     bool prepare_mbsdfs_part(mi::neuraylib::Mbsdf_part part, Mbsdf& mbsdf_cuda_representation,
-                             const mi::neuraylib::IBsdf_measurement* bsdf_measurement)
+                             const mi::neuraylib::IBsdf_measurement* bsdf_measurement,
+                             const mi::neuraylib::IBuffer* alias_tables)
     {
         mi::base::Handle<const mi::neuraylib::Bsdf_isotropic_data> dataset;
         switch (part)
@@ -982,6 +1010,11 @@ namespace
             }
         }
 
+        // optionally, use the alias tables of the SDK, which have the same layout as the CDFs
+        // and allow to select theta_out and phi_out in constant time
+        if (alias_tables)
+            mbsdf_cuda_representation.alias_data[part] = copy_alias_tables_to_gpu(alias_tables);
+
         // copy entire CDF data buffer to GPU
         CUdeviceptr sample_obj = 0;
         check_cuda_success(cuMemAlloc(&sample_obj, sample_data_size * sizeof(float)));
@@ -1092,10 +1125,17 @@ bool Material_gpu_context::prepare_mbsdf(
     Mbsdf mbsdf_cuda;
 
     // handle reflection and transmission
-    if (!prepare_mbsdfs_part(mi::neuraylib::MBSDF_DATA_REFLECTION, mbsdf_cuda, mbsdf.get()))
-        return false;
-    if (!prepare_mbsdfs_part(mi::neuraylib::MBSDF_DATA_TRANSMISSION, mbsdf_cuda, mbsdf.get()))
-        return false;
+    for (mi::neuraylib::Mbsdf_part part :
+            { mi::neuraylib::MBSDF_DATA_REFLECTION, mi::neuraylib::MBSDF_DATA_TRANSMISSION })
+    {
+        mi::base::Handle<const mi::neuraylib::IBuffer> alias_tables;
+        if (m_use_alias_tables)
+            alias_tables = code_ptx->get_bsdf_measurement_alias_tables(
+                transaction, mbsdf_index, part);
+
+        if (!prepare_mbsdfs_part(part, mbsdf_cuda, mbsdf.get(), alias_tables.get()))
+            return false;
+    }
 
     mbsdfs.push_back(mbsdf_cuda);
     m_all_mbsdfs->push_back(mbsdfs.back());
@@ -1180,6 +1220,17 @@ bool Material_gpu_context::prepare_lightprofile(
 
     cdf_data[res.x - 2] = 1.0f;
 
+    // optionally, use the alias tables of the SDK, which have the same layout as the CDFs and
+    // allow to select theta and phi in constant time
+    Alias_entry* alias_data_obj = nullptr;
+    if (m_use_alias_tables)
+    {
+        mi::base::Handle<const mi::neuraylib::IBuffer> alias_tables(
+            code_ptx->get_light_profile_alias_tables(transaction, lightprofile_index));
+        if (alias_tables)
+            alias_data_obj = copy_alias_tables_to_gpu(alias_tables.get());
+    }
+
     // copy entire CDF data buffer to GPU
     CUdeviceptr cdf_data_obj = 0;
     check_cuda_success(cuMemAlloc(&cdf_data_obj, cdf_data_size * sizeof(float)));
@@ -1229,7 +1280,8 @@ bool Material_gpu_context::prepare_lightprofile(
         float(multiplier),
         float(total_power * multiplier),
         tex_obj,
-        reinterpret_cast<float*>(cdf_data_obj));
+        reinterpret_cast<float*>(cdf_data_obj),
+        alias_data_obj);
 
     lightprofiles.push_back(lprof);
     m_all_lightprofiles->push_back(lightprofiles.back());
@@ -85,6 +85,9 @@ struct Texture
     float3               inv_size;           // the inverse values of the size of the texture
 };
 
+// Entry of an alias table for sampling a discrete distribution in constant time.
+typedef mi::neuraylib::Alias_table_entry                   Alias_entry;
+
 // Custom structure representing an MDL BSDF measurement.
 struct Mbsdf
 {
@@ -92,6 +95,7 @@ struct Mbsdf
     cudaTextureObject_t eval_data[2];           // uses filter mode cudaFilterModeLinear
     float               max_albedo[2];          // max albedo used to limit the multiplier
     float*              sample_data[2];         // CDFs for sampling a BSDF measurement
+    Alias_entry*        alias_data[2];          // optional alias tables for the CDFs above
     float*              albedo_data[2];         // max albedo for each theta (isotropic)
 
     uint2           angular_resolution[2];      // size of the dataset, needed for texel access
@@ -111,6 +115,8 @@ struct Lightprofile
         , candela_multiplier(0.0f)
         , total_power(0.0f)
         , eval_data(0)
+        , cdf_data(nullptr)
+        , alias_data(nullptr)
     {
     }
 
@@ -124,6 +130,7 @@ struct Lightprofile
 
     cudaTextureObject_t eval_data;          // normalized data sampled on grid
     float*              cdf_data;           // CDFs for sampling a light profile
+    Alias_entry*        alias_data;         // optional alias tables for the CDFs above
 };
 
 
@@ -719,6 +726,27 @@ __device__ inline unsigned sample_cdf(
     return m;
 }
 
+// selection through an alias table, the random number is rescaled for re-usage
+__device__ inline unsigned sample_alias_table(
+    const Alias_entry* table,
+    unsigned table_size,
+    float& xi)
+{
+    const float x = xi * float(table_size);
+    const unsigned idx = min(unsigned(x), table_size - 1);
+    const float f = x - float(idx);
+
+    const Alias_entry entry = table[idx];
+    if (f < entry.q || entry.q >= 1.0f)
+    {
+        xi = f / entry.q;
+        return idx;
+    }
+
+    xi = (f - entry.q) / (1.0f - entry.q);
+    return entry.alias;
+}
+
 
 // Implementation of df::light_profile_evaluate() for a light profile.
 extern "C" __device__ float df_light_profile_evaluate(
@@ -781,32 +809,61 @@ extern "C" __device__ void df_light_profile_sample(
     //-------------------------------------------
     float xi0 = xi[0];
     const float* cdf_data_theta = lp.cdf_data;                          // CDF theta
-    unsigned idx_theta = sample_cdf(cdf_data_theta, res.x - 1, xi0);    // binary search
+    unsigned idx_theta;
+    float prob_theta;
+    if (lp.alias_data)
+    {
+        idx_theta = sample_alias_table(lp.alias_data, res.x - 1, xi0);  // table lookup
 
-    float prob_theta = cdf_data_theta[idx_theta];
-    if (idx_theta > 0)
+        prob_theta = cdf_data_theta[idx_theta];
+        if (idx_theta > 0)
+            prob_theta -= cdf_data_theta[idx_theta - 1];
+    }
+    else
     {
-        const float tmp = cdf_data_theta[idx_theta - 1];
-        prob_theta -= tmp;
-        xi0 -= tmp;
+        idx_theta = sample_cdf(cdf_data_theta, res.x - 1, xi0);         // binary search
+
+        prob_theta = cdf_data_theta[idx_theta];
+        if (idx_theta > 0)
+        {
+            const float tmp = cdf_data_theta[idx_theta - 1];
+            prob_theta -= tmp;
+            xi0 -= tmp;
+        }
+        xi0 /= prob_theta;  // rescale for re-usage
     }
-    xi0 /= prob_theta;  // rescale for re-usage
 
     // sample phi_out
     //-------------------------------------------
     float xi1 = xi[1];
-    const float* cdf_data_phi = cdf_data_theta + (res.x - 1)            // CDF theta block
+    const unsigned offset_phi = (res.x - 1)                             // CDF theta block
                               + (idx_theta * (res.y - 1));              // selected CDF for phi
+    const float* cdf_data_phi = cdf_data_theta + offset_phi;
 
-    const unsigned idx_phi = sample_cdf(cdf_data_phi, res.y - 1, xi1);        // binary search
-    float prob_phi = cdf_data_phi[idx_phi];
-    if (idx_phi > 0)
+    unsigned idx_phi;
+    float prob_phi;
+    if (lp.alias_data)
     {
-        const float tmp = cdf_data_phi[idx_phi - 1];
-        prob_phi -= tmp;
-        xi1 -= tmp;
+        idx_phi = sample_alias_table(                                   // table lookup
+            lp.alias_data + offset_phi, res.y - 1, xi1);
+
+        prob_phi = cdf_data_phi[idx_phi];
+        if (idx_phi > 0)
+            prob_phi -= cdf_data_phi[idx_phi - 1];
+    }
+    else
+    {
+        idx_phi = sample_cdf(cdf_data_phi, res.y - 1, xi1);             // binary search
+
+        prob_phi = cdf_data_phi[idx_phi];
+        if (idx_phi > 0)
+        {
+            const float tmp = cdf_data_phi[idx_phi - 1];
+            prob_phi -= tmp;
+            xi1 -= tmp;
+        }
+        xi1 /= prob_phi;  // rescale for re-usage
     }
-    xi1 /= prob_phi;  // rescale for re-usage
 
     // compute theta and phi
     //-------------------------------------------
@@ -1057,6 +1114,7 @@ extern "C" __device__ void df_bsdf_measurement_sample(
     // CDF data
     uint2 res = bm.angular_resolution[part_index];
     const float* sample_data = bm.sample_data[part_index];
+    const Alias_entry* alias_data = bm.alias_data[part_index];
 
     // compute the theta_in index (flipping input and output, BSDFs are symmetric)
     unsigned idx_theta_in = unsigned(theta_phi_out[0] * M_ONE_OVER_PI * 2.0f * float(res.x));
@@ -1066,23 +1124,38 @@ extern "C" __device__ void df_bsdf_measurement_sample(
     //-------------------------------------------
     float xi0 = xi[0];
     const float* cdf_theta = sample_data + idx_theta_in * res.x;
-    unsigned idx_theta_out = sample_cdf(cdf_theta, res.x, xi0);       // binary search
+    unsigned idx_theta_out;
+    float prob_theta;
+    if (alias_data)
+    {
+        idx_theta_out = sample_alias_table(                             // table lookup
+            alias_data + idx_theta_in * res.x, res.x, xi0);
 
-    float prob_theta = cdf_theta[idx_theta_out];
-    if (idx_theta_out > 0)
+        prob_theta = cdf_theta[idx_theta_out];
+        if (idx_theta_out > 0)
+            prob_theta -= cdf_theta[idx_theta_out - 1];
+    }
+    else
     {
-        const float tmp = cdf_theta[idx_theta_out - 1];
-        prob_theta -= tmp;
-        xi0 -= tmp;
+        idx_theta_out = sample_cdf(cdf_theta, res.x, xi0);              // binary search
+
+        prob_theta = cdf_theta[idx_theta_out];
+        if (idx_theta_out > 0)
+        {
+            const float tmp = cdf_theta[idx_theta_out - 1];
+            prob_theta -= tmp;
+            xi0 -= tmp;
+        }
+        xi0 /= prob_theta;  // rescale for re-usage
     }
-    xi0 /= prob_theta;  // rescale for re-usage
 
     // sample phi_out
     //-------------------------------------------
     float xi1 = xi[1];
-    const float* cdf_phi = sample_data +
-                           (res.x * res.x) +                                // CDF theta block
-                           (idx_theta_in * res.x + idx_theta_out) * res.y;  // selected CDF phi
+    const unsigned offset_phi =
+        (res.x * res.x) +                                               // CDF theta block
+        (idx_theta_in * res.x + idx_theta_out) * res.y;                 // selected CDF phi
+    const float* cdf_phi = sample_data + offset_phi;
 
     // select which half-circle to choose with probability 0.5
     const bool flip = (xi1 > 0.5f);
@@ -1090,15 +1163,30 @@ extern "C" __device__ void df_bsdf_measurement_sample(
         xi1 = 1.0f - xi1;
     xi1 *= 2.0f;
 
-    unsigned idx_phi_out = sample_cdf(cdf_phi, res.y, xi1);           // binary search
-    float prob_phi = cdf_phi[idx_phi_out];
-    if (idx_phi_out > 0)
+    unsigned idx_phi_out;
+    float prob_phi;
+    if (alias_data)
     {
-        const float tmp = cdf_phi[idx_phi_out - 1];
-        prob_phi -= tmp;
-        xi1 -= tmp;
+        idx_phi_out = sample_alias_table(                               // table lookup
+            alias_data + offset_phi, res.y, xi1);
+
+        prob_phi = cdf_phi[idx_phi_out];
+        if (idx_phi_out > 0)
+            prob_phi -= cdf_phi[idx_phi_out - 1];
+    }
+    else
+    {
+        idx_phi_out = sample_cdf(cdf_phi, res.y, xi1);                  // binary search
+
+        prob_phi = cdf_phi[idx_phi_out];
+        if (idx_phi_out > 0)
+        {
+            const float tmp = cdf_phi[idx_phi_out - 1];
+            prob_phi -= tmp;
+            xi1 -= tmp;
+        }
+        xi1 /= prob_phi;  // rescale for re-usage
     }
-    xi1 /= prob_phi;  // rescale for re-usage
 
     // compute theta and phi out
     //-------------------------------------------
@@ -81,7 +81,7 @@ public:
 
 /// A simple code cache.
 class ICode_cache : public
-    mi::base::Interface_declare<0x34ba5c1c,0x4e58,0x42fb,0x8f,0x54,0xd3,0x39,0xb3,0x73,0xf8,0xd6,
+    mi::base::Interface_declare<0x34ba5c1c,0x4e58,0x42fb,0x8f,0x54,0xd3,0x39,0xb3,0x73,0xf8,0xd7,
     mi::base::IInterface>
 {
 public:
@@ -180,11 +180,27 @@ public:
 
     };
 
+    /// Statistics of a code cache.
+    struct Statistics {
+        size_t memory_hits;     ///< Number of lookups served from memory.
+        size_t disk_hits;       ///< Number of lookups served from the disk tier.
+        size_t misses;          ///< Number of failed lookups.
+        size_t disk_writes;     ///< Number of entries written to the disk tier.
+        size_t disk_evictions;  ///< Number of entries evicted from the disk tier.
+        size_t memory_size;     ///< Current size of the memory tier in bytes.
+        size_t disk_size;       ///< Current (estimated) size of the disk tier in bytes.
+    };
+
     /// Lookup a data blob.
     virtual Entry const *lookup(unsigned char const key[16]) const = 0;
 
     /// Enter a data blob.
     virtual bool enter(unsigned char const key[16], Entry const &entry) = 0;
+
+    /// Retrieve the statistics of this cache.
+    ///
+    /// \param[out] stats  the statistics
+    virtual void get_statistics(Statistics &stats) const = 0;
 };
 
 /// A name resolver interface.
@@ -986,6 +1002,10 @@ public:
     /// The name of the option that enables target material mode compilation.
     #define MDL_CG_DAG_OPTION_TARGET_MATERIAL_MODE "target_material_mode"
 
+    /// The name of the option that defers the conversion of function bodies until they are
+    /// first accessed.
+    #define MDL_CG_DAG_OPTION_LAZY_FUNCTION_BODIES "lazy_function_bodies"
+
     /// Compile a module.
     /// \param      module  The module to compile.
     /// \returns            The generated code.
@@ -1134,6 +1154,11 @@ class ICode_generator_jit : public
     /// the number of functions for which target code will be generated.
     #define MDL_JIT_OPTION_VISIBLE_FUNCTIONS "jit_visible_functions"
 
+    /// The name of the option to set the maximum number of partitions the optimized module
+    /// is split into for parallel PTX code generation (1 disables splitting, 0 uses one
+    /// partition per hardware thread).
+    #define MDL_JIT_OPTION_NUM_CODEGEN_PARTITIONS "jit_num_codegen_partitions"
+
     /// The name of the option to set a user-specified LLVM implementation for the state module.
     #define MDL_JIT_BINOPTION_LLVM_STATE_MODULE "jit_llvm_state_module"
 
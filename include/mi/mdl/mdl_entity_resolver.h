@@ -107,6 +107,25 @@ public:
     virtual bool get_resource_hash(unsigned char hash[16]) = 0;
 };
 
+/// A resource reader whose data might be directly accessible in memory.
+///
+/// Resources stored uncompressed inside MDL archives or MDLE files are served from a memory
+/// mapping of the container file. Use mi::base::IInterface::get_interface() on an
+/// #mi::mdl::IMDL_resource_reader to check for this interface.
+class IMDL_mapped_resource_reader : public
+    mi::base::Interface_declare<0x5d3b0c41,0x7a2e,0x4f6b,0x9c,0x1d,0x62,0x84,0x0e,0xa7,0x3b,0x55,
+    IMDL_resource_reader>
+{
+public:
+    /// Get the data of the resource.
+    ///
+    /// \param[out] size  the size of the resource data in bytes
+    ///
+    /// \return the resource data, valid as long as this reader exists, or NULL if the data is
+    ///         not directly accessible
+    virtual unsigned char const *get_mapped_data(Uint64 &size) const = 0;
+};
+
 /// An interface describing an module import result.
 class IMDL_import_result : public
     mi::base::Interface_declare<0xb7b3de9d,0xa9ce,0x4e19,0x93,0x87,0x46,0x13,0x69,0xdb,0xf0,0xef,
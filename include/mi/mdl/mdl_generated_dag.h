@@ -1098,6 +1098,17 @@ public:
     virtual DAG_node const *get_function_body(
         size_t function_index) const = 0;
 
+    /// Check if the body of the function at function_index was not converted yet.
+    ///
+    /// If the code DAG was compiled with the "lazy_function_bodies" option, function bodies
+    /// and their temporaries are converted on first access. This requires that the import
+    /// entries of the compiled module are available at that time.
+    ///
+    /// \param function_index      The index of the function.
+    /// \returns                   True if the body will be converted on the next access.
+    virtual bool is_function_body_pending(
+        size_t function_index) const = 0;
+
     /// Get the property flag of the function at function_index.
     ///
     /// \param function_index  The index of the function.
@@ -173,6 +173,22 @@ public:
     /// The name of the option to keep resource file paths as is.
     #define MDL_OPTION_KEEP_ORIGINAL_RESOURCE_FILE_PATHS "keep_original_resource_file_paths"
 
+    /// The name of the option that sets the directory of the module image cache.
+    ///
+    /// If set, analyzed modules loaded from files are stored as binary images in this directory.
+    /// Later compilations of the same source with the same imports, compiler build and options
+    /// load the image instead of parsing and analyzing the module again.
+    #define MDL_OPTION_MODULE_IMAGE_CACHE_PATH "module_image_cache_path"
+
+    /// The name of the option that sets the maximum number of threads loading imports.
+    ///
+    /// If greater than zero, up to this many imports (shared by all compilations of this compiler)
+    /// are resolved and compiled by jobs of the shared thread pool while the importing module
+    /// itself is analyzed. Only enable this if the module cache passed to the compiler lets concurrent
+    /// lookups of the same module wait for the loading thread, otherwise a module might be
+    /// compiled more than once. Defaults to 0, i.e., imports are loaded by the importing thread.
+    #define MDL_OPTION_PARALLEL_IMPORT_THREADS "parallel_import_threads"
+
 public:
     /// Get the type factory of the compiler.
     ///
@@ -387,6 +403,28 @@ public:
     /// \return the code DAG
     virtual IGenerated_code_dag const *deserialize_code_dag(IDeserializer *ds) = 0;
 
+    /// Load the code DAG of a module from the module image cache.
+    ///
+    /// \param module       the module, must have been compiled with the module image cache
+    /// \param options_key  a string identifying all options the code DAG was generated with
+    ///
+    /// \return the code DAG or NULL if there is no matching entry
+    virtual IGenerated_code_dag *load_cached_code_dag(
+        IModule const *module,
+        char const    *options_key) = 0;
+
+    /// Store the code DAG of a module in the module image cache.
+    ///
+    /// Does nothing if the module was not compiled with the module image cache.
+    ///
+    /// \param module       the module the code DAG was generated from
+    /// \param code         the code DAG
+    /// \param options_key  a string identifying all options the code DAG was generated with
+    virtual void store_cached_code_dag(
+        IModule const             *module,
+        IGenerated_code_dag const *code,
+        char const                *options_key) = 0;
+
     /// Create a new MDL lambda function.
     ///
     /// \param context  the execution context for this lambda function.
@@ -529,6 +567,14 @@ public:
     /// \return true on success, false if the given translator was not found
     virtual bool remove_foreign_module_translator(
         IMDL_foreign_module_translator *translator) = 0;
+
+    /// Invalidate the results of file resolution cached by this compiler.
+    ///
+    /// The compiler caches the results of resolving module and resource names, including
+    /// negative ones. Changes of the search paths are detected automatically, changes of the
+    /// file system (files added, removed or renamed inside the search paths) are not. Call this
+    /// method after such changes.
+    virtual void invalidate_file_resolution_cache() = 0;
 };
 
 
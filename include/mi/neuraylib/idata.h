@@ -301,9 +301,38 @@ namespace mi {
                                 <td>3 x Float32 representing RGB   color</td></tr>
     <tr><td>\c "Color"     </td><td>mi::IColor</td><td>mi::Color</td>
                                 <td>4 x Float32 representing RGBA  color</td></tr>
+    <tr><td>\c "Bc1"       </td><td>-</td><td>-</td>
+                                <td>8-byte BC1 blocks, decompresses to \c "Rgba" (7)</td></tr>
+    <tr><td>\c "Bc2"       </td><td>-</td><td>-</td>
+                                <td>16-byte BC2 blocks, decompresses to \c "Rgba" (7)</td></tr>
+    <tr><td>\c "Bc3"       </td><td>-</td><td>-</td>
+                                <td>16-byte BC3 blocks, decompresses to \c "Rgba" (7)</td></tr>
+    <tr><td>\c "Bc4"       </td><td>-</td><td>-</td>
+                                <td>8-byte BC4 blocks, decompresses to \c "Sint8" (7)</td></tr>
+    <tr><td>\c "Bc4s"      </td><td>-</td><td>-</td>
+                                <td>8-byte signed BC4 blocks, decompresses to \c "Float32" (7)</td></tr>
+    <tr><td>\c "Bc5"       </td><td>-</td><td>-</td>
+                                <td>16-byte BC5 blocks, decompresses to \c "Rgb" (7)</td></tr>
+    <tr><td>\c "Bc5s"      </td><td>-</td><td>-</td>
+                                <td>16-byte signed BC5 blocks, decompresses to \c "Float32<2>" (7)
+                                </td></tr>
+    <tr><td>\c "Bc6h"      </td><td>-</td><td>-</td>
+                                <td>16-byte BC6H blocks, decompresses to \c "Rgb_fp" (7)</td></tr>
+    <tr><td>\c "Bc6hs"     </td><td>-</td><td>-</td>
+                                <td>16-byte signed BC6H blocks, decompresses to \c "Rgb_fp" (7)
+                                </td></tr>
+    <tr><td>\c "Bc7"       </td><td>-</td><td>-</td>
+                                <td>16-byte BC7 blocks, decompresses to \c "Rgba" (7)</td></tr>
     </table>
     (6) For most purposes, in particular for pixel type conversion, the data is actually treated as
         \em unsigned 8-bit integer.
+
+    (7) Block-compressed pixel types store 4x4 pixel blocks, row by row starting with the \em top
+        row of blocks (as expected by GPUs, and in contrast to the bottom-up order of the other
+        pixel types). Partial blocks at the right and top border are padded. Canvases use these
+        pixel types only if the option \c "image_keep_compressed" is enabled. They can be
+        converted to other pixel types (which decodes them), but other pixel types cannot be
+        converted to them.
 */
 
 /** \addtogroup mi_neuray_types
@@ -355,13 +355,16 @@ public:
     ///   0.0f, or 0, respectively. Conversion of single-channel formats to \c "Float32<2>"
     ///   duplicates the channel. Conversion of three- or four-channel formats to \c "Float32<2>"
     ///   drops the third and fourth channel.
+    /// - Block-compressed pixel types like \c "Bc1" are decoded and converted via their
+    ///   decompressed pixel type. Conversion into block-compressed pixel types is not supported.
     ///
     /// \param canvas       The canvas to convert (or to copy).
     /// \param pixel_type   The desired pixel type. See \ref mi_neuray_types for a list of supported
     ///                     pixel types. If this pixel type is the same as the pixel type of \p
     ///                     canvas, then a copy of the canvas is returned.
     /// \return             A canvas with the requested pixel type, or \c NULL in case of errors
-    ///                     (\p canvas is \c NULL, or \p pixel_type is not valid).
+    ///                     (\p canvas is \c NULL, or \p pixel_type is not valid, or \p pixel_type
+    ///                     is block-compressed and differs from the pixel type of \p canvas).
     virtual ICanvas* convert( const ICanvas* canvas, const char* pixel_type) const = 0;
 
     /// Sets the gamma value of a canvas and adjusts the pixel data accordingly.
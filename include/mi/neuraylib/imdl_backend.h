@@ -87,10 +87,34 @@ public:
     ///                             Possible values: \c "none", \c "fixed_1", \c "fixed_2",
     ///                             \c "fixed_4", \c "fixed_8", and \c "pointer", while \c "pointer"
     ///                             is not available for all backends. Default: \c "none".
+    /// - \c "deduplicate_materials": If enabled, link units share the generated functions of
+    ///                               compiled materials with the same structure, i.e., materials
+    ///                               with equal hashes which only differ in their arguments.
+    ///                               Such materials only get their own target argument block and
+    ///                               reuse the function indices of the first material added, so
+    ///                               the function names requested for them are ignored. The
+    ///                               deduplication ratio is reported as info message when the
+    ///                               link unit is translated. Possible values: \c "on",
+    ///                               \c "off". Default: \c "off".
+    /// - \c "share_resource_indices": If enabled, the textures, light profiles and BSDF
+    ///                                measurements are registered in a registry shared by all
+    ///                                backends of the MDL backend API. The registry assigns
+    ///                                session IDs to the resources which stay stable across all
+    ///                                link units and target codes, see
+    ///                                #mi::neuraylib::ITarget_code::get_texture_session_id(),
+    ///                                and resources already resolved by an earlier compilation
+    ///                                are not resolved again unless they were edited. The
+    ///                                resource indices of each target code stay dense.
+    ///                                Possible values: \c "on", \c "off". Default: \c "off".
     ///
     /// The following options are supported by the NATIVE backend only:
     /// - \c "use_builtin_resource_handler": Enables/disables the built-in texture runtime.
     ///   Possible values: \c "on", \c "off". Default: \c "on".
+    /// - \c "use_alias_tables": Enables/disables sampling of BSDF measurements and light
+    ///   profiles with alias tables in the built-in texture runtime. The tables are built when
+    ///   the resources are prepared and allow to select a sample in constant time instead of
+    ///   using binary searches, at the cost of additional memory. Possible values:
+    ///   \c "on", \c "off". Default: \c "off".
     ///
     /// The following options are supported by the PTX, LLVM-IR, native and HLSL backend:
     ///
@@ -165,6 +189,12 @@ public:
     ///   * \c "vtable": generate calls through a vtable call (default)
     ///   * \c "direct_call": generate direct function calls
     ///   * \c "optix_cp": generate calls through OptiX bindless callable programs
+    /// - \c "num_codegen_partitions": The maximum number of partitions the optimized code of a
+    ///   target code is split into to generate PTX on several threads in parallel. The entry
+    ///   points are distributed over the partitions and the PTX of all partitions is merged, so
+    ///   the generated code stays functionally identical. \c "1" disables splitting, \c "0"
+    ///   uses one partition per hardware thread. Splitting is not applied if debug information
+    ///   is generated. Default: \c "1".
     ///
     /// The following options are supported by the HLSL backend only:
     /// - \c "hlsl_use_resource_data": If enabled, an extra user define resource data struct is
@@ -613,7 +643,7 @@ public:
 
 /// Represents target code of an MDL backend.
 class ITarget_code : public
-    mi::base::Interface_declare<0xefca46ae,0xd530,0x4b97,0x9d,0xab,0x3a,0xdb,0x0c,0x58,0xc3,0xac>
+    mi::base::Interface_declare<0xefca46ae,0xd530,0x4b97,0x9d,0xab,0x3a,0xdb,0x0c,0x58,0xc3,0xad>
 {
 public:
     /// The potential state usage properties.
@@ -803,6 +833,19 @@ public:
         Size &ry,
         Size &rz) const = 0;
 
+    /// Returns the session ID of a texture resource used by the target code.
+    ///
+    /// If the backend option \c "share_resource_indices" is enabled, each texture gets an ID
+    /// which is the same in all link units and target codes created by the backends of the MDL
+    /// backend API, while the texture indices stay dense per target code. This maps the texture
+    /// index of this target code to that ID, e.g., to share texture objects between target codes.
+    ///
+    /// \param index      The index of the texture resource.
+    /// \return           The session ID of the texture resource of the given index, or \c 0 if
+    ///                   \p index is out of range, the texture is invalid, the option is
+    ///                   disabled, or the target code was deserialized.
+    virtual Size get_texture_session_id( Size index) const = 0;
+
     //@}
     /// \name Light profiles
     //@{
@@ -842,6 +885,45 @@ public:
     ///                   module is not provided.
     virtual const char* get_light_profile_owner_module( Size index) const = 0;
 
+    /// Returns the session ID of a light profile resource used by the target code.
+    ///
+    /// \see #get_texture_session_id()
+    ///
+    /// \param index      The index of the light profile resource.
+    /// \return           The session ID of the light profile resource of the given index, or
+    ///                   \c 0 if none was assigned.
+    virtual Size get_light_profile_session_id( Size index) const = 0;
+
+    /// Returns the CDFs for sampling a light profile resource used by the target code.
+    ///
+    /// Sampling works on the cells of the grid of the light profile. For a resolution of
+    /// \c res_theta x \c res_phi grid nodes, the buffer contains <tt>res_theta - 1</tt> floats
+    /// with the CDF for selecting theta, followed by <tt>res_theta - 1</tt> CDFs with
+    /// <tt>res_phi - 1</tt> floats each for selecting phi for a given theta cell. The
+    /// probability of a cell is proportional to the average of its corners times its solid
+    /// angle.
+    ///
+    /// \param transaction  The transaction to access the light profile.
+    /// \param index        The index of the light profile resource.
+    /// \return             A buffer with the CDFs as floats, or \c NULL if \p index is out of range
+    ///                     or the light profile does not exist in the database.
+    virtual const IBuffer* get_light_profile_cdfs(
+        ITransaction* transaction, Size index) const = 0;
+
+    /// Returns the alias tables for sampling a light profile resource used by the target code.
+    ///
+    /// The buffer contains one #mi::neuraylib::Alias_table_entry for each float returned by
+    /// #get_light_profile_cdfs(), with the same layout. Each table selects a bin in constant time
+    /// with the probabilities given by the differences of consecutive CDF values, so the
+    /// probability densities can still be computed from the CDFs.
+    ///
+    /// \param transaction  The transaction to access the light profile.
+    /// \param index        The index of the light profile resource.
+    /// \return             A buffer with the alias tables, or \c NULL if \p index is out of range
+    ///                     or the light profile does not exist in the database.
+    virtual const IBuffer* get_light_profile_alias_tables(
+        ITransaction* transaction, Size index) const = 0;
+
     //@}
     /// \name BSDF measurements
     //@{
@@ -881,6 +963,50 @@ public:
     ///                   module is not provided.
     virtual const char* get_bsdf_measurement_owner_module( Size index) const = 0;
 
+    /// Returns the session ID of a BSDF measurement resource used by the target code.
+    ///
+    /// \see #get_texture_session_id()
+    ///
+    /// \param index      The index of the BSDF measurement resource.
+    /// \return           The session ID of the BSDF measurement resource of the given index, or
+    ///                   \c 0 if none was assigned.
+    virtual Size get_bsdf_measurement_session_id( Size index) const = 0;
+
+    /// Returns the CDFs for sampling a part of a BSDF measurement resource used by the target
+    /// code.
+    ///
+    /// For a resolution of \c res_theta x \c res_phi, the buffer contains \c res_theta CDFs with
+    /// \c res_theta floats each for selecting theta_out for a given theta_in, followed by
+    /// <tt>res_theta * res_theta</tt> CDFs with \c res_phi floats each for selecting phi_out for
+    /// a given pair of theta_in and theta_out. The probabilities are proportional to the maximum
+    /// color component of the symmetrized measurement times the solid angle of the bin.
+    ///
+    /// \param transaction  The transaction to access the BSDF measurement.
+    /// \param index        The index of the BSDF measurement resource.
+    /// \param part         The part of the BSDF measurement.
+    /// \return             A buffer with the CDFs as floats, or \c NULL if \p index is out of
+    ///                     range, the BSDF measurement does not exist in the database, or it has
+    ///                     no data for \p part.
+    virtual const IBuffer* get_bsdf_measurement_cdfs(
+        ITransaction* transaction, Size index, Mbsdf_part part) const = 0;
+
+    /// Returns the alias tables for sampling a part of a BSDF measurement resource used by the
+    /// target code.
+    ///
+    /// The buffer contains one #mi::neuraylib::Alias_table_entry for each float returned by
+    /// #get_bsdf_measurement_cdfs(), with the same layout. Each table selects a bin in constant
+    /// time with the probabilities given by the differences of consecutive CDF values, so the
+    /// probability densities can still be computed from the CDFs.
+    ///
+    /// \param transaction  The transaction to access the BSDF measurement.
+    /// \param index        The index of the BSDF measurement resource.
+    /// \param part         The part of the BSDF measurement.
+    /// \return             A buffer with the alias tables, or \c NULL if \p index is out of
+    ///                     range, the BSDF measurement does not exist in the database, or it has
+    ///                     no data for \p part.
+    virtual const IBuffer* get_bsdf_measurement_alias_tables(
+        ITransaction* transaction, Size index, Mbsdf_part part) const = 0;
+
     //@}
 
     /// Returns the number of constant data initializers.
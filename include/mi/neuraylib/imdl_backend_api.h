@@ -74,9 +74,29 @@ enum Df_data_kind {
 
 mi_static_assert(sizeof(Df_data_kind) == sizeof(Uint32));
 
+/// Statistics of the target code cache shared by all backends.
+///
+/// The target code cache consists of an in-memory tier and an optional persistent disk tier.
+/// The sizes of both tiers and the location of the disk tier are configured via the debug
+/// configuration options \c mdl_target_code_cache_size, \c mdl_target_code_cache_path and
+/// \c mdl_target_code_cache_disk_size, see #mi::neuraylib::IDebug_configuration.
+///
+/// Only code generated as source, i.e., by the PTX, HLSL and LLVM-IR backends, is cached.
+/// Native code is compiled again for each translation and does not show up in the statistics.
+struct Target_code_cache_statistics
+{
+    Size memory_hits;     ///< Number of lookups served from the in-memory tier.
+    Size disk_hits;       ///< Number of lookups served from the disk tier.
+    Size misses;          ///< Number of lookups that required code generation.
+    Size disk_writes;     ///< Number of entries written to the disk tier.
+    Size disk_evictions;  ///< Number of entries evicted from the disk tier.
+    Size memory_size;     ///< Current size of the in-memory tier in bytes.
+    Size disk_size;       ///< Current size of the disk tier in bytes.
+};
+
 /// This interface can be used to obtain the MDL backends.
 class IMdl_backend_api : public
-    mi::base::Interface_declare<0x425559dd,0xbf91,0x459a,0xaa,0xaf,0xc3,0x14,0x8a,0x5a,0x2f,0x99>
+    mi::base::Interface_declare<0x425559dd,0xbf91,0x459a,0xaa,0xaf,0xc3,0x14,0x8a,0x5a,0x2f,0x9a>
 {
 public:
 
@@ -112,6 +132,15 @@ public:
         Size &rx,
         Size &ry,
         Size &rz) const = 0;
+
+    /// Returns statistics of the target code cache shared by all backends.
+    ///
+    /// \param[out] stats  The statistics of the target code cache.
+    /// \return
+    ///                   -  0: Success.
+    ///                   - -1: The target code cache is disabled.
+    virtual Sint32 get_target_code_cache_statistics(
+        Target_code_cache_statistics &stats) const = 0;
 };
 
 /*@}*/ // end group mi_neuray_mdl_misc
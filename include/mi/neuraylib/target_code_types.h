@@ -348,6 +348,19 @@ enum Mbsdf_part
     MBSDF_DATA_TRANSMISSION = 1
 };
 
+/// An entry of an alias table for sampling a discrete distribution in constant time.
+///
+/// A bin is selected by first choosing an entry uniformly and then either keeping its bin with
+/// probability \c q or switching to the bin \c alias otherwise.
+///
+/// \see #mi::neuraylib::ITarget_code::get_bsdf_measurement_alias_tables(),
+///      #mi::neuraylib::ITarget_code::get_light_profile_alias_tables()
+struct Alias_table_entry
+{
+    tct_float q;      ///< The probability to keep the bin of this entry.
+    tct_uint  alias;  ///< The bin to select otherwise.
+};
+
 
 // Forward declaration of texture handler structure.
 struct Texture_handler_base;
@@ -44,12 +44,19 @@
 #include <base/lib/log/i_log_logger.h>
 #include <base/data/db/i_db_database.h>
 #include <base/data/dblight/i_dblight.h>
+#include <base/data/serial/serial.h>
+#include <base/lib/config/config.h>
+#include <base/util/registry/i_config_registry.h>
 #include <mdl/integration/mdlnr/i_mdlnr.h>
 #include <io/image/image/i_image.h>
+#include <io/scene/bsdf_measurement/i_bsdf_measurement.h>
+#include <io/scene/dbimage/i_dbimage.h>
+#include <io/scene/lightprofile/i_lightprofile.h>
 #include <io/scene/mdl_elements/i_mdl_elements_utilities.h>
 
 // API components
 #include "neuray_database_impl.h"
+#include "neuray_db_element_tracker.h"
 #include "neuray_debug_configuration_impl.h"
 #include "neuray_factory_impl.h"
 #include "neuray_image_api_impl.h"
@@ -89,7 +96,7 @@ void pull_in_required_modules();
 std::atomic_uint32_t Neuray_impl::s_instance_count = 0;
 
 Neuray_impl::Neuray_impl()
-  : m_status( PRE_STARTING), m_database( 0)
+  : m_status( PRE_STARTING), m_database( 0), m_deserialization_manager( 0)
 {
     pull_in_required_modules();
 
@@ -225,7 +232,37 @@ mi::Sint32 Neuray_impl::start( bool blocking)
 
     NEURAY::Class_registration::register_classes_part2( m_class_factory);
 
-    m_database = DBLIGHT::factory();
+    // Only elements of the registered classes are swapped out to disk by the database. These are
+    // the classes holding the bulk data of resources.
+    m_deserialization_manager = SERIAL::Deserialization_manager::create();
+    m_deserialization_manager->register_class(
+        DBIMAGE::Image_impl::id, DBIMAGE::Image_impl::factory);
+    m_deserialization_manager->register_class(
+        LIGHTPROFILE::Lightprofile_impl::id, LIGHTPROFILE::Lightprofile_impl::factory);
+    m_deserialization_manager->register_class(
+        BSDFM::Bsdf_measurement_impl::id, BSDFM::Bsdf_measurement_impl::factory);
+
+    m_database = DBLIGHT::factory( m_deserialization_manager);
+
+    // Memory limits and disk swapping are disabled by default.
+    SYSTEM::Access_module<CONFIG::Config_module> config_module( false);
+    const CONFIG::Config_registry& registry = config_module->get_configuration();
+    std::string swap_directory;
+    size_t low_water = 0, high_water = 0;
+    registry.get_value( "db_swap_directory", swap_directory);
+    registry.get_value( "db_memory_low_water", low_water);
+    registry.get_value( "db_memory_high_water", high_water);
+    if( !swap_directory.empty() && m_database->set_disk_swapping( swap_directory.c_str()) != 0)
+        LOG::mod_log->error( M_NEURAY_API, LOG::Mod_log::C_DATABASE,
+            "Failed to use \"%s\" as swap directory.", swap_directory.c_str());
+    if( m_database->set_memory_limits( low_water, high_water) != 0)
+        LOG::mod_log->error( M_NEURAY_API, LOG::Mod_log::C_DATABASE,
+            "Invalid memory limits for the database.");
+
+    // Tracking of DB elements in use by the API is only enabled by default in debug builds.
+    bool db_element_tracking = false;
+    if( registry.get_value( "db_element_tracking", db_element_tracking))
+        NEURAY::g_db_element_tracker.set_enabled( db_element_tracking);
 
 #define CHECK_RESULT if( result) { m_status = FAILURE; return result; }
 
@@ -266,6 +303,21 @@ mi::Sint32 Neuray_impl::start( bool blocking)
     mi::base::Handle<IMAGE::IMdl_container_callback> callback( MDL::create_mdl_container_callback());
     image_module->set_mdl_container_callback( callback.get());
 
+    // The tile cache budget is unlimited by default.
+    size_t tile_cache_budget = 0;
+    registry.get_value( "image_tile_cache_budget", tile_cache_budget);
+    image_module->set_tile_cache_budget( tile_cache_budget);
+
+    // The decode budget keeps the default of the IMAGE module unless configured.
+    size_t decode_budget = image_module->get_decode_budget();
+    registry.get_value( "image_decode_budget", decode_budget);
+    image_module->set_decode_budget( decode_budget);
+
+    // Block-compressed image data is decompressed when loaded unless configured otherwise.
+    bool keep_compressed = false;
+    registry.get_value( "image_keep_compressed", keep_compressed);
+    image_module->set_keep_compressed( keep_compressed);
+
     m_status = STARTED;
 
     return result;
@@ -294,7 +346,13 @@ mi::Sint32 Neuray_impl::shutdown( bool blocking)
     unregister_api_component<mi::neuraylib::IImage_api>();
     unregister_api_component<mi::neuraylib::IDatabase>();
 
+    if( NEURAY::g_db_element_tracker.is_enabled())
+        NEURAY::g_db_element_tracker.report_elements( "during shutdown");
+
     m_database->close();
+    m_database = 0;
+    SERIAL::Deserialization_manager::release( m_deserialization_manager);
+    m_deserialization_manager = 0;
 
 #define CHECK_RESULT  if( result ) { m_status = FAILURE; return result; }
 
@@ -55,6 +55,7 @@ namespace mi {
 namespace MI {
 
 namespace DB { class Database; }
+namespace SERIAL { class Deserialization_manager; }
 
 namespace NEURAY {
 
@@ -182,6 +183,9 @@ private:
 
     /// The database.
     DB::Database* m_database;
+
+    /// Used by the database to swap in elements that have been swapped out to disk.
+    SERIAL::Deserialization_manager* m_deserialization_manager;
 };
 
 } // namespace MDL
@@ -40,6 +40,7 @@
 #include <sstream>
 #include <mi/base/handle.h>
 #include <base/lib/log/i_log_assert.h>
+#include <base/lib/log/i_log_logger.h>
 
 
 namespace MI {
@@ -47,18 +48,38 @@ namespace MI {
 namespace NEURAY {
 
 Db_element_tracker::Db_element_tracker()
-  : m_initialized( false)
+#if defined(DEBUG) || defined(ENABLE_ASSERT)
+  : m_enabled( true),
+    m_was_enabled( true)
+#else
+  : m_enabled( false),
+    m_was_enabled( false)
+#endif
 {
 }
 
 Db_element_tracker::~Db_element_tracker()
 {
-    ASSERT( M_NEURAY_API, m_elements.empty());
+    ASSERT( M_NEURAY_API, get_element_count() == 0);
+}
+
+void Db_element_tracker::set_enabled( bool enabled)
+{
+    // The release stores pair with the acquire loads in add_element() and remove_element(): an
+    // element that was added after enabling is destroyed after the store to m_was_enabled, and
+    // its removal therefore sees that flag and looks at the shard.
+    if( enabled)
+        m_was_enabled.store( true, std::memory_order_release);
+    m_enabled.store( enabled, std::memory_order_release);
 }
 
 void Db_element_tracker::add_element( const Db_element_impl_base* db_element)
 {
-    mi::base::Lock::Block block(&m_lock);
+    if( !m_enabled.load( std::memory_order_acquire))
+        return;
+
+    Shard& shard = get_shard( db_element);
+    mi::base::Lock::Block block( &shard.m_lock);
 
     // Note: we store a pointer to a reference-counted object without calling retain() here.
     // This is not a problem since this method will only be called from the constructor of that
@@ -66,21 +87,71 @@ void Db_element_tracker::add_element( const Db_element_impl_base* db_element)
     //
     // Reference counting as usual is not possible since that would increase the reference count,
     // and the object would never go out of scope.
-    m_elements.insert( db_element);
+    shard.m_elements.insert( db_element);
 }
 
 void Db_element_tracker::remove_element( const Db_element_impl_base* db_element)
 {
+    if( !m_was_enabled.load( std::memory_order_acquire))
+        return;
+
     // Note: we remove a pointer to reference-counted object without calling release() here.
     // This is not a problem since this method will only be called from the destructor of that
     // object (and the corresponding method from the constructor of that object).
     //
     // Reference counting as usual is not possible since that would increase the reference count,
     // and the object would never go out of scope.
-    mi::base::Lock::Block block( &m_lock);
-    m_elements.erase( db_element);
+    Shard& shard = get_shard( db_element);
+    mi::base::Lock::Block block( &shard.m_lock);
+    shard.m_elements.erase( db_element);
+}
+
+mi::Size Db_element_tracker::get_element_count() const
+{
+    mi::Size count = 0;
+    for( const Shard& shard: m_shards) {
+        mi::base::Lock::Block block( &shard.m_lock);
+        count += shard.m_elements.size();
+    }
+    return count;
 }
 
+mi::Size Db_element_tracker::report_elements( const char* context) const
+{
+    mi::Size count = 0;
+    for( const Shard& shard: m_shards) {
+        mi::base::Lock::Block block( &shard.m_lock);
+        for( const Db_element_impl_base* db_element: shard.m_elements) {
+            LOG::mod_log->warning( M_NEURAY_API, LOG::Mod_log::C_DATABASE,
+                "DB element with tag %u in state %s is still in use %s.",
+                db_element->get_tag().get_uint(),
+                state_to_string( db_element->get_state()).c_str(),
+                context);
+        }
+        count += shard.m_elements.size();
+    }
+    return count;
+}
+
+std::string Db_element_tracker::state_to_string( Db_element_state state)
+{
+    switch( state) {
+        case STATE_ACCESS:  return "access";
+        case STATE_EDIT:    return "edit";
+        case STATE_POINTER: return "pointer";
+        case STATE_INVALID: return "invalid";
+    }
+
+    ASSERT( M_NEURAY_API, false);
+    return "unknown";
+}
+
+Db_element_tracker::Shard& Db_element_tracker::get_shard( const Db_element_impl_base* db_element)
+{
+    // Skip the low bits which are identical due to the alignment of heap allocations.
+    const size_t address = reinterpret_cast<size_t>( db_element);
+    return m_shards[((address >> 4) ^ (address >> 12)) % s_nr_of_shards];
+}
 
 } // namespace NEURAY
 
@@ -36,6 +36,8 @@
 #include "i_neuray_db_element.h"
 
 #include <mi/base/lock.h>
+#include <atomic>
+#include <set>
 #include <string>
 
 
@@ -48,8 +50,11 @@ namespace NEURAY {
 class Db_element_impl_base;
 
 /// The tracker can be used to monitor DB elements in use by the API. The constructor and
-/// destructor of Db_element_impl record these events with the tracker. The tracker installs a
-/// callback for the admin HTTP server to dump all DB elements currently in use by the API.
+/// destructor of Db_element_impl record these events with the tracker.
+///
+/// Since every access to a DB element via the API records such events, the elements are
+/// distributed over several shards with separate locks, and the tracking can be disabled
+/// completely. By default, tracking is only enabled in builds with assertions.
 class Db_element_tracker {
 
 public:
@@ -59,15 +64,30 @@ public:
     /// Destructor.
     ~Db_element_tracker();
 
-    /// Record the construction of (an API class for) a DB element.
+    /// Enables or disables the tracking.
     ///
-    /// The first invocation of this method also installs the callback handler for the admin HTTP
-    /// server.
+    /// While disabled, add_element() does nothing. Elements recorded before are still removed
+    /// by remove_element().
+    void set_enabled( bool enabled);
+
+    /// Indicates whether the tracking is enabled.
+    bool is_enabled() const { return m_enabled.load( std::memory_order_relaxed); }
+
+    /// Record the construction of (an API class for) a DB element.
     void add_element( const Db_element_impl_base* db_element);
 
     /// Record the destruction of (an API class for) a DB element.
     void remove_element( const Db_element_impl_base* db_element);
 
+    /// Returns the number of recorded DB elements currently in use by the API.
+    mi::Size get_element_count() const;
+
+    /// Emits a warning for each recorded DB element currently in use by the API.
+    ///
+    /// \param context   Describes the situation, used in the messages.
+    /// \return          The number of DB elements currently in use by the API.
+    mi::Size report_elements( const char* context) const;
+
     /// Returns a string representation of the element state.
     static std::string state_to_string( Db_element_state state);
 
@@ -75,18 +95,38 @@ public:
     static std::string flags_to_string( DB::Journal_type flags);
 
 private:
+    /// The number of shards.
+    static const mi::Size s_nr_of_shards = 64;
+
+    /// A subset of the DB elements currently in use by the API, and the corresponding lock.
+    ///
+    /// Aligned to avoid false sharing between the locks of different shards.
+    struct alignas(64) Shard
+    {
+        /// Lock for the set below.
+        mutable mi::base::Lock m_lock;
 
+        /// Contains the DB elements of this shard currently in use by the API.
+        std::set<const Db_element_impl_base*> m_elements;
+    };
 
-    /// Indicates whether the callback has already been installed.
-    bool m_initialized;
+    /// Returns the shard for \p db_element.
+    Shard& get_shard( const Db_element_impl_base* db_element);
 
-    /// Contains the DB elements currently in use by the API.
-    std::set<const Db_element_impl_base*> m_elements;
+    /// The shards.
+    Shard m_shards[s_nr_of_shards];
 
-    /// Lock for the set above.
-    mi::base::Lock m_lock;
+    /// Indicates whether the tracking is enabled.
+    std::atomic<bool> m_enabled;
+
+    /// Indicates whether the tracking has ever been enabled. If not, remove_element() does not
+    /// need to look at the shards.
+    std::atomic<bool> m_was_enabled;
 };
 
+/// The tracker for all DB elements in use by the API.
+extern Db_element_tracker g_db_element_tracker;
+
 } // namespace NEURAY
 
 } // namespace MI
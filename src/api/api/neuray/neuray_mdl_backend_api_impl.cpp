@@ -38,6 +38,7 @@
 #include <mi/mdl/mdl_code_generators.h>
 #include <mi/mdl/mdl_mdl.h>
 #include <mdl/integration/mdlnr/i_mdlnr.h>
+#include <render/mdl/backends/backends_backends.h>
 #include <render/mdl/backends/backends_target_code.h>
 
 namespace MI {
@@ -75,7 +76,8 @@ mi::neuraylib::IMdl_backend* Mdl_backend_api_impl::get_backend(Mdl_backend_kind
             compiler.get(),
             jit.get(),
             code_cache.get(),
-            /*string_ids=*/true);
+            /*string_ids=*/true,
+            m_resource_registry.get());
     }
     case MB_GLSL:
     case MB_FORCE_32_BIT:
@@ -126,14 +128,37 @@ const Float32* Mdl_backend_api_impl::get_df_data_texture(
     return BACKENDS::Target_code::get_df_data_texture(data_kind, rx, ry, rz);
 }
 
+mi::Sint32 Mdl_backend_api_impl::get_target_code_cache_statistics(
+    mi::neuraylib::Target_code_cache_statistics &stats) const
+{
+    mi::base::Handle<mi::mdl::ICode_cache> code_cache(m_mdlc_module->get_code_cache());
+    if (!code_cache)
+        return -1;
+
+    mi::mdl::ICode_cache::Statistics cache_stats;
+    code_cache->get_statistics(cache_stats);
+
+    stats.memory_hits    = cache_stats.memory_hits;
+    stats.disk_hits      = cache_stats.disk_hits;
+    stats.misses         = cache_stats.misses;
+    stats.disk_writes    = cache_stats.disk_writes;
+    stats.disk_evictions = cache_stats.disk_evictions;
+    stats.memory_size    = cache_stats.memory_size;
+    stats.disk_size      = cache_stats.disk_size;
+    return 0;
+}
+
 mi::Sint32 Mdl_backend_api_impl::start()
 {
     m_mdlc_module.set();
+    m_resource_registry = new BACKENDS::Resource_registry();
     return 0;
 }
 
 mi::Sint32 Mdl_backend_api_impl::shutdown()
 {
+    // the registered resources refer to the DB of this session
+    m_resource_registry.reset();
     m_mdlc_module.reset();
     return 0;
 }
@@ -33,6 +33,7 @@
 #ifndef API_API_NEURAY_MDL_BACKEND_API_IMPL_H
 #define API_API_NEURAY_MDL_BACKEND_API_IMPL_H
 
+#include <mi/base/handle.h>
 #include <mi/base/interface_implement.h>
 #include <mi/neuraylib/imdl_backend_api.h>
 
@@ -48,6 +49,7 @@ class INeuray;
 namespace MI {
 
 namespace MDLC { class Mdlc_module; }
+namespace BACKENDS { class Resource_registry; }
 
 namespace NEURAY {
 
@@ -74,6 +76,9 @@ public:
         mi::Size &ry,
         mi::Size &rz) const final;
 
+    mi::Sint32 get_target_code_cache_statistics(
+        mi::neuraylib::Target_code_cache_statistics &stats) const final;
+
     // internal methods
 
     /// Starts this API component.
@@ -101,6 +106,9 @@ private:
     mi::neuraylib::INeuray *m_neuray;
 
     SYSTEM::Access_module<MDLC::Mdlc_module> m_mdlc_module;
+
+    /// The resource registry shared by all backends created by this API component.
+    mi::base::Handle<BACKENDS::Resource_registry> m_resource_registry;
 };
 
 } // namespace NEURAY
@@ -154,8 +154,9 @@ Mdl_llvm_backend::Mdl_llvm_backend(
     mi::mdl::IMDL                *compiler,
     mi::mdl::ICode_generator_jit *jit,
     mi::mdl::ICode_cache         *code_cache,
-    bool                         string_ids)
-: m_backend(kind, compiler, jit, code_cache, string_ids)
+    bool                         string_ids,
+    BACKENDS::Resource_registry  *registry)
+: m_backend(kind, compiler, jit, code_cache, string_ids, registry)
 {
 }
 
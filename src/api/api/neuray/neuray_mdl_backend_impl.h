@@ -67,12 +67,14 @@ public:
     /// \param jit             The JIT code generator.
     /// \param code_cache      If non-NULL, the code cache.
     /// \param string_ids      If True, string arguments are mapped to string identifiers.
+    /// \param registry        The resource registry shared by all backends.
     Mdl_llvm_backend(
         mi::neuraylib::IMdl_backend_api::Mdl_backend_kind kind,
         mi::mdl::IMDL* compiler,
         mi::mdl::ICode_generator_jit* jit,
         mi::mdl::ICode_cache *code_cache,
-        bool string_ids);
+        bool string_ids,
+        BACKENDS::Resource_registry *registry);
 
     // API methods
 
@@ -534,6 +534,10 @@ mi::Sint32 Mdl_impexp_api_impl::export_module_common(
     Writer_output_stream writer_stream(writer);
     mdl_exporter->export_module(&writer_stream, module, &resource_callback);
 
+    // the exported module and its resources might be found now, drop cached resolution results
+    if (filename)
+        mdl->invalidate_file_resolution_cache();
+
     if (writer_stream.has_error())
         return -6003;
 
@@ -856,6 +856,8 @@ const char* Resource_callback::get_extension( const char* pixel_type)
         return ".png";
     if( s == "Sint8" || s == "Sint32") // Sint8 requires conversion
         return ".tif";
+    if( s.substr( 0, 2) == "Bc") // block-compressed, passed through without re-encoding
+        return ".dds";
 
     ASSERT( M_NEURAY_API, false);
     return ".exr";
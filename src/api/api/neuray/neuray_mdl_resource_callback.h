@@ -216,8 +216,8 @@ private:
     /// the filename suffix from \p suffix (which can contain frame and/or uvtile markers).
     static std::string construct_mdl_file_path( const std::string& prefix, const std::string& suffix);
 
-    /// Returns ".exr" for HDR pixel types, ".png" for LDR pixel types, and ".tif" for "Sint8" and
-    /// "Sint32".
+    /// Returns ".exr" for HDR pixel types, ".png" for LDR pixel types, ".tif" for "Sint8" and
+    /// "Sint32", and ".dds" for block-compressed pixel types.
     static const char* get_extension( const char* pixel_type);
 
     //@}
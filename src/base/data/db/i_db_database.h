@@ -149,6 +149,12 @@ struct Database_statistics
     Uint m_nr_of_created_transactions;
     /// number of hosts we know about
     Uint m_nr_of_known_hosts;
+    /// memory usage of all elements held in memory (in bytes)
+    size_t m_memory_usage;
+    /// memory usage of all elements swapped out to disk (in bytes, before swapping)
+    size_t m_swapped_memory_usage;
+    /// number of elements swapped out to disk
+    Uint m_nr_of_swapped_elements;
 };
 
 /// The database class manages the whole database. It holds the caches for the database elements and
@@ -347,6 +353,14 @@ class Database
     /// Returns the limits for memory usage of the database.
     virtual void get_memory_limits(size_t& low_water, size_t& high_water) const = 0;
 
+    /// Sets the directory used to swap out elements when the memory usage exceeds the limits.
+    ///
+    /// Pass \c NULL or the empty string to disable swapping.
+    virtual Sint32 set_disk_swapping(const char* path) = 0;
+
+    /// Returns the directory used to swap out elements, or \c NULL if swapping is disabled.
+    virtual const char* get_disk_swapping() const = 0;
+
   //
   // The functions below may only be used by DATA!!!!
   //
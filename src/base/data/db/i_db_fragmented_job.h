@@ -0,0 +1,89 @@
+/***************************************************************************************************
+ * Copyright (c) 2012-2022, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************************************/
+
+/** \file
+ ** \brief Interfaces for fragmented jobs.
+ **
+ ** A fragmented job is split into a given number of fragments which are executed in parallel by
+ ** the thread pool of the database, see DB::Transaction::execute_fragmented() and
+ ** DB::Database::execute_fragmented().
+ **/
+
+#ifndef BASE_DATA_DB_I_DB_FRAGMENTED_JOB_H
+#define BASE_DATA_DB_I_DB_FRAGMENTED_JOB_H
+
+#include <cstddef>
+
+namespace MI {
+
+namespace DB {
+
+class Transaction;
+
+/// Base class for fragmented jobs.
+///
+/// The fragments of a job might be executed in any order and concurrently by any number of threads.
+/// The job has to stay valid until all fragments have been executed, i.e., until
+/// execute_fragmented() returns, or until the execution listener has been called.
+class Fragmented_job
+{
+public:
+    virtual ~Fragmented_job() { }
+
+    /// Executes one fragment of the job.
+    ///
+    /// \param transaction   The transaction the job was submitted from, or \c NULL for jobs
+    ///                      submitted via the database.
+    /// \param index         The index of the fragment, in the range [0, count).
+    /// \param count         The total number of fragments of the job.
+    virtual void execute_fragment(Transaction* transaction, size_t index, size_t count) = 0;
+
+    /// Returns the number of fragments that are executed at once by a single thread.
+    ///
+    /// Fragments are distributed over the threads in chunks of this size. Larger values reduce
+    /// the scheduling overhead for very small fragments. The default is 1.
+    virtual size_t get_chunk_size() const { return 1; }
+};
+
+/// Callback for the completion of asynchronously executed fragmented jobs.
+class IExecution_listener
+{
+public:
+    virtual ~IExecution_listener() { }
+
+    /// Called after all fragments of the job have been executed or skipped due to cancellation.
+    ///
+    /// The job and the listener are no longer accessed by the database after this call.
+    virtual void job_finished() = 0;
+};
+
+} // namespace DB
+
+} // namespace MI
+
+#endif // BASE_DATA_DB_I_DB_FRAGMENTED_JOB_H
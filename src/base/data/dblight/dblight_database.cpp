@@ -39,26 +39,150 @@
 #include "dblight_transaction.h"
 
 #include <base/system/main/i_assert.h>
+#include <base/system/main/i_module_id.h>
+#include <base/hal/disk/disk.h>
+#include <base/hal/disk/i_disk_file.h>
+#include <base/hal/hal/i_hal_ospath.h>
+#include <base/lib/log/i_log_logger.h>
 #include <base/data/db/i_db_element.h>
+#include <base/data/db/i_db_fragmented_job.h>
 #include <base/data/db/i_db_info.h>
 #include <base/data/db/i_db_transaction.h>
 #include <base/data/db/i_db_database.h>
+#include <base/data/serial/i_serial_file_serializer.h>
+#include <base/data/thread_pool/i_thread_pool.h>
+
+#include <algorithm>
+#include <cstdio>
+
+#ifdef MI_PLATFORM_WINDOWS
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
 
 namespace MI {
 
 namespace DBLIGHT {
 
-Database_impl::Database_impl()
+namespace {
+
+/// A version that is a candidate for swapping out.
+struct Swap_candidate
+{
+    DB::Tag m_tag;
+    DB::Info* m_info;
+    Uint64 m_last_access;
+
+    bool operator<(const Swap_candidate& other) const
+    { return m_last_access < other.m_last_access; }
+};
+
+/// Adapts fragmented jobs to the thread pool.
+class Fragmented_job_adapter : public THREAD_POOL::Job_base
+{
+public:
+    /// Constructor. Pins \p transaction for asynchronous jobs.
+    Fragmented_job_adapter(
+        Database_impl* database,
+        Transaction_impl* transaction,
+        DB::Fragmented_job* job,
+        size_t count,
+        Uint32 generation,
+        bool is_async,
+        DB::IExecution_listener* listener)
+      : THREAD_POOL::Job_base(count, job->get_chunk_size())
+      , m_database(database)
+      , m_transaction(transaction)
+      , m_job(job)
+      , m_generation(generation)
+      , m_is_async(is_async)
+      , m_listener(listener)
+    {
+        if (m_is_async && m_transaction)
+            m_transaction->pin();
+    }
+
+    void execute_fragment(size_t index)
+    {
+        // Cancelled jobs skip their remaining fragments.
+        if (m_database->get_fragmented_jobs_cancelled(m_generation)
+            || (m_transaction && m_transaction->get_fragmented_jobs_cancelled()))
+            return;
+
+        m_job->execute_fragment(m_transaction, index, get_count());
+    }
+
+    void job_finished()
+    {
+        MI_ASSERT(m_is_async);
+
+        if (m_listener)
+            m_listener->job_finished();
+        if (m_transaction) {
+            m_transaction->fragmented_job_finished();
+            m_transaction->unpin();
+        }
+        Database_impl* database = m_database;
+        delete this;
+        database->async_job_finished();
+    }
+
+private:
+    Database_impl* m_database;
+    Transaction_impl* m_transaction;
+    DB::Fragmented_job* m_job;
+    Uint32 m_generation;
+    bool m_is_async;
+    DB::IExecution_listener* m_listener;
+};
+
+} // namespace
+
+Database_impl::Database_impl(SERIAL::Deserialization_manager* deserialization_manager)
   : m_next_tag(0)
   , m_next_transaction_id(0)
+  , m_commit_sequence(0)
   , m_global_scope(new Scope_impl(this))
+  , m_deserialization_manager(deserialization_manager)
+  , m_low_water(0)
+  , m_high_water(0)
+  , m_memory_usage(0)
+  , m_swapped_memory_usage(0)
+  , m_nr_of_swapped_elements(0)
+  , m_next_swap_id(0)
+  , m_access_clock(0)
+  , m_thread_pool(THREAD_POOL::get_shared_thread_pool())
+  , m_nr_of_async_jobs(0)
+  , m_fragmented_jobs_generation(0)
 {
 }
 
 Database_impl::~Database_impl()
 {
-    for (Tag_map::iterator it = m_tags.begin(); it != m_tags.end(); ++it) {
-        DB::Info* info = it->second;
+    // The pool is shared, wait only for the asynchronous fragmented jobs of this database.
+    {
+        std::unique_lock<std::mutex> lock(m_async_jobs_mutex);
+        m_async_jobs_condition.wait(lock, [this] { return m_nr_of_async_jobs == 0; });
+    }
+    m_thread_pool.reset();
+
+    // Collect all infos first, destroying an info modifies the reference counts in the shards.
+    std::vector<DB::Info*> infos;
+    for (size_t i = 0; i < NUM_SHARDS; ++i) {
+        Tag_map& tags = m_tag_shards[i].m_tags;
+        for (Tag_map::iterator it = tags.begin(); it != tags.end(); ++it) {
+            std::vector<Tag_version_entry>& versions = it->second.m_versions;
+            for (size_t j = 0; j < versions.size(); ++j) {
+                discard_swapped(versions[j]);
+                infos.push_back(versions[j].m_info);
+            }
+        }
+        tags.clear();
+    }
+
+    for (size_t i = 0; i < infos.size(); ++i) {
+        DB::Info* info = infos[i];
         MI_ASSERT(info->get_pin_count() == 1);
         info->unpin();
     }
@@ -76,14 +200,7 @@ void Database_impl::close()
 void Database_impl::garbage_collection(int /*priority*/)
 {
     // Priority argument is ignored, always runs at highest priority.
-    Uint32 counter = m_global_scope->increment_transaction_count();
-    if (counter > 1) {
-        m_global_scope->decrement_transaction_count();
-        return;
-    }
-
     garbage_collection_internal();
-    m_global_scope->decrement_transaction_count();
 }
 
 DB::Scope* Database_impl::get_global_scope() { return m_global_scope; }
@@ -102,27 +219,57 @@ bool Database_impl::remove(DB::Scope_id id) { return false; }
 
 Sint32 Database_impl::set_memory_limits(size_t low_water, size_t high_water)
 {
-    MI_ASSERT(false);
-    return -1;
+    if (high_water > 0 && low_water > high_water)
+        return -1;
+
+    {
+        mi::base::Lock::Block block(&m_swap_config_lock);
+        m_low_water = low_water;
+        m_high_water = high_water;
+    }
+
+    check_memory_limits();
+    return 0;
 }
 
 void Database_impl::get_memory_limits(size_t& low_water, size_t& high_water) const
 {
-    MI_ASSERT(false);
-    low_water = 0; //-V779 PVS
-    high_water = 0;
+    mi::base::Lock::Block block(&m_swap_config_lock);
+    low_water = m_low_water;
+    high_water = m_high_water;
 }
 
 Sint32 Database_impl::set_disk_swapping(const char* path)
 {
-    MI_ASSERT(false);
-    return -1;
+    std::string directory = path ? path : "";
+
+    // Lock order: m_swap_run_lock, shard locks, m_swap_config_lock.
+    mi::base::Lock::Block run_block(&m_swap_run_lock);
+    mi::base::Lock::Block block(&m_swap_config_lock);
+
+    if (directory == m_swap_directory)
+        return 0;
+
+    // The names of the swap files depend on the directory.
+    if (m_nr_of_swapped_elements > 0)
+        return -1;
+
+    if (!directory.empty() && !DISK::is_directory(directory.c_str())
+        && !DISK::mkdir(directory.c_str()))
+        return -1;
+
+    if (!directory.empty() && !m_deserialization_manager)
+        LOG::mod_log->warning(M_DB, LOG::Mod_log::C_DATABASE,
+            "No deserialization manager available, elements will not be swapped out.");
+
+    m_swap_directory = directory;
+    return 0;
 }
 
 const char* Database_impl::get_disk_swapping() const
 {
-    MI_ASSERT(false);
-    return 0;
+    mi::base::Lock::Block block(&m_swap_config_lock);
+    return m_swap_directory.empty() ? 0 : m_swap_directory.c_str();
 }
 
 void Database_impl::lock(DB::Tag tag) { MI_ASSERT(false); }
@@ -145,8 +292,18 @@ std::string Database_impl::get_next_name(const std::string& pattern)
 
 DB::Database_statistics Database_impl::get_statistics()
 {
-    MI_ASSERT(false);
-    return DB::Database_statistics();
+    DB::Database_statistics result;
+
+    for (size_t i = 0; i < NUM_SHARDS; ++i) {
+        mi::base::Lock::Block block(&m_tag_shards[i].m_lock);
+        result.m_nr_of_stored_tags += static_cast<Uint>(m_tag_shards[i].m_tags.size());
+    }
+
+    ptrdiff_t memory_usage = m_memory_usage;
+    result.m_memory_usage = memory_usage > 0 ? static_cast<size_t>(memory_usage) : 0;
+    result.m_swapped_memory_usage = m_swapped_memory_usage;
+    result.m_nr_of_swapped_elements = m_nr_of_swapped_elements;
+    return result;
 }
 
 DB::Db_status Database_impl::get_database_status() { return DB::DB_OK; }
@@ -167,37 +324,375 @@ DB::Transaction* Database_impl::get_transaction(DB::Transaction_id id)
     return 0;
 }
 
-void Database_impl::cancel_all_fragmented_jobs() { MI_ASSERT(false); }
+void Database_impl::cancel_all_fragmented_jobs() { ++m_fragmented_jobs_generation; }
 
 Sint32 Database_impl::execute_fragmented(DB::Fragmented_job* job, size_t count)
 {
-    MI_ASSERT(false);
-    return -1;
+    return execute_fragmented(0, job, count);
 }
 
 Sint32 Database_impl::execute_fragmented_async(
     DB::Fragmented_job* job, size_t count,  DB::IExecution_listener* listener)
 {
-    MI_ASSERT(false);
-    return -1;
+    return execute_fragmented_async(0, job, count, listener);
+}
+
+Sint32 Database_impl::execute_fragmented(
+    Transaction_impl* transaction, DB::Fragmented_job* job, size_t count)
+{
+    if (!job || count == 0)
+        return -1;
+
+    Fragmented_job_adapter adapter(
+        this, transaction, job, count, m_fragmented_jobs_generation, /*is_async*/ false, 0);
+    m_thread_pool->execute(&adapter);
+    return 0;
 }
 
-void Database_impl::suspend_current_job() { MI_ASSERT(false); }
-void Database_impl::resume_current_job() { MI_ASSERT(false); }
-void Database_impl::yield() { MI_ASSERT(false); }
+Sint32 Database_impl::execute_fragmented_async(
+    Transaction_impl* transaction,
+    DB::Fragmented_job* job,
+    size_t count,
+    DB::IExecution_listener* listener)
+{
+    if (!job || count == 0)
+        return -1;
+
+    {
+        std::unique_lock<std::mutex> lock(m_async_jobs_mutex);
+        ++m_nr_of_async_jobs;
+    }
+
+    // deletes itself when finished
+    Fragmented_job_adapter* adapter = new Fragmented_job_adapter(
+        this, transaction, job, count, m_fragmented_jobs_generation, /*is_async*/ true, listener);
+    m_thread_pool->submit(adapter);
+    return 0;
+}
+
+void Database_impl::async_job_finished()
+{
+    std::unique_lock<std::mutex> lock(m_async_jobs_mutex);
+    MI_ASSERT(m_nr_of_async_jobs > 0);
+    if (--m_nr_of_async_jobs == 0)
+        m_async_jobs_condition.notify_all();
+}
+
+void Database_impl::suspend_current_job() { m_thread_pool->suspend_current_job(); }
+void Database_impl::resume_current_job() { m_thread_pool->resume_current_job(); }
+void Database_impl::yield() { m_thread_pool->yield(); }
+
+Uint32 Database_impl::register_transaction()
+{
+    mi::base::Lock::Block block(&m_commit_lock);
+    m_open_snapshots.insert(m_commit_sequence);
+    return m_commit_sequence;
+}
+
+void Database_impl::commit_transaction(
+    DB::Transaction_id id,
+    Uint32 snapshot,
+    const std::vector<DB::Tag>& tags,
+    const std::vector<std::pair<DB::Tag, std::string> >& names,
+    const std::vector<DB::Tag>& removals)
+{
+    // Holding m_commit_lock while stamping the versions makes the commit atomic w.r.t. the
+    // snapshots of transactions started concurrently.
+    mi::base::Lock::Block block(&m_commit_lock);
+
+    Uint32 sequence = ++m_commit_sequence;
+
+    for (size_t i = 0; i < tags.size(); ++i) {
+        Tag_shard& shard = get_shard(tags[i]);
+        mi::base::Lock::Block shard_block(&shard.m_lock);
+
+        Tag_map::iterator it = shard.m_tags.find(tags[i]);
+        if (it == shard.m_tags.end())
+            continue;
+
+        std::vector<Tag_version_entry>& versions = it->second.m_versions;
+        for (size_t j = 0; j < versions.size(); ++j) {
+            Tag_version_entry& version = versions[j];
+            if (version.m_commit_sequence == 0 && version.m_info->get_transaction_id() == id)
+                version.m_commit_sequence = sequence;
+        }
+    }
+
+    for (size_t i = 0; i < names.size(); ++i)
+        add_name(names[i].first, names[i].second, sequence);
+
+    for (size_t i = 0; i < removals.size(); ++i)
+        add_removal(removals[i], sequence);
+
+    std::multiset<Uint32>::iterator it = m_open_snapshots.find(snapshot);
+    MI_ASSERT(it != m_open_snapshots.end());
+    m_open_snapshots.erase(it);
+}
+
+void Database_impl::abort_transaction(
+    DB::Transaction_id id, Uint32 snapshot, const std::vector<DB::Tag>& tags)
+{
+    std::vector<DB::Info*> dropped;
+    std::vector<DB::Tag> emptied;
+    for (size_t i = 0; i < tags.size(); ++i) {
+        Tag_shard& shard = get_shard(tags[i]);
+        mi::base::Lock::Block shard_block(&shard.m_lock);
+
+        Tag_map::iterator it = shard.m_tags.find(tags[i]);
+        if (it == shard.m_tags.end())
+            continue;
+
+        std::vector<Tag_version_entry>& versions = it->second.m_versions;
+        std::vector<Tag_version_entry> kept;
+        for (size_t j = 0; j < versions.size(); ++j) {
+            const Tag_version_entry& version = versions[j];
+            if (version.m_commit_sequence == 0 && version.m_info->get_transaction_id() == id) {
+                discard_swapped(version);
+                dropped.push_back(version.m_info);
+            } else
+                kept.push_back(version);
+        }
+        versions.swap(kept);
+
+        // the tag was created by this transaction, drop its self-reference
+        if (versions.empty())
+            emptied.push_back(tags[i]);
+    }
+
+    for (size_t i = 0; i < emptied.size(); ++i)
+        decrement_reference_count(emptied[i]);
+
+    // unpin outside of the locks, destroying the info decrements reference counts
+    for (size_t i = 0; i < dropped.size(); ++i)
+        dropped[i]->unpin();
+
+    {
+        mi::base::Lock::Block block(&m_commit_lock);
+        std::multiset<Uint32>::iterator it = m_open_snapshots.find(snapshot);
+        MI_ASSERT(it != m_open_snapshots.end());
+        m_open_snapshots.erase(it);
+    }
+
+    garbage_collection_internal();
+}
+
+bool Database_impl::add_version(DB::Info* info)
+{
+    DB::Tag tag = info->get_tag();
+    DB::Transaction_id id = info->get_transaction_id();
+
+    DB::Info* replaced = 0;
+    bool is_new_tag = false;
+    bool is_multi_version = false;
+    {
+        Tag_shard& shard = get_shard(tag);
+        mi::base::Lock::Block block(&shard.m_lock);
+
+        Tag_map::iterator it = shard.m_tags.find(tag);
+        if (it == shard.m_tags.end()) {
+            it = shard.m_tags.insert(std::make_pair(tag, Tag_entry())).first;
+            is_new_tag = true;
+        } else {
+            is_new_tag = it->second.m_versions.empty();
+        }
+
+        Tag_version_entry entry;
+        entry.m_info = info;
+        entry.m_commit_sequence = 0;
+        entry.m_swap_id = 0;
+        entry.m_swapped_size = 0;
+        entry.m_last_access = ++m_access_clock;
+
+        std::vector<Tag_version_entry>& versions = it->second.m_versions;
+        for (size_t j = 0; j < versions.size(); ++j) {
+            if (versions[j].m_commit_sequence == 0 && versions[j].m_info->get_transaction_id() == id) {
+                // replace the uncommitted version of the same transaction
+                discard_swapped(versions[j]);
+                replaced = versions[j].m_info;
+                versions[j] = entry;
+                break;
+            }
+        }
+        if (!replaced)
+            versions.push_back(entry);
+        is_multi_version = versions.size() > 1;
+
+        // the self-reference of new tags
+        if (is_new_tag && ++it->second.m_reference_count == 1) {
+            mi::base::Lock::Block gc_block(&m_gc_lock);
+            m_reference_count_zero.erase(tag);
+        }
+    }
+
+    if (is_multi_version) {
+        mi::base::Lock::Block gc_block(&m_gc_lock);
+        m_multi_version_tags.insert(tag);
+    }
+
+    // unpin outside of the shard lock, destroying the info decrements reference counts
+    if (replaced)
+        replaced->unpin();
+
+    return replaced != 0;
+}
+
+DB::Info* Database_impl::lookup_version(DB::Tag tag, DB::Transaction_id id, Uint32 snapshot)
+{
+    Tag_shard& shard = get_shard(tag);
+    mi::base::Lock::Block block(&shard.m_lock);
+
+    Tag_map::iterator it = shard.m_tags.find(tag);
+    if (it == shard.m_tags.end())
+        return 0;
+
+    // Own (uncommitted) versions take precedence, then the latest commit within the snapshot.
+    // Versions from the same commit are ordered by creation.
+    std::vector<Tag_version_entry>& versions = it->second.m_versions;
+    Tag_version_entry* best = 0;
+    for (size_t j = 0; j < versions.size(); ++j) {
+        Tag_version_entry& version = versions[j];
+        if (version.m_commit_sequence == 0) {
+            if (version.m_info->get_transaction_id() == id) {
+                best = &version;
+                break;
+            }
+            continue;
+        }
+        if (version.m_commit_sequence > snapshot)
+            continue;
+        if (!best || version.m_commit_sequence >= best->m_commit_sequence)
+            best = &version;
+    }
+
+    if (!best)
+        return 0;
+
+    if (best->m_swap_id != 0 && !swap_in(*best))
+        return 0;
+
+    best->m_last_access = ++m_access_clock;
+    best->m_info->pin();
+    return best->m_info;
+}
+
+bool Database_impl::get_tag_is_removed(DB::Tag tag, Uint32 snapshot)
+{
+    Tag_shard& shard = get_shard(tag);
+    mi::base::Lock::Block block(&shard.m_lock);
+
+    Tag_map::const_iterator it = shard.m_tags.find(tag);
+    if (it == shard.m_tags.end())
+        return false;
+
+    Uint32 removal = it->second.m_removal_sequence;
+    return removal != 0 && removal <= snapshot;
+}
+
+bool Database_impl::tag_to_name(DB::Tag tag, Uint32 snapshot, std::string& name)
+{
+    Tag_shard& shard = get_shard(tag);
+    mi::base::Lock::Block block(&shard.m_lock);
+
+    Tag_map::const_iterator it = shard.m_tags.find(tag);
+    if (it == shard.m_tags.end())
+        return false;
+
+    // the names are ordered by commit, the last one within the snapshot is visible
+    const std::vector<Tag_name_entry>& names = it->second.m_names;
+    for (size_t j = names.size(); j > 0; --j)
+        if (names[j-1].m_commit_sequence <= snapshot) {
+            name = names[j-1].m_name;
+            return true;
+        }
+    return false;
+}
+
+DB::Tag Database_impl::name_to_tag(const std::string& name, Uint32 snapshot)
+{
+    Name_shard& shard = get_shard(name);
+    mi::base::Lock::Block block(&shard.m_lock);
+
+    Named_tag_map::const_iterator it = shard.m_named_tags.find(name);
+    if (it == shard.m_named_tags.end())
+         return DB::Tag();
+
+    const std::vector<Named_tag_entry>& tags = it->second;
+    for (size_t j = tags.size(); j > 0; --j)
+        if (tags[j-1].m_commit_sequence <= snapshot)
+            return tags[j-1].m_tag;
+    return DB::Tag();
+}
+
+void Database_impl::add_name(DB::Tag tag, const std::string& name, Uint32 sequence)
+{
+    bool is_multi_version_tag;
+    {
+        Tag_shard& shard = get_shard(tag);
+        mi::base::Lock::Block block(&shard.m_lock);
+
+        std::vector<Tag_name_entry>& names = shard.m_tags[tag].m_names;
+        Tag_name_entry entry = { sequence, name };
+        names.push_back(entry);
+        is_multi_version_tag = names.size() > 1;
+    }
+
+    bool is_multi_version_name;
+    {
+        Name_shard& shard = get_shard(name);
+        mi::base::Lock::Block block(&shard.m_lock);
+
+        std::vector<Named_tag_entry>& tags = shard.m_named_tags[name];
+        Named_tag_entry entry = { sequence, tag };
+        tags.push_back(entry);
+        is_multi_version_name = tags.size() > 1;
+    }
+
+    if (is_multi_version_tag || is_multi_version_name) {
+        mi::base::Lock::Block gc_block(&m_gc_lock);
+        if (is_multi_version_tag)
+            m_multi_version_tags.insert(tag);
+        if (is_multi_version_name)
+            m_multi_version_names.insert(name);
+    }
+}
+
+void Database_impl::add_removal(DB::Tag tag, Uint32 sequence)
+{
+    {
+        Tag_shard& shard = get_shard(tag);
+        mi::base::Lock::Block block(&shard.m_lock);
+
+        Tag_entry& entry = shard.m_tags[tag];
+        if (entry.m_removal_sequence != 0)
+            return;
+        entry.m_removal_sequence = sequence;
+    }
+
+    decrement_reference_count(tag);
+}
 
 void Database_impl::increment_reference_count(DB::Tag tag)
 {
-    Uint32 value = ++m_reference_counts[tag];
-    if (value == 1)
+    Tag_shard& shard = get_shard(tag);
+    mi::base::Lock::Block block(&shard.m_lock);
+
+    Uint32 value = ++shard.m_tags[tag].m_reference_count;
+    if (value == 1) {
+        mi::base::Lock::Block gc_block(&m_gc_lock);
         m_reference_count_zero.erase(tag);
+    }
 }
 
 void Database_impl::decrement_reference_count(DB::Tag tag)
 {
-    Uint32 value = --m_reference_counts[tag];
-    if (value == 0)
+    Tag_shard& shard = get_shard(tag);
+    mi::base::Lock::Block block(&shard.m_lock);
+
+    Uint32 value = --shard.m_tags[tag].m_reference_count;
+    if (value == 0) {
+        mi::base::Lock::Block gc_block(&m_gc_lock);
         m_reference_count_zero.insert(tag);
+    }
 }
 
 void Database_impl::increment_reference_counts(const DB::Tag_set& tag_set)
@@ -220,17 +715,156 @@ void Database_impl::decrement_reference_counts(const DB::Tag_set& tag_set)
 
 Uint32 Database_impl::get_tag_reference_count(DB::Tag tag)
 {
-    mi::base::Lock::Block block(&m_lock);
-    return m_reference_counts[tag];
+    Tag_shard& shard = get_shard(tag);
+    mi::base::Lock::Block block(&shard.m_lock);
+
+    Tag_map::const_iterator it = shard.m_tags.find(tag);
+    return it != shard.m_tags.end() ? it->second.m_reference_count : 0;
 }
 
 void Database_impl::garbage_collection_internal()
 {
-    mi::base::Lock::Block block(&m_lock);
+    mi::base::Lock::Block block(&m_gc_run_lock);
+
+    prune_versions();
+
+    bool has_open_transactions;
+    {
+        mi::base::Lock::Block commit_block(&m_commit_lock);
+        has_open_transactions = !m_open_snapshots.empty();
+    }
+
+    // Unreferenced tags are only removed if no transaction can still access them.
+    if (!has_open_transactions)
+        remove_unreferenced_tags();
+}
 
+void Database_impl::prune_versions()
+{
+    // Committed versions up to the oldest open snapshot are only visible through the latest of
+    // them, all older ones can be dropped.
+    Uint32 horizon;
+    {
+        mi::base::Lock::Block commit_block(&m_commit_lock);
+        horizon = m_open_snapshots.empty() ? m_commit_sequence : *m_open_snapshots.begin();
+    }
+
+    prune_names(horizon);
+
+    std::set<DB::Tag> candidates;
+    {
+        mi::base::Lock::Block gc_block(&m_gc_lock);
+        candidates.swap(m_multi_version_tags);
+    }
+
+    std::vector<DB::Info*> dropped;
+    std::set<DB::Tag>::const_iterator it     = candidates.begin();
+    std::set<DB::Tag>::const_iterator it_end = candidates.end();
+    for ( ; it != it_end; ++it) {
+
+        DB::Tag tag = *it;
+        bool still_multi_version = false;
+        {
+            Tag_shard& shard = get_shard(tag);
+            mi::base::Lock::Block shard_block(&shard.m_lock);
+
+            Tag_map::iterator it_entry = shard.m_tags.find(tag);
+            if (it_entry == shard.m_tags.end())
+                continue;
+
+            std::vector<Tag_version_entry>& versions = it_entry->second.m_versions;
+            const Tag_version_entry* latest = 0;
+            for (size_t j = 0; j < versions.size(); ++j) {
+                const Tag_version_entry& version = versions[j];
+                if (version.m_commit_sequence != 0 && version.m_commit_sequence <= horizon
+                    && (!latest || version.m_commit_sequence >= latest->m_commit_sequence))
+                    latest = &version;
+            }
+
+            std::vector<Tag_version_entry> kept;
+            for (size_t j = 0; j < versions.size(); ++j) {
+                const Tag_version_entry& version = versions[j];
+                if (latest && &version != latest && version.m_commit_sequence != 0
+                    && version.m_commit_sequence <= horizon) {
+                    discard_swapped(version);
+                    dropped.push_back(version.m_info);
+                } else
+                    kept.push_back(version);
+            }
+            versions.swap(kept);
+
+            // the same for the names
+            std::vector<Tag_name_entry>& names = it_entry->second.m_names;
+            size_t latest_name = names.size();
+            for (size_t j = names.size(); j > 0; --j)
+                if (names[j-1].m_commit_sequence <= horizon) {
+                    latest_name = j-1;
+                    break;
+                }
+            if (latest_name < names.size())
+                names.erase(names.begin(), names.begin() + latest_name);
+
+            still_multi_version = versions.size() > 1 || names.size() > 1;
+        }
+
+        if (still_multi_version) {
+            mi::base::Lock::Block gc_block(&m_gc_lock);
+            m_multi_version_tags.insert(tag);
+        }
+    }
+
+    // unpin outside of the locks, destroying the info decrements reference counts
+    for (size_t i = 0; i < dropped.size(); ++i)
+        dropped[i]->unpin();
+}
+
+void Database_impl::prune_names(Uint32 horizon)
+{
+    std::set<std::string> candidates;
+    {
+        mi::base::Lock::Block gc_block(&m_gc_lock);
+        candidates.swap(m_multi_version_names);
+    }
+
+    std::set<std::string>::const_iterator it     = candidates.begin();
+    std::set<std::string>::const_iterator it_end = candidates.end();
+    for ( ; it != it_end; ++it) {
+
+        bool still_multi_version = false;
+        {
+            Name_shard& shard = get_shard(*it);
+            mi::base::Lock::Block shard_block(&shard.m_lock);
+
+            Named_tag_map::iterator it_name = shard.m_named_tags.find(*it);
+            if (it_name == shard.m_named_tags.end())
+                continue;
+
+            // only the latest assignment up to the horizon and later ones are visible
+            std::vector<Named_tag_entry>& tags = it_name->second;
+            for (size_t j = tags.size(); j > 0; --j)
+                if (tags[j-1].m_commit_sequence <= horizon) {
+                    tags.erase(tags.begin(), tags.begin() + (j-1));
+                    break;
+                }
+            still_multi_version = tags.size() > 1;
+        }
+
+        if (still_multi_version) {
+            mi::base::Lock::Block gc_block(&m_gc_lock);
+            m_multi_version_names.insert(*it);
+        }
+    }
+}
+
+void Database_impl::remove_unreferenced_tags()
+{
     while (true) {
 
-        DB::Tag_set candidates = m_reference_count_zero;
+        DB::Tag_set candidates;
+        {
+            mi::base::Lock::Block gc_block(&m_gc_lock);
+            candidates = m_reference_count_zero;
+        }
         if (candidates.empty())
             return;
 
@@ -239,35 +873,250 @@ void Database_impl::garbage_collection_internal()
         for ( ;  it != it_end; ++it) {
 
             DB::Tag tag = *it;
+            Tag_entry entry;
+            {
+                Tag_shard& shard = get_shard(tag);
+                mi::base::Lock::Block shard_block(&shard.m_lock);
 
-            Tag_map::iterator it_info = m_tags.find(tag);
-            it_info->second->unpin(); //-V783 PVS
-            m_tags.erase(it_info);
+                Tag_map::iterator it_entry = shard.m_tags.find(tag);
+                if (it_entry != shard.m_tags.end()) {
+                    if (it_entry->second.m_reference_count != 0)
+                        continue;
+                    entry.m_versions.swap(it_entry->second.m_versions);
+                    entry.m_names.swap(it_entry->second.m_names);
+                    shard.m_tags.erase(it_entry);
+                }
 
-            Reverse_named_tag_map::iterator it_name = m_reverse_named_tags.find(tag);
-            if( it_name != m_reverse_named_tags.end()) {
-                m_named_tags.erase(it_name->second);
-                m_reverse_named_tags.erase(it_name);
+                mi::base::Lock::Block gc_block(&m_gc_lock);
+                m_reference_count_zero.erase(tag);
             }
 
-            m_tags_flagged_for_removal.erase(tag);
-            m_reference_counts.erase(tag);
-            m_reference_count_zero.erase(tag);
+            for (size_t j = 0; j < entry.m_names.size(); ++j) {
+                const std::string& name = entry.m_names[j].m_name;
+                Name_shard& shard = get_shard(name);
+                mi::base::Lock::Block name_block(&shard.m_lock);
+
+                // the name might have been reused for other tags in the meantime
+                Named_tag_map::iterator it_name = shard.m_named_tags.find(name);
+                if (it_name == shard.m_named_tags.end())
+                    continue;
+                std::vector<Named_tag_entry>& tags = it_name->second;
+                std::vector<Named_tag_entry> kept;
+                for (size_t k = 0; k < tags.size(); ++k)
+                    if (tags[k].m_tag != tag)
+                        kept.push_back(tags[k]);
+                if (kept.empty())
+                    shard.m_named_tags.erase(it_name);
+                else
+                    tags.swap(kept);
+            }
+
+            // unpin outside of the locks, destroying the info decrements reference counts
+            for (size_t j = 0; j < entry.m_versions.size(); ++j) {
+                discard_swapped(entry.m_versions[j]);
+                entry.m_versions[j].m_info->unpin();
+            }
         }
     }
 }
 
+void Database_impl::check_memory_limits()
+{
+    size_t high_water;
+    {
+        mi::base::Lock::Block block(&m_swap_config_lock);
+        if (m_swap_directory.empty() || !m_deserialization_manager)
+            return;
+        high_water = m_high_water;
+    }
+
+    if (high_water == 0 || m_memory_usage <= static_cast<ptrdiff_t>(high_water))
+        return;
+
+    swap_out_elements();
+}
+
+void Database_impl::swap_out_elements()
+{
+    // Concurrent callers do not need to wait, the running call already frees memory.
+    mi::base::Lock::Block run_block;
+    if (!run_block.try_set(&m_swap_run_lock))
+        return;
+
+    size_t low_water;
+    {
+        mi::base::Lock::Block block(&m_swap_config_lock);
+        low_water = m_low_water;
+    }
+
+    std::vector<Swap_candidate> candidates;
+    for (size_t i = 0; i < NUM_SHARDS; ++i) {
+        mi::base::Lock::Block block(&m_tag_shards[i].m_lock);
+        Tag_map& tags = m_tag_shards[i].m_tags;
+        for (Tag_map::const_iterator it = tags.begin(); it != tags.end(); ++it) {
+            const std::vector<Tag_version_entry>& versions = it->second.m_versions;
+            for (size_t j = 0; j < versions.size(); ++j)
+                if (can_swap_out(versions[j])) {
+                    Swap_candidate candidate = { it->first, versions[j].m_info,
+                                                 versions[j].m_last_access };
+                    candidates.push_back(candidate);
+                }
+        }
+    }
+
+    // least recently used first
+    std::sort(candidates.begin(), candidates.end());
+
+    for (size_t i = 0; i < candidates.size(); ++i) {
+
+        if (m_memory_usage <= static_cast<ptrdiff_t>(low_water))
+            return;
+
+        // The version might have been dropped, pinned, or swapped in the meantime.
+        const Swap_candidate& candidate = candidates[i];
+        Tag_shard& shard = get_shard(candidate.m_tag);
+        mi::base::Lock::Block block(&shard.m_lock);
 
-DB::Database* factory()
+        Tag_map::iterator it = shard.m_tags.find(candidate.m_tag);
+        if (it == shard.m_tags.end())
+            continue;
+
+        std::vector<Tag_version_entry>& versions = it->second.m_versions;
+        for (size_t j = 0; j < versions.size(); ++j)
+            if (versions[j].m_info == candidate.m_info) {
+                if (can_swap_out(versions[j]))
+                    swap_out(versions[j]);
+                break;
+            }
+    }
+}
+
+bool Database_impl::can_swap_out(const Tag_version_entry& version) const
 {
-    return new Database_impl;
+    // Elements pinned by accesses or edits need to stay in memory.
+    if (version.m_swap_id != 0 || version.m_info->get_pin_count() != 1)
+        return false;
+
+    const DB::Element_base* element = version.m_info->get_element();
+    return element && m_deserialization_manager->is_registered(element->get_class_id());
+}
+
+bool Database_impl::swap_out(Tag_version_entry& version)
+{
+    DB::Info* info = version.m_info;
+    Uint64 swap_id = ++m_next_swap_id;
+    std::string file_name = get_swap_file_name(swap_id);
+
+    DISK::File file;
+    if (!file.open(file_name.c_str(), DISK::IFile::M_WRITE)) {
+        LOG::mod_log->error(M_DB, LOG::Mod_log::C_DATABASE,
+            "Failed to open swap file \"%s\".", file_name.c_str());
+        return false;
+    }
+
+    SERIAL::File_serializer serializer;
+    serializer.set_output_file(&file);
+    serializer.serialize(info->get_element());
+    bool success = serializer.is_valid();
+    success = file.close() && success;
+    if (!success) {
+        LOG::mod_log->error(M_DB, LOG::Mod_log::C_DATABASE,
+            "Failed to write swap file \"%s\".", file_name.c_str());
+        DISK::file_remove(file_name.c_str());
+        return false;
+    }
+
+    version.m_swap_id = swap_id;
+    version.m_swapped_size = info->get_element_size();
+    m_swapped_memory_usage += version.m_swapped_size;
+    ++m_nr_of_swapped_elements;
+
+    info->set_element(0);
+    return true;
+}
+
+bool Database_impl::swap_in(Tag_version_entry& version)
+{
+    std::string file_name = get_swap_file_name(version.m_swap_id);
+
+    DISK::File file;
+    if (!file.open(file_name.c_str(), DISK::IFile::M_READ)) {
+        LOG::mod_log->error(M_DB, LOG::Mod_log::C_DATABASE,
+            "Failed to open swap file \"%s\".", file_name.c_str());
+        return false;
+    }
+
+    SERIAL::File_deserializer deserializer(m_deserialization_manager);
+    deserializer.set_input_file(&file);
+    SERIAL::Serializable* serializable = deserializer.deserialize_file();
+    if (!serializable || !deserializer.is_valid()) {
+        LOG::mod_log->error(M_DB, LOG::Mod_log::C_DATABASE,
+            "Failed to read swap file \"%s\".", file_name.c_str());
+        delete serializable;
+        return false;
+    }
+    file.close();
+
+    version.m_info->set_element(static_cast<DB::Element_base*>(serializable));
+
+    discard_swapped(version);
+    version.m_swap_id = 0;
+    version.m_swapped_size = 0;
+    return true;
+}
+
+void Database_impl::discard_swapped(const Tag_version_entry& version)
+{
+    if (version.m_swap_id == 0)
+        return;
+
+    DISK::file_remove(get_swap_file_name(version.m_swap_id).c_str());
+    m_swapped_memory_usage -= version.m_swapped_size;
+    --m_nr_of_swapped_elements;
+}
+
+std::string Database_impl::get_swap_file_name(Uint64 swap_id) const
+{
+#ifdef MI_PLATFORM_WINDOWS
+    int pid = _getpid();
+#else
+    int pid = getpid();
+#endif
+
+    // The process ID and the address of the database keep swap directories shareable.
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "dblight_%d_%p_%llu.swap",
+        pid, static_cast<const void*>(this), static_cast<unsigned long long>(swap_id));
+
+    mi::base::Lock::Block block(&m_swap_config_lock);
+    return HAL::Ospath::join(m_swap_directory, buffer);
+}
+
+DB::Database* factory(SERIAL::Deserialization_manager* deserialization_manager)
+{
+    return new Database_impl(deserialization_manager);
 }
 
 } // namespace DBLIGHT
 
 namespace DBNR { class Transaction_impl : public DB::Transaction { }; }
 
-namespace DB { Database_statistics::Database_statistics() { MI_ASSERT(false); } } //-V730 PVS
+namespace DB {
+
+Database_statistics::Database_statistics()
+  : m_nr_of_stored_tags(0)
+  , m_nr_of_received_updates(0)
+  , m_nr_of_received_objects(0)
+  , m_nr_of_received_transactions(0)
+  , m_nr_of_created_transactions(0)
+  , m_nr_of_known_hosts(0)
+  , m_memory_usage(0)
+  , m_swapped_memory_usage(0)
+  , m_nr_of_swapped_elements(0)
+{
+}
+
+} // namespace DB
 
 } // namespace MI
 
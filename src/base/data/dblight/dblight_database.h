@@ -39,42 +39,136 @@
 
 #include <string>
 #include <map>
+#include <set>
+#include <vector>
+#include <unordered_map>
 #include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
 #include <mi/base/lock.h>
 
 namespace MI {
 
 namespace DB { class Info; }
+namespace SERIAL { class Deserialization_manager; }
+namespace THREAD_POOL { class Thread_pool; }
 
 
 namespace DBLIGHT {
 
 class Scope_impl;
+class Transaction_impl;
 
-/// Map of tags to infos
-typedef std::map<DB::Tag, DB::Info*> Tag_map;
+/// One version of a tag.
+///
+/// Versions are created by #Transaction_impl::store() and #Transaction_impl::edit_element(). A
+/// version becomes visible to other transactions when the creating transaction commits.
+struct Tag_version_entry
+{
+    /// The info of this version. The tag entry holds one pin.
+    DB::Info* m_info;
+    /// The commit sequence number of the creating transaction, or 0 if not yet committed.
+    Uint32 m_commit_sequence;
+    /// The ID of the swap file if the element has been swapped out, or 0.
+    Uint64 m_swap_id;
+    /// The size of the element before it has been swapped out.
+    size_t m_swapped_size;
+    /// The value of the access clock at the last lookup of this version. Used to swap out the
+    /// least recently used elements first.
+    Uint64 m_last_access;
+};
 
-/// Map of names (strings) to tags
-typedef std::map<std::string, DB::Tag> Named_tag_map;
+/// One committed name of a tag.
+struct Tag_name_entry
+{
+    /// The commit sequence number of the transaction that set the name.
+    Uint32 m_commit_sequence;
+    /// The name.
+    std::string m_name;
+};
 
-/// Map of tags to names (strings)
-typedef std::map<DB::Tag, std::string> Reverse_named_tag_map;
+/// All versions of a tag plus the data shared by all versions.
+struct Tag_entry
+{
+    Tag_entry() : m_reference_count(0), m_removal_sequence(0) { }
+
+    /// The version chain, in order of creation.
+    std::vector<Tag_version_entry> m_versions;
+    /// The committed names of the tag, in order of commit.
+    std::vector<Tag_name_entry> m_names;
+    /// The reference count of the tag.
+    Uint32 m_reference_count;
+    /// The commit sequence number of the transaction that flagged the tag for removal, or 0.
+    Uint32 m_removal_sequence;
+};
 
-/// Set of tags flagged for removal
-typedef std::set<DB::Tag> Flagged_for_removal_set;
+/// One committed assignment of a name to a tag.
+struct Named_tag_entry
+{
+    /// The commit sequence number of the transaction that assigned the name.
+    Uint32 m_commit_sequence;
+    /// The tag.
+    DB::Tag m_tag;
+};
+
+/// Hash functor for tags.
+struct Tag_hash
+{
+    size_t operator()(DB::Tag tag) const { return tag.get_uint(); }
+};
+
+/// Map of tags to tag entries
+typedef std::unordered_map<DB::Tag, Tag_entry, Tag_hash> Tag_map;
 
-/// Map of tags to reference count
-typedef std::map<DB::Tag, Uint32> Reference_count_map;
+/// Map of names (strings) to the tags assigned to them, in order of commit
+typedef std::unordered_map<std::string, std::vector<Named_tag_entry> > Named_tag_map;
 
 /// Set of tags with reference count zero
 typedef std::set<DB::Tag> Reference_count_zero_set;
 
+/// One shard of the tag table.
+struct Tag_shard
+{
+    /// The lock for #m_tags.
+    mi::base::Lock m_lock;
+    /// The tag entries of this shard. Needs #m_lock.
+    Tag_map m_tags;
+};
+
+/// One shard of the table of named tags.
+struct Name_shard
+{
+    /// The lock for #m_named_tags.
+    mi::base::Lock m_lock;
+    /// The named tags of this shard. Needs #m_lock.
+    Named_tag_map m_named_tags;
+};
+
 /// The database class manages the whole database.
+///
+/// Tags are distributed over #NUM_SHARDS shards, each with its own lock, such that concurrent
+/// accesses to different tags do not contend. Each tag has a chain of versions, and each
+/// transaction sees the versions committed before it was started (plus its own versions). Names
+/// and removal flags are versioned the same way: transactions record them locally and they
+/// become visible to transactions started after the commit.
+///
+/// If memory limits and a swap directory are set, the least recently used elements are swapped
+/// out to disk when the memory usage exceeds the high water mark, until it drops below the low
+/// water mark. Only elements that are not pinned by anyone except the database and whose class is
+/// registered with the deserialization manager are swapped out. Swapped out elements are swapped
+/// in again when they are looked up.
 class Database_impl : public DB::Database
 {
 public:
+    /// Number of shards for the tag and name tables, must be a power of two.
+    static const size_t NUM_SHARDS = 64;
+
     /// Constructor
-    Database_impl();
+    ///
+    /// \param deserialization_manager   Used to swap in elements. Swapping is not supported if
+    ///                                  \c NULL.
+    Database_impl(SERIAL::Deserialization_manager* deserialization_manager);
 
     /// Destructor, empties the database
     ~Database_impl();
@@ -118,6 +212,31 @@ public:
     void resume_current_job();
     void yield();
 
+    /// Used by the transaction to execute a fragmented job in the thread pool.
+    ///
+    /// \param transaction   The transaction passed to the fragments. The job is skipped if the
+    ///                      fragmented jobs of the transaction are cancelled.
+    Sint32 execute_fragmented(
+        Transaction_impl* transaction, DB::Fragmented_job* job, size_t count);
+
+    /// Used by the transaction to execute a fragmented job asynchronously in the thread pool.
+    ///
+    /// \param transaction   The transaction passed to the fragments. It is pinned until the job
+    ///                      is finished and notified via Transaction_impl::fragmented_job_finished().
+    Sint32 execute_fragmented_async(
+        Transaction_impl* transaction,
+        DB::Fragmented_job* job,
+        size_t count,
+        DB::IExecution_listener* listener);
+
+    /// Used by asynchronous fragmented jobs when they are finished.
+    void async_job_finished();
+
+    /// Indicates whether all fragmented jobs submitted up to the given generation have been
+    /// cancelled via #cancel_all_fragmented_jobs().
+    bool get_fragmented_jobs_cancelled(Uint32 generation) const
+    { return m_fragmented_jobs_generation != generation; }
+
     /// Used by the transaction to allocate new tags
     DB::Tag allocate_tag() { return DB::Tag(++m_next_tag); }
 
@@ -125,66 +244,200 @@ public:
     DB::Transaction_id allocate_transaction_id()
     { return DB::Transaction_id(++m_next_transaction_id); }
 
+    /// Used by the scope to register a new transaction. Returns the snapshot, i.e., the commit
+    /// sequence number of the last commit visible to the new transaction.
+    Uint32 register_transaction();
+
+    /// Used by the transaction to commit its changes.
+    ///
+    /// Makes all versions of the transaction \p id for \p tags, the names \p names and the
+    /// removal flags for \p removals atomically visible to transactions started afterwards, and
+    /// unregisters the transaction with the snapshot \p snapshot.
+    void commit_transaction(
+        DB::Transaction_id id,
+        Uint32 snapshot,
+        const std::vector<DB::Tag>& tags,
+        const std::vector<std::pair<DB::Tag, std::string> >& names,
+        const std::vector<DB::Tag>& removals);
+
+    /// Used by the transaction to discard its changes if it is destroyed without commit.
+    ///
+    /// Drops the uncommitted versions of the transaction \p id for \p tags, and unregisters the
+    /// transaction with the snapshot \p snapshot.
+    void abort_transaction(
+        DB::Transaction_id id, Uint32 snapshot, const std::vector<DB::Tag>& tags);
+
+    /// Used by the transaction to add a new version of a tag.
+    ///
+    /// An older uncommitted version of the same transaction is replaced, other versions are kept
+    /// for transactions that still see them. Increments the reference count of new tags.
+    ///
+    /// \param info       The info of the new version. Ownership of one pin is transferred.
+    /// \return           \c true if a version of the same transaction was replaced.
+    bool add_version(DB::Info* info);
+
+    /// Used by the transaction to look up the version of a tag visible to a transaction.
+    ///
+    /// \param tag        The tag to look up.
+    /// \param id         The ID of the looking-up transaction.
+    /// \param snapshot   The snapshot of the looking-up transaction.
+    /// \return           The visible version (pinned), or \c NULL.
+    DB::Info* lookup_version(DB::Tag tag, DB::Transaction_id id, Uint32 snapshot);
+
+    /// Indicates whether a tag has been flagged for removal by a commit within \p snapshot.
+    bool get_tag_is_removed(DB::Tag tag, Uint32 snapshot);
+
+    /// Returns the name of a tag committed within \p snapshot.
+    ///
+    /// \return           \c false if the tag has no such name.
+    bool tag_to_name(DB::Tag tag, Uint32 snapshot, std::string& name);
+
+    /// Returns the tag for a name committed within \p snapshot, or the invalid tag.
+    DB::Tag name_to_tag(const std::string& name, Uint32 snapshot);
+
     /// Used by the info/transaction to increment the reference count of the tag.
-    /// Needs #m_lock.
     void increment_reference_count(DB::Tag tag);
 
     /// Used by the info/transaction to decrement the reference counts of the tag.
-    /// Needs #m_lock.
     void decrement_reference_count(DB::Tag tag);
 
     /// Used by the info to increment the reference counts of the referenced elements.
-    /// Needs #m_lock.
     void increment_reference_counts(const DB::Tag_set& tag_set);
 
     /// Used by the info to decrement the reference counts of the referenced elements.
-    /// Needs #m_lock.
     void decrement_reference_counts(const DB::Tag_set& tag_set);
 
     /// Returns the reference count of the tag.
     Uint32 get_tag_reference_count(DB::Tag tag);
 
-    /// Used by the transaction during commit(). The caller must ensure that there is no open
-    /// transaction.
+    /// Used by the transaction during commit(). Removes tags with reference count zero if there
+    /// is no open transaction and versions that are no longer visible to any transaction.
     void garbage_collection_internal();
 
-    /// Used by the transaction to access the tag map. Needs #m_lock.
-    Tag_map& get_tag_map() { return m_tags; }
-    /// Used by the transaction to access the named tag map. Needs #m_lock.
-    Named_tag_map& get_named_tag_map() { return m_named_tags; }
-    /// Used by the transaction to access the reverse tag map. Needs #m_lock.
-    Reverse_named_tag_map& get_reverse_named_tag_map() { return m_reverse_named_tags; }
-    /// Used by the transaction to track removal requests. Needs #m_lock.
-    Flagged_for_removal_set& get_flagged_for_removal_set() { return m_tags_flagged_for_removal; }
+    /// Used by the info to keep track of the memory usage of all elements.
+    void update_memory_usage(ptrdiff_t delta) { m_memory_usage += delta; }
 
+    /// Used by the transaction after elements have been stored or edited. Swaps out elements if
+    /// the memory usage exceeds the high water mark.
+    void check_memory_limits();
 
 private:
+    /// Returns the shard for a tag.
+    Tag_shard& get_shard(DB::Tag tag)
+    { return m_tag_shards[(tag.get_uint() * 2654435761u >> 16) & (NUM_SHARDS - 1)]; }
+
+    /// Returns the shard for a name.
+    Name_shard& get_shard(const std::string& name)
+    { return m_name_shards[std::hash<std::string>()(name) & (NUM_SHARDS - 1)]; }
+
+    /// Adds a committed name of a tag. Needs #m_commit_lock.
+    void add_name(DB::Tag tag, const std::string& name, Uint32 sequence);
+
+    /// Flags a tag for removal with the given commit. Needs #m_commit_lock.
+    void add_removal(DB::Tag tag, Uint32 sequence);
+
+    /// Removes all versions and names that are not visible to any open or future transaction.
+    void prune_versions();
+
+    /// Removes all name assignments that are not visible to any open or future transaction.
+    void prune_names(Uint32 horizon);
+
+    /// Removes the tags with reference count zero.
+    void remove_unreferenced_tags();
+
+    /// Swaps out elements until the memory usage drops below the low water mark.
+    void swap_out_elements();
+
+    /// Indicates whether the element of a version can be swapped out. Needs the shard lock.
+    bool can_swap_out(const Tag_version_entry& version) const;
+
+    /// Swaps out the element of a version. Needs the shard lock.
+    ///
+    /// \return   \c true in case of success, \c false otherwise (the element stays in memory).
+    bool swap_out(Tag_version_entry& version);
+
+    /// Swaps in the element of a swapped out version. Needs the shard lock.
+    ///
+    /// \return   \c true in case of success, \c false otherwise.
+    bool swap_in(Tag_version_entry& version);
+
+    /// Removes the swap file of a version that is about to be dropped (if swapped out).
+    void discard_swapped(const Tag_version_entry& version);
+
+    /// Returns the name of the swap file for the given ID.
+    std::string get_swap_file_name(Uint64 swap_id) const;
+
     /// This is used for allocating tags
     std::atomic_uint32_t m_next_tag;
     /// This is used for allocating transaction ids
     std::atomic_uint32_t m_next_transaction_id;
 
-public:
-    /// The lock for the six containers below.
-    mi::base::Lock m_lock;
-
-private:
-    /// Holds the DB::Info for each tag. Needs #m_lock.
-    Tag_map m_tags;
-    /// This is used for converting names in the corresponding tags. Needs #m_lock.
-    Named_tag_map m_named_tags;
-    /// This is used for converting tags into names. Needs #m_lock.
-    Reverse_named_tag_map m_reverse_named_tags;
-    /// This holds the tags flagged for removal. Needs #m_lock.
-    Flagged_for_removal_set m_tags_flagged_for_removal;
-    /// Holds the reference count for each tag. Needs #m_lock.
-    Reference_count_map m_reference_counts;
-    /// Holds the tags with reference count zero. Needs #m_lock.
+    /// The shards of the tag table.
+    Tag_shard m_tag_shards[NUM_SHARDS];
+    /// The shards of the name table.
+    Name_shard m_name_shards[NUM_SHARDS];
+
+    /// The lock for the commit sequence and the open snapshots.
+    mi::base::Lock m_commit_lock;
+    /// The sequence number of the last commit. Needs #m_commit_lock for writing.
+    Uint32 m_commit_sequence;
+    /// The snapshots of all open transactions. Needs #m_commit_lock.
+    std::multiset<Uint32> m_open_snapshots;
+
+    /// The lock for the two sets below. Might be acquired while holding a shard lock, but not
+    /// vice versa.
+    mi::base::Lock m_gc_lock;
+    /// Holds the tags with reference count zero. Needs #m_gc_lock.
     Reference_count_zero_set m_reference_count_zero;
+    /// Holds the tags with more than one version or name. Needs #m_gc_lock.
+    std::set<DB::Tag> m_multi_version_tags;
+    /// Holds the names assigned more than once. Needs #m_gc_lock.
+    std::set<std::string> m_multi_version_names;
+
+    /// Serializes runs of the garbage collection.
+    mi::base::Lock m_gc_run_lock;
 
     /// The global scope is currently the only scope
     Scope_impl* m_global_scope;
 
+    /// Used to reconstruct swapped out elements, or \c NULL.
+    SERIAL::Deserialization_manager* m_deserialization_manager;
+
+    /// The lock for the memory limits and the swap directory.
+    mutable mi::base::Lock m_swap_config_lock;
+    /// The low water mark for the memory usage (0 means unlimited). Needs #m_swap_config_lock.
+    size_t m_low_water;
+    /// The high water mark for the memory usage (0 means unlimited). Needs #m_swap_config_lock.
+    size_t m_high_water;
+    /// The swap directory, or empty if swapping is disabled. Needs #m_swap_config_lock.
+    std::string m_swap_directory;
+
+    /// Serializes runs of #swap_out_elements() and changes of the swap directory.
+    mi::base::Lock m_swap_run_lock;
+
+    /// The memory usage of all elements in memory (as reported by DB::Element_base::get_size()).
+    std::atomic<ptrdiff_t> m_memory_usage;
+    /// The memory usage of all swapped out elements before they have been swapped out.
+    std::atomic<size_t> m_swapped_memory_usage;
+    /// The number of swapped out elements.
+    std::atomic_uint32_t m_nr_of_swapped_elements;
+    /// This is used for allocating swap file IDs.
+    std::atomic<Uint64> m_next_swap_id;
+    /// Incremented for each lookup, used for the LRU order of #Tag_version_entry::m_last_access.
+    std::atomic<Uint64> m_access_clock;
+
+    /// The thread pool for fragmented jobs, shared with other modules.
+    std::shared_ptr<THREAD_POOL::Thread_pool> m_thread_pool;
+    /// The mutex for #m_nr_of_async_jobs.
+    std::mutex m_async_jobs_mutex;
+    /// Signaled when #m_nr_of_async_jobs drops to zero.
+    std::condition_variable m_async_jobs_condition;
+    /// The number of asynchronous fragmented jobs not yet finished. Needs #m_async_jobs_mutex.
+    size_t m_nr_of_async_jobs;
+    /// Incremented by #cancel_all_fragmented_jobs(). Jobs submitted with an older generation are
+    /// cancelled.
+    std::atomic_uint32_t m_fragmented_jobs_generation;
+
 };
 
 } // namespace DBLIGHT
@@ -106,8 +106,8 @@ Info::Info(
     m_element_messages(NULL),
     m_job(NULL),
     m_job_messages(NULL),
-    // unused    
-    m_element_size(0),                           
+    m_element_size(element ? element->get_size() : 0),
+    // unused
     m_element_messages_size(0),                  
     m_job_size(0),                               
     m_job_messages_size(0),                      
@@ -127,6 +127,8 @@ Info::Info(
 {
     for(size_t i = 0; i < MAX_REDUNDANCY_LEVEL; ++i)
         m_owners[i] = 0;
+
+    m_database->update_memory_usage(m_element_size);
 }
 
 Info::~Info()
@@ -165,7 +167,7 @@ bool Info::remove_owner(NET::Host_id host_id) { MI_ASSERT(false); return true; }
 bool Info::add_owner(NET::Host_id host_id) { MI_ASSERT(false); return 0; }
 ptrdiff_t Info::offload() { MI_ASSERT(false); return 0; }
 
-// Needs m_database->m_lock.
+// Locks the shards of the referenced tags one by one.
 void Info::store_references()
 {
     m_database->decrement_reference_counts(m_references);
@@ -180,7 +182,18 @@ ptrdiff_t Info::set_element(Element_base* element)
 {
     delete m_element;
     m_element = element;
-    return 0;
+
+    size_t old_size = m_element_size;
+    update_memory_usage();
+    return static_cast<ptrdiff_t>(m_element_size) - static_cast<ptrdiff_t>(old_size);
+}
+
+void Info::update_memory_usage()
+{
+    size_t new_size = m_element ? m_element->get_size() : 0;
+    ptrdiff_t delta = static_cast<ptrdiff_t>(new_size) - static_cast<ptrdiff_t>(m_element_size);
+    m_element_size = new_size;
+    m_database->update_memory_usage(delta);
 }
 
 ptrdiff_t Info::set_element_messages(DBNET::Message_list* element_messages)
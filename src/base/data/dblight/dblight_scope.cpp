@@ -47,16 +47,10 @@ namespace DBLIGHT {
 Scope_impl::Scope_impl(Database_impl* database)
   : m_database(database)
   , m_refcount(1)
-  , m_transaction(nullptr)
-  , m_transaction_count(0)
 {
 }
 
-Scope_impl::~Scope_impl()
-{
-    if (m_transaction)
-        m_transaction->unpin();
-}
+Scope_impl::~Scope_impl() { }
 
 void Scope_impl::pin()
 {
@@ -85,17 +79,10 @@ DB::Privacy_level Scope_impl::get_level() { return 0; }
 
 DB::Transaction* Scope_impl::start_transaction()
 {
-    Uint32 counter = increment_transaction_count();
-    if (counter > 1) {
-        decrement_transaction_count();
-        return 0;
-    }
-
-    if (m_transaction)
-        m_transaction->unpin();
+    // Concurrent transactions are isolated by the version chains in the database.
     DB::Transaction_id transaction_id = m_database->allocate_transaction_id();
-    m_transaction = new Transaction_impl(m_database, this, transaction_id);
-    return m_transaction;
+    // The caller takes ownership with its first pin() call.
+    return new Transaction_impl(m_database, this, transaction_id);
 }
 
 } // namespace DB
@@ -59,22 +59,10 @@ public:
     DB::Privacy_level get_level();
     DB::Transaction* start_transaction();
 
-    /// Increments #m_transaction_count.
-    Uint32 increment_transaction_count() { return ++m_transaction_count; }
-    /// Decrements #m_transaction_count.
-    void decrement_transaction_count() { --m_transaction_count; }
-
 private:
     Database_impl* m_database;
     std::string m_name;
     std::atomic_uint32_t m_refcount;
-
-    // The current (or last) transaction.
-    DB::Transaction* m_transaction;
-
-    // Number of transactions started and not yet committed in this scope. Used to limit the number
-    // of such transaction1 to 1.
-    std::atomic_uint32_t m_transaction_count;
 };
 
 } // namespace DB
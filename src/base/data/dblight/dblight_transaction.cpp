@@ -50,13 +50,28 @@ Transaction_impl::Transaction_impl(
   : m_database(database)
   , m_scope(scope)
   , m_id(id)
-  , m_refcount(1)
+  , m_refcount(0)
   , m_next_sequence_number(0)
   , m_is_open(true)
+  , m_snapshot(database->register_transaction())
+  , m_fragmented_jobs_cancelled(false)
+  , m_nr_of_fragmented_jobs(0)
 {
 }
 
-Transaction_impl::~Transaction_impl() { }
+Transaction_impl::~Transaction_impl()
+{
+    if (!m_is_open)
+        return;
+
+    // Released without commit, drop the versions of this transaction and its snapshot.
+    cancel_fragmented_jobs();
+    wait_for_fragmented_jobs();
+
+    std::vector<DB::Tag> modified_tags(m_modified_tags.begin(), m_modified_tags.end());
+    m_is_open = false;
+    m_database->abort_transaction(m_id, m_snapshot, modified_tags);
+}
 
 void Transaction_impl::pin()
 {
@@ -83,12 +98,26 @@ bool Transaction_impl::unblock_commit()
 
 bool Transaction_impl::commit()
 {
-    if (!m_is_open)
+    bool expected = true;
+    if (!m_is_open.compare_exchange_strong(expected, false))
         return false;
 
+    // Asynchronous fragmented jobs must not outlive the commit.
+    cancel_fragmented_jobs();
+    wait_for_fragmented_jobs();
+
+    std::vector<DB::Tag> modified_tags;
+    std::vector<std::pair<DB::Tag, std::string> > names;
+    std::vector<DB::Tag> removals;
+    {
+        mi::base::Lock::Block block(&m_modified_tags_lock);
+        modified_tags.assign(m_modified_tags.begin(), m_modified_tags.end());
+        names.assign(m_pending_names.begin(), m_pending_names.end());
+        removals.assign(m_pending_removals.begin(), m_pending_removals.end());
+    }
+
+    m_database->commit_transaction(m_id, m_snapshot, modified_tags, names, removals);
     m_database->garbage_collection_internal();
-    m_scope->decrement_transaction_count();
-    m_is_open = false;
     return true;
 }
 
@@ -113,16 +142,11 @@ DB::Tag Transaction_impl::store(
     Uint32 version = m_next_sequence_number++;
     DB::Info* info = new DB::Info(m_database, tag, this, DB::Scope_id(0), version, element);
 
-    mi::base::Lock::Block block(&m_database->m_lock);
-
     info->store_references();
-    m_database->get_tag_map()[tag] = info;
-    m_database->increment_reference_count(tag);
-
-    if (name) {
-        m_database->get_named_tag_map()[name] = tag;
-        m_database->get_reverse_named_tag_map()[tag] = name;
-    }
+    m_database->add_version(info);
+    add_modified_tag(tag);
+    add_pending_name(tag, name);
+    m_database->check_memory_limits();
 
     return tag;
 }
@@ -143,24 +167,12 @@ void Transaction_impl::store(
     Uint32 version = m_next_sequence_number++;
     DB::Info* info = new DB::Info(m_database, tag, this, DB::Scope_id(0), version, element);
 
-    mi::base::Lock::Block block(&m_database->m_lock);
-
+    // Adds the self-reference only for new tags.
     info->store_references();
-
-    Tag_map::iterator it = m_database->get_tag_map().find(tag);
-    if (it != m_database->get_tag_map().end()) {
-         it->second->unpin();
-         it->second = info;
-         // leave self-reference as is
-    } else {
-        m_database->get_tag_map()[tag] = info;
-        m_database->increment_reference_count(tag);
-    }
-
-    if (name) {
-         m_database->get_named_tag_map()[name] = tag;
-         m_database->get_reverse_named_tag_map()[tag] = name;
-    }
+    m_database->add_version(info);
+    add_modified_tag(tag);
+    add_pending_name(tag, name);
+    m_database->check_memory_limits();
 }
 
 DB::Tag Transaction_impl::store(
@@ -238,12 +250,9 @@ bool Transaction_impl::remove(DB::Tag tag, bool remove_local_copy)
     if (!m_is_open)
         return false;
 
-    mi::base::Lock::Block block(&m_database->m_lock);
-    std::pair<Flagged_for_removal_set::iterator,bool> result
-        = m_database->get_flagged_for_removal_set().insert(tag);
-    if (result.second)
-        m_database->decrement_reference_count(tag);
-
+    // Like the names, the removal flag becomes visible with the commit.
+    mi::base::Lock::Block block(&m_modified_tags_lock);
+    m_pending_removals.insert(tag);
     return true;
 }
 
@@ -263,11 +272,19 @@ const char* Transaction_impl::tag_to_name(DB::Tag tag)
     if (!m_is_open)
         return 0;
 
-    mi::base::Lock::Block block(&m_database->m_lock);
-    Reverse_named_tag_map::const_iterator it = m_database->get_reverse_named_tag_map().find(tag);
-    if (it == m_database->get_reverse_named_tag_map().end())
+    std::string name;
+    {
+        mi::base::Lock::Block block(&m_modified_tags_lock);
+        std::map<DB::Tag, std::string>::const_iterator it = m_pending_names.find(tag);
+        if (it != m_pending_names.end())
+            return m_returned_names.insert(it->second).first->c_str();
+    }
+
+    if (!m_database->tag_to_name(tag, m_snapshot, name))
         return 0;
-    return it->second.c_str(); // TODO unsafe
+
+    mi::base::Lock::Block block(&m_modified_tags_lock);
+    return m_returned_names.insert(name).first->c_str();
 }
 
 DB::Tag Transaction_impl::name_to_tag(const char* name)
@@ -275,11 +292,14 @@ DB::Tag Transaction_impl::name_to_tag(const char* name)
     if (!m_is_open || !name)
         return DB::Tag();
 
-    mi::base::Lock::Block block(&m_database->m_lock);
-    Named_tag_map::const_iterator it = m_database->get_named_tag_map().find(name);
-    if (it == m_database->get_named_tag_map().end())
-         return DB::Tag();
-    return it->second;
+    {
+        mi::base::Lock::Block block(&m_modified_tags_lock);
+        std::map<std::string, DB::Tag>::const_iterator it = m_pending_named_tags.find(name);
+        if (it != m_pending_named_tags.end())
+            return it->second;
+    }
+
+    return m_database->name_to_tag(name, m_snapshot);
 }
 
 SERIAL::Class_id Transaction_impl::get_class_id(DB::Tag tag)
@@ -334,9 +354,13 @@ bool Transaction_impl::get_tag_is_removed(DB::Tag tag)
     if (!m_is_open)
         return false;
 
-    mi::base::Lock::Block block(&m_database->m_lock);
-    const Flagged_for_removal_set& set = m_database->get_flagged_for_removal_set();
-    return set.find(tag) != set.end();
+    {
+        mi::base::Lock::Block block(&m_modified_tags_lock);
+        if (m_pending_removals.count(tag) != 0)
+            return true;
+    }
+
+    return m_database->get_tag_is_removed(tag, m_snapshot);
 }
 
 bool Transaction_impl::get_tag_is_job(DB::Tag tag) { return false; }
@@ -359,20 +383,46 @@ std::vector<std::pair<DB::Tag, DB::Journal_type> >* Transaction_impl::get_journa
 
 Sint32 Transaction_impl::execute_fragmented(DB::Fragmented_job* job, size_t count)
 {
-    MI_ASSERT(false);
-    return -1;
+    if (!m_is_open)
+        return -1;
+
+    return m_database->execute_fragmented(this, job, count);
 }
 
 Sint32 Transaction_impl::execute_fragmented_async(
     DB::Fragmented_job* job, size_t count, DB::IExecution_listener* listener)
 {
-    MI_ASSERT(false);
-    return -1;
+    if (!m_is_open)
+        return -1;
+
+    {
+        std::unique_lock<std::mutex> lock(m_fragmented_jobs_mutex);
+        ++m_nr_of_fragmented_jobs;
+    }
+
+    Sint32 result = m_database->execute_fragmented_async(this, job, count, listener);
+    if (result != 0)
+        fragmented_job_finished();
+    return result;
 }
 
-void Transaction_impl::cancel_fragmented_jobs() { MI_ASSERT(false); }
+void Transaction_impl::cancel_fragmented_jobs() { m_fragmented_jobs_cancelled = true; }
 
-bool Transaction_impl::get_fragmented_jobs_cancelled() { return false; }
+bool Transaction_impl::get_fragmented_jobs_cancelled() { return m_fragmented_jobs_cancelled; }
+
+void Transaction_impl::fragmented_job_finished()
+{
+    std::unique_lock<std::mutex> lock(m_fragmented_jobs_mutex);
+    MI_ASSERT(m_nr_of_fragmented_jobs > 0);
+    if (--m_nr_of_fragmented_jobs == 0)
+        m_fragmented_jobs_condition.notify_all();
+}
+
+void Transaction_impl::wait_for_fragmented_jobs()
+{
+    std::unique_lock<std::mutex> lock(m_fragmented_jobs_mutex);
+    m_fragmented_jobs_condition.wait(lock, [this] { return m_nr_of_fragmented_jobs == 0; });
+}
 
 DB::Scope* Transaction_impl::get_scope() { return m_scope; }
 
@@ -391,22 +441,22 @@ DB::Info* Transaction_impl::edit_element(DB::Tag tag)
     if (!m_is_open)
         return 0;
 
-    mi::base::Lock::Block block(&m_database->m_lock);
-
-    Tag_map::const_iterator it = m_database->get_tag_map().find(tag);
-    if (it == m_database->get_tag_map().end())
+    // The edit creates a new version, the old one stays visible to other transactions.
+    DB::Info* old_info = m_database->lookup_version(tag, m_id, m_snapshot);
+    if (!old_info)
          return 0;
 
-    DB::Info* old_info = it->second;
     DB::Element_base* new_element = old_info->get_element()->copy();
+    old_info->unpin();
+
     Uint32 version = m_next_sequence_number++;
     DB::Info* new_info = new DB::Info(m_database, tag, this, DB::Scope_id(0), version, new_element);
     new_info->store_references();
 
-    old_info->unpin();
-    m_database->get_tag_map()[tag] = new_info;
-
     new_info->pin();
+    m_database->add_version(new_info);
+    add_modified_tag(tag);
+
     return new_info;
 }
 
@@ -414,9 +464,11 @@ void Transaction_impl::finish_edit(DB::Info* info, DB::Journal_type journal_type
 {
     info->get_element()->prepare_store(this, info->get_tag());
 
-    mi::base::Lock::Block block(&m_database->m_lock);
     info->store_references();
+    info->update_memory_usage();
     info->unpin();
+
+    m_database->check_memory_limits();
 }
 
 DB::Info* Transaction_impl::get_element(DB::Tag tag, bool do_wait)
@@ -424,15 +476,7 @@ DB::Info* Transaction_impl::get_element(DB::Tag tag, bool do_wait)
     if (!m_is_open)
         return 0;
 
-    mi::base::Lock::Block block(&m_database->m_lock);
-
-    Tag_map::const_iterator it = m_database->get_tag_map().find(tag);
-    if (it == m_database->get_tag_map().end())
-        return 0;
-
-    DB::Info* info = it->second;
-    info->pin();
-    return info;
+    return m_database->lookup_version(tag, m_id, m_snapshot);
 }
 
 DB::Element_base* Transaction_impl::construct_empty_element(SERIAL::Class_id class_id)
@@ -443,6 +487,25 @@ DB::Element_base* Transaction_impl::construct_empty_element(SERIAL::Class_id cla
 
 DB::Transaction* Transaction_impl::get_real_transaction() { return this; }
 
+void Transaction_impl::add_modified_tag(DB::Tag tag)
+{
+    mi::base::Lock::Block block(&m_modified_tags_lock);
+    m_modified_tags.insert(tag);
+}
+
+void Transaction_impl::add_pending_name(DB::Tag tag, const char* name)
+{
+    if (!name)
+        return;
+
+    mi::base::Lock::Block block(&m_modified_tags_lock);
+    std::string& old_name = m_pending_names[tag];
+    if (!old_name.empty())
+        m_pending_named_tags.erase(old_name);
+    old_name = name;
+    m_pending_named_tags[old_name] = tag;
+}
+
 } // namespace DBLIGHT
 
 } // namespace MI
@@ -34,6 +34,13 @@
 #define BASE_DATA_DBLIGHT_DBLIGHT_TRANSACTION_H
 
 #include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+
+#include <mi/base/lock.h>
 
 #include <base/data/db/i_db_transaction.h>
 #include <base/data/db/i_db_tag.h>
@@ -48,6 +55,8 @@ class Scope_impl;
 class Transaction_impl : public DB::Transaction
 {
 public:
+    /// The transaction is created with a reference count of zero, the first #pin() call takes
+    /// ownership. Transactions released while still open are aborted.
     Transaction_impl(Database_impl* database, Scope_impl* scope, DB::Transaction_id id);
 
     ~Transaction_impl();
@@ -199,13 +208,52 @@ public:
 
     Transaction* get_real_transaction();
 
+    /// Used by the database when an asynchronous fragmented job of this transaction is finished.
+    void fragmented_job_finished();
+
 private:
+    /// Records that this transaction created a new version of \p tag.
+    void add_modified_tag(DB::Tag tag);
+
+    /// Records that this transaction assigned \p name to \p tag.
+    void add_pending_name(DB::Tag tag, const char* name);
+
+    /// Waits until all asynchronous fragmented jobs of this transaction are finished.
+    void wait_for_fragmented_jobs();
+
     Database_impl* m_database;
     Scope_impl* m_scope;
     DB::Transaction_id m_id;
     std::atomic_uint32_t m_refcount;
     std::atomic_uint32_t m_next_sequence_number;
-    bool m_is_open;
+    std::atomic_bool m_is_open;
+
+    /// The commit sequence number of the last commit visible to this transaction.
+    Uint32 m_snapshot;
+
+    /// The lock for #m_modified_tags and the pending names and removals.
+    mi::base::Lock m_modified_tags_lock;
+    /// The tags for which this transaction created new versions. Needs #m_modified_tags_lock.
+    std::set<DB::Tag> m_modified_tags;
+    /// The names assigned by this transaction, visible to other transactions after the commit.
+    /// Needs #m_modified_tags_lock.
+    std::map<DB::Tag, std::string> m_pending_names;
+    /// The reverse map of #m_pending_names. Needs #m_modified_tags_lock.
+    std::map<std::string, DB::Tag> m_pending_named_tags;
+    /// The tags flagged for removal by this transaction. Needs #m_modified_tags_lock.
+    std::set<DB::Tag> m_pending_removals;
+    /// Keeps the strings returned by #tag_to_name() valid for the lifetime of the transaction.
+    /// Needs #m_modified_tags_lock.
+    std::set<std::string> m_returned_names;
+
+    /// Indicates whether the fragmented jobs of this transaction have been cancelled.
+    std::atomic_bool m_fragmented_jobs_cancelled;
+    /// The mutex for #m_nr_of_fragmented_jobs.
+    std::mutex m_fragmented_jobs_mutex;
+    /// Signaled when #m_nr_of_fragmented_jobs drops to zero.
+    std::condition_variable m_fragmented_jobs_condition;
+    /// The number of asynchronous fragmented jobs not yet finished. Needs #m_fragmented_jobs_mutex.
+    size_t m_nr_of_fragmented_jobs;
 };
 
 } // namespace DBLIGHT
@@ -38,11 +38,16 @@
 namespace MI {
 
 namespace DB { class Database; }
+namespace SERIAL { class Deserialization_manager; }
 
 namespace DBLIGHT {
 
 /// Create a database instance.
-DB::Database* factory();
+///
+/// \param deserialization_manager   Used to swap in elements that have been swapped out to disk.
+///                                  Only elements whose class is registered there are swapped
+///                                  out. Swapping is not supported if \c NULL.
+DB::Database* factory(SERIAL::Deserialization_manager* deserialization_manager = nullptr);
 
 } // namespace DBLIGHT
 
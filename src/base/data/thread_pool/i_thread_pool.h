@@ -0,0 +1,240 @@
+/***************************************************************************************************
+ * Copyright (c) 2012-2022, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************************************/
+
+/** \file
+ ** \brief A work-stealing thread pool.
+ **
+ ** The thread pool executes jobs consisting of a fixed number of fragments. Each worker thread has
+ ** its own task queue. Ranges of fragments are split recursively, the worker keeps the first half
+ ** and pushes the second half to its own queue, from where idle workers steal it. This keeps the
+ ** scheduling overhead low for large numbers of fragments while balancing the load automatically.
+ **/
+
+#ifndef BASE_DATA_THREAD_POOL_I_THREAD_POOL_H
+#define BASE_DATA_THREAD_POOL_I_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace MI {
+
+namespace THREAD_POOL {
+
+class Thread_pool;
+
+/// Base class for jobs executed by the thread pool.
+///
+/// Derived classes implement the execution of a single fragment and the notification when the
+/// whole job has been executed.
+class Job_base
+{
+public:
+    /// Constructor.
+    ///
+    /// \param count        The number of fragments, must be greater than zero.
+    /// \param chunk_size   Ranges of fragments are not split below this size.
+    Job_base(size_t count, size_t chunk_size = 1);
+
+    virtual ~Job_base() { }
+
+    /// Executes the fragment with the given index.
+    virtual void execute_fragment(size_t index) = 0;
+
+    /// Called after all fragments have been executed.
+    ///
+    /// The thread pool does not access the job anymore after this call, i.e., asynchronous jobs
+    /// may delete themselves here. Not called for jobs passed to Thread_pool::execute().
+    virtual void job_finished() { }
+
+    /// Returns the number of fragments.
+    size_t get_count() const { return m_count; }
+
+private:
+    friend class Thread_pool;
+
+    /// Marks \p n fragments as executed. Returns \c true if this completes the job.
+    bool fragments_done(size_t n) { return (m_remaining -= n) == 0; }
+
+    /// The number of fragments.
+    size_t m_count;
+    /// The minimum size of ranges of fragments.
+    size_t m_chunk_size;
+    /// The number of fragments that still need to be executed.
+    std::atomic<size_t> m_remaining;
+    /// Indicates whether the job was passed to Thread_pool::execute().
+    bool m_is_synchronous;
+    /// Indicates whether a synchronous job is waited for by a worker thread of the pool.
+    bool m_has_waiting_worker;
+
+    /// The mutex for #m_done_condition.
+    std::mutex m_done_mutex;
+    /// Indicates whether a synchronous job is done. Set under #m_done_mutex if the job is waited
+    /// for by another thread. Worker threads check it under Thread_pool::m_mutex.
+    std::atomic<bool> m_done;
+    /// Signaled when a synchronous job waited for by another thread is done.
+    std::condition_variable m_done_condition;
+};
+
+/// A work-stealing thread pool.
+///
+/// Worker threads are started lazily on the first submitted job.
+class Thread_pool
+{
+public:
+    /// Constructor.
+    ///
+    /// \param nr_of_threads   The number of worker threads. 0 means one thread per hardware
+    ///                        thread.
+    explicit Thread_pool(size_t nr_of_threads = 0);
+
+    /// Destructor. Waits for all submitted jobs to finish and joins the worker threads.
+    ~Thread_pool();
+
+    /// Returns the number of worker threads executing jobs concurrently.
+    size_t get_nr_of_threads() const { return m_nr_of_threads; }
+
+    /// Submits a job for asynchronous execution. Returns immediately.
+    ///
+    /// Job_base::job_finished() is called when all fragments have been executed.
+    void submit(Job_base* job);
+
+    /// Executes a job and waits until all fragments have been executed.
+    ///
+    /// If called from a worker thread (nested jobs) the calling thread executes pending tasks
+    /// while waiting, such that nested jobs cannot deadlock the pool.
+    void execute(Job_base* job);
+
+    /// Notifies the pool that the job running in the current thread is about to block.
+    ///
+    /// The pool starts an additional worker thread such that the number of working threads stays
+    /// constant. Must be followed by #resume_current_job(). Has no effect if not called from a
+    /// worker thread.
+    void suspend_current_job();
+
+    /// Notifies the pool that the job running in the current thread continues after a call to
+    /// #suspend_current_job(). Surplus worker threads exit when they become idle.
+    void resume_current_job();
+
+    /// Executes one pending task if called from a worker thread, or yields the processor
+    /// otherwise.
+    void yield();
+
+private:
+    /// A range of fragments of a job.
+    struct Task
+    {
+        Job_base* m_job;
+        size_t m_begin;
+        size_t m_end;
+    };
+
+    /// The state of one worker thread slot.
+    struct Worker
+    {
+        Worker() : m_is_active(false) { }
+
+        /// The mutex for #m_tasks.
+        std::mutex m_mutex;
+        /// The task queue. The owner pushes and pops at the back, thieves steal at the front.
+        std::deque<Task> m_tasks;
+        /// The thread of this slot (possibly already exited). Needs Thread_pool::m_mutex.
+        std::thread m_thread;
+        /// Indicates whether the thread of this slot is running. Needs Thread_pool::m_mutex.
+        bool m_is_active;
+    };
+
+    /// The main loop of worker threads.
+    void run(size_t index);
+
+    /// Starts worker threads (unless already started). Needs #m_mutex.
+    void start_workers();
+
+    /// Starts a new worker thread in an unused slot (if any). Needs #m_mutex.
+    void start_worker();
+
+    /// Pushes a task to the queue of the current worker thread, or to the shared queue.
+    void push_task(const Task& task);
+
+    /// Pops a task from the own queue, the shared queue, or steals one from another worker.
+    bool pop_task(size_t index, Task& task);
+
+    /// Executes a task, splitting it recursively.
+    void execute_task(Task task);
+
+    /// Marks a job as finished.
+    void finish_job(Job_base* job);
+
+    /// Executes one pending task, if any, in worker thread \p index.
+    bool execute_pending_task(size_t index);
+
+    /// Returns the index of the calling worker thread in this pool, or ~0 for other threads.
+    size_t get_current_worker() const;
+
+    /// The number of worker threads executing jobs concurrently.
+    size_t m_nr_of_threads;
+    /// The number of worker slots. Additional slots are used for threads started while others
+    /// are suspended.
+    size_t m_nr_of_slots;
+
+    /// The mutex for the shared queue, the worker threads, and the condition variable.
+    std::mutex m_mutex;
+    /// Signaled when tasks are pushed, synchronous jobs of worker threads are finished, or the
+    /// pool shuts down.
+    std::condition_variable m_condition;
+    /// The queue for tasks submitted from threads that are not worker threads. Needs #m_mutex.
+    std::deque<Task> m_shared_tasks;
+    /// The worker slots.
+    std::unique_ptr<Worker[]> m_workers;
+    /// Indicates whether the initial worker threads have been started. Needs #m_mutex.
+    bool m_started;
+    /// The number of pending tasks in all queues.
+    std::atomic<size_t> m_nr_of_pending_tasks;
+    /// The number of idle worker threads (about to) wait for #m_condition.
+    std::atomic<size_t> m_nr_of_idle_threads;
+    /// The number of running (started, not suspended, not exited) worker threads. Needs #m_mutex.
+    size_t m_nr_of_running_threads;
+    /// Indicates whether the pool shuts down. Needs #m_mutex.
+    bool m_shutdown;
+};
+
+/// Returns the thread pool shared by all modules of the process.
+///
+/// The pool is created on the first call and destroyed when the last reference is released, i.e.,
+/// callers keep the returned pointer as long as they submit jobs. Modules that would otherwise
+/// create their own pool should use this one to avoid oversubscription.
+std::shared_ptr<Thread_pool> get_shared_thread_pool();
+
+} // namespace THREAD_POOL
+
+} // namespace MI
+
+#endif // BASE_DATA_THREAD_POOL_I_THREAD_POOL_H
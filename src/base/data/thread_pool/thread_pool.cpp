@@ -0,0 +1,367 @@
+/***************************************************************************************************
+ * Copyright (c) 2012-2022, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************************************/
+
+/** \file
+ ** \brief Implementation of the work-stealing thread pool.
+ **/
+
+#include "pch.h"
+
+#include "i_thread_pool.h"
+
+#include <base/system/main/i_assert.h>
+
+namespace MI {
+
+namespace THREAD_POOL {
+
+namespace {
+
+/// The pool of the worker thread executing the calling thread, or \c NULL.
+thread_local Thread_pool* s_current_pool = 0;
+
+/// The slot index of the worker thread executing the calling thread.
+thread_local size_t s_current_index = ~size_t(0);
+
+/// The maximum number of additional threads started for suspended jobs, per regular thread.
+const size_t SLOTS_PER_THREAD = 4;
+
+} // namespace
+
+Job_base::Job_base(size_t count, size_t chunk_size)
+  : m_count(count)
+  , m_chunk_size(chunk_size > 0 ? chunk_size : 1)
+  , m_remaining(count)
+  , m_is_synchronous(false)
+  , m_has_waiting_worker(false)
+  , m_done(false)
+{
+    MI_ASSERT(count > 0);
+}
+
+Thread_pool::Thread_pool(size_t nr_of_threads)
+  : m_nr_of_threads(nr_of_threads)
+  , m_started(false)
+  , m_nr_of_pending_tasks(0)
+  , m_nr_of_idle_threads(0)
+  , m_nr_of_running_threads(0)
+  , m_shutdown(false)
+{
+    if (m_nr_of_threads == 0)
+        m_nr_of_threads = std::thread::hardware_concurrency();
+    if (m_nr_of_threads == 0)
+        m_nr_of_threads = 1;
+
+    m_nr_of_slots = m_nr_of_threads * SLOTS_PER_THREAD;
+    m_workers.reset(new Worker[m_nr_of_slots]);
+}
+
+Thread_pool::~Thread_pool()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+        m_condition.notify_all();
+    }
+
+    // Workers exit only when their own queue is empty, all submitted jobs are finished by then.
+    for (size_t i = 0; i < m_nr_of_slots; ++i)
+        if (m_workers[i].m_thread.joinable())
+            m_workers[i].m_thread.join();
+
+    MI_ASSERT(m_shared_tasks.empty());
+}
+
+void Thread_pool::submit(Job_base* job)
+{
+    job->m_is_synchronous = false;
+
+    Task task = { job, 0, job->get_count() };
+    push_task(task);
+}
+
+void Thread_pool::execute(Job_base* job)
+{
+    size_t index = get_current_worker();
+
+    job->m_is_synchronous = true;
+    job->m_has_waiting_worker = index != ~size_t(0);
+    job->m_done = false;
+
+    Task task = { job, 0, job->get_count() };
+    push_task(task);
+
+    // Threads from outside the pool just wait.
+    if (index == ~size_t(0)) {
+        std::unique_lock<std::mutex> lock(job->m_done_mutex);
+        job->m_done_condition.wait(lock, [job] { return job->m_done.load(); });
+        return;
+    }
+
+    // Worker threads help executing pending tasks while waiting, otherwise nested jobs could
+    // block all workers. They wait like idle workers, i.e., they are woken up by new tasks as
+    // well as by the completion of the job, see finish_job().
+    while (!job->m_done) {
+        if (execute_pending_task(index))
+            continue;
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        ++m_nr_of_idle_threads;
+        m_condition.wait(lock, [this, job] { return job->m_done || m_nr_of_pending_tasks > 0; });
+        --m_nr_of_idle_threads;
+    }
+}
+
+void Thread_pool::suspend_current_job()
+{
+    if (get_current_worker() == ~size_t(0))
+        return;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    --m_nr_of_running_threads;
+    if (!m_shutdown && m_nr_of_running_threads < m_nr_of_threads)
+        start_worker();
+}
+
+void Thread_pool::resume_current_job()
+{
+    if (get_current_worker() == ~size_t(0))
+        return;
+
+    // Surplus threads exit when they become idle.
+    std::unique_lock<std::mutex> lock(m_mutex);
+    ++m_nr_of_running_threads;
+}
+
+void Thread_pool::yield()
+{
+    size_t index = get_current_worker();
+    if (index == ~size_t(0) || !execute_pending_task(index))
+        std::this_thread::yield();
+}
+
+void Thread_pool::run(size_t index)
+{
+    s_current_pool = this;
+    s_current_index = index;
+
+    while (true) {
+
+        Task task;
+        if (pop_task(index, task)) {
+            execute_task(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        if (m_shutdown || m_nr_of_running_threads > m_nr_of_threads) {
+            // The own queue is empty, other tasks are handled by the remaining workers.
+            --m_nr_of_running_threads;
+            m_workers[index].m_is_active = false;
+            break;
+        }
+
+        // Announce the wait before checking for tasks, see push_task().
+        ++m_nr_of_idle_threads;
+        if (m_nr_of_pending_tasks == 0)
+            m_condition.wait(lock);
+        --m_nr_of_idle_threads;
+    }
+
+    s_current_pool = 0;
+    s_current_index = ~size_t(0);
+}
+
+void Thread_pool::start_workers()
+{
+    if (m_started)
+        return;
+
+    m_started = true;
+    for (size_t i = 0; i < m_nr_of_threads; ++i)
+        start_worker();
+}
+
+void Thread_pool::start_worker()
+{
+    for (size_t i = 0; i < m_nr_of_slots; ++i) {
+        Worker& worker = m_workers[i];
+        if (worker.m_is_active)
+            continue;
+
+        // The previous thread of this slot has already left run().
+        if (worker.m_thread.joinable())
+            worker.m_thread.join();
+
+        worker.m_is_active = true;
+        ++m_nr_of_running_threads;
+        worker.m_thread = std::thread(&Thread_pool::run, this, i);
+        return;
+    }
+}
+
+void Thread_pool::push_task(const Task& task)
+{
+    // Incrementing the pending tasks before checking the idle threads (and vice versa in run())
+    // guarantees that no wakeup is lost.
+    ++m_nr_of_pending_tasks;
+
+    size_t index = get_current_worker();
+    if (index != ~size_t(0)) {
+        Worker& worker = m_workers[index];
+        std::unique_lock<std::mutex> lock(worker.m_mutex);
+        worker.m_tasks.push_back(task);
+    } else {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        start_workers();
+        m_shared_tasks.push_back(task);
+    }
+
+    if (m_nr_of_idle_threads > 0) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.notify_one();
+    }
+}
+
+bool Thread_pool::pop_task(size_t index, Task& task)
+{
+    if (m_nr_of_pending_tasks == 0)
+        return false;
+
+    // own queue: most recently pushed, i.e., smallest range with the best cache locality
+    {
+        Worker& worker = m_workers[index];
+        std::unique_lock<std::mutex> lock(worker.m_mutex);
+        if (!worker.m_tasks.empty()) {
+            task = worker.m_tasks.back();
+            worker.m_tasks.pop_back();
+            --m_nr_of_pending_tasks;
+            return true;
+        }
+    }
+
+    // shared queue
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!m_shared_tasks.empty()) {
+            task = m_shared_tasks.front();
+            m_shared_tasks.pop_front();
+            --m_nr_of_pending_tasks;
+            return true;
+        }
+    }
+
+    // steal the oldest, i.e., largest range from the other queues
+    for (size_t i = 1; i < m_nr_of_slots; ++i) {
+        Worker& victim = m_workers[(index + i) % m_nr_of_slots];
+        std::unique_lock<std::mutex> lock(victim.m_mutex);
+        if (!victim.m_tasks.empty()) {
+            task = victim.m_tasks.front();
+            victim.m_tasks.pop_front();
+            --m_nr_of_pending_tasks;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void Thread_pool::execute_task(Task task)
+{
+    Job_base* job = task.m_job;
+
+    // Keep the first half, offer the second half to other workers.
+    while (task.m_end - task.m_begin > job->m_chunk_size) {
+        size_t middle = task.m_begin + (task.m_end - task.m_begin) / 2;
+        Task second_half = { job, middle, task.m_end };
+        push_task(second_half);
+        task.m_end = middle;
+    }
+
+    for (size_t i = task.m_begin; i < task.m_end; ++i)
+        job->execute_fragment(i);
+
+    if (job->fragments_done(task.m_end - task.m_begin))
+        finish_job(job);
+}
+
+void Thread_pool::finish_job(Job_base* job)
+{
+    if (!job->m_is_synchronous) {
+        job->job_finished();
+        return;
+    }
+
+    // A waiting worker thread blocks on #m_condition. Acquiring #m_mutex after setting the flag
+    // ensures that the worker either sees the flag or already waits. The job might be destroyed
+    // as soon as the flag is set, so its members are not accessed afterwards.
+    if (job->m_has_waiting_worker) {
+        job->m_done = true;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.notify_all();
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(job->m_done_mutex);
+    job->m_done = true;
+    job->m_done_condition.notify_all();
+}
+
+bool Thread_pool::execute_pending_task(size_t index)
+{
+    Task task;
+    if (!pop_task(index, task))
+        return false;
+
+    execute_task(task);
+    return true;
+}
+
+size_t Thread_pool::get_current_worker() const
+{
+    return s_current_pool == this ? s_current_index : ~size_t(0);
+}
+
+std::shared_ptr<Thread_pool> get_shared_thread_pool()
+{
+    static std::mutex s_mutex;
+    static std::weak_ptr<Thread_pool> s_pool;
+
+    std::unique_lock<std::mutex> lock(s_mutex);
+    std::shared_ptr<Thread_pool> pool = s_pool.lock();
+    if (!pool) {
+        pool = std::make_shared<Thread_pool>();
+        s_pool = pool;
+    }
+    return pool;
+}
+
+} // namespace THREAD_POOL
+
+} // namespace MI
@@ -100,12 +100,30 @@ namespace MI {
 
 namespace SYSTEM { class Module_registration_entry; }
 namespace SERIAL { class Serializer; class Deserializer; }
+namespace THREAD_POOL { class Thread_pool; }
 
 namespace IMAGE {
 
 class IMdl_container_callback;
 class IMipmap;
 
+/// Statistics of the tile cache, see Image_module::get_tile_cache_statistics().
+struct Tile_cache_statistics
+{
+    /// The number of block lookups that found the block already loaded.
+    mi::Uint64 m_hits = 0;
+    /// The number of blocks that had to be loaded.
+    mi::Uint64 m_misses = 0;
+    /// The number of blocks evicted to stay within the budget.
+    mi::Uint64 m_evictions = 0;
+    /// The number of blocks currently held by the cache.
+    mi::Size m_nr_of_tiles = 0;
+    /// The memory used by the blocks currently held by the cache in bytes.
+    mi::Size m_memory_usage = 0;
+    /// The budget of the cache in bytes (0 means unlimited).
+    mi::Size m_budget = 0;
+};
+
 /// Public interface of the IMAGE module.
 class Image_module : public SYSTEM::IModule
 {
@@ -675,6 +693,51 @@ public:
     /// ... or \c NULL if no callback is set.
     virtual IMdl_container_callback* get_mdl_container_callback() const = 0;
 
+    /// Sets the budget of the process-wide tile cache.
+    ///
+    /// The tile cache holds the lazily loaded tiles of file-based and archive-based canvases. If
+    /// their memory usage exceeds the budget, the least recently used tiles are released again and
+    /// loaded on the next access. Tiles obtained for modification and tiles still referenced
+    /// elsewhere are never released.
+    ///
+    /// \param budget   The budget in bytes. The default 0 means unlimited.
+    virtual void set_tile_cache_budget( mi::Size budget) = 0;
+
+    /// Returns the budget of the process-wide tile cache in bytes (0 means unlimited).
+    virtual mi::Size get_tile_cache_budget() const = 0;
+
+    /// Returns the statistics of the process-wide tile cache.
+    virtual Tile_cache_statistics get_tile_cache_statistics() const = 0;
+
+    /// Sets the budget for image data decoded concurrently.
+    ///
+    /// Image sets with several frames or uvtiles are decoded in parallel. Decoding of further
+    /// frames or uvtiles is deferred as long as the size of the image data being decoded (the
+    /// decoded size of level 0, computed from the image headers) would exceed the budget. A single
+    /// image exceeding the budget is still decoded.
+    ///
+    /// \param budget   The budget in bytes. 0 means unlimited. The default is 512 MiB.
+    virtual void set_decode_budget( mi::Size budget) = 0;
+
+    /// Returns the budget for image data decoded concurrently in bytes (0 means unlimited).
+    virtual mi::Size get_decode_budget() const = 0;
+
+    /// Indicates whether block-compressed image data is kept compressed.
+    ///
+    /// If enabled, canvases loaded from block-compressed files (BC1 to BC7) use the
+    /// block-compressed pixel types and their data is passed through unchanged. Otherwise, and
+    /// always for cubemaps and canvases with a selector, the data is decompressed when loaded.
+    ///
+    /// \param value    The new setting. The default is \c false.
+    virtual void set_keep_compressed( bool value) = 0;
+
+    /// Indicates whether block-compressed image data is kept compressed.
+    virtual bool get_keep_compressed() const = 0;
+
+    /// Returns the thread pool used for parallel image processing, or \c NULL if the module is
+    /// not initialized. This is the pool shared with the other modules of the process.
+    virtual THREAD_POOL::Thread_pool* get_thread_pool() const = 0;
+
     /// Creates the next miplevel from the given canvas.
     ///
     /// \param prev_canvas      The canvas to create a miplevel from.
@@ -684,6 +747,22 @@ public:
     virtual mi::neuraylib::ICanvas* create_miplevel(
         const mi::neuraylib::ICanvas* prev_canvas, float gamma_override) const = 0;
 
+    /// Creates the next \p nr_of_levels miplevels from the given canvas.
+    ///
+    /// Yields the same result as repeated calls of #create_miplevel(), but computes several
+    /// miplevels at once in parallel strips of rows.
+    ///
+    /// \param prev_canvas      The canvas to create the miplevels from.
+    /// \param gamma_override   Canvas gamma override. If it is different from zero
+    ///                         it is used instead of the canvas gamma.
+    /// \param nr_of_levels     The number of miplevels to create.
+    /// \param[out] levels      The created miplevels.
+    virtual void create_miplevels(
+        const mi::neuraylib::ICanvas* prev_canvas,
+        float gamma_override,
+        mi::Uint32 nr_of_levels,
+        std::vector<mi::base::Handle<mi::neuraylib::ICanvas> >& levels) const = 0;
+
     // Methods for testing
     // ===================
 
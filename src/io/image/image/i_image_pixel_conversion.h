@@ -87,7 +87,8 @@ MI_HOST_DEVICE_INLINE void adjust_gamma(
 /// Currently, pixel type conversion is implemented between all valid pixel types (but not for
 /// PT_UNDEF). Since this does not need to be the case in general, this method can be used to
 /// query whether the free convert() methods can successfully convert from type \p Source to
-/// type \p Dest.
+/// type \p Dest. Block-compressed pixel types are not supported by the convert() methods, they
+/// need to be decoded first, see #decompress_tile().
 ///
 /// \param Source   The pixel type to convert from.
 /// \param Dest     The pixel type to convert to.
@@ -419,7 +420,7 @@ MI_HOST_DEVICE_INLINE void adjust_gamma(
 
 MI_HOST_DEVICE_INLINE bool exists_pixel_conversion( const Pixel_type Source, const Pixel_type Dest)
 {
-    return Source != PT_UNDEF && Dest != PT_UNDEF;
+    return Source != PT_UNDEF && Dest != PT_UNDEF && Source <= PT_COLOR && Dest <= PT_COLOR;
 }
 
 MI_HOST_DEVICE_INLINE bool convert(
@@ -0,0 +1,233 @@
+/***************************************************************************************************
+ * Copyright (c) 2012-2022, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************************************/
+
+#ifndef IO_IMAGE_IMAGE_I_IMAGE_TEXEL_VIEW_H
+#define IO_IMAGE_IMAGE_I_IMAGE_TEXEL_VIEW_H
+
+#include <mi/base/handle.h>
+#include <mi/math/color.h>
+#include <mi/neuraylib/icanvas.h>
+#include <mi/neuraylib/itile.h>
+
+#include "i_image_pixel_conversion.h"
+#include "i_image_utilities.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace MI {
+
+namespace IMAGE {
+
+class ICanvas;
+
+/// An immutable view of the pixel data of a canvas for fast texel reads.
+///
+/// In contrast to Access_canvas, tiles are resolved only once, and texels are read directly from
+/// the raw tile data with a conversion specialized for the pixel type of the canvas. There is no
+/// locking and no virtual ITile::get_pixel() call per texel, hence lookups from many threads do not
+/// interfere with each other.
+///
+/// For canvases that keep their pixel data in blocks (see ICanvas::get_block()), the blocks are
+/// resolved on their first lookup. The view references only the blocks that were actually
+/// accessed, the remaining blocks stay evictable by the tile cache. Copies of the view share the
+/// resolved blocks.
+///
+/// For other canvases, all tiles are resolved on construction and the view keeps references to the
+/// tiles, not to the canvas. Tiles that do not provide their data in the layout documented for
+/// ITile::get_data() (e.g., tiles of application-provided canvases that are smaller than the
+/// canvas) are read via ITile::get_pixel() instead. The tiles of block-compressed canvases are
+/// decoded on construction, and the view keeps references to the decoded tiles.
+///
+/// \note There is also an Access_canvas class which supports reading rectangular regions.
+class Texel_view
+{
+public:
+    /// Constructor.
+    ///
+    /// \param canvas   The canvas to view. Can be \c NULL, which results in an invalid view.
+    Texel_view( const mi::neuraylib::ICanvas* canvas = nullptr);
+
+    /// Indicates whether this view refers to a valid canvas.
+    bool is_valid() const { return !m_layers.empty(); }
+
+    /// Reads a single texel.
+    ///
+    /// \param color   The texel will be returned here.
+    /// \param x       The x coordinate of the texel in the canvas.
+    /// \param y       The y coordinate of the texel in the canvas.
+    /// \param z       The z coordinate of the texel in the canvas.
+    /// \return        \c true in case of success,
+    ///                \c false in case of errors, e.g., invalid parameters
+    bool lookup( mi::math::Color& color, mi::Uint32 x, mi::Uint32 y, mi::Uint32 z = 0) const
+    {
+        if( x >= m_width || y >= m_height || z >= m_layers.size())
+            return false;
+
+        fetch( color, x, y, z);
+        return true;
+    }
+
+    /// Reads a single texel without checking the coordinates.
+    void fetch( mi::math::Color& color, mi::Uint32 x, mi::Uint32 y, mi::Uint32 z) const;
+
+private:
+    /// The tile of a layer and the raw data used for direct access, or \c NULL if the texels of
+    /// this layer have to be read via ITile::get_pixel().
+    struct Layer
+    {
+        const mi::neuraylib::ITile* m_tile;
+        const mi::Uint8* m_data;
+    };
+
+    /// A resolved block, or the entire layer if the layer is not split into blocks.
+    struct Block
+    {
+        /// Keeps the block data alive.
+        mi::base::Handle<const mi::neuraylib::ITile> m_tile;
+        /// The raw data for direct access, or \c NULL (see Layer::m_data).
+        const mi::Uint8* m_data;
+        /// The coordinates of the first pixel of m_tile in the canvas.
+        mi::Uint32 m_x;
+        mi::Uint32 m_y;
+        /// The width of m_tile.
+        mi::Uint32 m_width;
+    };
+
+    /// The blocks of a canvas, shared between copies of the view.
+    struct Blocks
+    {
+        ~Blocks();
+
+        /// The canvas that provides the blocks.
+        mi::base::Handle<const ICanvas> m_canvas;
+        /// The resolved blocks, \c NULL for blocks that were not accessed yet.
+        std::unique_ptr<std::atomic<Block*>[]> m_blocks;
+        /// The number of blocks in x direction.
+        mi::Uint32 m_nr_of_blocks_x = 0;
+        /// The number of blocks in y direction.
+        mi::Uint32 m_nr_of_blocks_y = 0;
+    };
+
+    /// Returns the block that contains the given texel.
+    const Block& get_block( mi::Uint32 x, mi::Uint32 y, mi::Uint32 z) const;
+
+    /// Resolves a block on its first access.
+    const Block& resolve_block(
+        mi::Size index, mi::Uint32 block_x, mi::Uint32 block_y, mi::Uint32 z) const;
+
+    /// The tiles, keeps the tile data alive. Empty if blocks are used.
+    std::vector<mi::base::Handle<const mi::neuraylib::ITile> > m_tiles;
+    /// The layers of the canvas, the size is the number of layers. Unused if blocks are used.
+    std::vector<Layer> m_layers;
+
+    /// The blocks of the canvas, or \c NULL if blocks are not used.
+    std::shared_ptr<Blocks> m_blocks;
+    /// The size of the blocks, or 0 if blocks are not used.
+    mi::Uint32 m_block_size = 0;
+
+    /// The width of the canvas.
+    mi::Uint32 m_width = 0;
+    /// The height of the canvas.
+    mi::Uint32 m_height = 0;
+    /// The number of bytes per pixel.
+    mi::Uint32 m_bytes_per_pixel = 0;
+    /// The pixel type used for the conversion. PT_SINT32, PT_FLOAT32_3 and PT_FLOAT32_4 are mapped
+    /// to their equivalent types like in convert().
+    Pixel_type m_pixel_type = PT_UNDEF;
+};
+
+inline const Texel_view::Block& Texel_view::get_block(
+    mi::Uint32 x, mi::Uint32 y, mi::Uint32 z) const
+{
+    const mi::Uint32 block_x = x / m_block_size;
+    const mi::Uint32 block_y = y / m_block_size;
+    const mi::Size index
+        = (static_cast<mi::Size>( z) * m_blocks->m_nr_of_blocks_y + block_y)
+            * m_blocks->m_nr_of_blocks_x + block_x;
+
+    const Block* block = m_blocks->m_blocks[index].load( std::memory_order_acquire);
+    return block ? *block : resolve_block( index, block_x, block_y, z);
+}
+
+inline void Texel_view::fetch(
+    mi::math::Color& color, mi::Uint32 x, mi::Uint32 y, mi::Uint32 z) const
+{
+    const mi::neuraylib::ITile* tile;
+    const mi::Uint8* data;
+    mi::Uint32 width;
+    mi::Float32* const dest = &color.r;
+
+    if( m_block_size == 0) {
+        const Layer& layer = m_layers[z];
+        tile  = layer.m_tile;
+        data  = layer.m_data;
+        width = m_width;
+    } else {
+        const Block& block = get_block( x, y, z);
+        tile  = block.m_tile.get();
+        data  = block.m_data;
+        width = block.m_width;
+        x    -= block.m_x;
+        y    -= block.m_y;
+    }
+
+    if( !data) {
+        tile->get_pixel( x, y, dest);
+        return;
+    }
+
+    const mi::Uint8* const texel
+        = data + (static_cast<mi::Size>( y) * width + x) * m_bytes_per_pixel;
+
+#define MI_IMAGE_ARGS texel, dest
+
+    switch( m_pixel_type) {
+        case PT_SINT8:     Pixel_converter<PT_SINT8,     PT_COLOR>::convert( MI_IMAGE_ARGS); return;
+        case PT_FLOAT32:   Pixel_converter<PT_FLOAT32,   PT_COLOR>::convert( MI_IMAGE_ARGS); return;
+        case PT_FLOAT32_2: Pixel_converter<PT_FLOAT32_2, PT_COLOR>::convert( MI_IMAGE_ARGS); return;
+        case PT_RGB:       Pixel_converter<PT_RGB,       PT_COLOR>::convert( MI_IMAGE_ARGS); return;
+        case PT_RGBA:      Pixel_converter<PT_RGBA,      PT_COLOR>::convert( MI_IMAGE_ARGS); return;
+        case PT_RGBE:      Pixel_converter<PT_RGBE,      PT_COLOR>::convert( MI_IMAGE_ARGS); return;
+        case PT_RGBEA:     Pixel_converter<PT_RGBEA,     PT_COLOR>::convert( MI_IMAGE_ARGS); return;
+        case PT_RGB_16:    Pixel_converter<PT_RGB_16,    PT_COLOR>::convert( MI_IMAGE_ARGS); return;
+        case PT_RGBA_16:   Pixel_converter<PT_RGBA_16,   PT_COLOR>::convert( MI_IMAGE_ARGS); return;
+        case PT_RGB_FP:    Pixel_converter<PT_RGB_FP,    PT_COLOR>::convert( MI_IMAGE_ARGS); return;
+        case PT_COLOR:     Pixel_converter<PT_COLOR,     PT_COLOR>::convert( MI_IMAGE_ARGS); return;
+        default:           tile->get_pixel( x, y, dest); return;
+    }
+
+#undef MI_IMAGE_ARGS
+}
+
+} // namespace IMAGE
+
+} // namespace MI
+
+#endif // IO_IMAGE_IMAGE_I_IMAGE_TEXEL_VIEW_H
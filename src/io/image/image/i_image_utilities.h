@@ -66,7 +66,17 @@ enum Pixel_type {
     PT_RGB_16,     /// pixel type "Rgb_16"
     PT_RGBA_16,    /// pixel type "Rgba_16"
     PT_RGB_FP,     /// pixel type "Rgb_fp"
-    PT_COLOR       /// pixel type "Color"
+    PT_COLOR,      /// pixel type "Color"
+    PT_BC1,        /// pixel type "Bc1"   (block-compressed, decompresses to "Rgba")
+    PT_BC2,        /// pixel type "Bc2"   (block-compressed, decompresses to "Rgba")
+    PT_BC3,        /// pixel type "Bc3"   (block-compressed, decompresses to "Rgba")
+    PT_BC4,        /// pixel type "Bc4"   (block-compressed, decompresses to "Sint8")
+    PT_BC4S,       /// pixel type "Bc4s"  (block-compressed, decompresses to "Float32")
+    PT_BC5,        /// pixel type "Bc5"   (block-compressed, decompresses to "Rgb", blue is 0)
+    PT_BC5S,       /// pixel type "Bc5s"  (block-compressed, decompresses to "Float32<2>")
+    PT_BC6H,       /// pixel type "Bc6h"  (block-compressed, decompresses to "Rgb_fp")
+    PT_BC6HS,      /// pixel type "Bc6hs" (block-compressed, decompresses to "Rgb_fp")
+    PT_BC7         /// pixel type "Bc7"   (block-compressed, decompresses to "Rgba")
 };
 
 /// Converts a pixel type from its string to enum representation.
@@ -87,6 +97,16 @@ inline Pixel_type convert_pixel_type_string_to_enum( const char* pixel_type)
     if( strcmp( pixel_type, "Rgba_16")    == 0) return PT_RGBA_16;
     if( strcmp( pixel_type, "Rgb_fp")     == 0) return PT_RGB_FP;
     if( strcmp( pixel_type, "Color")      == 0) return PT_COLOR;
+    if( strcmp( pixel_type, "Bc1")        == 0) return PT_BC1;
+    if( strcmp( pixel_type, "Bc2")        == 0) return PT_BC2;
+    if( strcmp( pixel_type, "Bc3")        == 0) return PT_BC3;
+    if( strcmp( pixel_type, "Bc4")        == 0) return PT_BC4;
+    if( strcmp( pixel_type, "Bc4s")       == 0) return PT_BC4S;
+    if( strcmp( pixel_type, "Bc5")        == 0) return PT_BC5;
+    if( strcmp( pixel_type, "Bc5s")       == 0) return PT_BC5S;
+    if( strcmp( pixel_type, "Bc6h")       == 0) return PT_BC6H;
+    if( strcmp( pixel_type, "Bc6hs")      == 0) return PT_BC6HS;
+    if( strcmp( pixel_type, "Bc7")        == 0) return PT_BC7;
     return PT_UNDEF;
 }
 
@@ -109,13 +129,45 @@ inline const char* convert_pixel_type_enum_to_string( Pixel_type pixel_type)
         case PT_RGBA_16:   return "Rgba_16";
         case PT_RGB_FP:    return "Rgb_fp";
         case PT_COLOR:     return "Color";
+        case PT_BC1:       return "Bc1";
+        case PT_BC2:       return "Bc2";
+        case PT_BC3:       return "Bc3";
+        case PT_BC4:       return "Bc4";
+        case PT_BC4S:      return "Bc4s";
+        case PT_BC5:       return "Bc5";
+        case PT_BC5S:      return "Bc5s";
+        case PT_BC6H:      return "Bc6h";
+        case PT_BC6HS:     return "Bc6hs";
+        case PT_BC7:       return "Bc7";
         default:           return 0;
     }
 }
 
+/// Indicates whether the pixel type is block-compressed (PT_BC1 to PT_BC7).
+///
+/// Block-compressed pixel data consists of 4x4 pixel blocks, stored row by row starting with the
+/// top row of blocks (as expected by GPUs). Partial blocks at the right and top border are padded.
+inline bool is_compressed_pixel_type( Pixel_type pixel_type);
+
+/// Returns the pixel type that a block-compressed pixel type decompresses to.
+///
+/// Returns \p pixel_type itself for all other pixel types.
+inline Pixel_type get_decompressed_pixel_type( Pixel_type pixel_type);
+
+/// Returns the number of bytes of a 4x4 block of a block-compressed pixel type.
+///
+/// For example, 8 for PT_BC1 and 16 for PT_BC7. Returns 0 for all other pixel types.
+inline mi::Uint32 get_bytes_per_block( Pixel_type pixel_type);
+
+/// Returns the number of bytes used by \p width x \p height pixels of a given pixel type.
+///
+/// Takes the block size of block-compressed pixel types into account.
+inline mi::Size get_data_size( Pixel_type pixel_type, mi::Uint32 width, mi::Uint32 height);
+
 /// Returns the number of components of a given pixel type.
 ///
-/// For example, 3 for PT_RGB and 4 for PT_RGBA.
+/// For example, 3 for PT_RGB and 4 for PT_RGBA. For block-compressed pixel types the number of
+/// components of the decompressed pixel type.
 inline int get_components_per_pixel( Pixel_type pixel_type);
 
 /// Returns the number of bytes used by a component of a given pixel type.
@@ -125,7 +177,8 @@ inline int get_bytes_per_component( Pixel_type pixel_type);
 
 /// Return the number of bytes used by a pixel of a given pixel type.
 ///
-/// This is the product of #get_components_per_pixel() and #get_bytes_per_component().
+/// This is the product of #get_components_per_pixel() and #get_bytes_per_component(). Returns 0
+/// for block-compressed pixel types, see #get_data_size().
 inline mi::Uint32 get_bytes_per_pixel( Pixel_type pixel_type);
 
 /// Indicates whether the pixel type has an alpha channel.
@@ -133,7 +186,8 @@ inline bool has_alpha( Pixel_type pixel_type);
 
 /// Returns the default gamma value for a given pixel type.
 ///
-/// The default gamma value is 1.0 for HDR pixel types and 2.2 for LDR pixel types.
+/// The default gamma value is 1.0 for HDR pixel types and 2.2 for LDR pixel types. Block-compressed
+/// pixel types use the default of their decompressed pixel type.
 inline mi::Float32 get_default_gamma( Pixel_type pixel_type);
 
 /// Indicates whether \p selector is a valid RGBA channel selector.
@@ -289,8 +343,73 @@ struct Pixel_type_traits<PT_COLOR>
     static constexpr bool s_linear = true;
 };
 
+inline bool is_compressed_pixel_type( Pixel_type pixel_type)
+{
+    switch( pixel_type) {
+        case PT_BC1:
+        case PT_BC2:
+        case PT_BC3:
+        case PT_BC4:
+        case PT_BC4S:
+        case PT_BC5:
+        case PT_BC5S:
+        case PT_BC6H:
+        case PT_BC6HS:
+        case PT_BC7:       return true;
+        default:           return false;
+    }
+}
+
+inline Pixel_type get_decompressed_pixel_type( Pixel_type pixel_type)
+{
+    switch( pixel_type) {
+        case PT_BC1:       return PT_RGBA;
+        case PT_BC2:       return PT_RGBA;
+        case PT_BC3:       return PT_RGBA;
+        case PT_BC4:       return PT_SINT8;
+        case PT_BC4S:      return PT_FLOAT32;
+        case PT_BC5:       return PT_RGB;
+        case PT_BC5S:      return PT_FLOAT32_2;
+        case PT_BC6H:      return PT_RGB_FP;
+        case PT_BC6HS:     return PT_RGB_FP;
+        case PT_BC7:       return PT_RGBA;
+        default:           return pixel_type;
+    }
+}
+
+inline mi::Uint32 get_bytes_per_block( Pixel_type pixel_type)
+{
+    switch( pixel_type) {
+        case PT_BC1:
+        case PT_BC4:
+        case PT_BC4S:      return 8;
+        case PT_BC2:
+        case PT_BC3:
+        case PT_BC5:
+        case PT_BC5S:
+        case PT_BC6H:
+        case PT_BC6HS:
+        case PT_BC7:       return 16;
+        default:           return 0;
+    }
+}
+
+inline mi::Size get_data_size( Pixel_type pixel_type, mi::Uint32 width, mi::Uint32 height)
+{
+    if( is_compressed_pixel_type( pixel_type))
+        return   static_cast<mi::Size>( (width  + 3) / 4)
+               * static_cast<mi::Size>( (height + 3) / 4)
+               * get_bytes_per_block( pixel_type);
+
+    return   static_cast<mi::Size>( width)
+           * static_cast<mi::Size>( height)
+           * get_bytes_per_pixel( pixel_type);
+}
+
 inline int get_components_per_pixel( Pixel_type pixel_type)
 {
+    pixel_type = get_decompressed_pixel_type( pixel_type);
+
     switch( pixel_type) {
         case PT_UNDEF:     return 0;
         case PT_SINT8:     return Pixel_type_traits<PT_SINT8    >::s_components_per_pixel;
@@ -362,6 +481,8 @@ inline mi::Uint32 get_bytes_per_pixel( Pixel_type pixel_type)
 
 inline bool has_alpha( Pixel_type pixel_type)
 {
+    pixel_type = get_decompressed_pixel_type( pixel_type);
+
     switch( pixel_type) {
         case PT_UNDEF:     return false;
         case PT_SINT8:     return Pixel_type_traits<PT_SINT8    >::s_has_alpha;
@@ -384,6 +505,8 @@ inline bool has_alpha( Pixel_type pixel_type)
 
 inline mi::Float32 get_default_gamma( Pixel_type pixel_type)
 {
+    pixel_type = get_decompressed_pixel_type( pixel_type);
+
     switch( pixel_type) {
         case PT_UNDEF:     return 1.0f;
         case PT_SINT8:     return Pixel_type_traits<PT_SINT8    >::s_linear ? 1.0f : 2.2f;
@@ -435,6 +558,9 @@ inline Pixel_type get_pixel_type_for_channel( Pixel_type pixel_type, const char*
     if( !is_valid_rgba_channel( selector))
         return PT_UNDEF;
 
+    // Channels of block-compressed pixel types are extracted after decompression.
+    pixel_type = get_decompressed_pixel_type( pixel_type);
+
     switch( pixel_type) {
 
         case PT_SINT8:
@@ -457,6 +583,16 @@ inline Pixel_type get_pixel_type_for_channel( Pixel_type pixel_type, const char*
         case PT_COLOR:
             return PT_FLOAT32;
 
+        case PT_BC1:
+        case PT_BC2:
+        case PT_BC3:
+        case PT_BC4:
+        case PT_BC4S:
+        case PT_BC5:
+        case PT_BC5S:
+        case PT_BC6H:
+        case PT_BC6HS:
+        case PT_BC7:
         case PT_UNDEF:
             return PT_UNDEF; }
 
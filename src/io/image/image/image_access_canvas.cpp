@@ -30,6 +30,8 @@
 
 #include "i_image_access_canvas.h"
 #include "i_image_pixel_conversion.h"
+#include "image_block_compression.h"
+#include "image_canvas_impl.h"
 
 #include <mi/base/handle.h>
 #include <mi/neuraylib/itile.h>
@@ -41,6 +43,28 @@ namespace MI {
 
 namespace IMAGE {
 
+namespace {
+
+/// Returns the tile for the given layer of the canvas.
+///
+/// Tiles of block-compressed canvases are decoded into the decompressed pixel type.
+const mi::neuraylib::ITile* get_decoded_tile(
+    const mi::neuraylib::ICanvas* canvas, Pixel_type pixel_type, mi::Uint32 layer)
+{
+    mi::base::Handle<const mi::neuraylib::ITile> tile( canvas->get_tile( layer));
+    if( !is_compressed_pixel_type( pixel_type)) {
+        tile->retain();
+        return tile.get();
+    }
+
+    // Cubemap faces are not flipped, see Canvas_impl.
+    mi::base::Handle<const ICanvas> canvas_internal( canvas->get_interface<ICanvas>());
+    const bool is_cubemap = canvas_internal && canvas_internal->get_is_cubemap();
+    return decompress_tile( tile.get(), !is_cubemap);
+}
+
+} // namespace
+
 Access_canvas::Access_canvas( const mi::neuraylib::ICanvas* canvas, bool lockless)
   : m_lockless( lockless)
 {
@@ -133,16 +157,19 @@ bool Access_canvas::read_rect(
     if( m_canvas_pixel_type == PT_UNDEF)
         return false;
 
-    if( !exists_pixel_conversion( m_canvas_pixel_type, buffer_pixel_type))
+    // Block-compressed canvases are read via their decoded tiles.
+    const Pixel_type canvas_pixel_type = get_decompressed_pixel_type( m_canvas_pixel_type);
+    if( !exists_pixel_conversion( canvas_pixel_type, buffer_pixel_type))
         return false;
 
-    const mi::Uint32 canvas_bytes_per_pixel = get_bytes_per_pixel( m_canvas_pixel_type);
+    const mi::Uint32 canvas_bytes_per_pixel = get_bytes_per_pixel( canvas_pixel_type);
     const mi::Uint32 buffer_bytes_per_pixel = get_bytes_per_pixel( buffer_pixel_type);
 
     // Compute the pointer to the lower left corner of the rectangle that falls into this
     // tile, and stride per row (canvas, source).
     const mi::Difference source_stride = m_canvas_width * canvas_bytes_per_pixel;
-    mi::base::Handle<const mi::neuraylib::ITile> tile( m_canvas->get_tile( canvas_layer));
+    mi::base::Handle<const mi::neuraylib::ITile> tile(
+        get_decoded_tile( m_canvas.get(), m_canvas_pixel_type, canvas_layer));
     const mi::Uint8* tile_data = static_cast<const mi::Uint8*>( tile->get_data());
     const mi::Uint8* source =
             tile_data + canvas_y * source_stride + canvas_x * canvas_bytes_per_pixel;
@@ -157,7 +184,7 @@ bool Access_canvas::read_rect(
     }
 
     // Copy pixel data for rectangle that falls into this tile
-    convert( source, dest, m_canvas_pixel_type, buffer_pixel_type, width, height,
+    convert( source, dest, canvas_pixel_type, buffer_pixel_type, width, height,
              source_stride, dest_stride);
 
     return true;
@@ -272,16 +299,19 @@ bool Edit_canvas::read_rect(
     if( m_canvas_pixel_type == PT_UNDEF)
         return false;
 
-    if( !exists_pixel_conversion( m_canvas_pixel_type, buffer_pixel_type))
+    // Block-compressed canvases are read via their decoded tiles.
+    const Pixel_type canvas_pixel_type = get_decompressed_pixel_type( m_canvas_pixel_type);
+    if( !exists_pixel_conversion( canvas_pixel_type, buffer_pixel_type))
         return false;
 
-    const mi::Uint32 canvas_bytes_per_pixel = get_bytes_per_pixel( m_canvas_pixel_type);
+    const mi::Uint32 canvas_bytes_per_pixel = get_bytes_per_pixel( canvas_pixel_type);
     const mi::Uint32 buffer_bytes_per_pixel = get_bytes_per_pixel( buffer_pixel_type);
 
     // Compute the pointer to the lower left corner of the rectangle that falls into this
     // tile, and stride per row (canvas, source).
     const mi::Difference source_stride = (mi::Difference)m_canvas_width * canvas_bytes_per_pixel;
-    mi::base::Handle<const mi::neuraylib::ITile> tile( m_canvas->get_tile( canvas_layer));
+    mi::base::Handle<const mi::neuraylib::ITile> tile(
+        get_decoded_tile( m_canvas.get(), m_canvas_pixel_type, canvas_layer));
     const mi::Uint8* const tile_data = static_cast<const mi::Uint8*>( tile->get_data());
     const mi::Uint8* const source =
             tile_data + canvas_y * source_stride + canvas_x * canvas_bytes_per_pixel;
@@ -296,7 +326,7 @@ bool Edit_canvas::read_rect(
     }
 
     // Copy pixel data for rectangle that falls into this tile
-    convert( source, dest, m_canvas_pixel_type, buffer_pixel_type, width, height,
+    convert( source, dest, canvas_pixel_type, buffer_pixel_type, width, height,
              source_stride, dest_stride);
 
     return true;
@@ -325,6 +355,7 @@ bool Edit_canvas::write_rect(
     if( m_canvas_pixel_type == PT_UNDEF)
         return false;
 
+    // Block-compressed canvases cannot be written (encoding is not supported).
     if( !exists_pixel_conversion( m_canvas_pixel_type, buffer_pixel_type))
         return false;
 
@@ -0,0 +1,845 @@
+/***************************************************************************************************
+ * Copyright (c) 2012-2022, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************************************/
+
+#include "pch.h"
+
+#include "image_block_compression.h"
+#include "image_tile_impl.h"
+
+#include <mi/neuraylib/itile.h>
+
+#include <base/lib/log/i_log_assert.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace MI {
+
+namespace IMAGE {
+
+namespace {
+
+/// Blocks have a size of 4x4 pixels.
+const mi::Uint32 BLOCK_PIXEL_DIM = 4;
+
+/// Converts a half (IEEE 754 binary16) to a float.
+mi::Float32 half_to_float( mi::Uint16 half)
+{
+    const mi::Uint32 sign = static_cast<mi::Uint32>( half & 0x8000) << 16;
+    const mi::Uint32 exponent = (half >> 10) & 0x1f;
+    mi::Uint32 mantissa = half & 0x3ff;
+
+    mi::Uint32 bits;
+    if( exponent == 0x1f) {
+        // infinity or NaN
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    } else if( exponent != 0) {
+        // normalized
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    } else if( mantissa == 0) {
+        // zero
+        bits = sign;
+    } else {
+        // denormalized, becomes normalized as float
+        mi::Uint32 float_exponent = 113;
+        while( (mantissa & 0x400) == 0) {
+            mantissa <<= 1;
+            --float_exponent;
+        }
+        bits = sign | (float_exponent << 23) | ((mantissa & 0x3ff) << 13);
+    }
+
+    mi::Float32 result;
+    memcpy( &result, &bits, sizeof( result));
+    return result;
+}
+
+/// Converts 16 bit BGR color (565) to 24 bit RGB color (888)
+void bgr565_to_rgb888( const mi::Uint8* const c_in, mi::Uint8* const c_out)
+{
+    // red
+    c_out[0] =  (c_in[1] & 0xf8 /*11111000*/);
+    c_out[0] |= c_out[0] >> 5;
+    // green
+    c_out[1] = ((c_in[1] & 0x07 /*00000111*/) << 5) | ((c_in[0] >> 3) & 0x1c /*00011100*/);
+    c_out[1] |= c_out[1] >> 6;
+    // blue
+    c_out[2] =  (c_in[0] & 0x1f /*00011111*/) << 3;
+    c_out[2] |= c_out[2] >> 5;
+}
+
+/// Decodes color data for BC2 and BC3 into 16 RGBA pixels (alpha is not touched).
+///
+/// The color sub-blocks of BC2 and BC3 are the same, they are a simpler version of the BC1 format.
+void decode_colors( const mi::Uint8* const color_block, mi::Uint8* pixels)
+{
+    // First 32bit of color_block represent the color table.
+    mi::Uint8 color[4][3];
+    bgr565_to_rgb888( color_block, color[0]);
+    bgr565_to_rgb888( color_block + 2, color[1]);
+    for( mi::Uint32 c = 0; c < 3; ++c) {
+        color[2][c] = (2 * color[0][c] + color[1][c] + 1) / 3;
+        color[3][c] = (color[0][c] + 2 * color[1][c] + 1) / 3;
+    }
+
+    // Decode 2-bit color table indices
+    for( mi::Uint32 y = 0; y < BLOCK_PIXEL_DIM; ++y) {
+        const mi::Uint8 t = color_block[y + 4];
+        for( mi::Uint32 x = 0; x < BLOCK_PIXEL_DIM; ++x) {
+            const mi::Uint32 index = (t >> (x * 2)) & 0x03;
+            memcpy( pixels + (y * BLOCK_PIXEL_DIM + x) * 4, color[index], 3);
+        }
+    }
+}
+
+/// Decodes a BC1 block into 16 RGBA pixels.
+///
+/// This is an expanded version of decode_colors() since BC1 supports a 1 bit alpha additionally.
+void decompress_bc1( const mi::Uint8* const block, mi::Uint8* pixels)
+{
+    // First 32bit of block represent the color table.
+    mi::Uint8 color[4][4];
+    memset( color, 0xff, sizeof( color));
+
+    bgr565_to_rgb888( block, color[0]);
+    bgr565_to_rgb888( block + 2, color[1]);
+    // Interpret block colors as 16 bit integer for comparison
+    const mi::Uint16 c0 = block[0] + (block[1] << 8);
+    const mi::Uint16 c1 = block[2] + (block[3] << 8);
+    if( c0 > c1) {
+        for( mi::Uint32 c = 0; c < 3; ++c) {
+            color[2][c] = (2 * color[0][c] + color[1][c] + 1) / 3;
+            color[3][c] = (color[0][c] + 2 * color[1][c] + 1) / 3;
+        }
+    } else {
+        for( mi::Uint32 c = 0; c < 3; ++c) {
+            color[2][c] = (color[0][c] + color[1][c]) / 2;
+            color[3][c] = 0;  // black
+        }
+        color[3][3] = 0;      // transparent
+    }
+
+    // Decode 2-bit color table indices
+    for( mi::Uint32 y = 0; y < BLOCK_PIXEL_DIM; ++y) {
+        const mi::Uint8 t = block[y + 4];
+        for( mi::Uint32 x = 0; x < BLOCK_PIXEL_DIM; ++x) {
+            const mi::Uint32 index = (t >> (x * 2)) & 0x03;
+            memcpy( pixels + (y * BLOCK_PIXEL_DIM + x) * 4, color[index], 4);
+        }
+    }
+}
+
+/// Decodes a BC2 block into 16 RGBA pixels.
+///
+/// A BC2 block consists of an alpha sub-block and a color sub-block. The alpha sub-block has
+/// direct 4-bit alpha data.
+void decompress_bc2( const mi::Uint8* const block, mi::Uint8* pixels)
+{
+    decode_colors( block + 8, pixels);
+
+    for( mi::Uint32 i = 0; i < 16; ++i) {
+        mi::Uint8 alpha = block[i >> 1];
+        alpha = (i % 2 == 0) ? (alpha & 0x0f) : (alpha >> 4);
+        pixels[i * 4 + 3] = 17 * alpha; // spread from 0..15 to 0..255
+    }
+}
+
+/// Decodes a BC4 channel into 16 unsigned values (row-major order).
+///
+/// The same layout is used for the alpha sub-block of BC3 and the two channels of BC5.
+void decode_bc4u_channel( const mi::Uint8* const block, mi::Uint8* values)
+{
+    mi::Uint8 palette[8];
+    palette[0] = block[0];
+    palette[1] = block[1];
+
+    if( palette[0] > palette[1]) {
+        for( mi::Uint32 i = 1; i < 7; ++i)
+            palette[i+1] = static_cast<mi::Uint8>( ((7-i) * palette[0] + i * palette[1] + 3) / 7);
+    } else {
+        for( mi::Uint32 i = 1; i < 5; ++i)
+            palette[i+1] = static_cast<mi::Uint8>( ((5-i) * palette[0] + i * palette[1] + 2) / 5);
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+
+    // Read next 48 bits (3 bits per pixel) of block into a mi::Uint64 for easier extraction.
+    mi::Uint64 bits = 0;
+    for( int i = 5; i >= 0; --i) {
+        bits <<= 8;
+        bits |= block[i+2];
+    }
+
+    for( mi::Uint32 i = 0; i < 16; ++i)
+        values[i] = palette[(bits >> (i * 3)) & 0x07];
+}
+
+/// Decodes a BC4 channel into 16 signed values in [-1,1] (row-major order).
+void decode_bc4s_channel( const mi::Uint8* const block, mi::Float32* values)
+{
+    // -128 and -127 both map to -1.0
+    mi::Float32 palette[8];
+    palette[0] = std::max( static_cast<mi::Sint8>( block[0]), mi::Sint8( -127)) / 127.0f;
+    palette[1] = std::max( static_cast<mi::Sint8>( block[1]), mi::Sint8( -127)) / 127.0f;
+
+    if( palette[0] > palette[1]) {
+        for( mi::Uint32 i = 1; i < 7; ++i)
+            palette[i+1] = ((7-i) * palette[0] + i * palette[1]) / 7.0f;
+    } else {
+        for( mi::Uint32 i = 1; i < 5; ++i)
+            palette[i+1] = ((5-i) * palette[0] + i * palette[1]) / 5.0f;
+        palette[6] = -1.0f;
+        palette[7] =  1.0f;
+    }
+
+    mi::Uint64 bits = 0;
+    for( int i = 5; i >= 0; --i) {
+        bits <<= 8;
+        bits |= block[i+2];
+    }
+
+    for( mi::Uint32 i = 0; i < 16; ++i)
+        values[i] = palette[(bits >> (i * 3)) & 0x07];
+}
+
+/// Decodes a BC3 block into 16 RGBA pixels.
+///
+/// A BC3 block consists of an alpha sub-block and a color sub-block. The alpha sub-block has
+/// indirect 3-bit alpha data and 2 reference alpha values.
+void decompress_bc3( const mi::Uint8* const block, mi::Uint8* pixels)
+{
+    decode_colors( block + 8, pixels);
+
+    mi::Uint8 alpha[16];
+    decode_bc4u_channel( block, alpha);
+    for( mi::Uint32 i = 0; i < 16; ++i)
+        pixels[i * 4 + 3] = alpha[i];
+}
+
+/// Decodes a BC4 block into 16 "Sint8" pixels.
+void decompress_bc4( const mi::Uint8* const block, mi::Uint8* pixels)
+{
+    decode_bc4u_channel( block, pixels);
+}
+
+/// Decodes a signed BC4 block into 16 "Float32" pixels.
+void decompress_bc4s( const mi::Uint8* const block, mi::Uint8* pixels)
+{
+    mi::Float32 values[16];
+    decode_bc4s_channel( block, values);
+    memcpy( pixels, values, sizeof( values));
+}
+
+/// Decodes a BC5 block into 16 "Rgb" pixels.
+///
+/// A BC5 block consists of two BC4 blocks, one for red and one for green. Blue is set to 0.
+void decompress_bc5( const mi::Uint8* const block, mi::Uint8* pixels)
+{
+    mi::Uint8 red[16];
+    mi::Uint8 green[16];
+    decode_bc4u_channel( block, red);
+    decode_bc4u_channel( block + 8, green);
+
+    for( mi::Uint32 i = 0; i < 16; ++i) {
+        pixels[i * 3 + 0] = red[i];
+        pixels[i * 3 + 1] = green[i];
+        pixels[i * 3 + 2] = 0;
+    }
+}
+
+/// Decodes a signed BC5 block into 16 "Float32<2>" pixels.
+void decompress_bc5s( const mi::Uint8* const block, mi::Uint8* pixels)
+{
+    mi::Float32 values[2][16];
+    decode_bc4s_channel( block, values[0]);
+    decode_bc4s_channel( block + 8, values[1]);
+
+    for( mi::Uint32 i = 0; i < 16; ++i) {
+        const mi::Float32 pixel[2] = { values[0][i], values[1][i] };
+        memcpy( pixels + i * sizeof( pixel), pixel, sizeof( pixel));
+    }
+}
+
+/// Reads bit fields from a 128-bit block, starting at the least significant bit.
+class Bit_reader
+{
+public:
+    explicit Bit_reader( const mi::Uint8* const block)
+      : m_lo( load_uint64( block)), m_hi( load_uint64( block + 8)), m_position( 0) { }
+
+    /// Reads the next \p count bits (at most 32).
+    mi::Uint32 read( mi::Uint32 count)
+    {
+        if( count == 0)
+            return 0;
+
+        mi::Uint64 bits;
+        if( m_position >= 64)
+            bits = m_hi >> (m_position - 64);
+        else if( m_position + count <= 64)
+            bits = m_lo >> m_position;
+        else
+            bits = (m_lo >> m_position) | (m_hi << (64 - m_position));
+
+        m_position += count;
+        return static_cast<mi::Uint32>( bits & ((mi::Uint64( 1) << count) - 1));
+    }
+
+private:
+    static mi::Uint64 load_uint64( const mi::Uint8* const bytes)
+    {
+        mi::Uint64 result = 0;
+        for( int i = 7; i >= 0; --i)
+            result = (result << 8) | bytes[i];
+        return result;
+    }
+
+    mi::Uint64 m_lo;
+    mi::Uint64 m_hi;
+    mi::Uint32 m_position;
+};
+
+/// Interpolation weights for 2-, 3-, and 4-bit indices (BC6H and BC7).
+const mi::Uint32 g_weights_2[4]  = { 0, 21, 43, 64 };
+const mi::Uint32 g_weights_3[8]  = { 0, 9, 18, 27, 37, 46, 55, 64 };
+const mi::Uint32 g_weights_4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+const mi::Uint32* get_weights( mi::Uint32 index_bits)
+{
+    switch( index_bits) {
+        case 2: return g_weights_2;
+        case 3: return g_weights_3;
+        case 4: return g_weights_4;
+        default: ASSERT( M_IMAGE, false); return g_weights_4;
+    }
+}
+
+/// Partitions for two subsets (BC6H and BC7). Bit i is set iff pixel i belongs to subset 1.
+const mi::Uint16 g_partitions_2[64] = {
+    0xcccc, 0x8888, 0xeeee, 0xecc8, 0xc880, 0xfeec, 0xfec8, 0xec80,
+    0xc800, 0xffec, 0xfe80, 0xe800, 0xffe8, 0xff00, 0xfff0, 0xf000,
+    0xf710, 0x008e, 0x7100, 0x08ce, 0x008c, 0x7310, 0x3100, 0x8cce,
+    0x088c, 0x3110, 0x6666, 0x366c, 0x17e8, 0x0ff0, 0x718e, 0x399c,
+    0xaaaa, 0xf0f0, 0x5a5a, 0x33cc, 0x3c3c, 0x55aa, 0x9696, 0xa55a,
+    0x73ce, 0x13c8, 0x324c, 0x3bdc, 0x6996, 0xc33c, 0x9966, 0x0660,
+    0x0272, 0x04e4, 0x4e40, 0x2720, 0xc936, 0x936c, 0x39c6, 0x639c,
+    0x9336, 0x9cc6, 0x817e, 0xe718, 0xccf0, 0x0fcc, 0x7744, 0xee22
+};
+
+/// Partitions for three subsets (BC7). Subset index per pixel.
+const mi::Uint8 g_partitions_3[64][16] = {
+    { 0,0,1,1, 0,0,1,1, 0,2,2,1, 2,2,2,2 }, { 0,0,0,1, 0,0,1,1, 2,2,1,1, 2,2,2,1 },
+    { 0,0,0,0, 2,0,0,1, 2,2,1,1, 2,2,1,1 }, { 0,2,2,2, 0,0,2,2, 0,0,1,1, 0,1,1,1 },
+    { 0,0,0,0, 0,0,0,0, 1,1,2,2, 1,1,2,2 }, { 0,0,1,1, 0,0,1,1, 0,0,2,2, 0,0,2,2 },
+    { 0,0,2,2, 0,0,2,2, 1,1,1,1, 1,1,1,1 }, { 0,0,1,1, 0,0,1,1, 2,2,1,1, 2,2,1,1 },
+    { 0,0,0,0, 0,0,0,0, 1,1,1,1, 2,2,2,2 }, { 0,0,0,0, 1,1,1,1, 1,1,1,1, 2,2,2,2 },
+    { 0,0,0,0, 1,1,1,1, 2,2,2,2, 2,2,2,2 }, { 0,0,1,2, 0,0,1,2, 0,0,1,2, 0,0,1,2 },
+    { 0,1,1,2, 0,1,1,2, 0,1,1,2, 0,1,1,2 }, { 0,1,2,2, 0,1,2,2, 0,1,2,2, 0,1,2,2 },
+    { 0,0,1,1, 0,1,1,2, 1,1,2,2, 1,2,2,2 }, { 0,0,1,1, 2,0,0,1, 2,2,0,0, 2,2,2,0 },
+    { 0,0,0,1, 0,0,1,1, 0,1,1,2, 1,1,2,2 }, { 0,1,1,1, 0,0,1,1, 2,0,0,1, 2,2,0,0 },
+    { 0,0,0,0, 1,1,2,2, 1,1,2,2, 1,1,2,2 }, { 0,0,2,2, 0,0,2,2, 0,0,2,2, 1,1,1,1 },
+    { 0,1,1,1, 0,1,1,1, 0,2,2,2, 0,2,2,2 }, { 0,0,0,1, 0,0,0,1, 2,2,2,1, 2,2,2,1 },
+    { 0,0,0,0, 0,0,1,1, 0,1,2,2, 0,1,2,2 }, { 0,0,0,0, 1,1,0,0, 2,2,1,0, 2,2,1,0 },
+    { 0,1,2,2, 0,1,2,2, 0,0,1,1, 0,0,0,0 }, { 0,0,1,2, 0,0,1,2, 1,1,2,2, 2,2,2,2 },
+    { 0,1,1,0, 1,2,2,1, 1,2,2,1, 0,1,1,0 }, { 0,0,0,0, 0,1,1,0, 1,2,2,1, 1,2,2,1 },
+    { 0,0,2,2, 1,1,0,2, 1,1,0,2, 0,0,2,2 }, { 0,1,1,0, 0,1,1,0, 2,0,0,2, 2,2,2,2 },
+    { 0,0,1,1, 0,1,2,2, 0,1,2,2, 0,0,1,1 }, { 0,0,0,0, 2,0,0,0, 2,2,1,1, 2,2,2,1 },
+    { 0,0,0,0, 0,0,0,2, 1,1,2,2, 1,2,2,2 }, { 0,2,2,2, 0,0,2,2, 0,0,1,2, 0,0,1,1 },
+    { 0,0,1,1, 0,0,1,2, 0,0,2,2, 0,2,2,2 }, { 0,1,2,0, 0,1,2,0, 0,1,2,0, 0,1,2,0 },
+    { 0,0,0,0, 1,1,1,1, 2,2,2,2, 0,0,0,0 }, { 0,1,2,0, 1,2,0,1, 2,0,1,2, 0,1,2,0 },
+    { 0,1,2,0, 2,0,1,2, 1,2,0,1, 0,1,2,0 }, { 0,0,1,1, 2,2,0,0, 1,1,2,2, 0,0,1,1 },
+    { 0,0,1,1, 1,1,2,2, 2,2,0,0, 0,0,1,1 }, { 0,1,0,1, 0,1,0,1, 2,2,2,2, 2,2,2,2 },
+    { 0,0,0,0, 0,0,0,0, 2,1,2,1, 2,1,2,1 }, { 0,0,2,2, 1,1,2,2, 0,0,2,2, 1,1,2,2 },
+    { 0,0,2,2, 0,0,1,1, 0,0,2,2, 0,0,1,1 }, { 0,2,2,0, 1,2,2,1, 0,2,2,0, 1,2,2,1 },
+    { 0,1,0,1, 2,2,2,2, 2,2,2,2, 0,1,0,1 }, { 0,0,0,0, 2,1,2,1, 2,1,2,1, 2,1,2,1 },
+    { 0,1,0,1, 0,1,0,1, 0,1,0,1, 2,2,2,2 }, { 0,2,2,2, 0,1,1,1, 0,2,2,2, 0,1,1,1 },
+    { 0,0,0,2, 1,1,1,2, 0,0,0,2, 1,1,1,2 }, { 0,0,0,0, 2,1,1,2, 2,1,1,2, 2,1,1,2 },
+    { 0,2,2,2, 0,1,1,1, 0,1,1,1, 0,2,2,2 }, { 0,0,0,2, 1,1,1,2, 1,1,1,2, 0,0,0,2 },
+    { 0,1,1,0, 0,1,1,0, 0,1,1,0, 2,2,2,2 }, { 0,0,0,0, 0,0,0,0, 2,1,1,2, 2,1,1,2 },
+    { 0,1,1,0, 0,1,1,0, 2,2,2,2, 2,2,2,2 }, { 0,0,2,2, 0,0,1,1, 0,0,1,1, 0,0,2,2 },
+    { 0,0,2,2, 1,1,2,2, 1,1,2,2, 0,0,2,2 }, { 0,0,0,0, 0,0,0,0, 0,0,0,0, 2,1,1,2 },
+    { 0,0,0,2, 0,0,0,1, 0,0,0,2, 0,0,0,1 }, { 0,2,2,2, 1,2,2,2, 0,2,2,2, 1,2,2,2 },
+    { 0,1,0,1, 2,2,2,2, 2,2,2,2, 2,2,2,2 }, { 0,1,1,1, 2,0,1,1, 2,2,0,1, 2,2,2,0 }
+};
+
+/// Anchor index of the second subset for partitions with two subsets (BC6H and BC7).
+const mi::Uint8 g_anchors_2[64] = {
+    15,15,15,15,15,15,15,15, 15,15,15,15,15,15,15,15,
+    15, 2, 8, 2, 2, 8, 8,15,  2, 8, 2, 2, 8, 8, 2, 2,
+    15,15, 6, 8, 2, 8,15,15,  2, 8, 2, 2, 2,15,15, 6,
+     6, 2, 6, 8,15,15, 2, 2, 15,15,15,15,15, 2, 2,15
+};
+
+/// Anchor index of the second subset for partitions with three subsets (BC7).
+const mi::Uint8 g_anchors_3a[64] = {
+     3, 3,15,15, 8, 3,15,15,  8, 8, 6, 6, 6, 5, 3, 3,
+     3, 3, 8,15, 3, 3, 6,10,  5, 8, 8, 6, 8, 5,15,15,
+     8,15, 3, 5, 6,10, 8,15, 15, 3,15, 5,15,15,15,15,
+     3,15, 5, 5, 5, 8, 5,10,  5,10, 8,13,15,12, 3, 3
+};
+
+/// Anchor index of the third subset for partitions with three subsets (BC7).
+const mi::Uint8 g_anchors_3b[64] = {
+    15, 8, 8, 3,15,15, 3, 8, 15,15,15,15,15,15,15, 8,
+    15, 8,15, 3,15, 8,15, 8,  3,15, 6,10,15,15,10, 8,
+    15, 3,15,10,10, 8, 9,10,  6,15, 8,15, 3, 6, 6, 8,
+    15, 3,15,15,15,15,15,15, 15,15,15,15, 3,15,15, 8
+};
+
+/// Properties of the eight BC7 modes.
+struct Bc7_mode_info
+{
+    mi::Uint32 m_subsets;
+    mi::Uint32 m_partition_bits;
+    mi::Uint32 m_rotation_bits;
+    mi::Uint32 m_index_selection_bits;
+    mi::Uint32 m_color_bits;
+    mi::Uint32 m_alpha_bits;
+    mi::Uint32 m_endpoint_pbits;
+    mi::Uint32 m_shared_pbits;
+    mi::Uint32 m_index_bits;
+    mi::Uint32 m_index2_bits;
+};
+
+const Bc7_mode_info g_bc7_modes[8] = {
+    { 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+    { 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+    { 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+    { 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+    { 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+    { 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+    { 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+    { 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 }
+};
+
+/// The endpoint fields of BC6H blocks: the partition and the components w, x, y, z of the
+/// endpoints for red, green, and blue.
+enum Bc6h_field { D, RW, RX, RY, RZ, GW, GX, GY, GZ, BW, BX, BY, BZ, BC6H_FIELD_COUNT };
+
+/// A contiguous sequence of bits of a BC6H endpoint field.
+struct Bc6h_segment
+{
+    mi::Uint8 m_field;
+    mi::Uint8 m_shift;
+    mi::Uint8 m_count;
+};
+
+/// Properties of the 14 BC6H modes.
+struct Bc6h_mode_info
+{
+    bool m_transformed;
+    mi::Uint32 m_regions;
+    mi::Uint32 m_endpoint_bits;
+    mi::Uint32 m_delta_bits[3];
+    Bc6h_segment m_segments[24];   // terminated by a zero-length segment
+};
+
+#define S(field, shift, count) { field, shift, count }
+
+const Bc6h_mode_info g_bc6h_modes[14] = {
+    { true, 2, 10, { 5, 5, 5}, {
+        S(GY,4,1), S(BY,4,1), S(BZ,4,1), S(RW,0,10), S(GW,0,10), S(BW,0,10), S(RX,0,5), S(GZ,4,1),
+        S(GY,0,4), S(GX,0,5), S(BZ,0,1), S(GZ,0,4), S(BX,0,5), S(BZ,1,1), S(BY,0,4), S(RY,0,5),
+        S(BZ,2,1), S(RZ,0,5), S(BZ,3,1), S(D,0,5) } },
+    { true, 2, 7, { 6, 6, 6}, {
+        S(GY,5,1), S(GZ,4,1), S(GZ,5,1), S(RW,0,7), S(BZ,0,1), S(BZ,1,1), S(BY,4,1), S(GW,0,7),
+        S(BY,5,1), S(BZ,2,1), S(GY,4,1), S(BW,0,7), S(BZ,3,1), S(BZ,5,1), S(BZ,4,1), S(RX,0,6),
+        S(GY,0,4), S(GX,0,6), S(GZ,0,4), S(BX,0,6), S(BY,0,4), S(RY,0,6), S(RZ,0,6), S(D,0,5) } },
+    { true, 2, 11, { 5, 4, 4}, {
+        S(RW,0,10), S(GW,0,10), S(BW,0,10), S(RX,0,5), S(RW,10,1), S(GY,0,4), S(GX,0,4),
+        S(GW,10,1), S(BZ,0,1), S(GZ,0,4), S(BX,0,4), S(BW,10,1), S(BZ,1,1), S(BY,0,4), S(RY,0,5),
+        S(BZ,2,1), S(RZ,0,5), S(BZ,3,1), S(D,0,5) } },
+    { true, 2, 11, { 4, 5, 4}, {
+        S(RW,0,10), S(GW,0,10), S(BW,0,10), S(RX,0,4), S(RW,10,1), S(GZ,4,1), S(GY,0,4),
+        S(GX,0,5), S(GW,10,1), S(GZ,0,4), S(BX,0,4), S(BW,10,1), S(BZ,1,1), S(BY,0,4), S(RY,0,4),
+        S(BZ,0,1), S(BZ,2,1), S(RZ,0,4), S(GY,4,1), S(BZ,3,1), S(D,0,5) } },
+    { true, 2, 11, { 4, 4, 5}, {
+        S(RW,0,10), S(GW,0,10), S(BW,0,10), S(RX,0,4), S(RW,10,1), S(BY,4,1), S(GY,0,4),
+        S(GX,0,4), S(GW,10,1), S(BZ,0,1), S(GZ,0,4), S(BX,0,5), S(BW,10,1), S(BY,0,4), S(RY,0,4),
+        S(BZ,1,1), S(BZ,2,1), S(RZ,0,4), S(BZ,4,1), S(BZ,3,1), S(D,0,5) } },
+    { true, 2, 9, { 5, 5, 5}, {
+        S(RW,0,9), S(BY,4,1), S(GW,0,9), S(GY,4,1), S(BW,0,9), S(BZ,4,1), S(RX,0,5), S(GZ,4,1),
+        S(GY,0,4), S(GX,0,5), S(BZ,0,1), S(GZ,0,4), S(BX,0,5), S(BZ,1,1), S(BY,0,4), S(RY,0,5),
+        S(BZ,2,1), S(RZ,0,5), S(BZ,3,1), S(D,0,5) } },
+    { true, 2, 8, { 6, 5, 5}, {
+        S(RW,0,8), S(GZ,4,1), S(BY,4,1), S(GW,0,8), S(BZ,2,1), S(GY,4,1), S(BW,0,8), S(BZ,3,1),
+        S(BZ,4,1), S(RX,0,6), S(GY,0,4), S(GX,0,5), S(BZ,0,1), S(GZ,0,4), S(BX,0,5), S(BZ,1,1),
+        S(BY,0,4), S(RY,0,6), S(RZ,0,6), S(D,0,5) } },
+    { true, 2, 8, { 5, 6, 5}, {
+        S(RW,0,8), S(BZ,0,1), S(BY,4,1), S(GW,0,8), S(GY,5,1), S(GY,4,1), S(BW,0,8), S(GZ,5,1),
+        S(BZ,4,1), S(RX,0,5), S(GZ,4,1), S(GY,0,4), S(GX,0,6), S(GZ,0,4), S(BX,0,5), S(BZ,1,1),
+        S(BY,0,4), S(RY,0,5), S(BZ,2,1), S(RZ,0,5), S(BZ,3,1), S(D,0,5) } },
+    { true, 2, 8, { 5, 5, 6}, {
+        S(RW,0,8), S(BZ,1,1), S(BY,4,1), S(GW,0,8), S(BY,5,1), S(GY,4,1), S(BW,0,8), S(BZ,5,1),
+        S(BZ,4,1), S(RX,0,5), S(GZ,4,1), S(GY,0,4), S(GX,0,5), S(BZ,0,1), S(GZ,0,4), S(BX,0,6),
+        S(BY,0,4), S(RY,0,5), S(BZ,2,1), S(RZ,0,5), S(BZ,3,1), S(D,0,5) } },
+    { false, 2, 6, { 6, 6, 6}, {
+        S(RW,0,6), S(GZ,4,1), S(BZ,0,1), S(BZ,1,1), S(BY,4,1), S(GW,0,6), S(GY,5,1), S(BY,5,1),
+        S(BZ,2,1), S(GY,4,1), S(BW,0,6), S(GZ,5,1), S(BZ,3,1), S(BZ,5,1), S(BZ,4,1), S(RX,0,6),
+        S(GY,0,4), S(GX,0,6), S(GZ,0,4), S(BX,0,6), S(BY,0,4), S(RY,0,6), S(RZ,0,6), S(D,0,5) } },
+    { false, 1, 10, { 10, 10, 10}, {
+        S(RW,0,10), S(GW,0,10), S(BW,0,10), S(RX,0,10), S(GX,0,10), S(BX,0,10) } },
+    { true, 1, 11, { 9, 9, 9}, {
+        S(RW,0,10), S(GW,0,10), S(BW,0,10), S(RX,0,9), S(RW,10,1), S(GX,0,9), S(GW,10,1),
+        S(BX,0,9), S(BW,10,1) } },
+    { true, 1, 12, { 8, 8, 8}, {
+        S(RW,0,10), S(GW,0,10), S(BW,0,10), S(RX,0,8), S(RW,11,1), S(RW,10,1), S(GX,0,8),
+        S(GW,11,1), S(GW,10,1), S(BX,0,8), S(BW,11,1), S(BW,10,1) } },
+    { true, 1, 16, { 4, 4, 4}, {
+        S(RW,0,10), S(GW,0,10), S(BW,0,10), S(RX,0,4), S(RW,15,1), S(RW,14,1), S(RW,13,1),
+        S(RW,12,1), S(RW,11,1), S(RW,10,1), S(GX,0,4), S(GW,15,1), S(GW,14,1), S(GW,13,1),
+        S(GW,12,1), S(GW,11,1), S(GW,10,1), S(BX,0,4), S(BW,15,1), S(BW,14,1), S(BW,13,1),
+        S(BW,12,1), S(BW,11,1), S(BW,10,1) } }
+};
+
+#undef S
+
+/// Sign-extends the lowest \\p bits bits of \\p value.
+mi::Sint32 sign_extend( mi::Sint32 value, mi::Uint32 bits)
+{
+    const mi::Uint32 shift = 32 - bits;
+    return static_cast<mi::Sint32>( static_cast<mi::Uint32>( value) << shift) >> shift;
+}
+
+/// Maps a quantized BC6H endpoint component to the 16-bit range (or 15-bit plus sign).
+mi::Sint32 bc6h_unquantize( mi::Sint32 value, mi::Uint32 bits, bool is_signed)
+{
+    if( !is_signed) {
+        if( bits >= 15)
+            return value;
+        if( value == 0)
+            return 0;
+        if( value == (1 << bits) - 1)
+            return 0xffff;
+        return ((value << 16) + 0x8000) >> bits;
+    }
+
+    if( bits >= 16)
+        return value;
+    const bool negative = value < 0;
+    if( negative)
+        value = -value;
+    mi::Sint32 result;
+    if( value == 0)
+        result = 0;
+    else if( value >= (1 << (bits - 1)) - 1)
+        result = 0x7fff;
+    else
+        result = ((value << 15) + 0x4000) >> (bits - 1);
+    return negative ? -result : result;
+}
+
+/// Converts an interpolated BC6H value to a float (via its half representation).
+mi::Float32 bc6h_finish_unquantize( mi::Sint32 value, bool is_signed)
+{
+    if( !is_signed)
+        return half_to_float( static_cast<mi::Uint16>( (value * 31) >> 6));
+
+    const mi::Uint16 half = value < 0
+        ? static_cast<mi::Uint16>( 0x8000 | ((-value * 31) >> 5))
+        : static_cast<mi::Uint16>( (value * 31) >> 5);
+    return half_to_float( half);
+}
+
+/// Decodes a BC6H block into 16 "Rgb_fp" pixels.
+///
+/// The mode in the lowest bits selects the layout of the endpoint fields, their precision, and
+/// whether the endpoints other than the first one are stored as deltas. Blocks with one region
+/// use 4-bit indices, blocks with two regions 3-bit indices and one of 32 partitions.
+void decompress_bc6h( const mi::Uint8* const block, mi::Uint8* pixels, bool is_signed)
+{
+    Bit_reader reader( block);
+
+    mi::Uint32 mode = reader.read( 2);
+    if( mode >= 2) {
+        mode |= reader.read( 3) << 2;
+        if( (mode & 0x3) == 0x2)
+            mode = (mode >> 2) + 2;
+        else if( (mode >> 2) < 4)
+            mode = (mode >> 2) + 10;
+        else
+            mode = 14;
+    }
+
+    // Reserved modes decode to black.
+    if( mode >= 14) {
+        memset( pixels, 0, 16 * 3 * sizeof( mi::Float32));
+        return;
+    }
+
+    const Bc6h_mode_info& info = g_bc6h_modes[mode];
+
+    mi::Sint32 fields[BC6H_FIELD_COUNT] = {};
+    for( const Bc6h_segment* segment = info.m_segments; segment->m_count > 0; ++segment)
+        fields[segment->m_field] |= reader.read( segment->m_count) << segment->m_shift;
+
+    // Endpoints 0 and 1 belong to the first region, endpoints 2 and 3 to the second region.
+    const mi::Uint32 endpoint_count = 2 * info.m_regions;
+    mi::Sint32 endpoints[4][3] = {
+        { fields[RW], fields[GW], fields[BW] },
+        { fields[RX], fields[GX], fields[BX] },
+        { fields[RY], fields[GY], fields[BY] },
+        { fields[RZ], fields[GZ], fields[BZ] }
+    };
+
+    for( mi::Uint32 c = 0; c < 3; ++c) {
+        if( is_signed)
+            endpoints[0][c] = sign_extend( endpoints[0][c], info.m_endpoint_bits);
+        if( is_signed || info.m_transformed)
+            for( mi::Uint32 e = 1; e < endpoint_count; ++e)
+                endpoints[e][c] = sign_extend( endpoints[e][c], info.m_delta_bits[c]);
+        if( info.m_transformed) {
+            const mi::Sint32 mask = (1 << info.m_endpoint_bits) - 1;
+            for( mi::Uint32 e = 1; e < endpoint_count; ++e) {
+                endpoints[e][c] = (endpoints[0][c] + endpoints[e][c]) & mask;
+                if( is_signed)
+                    endpoints[e][c] = sign_extend( endpoints[e][c], info.m_endpoint_bits);
+            }
+        }
+        for( mi::Uint32 e = 0; e < endpoint_count; ++e)
+            endpoints[e][c] = bc6h_unquantize( endpoints[e][c], info.m_endpoint_bits, is_signed);
+    }
+
+    const mi::Uint32 partition   = static_cast<mi::Uint32>( fields[D]);
+    const mi::Uint32 index_bits  = info.m_regions == 1 ? 4 : 3;
+    const mi::Uint32* weights    = get_weights( index_bits);
+
+    for( mi::Uint32 i = 0; i < 16; ++i) {
+
+        const bool anchor = i == 0 || (info.m_regions == 2 && i == g_anchors_2[partition]);
+        const mi::Sint32 weight = static_cast<mi::Sint32>(
+            weights[reader.read( index_bits - (anchor ? 1 : 0))]);
+        const mi::Uint32 region
+            = info.m_regions == 2 ? (g_partitions_2[partition] >> i) & 1 : 0;
+
+        mi::Float32 pixel[3];
+        for( mi::Uint32 c = 0; c < 3; ++c) {
+            const mi::Sint32 e0 = endpoints[2*region  ][c];
+            const mi::Sint32 e1 = endpoints[2*region+1][c];
+            const mi::Sint32 value = ((64 - weight) * e0 + weight * e1 + 32) >> 6;
+            pixel[c] = bc6h_finish_unquantize( value, is_signed);
+        }
+        memcpy( pixels + i * sizeof( pixel), pixel, sizeof( pixel));
+    }
+}
+
+/// Decodes a BC7 block into 16 RGBA pixels.
+///
+/// The mode is encoded in unary in the lowest bits. It selects the number of subsets, the
+/// precision of color and alpha endpoints, the kind of P-bits, and the index precision. Modes 4
+/// and 5 use separate indices for color and alpha and allow to rotate alpha into one of the
+/// color channels.
+void decompress_bc7( const mi::Uint8* const block, mi::Uint8* pixels)
+{
+    Bit_reader reader( block);
+
+    mi::Uint32 mode = 0;
+    while( mode < 8 && reader.read( 1) == 0)
+        ++mode;
+
+    // Reserved mode decodes to transparent black.
+    if( mode == 8) {
+        memset( pixels, 0, 16 * 4);
+        return;
+    }
+
+    const Bc7_mode_info& info = g_bc7_modes[mode];
+    const mi::Uint32 partition       = reader.read( info.m_partition_bits);
+    const mi::Uint32 rotation        = reader.read( info.m_rotation_bits);
+    const mi::Uint32 index_selection = reader.read( info.m_index_selection_bits);
+
+    // Endpoints 2*s and 2*s+1 belong to subset s.
+    const mi::Uint32 endpoint_count = 2 * info.m_subsets;
+    mi::Uint32 endpoints[6][4];
+    for( mi::Uint32 c = 0; c < 3; ++c)
+        for( mi::Uint32 e = 0; e < endpoint_count; ++e)
+            endpoints[e][c] = reader.read( info.m_color_bits);
+    for( mi::Uint32 e = 0; e < endpoint_count; ++e)
+        endpoints[e][3] = reader.read( info.m_alpha_bits);
+
+    mi::Uint32 color_bits = info.m_color_bits;
+    mi::Uint32 alpha_bits = info.m_alpha_bits;
+    if( info.m_endpoint_pbits || info.m_shared_pbits) {
+        const mi::Uint32 components = alpha_bits > 0 ? 4 : 3;
+        for( mi::Uint32 e = 0; e < endpoint_count; ++e) {
+            if( info.m_shared_pbits && e % 2 == 1) {
+                // Shares the P-bit of the previous endpoint, stored in the lowest bits.
+                for( mi::Uint32 c = 0; c < components; ++c)
+                    endpoints[e][c] = (endpoints[e][c] << 1) | (endpoints[e-1][c] & 1);
+                continue;
+            }
+            const mi::Uint32 pbit = reader.read( 1);
+            for( mi::Uint32 c = 0; c < components; ++c)
+                endpoints[e][c] = (endpoints[e][c] << 1) | pbit;
+        }
+        ++color_bits;
+        if( alpha_bits > 0)
+            ++alpha_bits;
+    }
+
+    // Expand endpoints to 8 bits by replicating the highest bits.
+    for( mi::Uint32 e = 0; e < endpoint_count; ++e) {
+        for( mi::Uint32 c = 0; c < 3; ++c) {
+            endpoints[e][c] <<= 8 - color_bits;
+            endpoints[e][c] |= endpoints[e][c] >> color_bits;
+        }
+        if( alpha_bits > 0) {
+            endpoints[e][3] <<= 8 - alpha_bits;
+            endpoints[e][3] |= endpoints[e][3] >> alpha_bits;
+        } else
+            endpoints[e][3] = 255;
+    }
+
+    // Read the indices. The anchor index of each subset is stored with one bit less.
+    mi::Uint32 indices[16];
+    for( mi::Uint32 i = 0; i < 16; ++i) {
+        bool anchor = i == 0;
+        if( info.m_subsets == 2)
+            anchor = anchor || i == g_anchors_2[partition];
+        else if( info.m_subsets == 3)
+            anchor = anchor || i == g_anchors_3a[partition] || i == g_anchors_3b[partition];
+        indices[i] = reader.read( info.m_index_bits - (anchor ? 1 : 0));
+    }
+
+    mi::Uint32 indices2[16] = {};
+    if( info.m_index2_bits > 0)
+        for( mi::Uint32 i = 0; i < 16; ++i)
+            indices2[i] = reader.read( info.m_index2_bits - (i == 0 ? 1 : 0));
+
+    // Select which index set is used for color and alpha.
+    const mi::Uint32* color_indices = indices;
+    const mi::Uint32* alpha_indices = indices;
+    mi::Uint32 color_index_bits = info.m_index_bits;
+    mi::Uint32 alpha_index_bits = info.m_index_bits;
+    if( info.m_index2_bits > 0) {
+        if( index_selection == 0) {
+            alpha_indices    = indices2;
+            alpha_index_bits = info.m_index2_bits;
+        } else {
+            color_indices    = indices2;
+            color_index_bits = info.m_index2_bits;
+        }
+    }
+    const mi::Uint32* color_weights = get_weights( color_index_bits);
+    const mi::Uint32* alpha_weights = get_weights( alpha_index_bits);
+
+    for( mi::Uint32 i = 0; i < 16; ++i) {
+
+        mi::Uint32 subset = 0;
+        if( info.m_subsets == 2)
+            subset = (g_partitions_2[partition] >> i) & 1;
+        else if( info.m_subsets == 3)
+            subset = g_partitions_3[partition][i];
+
+        const mi::Uint32* e0 = endpoints[2*subset];
+        const mi::Uint32* e1 = endpoints[2*subset+1];
+        const mi::Uint32 color_weight = color_weights[color_indices[i]];
+        const mi::Uint32 alpha_weight = alpha_weights[alpha_indices[i]];
+
+        mi::Uint8* rgba = pixels + i * 4;
+        for( mi::Uint32 c = 0; c < 3; ++c)
+            rgba[c] = static_cast<mi::Uint8>(
+                ((64 - color_weight) * e0[c] + color_weight * e1[c] + 32) >> 6);
+        rgba[3] = static_cast<mi::Uint8>(
+            ((64 - alpha_weight) * e0[3] + alpha_weight * e1[3] + 32) >> 6);
+
+        if( rotation > 0)
+            std::swap( rgba[3], rgba[rotation-1]);
+    }
+}
+
+} // namespace
+
+void decompress_block( Pixel_type pixel_type, const mi::Uint8* block, mi::Uint8* pixels)
+{
+    ASSERT( M_IMAGE, block);
+    ASSERT( M_IMAGE, pixels);
+
+    switch( pixel_type) {
+        case PT_BC1:   decompress_bc1 ( block, pixels); return;
+        case PT_BC2:   decompress_bc2 ( block, pixels); return;
+        case PT_BC3:   decompress_bc3 ( block, pixels); return;
+        case PT_BC4:   decompress_bc4 ( block, pixels); return;
+        case PT_BC4S:  decompress_bc4s( block, pixels); return;
+        case PT_BC5:   decompress_bc5 ( block, pixels); return;
+        case PT_BC5S:  decompress_bc5s( block, pixels); return;
+        case PT_BC6H:  decompress_bc6h( block, pixels, /*is_signed*/ false); return;
+        case PT_BC6HS: decompress_bc6h( block, pixels, /*is_signed*/ true); return;
+        case PT_BC7:   decompress_bc7 ( block, pixels); return;
+        default:       ASSERT( M_IMAGE, false); return;
+    }
+}
+
+mi::neuraylib::ITile* decompress_tile( const mi::neuraylib::ITile* tile, bool flip)
+{
+    const Pixel_type pixel_type = convert_pixel_type_string_to_enum( tile->get_type());
+    if( !is_compressed_pixel_type( pixel_type))
+        return nullptr;
+
+    const Pixel_type result_pixel_type = get_decompressed_pixel_type( pixel_type);
+    const mi::Uint32 width  = tile->get_resolution_x();
+    const mi::Uint32 height = tile->get_resolution_y();
+    mi::neuraylib::ITile* result = create_tile( result_pixel_type, width, height);
+
+    const mi::Uint32 bytes_per_block = get_bytes_per_block( pixel_type);
+    const mi::Uint32 bytes_per_pixel = get_bytes_per_pixel( result_pixel_type);
+    const mi::Uint32 blocks_x = (width  + BLOCK_PIXEL_DIM - 1) / BLOCK_PIXEL_DIM;
+    const mi::Uint32 blocks_y = (height + BLOCK_PIXEL_DIM - 1) / BLOCK_PIXEL_DIM;
+
+    const auto* src = static_cast<const mi::Uint8*>( tile->get_data());
+    auto* dest = static_cast<mi::Uint8*>( result->get_data());
+
+    // Large enough for 16 pixels of all decompressed pixel types.
+    mi::Uint8 pixels[16 * 4 * sizeof( mi::Float32)];
+
+    for( mi::Uint32 block_y = 0; block_y < blocks_y; ++block_y)
+        for( mi::Uint32 block_x = 0; block_x < blocks_x; ++block_x, src += bytes_per_block) {
+
+            decompress_block( pixel_type, src, pixels);
+
+            // Skip the padding of partial blocks at the right and bottom border.
+            const mi::Uint32 x = block_x * BLOCK_PIXEL_DIM;
+            const mi::Uint32 count = std::min( BLOCK_PIXEL_DIM, width - x);
+            for( mi::Uint32 row = 0; row < BLOCK_PIXEL_DIM; ++row) {
+                const mi::Uint32 y = block_y * BLOCK_PIXEL_DIM + row;
+                if( y >= height)
+                    break;
+                const mi::Uint32 dest_y = flip ? height - 1 - y : y;
+                memcpy(
+                    dest + (static_cast<mi::Size>( dest_y) * width + x) * bytes_per_pixel,
+                    pixels + row * BLOCK_PIXEL_DIM * bytes_per_pixel,
+                    count * bytes_per_pixel);
+            }
+        }
+
+    return result;
+}
+
+} // namespace IMAGE
+
+} // namespace MI
@@ -0,0 +1,63 @@
+/***************************************************************************************************
+ * Copyright (c) 2012-2022, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************************************/
+
+#ifndef IO_IMAGE_IMAGE_IMAGE_BLOCK_COMPRESSION_H
+#define IO_IMAGE_IMAGE_IMAGE_BLOCK_COMPRESSION_H
+
+#include <mi/base/types.h>
+
+#include "i_image_utilities.h"
+
+namespace mi { namespace neuraylib { class ITile; } }
+
+namespace MI {
+
+namespace IMAGE {
+
+/// Decodes one 4x4 block of a block-compressed pixel type.
+///
+/// \param pixel_type   A block-compressed pixel type, see #is_compressed_pixel_type().
+/// \param block        The block data (#get_bytes_per_block() bytes).
+/// \param pixels       Receives the 16 decoded pixels in the pixel type returned by
+///                     #get_decompressed_pixel_type(), row by row starting with the top row.
+void decompress_block( Pixel_type pixel_type, const mi::Uint8* block, mi::Uint8* pixels);
+
+/// Decodes a tile of a block-compressed pixel type.
+///
+/// \param tile         The tile to decode.
+/// \param flip         Indicates whether the rows are flipped. Blocks are stored top-down. All
+///                     other pixel data is stored bottom-up, except for cubemap faces.
+/// \return             A tile of the pixel type returned by #get_decompressed_pixel_type(), or
+///                     \c nullptr if the pixel type of \p tile is not block-compressed.
+mi::neuraylib::ITile* decompress_tile( const mi::neuraylib::ITile* tile, bool flip);
+
+} // namespace IMAGE
+
+} // namespace MI
+
+#endif // IO_IMAGE_IMAGE_IMAGE_BLOCK_COMPRESSION_H
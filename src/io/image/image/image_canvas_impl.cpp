@@ -34,7 +34,9 @@
 
 #include "i_image.h"
 #include "i_image_utilities.h"
+#include "image_block_compression.h"
 #include "image_canvas_impl.h"
+#include "image_tile_cache.h"
 #include "image_tile_impl.h"
 
 #include <base/system/main/access_module.h>
@@ -44,6 +46,9 @@
 #include <base/hal/disk/disk_memory_reader_writer_impl.h>
 #include <base/hal/hal/i_hal_ospath.h>
 
+#include <algorithm>
+#include <cstring>
+
 namespace MI {
 
 namespace IMAGE {
@@ -58,6 +63,36 @@ std::string get_selector_string( const char* selector)
     return std::string( "selector \"") + selector + "\"";
 }
 
+/// Returns the pixel type of a canvas loaded from an image file with the given pixel type.
+///
+/// Block-compressed data is decompressed unless the IMAGE module is configured to keep it
+/// compressed. Cubemaps and canvases with a selector are always decompressed.
+Pixel_type get_canvas_pixel_type(
+    Pixel_type file_pixel_type, bool is_cubemap, const char* selector)
+{
+    if( !is_compressed_pixel_type( file_pixel_type))
+        return file_pixel_type;
+
+    SYSTEM::Access_module<Image_module> image_module( false);
+    if( image_module->get_keep_compressed() && !is_cubemap && !selector)
+        return file_pixel_type;
+
+    return get_decompressed_pixel_type( file_pixel_type);
+}
+
+/// Decompresses a tile returned by an image plugin unless the canvas keeps it compressed.
+void decompress_if_needed(
+    mi::base::Handle<mi::neuraylib::ITile>& tile, Pixel_type canvas_pixel_type, bool is_cubemap)
+{
+    if( !tile || is_compressed_pixel_type( canvas_pixel_type))
+        return;
+    if( !is_compressed_pixel_type( convert_pixel_type_string_to_enum( tile->get_type())))
+        return;
+
+    // Like the blocks, cubemap faces are stored top-down.
+    tile = decompress_tile( tile.get(), !is_cubemap);
+}
+
 } // namespace
 
 Canvas_impl::Canvas_impl(
@@ -165,6 +200,8 @@ Canvas_impl::Canvas_impl(
         return;
     }
 
+    m_pixel_type = get_canvas_pixel_type( m_pixel_type, m_is_cubemap, selector);
+
     if( selector && m_pixel_type) {
         const Pixel_type new_pixel_type = get_pixel_type_for_channel( m_pixel_type, selector);
         if( new_pixel_type == PT_UNDEF) {
@@ -201,6 +238,7 @@ Canvas_impl::Canvas_impl(
     }
 
     m_tiles.resize( m_nr_of_layers);
+    init_blocks();
 
     *errors = 0;
 }
@@ -285,6 +323,8 @@ Canvas_impl::Canvas_impl(
         return;
     }
 
+    m_pixel_type = get_canvas_pixel_type( m_pixel_type, m_is_cubemap, selector);
+
     if( selector && m_pixel_type) {
         const Pixel_type new_pixel_type = get_pixel_type_for_channel( m_pixel_type, selector);
         if( new_pixel_type == PT_UNDEF) {
@@ -325,12 +365,14 @@ Canvas_impl::Canvas_impl(
     m_tiles.resize( m_nr_of_layers);
 
     if( supports_lazy_loading()) {
+        init_blocks();
         *errors = 0;
         return;
     }
 
     for( mi::Uint32 z = 0; z < m_nr_of_layers; ++z) {
         m_tiles[z] = image_file2->read( z, m_miplevel);
+        decompress_if_needed( m_tiles[z], m_pixel_type, m_is_cubemap);
         if( !m_tiles[z]) {
             LOG::mod_log->error( M_IMAGE, LOG::Mod_log::C_IO,
                     "The image plugin failed to import \"%s\" in \"%s\".",
@@ -420,6 +462,8 @@ Canvas_impl::Canvas_impl(
         return;
     }
 
+    m_pixel_type = get_canvas_pixel_type( m_pixel_type, m_is_cubemap, selector);
+
     if( selector && m_pixel_type) {
         const Pixel_type new_pixel_type = get_pixel_type_for_channel( m_pixel_type, selector);
         if( new_pixel_type == PT_UNDEF) {
@@ -460,6 +504,7 @@ Canvas_impl::Canvas_impl(
 
     for( mi::Uint32 z = 0; z < m_nr_of_layers; ++z) {
         m_tiles[z] = image_file2->read( z, m_miplevel);
+        decompress_if_needed( m_tiles[z], m_pixel_type, m_is_cubemap);
         if( !m_tiles[z]) {
             LOG::mod_log->error( M_IMAGE, LOG::Mod_log::C_IO,
                 "The image plugin failed to import %s.", log_identifier.c_str());
@@ -498,6 +543,12 @@ Canvas_impl::Canvas_impl(
     m_tiles = tiles;
 }
 
+Canvas_impl::~Canvas_impl()
+{
+    if( m_uses_tile_cache)
+        Tile_cache::get_instance().erase( this);
+}
+
 const char* Canvas_impl::get_type() const
 {
     return convert_pixel_type_enum_to_string( m_pixel_type);
@@ -516,20 +567,31 @@ const mi::neuraylib::ITile* Canvas_impl::get_tile( mi::Uint32 layer) const
 
     mi::base::Lock::Block block( &m_lock);
 
-    if( m_tiles[layer] == nullptr) {
-        ASSERT( M_IMAGE, supports_lazy_loading());
-#ifdef MI_IMAGE_LOAD_ONLY_REQUESTED_TILE
+    // Layers of canvases without blocks are loaded as a whole.
+    if( !m_tiles[layer] && !m_uses_blocks)
         m_tiles[layer] = load_tile( layer);
-#else
-        for( mi::Uint32 z = 0; z < m_nr_of_layers; ++z) {
-            ASSERT( M_IMAGE, !m_tiles[z]);
-            m_tiles[z] = load_tile( z);
-        }
-#endif
+
+    if( m_tiles[layer]) {
+        m_tiles[layer]->retain();
+        return m_tiles[layer].get();
     }
 
-    m_tiles[layer]->retain();
-    return m_tiles[layer].get();
+    // Keep the assembled layer instead of its blocks, such that repeated calls neither copy nor
+    // decode the layer again, and such that the layer is charged to the budget of the tile cache.
+    ASSERT( M_IMAGE, m_uses_blocks);
+    Tile_cache& tile_cache = Tile_cache::get_instance();
+    if( m_layers[layer])
+        tile_cache.touch( this, get_layer_index( layer));
+    else {
+        m_layers[layer] = assemble_layer( layer);
+        drop_blocks( layer);
+        m_uses_tile_cache = true;
+        tile_cache.insert(
+            this, get_layer_index( layer), get_tile_size( m_layers[layer].get()));
+    }
+
+    m_layers[layer]->retain();
+    return m_layers[layer].get();
 }
 
 mi::neuraylib::ITile* Canvas_impl::get_tile( mi::Uint32 layer)
@@ -539,39 +601,60 @@ mi::neuraylib::ITile* Canvas_impl::get_tile( mi::Uint32 layer)
 
     mi::base::Lock::Block block( &m_lock);
 
-    if( m_tiles[layer] == nullptr) {
-
-        ASSERT( M_IMAGE, supports_lazy_loading());
-#ifdef MI_IMAGE_LOAD_ONLY_REQUESTED_TILE
+    // The tile might get modified, keep it as a whole from now on.
+    if( m_tiles[layer] == nullptr && m_uses_blocks) {
+        m_tiles[layer] = assemble_layer( layer);
+        drop_blocks( layer);
+        drop_layer( layer);
+    } else if( m_tiles[layer] == nullptr)
         m_tiles[layer] = load_tile( layer);
-#else
-        for( mi::Uint32 z = 0; z < m_nr_of_layers; ++z) {
-            ASSERT( M_IMAGE, !m_tiles[z]);
-            m_tiles[z] = load_tile( z);
-        }
-#endif
-    }
 
     m_tiles[layer]->retain();
     return m_tiles[layer].get();
 }
 
+const mi::neuraylib::ITile* Canvas_impl::get_block(
+    mi::Uint32 block_x, mi::Uint32 block_y, mi::Uint32 layer) const
+{
+    if(    !m_uses_blocks
+        || layer >= m_nr_of_layers
+        || block_x >= m_nr_of_blocks_x
+        || block_y >= m_nr_of_blocks_y)
+        return nullptr;
+
+    mi::base::Lock::Block block( &m_lock);
+
+    if( m_tiles[layer])
+        return nullptr;
+
+    const mi::Uint32 index = get_block_index( block_x, block_y, layer);
+    if( m_blocks[index] == nullptr)
+        load_missing_blocks( layer);
+    else
+        Tile_cache::get_instance().touch( this, index);
+
+    m_blocks[index]->retain();
+    return m_blocks[index].get();
+}
+
 mi::Size Canvas_impl::get_size() const
 {
     mi::Size size = sizeof( *this);
 
     size += m_nr_of_layers * sizeof( mi::base::Handle<mi::neuraylib::ITile>); // m_tiles
+    size += m_blocks.size() * sizeof( mi::base::Handle<mi::neuraylib::ITile>); // m_blocks
+    size += m_layers.size() * sizeof( mi::base::Handle<mi::neuraylib::ITile>); // m_layers
 
+    mi::base::Lock::Block block( &m_lock);
     for( mi::Uint32 i = 0; i < m_nr_of_layers; ++i)          // m_tiles[i]
-        if( m_tiles[i]) {
-            mi::base::Handle<ITile> tile_internal( m_tiles[i]->get_interface<ITile>());
-            if( tile_internal)         // exact memory usage
-                size += tile_internal->get_size();
-            else                                            // approximate memory usage
-                size +=   static_cast<size_t>( m_width)
-                        * static_cast<size_t>( m_height)
-                        * get_bytes_per_pixel( m_pixel_type);
-        }
+        if( m_tiles[i])
+            size += get_tile_size( m_tiles[i].get());
+    for( const auto& b: m_blocks)                            // m_blocks[i]
+        if( b)
+            size += get_tile_size( b.get());
+    for( const auto& l: m_layers)                            // m_layers[i]
+        if( l)
+            size += get_tile_size( l.get());
 
     return size;
 }
@@ -584,10 +667,37 @@ bool Canvas_impl::release_tiles() const
     mi::base::Lock::Block block( &m_lock);
     for( mi::Uint32 z = 0; z < m_nr_of_layers; ++z)
         m_tiles[z] = 0;
+    for( auto& b: m_blocks)
+        b = 0;
+    for( auto& l: m_layers)
+        l = 0;
+
+    if( m_uses_tile_cache)
+        Tile_cache::get_instance().erase( this);
 
     return true;
 }
 
+bool Canvas_impl::try_evict_block( mi::Uint32 index) const
+{
+    mi::base::Lock::Block block;
+    if( !block.try_set( &m_lock))
+        return false;
+
+    mi::base::Handle<mi::neuraylib::ITile>& tile = index < m_blocks.size()
+        ? m_blocks[index] : m_layers[index - m_blocks.size()];
+    ASSERT( M_IMAGE, tile);
+
+    // Do not release tiles that are still referenced elsewhere, that would not free any memory.
+    const mi::Uint32 ref_count = tile->retain();
+    tile->release();
+    if( ref_count > 2)
+        return false;
+
+    tile = nullptr;
+    return true;
+}
+
 bool Canvas_impl::supports_lazy_loading() const
 {
     // either both m_archive_filename or m_member_filename are set or none
@@ -607,6 +717,138 @@ bool Canvas_impl::supports_lazy_loading() const
     return callback;
 }
 
+namespace {
+
+/// Copies a rectangular region of \p width x \p height pixels between two tiles of the same
+/// pixel type.
+void copy_region(
+    const mi::neuraylib::ITile* src,
+    mi::Uint32 src_x,
+    mi::Uint32 src_y,
+    mi::neuraylib::ITile* dst,
+    mi::Uint32 dst_x,
+    mi::Uint32 dst_y,
+    mi::Uint32 width,
+    mi::Uint32 height,
+    mi::Uint32 bytes_per_pixel)
+{
+    const mi::Size src_stride = static_cast<mi::Size>( src->get_resolution_x()) * bytes_per_pixel;
+    const mi::Size dst_stride = static_cast<mi::Size>( dst->get_resolution_x()) * bytes_per_pixel;
+    const mi::Size row_size   = static_cast<mi::Size>( width) * bytes_per_pixel;
+
+    const auto* s = static_cast<const mi::Uint8*>( src->get_data())
+        + src_y * src_stride + static_cast<mi::Size>( src_x) * bytes_per_pixel;
+    auto* d = static_cast<mi::Uint8*>( dst->get_data())
+        + dst_y * dst_stride + static_cast<mi::Size>( dst_x) * bytes_per_pixel;
+
+    for( mi::Uint32 y = 0; y < height; ++y, s += src_stride, d += dst_stride)
+        memcpy( d, s, row_size);
+}
+
+} // namespace
+
+void Canvas_impl::init_blocks()
+{
+    // Blocks of pixels are not compatible with the 4x4 pixel blocks of block-compressed data.
+    if( is_compressed_pixel_type( m_pixel_type))
+        return;
+
+    m_uses_blocks     = true;
+    m_nr_of_blocks_x  = (m_width  + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    m_nr_of_blocks_y  = (m_height + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    m_blocks.resize(
+        static_cast<size_t>( m_nr_of_blocks_x) * m_nr_of_blocks_y * m_nr_of_layers);
+    m_layers.resize( m_nr_of_layers);
+}
+
+void Canvas_impl::load_missing_blocks( mi::Uint32 layer) const
+{
+    ASSERT( M_IMAGE, !m_tiles[layer]);
+
+    // The plugins decode whole layers. Prefer cutting the blocks from the assembled layer.
+    mi::base::Handle<mi::neuraylib::ITile> tile( m_layers[layer]);
+    Tile_cache& tile_cache = Tile_cache::get_instance();
+    if( tile)
+        tile_cache.touch( this, get_layer_index( layer));
+    else
+        tile = load_tile( layer);
+
+    const mi::Uint32 bytes_per_pixel = get_bytes_per_pixel( m_pixel_type);
+    for( mi::Uint32 by = 0; by < m_nr_of_blocks_y; ++by)
+        for( mi::Uint32 bx = 0; bx < m_nr_of_blocks_x; ++bx) {
+            const mi::Uint32 index = get_block_index( bx, by, layer);
+            if( m_blocks[index])
+                continue;
+            const mi::Uint32 x = bx * BLOCK_SIZE;
+            const mi::Uint32 y = by * BLOCK_SIZE;
+            const mi::Uint32 w = std::min( BLOCK_SIZE, m_width  - x);
+            const mi::Uint32 h = std::min( BLOCK_SIZE, m_height - y);
+            m_blocks[index] = create_tile( m_pixel_type, w, h);
+            copy_region( tile.get(), x, y, m_blocks[index].get(), 0, 0, w, h, bytes_per_pixel);
+            m_uses_tile_cache = true;
+            tile_cache.insert( this, index, get_tile_size( m_blocks[index].get()));
+        }
+}
+
+mi::neuraylib::ITile* Canvas_impl::assemble_layer( mi::Uint32 layer) const
+{
+    if( m_layers[layer]) {
+        m_layers[layer]->retain();
+        return m_layers[layer].get();
+    }
+
+    // Decode the layer if any block is missing, instead of decoding it for the missing blocks and
+    // copying all blocks afterwards.
+    const mi::Uint32 first = get_block_index( 0, 0, layer);
+    const mi::Uint32 last  = first + m_nr_of_blocks_x * m_nr_of_blocks_y;
+    for( mi::Uint32 i = first; i < last; ++i)
+        if( !m_blocks[i])
+            return load_tile( layer);
+
+    const mi::Uint32 bytes_per_pixel = get_bytes_per_pixel( m_pixel_type);
+    mi::neuraylib::ITile* result = create_tile( m_pixel_type, m_width, m_height);
+    for( mi::Uint32 by = 0; by < m_nr_of_blocks_y; ++by)
+        for( mi::Uint32 bx = 0; bx < m_nr_of_blocks_x; ++bx) {
+            const mi::neuraylib::ITile* b = m_blocks[get_block_index( bx, by, layer)].get();
+            copy_region( b, 0, 0, result, bx * BLOCK_SIZE, by * BLOCK_SIZE,
+                b->get_resolution_x(), b->get_resolution_y(), bytes_per_pixel);
+        }
+
+    return result;
+}
+
+void Canvas_impl::drop_layer( mi::Uint32 layer) const
+{
+    if( !m_layers[layer])
+        return;
+
+    m_layers[layer] = nullptr;
+    Tile_cache::get_instance().erase( this, get_layer_index( layer));
+}
+
+void Canvas_impl::drop_blocks( mi::Uint32 layer) const
+{
+    Tile_cache& tile_cache = Tile_cache::get_instance();
+
+    const mi::Uint32 first = get_block_index( 0, 0, layer);
+    const mi::Uint32 last  = first + m_nr_of_blocks_x * m_nr_of_blocks_y;
+    for( mi::Uint32 i = first; i < last; ++i) {
+        if( !m_blocks[i])
+            continue;
+        m_blocks[i] = nullptr;
+        tile_cache.erase( this, i);
+    }
+}
+
+mi::Size Canvas_impl::get_tile_size( const mi::neuraylib::ITile* tile) const
+{
+    mi::base::Handle<const ITile> tile_internal( tile->get_interface<ITile>());
+    if( tile_internal)                                      // exact memory usage
+        return tile_internal->get_size();
+
+    return get_data_size( m_pixel_type, m_width, m_height); // approximate memory usage
+}
+
 mi::neuraylib::ITile* Canvas_impl::load_tile( mi::Uint32 z) const
 {
     mi::neuraylib::ITile* tile = do_load_tile( z);
@@ -653,6 +895,8 @@ mi::neuraylib::ITile* Canvas_impl::do_load_tile( mi::Uint32 z) const
         return nullptr;
     }
 
+    decompress_if_needed( tile, m_pixel_type, m_is_cubemap);
+
     const char* pixel_type = tile->get_type();
     const std::string pixel_type_str = pixel_type ? pixel_type : "(invalid)";
     if( !m_selector.empty()) {
@@ -753,6 +997,9 @@ mi::neuraylib::IReader* Canvas_impl::get_reader( std::string& log_identifier) co
 void Canvas_impl::set_default_pink_dummy_canvas()
 {
     m_tiles.clear();
+    m_blocks.clear();
+    m_layers.clear();
+    m_uses_blocks = false;
 
     m_filename.clear();
     m_archive_filename.clear();
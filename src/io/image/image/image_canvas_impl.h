@@ -69,6 +69,28 @@ public:
     /// \return   \c true on success, \c false, if the canvas does not support lazy loading and
     ///           therefore cannot simply free its data.
     virtual bool release_tiles() const = 0;
+
+    /// Returns the size of the blocks returned by #get_block(), or 0 if the pixel data of this
+    /// canvas is not split into blocks.
+    virtual mi::Uint32 get_block_size() const = 0;
+
+    /// Returns a block of a layer.
+    ///
+    /// Lazily loaded canvases keep their pixel data in blocks of #get_block_size() x
+    /// #get_block_size() pixels (smaller at the right and bottom borders), which are loaded and
+    /// released independently. Readers that need only parts of a layer, or that keep tiles for a
+    /// long time, should use blocks instead of #get_tile(), which keeps the entire layer in memory
+    /// for such canvases.
+    ///
+    /// \param block_x   The x coordinate of the block, i.e., the x coordinate of its first pixel
+    ///                  divided by #get_block_size().
+    /// \param block_y   The y coordinate of the block.
+    /// \param layer     The layer of the block.
+    /// \return          The block, or \c NULL if the layer is not split into blocks (e.g., after
+    ///                  it has been requested for modification via the non-const #get_tile()) or
+    ///                  for invalid parameters.
+    virtual const mi::neuraylib::ITile* get_block(
+        mi::Uint32 block_x, mi::Uint32 block_y, mi::Uint32 layer) const = 0;
 };
 
 /// A simple implementation of the ICanvas interface.
@@ -78,13 +100,20 @@ public:
 /// pixel type, width, height, etc.). File-based or archive-based canvases load the tile data lazily
 /// when needed. Memory-based canvases create all tiles right in the constructor.
 ///
-/// File-based or archive-based canvases could flush unused tiles if memory gets tight (not yet
-/// implemented).
+/// The pixel data of file-based or archive-based canvases is kept in blocks of #BLOCK_SIZE x
+/// #BLOCK_SIZE pixels. The blocks are managed by the process-wide Tile_cache, which releases least
+/// recently used blocks again if memory gets tight. The const #get_tile() assembles the layer once
+/// and keeps it instead of its blocks, as a single entry of the tile cache. Blocks requested later
+/// are cut from that layer as long as it is cached. The non-const #get_tile() keeps the layer as a
+/// whole outside of the tile cache, since it might get modified.
 class Canvas_impl final // constructor invokes virtual method calls
   : public mi::base::Interface_implement<ICanvas>,
     public boost::noncopyable
 {
 public:
+    /// The size of the blocks of lazily loaded canvases in pixels.
+    static constexpr mi::Uint32 BLOCK_SIZE = 256;
+
     /// Constructor.
     ///
     /// Creates a memory-based canvas with given pixel type, width, height, and layers.
@@ -206,6 +235,9 @@ public:
     Canvas_impl(
         const std::vector<mi::base::Handle<mi::neuraylib::ITile>>& tiles, mi::Float32 gamma = 0.0f);
 
+    /// Destructor.
+    ~Canvas_impl();
+
     // methods of mi::neuraylib::ICanvas_base
 
     mi::Uint32 get_resolution_x() const { return m_width; }
@@ -234,6 +266,23 @@ public:
 
     bool release_tiles() const;
 
+    mi::Uint32 get_block_size() const { return m_uses_blocks ? BLOCK_SIZE : 0; }
+
+    const mi::neuraylib::ITile* get_block(
+        mi::Uint32 block_x, mi::Uint32 block_y, mi::Uint32 layer) const;
+
+    // internal methods
+
+    /// Releases a lazily loaded block or assembled layer on behalf of the tile cache.
+    ///
+    /// Fails if the lock of the canvas is currently taken, or if the block or layer is referenced
+    /// elsewhere. Never blocks. Used by Tile_cache only.
+    ///
+    /// \param index   The index of the block to release, see #get_block_index() and
+    ///                #get_layer_index().
+    /// \return        \c true if the block or layer was released, \c false otherwise.
+    bool try_evict_block( mi::Uint32 index) const;
+
 private:
     /// Indicates whether this canvas supports lazy loading.
     bool supports_lazy_loading() const;
@@ -256,6 +305,48 @@ private:
     /// \note The caller needs to hold the lock m_lock.
      mi::neuraylib::ITile* do_load_tile( mi::Uint32 z) const;
 
+    /// Loads the missing blocks of \p layer and registers them with the tile cache.
+    ///
+    /// The blocks are cut from the assembled layer in #m_layers if present, otherwise the layer is
+    /// decoded. Other layers are not decoded.
+    ///
+    /// \note The caller needs to hold the lock m_lock.
+    void load_missing_blocks( mi::Uint32 layer) const;
+
+    /// Returns \p layer as a whole, assembled from its blocks if all of them are present, or
+    /// decoded otherwise. Takes the assembled layer from #m_layers if present.
+    ///
+    /// \note The caller needs to hold the lock m_lock.
+    mi::neuraylib::ITile* assemble_layer( mi::Uint32 layer) const;
+
+    /// Releases the blocks of \p layer and removes them from the tile cache.
+    ///
+    /// \note The caller needs to hold the lock m_lock.
+    void drop_blocks( mi::Uint32 layer) const;
+
+    /// Releases the assembled \p layer in #m_layers and removes it from the tile cache.
+    ///
+    /// \note The caller needs to hold the lock m_lock.
+    void drop_layer( mi::Uint32 layer) const;
+
+    /// Returns the index of a block in #m_blocks.
+    mi::Uint32 get_block_index( mi::Uint32 block_x, mi::Uint32 block_y, mi::Uint32 layer) const
+    { return (layer * m_nr_of_blocks_y + block_y) * m_nr_of_blocks_x + block_x; }
+
+    /// Returns the index of an assembled layer in the tile cache, which follows the indices of
+    /// all blocks.
+    mi::Uint32 get_layer_index( mi::Uint32 layer) const
+    { return static_cast<mi::Uint32>( m_blocks.size()) + layer; }
+
+    /// Sets up #m_blocks for lazy loading.
+    ///
+    /// Canvases with a block-compressed pixel type do not use blocks. Their layers are loaded as a
+    /// whole into #m_tiles.
+    void init_blocks();
+
+    /// Returns the memory used by the given tile in bytes.
+    mi::Size get_tile_size( const mi::neuraylib::ITile* tile) const;
+
     /// Returns the reader used by #load_tile();
     mi::neuraylib::IReader* get_reader( std::string& log_identifier) const;
 
@@ -279,15 +370,43 @@ private:
 
     /// The tiles of this canvas.
     ///
-    /// Might contain \c NULL pointers for not yet loaded tiles for file-based canvases. Never
-    /// contains \c NULL pointers for memory-based canvases.
+    /// Contains \c NULL pointers for layers kept in blocks or not yet loaded in lazily loaded
+    /// canvases. Never contains \c NULL pointers for memory-based canvases.
     ///
     /// \note Any access needs to be protected by m_lock.
     mutable std::vector<mi::base::Handle<mi::neuraylib::ITile>> m_tiles;
 
-    /// The lock that protects m_tiles;
+    /// The blocks of lazily loaded canvases, see #get_block_index().
+    ///
+    /// Contains \c NULL pointers for not yet loaded or evicted blocks, and for all blocks of
+    /// layers in #m_tiles.
+    ///
+    /// \note Any access needs to be protected by m_lock.
+    mutable std::vector<mi::base::Handle<mi::neuraylib::ITile>> m_blocks;
+
+    /// The layers of lazily loaded canvases assembled for the const #get_tile().
+    ///
+    /// Managed by the tile cache like blocks, see #get_layer_index(). Contains \c NULL pointers
+    /// for layers that have not been requested as a whole, or that have been evicted.
+    ///
+    /// \note Any access needs to be protected by m_lock.
+    mutable std::vector<mi::base::Handle<mi::neuraylib::ITile>> m_layers;
+
+    /// Indicates whether this canvas loads its pixel data lazily into #m_blocks.
+    bool m_uses_blocks = false;
+    /// The number of blocks in x direction.
+    mi::Uint32 m_nr_of_blocks_x = 0;
+    /// The number of blocks in y direction.
+    mi::Uint32 m_nr_of_blocks_y = 0;
+
+    /// The lock that protects m_tiles, m_blocks, and m_layers.
     mutable mi::base::Lock m_lock;
 
+    /// Indicates whether tiles of this canvas have been registered with the tile cache.
+    ///
+    /// \note Any access needs to be protected by m_lock (except in the destructor).
+    mutable bool m_uses_tile_cache = false;
+
     /// The file used to load this canvas.
     ///
     /// Non-empty for file-based canvases, empty for memory-based canvases (including archives).
@@ -0,0 +1,387 @@
+/***************************************************************************************************
+ * Copyright (c) 2012-2022, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************************************/
+
+#include "pch.h"
+
+#include "image_mipmap_filter.h"
+
+#include <mi/math/function.h>
+#include <mi/neuraylib/itile.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <base/lib/log/i_log_assert.h>
+
+#include "i_image_quantization.h"
+
+#if defined(HAS_SSE) || defined(SSE_INTRINSICS)
+#ifdef MI_ARCH_X86_64
+#include <xmmintrin.h>
+#elif defined(MI_ARCH_ARM_64)
+#define SIMDE_ENABLE_NATIVE_ALIASES
+#include <base/lib/simde/x86/sse2.h>
+#endif
+#endif
+
+namespace MI {
+
+namespace IMAGE {
+
+namespace {
+
+/// Lookup tables for the conversion of quantized components between gamma and linear space.
+///
+/// The decode tables map each quantized value to its linear value. The encode tables contain for
+/// each quantized value k the smallest linear value that is quantized to k, i.e., a binary search
+/// yields the same result as quantize_unsigned() applied to the gamma-corrected value.
+class Gamma_tables
+{
+public:
+    explicit Gamma_tables( mi::Float32 gamma) : m_gamma( gamma)
+    {
+        build( 8, m_decode_8, m_encode_8);
+    }
+
+    mi::Float32 get_gamma() const { return m_gamma; }
+
+    const mi::Float32* get_decode_8() const { return m_decode_8.data(); }
+    const mi::Float32* get_encode_8() const { return m_encode_8.data(); }
+
+    /// The 16-bit tables are only built on first use.
+    const mi::Float32* get_decode_16() const
+    {
+        std::call_once( m_once_16, [this]() { build( 16, m_decode_16, m_encode_16); });
+        return m_decode_16.data();
+    }
+
+    const mi::Float32* get_encode_16() const
+    {
+        get_decode_16();
+        return m_encode_16.data();
+    }
+
+private:
+    void build(
+        mi::Uint32 bits, std::vector<mi::Float32>& decode, std::vector<mi::Float32>& encode) const
+    {
+        const mi::Uint32 n = 1u << bits;
+        decode.resize( n);
+        encode.resize( n);
+        const double max_value = n - 1;
+        for( mi::Uint32 k = 0; k < n; ++k) {
+            decode[k] = static_cast<mi::Float32>( std::pow( k / max_value, double( m_gamma)));
+            encode[k] = static_cast<mi::Float32>( std::pow( k / double( n), double( m_gamma)));
+        }
+    }
+
+    mi::Float32 m_gamma;
+    std::vector<mi::Float32> m_decode_8;
+    std::vector<mi::Float32> m_encode_8;
+    mutable std::once_flag m_once_16;
+    mutable std::vector<mi::Float32> m_decode_16;
+    mutable std::vector<mi::Float32> m_encode_16;
+};
+
+/// Returns the lookup tables for the given gamma value.
+///
+/// Keeps the tables for the most recently used gamma values, since typically only very few
+/// distinct values occur.
+std::shared_ptr<const Gamma_tables> get_gamma_tables( mi::Float32 gamma)
+{
+    static std::mutex s_mutex;
+    static std::vector<std::shared_ptr<const Gamma_tables>> s_tables;
+    const size_t max_tables = 4;
+
+    std::lock_guard<std::mutex> lock( s_mutex);
+    for( size_t i = 0; i < s_tables.size(); ++i)
+        if( s_tables[i]->get_gamma() == gamma) {
+            std::shared_ptr<const Gamma_tables> result = s_tables[i];
+            s_tables.erase( s_tables.begin() + i);
+            s_tables.push_back( result);
+            return result;
+        }
+
+    if( s_tables.size() == max_tables)
+        s_tables.erase( s_tables.begin());
+    s_tables.push_back( std::make_shared<const Gamma_tables>( gamma));
+    return s_tables.back();
+}
+
+/// Returns the largest k such that encode[k] <= value, where encode has 2^bits entries.
+template <mi::Uint32 bits>
+inline mi::Uint32 encode_with_table( const mi::Float32* encode, mi::Float32 value)
+{
+    mi::Uint32 k = 0;
+    for( mi::Uint32 step = 1u << (bits-1); step > 0; step >>= 1)
+        if( encode[k+step] <= value)
+            k += step;
+    return k;
+}
+
+/// Converts quantized 8-bit or 16-bit components to/from linear floats via the lookup tables.
+template <typename T, mi::Uint32 bits>
+struct Table_codec
+{
+    const mi::Float32* m_decode;
+    const mi::Float32* m_encode;
+
+    mi::Float32 decode( T value) const { return m_decode[value]; }
+    T encode( mi::Float32 value) const { return T( encode_with_table<bits>( m_encode, value)); }
+};
+
+/// Converts quantized 8-bit or 16-bit components to/from floats for gamma 1.0.
+template <typename T>
+struct Linear_codec
+{
+    mi::Float32 decode( T value) const
+    {
+        return mi::Float32( value) * mi::Float32( 1.0 / std::numeric_limits<T>::max());
+    }
+
+    T encode( mi::Float32 value) const { return quantize_unsigned<T>( std::max( value, 0.0f)); }
+};
+
+/// Converts float components to/from linear space for gamma values different from 1.0.
+struct Float_gamma_codec
+{
+    mi::Float32 m_gamma;
+    mi::Float32 m_inv_gamma;
+
+    mi::Float32 decode( mi::Float32 value) const { return mi::math::fast_pow( value, m_gamma); }
+    mi::Float32 encode( mi::Float32 value) const { return mi::math::fast_pow( value, m_inv_gamma); }
+};
+
+/// Computes rows [row_begin,row_end) of \p dest from \p src with a 2x2 box filter.
+///
+/// \p C is the number of components per pixel. Degenerate source dimensions (resolution 1) are
+/// handled by using the same pixel twice, such that the weights are always 1/4.
+template <typename T, int C, typename Codec>
+void filter_rows(
+    const Codec& codec,
+    const T* src,
+    mi::Uint32 src_width,
+    mi::Uint32 src_height,
+    T* dest,
+    mi::Uint32 dest_width,
+    mi::Uint32 row_begin,
+    mi::Uint32 row_end)
+{
+    const size_t src_stride = size_t( src_width) * C;
+    const size_t dx = src_width  > 1 ? C : 0;
+    const size_t dy = src_height > 1 ? src_stride : 0;
+
+    for( mi::Uint32 y = row_begin; y < row_end; ++y) {
+        const T* row0 = src + 2 * size_t( y) * src_stride;
+        const T* row1 = row0 + dy;
+        T* out = dest + size_t( y) * dest_width * C;
+        for( mi::Uint32 x = 0; x < dest_width; ++x) {
+            const T* p0 = row0 + 2 * size_t( x) * C;
+            const T* p1 = row1 + 2 * size_t( x) * C;
+            for( int c = 0; c < C; ++c) {
+                const mi::Float32 sum
+                    = codec.decode( p0[c]) + codec.decode( p0[dx+c])
+                    + codec.decode( p1[c]) + codec.decode( p1[dx+c]);
+                out[x*C+c] = codec.encode( sum * 0.25f);
+            }
+        }
+    }
+}
+
+/// Computes rows [row_begin,row_end) of \p dest from \p src with a 2x2 box filter for float
+/// components and gamma 1.0.
+template <int C>
+void filter_rows_float(
+    const mi::Float32* src,
+    mi::Uint32 src_width,
+    mi::Uint32 src_height,
+    mi::Float32* dest,
+    mi::Uint32 dest_width,
+    mi::Uint32 row_begin,
+    mi::Uint32 row_end)
+{
+    const size_t src_stride = size_t( src_width) * C;
+    const size_t dx = src_width  > 1 ? C : 0;
+    const size_t dy = src_height > 1 ? src_stride : 0;
+
+    for( mi::Uint32 y = row_begin; y < row_end; ++y) {
+        const mi::Float32* row0 = src + 2 * size_t( y) * src_stride;
+        const mi::Float32* row1 = row0 + dy;
+        mi::Float32* out = dest + size_t( y) * dest_width * C;
+        mi::Uint32 x = 0;
+#if defined(HAS_SSE) || defined(SSE_INTRINSICS)
+        if( C == 4) {
+            const __m128 quarter = _mm_set1_ps( 0.25f);
+            for( ; x < dest_width; ++x) {
+                const mi::Float32* p0 = row0 + 2 * size_t( x) * 4;
+                const mi::Float32* p1 = row1 + 2 * size_t( x) * 4;
+                const __m128 sum = _mm_add_ps(
+                    _mm_add_ps( _mm_loadu_ps( p0), _mm_loadu_ps( p0 + dx)),
+                    _mm_add_ps( _mm_loadu_ps( p1), _mm_loadu_ps( p1 + dx)));
+                _mm_storeu_ps( out + 4 * size_t( x), _mm_mul_ps( sum, quarter));
+            }
+        }
+#endif
+        for( ; x < dest_width; ++x) {
+            const mi::Float32* p0 = row0 + 2 * size_t( x) * C;
+            const mi::Float32* p1 = row1 + 2 * size_t( x) * C;
+            for( int c = 0; c < C; ++c)
+                out[x*C+c] = (p0[c] + p0[dx+c] + p1[c] + p1[dx+c]) * 0.25f;
+        }
+    }
+}
+
+/// Dispatches 8-bit and 16-bit pixel types to the table-driven or linear kernel.
+template <typename T, int C>
+void filter_rows_quantized(
+    mi::Float32 gamma,
+    const mi::neuraylib::ITile* src,
+    mi::neuraylib::ITile* dest,
+    mi::Uint32 row_begin,
+    mi::Uint32 row_end)
+{
+    const T* src_data  = static_cast<const T*>( src->get_data());
+    T* dest_data = static_cast<T*>( dest->get_data());
+    const mi::Uint32 src_width  = src->get_resolution_x();
+    const mi::Uint32 src_height = src->get_resolution_y();
+    const mi::Uint32 dest_width = dest->get_resolution_x();
+
+    if( gamma == 1.0f) {
+        filter_rows<T, C>( Linear_codec<T>(), src_data, src_width, src_height,
+            dest_data, dest_width, row_begin, row_end);
+        return;
+    }
+
+    const std::shared_ptr<const Gamma_tables> tables = get_gamma_tables( gamma);
+    if( sizeof( T) == 1) {
+        const Table_codec<T, 8> codec = { tables->get_decode_8(), tables->get_encode_8() };
+        filter_rows<T, C>( codec, src_data, src_width, src_height,
+            dest_data, dest_width, row_begin, row_end);
+    } else {
+        const Table_codec<T, 16> codec = { tables->get_decode_16(), tables->get_encode_16() };
+        filter_rows<T, C>( codec, src_data, src_width, src_height,
+            dest_data, dest_width, row_begin, row_end);
+    }
+}
+
+/// Dispatches float pixel types to the plain or gamma-correcting kernel.
+template <int C>
+void filter_rows_float(
+    mi::Float32 gamma,
+    const mi::neuraylib::ITile* src,
+    mi::neuraylib::ITile* dest,
+    mi::Uint32 row_begin,
+    mi::Uint32 row_end)
+{
+    const mi::Float32* src_data  = static_cast<const mi::Float32*>( src->get_data());
+    mi::Float32* dest_data = static_cast<mi::Float32*>( dest->get_data());
+    const mi::Uint32 src_width  = src->get_resolution_x();
+    const mi::Uint32 src_height = src->get_resolution_y();
+    const mi::Uint32 dest_width = dest->get_resolution_x();
+
+    if( gamma == 1.0f) {
+        filter_rows_float<C>( src_data, src_width, src_height,
+            dest_data, dest_width, row_begin, row_end);
+        return;
+    }
+
+    const Float_gamma_codec codec = { gamma, 1.0f / gamma };
+    filter_rows<mi::Float32, C>( codec, src_data, src_width, src_height,
+        dest_data, dest_width, row_begin, row_end);
+}
+
+} // namespace
+
+bool is_box_filter_supported( Pixel_type pixel_type)
+{
+    return    pixel_type != PT_UNDEF && pixel_type != PT_RGBE && pixel_type != PT_RGBEA
+           && !is_compressed_pixel_type( pixel_type);
+}
+
+void box_filter_rows(
+    Pixel_type pixel_type,
+    mi::Float32 gamma,
+    const mi::neuraylib::ITile* src,
+    mi::neuraylib::ITile* dest,
+    mi::Uint32 row_begin,
+    mi::Uint32 row_end)
+{
+    ASSERT( M_IMAGE, is_box_filter_supported( pixel_type));
+    ASSERT( M_IMAGE, dest->get_resolution_x() == std::max( src->get_resolution_x() / 2, 1u));
+    ASSERT( M_IMAGE, dest->get_resolution_y() == std::max( src->get_resolution_y() / 2, 1u));
+    ASSERT( M_IMAGE, row_end <= dest->get_resolution_y());
+
+    switch( pixel_type) {
+        // PT_SINT8 actually means 8-bit unsigned, PT_SINT32 is treated as PT_RGBA
+        case PT_SINT8:
+            filter_rows_quantized<mi::Uint8, 1>( gamma, src, dest, row_begin, row_end); return;
+        case PT_RGB:
+            filter_rows_quantized<mi::Uint8, 3>( gamma, src, dest, row_begin, row_end); return;
+        case PT_SINT32:
+        case PT_RGBA:
+            filter_rows_quantized<mi::Uint8, 4>( gamma, src, dest, row_begin, row_end); return;
+        case PT_RGB_16:
+            filter_rows_quantized<mi::Uint16, 3>( gamma, src, dest, row_begin, row_end); return;
+        case PT_RGBA_16:
+            filter_rows_quantized<mi::Uint16, 4>( gamma, src, dest, row_begin, row_end); return;
+        case PT_FLOAT32:
+            filter_rows_float<1>( gamma, src, dest, row_begin, row_end); return;
+        case PT_FLOAT32_2:
+            filter_rows_float<2>( gamma, src, dest, row_begin, row_end); return;
+        case PT_FLOAT32_3:
+        case PT_RGB_FP:
+            filter_rows_float<3>( gamma, src, dest, row_begin, row_end); return;
+        case PT_FLOAT32_4:
+        case PT_COLOR:
+            filter_rows_float<4>( gamma, src, dest, row_begin, row_end); return;
+        case PT_RGBE:
+        case PT_RGBEA:
+        case PT_BC1:
+        case PT_BC2:
+        case PT_BC3:
+        case PT_BC4:
+        case PT_BC4S:
+        case PT_BC5:
+        case PT_BC5S:
+        case PT_BC6H:
+        case PT_BC6HS:
+        case PT_BC7:
+        case PT_UNDEF:
+            break;
+    }
+
+    ASSERT( M_IMAGE, false);
+}
+
+} // namespace IMAGE
+
+} // namespace MI
@@ -0,0 +1,74 @@
+/***************************************************************************************************
+ * Copyright (c) 2012-2022, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************************************/
+
+#ifndef IO_IMAGE_IMAGE_IMAGE_MIPMAP_FILTER_H
+#define IO_IMAGE_IMAGE_IMAGE_MIPMAP_FILTER_H
+
+#include <mi/base/types.h>
+
+#include "i_image_utilities.h"
+
+namespace mi { namespace neuraylib { class ITile; } }
+
+namespace MI {
+
+namespace IMAGE {
+
+/// Indicates whether #box_filter_rows() supports the given pixel type.
+///
+/// All pixel types are supported, except for the shared-exponent types PT_RGBE and PT_RGBEA and the
+/// block-compressed pixel types.
+bool is_box_filter_supported( Pixel_type pixel_type);
+
+/// Computes rows of the next miplevel from a tile of the previous miplevel.
+///
+/// Each pixel of \p dest is the average of the corresponding 2x2 pixels of \p src. The average is
+/// computed in linear space, i.e., components are raised to the power of \p gamma before and to
+/// the power of 1/gamma after averaging. The typed kernels operate directly on the pixel data of
+/// the tiles. Disjoint row ranges of the same tile can be computed concurrently.
+///
+/// \param pixel_type   The pixel type of both tiles. See #is_box_filter_supported().
+/// \param gamma        The gamma value of the tiles.
+/// \param src          The tile of the previous miplevel.
+/// \param dest         The tile of the next miplevel. Its resolution is half of the resolution of
+///                     \p src (rounded down, but at least 1).
+/// \param row_begin    The first row of \p dest to compute.
+/// \param row_end      The row of \p dest after the last row to compute.
+void box_filter_rows(
+    Pixel_type pixel_type,
+    mi::Float32 gamma,
+    const mi::neuraylib::ITile* src,
+    mi::neuraylib::ITile* dest,
+    mi::Uint32 row_begin,
+    mi::Uint32 row_end);
+
+} // namespace IMAGE
+
+} // namespace MI
+
+#endif // IO_IMAGE_IMAGE_IMAGE_MIPMAP_FILTER_H
@@ -367,17 +367,8 @@ const mi::neuraylib::ICanvas* Mipmap_impl::get_level( mi::Uint32 level) const
     if( level >= m_nr_of_levels)
         return nullptr;
 
-    SYSTEM::Access_module<Image_module> image_module(false);
     mi::base::Lock::Block block( &m_lock);
-
-    // create miplevels if needed
-    for( mi::Uint32 i = m_last_created_level+1; i <= level; ++i) {
-
-        m_levels[i] = mi::base::make_handle(image_module->create_miplevel(
-            m_levels[i-1].get(), m_levels[i-1]->get_gamma()));
-
-        m_last_created_level = i;
-    }
+    create_levels( level, block);
 
     ASSERT( M_IMAGE, m_last_created_level >= level);
     ASSERT( M_IMAGE, m_levels[level]);
@@ -390,18 +381,8 @@ mi::neuraylib::ICanvas* Mipmap_impl::get_level( mi::Uint32 level) //-V659 PVS
     if( level >= m_nr_of_levels)
         return nullptr;
 
-    SYSTEM::Access_module<Image_module> image_module(false);
     mi::base::Lock::Block block( &m_lock);
-
-    // create miplevels if needed
-    for( mi::Uint32 i = m_last_created_level+1; i <= level; ++i) {
-
-        m_levels[i] = mi::base::make_handle(image_module->create_miplevel(
-            m_levels[i - 1].get(), m_levels[i - 1]->get_gamma()));
-
-        m_last_created_level = i;
-    }
-    ASSERT( M_IMAGE, m_last_created_level >= level);
+    create_levels( level, block);
 
     // destroy higher levels if needed
     const mi::Uint32 first_level_to_destroy = std::max( level+1, m_nr_of_provided_levels);
@@ -415,6 +396,37 @@ mi::neuraylib::ICanvas* Mipmap_impl::get_level( mi::Uint32 level) //-V659 PVS
     return m_levels[level].get();
 }
 
+void Mipmap_impl::create_levels( mi::Uint32 level, mi::base::Lock::Block& block) const
+{
+    // create miplevels if needed, all missing ones at once
+    while( level > m_last_created_level) {
+
+        const mi::Uint32 base_level = m_last_created_level;
+        mi::base::Handle<const mi::neuraylib::ICanvas> base_canvas(
+            make_handle_dup( m_levels[base_level].get()));
+
+        // create_miplevels() waits for jobs of the shared thread pool. A worker thread waiting
+        // for them runs other jobs which might access this mipmap, so do not hold the lock.
+        block.release();
+        std::vector<mi::base::Handle<mi::neuraylib::ICanvas> > levels;
+        SYSTEM::Access_module<Image_module> image_module( false);
+        image_module->create_miplevels(
+            base_canvas.get(), base_canvas->get_gamma(), level - base_level, levels);
+        block.set( &m_lock);
+
+        // The base level was destroyed in the meantime, start over.
+        if( m_last_created_level < base_level)
+            continue;
+
+        // Publish the levels which were not created by another thread in the meantime.
+        for( mi::Uint32 i = m_last_created_level+1; i <= level; ++i)
+            m_levels[i] = levels[i-base_level-1];
+        m_last_created_level = std::max( m_last_created_level, level);
+    }
+
+    ASSERT( M_IMAGE, m_last_created_level >= level);
+}
+
 mi::Size Mipmap_impl::get_size() const
 {
     mi::Size size = sizeof( *this);
@@ -432,7 +444,7 @@ mi::Size Mipmap_impl::get_size() const
             const mi::Size height = m_levels[i]->get_resolution_y();
             const Pixel_type pixel_type
                 = convert_pixel_type_string_to_enum( m_levels[i]->get_type());
-            size += width * height * get_bytes_per_pixel( pixel_type);
+            size += get_data_size( pixel_type, width, height);
         }
     }
 
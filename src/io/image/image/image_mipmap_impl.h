@@ -193,6 +193,13 @@ public:
 
 private:
 
+    /// Creates the miplevels up to \p level, if not yet done.
+    ///
+    /// \param level   The highest miplevel to create.
+    /// \param block   Holds #m_lock on entry and on return. The lock is released while the
+    ///                miplevels are computed.
+    void create_levels( mi::Uint32 level, mi::base::Lock::Block& block) const;
+
     /// The number of miplevels of this mipmap.
     ///
     /// The number of miplevels is determined from the width and height of the base level. The last
@@ -50,12 +50,16 @@
 #include <base/hal/disk/disk_memory_reader_writer_impl.h>
 #include <base/hal/hal/i_hal_ospath.h>
 #include <base/data/serial/i_serializer.h>
+#include <base/data/thread_pool/i_thread_pool.h>
 
 #include "i_image_pixel_conversion.h"
 #include "i_image_utilities.h"
+#include "image_block_compression.h"
 #include "image_canvas_impl.h"
 #include "image_image_api_impl.h"
+#include "image_mipmap_filter.h"
 #include "image_mipmap_impl.h"
+#include "image_tile_cache.h"
 #include "image_tile_impl.h"
 
 
@@ -86,6 +90,9 @@ bool Image_module_impl::init()
 {
     m_plug_module.set();
 
+    // Worker threads are only started when the first job is submitted to the shared pool.
+    m_thread_pool = THREAD_POOL::get_shared_thread_pool();
+
     mi::base::Handle<mi::neuraylib::IPlugin_api> plugin_api( m_plug_module->get_plugin_api());
 
     // If no plugin API has been registered, e.g., in some unit tests, then we provide our own
@@ -142,6 +149,7 @@ void Image_module_impl::exit()
     }
     m_plugins.clear();
 
+    m_thread_pool.reset();
     m_plug_module.reset();
 }
 
@@ -240,14 +248,7 @@ void Image_module_impl::create_mipmaps(
         return;
 
     const mi::Uint32 nr_of_levels = mi::math::log2_int(std::min(w, h));
-    mipmaps.resize(nr_of_levels);
-
-    const mi::neuraylib::ICanvas* prev_canvas = base_canvas;
-    for (mi::Size i = 0; i < nr_of_levels; ++i)
-    {
-        mipmaps[i] = mi::base::make_handle(create_miplevel(prev_canvas, gamma));
-        prev_canvas = mipmaps[i].get();
-    }
+    create_miplevels(base_canvas, gamma, nr_of_levels, mipmaps);
 }
 
 IMipmap* Image_module_impl::create_dummy_mipmap()
@@ -382,8 +383,7 @@ mi::neuraylib::ICanvas* Image_module_impl::copy_canvas( const mi::neuraylib::ICa
     if (!canvas)
         return nullptr;
 
-    const mi::Uint32 bytes_per_pixel = get_bytes_per_pixel( pixel_type);
-    const mi::Size count = static_cast<mi::Size>( canvas_width) * canvas_height * bytes_per_pixel;
+    const mi::Size count = get_data_size( pixel_type, canvas_width, canvas_height);
 
     for( mi::Uint32 z = 0; z < nr_of_layers; ++z) {
         mi::base::Handle<const mi::neuraylib::ITile> other_tile( other->get_tile( z));
@@ -406,8 +406,7 @@ mi::neuraylib::ITile* Image_module_impl::copy_tile( const mi::neuraylib::ITile*
 
     mi::neuraylib::ITile* tile = create_tile( pixel_type, width, height);
 
-    const mi::Uint32 bytes_per_pixel = get_bytes_per_pixel( pixel_type);
-    const mi::Size count = static_cast<mi::Size>( width) * height * bytes_per_pixel;
+    const mi::Size count = get_data_size( pixel_type, width, height);
     const void* const other_tile_data = other->get_data();
     void* const tile_data = tile->get_data();
     memcpy( tile_data, other_tile_data, count);
@@ -478,8 +477,7 @@ mi::Sint32 Image_module_impl::copy_tile_data(
         || dest_height     != source_height)
         return -1;
 
-    const mi::Uint32 bytes_per_pixel = get_bytes_per_pixel( source_pixel_type);
-    const mi::Size count = static_cast<mi::Size>( source_width) * source_height * bytes_per_pixel;
+    const mi::Size count = get_data_size( source_pixel_type, source_width, source_height);
 
     const void* const source_data = source->get_data();
     void* const dest_data         = dest->get_data();
@@ -519,6 +517,10 @@ mi::neuraylib::ICanvas* Image_module_impl::convert_canvas(
     if( old_pixel_type == new_pixel_type)
         return copy_canvas( old_canvas); // faster than the code below
 
+    // Encoding into block-compressed pixel types is not supported.
+    if( is_compressed_pixel_type( new_pixel_type))
+        return nullptr;
+
     const mi::Uint32 canvas_width  = old_canvas->get_resolution_x();
     const mi::Uint32 canvas_height = old_canvas->get_resolution_y();
     const mi::Uint32 nr_of_layers  = old_canvas->get_layers_size();
@@ -529,12 +531,18 @@ mi::neuraylib::ICanvas* Image_module_impl::convert_canvas(
     mi::neuraylib::ICanvas* new_canvas = new Canvas_impl( new_pixel_type,
         canvas_width, canvas_height, nr_of_layers, is_cubemap, gamma);
 
+    // Block-compressed layers are decoded first and then converted from the decompressed type.
+    const bool is_compressed = is_compressed_pixel_type( old_pixel_type);
+    const Pixel_type source_pixel_type = get_decompressed_pixel_type( old_pixel_type);
+
     for( mi::Uint32 z = 0; z < nr_of_layers; ++z) {
         mi::base::Handle<const mi::neuraylib::ITile> old_tile( old_canvas->get_tile( z));
+        if( is_compressed)
+            old_tile = decompress_tile( old_tile.get(), !is_cubemap);
         mi::base::Handle<mi::neuraylib::ITile> new_tile( new_canvas->get_tile( z));
         const void* const old_data = old_tile->get_data();
         void* const new_data = new_tile->get_data();
-        convert( old_data, new_data, old_pixel_type, new_pixel_type, nr_of_pixels);
+        convert( old_data, new_data, source_pixel_type, new_pixel_type, nr_of_pixels);
     }
 
     return new_canvas;
@@ -553,6 +561,10 @@ mi::neuraylib::ITile* Image_module_impl::convert_tile(
     if( old_pixel_type == new_pixel_type)
         return copy_tile( old_tile); // faster than the code below
 
+    // Encoding into block-compressed pixel types is not supported.
+    if( is_compressed_pixel_type( new_pixel_type))
+        return nullptr;
+
     const mi::Uint32 tile_width   = old_tile->get_resolution_x();
     const mi::Uint32 tile_height  = old_tile->get_resolution_y();
     const mi::Size   nr_of_pixels = tile_width * tile_height;
@@ -561,9 +573,15 @@ mi::neuraylib::ITile* Image_module_impl::convert_tile(
     if( !new_tile)
         return nullptr;
 
-    const void* const old_data = old_tile->get_data();
+    // Block-compressed tiles are decoded first and then converted from the decompressed type.
+    mi::base::Handle<const mi::neuraylib::ITile> source_tile( old_tile, mi::base::DUP_INTERFACE);
+    if( is_compressed_pixel_type( old_pixel_type))
+        source_tile = decompress_tile( old_tile, /*flip*/ true);
+
+    const void* const old_data = source_tile->get_data();
     void* const new_data = new_tile->get_data();
-    convert( old_data, new_data, old_pixel_type, new_pixel_type, nr_of_pixels);
+    convert( old_data, new_data, get_decompressed_pixel_type( old_pixel_type), new_pixel_type,
+        nr_of_pixels);
 
     return new_tile;
 }
@@ -621,6 +639,14 @@ void Image_module_impl::adjust_gamma(
             }
             break;
         }
+        case PT_BC1:    case PT_BC2:    case PT_BC3:
+        case PT_BC4:    case PT_BC4S:   case PT_BC5:
+        case PT_BC5S:   case PT_BC6H:   case PT_BC6HS:
+        case PT_BC7:
+            LOG::mod_log->warning(M_IMAGE, LOG::Mod_log::C_IO,
+                "Adjusting gamma is not supported for the block-compressed pixel type \"%s\".",
+                canvas->get_type());
+            return;
         case PT_UNDEF:
             return;
     }
@@ -664,7 +690,11 @@ mi::neuraylib::ICanvas* Image_module_impl::extract_channel(
         return nullptr;
 
     mi::base::Handle<mi::neuraylib::ICanvas> tmp_canvas;
-    if( old_pixel_type == PT_RGBE || old_pixel_type == PT_RGB_16) {
+    if( is_compressed_pixel_type( old_pixel_type)) {
+        old_pixel_type = get_decompressed_pixel_type( old_pixel_type);
+        tmp_canvas = convert_canvas( old_canvas, old_pixel_type);
+        old_canvas = tmp_canvas.get();
+    } else if( old_pixel_type == PT_RGBE || old_pixel_type == PT_RGB_16) {
         tmp_canvas = convert_canvas( old_canvas, PT_RGB_FP);
         old_canvas = tmp_canvas.get();
         old_pixel_type = PT_RGB_FP;
@@ -709,7 +739,11 @@ mi::neuraylib::ITile* Image_module_impl::extract_channel(
         return nullptr;
 
     mi::base::Handle<mi::neuraylib::ITile> tmp_tile;
-    if( old_pixel_type == PT_RGBE || old_pixel_type == PT_RGB_16) {
+    if( is_compressed_pixel_type( old_pixel_type)) {
+        old_pixel_type = get_decompressed_pixel_type( old_pixel_type);
+        tmp_tile = convert_tile( old_tile, old_pixel_type);
+        old_tile = tmp_tile.get();
+    } else if( old_pixel_type == PT_RGBE || old_pixel_type == PT_RGB_16) {
         tmp_tile = convert_tile( old_tile, PT_RGB_FP);
         old_tile = tmp_tile.get();
         old_pixel_type = PT_RGB_FP;
@@ -782,8 +816,7 @@ void Image_module_impl::serialize_canvas(
     serializer->write( is_cubemap);
     serializer->write( gamma);
 
-    const mi::Uint32 bytes_per_pixel = get_bytes_per_pixel( pixel_type);
-    const mi::Size count = static_cast<mi::Size>( canvas_width) * canvas_height * bytes_per_pixel;
+    const mi::Size count = get_data_size( pixel_type, canvas_width, canvas_height);
 
     for( mi::Uint32 z = 0; z < nr_of_layers; ++z) {
         mi::base::Handle<const mi::neuraylib::ITile> tile( canvas->get_tile( z));
@@ -813,8 +846,7 @@ mi::neuraylib::ICanvas* Image_module_impl::deserialize_canvas(
     mi::neuraylib::ICanvas* canvas = create_canvas( pixel_type,
         canvas_width, canvas_height, nr_of_layers, is_cubemap, gamma);
 
-    const mi::Uint32 bytes_per_pixel = get_bytes_per_pixel( pixel_type);
-    const mi::Size count = static_cast<mi::Size>( canvas_width) * canvas_height * bytes_per_pixel;
+    const mi::Size count = get_data_size( pixel_type, canvas_width, canvas_height);
 
     for( mi::Uint32 z = 0; z < nr_of_layers; ++z) {
         mi::base::Handle<mi::neuraylib::ITile> tile( canvas->get_tile( z));
@@ -836,8 +868,7 @@ void Image_module_impl::serialize_tile(
     serializer->write( width);
     serializer->write( height);
 
-    const mi::Uint32 bytes_per_pixel = get_bytes_per_pixel( pixel_type);
-    const mi::Size count = static_cast<mi::Size>( width) * height * bytes_per_pixel;
+    const mi::Size count = get_data_size( pixel_type, width, height);
     const void* const tile_data = tile->get_data();
     serializer->write( static_cast<const char*>( tile_data), count);
 }
@@ -856,8 +887,7 @@ mi::neuraylib::ITile* Image_module_impl::deserialize_tile(
 
     mi::neuraylib::ITile* tile = create_tile( pixel_type, width, height);
 
-    const mi::Uint32 bytes_per_pixel = get_bytes_per_pixel( pixel_type);
-    const mi::Size count = static_cast<mi::Size>( width) * height * bytes_per_pixel;
+    const mi::Size count = get_data_size( pixel_type, width, height);
     void* const tile_data = tile->get_data();
     deserializer->read( static_cast<char*>( tile_data), count);
 
@@ -898,15 +928,24 @@ bool Image_module_impl::export_canvas(
     const Pixel_type export_pixel_type_enum = convert_pixel_type_string_to_enum( export_pixel_type);
     const mi::Float32 export_default_gamma = get_default_gamma( export_pixel_type_enum);
 
+    // Block-compressed data is passed through unchanged if the plugin supports its pixel type,
+    // and decoded otherwise.
+    const bool pass_through = is_compressed_pixel_type( export_pixel_type_enum);
+    const Pixel_type canvas_pixel_type_enum = convert_pixel_type_string_to_enum( canvas_pixel_type);
+    if( !pass_through && is_compressed_pixel_type( canvas_pixel_type_enum))
+        canvas = convert_canvas(
+            canvas.get(), get_decompressed_pixel_type( canvas_pixel_type_enum));
+
     // If enabled and necessary, adjust gamma to export_default_gamma
-    if( force_default_gamma && fabs( canvas->get_gamma() - export_default_gamma) > 0.001) {
+    if(    force_default_gamma && !pass_through
+        && fabs( canvas->get_gamma() - export_default_gamma) > 0.001) {
         mi::base::Handle<mi::neuraylib::ICanvas> tmp( copy_canvas( canvas.get()));
         adjust_gamma( tmp.get(), export_default_gamma);
         canvas = tmp;
     }
 
     // If necessary, convert canvas to export_pixel_type
-    if( strcmp( canvas_pixel_type, export_pixel_type) != 0) {
+    if( strcmp( canvas->get_type(), export_pixel_type) != 0) {
         canvas = convert_canvas( canvas.get(), export_pixel_type_enum);
         ASSERT( M_IMAGE, canvas);
     }
@@ -985,6 +1024,10 @@ bool Image_module_impl::export_mipmap(
     const Pixel_type export_pixel_type_enum = convert_pixel_type_string_to_enum( export_pixel_type);
     const mi::Float32 export_default_gamma = get_default_gamma( export_pixel_type_enum);
 
+    // Block-compressed data is passed through unchanged if the plugin supports its pixel type,
+    // and decoded otherwise.
+    const bool pass_through = is_compressed_pixel_type( export_pixel_type_enum);
+
     DISK::File_writer_impl writer;
     if( !writer.open( output_filename)) {
         LOG::mod_log->error( M_IMAGE, LOG::Mod_log::C_IO,
@@ -999,6 +1042,16 @@ bool Image_module_impl::export_mipmap(
     const mi::Float32 gamma        = canvas->get_gamma();
     const bool is_cubemap          = get_canvas_is_cubemap( canvas.get());
 
+    // Only the leading levels that share the block-compressed pixel type can be passed through.
+    if( pass_through)
+        for( mi::Uint32 l = 1; l < nr_of_levels; ++l) {
+            mi::base::Handle<const mi::neuraylib::ICanvas> canvas_l( mipmap->get_level( l));
+            if( !canvas_l || strcmp( canvas_l->get_type(), export_pixel_type) != 0) {
+                nr_of_levels = l;
+                break;
+            }
+        }
+
     mi::base::Handle<mi::neuraylib::IImage_file> image_file( plugin->open_for_writing( &writer,
         export_pixel_type, image_width, image_height, nr_of_layers, nr_of_levels, is_cubemap, gamma,
         quality));
@@ -1024,15 +1077,21 @@ bool Image_module_impl::export_mipmap(
 
         nr_of_layers             = canvas_l->get_layers_size();
 
+        const Pixel_type level_pixel_type = convert_pixel_type_string_to_enum( canvas_l->get_type());
+        if( !pass_through && is_compressed_pixel_type( level_pixel_type))
+            canvas_l = convert_canvas(
+                canvas_l.get(), get_decompressed_pixel_type( level_pixel_type));
+
         // If enabled and necessary, adjust gamma to export_default_gamma
-        if( force_default_gamma && fabs( canvas_l->get_gamma() - export_default_gamma) > 0.001) {
+        if(    force_default_gamma && !pass_through
+            && fabs( canvas_l->get_gamma() - export_default_gamma) > 0.001) {
             mi::base::Handle<mi::neuraylib::ICanvas> tmp( copy_canvas( canvas_l.get()));
             adjust_gamma( tmp.get(), export_default_gamma);
             canvas_l = tmp;
         }
 
         // If necessary, convert canvas to export_pixel_type
-        if( strcmp( canvas_pixel_type, export_pixel_type) != 0) {
+        if( strcmp( canvas_l->get_type(), export_pixel_type) != 0) {
             canvas_l = convert_canvas( canvas_l.get(), export_pixel_type_enum);
             ASSERT( M_IMAGE, canvas_l);
         }
@@ -1087,8 +1146,22 @@ mi::neuraylib::IBuffer* Image_module_impl::create_buffer_from_canvas(
     const Pixel_type export_pixel_type_enum = convert_pixel_type_string_to_enum( export_pixel_type);
     const mi::Float32 export_default_gamma = get_default_gamma( export_pixel_type_enum);
 
+    // Block-compressed data is passed through unchanged if the plugin supports its pixel type,
+    // and decoded otherwise. Encoding into block-compressed pixel types is not supported.
+    const bool pass_through = is_compressed_pixel_type( export_pixel_type_enum);
+    const Pixel_type canvas_pixel_type = convert_pixel_type_string_to_enum( canvas->get_type());
+    if( pass_through && export_pixel_type_enum != canvas_pixel_type) {
+        LOG::mod_log->error( M_IMAGE, LOG::Mod_log::C_IO,
+            "Cannot encode a canvas of pixel type \"%s\" as block-compressed pixel type \"%s\".",
+            canvas->get_type(), export_pixel_type);
+        return nullptr;
+    }
+    if( !pass_through && is_compressed_pixel_type( canvas_pixel_type))
+        canvas = convert_canvas( canvas.get(), get_decompressed_pixel_type( canvas_pixel_type));
+
     // If enabled and necessary, adjust gamma to export_default_gamma
-    if( force_default_gamma && fabs( canvas->get_gamma() - export_default_gamma) > 0.001) {
+    if(    force_default_gamma && !pass_through
+        && fabs( canvas->get_gamma() - export_default_gamma) > 0.001) {
         mi::base::Handle<mi::neuraylib::ICanvas> tmp( copy_canvas( canvas.get()));
         adjust_gamma( tmp.get(), export_default_gamma);
         canvas = tmp;
@@ -1214,6 +1287,46 @@ IMdl_container_callback* Image_module_impl::get_mdl_container_callback() const
     return m_mdl_container_callback.get();
 }
 
+void Image_module_impl::set_tile_cache_budget( mi::Size budget)
+{
+    Tile_cache::get_instance().set_budget( budget);
+}
+
+mi::Size Image_module_impl::get_tile_cache_budget() const
+{
+    return Tile_cache::get_instance().get_budget();
+}
+
+Tile_cache_statistics Image_module_impl::get_tile_cache_statistics() const
+{
+    return Tile_cache::get_instance().get_statistics();
+}
+
+void Image_module_impl::set_decode_budget( mi::Size budget)
+{
+    m_decode_budget = budget;
+}
+
+mi::Size Image_module_impl::get_decode_budget() const
+{
+    return m_decode_budget;
+}
+
+void Image_module_impl::set_keep_compressed( bool value)
+{
+    m_keep_compressed = value;
+}
+
+bool Image_module_impl::get_keep_compressed() const
+{
+    return m_keep_compressed;
+}
+
+THREAD_POOL::Thread_pool* Image_module_impl::get_thread_pool() const
+{
+    return m_thread_pool.get();
+}
+
 void Image_module_impl::dump() const
 {
     mi::Size i = 0;
@@ -1348,6 +1461,12 @@ static constexpr mi::Float32 g_cost[14][14] = {
 
 mi::Float32 Image_module_impl::get_conversion_cost( Pixel_type from, Pixel_type to)
 {
+    // Block-compressed pixel types are only chosen for pass-through, never as conversion target.
+    // Conversions from them start at their decompressed pixel type.
+    if( is_compressed_pixel_type( to))
+        return from == to ? 0.0f : std::numeric_limits<mi::Float32>::max();
+    from = get_decompressed_pixel_type( from);
+
     ASSERT( M_IMAGE, from != PT_UNDEF && to != PT_UNDEF);
     ASSERT( M_IMAGE, from <= PT_COLOR && to <= PT_COLOR);
 
@@ -1457,16 +1576,130 @@ void apply_gamma(mi::math::Color& c, mi::Float32 gamma)
 #endif
 }
 
+/// Computes the layers of a miplevel with the box filter, split into fragments of rows.
+class Miplevel_job : public THREAD_POOL::Job_base
+{
+public:
+    Miplevel_job(
+        Pixel_type pixel_type,
+        mi::Float32 gamma,
+        const std::vector<mi::base::Handle<const mi::neuraylib::ITile> >& prev_tiles,
+        const std::vector<mi::base::Handle<mi::neuraylib::ITile> >& tiles,
+        mi::Uint32 height,
+        mi::Uint32 rows_per_fragment)
+      : Job_base( tiles.size() * ((height + rows_per_fragment - 1) / rows_per_fragment)),
+        m_pixel_type( pixel_type),
+        m_gamma( gamma),
+        m_prev_tiles( prev_tiles),
+        m_tiles( tiles),
+        m_height( height),
+        m_rows_per_fragment( rows_per_fragment),
+        m_fragments_per_layer( (height + rows_per_fragment - 1) / rows_per_fragment)
+    {
+    }
+
+    void execute_fragment( size_t index) final
+    {
+        const size_t layer = index / m_fragments_per_layer;
+        const mi::Uint32 row_begin
+            = static_cast<mi::Uint32>( index % m_fragments_per_layer) * m_rows_per_fragment;
+        const mi::Uint32 row_end = std::min( row_begin + m_rows_per_fragment, m_height);
+        box_filter_rows(
+            m_pixel_type, m_gamma, m_prev_tiles[layer].get(), m_tiles[layer].get(),
+            row_begin, row_end);
+    }
+
+private:
+    Pixel_type m_pixel_type;
+    mi::Float32 m_gamma;
+    const std::vector<mi::base::Handle<const mi::neuraylib::ITile> >& m_prev_tiles;
+    const std::vector<mi::base::Handle<mi::neuraylib::ITile> >& m_tiles;
+    mi::Uint32 m_height;
+    mi::Uint32 m_rows_per_fragment;
+    size_t m_fragments_per_layer;
+};
+
+/// Computes several consecutive miplevels in strips of rows.
+///
+/// Row y of a miplevel depends only on rows 2y and 2y+1 of the previous one. Hence, a strip of
+/// 2^(n-1) rows of the first miplevel, 2^(n-2) rows of the second one, ..., and one row of the
+/// n-th miplevel can be computed independently of the other strips. Each fragment computes such a
+/// strip for one layer, the data of the strip stays in the cache while descending the levels.
+class Miplevel_strips_job : public THREAD_POOL::Job_base
+{
+public:
+    /// \param prev_tiles   The tiles of the source canvas, for each layer.
+    /// \param tiles        The tiles of the \p nr_of_levels miplevels to compute, for each layer.
+    /// \param heights      The heights of the source canvas and the miplevels.
+    Miplevel_strips_job(
+        Pixel_type pixel_type,
+        mi::Float32 gamma,
+        const std::vector<mi::base::Handle<const mi::neuraylib::ITile> >& prev_tiles,
+        const std::vector<std::vector<mi::base::Handle<mi::neuraylib::ITile> > >& tiles,
+        const std::vector<mi::Uint32>& heights,
+        mi::Uint32 nr_of_levels,
+        mi::Uint32 nr_of_strips)
+      : Job_base( tiles.size() * nr_of_strips),
+        m_pixel_type( pixel_type),
+        m_gamma( gamma),
+        m_prev_tiles( prev_tiles),
+        m_tiles( tiles),
+        m_heights( heights),
+        m_nr_of_levels( nr_of_levels),
+        m_nr_of_strips( nr_of_strips)
+    {
+    }
+
+    void execute_fragment( size_t index) final
+    {
+        const size_t layer = index / m_nr_of_strips;
+        const std::vector<mi::base::Handle<mi::neuraylib::ITile> >& tiles = m_tiles[layer];
+        const mi::Uint32 strip = static_cast<mi::Uint32>( index % m_nr_of_strips);
+
+        for( mi::Uint32 level = 1; level <= m_nr_of_levels; ++level) {
+            const mi::Uint32 rows = 1u << (m_nr_of_levels - level);
+            const mi::Uint32 row_begin = strip * rows;
+            const mi::Uint32 row_end = std::min( row_begin + rows, m_heights[level]);
+            if( row_begin >= row_end)
+                break;
+            const mi::neuraylib::ITile* prev_tile
+                = level == 1 ? m_prev_tiles[layer].get() : tiles[level-2].get();
+            box_filter_rows(
+                m_pixel_type, m_gamma, prev_tile, tiles[level-1].get(), row_begin, row_end);
+        }
+    }
+
+private:
+    Pixel_type m_pixel_type;
+    mi::Float32 m_gamma;
+    const std::vector<mi::base::Handle<const mi::neuraylib::ITile> >& m_prev_tiles;
+    const std::vector<std::vector<mi::base::Handle<mi::neuraylib::ITile> > >& m_tiles;
+    const std::vector<mi::Uint32>& m_heights;
+    mi::Uint32 m_nr_of_levels;
+    mi::Uint32 m_nr_of_strips;
+};
+
 } // namespace
 
 mi::neuraylib::ICanvas* Image_module_impl::create_miplevel(
     const mi::neuraylib::ICanvas* prev_canvas, float gamma_override) const
 {
-    // NOTE: This implementation creates the new miplevel tile by tile. For each tile, it retrieves
-    // the at most four needed tiles from the previous miplevel *once* (and not for every pixel).
-    // Remember that tile lookups require locks (and reference counts).
+    // NOTE: For all pixel types except PT_RGBE and PT_RGBEA, this implementation uses typed
+    // kernels operating directly on the pixel data of the tiles, see box_filter_rows(). Larger
+    // miplevels are split into fragments of rows that are computed in parallel. The remaining
+    // pixel types are handled pixel by pixel via mi::math::Color.
     ASSERT(M_IMAGE, prev_canvas);
 
+    // Miplevels of block-compressed canvases are computed from the decompressed pixel data.
+    mi::base::Handle<mi::neuraylib::ICanvas> decompressed_canvas;
+    const Pixel_type compressed_pixel_type
+        = convert_pixel_type_string_to_enum(prev_canvas->get_type());
+    if (is_compressed_pixel_type(compressed_pixel_type)) {
+        decompressed_canvas = convert_canvas(
+            prev_canvas, get_decompressed_pixel_type(compressed_pixel_type));
+        prev_canvas = decompressed_canvas.get();
+    }
+
     // Get properties of previous miplevel
     const mi::Uint32 prev_width = prev_canvas->get_resolution_x();
     const mi::Uint32 prev_height = prev_canvas->get_resolution_y();
@@ -1487,6 +1720,31 @@ mi::neuraylib::ICanvas* Image_module_impl::create_miplevel(
         pixel_type, width, height, layers,
         get_canvas_is_cubemap(prev_canvas), prev_canvas->get_gamma());
 
+    if (is_box_filter_supported(pixel_type)) {
+
+        // Lookup all tiles upfront, tile lookups require locks (and might load tiles lazily)
+        std::vector<mi::base::Handle<const mi::neuraylib::ITile> > prev_tiles(layers);
+        std::vector<mi::base::Handle<mi::neuraylib::ITile> > tiles(layers);
+        for (mi::Uint32 z = 0; z < layers; ++z) {
+            prev_tiles[z] = prev_canvas->get_tile(z);
+            tiles[z] = canvas->get_tile(z);
+            ASSERT(M_IMAGE, prev_tiles[z] && tiles[z]);
+        }
+
+        // Use fragments of about 16k pixels, and avoid the overhead of the thread pool for small
+        // miplevels.
+        const mi::Uint64 nr_of_pixels = mi::Uint64(width) * height * layers;
+        if (!m_thread_pool || nr_of_pixels < 65536) {
+            for (mi::Uint32 z = 0; z < layers; ++z)
+                box_filter_rows(pixel_type, gamma, prev_tiles[z].get(), tiles[z].get(), 0, height);
+        } else {
+            const mi::Uint32 rows_per_fragment = std::max(16384u / width, 1u);
+            Miplevel_job job(pixel_type, gamma, prev_tiles, tiles, height, rows_per_fragment);
+            m_thread_pool->execute(&job);
+        }
+        return canvas;
+    }
+
     constexpr mi::Uint32 offsets_x[4] = { 0, 1, 0, 1 };
     constexpr mi::Uint32 offsets_y[4] = { 0, 0, 1, 1 };
 
@@ -1501,11 +1759,11 @@ mi::neuraylib::ICanvas* Image_module_impl::create_miplevel(
         const mi::Uint32 y_end = height;
 
         // Lookup tile for this miplevel
-        mi::base::Handle<mi::neuraylib::ITile> tile(canvas->get_tile());
+        mi::base::Handle<mi::neuraylib::ITile> tile(canvas->get_tile(tile_z));
 
         // Lookup involved tiles from the previous miplevel (note that these tiles are not
         // necessarily distinct).
-        mi::base::Handle<const mi::neuraylib::ITile> prev_tile( prev_canvas->get_tile());
+        mi::base::Handle<const mi::neuraylib::ITile> prev_tile( prev_canvas->get_tile(tile_z));
         ASSERT(M_IMAGE, prev_tile);
 
         // Loop over the pixels of this tile and compute the value for each pixel
@@ -1557,6 +1815,87 @@ mi::neuraylib::ICanvas* Image_module_impl::create_miplevel(
     return canvas;
 }
 
+void Image_module_impl::create_miplevels(
+    const mi::neuraylib::ICanvas* prev_canvas,
+    float gamma_override,
+    mi::Uint32 nr_of_levels,
+    std::vector<mi::base::Handle<mi::neuraylib::ICanvas> >& levels) const
+{
+    ASSERT(M_IMAGE, prev_canvas);
+    levels.resize(nr_of_levels);
+
+    // Miplevels of block-compressed canvases are computed from the decompressed pixel data.
+    mi::base::Handle<mi::neuraylib::ICanvas> decompressed_canvas;
+    const Pixel_type compressed_pixel_type
+        = convert_pixel_type_string_to_enum(prev_canvas->get_type());
+    if (is_compressed_pixel_type(compressed_pixel_type)) {
+        decompressed_canvas = convert_canvas(
+            prev_canvas, get_decompressed_pixel_type(compressed_pixel_type));
+        prev_canvas = decompressed_canvas.get();
+    }
+
+    const Pixel_type pixel_type = convert_pixel_type_string_to_enum(prev_canvas->get_type());
+    const mi::Float32 gamma
+        = gamma_override != 0.0f ? gamma_override : prev_canvas->get_gamma();
+    const mi::Uint32 layers = prev_canvas->get_layers_size();
+
+    mi::Uint32 level = 0;
+    const mi::neuraylib::ICanvas* canvas = prev_canvas;
+    while (level < nr_of_levels) {
+
+        const mi::Uint32 width = std::max(canvas->get_resolution_x() / 2, 1u);
+        const mi::Uint32 height = std::max(canvas->get_resolution_y() / 2, 1u);
+
+        // Small miplevels (and the pixel types without typed kernels) are created one by one.
+        const mi::Uint64 nr_of_pixels = mi::Uint64(width) * height * layers;
+        if (!m_thread_pool || !is_box_filter_supported(pixel_type) || nr_of_pixels < 65536) {
+            levels[level] = create_miplevel(canvas, gamma);
+            canvas = levels[level].get();
+            ++level;
+            continue;
+        }
+
+        // Use strips of about 16k pixels in the first miplevel of this pass. A strip of 2^(n-1)
+        // rows covers the next n miplevels.
+        const mi::Uint32 rows_per_strip = std::max(16384u / width, 1u);
+        mi::Uint32 n = 1;
+        while ((2u << (n-1)) <= rows_per_strip && level + n < nr_of_levels)
+            ++n;
+        const mi::Uint32 strip_rows = 1u << (n-1);
+        const mi::Uint32 nr_of_strips = (height + strip_rows - 1) / strip_rows;
+
+        // Create the miplevels of this pass and lookup all tiles upfront, tile lookups require
+        // locks (and might load tiles lazily)
+        std::vector<mi::Uint32> heights(n+1);
+        heights[0] = canvas->get_resolution_y();
+        std::vector<mi::base::Handle<const mi::neuraylib::ITile> > prev_tiles(layers);
+        std::vector<std::vector<mi::base::Handle<mi::neuraylib::ITile> > > tiles(layers);
+        for (mi::Uint32 z = 0; z < layers; ++z) {
+            prev_tiles[z] = canvas->get_tile(z);
+            ASSERT(M_IMAGE, prev_tiles[z]);
+            tiles[z].resize(n);
+        }
+        mi::Uint32 level_width = canvas->get_resolution_x();
+        for (mi::Uint32 i = 0; i < n; ++i) {
+            level_width = std::max(level_width / 2, 1u);
+            heights[i+1] = std::max(heights[i] / 2, 1u);
+            levels[level+i] = new Canvas_impl(
+                pixel_type, level_width, heights[i+1], layers,
+                get_canvas_is_cubemap(prev_canvas), prev_canvas->get_gamma());
+            for (mi::Uint32 z = 0; z < layers; ++z) {
+                tiles[z][i] = levels[level+i]->get_tile(z);
+                ASSERT(M_IMAGE, tiles[z][i]);
+            }
+        }
+
+        Miplevel_strips_job job(pixel_type, gamma, prev_tiles, tiles, heights, n, nr_of_strips);
+        m_thread_pool->execute(&job);
+
+        level += n;
+        canvas = levels[level-1].get();
+    }
+}
+
 } // namespace IMAGE
 
 } // namespace MI
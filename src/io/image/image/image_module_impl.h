@@ -34,6 +34,8 @@
 #include <mi/base/handle.h>
 #include <mi/base/lock.h>
 
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <base/system/main/access_module.h>
 
@@ -42,6 +44,7 @@ namespace mi { namespace base { class IPlugin_descriptor; } }
 namespace MI {
 
 namespace PLUG { class Plug_module; }
+namespace THREAD_POOL { class Thread_pool; }
 
 namespace IMAGE {
 
@@ -223,9 +226,31 @@ public:
 
     IMdl_container_callback* get_mdl_container_callback() const;
 
+    void set_tile_cache_budget( mi::Size budget);
+
+    mi::Size get_tile_cache_budget() const;
+
+    Tile_cache_statistics get_tile_cache_statistics() const;
+
+    void set_decode_budget( mi::Size budget);
+
+    mi::Size get_decode_budget() const;
+
+    void set_keep_compressed( bool value);
+
+    bool get_keep_compressed() const;
+
+    THREAD_POOL::Thread_pool* get_thread_pool() const;
+
     mi::neuraylib::ICanvas* create_miplevel(
         const mi::neuraylib::ICanvas* prev_canvas, float gamma_override) const;
 
+    void create_miplevels(
+        const mi::neuraylib::ICanvas* prev_canvas,
+        float gamma_override,
+        mi::Uint32 nr_of_levels,
+        std::vector<mi::base::Handle<mi::neuraylib::ICanvas> >& levels) const;
+
     void dump() const;
 
 private:
@@ -276,6 +301,16 @@ private:
 
     /// Callback to support lazy loading of images in MDL archives.
     mi::base::Handle<IMdl_container_callback> m_mdl_container_callback;
+
+    /// Thread pool used to compute the rows of miplevels and the mipmaps of image sets in
+    /// parallel. Shared with the other modules, see THREAD_POOL::get_shared_thread_pool().
+    std::shared_ptr<THREAD_POOL::Thread_pool> m_thread_pool;
+
+    /// The budget for image data decoded concurrently in bytes (0 means unlimited).
+    std::atomic<mi::Size> m_decode_budget{ 512 * 1024 * 1024};
+
+    /// Indicates whether block-compressed image data is kept compressed.
+    std::atomic<bool> m_keep_compressed{ false};
 };
 
 } // namespace IMAGE
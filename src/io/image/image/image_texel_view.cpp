@@ -0,0 +1,152 @@
+/***************************************************************************************************
+ * Copyright (c) 2012-2022, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************************************/
+
+#include "pch.h"
+
+#include "i_image_texel_view.h"
+#include "image_block_compression.h"
+#include "image_canvas_impl.h"
+
+#include <cstring>
+
+namespace MI {
+
+namespace IMAGE {
+
+Texel_view::Texel_view( const mi::neuraylib::ICanvas* canvas)
+{
+    if( !canvas)
+        return;
+
+    Pixel_type pixel_type = convert_pixel_type_string_to_enum( canvas->get_type());
+    if( pixel_type == PT_UNDEF)
+        return;
+
+    // Block-compressed canvases are decoded up front and viewed with the decompressed pixel type.
+    const bool is_compressed = is_compressed_pixel_type( pixel_type);
+    pixel_type = get_decompressed_pixel_type( pixel_type);
+
+    m_width           = canvas->get_resolution_x();
+    m_height          = canvas->get_resolution_y();
+    m_bytes_per_pixel = get_bytes_per_pixel( pixel_type);
+
+    if( pixel_type == PT_SINT32)    pixel_type = PT_RGBA;
+    if( pixel_type == PT_FLOAT32_3) pixel_type = PT_RGB_FP;
+    if( pixel_type == PT_FLOAT32_4) pixel_type = PT_COLOR;
+    m_pixel_type = pixel_type;
+
+    const mi::Uint32 nr_of_layers = canvas->get_layers_size();
+    m_layers.resize( nr_of_layers);
+
+    // Resolve blocks lazily such that the view does not keep the entire canvas loaded.
+    mi::base::Handle<const ICanvas> canvas_internal( canvas->get_interface<ICanvas>());
+    const mi::Uint32 block_size = canvas_internal ? canvas_internal->get_block_size() : 0;
+    if( block_size > 0) {
+        m_block_size = block_size;
+        m_blocks = std::make_shared<Blocks>();
+        m_blocks->m_canvas = canvas_internal;
+        m_blocks->m_nr_of_blocks_x = (m_width  + block_size - 1) / block_size;
+        m_blocks->m_nr_of_blocks_y = (m_height + block_size - 1) / block_size;
+        const mi::Size n = static_cast<mi::Size>( m_blocks->m_nr_of_blocks_x)
+            * m_blocks->m_nr_of_blocks_y * nr_of_layers;
+        m_blocks->m_blocks.reset( new std::atomic<Block*>[n]);
+        for( mi::Size i = 0; i < n; ++i)
+            m_blocks->m_blocks[i] = nullptr;
+        return;
+    }
+
+    m_tiles.resize( nr_of_layers);
+
+    const bool is_cubemap = canvas_internal && canvas_internal->get_is_cubemap();
+    const char* const type = convert_pixel_type_enum_to_string( pixel_type);
+
+    for( mi::Uint32 z = 0; z < nr_of_layers; ++z) {
+        m_tiles[z] = canvas->get_tile( z);
+        if( is_compressed)
+            m_tiles[z] = decompress_tile( m_tiles[z].get(), !is_cubemap);
+        const mi::neuraylib::ITile* tile = m_tiles[z].get();
+
+        // Direct access requires the tile to cover the entire layer with the (decompressed) pixel
+        // type of the canvas.
+        const bool direct = tile->get_resolution_x() == m_width
+            && tile->get_resolution_y() == m_height
+            && strcmp( tile->get_type(), type) == 0;
+
+        m_layers[z].m_tile = tile;
+        m_layers[z].m_data = direct ? static_cast<const mi::Uint8*>( tile->get_data()) : nullptr;
+    }
+}
+
+Texel_view::Blocks::~Blocks()
+{
+    const mi::Size n = static_cast<mi::Size>( m_nr_of_blocks_x) * m_nr_of_blocks_y
+        * m_canvas->get_layers_size();
+    for( mi::Size i = 0; i < n; ++i)
+        delete m_blocks[i].load( std::memory_order_relaxed);
+}
+
+const Texel_view::Block& Texel_view::resolve_block(
+    mi::Size index, mi::Uint32 block_x, mi::Uint32 block_y, mi::Uint32 z) const
+{
+    const ICanvas* canvas = m_blocks->m_canvas.get();
+
+    auto* block = new Block;
+    block->m_tile = canvas->get_block( block_x, block_y, z);
+    const bool is_block = block->m_tile;
+    if( is_block) {
+        block->m_x = block_x * m_block_size;
+        block->m_y = block_y * m_block_size;
+    } else {
+        // The layer has been requested for modification and is no longer split into blocks.
+        block->m_tile = canvas->get_tile( z);
+        block->m_x = 0;
+        block->m_y = 0;
+    }
+
+    // Direct access requires the pixel type of the canvas, and for entire layers also the size
+    // of the canvas.
+    const mi::neuraylib::ITile* tile = block->m_tile.get();
+    block->m_width = tile->get_resolution_x();
+    const bool direct = strcmp( tile->get_type(), canvas->get_type()) == 0
+        && (is_block || (block->m_width == m_width && tile->get_resolution_y() == m_height));
+    block->m_data = direct ? static_cast<const mi::Uint8*>( tile->get_data()) : nullptr;
+
+    // Publish the block. If another thread was faster, use its block instead.
+    Block* expected = nullptr;
+    if( !m_blocks->m_blocks[index].compare_exchange_strong(
+            expected, block, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        delete block;
+        return *expected;
+    }
+
+    return *block;
+}
+
+} // namespace IMAGE
+
+} // namespace MI
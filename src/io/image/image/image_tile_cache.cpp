@@ -0,0 +1,143 @@
+/***************************************************************************************************
+ * Copyright (c) 2012-2022, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************************************/
+
+#include "pch.h"
+
+#include "image_tile_cache.h"
+#include "image_canvas_impl.h"
+
+#include <base/lib/log/i_log_assert.h>
+
+namespace MI {
+
+namespace IMAGE {
+
+Tile_cache& Tile_cache::get_instance()
+{
+    static Tile_cache s_instance;
+    return s_instance;
+}
+
+void Tile_cache::set_budget( mi::Size budget)
+{
+    std::lock_guard<std::mutex> lock( m_mutex);
+    m_budget = budget;
+    evict( nullptr);
+}
+
+mi::Size Tile_cache::get_budget() const
+{
+    std::lock_guard<std::mutex> lock( m_mutex);
+    return m_budget;
+}
+
+Tile_cache_statistics Tile_cache::get_statistics() const
+{
+    std::lock_guard<std::mutex> lock( m_mutex);
+    Tile_cache_statistics result = m_statistics;
+    result.m_nr_of_tiles = m_entries.size();
+    result.m_budget = m_budget;
+    return result;
+}
+
+void Tile_cache::insert( const Canvas_impl* canvas, mi::Uint32 index, mi::Size size)
+{
+    std::lock_guard<std::mutex> lock( m_mutex);
+    ++m_statistics.m_misses;
+
+    const Key key( canvas, index);
+    auto it = m_entries.find( key);
+    if( it != m_entries.end())
+        remove( it->second);
+
+    m_lru.push_back( Entry{ key, size});
+    m_entries[key] = std::prev( m_lru.end());
+    m_statistics.m_memory_usage += size;
+
+    evict( canvas);
+}
+
+void Tile_cache::touch( const Canvas_impl* canvas, mi::Uint32 index)
+{
+    std::lock_guard<std::mutex> lock( m_mutex);
+    ++m_statistics.m_hits;
+
+    auto it = m_entries.find( Key( canvas, index));
+    if( it != m_entries.end())
+        m_lru.splice( m_lru.end(), m_lru, it->second);
+}
+
+void Tile_cache::erase( const Canvas_impl* canvas, mi::Uint32 index)
+{
+    std::lock_guard<std::mutex> lock( m_mutex);
+    auto it = m_entries.find( Key( canvas, index));
+    if( it != m_entries.end())
+        remove( it->second);
+}
+
+void Tile_cache::erase( const Canvas_impl* canvas)
+{
+    std::lock_guard<std::mutex> lock( m_mutex);
+    auto it = m_entries.lower_bound( Key( canvas, 0));
+    while( it != m_entries.end() && it->first.first == canvas) {
+        Lru_list::iterator entry = it->second;
+        ++it;
+        remove( entry);
+    }
+}
+
+void Tile_cache::evict( const Canvas_impl* keep)
+{
+    if( m_budget == 0)
+        return;
+
+    auto it = m_lru.begin();
+    while( m_statistics.m_memory_usage > m_budget && it != m_lru.end()) {
+        const Key key = it->m_key;
+        auto current = it++;
+        if( key.first == keep)
+            continue;
+        // Skips canvases that are locked or whose block is still referenced elsewhere.
+        if( !key.first->try_evict_block( key.second))
+            continue;
+        remove( current);
+        ++m_statistics.m_evictions;
+    }
+}
+
+void Tile_cache::remove( Lru_list::iterator it)
+{
+    ASSERT( M_IMAGE, m_statistics.m_memory_usage >= it->m_size);
+    m_statistics.m_memory_usage -= it->m_size;
+    m_entries.erase( it->m_key);
+    m_lru.erase( it);
+}
+
+} // namespace IMAGE
+
+} // namespace MI
@@ -0,0 +1,124 @@
+/***************************************************************************************************
+ * Copyright (c) 2012-2022, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************************************/
+
+#ifndef IO_IMAGE_IMAGE_IMAGE_TILE_CACHE_H
+#define IO_IMAGE_IMAGE_IMAGE_TILE_CACHE_H
+
+#include <mi/base/types.h>
+
+#include "i_image.h"
+
+#include <list>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace MI {
+
+namespace IMAGE {
+
+class Canvas_impl;
+
+/// The process-wide LRU cache for lazily loaded tiles.
+///
+/// The cache does not own tiles, they are still held by their canvases. It tracks the memory used
+/// by the fixed-size blocks of lazily loading canvases (and by layers of such canvases that have
+/// been requested as a whole), and asks the least recently used canvases to release them if the
+/// memory usage exceeds the budget (see Canvas_impl::try_evict_block()). Blocks and layers are
+/// identified by the canvas and an index.
+///
+/// Canvases call #insert() and #touch() while holding their own lock. Therefore, the cache never
+/// blocks on the lock of a canvas while holding its own lock, but skips canvases whose lock is
+/// currently taken.
+class Tile_cache
+{
+public:
+    /// Returns the process-wide instance.
+    static Tile_cache& get_instance();
+
+    /// Sets the budget in bytes (0 means unlimited). Evicts tiles if necessary.
+    void set_budget( mi::Size budget);
+
+    /// Returns the budget in bytes (0 means unlimited).
+    mi::Size get_budget() const;
+
+    /// Returns the statistics of the cache.
+    Tile_cache_statistics get_statistics() const;
+
+    /// Adds a freshly loaded block of a canvas as most recently used block, counts a miss, and
+    /// evicts other blocks if the budget is exceeded.
+    void insert( const Canvas_impl* canvas, mi::Uint32 index, mi::Size size);
+
+    /// Marks a block of a canvas as most recently used and counts a hit.
+    ///
+    /// The hit is also counted if the block is not (or no longer) managed by the cache.
+    void touch( const Canvas_impl* canvas, mi::Uint32 index);
+
+    /// Removes a block of a canvas from the cache, e.g., if its layer is about to be modified.
+    void erase( const Canvas_impl* canvas, mi::Uint32 index);
+
+    /// Removes all tiles of a canvas from the cache, e.g., if the canvas is destroyed.
+    void erase( const Canvas_impl* canvas);
+
+private:
+    Tile_cache() = default;
+
+    using Key = std::pair<const Canvas_impl*, mi::Uint32>;
+
+    struct Entry
+    {
+        Key m_key;
+        mi::Size m_size;
+    };
+
+    using Lru_list = std::list<Entry>;
+
+    /// Evicts least recently used tiles until the memory usage is within the budget. Does not
+    /// evict tiles of \p keep (the canvas calling #insert(), if any). Needs #m_mutex.
+    void evict( const Canvas_impl* keep);
+
+    /// Removes an entry. Needs #m_mutex.
+    void remove( Lru_list::iterator it);
+
+    /// The mutex for all members.
+    mutable std::mutex m_mutex;
+    /// The budget in bytes (0 means unlimited).
+    mi::Size m_budget = 0;
+    /// The entries, from least to most recently used.
+    Lru_list m_lru;
+    /// Maps canvas and block index to the corresponding entry in #m_lru.
+    std::map<Key, Lru_list::iterator> m_entries;
+    /// The statistics (budget, number of tiles and memory usage are filled in on request).
+    Tile_cache_statistics m_statistics;
+};
+
+} // namespace IMAGE
+
+} // namespace MI
+
+#endif // IO_IMAGE_IMAGE_IMAGE_TILE_CACHE_H
@@ -29,10 +29,12 @@
 #include "pch.h"
 
 #include "image_tile_impl.h"
+#include "image_block_compression.h"
 
 #include <mi/math/color.h>
 #include <mi/math/function.h>
 
+#include <io/image/image/i_image_pixel_conversion.h>
 #include <io/image/image/i_image_quantization.h>
 
 #include <base/lib/log/i_log_logger.h>
@@ -510,6 +512,57 @@ template class Tile_impl<PT_RGBA_16>;
 template class Tile_impl<PT_RGB_FP>;
 template class Tile_impl<PT_COLOR>;
 
+// ---------- Compressed_tile_impl -----------------------------------------------------------------
+
+Compressed_tile_impl::Compressed_tile_impl(
+    Pixel_type pixel_type, mi::Uint32 width, mi::Uint32 height)
+{
+    // check incorrect arguments
+    ASSERT( M_IMAGE, is_compressed_pixel_type( pixel_type));
+    ASSERT( M_IMAGE, width > 0 && height > 0);
+
+    m_pixel_type = pixel_type;
+    m_width = width;
+    m_height = height;
+    m_data.resize( get_data_size( m_pixel_type, m_width, m_height));
+}
+
+void Compressed_tile_impl::set_pixel(
+    mi::Uint32 x_offset, mi::Uint32 y_offset, const mi::Float32* floats)
+{
+}
+
+void Compressed_tile_impl::get_pixel(
+    mi::Uint32 x_offset, mi::Uint32 y_offset, mi::Float32* floats) const
+{
+    if( x_offset >= m_width || y_offset >= m_height)
+        return;
+
+    // The blocks are stored top-down.
+    const mi::Uint32 row = m_height - 1 - y_offset;
+    const mi::Size blocks_x = (m_width + 3) / 4;
+    const mi::Uint8* const block = m_data.data()
+        + ((row / 4) * blocks_x + x_offset / 4) * get_bytes_per_block( m_pixel_type);
+
+    mi::Uint8 pixels[16 * 4 * sizeof( mi::Float32)];
+    decompress_block( m_pixel_type, block, pixels);
+
+    const Pixel_type pixel_type = get_decompressed_pixel_type( m_pixel_type);
+    const mi::Uint32 bytes_per_pixel = get_bytes_per_pixel( pixel_type);
+    const mi::Uint8* const pixel = pixels + ((row % 4) * 4 + x_offset % 4) * bytes_per_pixel;
+    convert( pixel, floats, pixel_type, PT_COLOR);
+}
+
+const char* Compressed_tile_impl::get_type() const
+{
+    return convert_pixel_type_enum_to_string( m_pixel_type);
+}
+
+mi::Size Compressed_tile_impl::get_size() const
+{
+    return sizeof( *this) + m_data.size();
+}
+
 mi::neuraylib::ITile* create_tile( Pixel_type pixel_type, mi::Uint32 width, mi::Uint32 height)
 {
     switch( pixel_type) {
@@ -528,6 +581,16 @@ mi::neuraylib::ITile* create_tile( Pixel_type pixel_type, mi::Uint32 width, mi::
         case PT_RGBA_16:   return new Tile_impl<PT_RGBA_16  >( width, height);
         case PT_RGB_FP:    return new Tile_impl<PT_RGB_FP   >( width, height);
         case PT_COLOR:     return new Tile_impl<PT_COLOR    >( width, height);
+        case PT_BC1:
+        case PT_BC2:
+        case PT_BC3:
+        case PT_BC4:
+        case PT_BC4S:
+        case PT_BC5:
+        case PT_BC5S:
+        case PT_BC6H:
+        case PT_BC6HS:
+        case PT_BC7:       return new Compressed_tile_impl( pixel_type, width, height);
         default:           ASSERT( M_IMAGE, false); return nullptr;
     }
 }
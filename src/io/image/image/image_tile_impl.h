@@ -111,6 +111,55 @@ private:
     std::vector<typename Pixel_type_traits<T>::Base_type> m_data;
 };
 
+/// An implementation of the ITile interface for block-compressed pixel types.
+///
+/// The data consists of the 4x4 pixel blocks, starting with the top row of blocks (see
+/// #is_compressed_pixel_type()). #get_pixel() decodes the block containing the pixel and uses the
+/// usual bottom-up row order. #set_pixel() has no effect.
+class Compressed_tile_impl
+  : public mi::base::Interface_implement<ITile>,
+    public boost::noncopyable
+{
+public:
+    /// Constructor.
+    ///
+    /// Creates a tile of the given block-compressed pixel type, width and height.
+    Compressed_tile_impl( Pixel_type pixel_type, mi::Uint32 width, mi::Uint32 height);
+
+    // methods of mi::neuraylib::ITile
+
+    void set_pixel( mi::Uint32 x_offset, mi::Uint32 y_offset, const mi::Float32* floats);
+
+    void get_pixel( mi::Uint32 x_offset, mi::Uint32 y_offset, mi::Float32* floats) const;
+
+    const char* get_type() const;
+
+    mi::Uint32 get_resolution_x() const { return m_width; }
+
+    mi::Uint32 get_resolution_y() const { return m_height; }
+
+    const void* get_data() const { return m_data.data(); }
+
+    void* get_data() { return m_data.data(); }
+
+    // own methods
+
+    /// Returns the memory used by this element in bytes, including all substructures.
+    ///
+    /// Used to implement DB::Element_base::get_size() for DBIMAGE::Image.
+    mi::Size get_size() const;
+
+private:
+    /// The block-compressed pixel type
+    Pixel_type m_pixel_type;
+    /// Width of the tile
+    mi::Uint32 m_width;
+    /// Height of the tile
+    mi::Uint32 m_height;
+    /// The blocks of this tile
+    std::vector<mi::Uint8> m_data;
+};
+
 } // namespace IMAGE
 
 } // namespace MI
@@ -34,6 +34,9 @@
 #include <mi/neuraylib/ireader.h>
 #include <mi/neuraylib/itile.h>
 
+#include <condition_variable>
+#include <mutex>
+
 #include <boost/core/ignore_unused.hpp>
 
 #include <base/hal/disk/disk.h>
@@ -43,6 +46,7 @@
 #include <base/data/serial/i_serializer.h>
 #include <base/data/db/i_db_access.h>
 #include <base/data/db/i_db_transaction.h>
+#include <base/data/thread_pool/i_thread_pool.h>
 #include <base/util/string_utils/i_string_utils.h>
 #include <io/image/image/i_image.h>
 #include <io/image/image/i_image_mipmap.h>
@@ -67,6 +71,103 @@ std::string hash_to_string( const mi::base::Uuid& hash)
     return buffer;
 }
 
+/// Indicates whether the current thread holds some of the decode budget.
+thread_local bool s_holds_decode_budget = false;
+
+/// Creates the mipmaps of several frames/uvtiles of an image set, one fragment per uvtile.
+///
+/// Lazily loaded mipmaps only read the image header when created. Therefore, each fragment also
+/// decodes all layers of level 0, such that the pixel data is decoded in parallel instead of on
+/// first access. Fragments wait before decoding as long as the size of the decoded image data in
+/// flight, computed from the header, would exceed the budget. The mipmaps are stored by fragment
+/// index, i.e., the result does not depend on the order of execution. Requires
+/// Image_set::supports_concurrent_create_mipmap().
+class Create_mipmaps_job : public THREAD_POOL::Job_base
+{
+public:
+    /// Constructor.
+    ///
+    /// \param image_set   The image set to decode.
+    /// \param uvtiles     The frame and uvtile indices of all fragments.
+    /// \param budget      The decode budget in bytes, 0 means unlimited.
+    Create_mipmaps_job(
+        const Image_set* image_set,
+        const std::vector<std::pair<mi::Size, mi::Size> >& uvtiles,
+        mi::Size budget)
+      : Job_base( uvtiles.size()),
+        m_image_set( image_set),
+        m_uvtiles( uvtiles),
+        m_mipmaps( uvtiles.size()),
+        m_budget( budget),
+        m_in_flight( 0)
+    {
+    }
+
+    void execute_fragment( size_t index) final
+    {
+        const mi::Size f = m_uvtiles[index].first;
+        const mi::Size i = m_uvtiles[index].second;
+
+        // Creating the mipmap reads only the header (for lazily loaded image data).
+        m_mipmaps[index] = m_image_set->create_mipmap( f, i);
+        if( !m_mipmaps[index])
+            return;
+        mi::base::Handle<const mi::neuraylib::ICanvas> canvas( m_mipmaps[index]->get_level( 0));
+        if( !canvas)
+            return;
+
+        // Nested fragments of a thread that already holds budget must not wait for it.
+        const bool acquire = m_budget > 0 && !s_holds_decode_budget;
+        const mi::Size size = acquire ? std::min( get_decoded_size( canvas.get()), m_budget) : 0;
+        if( acquire) {
+            std::unique_lock<std::mutex> lock( m_mutex);
+            m_condition.wait( lock, [this, size] {
+                return m_in_flight == 0 || m_in_flight + size <= m_budget; });
+            m_in_flight += size;
+            s_holds_decode_budget = true;
+        }
+
+        // Decode the pixel data. Lazily loaded canvases keep the decoded layers (subject to the
+        // budget of the tile cache), memory-based canvases just return their tiles.
+        for( mi::Uint32 z = 0, n = canvas->get_layers_size(); z < n; ++z)
+            mi::base::Handle<const mi::neuraylib::ITile> tile( canvas->get_tile( z));
+
+        if( acquire) {
+            s_holds_decode_budget = false;
+            std::unique_lock<std::mutex> lock( m_mutex);
+            m_in_flight -= size;
+            m_condition.notify_all();
+        }
+    }
+
+    /// Returns the mipmap of fragment \p index.
+    const mi::base::Handle<IMAGE::IMipmap>& get_mipmap( size_t index) const
+    { return m_mipmaps[index]; }
+
+private:
+    /// Returns the size of the decoded pixel data of all layers of \p canvas.
+    static mi::Size get_decoded_size( const mi::neuraylib::ICanvas* canvas)
+    {
+        const IMAGE::Pixel_type pixel_type
+            = IMAGE::convert_pixel_type_string_to_enum( canvas->get_type());
+        return IMAGE::get_data_size(
+                pixel_type, canvas->get_resolution_x(), canvas->get_resolution_y())
+            * canvas->get_layers_size();
+    }
+
+    const Image_set* m_image_set;
+    const std::vector<std::pair<mi::Size, mi::Size> >& m_uvtiles;
+    std::vector<mi::base::Handle<IMAGE::IMipmap> > m_mipmaps;
+    mi::Size m_budget;
+
+    /// The mutex for #m_in_flight.
+    std::mutex m_mutex;
+    /// The size of the image data currently being decoded. Needs #m_mutex.
+    mi::Size m_in_flight;
+    /// Signaled when image data has been decoded.
+    std::condition_variable m_condition;
+};
+
 } // namespace
 
 IMAGE::IMipmap* Image_set::create_mipmap( mi::Size f, mi::Size i) const
@@ -254,6 +355,9 @@ public:
 
     mi::neuraylib::ICanvas* get_canvas( mi::Size f, mi::Size i) const { return nullptr; }
 
+    // Every uvtile is decoded from a file of its own.
+    bool supports_concurrent_create_mipmap() const { return true; }
+
 private:
     mi::Size get_global_index( mi::Size f, mi::Size i) const
     {
@@ -521,6 +625,9 @@ mi::Sint32 Image::reset_image_set(
     Frames_filenames tmp_frames_filenames;
     Frame_to_id tmp_frame_to_id;
 
+    // The frame and uvtile indices of all uvtiles, in order.
+    std::vector<std::pair<mi::Size, mi::Size> > uvtiles;
+
     // Convert data from image set into temporary variables
     for( mi::Size f = 0; f < number_of_frames; ++f) {
 
@@ -567,9 +674,7 @@ mi::Sint32 Image::reset_image_set(
             Uvtile& tile = frame.m_uvtiles[i];
             tile.m_u = u;
             tile.m_v = v;
-            tile.m_mipmap = image_set->create_mipmap( f, i);
-            if( !tile.m_mipmap)
-                return -3;
+            uvtiles.emplace_back( f, i);
 
             Uvfilenames& filenames = frame_filenames[i];
             filenames.m_resolved_filename    = image_set->get_resolved_filename( f, i);
@@ -587,6 +692,29 @@ mi::Sint32 Image::reset_image_set(
         tmp_frame_to_id[frame_number] = f;
     }
 
+    // Decode all frames/uvtiles. Several of them are decoded in parallel, in particular for UDIM
+    // sets and animated textures, see Create_mipmaps_job. Image sets that do not support this
+    // are decoded sequentially.
+    SYSTEM::Access_module<IMAGE::Image_module> image_module( false);
+    THREAD_POOL::Thread_pool* thread_pool = image_module->get_thread_pool();
+    if( !thread_pool || uvtiles.size() < 2 || !image_set->supports_concurrent_create_mipmap()) {
+        for( const auto& uvtile: uvtiles) {
+            Uvtile& tile = tmp_frames[uvtile.first].m_uvtiles[uvtile.second];
+            tile.m_mipmap = image_set->create_mipmap( uvtile.first, uvtile.second);
+            if( !tile.m_mipmap)
+                return -3;
+        }
+    } else {
+        Create_mipmaps_job job( image_set, uvtiles, image_module->get_decode_budget());
+        thread_pool->execute( &job);
+        for( size_t j = 0, n = uvtiles.size(); j < n; ++j) {
+            Uvtile& tile = tmp_frames[uvtiles[j].first].m_uvtiles[uvtiles[j].second];
+            tile.m_mipmap = job.get_mipmap( j);
+            if( !tile.m_mipmap)
+                return -3;
+        }
+    }
+
     reset_shared(
         transaction, tmp_is_animated, tmp_is_uvtile, tmp_frames, tmp_frame_to_id, impl_hash);
 
@@ -140,8 +140,19 @@ public:
     /// Returns \c NULL if not supported.
     virtual mi::neuraylib::ICanvas* get_canvas( mi::Size f, mi::Size i) const = 0;
 
+    /// Indicates whether #create_mipmap() may be called concurrently for different frames and
+    /// uvtiles.
+    ///
+    /// Implementations returning \c true must support concurrent calls of #open_reader() and
+    /// #get_canvas(). Otherwise, the frames and uvtiles of the set are decoded one after the
+    /// other. The default returns \c false.
+    virtual bool supports_concurrent_create_mipmap() const { return false; }
+
     /// Creates a mipmap for  for frame \p f, uvtile \p i.
     ///
+    /// Thread-safe for different (\p f, \p i) pairs if #supports_concurrent_create_mipmap()
+    /// returns \c true.
+    ///
     /// Never returns \c NULL.
     IMAGE::IMipmap* create_mipmap( mi::Size f, mi::Size i) const;
 };
@@ -1115,11 +1115,23 @@ private:
 class Module_cache;
 
 /// Used with module cache in order to allow parallel loading of modules.
+///
+/// Loading contexts are identified by the module cache instance and the calling thread, such that
+/// several threads can load modules concurrently for the same module cache, e.g., when the MDL
+/// compiler loads imports in parallel.
 class Mdl_module_wait_queue
 {
     class Table;
 
 public:
+    /// Identifies a loading context: the context ID of the module cache and the calling thread.
+    using Loader_id = std::pair<size_t, std::thread::id>;
+
+    /// Returns the identifier of the current loading context.
+    ///
+    /// \param cache                The current instance of the module cache.
+    static Loader_id get_loader_id(const Module_cache* cache);
+
     /// For each module to load, an entry is created in the waiting table so threads that
     /// depend on that module can wait until the loading thread is finished
     class Entry
@@ -1169,12 +1181,15 @@ public:
         /// Increments the usage counter of the entry.
         void increment_usage_count();
 
+        /// Returns the identifier of the loading context that created this entry.
+        const Loader_id& get_loader_id() const { return m_loader_id; }
+
     private:
         /// Erases this entry from the parent table and self-destructs.
         void cleanup();
 
         std::string m_core_name;
-        size_t m_cache_context_id;
+        Loader_id m_loader_id;
         mi::base::Handle<mi::neuraylib::IMdl_loading_wait_handle> m_handle;
         Table* m_parent_table;
         std::mutex m_usage_count_mutex;
@@ -1236,6 +1251,11 @@ public:
         /// If the module is not in the cache, \c wait has to be called on this queue entry
         /// If this pointer is NULL, too, the current thread is responsible for loading the module.
         Entry* queue_entry;
+
+        /// Indicates that waiting for the loading context of the module would never end, because
+        /// that context (indirectly) waits for the current one. Both pointers are NULL in this
+        /// case, but the current thread must not load the module.
+        bool is_cyclic;
     };
 
     //---------------------------------------------------------------------------------------------
@@ -1252,6 +1272,13 @@ public:
         size_t transaction,
         const std::string& name);
 
+    /// Waits on an entry returned by \c lookup.
+    ///
+    /// \param cache            The current module cache.
+    /// \param entry            The entry returned by \c lookup.
+    /// \return                 The result code of the loading context.
+    mi::Sint32 wait(const Module_cache* cache, Entry* entry);
+
     /// Check if this module is loaded by the current thread.
     /// \param cache            The current module cache.
     /// \param transaction      The current transaction to use.
@@ -1283,6 +1310,10 @@ public:
 
 private:
     std::unordered_map<size_t, Table*> m_tables;
+
+    /// The loading contexts currently waiting, mapped to the loading context they wait for.
+    std::map<Loader_id, Loader_id> m_waiting;
+
     std::mutex m_mutex;
 };
 
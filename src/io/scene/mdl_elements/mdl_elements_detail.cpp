@@ -773,8 +773,20 @@ bool Input_stream_reader_impl::readline( char* buffer, mi::Sint32 size)
 }
 
 Resource_reader_impl::Resource_reader_impl( mi::mdl::IMDL_resource_reader* reader)
-  : m_reader( reader, mi::base::DUP_INTERFACE)
-{
+  : m_reader( reader, mi::base::DUP_INTERFACE),
+    m_data( nullptr),
+    m_size( 0)
+{
+    mi::base::Handle<mi::mdl::IMDL_mapped_resource_reader> mapped_reader(
+        reader->get_interface<mi::mdl::IMDL_mapped_resource_reader>());
+    if( mapped_reader) {
+        mi::Uint64 size = 0;
+        const unsigned char* data = mapped_reader->get_mapped_data( size);
+        if( data) {
+            m_data = reinterpret_cast<const char*>( data);
+            m_size = static_cast<mi::Sint64>( size);
+        }
+    }
 }
 
 bool Resource_reader_impl::eof() const
@@ -799,6 +811,9 @@ bool Resource_reader_impl::seek_absolute( mi::Sint64 pos)
 
 mi::Sint64 Resource_reader_impl::get_file_size() const
 {
+    if( m_data)
+        return m_size;
+
     mi::Uint64 pos = m_reader->tell();
     m_reader->seek( 0, mi::mdl::IMDL_resource_reader::MDL_SEEK_END);
     mi::Uint64 size = m_reader->tell();
@@ -839,6 +854,23 @@ bool Resource_reader_impl::readline( char* buffer, mi::Sint32 size)
     return true;
 }
 
+mi::Sint64 Resource_reader_impl::lookahead( mi::Sint64 size, const char** buffer) const
+{
+    if( !m_data) {
+        *buffer = nullptr;
+        return 0;
+    }
+
+    // the data stays valid as long as the reader, so the buffer can point into it
+    mi::Sint64 pos = tell_absolute();
+    if( pos >= m_size) {
+        *buffer = nullptr;
+        return 0;
+    }
+    *buffer = m_data + pos;
+    return std::min( size, m_size - pos);
+}
+
 Input_stream_impl::Input_stream_impl( mi::neuraylib::IReader* reader, const std::string& filename)
   : m_reader( reader, mi::base::DUP_INTERFACE),
     m_filename( filename)
@@ -1092,6 +1124,12 @@ mi::neuraylib::ICanvas* Mdl_image_set::get_canvas( mi::Size f, mi::Size i) const
     return nullptr;
 }
 
+bool Mdl_image_set::supports_concurrent_create_mipmap() const
+{
+    // The resource elements open a new file or container handle for every reader.
+    return true;
+}
+
 std::string lookup_thumbnail(
     const std::string& module_filename,
     const std::string& module_name,
@@ -1369,6 +1407,22 @@ Local_mdl_resource_reader::Local_mdl_resource_reader( mi::mdl::IMDL_resource_rea
     if( mdl_url)
         m_mdl_url  = mdl_url;
     m_hash_valid   = other->get_resource_hash( &m_hash[0]);
+    m_view         = nullptr;
+
+    // data that is directly accessible in memory stays valid as long as its reader, no need to
+    // copy it
+    mi::base::Handle<mi::mdl::IMDL_mapped_resource_reader> mapped_reader(
+        other->get_interface<mi::mdl::IMDL_mapped_resource_reader>());
+    if( mapped_reader) {
+        mi::Uint64 size = 0;
+        const unsigned char* data = mapped_reader->get_mapped_data( size);
+        if( data) {
+            m_mapped_reader = mapped_reader;
+            m_view = data;
+            m_size = size;
+            return;
+        }
+    }
 
     bool success = other->seek( 0, mi::mdl::IMDL_resource_reader::MDL_SEEK_END);
     if( !success)
@@ -1386,12 +1440,14 @@ Local_mdl_resource_reader::Local_mdl_resource_reader( mi::mdl::IMDL_resource_rea
         m_size = count;
         m_data.resize( m_size);
     }
+    m_view = reinterpret_cast<const unsigned char*>( m_data.data());
 }
 
 mi::Uint64 Local_mdl_resource_reader::read( void* ptr, mi::Uint64 size)
 {
    mi::Uint64 count = std::min( size, m_size-m_position);
-   memcpy( ptr, &m_data[m_position], count);
+   if( count > 0)
+       memcpy( ptr, m_view + m_position, count);
    m_position += count;
    return count;
 }
@@ -1445,6 +1501,12 @@ bool Local_mdl_resource_reader::get_resource_hash( unsigned char hash[16])
     return true;
 }
 
+const unsigned char* Local_mdl_resource_reader::get_mapped_data( mi::Uint64& size) const
+{
+    size = m_view ? m_size : 0;
+    return m_view;
+}
+
 } // namespace DETAIL
 
 } // namespace MDL
@@ -503,16 +503,21 @@ public:
 
     bool readline( char* buffer, mi::Sint32 size);
 
-    /// Lookahead is not supported in this implementation since the signature of lookahead()
-    /// is not thread-safe.
-    bool supports_lookahead() const { return false; }
+    /// Lookahead is only supported for resource data that is directly accessible in memory, e.g.,
+    /// resources stored uncompressed in MDL archives. Otherwise the signature of lookahead() is
+    /// not thread-safe.
+    bool supports_lookahead() const { return m_data != nullptr; }
 
-    /// Lookahead is not supported in this implementation since the signature of lookahead()
-    /// is not thread-safe.
-    mi::Sint64 lookahead( mi::Sint64 size, const char** buffer) const { return 0; }
+    mi::Sint64 lookahead( mi::Sint64 size, const char** buffer) const;
 
 private:
     mi::base::Handle<mi::mdl::IMDL_resource_reader> m_reader;
+
+    /// The resource data if directly accessible in memory, \c nullptr otherwise.
+    const char* m_data;
+
+    /// The size of the resource data if directly accessible in memory.
+    mi::Sint64 m_size;
 };
 
 /// Adapts mi::neuraylib::IReader to mi::mdl::Input_stream.
@@ -624,6 +629,8 @@ public:
 
     mi::neuraylib::ICanvas* get_canvas( mi::Size f, mi::Size i) const;
 
+    bool supports_concurrent_create_mipmap() const;
+
 private:
 
     mi::base::Handle<mi::mdl::IMDL_resource_set> m_resource_set;
@@ -726,9 +733,10 @@ private:
 /// Can be used to enforce reading all data from \c other once upfront in situations where later
 /// calls are not feasible.
 ///
-/// The entire reader content will be read upfront and stored in a local memory buffer.
+/// The entire reader content will be read upfront and stored in a local memory buffer, unless
+/// it is already directly accessible in memory.
 class Local_mdl_resource_reader
-  : public mi::base::Interface_implement<mi::mdl::IMDL_resource_reader>
+  : public mi::base::Interface_implement<mi::mdl::IMDL_mapped_resource_reader>
 {
 public:
     Local_mdl_resource_reader( mi::mdl::IMDL_resource_reader* other);
@@ -745,6 +753,8 @@ public:
 
     bool get_resource_hash( unsigned char hash[16]);
 
+    const unsigned char* get_mapped_data( mi::Uint64& size) const;
+
 private:
     mi::Uint64 m_size;
     mi::Uint64 m_position;
@@ -753,6 +763,12 @@ private:
     bool m_hash_valid;
     unsigned char m_hash[16];
     std::vector<char> m_data;
+
+    /// Keeps the data of \c other alive if it was not copied.
+    mi::base::Handle<mi::mdl::IMDL_mapped_resource_reader> m_mapped_reader;
+
+    /// Points to \c m_data or to the data of \c m_mapped_reader.
+    const unsigned char* m_view;
 };
 
 // We require a mutex per transaction. However, that is difficult to implement and we use a global
@@ -387,6 +387,36 @@ const IAnnotation_list* Mdl_function_definition::get_parameter_annotations() con
     return m_parameter_annotations.get();
 }
 
+namespace {
+
+/// Converts the body of the function at \p index if its conversion was deferred (see registry
+/// key "mdl_lazy_function_bodies"). This requires the imports of the module, which are dropped
+/// after the module was compiled.
+void convert_pending_function_body(
+    DB::Transaction* transaction,
+    const Mdl_module* module,
+    const mi::mdl::IGenerated_code_dag* code_dag,
+    mi::Size index)
+{
+    if( !code_dag->is_function_body_pending( index))
+        return;
+
+    std::unique_lock<std::mutex> lock( DETAIL::g_transaction_mutex);
+    SYSTEM::Access_module<MDLC::Mdlc_module> mdlc_module( false);
+    Module_cache module_cache( transaction, mdlc_module->get_module_wait_queue(), {});
+    mi::base::Handle<const mi::mdl::IModule> mdl_module( module->get_mdl_module());
+    if( !mdl_module->restore_import_entries( &module_cache)) {
+        LOG::mod_log->error( M_SCENE, LOG::Mod_log::C_DATABASE,
+            "Failed to restore imports of module \"%s\".", mdl_module->get_name());
+        return;
+    }
+    Drop_import_scope scope( mdl_module.get());
+
+    code_dag->get_function_body( index);
+}
+
+} // namespace
+
 const IExpression* Mdl_function_definition::get_body( DB::Transaction* transaction) const
 {
     DB::Tag module_tag = transaction->name_to_tag( m_module_db_name.c_str());
@@ -403,6 +433,9 @@ const IExpression* Mdl_function_definition::get_body( DB::Transaction* transacti
     ASSERT( M_SCENE, definition_index != ~mi::Size( 0));
 
     mi::base::Handle<const mi::mdl::IGenerated_code_dag> mdl_code_dag( module->get_code_dag());
+    if( !m_is_material)
+        convert_pending_function_body(
+            transaction, module.get_ptr(), mdl_code_dag.get(), definition_index);
     Code_dag code_dag( mdl_code_dag.get(), m_is_material);
     const mi::mdl::DAG_node* body = code_dag.get_body( definition_index);
     if( !body)
@@ -441,6 +474,9 @@ mi::Size Mdl_function_definition::get_temporary_count( DB::Transaction* transact
     ASSERT( M_SCENE, definition_index != ~mi::Size( 0));
 
     mi::base::Handle<const mi::mdl::IGenerated_code_dag> mdl_code_dag( module->get_code_dag());
+    if( !m_is_material)
+        convert_pending_function_body(
+            transaction, module.get_ptr(), mdl_code_dag.get(), definition_index);
     Code_dag code_dag( mdl_code_dag.get(), m_is_material);
     return code_dag.get_temporary_count( definition_index);
 }
@@ -462,6 +498,9 @@ const IExpression* Mdl_function_definition::get_temporary(
     ASSERT( M_SCENE, definition_index != ~mi::Size( 0));
 
     mi::base::Handle<const mi::mdl::IGenerated_code_dag> mdl_code_dag( module->get_code_dag());
+    if( !m_is_material)
+        convert_pending_function_body(
+            transaction, module.get_ptr(), mdl_code_dag.get(), definition_index);
     Code_dag code_dag( mdl_code_dag.get(), m_is_material);
     if( index >= code_dag.get_temporary_count( definition_index))
         return nullptr;
@@ -501,6 +540,9 @@ const char* Mdl_function_definition::get_temporary_name(
     ASSERT( M_SCENE, definition_index != ~mi::Size( 0));
 
     mi::base::Handle<const mi::mdl::IGenerated_code_dag> mdl_code_dag( module->get_code_dag());
+    if( !m_is_material)
+        convert_pending_function_body(
+            transaction, module.get_ptr(), mdl_code_dag.get(), definition_index);
     Code_dag code_dag( mdl_code_dag.get(), m_is_material);
     if( index >= code_dag.get_temporary_count( definition_index))
         return nullptr;
@@ -79,21 +79,6 @@ namespace MDL {
 
 namespace {
 
-/// Helper class for dropping module imports at destruction.
-class Drop_import_scope
-{
-public:
-    Drop_import_scope( const mi::mdl::IModule* module)
-      : m_module( module, mi::base::DUP_INTERFACE)
-    {
-    }
-
-    ~Drop_import_scope() { m_module->drop_import_entries(); }
-
-private:
-    mi::base::Handle<const mi::mdl::IModule> m_module;
-};
-
 class Module_loaded_callback : public mi::mdl::IModule_loaded_callback
 {
 public:
@@ -121,6 +106,9 @@ public:
     bool register_module(
         const mi::mdl::IModule* module) override
     {
+        // the MDL compiler might load imports on several threads, registration uses m_context
+        std::unique_lock<std::mutex> register_lock(m_register_mutex);
+
         const char* core_name = module->get_name();
 
         // special handling for built-in modules
@@ -137,6 +125,7 @@ public:
                            core_name), res));
             }
 
+            std::unique_lock<std::mutex> lock(DETAIL::g_transaction_mutex);
             m_registered_builtins.insert(core_name);
             return true;
         }
@@ -197,6 +186,7 @@ private:
     Module_cache* m_cache;
     Execution_context* m_context;
     std::set<std::string> m_registered_builtins;
+    std::mutex m_register_mutex;
 };
 
 }  // anonymous
@@ -563,6 +553,10 @@ mi::mdl::IGenerated_code_dag* generate_dag(
         options.set_option(MDL_CG_DAG_OPTION_TARGET_MATERIAL_MODE, "true");
     }
 
+    // Defer the conversion of function bodies until they are requested, if configured
+    if (mdlc_module->get_lazy_function_bodies())
+        options.set_option(MDL_CG_DAG_OPTION_LAZY_FUNCTION_BODIES, "true");
+
     {
         std::unique_lock<std::mutex> lock(DETAIL::g_transaction_mutex);
         Module_cache module_cache(transaction, mdlc_module->get_module_wait_queue(), {});
@@ -575,24 +569,41 @@ mi::mdl::IGenerated_code_dag* generate_dag(
     }
 
     Drop_import_scope scope(module);
-    mi::base::Handle<mi::mdl::IGenerated_code> code(generator_dag->compile(module));
-    if (!code.is_valid_interface()) {
-        context->set_result(-2);
-        return nullptr;
-    }
-    const mi::mdl::Messages& code_messages = code->access_messages();
-    convert_and_log_messages(code_messages, context);
 
-    // Treat error messages as compilation failures, e.g., "Call to non-exported function '...' is
-    // not allowed in this context".
-    if (code_messages.get_error_message_count() > 0) {
-        context->set_result(-2);
-        return nullptr;
+    // The module image cache keeps code DAGs before resource updates, the resource tags are
+    // specific to this database.
+    std::string options_key;
+    for (int i = 0, n = options.get_option_count(); i < n; ++i) {
+        const char* value = options.get_option_value(i);
+        options_key += options.get_option_name(i);
+        options_key += '=';
+        options_key += value ? value : "";
+        options_key += ';';
     }
 
-    ASSERT(M_SCENE, code->get_kind() == mi::mdl::IGenerated_code::CK_DAG);
     mi::base::Handle<mi::mdl::IGenerated_code_dag> code_dag(
-        code->get_interface<mi::mdl::IGenerated_code_dag>());
+        mdl->load_cached_code_dag(module, options_key.c_str()));
+    if (!code_dag) {
+        mi::base::Handle<mi::mdl::IGenerated_code> code(generator_dag->compile(module));
+        if (!code.is_valid_interface()) {
+            context->set_result(-2);
+            return nullptr;
+        }
+        const mi::mdl::Messages& code_messages = code->access_messages();
+        convert_and_log_messages(code_messages, context);
+
+        // Treat error messages as compilation failures, e.g., "Call to non-exported function
+        // '...' is not allowed in this context".
+        if (code_messages.get_error_message_count() > 0) {
+            context->set_result(-2);
+            return nullptr;
+        }
+
+        ASSERT(M_SCENE, code->get_kind() == mi::mdl::IGenerated_code::CK_DAG);
+        code_dag = code->get_interface<mi::mdl::IGenerated_code_dag>();
+
+        mdl->store_cached_code_dag(module, code_dag.get(), options_key.c_str());
+    }
 
     if (context->get_option<bool>(MDL_CTX_OPTION_RESOLVE_RESOURCES)) {
 
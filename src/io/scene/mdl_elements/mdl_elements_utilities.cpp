@@ -6629,12 +6629,17 @@ std::string Symbol_importer::stringify( const mi::mdl::IQualified_name* name)
 
 // **********  Mdl_module_wait_queue  **************************************************************
 
+Mdl_module_wait_queue::Loader_id Mdl_module_wait_queue::get_loader_id(const Module_cache* cache)
+{
+    return Loader_id(cache->get_loading_context_id(), std::this_thread::get_id());
+}
+
 Mdl_module_wait_queue::Entry::Entry(
     const std::string& name,
     const Module_cache* cache,
     Mdl_module_wait_queue::Table* parent_table)
     : m_core_name(name)
-    , m_cache_context_id(cache->get_loading_context_id())
+    , m_loader_id(Mdl_module_wait_queue::get_loader_id(cache))
     , m_handle(nullptr)
     , m_parent_table(parent_table)
     , m_usage_count(1 /* one for the creator */)
@@ -6705,7 +6710,7 @@ void Mdl_module_wait_queue::Entry::notify(
 // Check if this module is loaded by the current thread.
 bool Mdl_module_wait_queue::Entry::processed_in_current_context(const Module_cache* cache) const
 {
-    return m_cache_context_id == cache->get_loading_context_id();
+    return m_loader_id == Mdl_module_wait_queue::get_loader_id(cache);
 }
 
 // Increments the usage counter of the entry.
@@ -6791,7 +6796,7 @@ Mdl_module_wait_queue::Queue_lockup Mdl_module_wait_queue::lookup(
     const std::string& name)
 {
     std::unique_lock<std::mutex> lock(m_mutex);
-    Queue_lockup result{nullptr, nullptr};
+    Queue_lockup result{nullptr, nullptr, false};
 
     // check if the module is already in the cache
     result.cached_module = cache->lookup_db(name.c_str());
@@ -6820,12 +6825,43 @@ Mdl_module_wait_queue::Queue_lockup Mdl_module_wait_queue::lookup(
     if (created_entry || result.queue_entry->processed_in_current_context(cache))
         result.queue_entry = nullptr;
 
-    if (result.queue_entry != nullptr)
-        result.queue_entry->increment_usage_count();
+    if (result.queue_entry == nullptr)
+        return result;
+
+    // do not wait if the loading context waits (indirectly) for this context, e.g., for cyclic
+    // imports loaded on different threads
+    const Loader_id self = get_loader_id(cache);
+    Loader_id loader = result.queue_entry->get_loader_id();
+    for (;;) {
+        if (loader == self) {
+            result.queue_entry = nullptr;
+            result.is_cyclic = true;
+            return result;
+        }
+        auto found_waiting = m_waiting.find(loader);
+        if (found_waiting == m_waiting.end())
+            break;
+        loader = found_waiting->second;
+    }
+
+    // registered while the queue is locked, such that two contexts cannot wait for each other
+    m_waiting[self] = result.queue_entry->get_loader_id();
+    result.queue_entry->increment_usage_count();
 
     return result;
 }
 
+// Waits on an entry returned by lookup.
+mi::Sint32 Mdl_module_wait_queue::wait(const Module_cache* cache, Entry* entry)
+{
+    // the entry might self-destruct during wait, do not access it afterwards
+    mi::Sint32 result_code = entry->wait(cache);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_waiting.erase(get_loader_id(cache));
+    return result_code;
+}
+
 // Check if this module is loaded by the current thread.
 bool Mdl_module_wait_queue::processed_in_current_context(
     const Module_cache* cache,
@@ -7021,6 +7057,13 @@ const mi::mdl::IModule* Module_cache::lookup(
         return lookup.cached_module;
     }
 
+    // the loading context waits for this one, report a failure instead of a dead lock
+    if (lookup.is_cyclic)
+    {
+        handle_internal->set_is_processing(false);
+        return nullptr;
+    }
+
     // this thread is supposed to load the module, do not wait, start loading instead
     if (!lookup.queue_entry)
     {
@@ -7032,7 +7075,7 @@ const mi::mdl::IModule* Module_cache::lookup(
 
     // wait until the module is loaded
     // printf_s("[info] waiting for thread loading \"%s\"\n", module_name);
-    mi::Sint32 result_code = lookup.queue_entry->wait(this);
+    mi::Sint32 result_code = m_queue->wait(this, lookup.queue_entry);
 
     // loading thread reported success
     if (result_code >= 0)
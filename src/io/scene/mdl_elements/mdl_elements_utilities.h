@@ -674,6 +674,21 @@ private:
     bool m_has_cycle;
 };
 
+/// Helper class for dropping module imports at destruction.
+class Drop_import_scope
+{
+public:
+    Drop_import_scope( const mi::mdl::IModule* module)
+      : m_module( module, mi::base::DUP_INTERFACE)
+    {
+    }
+
+    ~Drop_import_scope() { m_module->drop_import_entries(); }
+
+private:
+    mi::base::Handle<const mi::mdl::IModule> m_module;
+};
+
 /// Loads the neuray module in the current transaction (if not already loaded).
 ///
 /// The side effect of this is that all standard modules including the builtins module are loaded
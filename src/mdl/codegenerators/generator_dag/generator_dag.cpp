@@ -247,6 +247,10 @@ Code_generator_dag::Code_generator_dag(
         MDL_CG_DAG_OPTION_TARGET_MATERIAL_MODE,
         "false",
         "Enable target mode compilation");
+    m_options.add_option(
+        MDL_CG_DAG_OPTION_LAZY_FUNCTION_BODIES,
+        "false",
+        "Convert function bodies on first access");
 }
 
 char const *Code_generator_dag::get_target_language() const
@@ -275,6 +279,9 @@ IGenerated_code_dag *Code_generator_dag::compile(IModule const *module)
     if (m_options.get_bool_option(MDL_CG_DAG_OPTION_TARGET_MATERIAL_MODE)) {
         options |= Generated_code_dag::TARGET_MATERIAL_MODEL_MODE;
     }
+    if (m_options.get_bool_option(MDL_CG_DAG_OPTION_LAZY_FUNCTION_BODIES)) {
+        options |= Generated_code_dag::LAZY_FUNCTION_BODIES;
+    }
 
     Generated_code_dag *result = m_builder.create<Generated_code_dag>(
         m_builder.get_allocator(),
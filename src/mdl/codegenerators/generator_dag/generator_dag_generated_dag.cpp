@@ -896,6 +896,9 @@ Generated_code_dag::Generated_code_dag(
 , m_needs_anno(false)
 , m_mark_generated((options & MARK_GENERATED_ENTITIES) != 0)
 , m_error_detected(false)
+, m_pending_module()
+, m_pending_body_count(0)
+, m_pending_lock()
 , m_resource_tag_map(alloc)
 , m_resource_tagger(m_resource_tag_map)
 {
@@ -1415,7 +1418,17 @@ void Generated_code_dag::compile_function(
         // convert the function body
         IExpression const *expr = get_single_expr_body(func_decl);
 
-        func.set_body(expr != NULL ? dag_builder.expr_to_dag(expr) : NULL);
+        IDeclaration_function const *fun_proto = as<IDeclaration_function>(proto_decl);
+        if (expr != NULL &&
+            (m_options & LAZY_FUNCTION_BODIES) != 0 &&
+            fun_proto != NULL && !fun_proto->is_preset())
+        {
+            // defer the conversion until the body is accessed for the first time
+            func.set_pending_body(expr, fun_proto, orig_module.get());
+            ++m_pending_body_count;
+        } else {
+            func.set_body(expr != NULL ? dag_builder.expr_to_dag(expr) : NULL);
+        }
 
         collect_callees(func, f_node);
     }
@@ -2182,6 +2195,11 @@ void Generated_code_dag::compile(IModule const *module)
     m_node_factory.identify_clear();
 
     m_error_detected |= dag_builder.error_state();
+
+    if (m_pending_body_count > 0) {
+        // keep the module alive until all deferred function bodies are converted
+        m_pending_module = mi::base::make_handle_dup(module);
+    }
 }
 
 // Helper function, adds a "hidden" annotation to a generated function.
@@ -2648,6 +2666,92 @@ void Generated_code_dag::build_function_temporaries(int func_index)
     walker.walk_function(this, func_index, &inserter);
 }
 
+// Get the lock protecting the state modified by deferred body conversions, if any.
+mi::base::Recursive_lock *Generated_code_dag::get_pending_lock() const
+{
+    return (m_options & LAZY_FUNCTION_BODIES) != 0 ? &m_pending_lock : NULL;
+}
+
+// Convert the body of a function whose conversion was deferred, if any.
+void Generated_code_dag::compile_pending_function_body(size_t func_index) const
+{
+    if ((m_options & LAZY_FUNCTION_BODIES) == 0) {
+        return;
+    }
+
+    mi::base::Recursive_lock::Block block(&m_pending_lock);
+
+    if (func_index >= m_functions.size() || !m_functions[func_index].is_body_pending()) {
+        return;
+    }
+
+    // the DAG builder resolves callees through the imports of the compiled module, these
+    // must be available (again) at this point
+    if (!m_pending_module->restore_import_entries(NULL)) {
+        return;
+    }
+
+    // converting the body lazily does not change the observable state of this code DAG, all
+    // readers of the modified state below hold the pending lock
+    Generated_code_dag *self = const_cast<Generated_code_dag *>(this);
+    Function_info      &func = self->m_functions[func_index];
+
+    IExpression const           *expr  = func.m_pending_body;
+    IDeclaration_function const *proto = func.m_pending_decl;
+    mi::base::Handle<IModule const> owner(func.m_pending_module);
+
+    func.m_pending_body = NULL;
+    func.m_pending_decl = NULL;
+    func.m_pending_module.reset();
+
+    {
+        DAG_builder dag_builder(get_allocator(), self->m_node_factory, self->m_mangler);
+
+        // the rest of the processing is done inside the owner module
+        Module_scope scope(dag_builder, owner.get());
+
+        dag_builder.reset();
+        for (size_t k = 0, n = proto->get_parameter_count(); k < n; ++k) {
+            dag_builder.make_accessible(proto->get_parameter(k));
+        }
+
+        func.set_body(dag_builder.expr_to_dag(expr));
+
+        MDL_ASSERT(dag_builder.get_errors().size() == 0 && "Unexpected errors compiling function");
+    }
+
+    self->build_function_temporaries(int(func_index));
+
+    // the body might reference entities that were not necessary for the eager parts
+    if (m_node_factory.needs_state_import()) {
+        self->add_import("::state");
+    }
+    if (m_node_factory.needs_nvidia_df_import()) {
+        self->add_import("::nvidia::df");
+    }
+
+    // restore the state after compile(): an empty CSE table
+    self->m_node_factory.identify_clear();
+
+    if (--m_pending_body_count == 0) {
+        m_pending_module.reset();
+    }
+}
+
+// Convert all function bodies whose conversion was deferred.
+void Generated_code_dag::compile_pending_function_bodies() const
+{
+    if ((m_options & LAZY_FUNCTION_BODIES) == 0) {
+        return;
+    }
+
+    mi::base::Recursive_lock::Block block(&m_pending_lock);
+
+    for (size_t i = 0, n = m_functions.size(); i < n && m_pending_body_count > 0; ++i) {
+        compile_pending_function_body(i);
+    }
+}
+
 // Get the kind of code generated.
 IGenerated_code::Kind Generated_code_dag::get_kind() const
 {
@@ -2676,6 +2780,9 @@ const char *Generated_code_dag::get_module_file_name() const
 // from which this code was generated.
 size_t Generated_code_dag::get_import_count() const
 {
+    // deferred body conversions might add imports
+    mi::base::Recursive_lock::Block block(get_pending_lock());
+
     return m_module_imports.size();
 }
 
@@ -2684,6 +2791,8 @@ size_t Generated_code_dag::get_import_count() const
 char const *Generated_code_dag::get_import(
     size_t index) const
 {
+    mi::base::Recursive_lock::Block block(get_pending_lock());
+
     if (index < m_module_imports.size()) {
         return m_module_imports[index].c_str();
     }
@@ -3092,6 +3201,11 @@ DAG_node const *Generated_code_dag::get_function_parameter_annotation(
 size_t Generated_code_dag::get_function_temporary_count(
     size_t function_index) const
 {
+    // hold the lock while reading, so the result cannot be observed half-converted
+    mi::base::Recursive_lock::Block block(get_pending_lock());
+
+    compile_pending_function_body(function_index);
+
     if (Function_info const *func = get_function_info(function_index)) {
         return func->get_temporary_count();
     }
@@ -3103,6 +3217,11 @@ DAG_node const *Generated_code_dag::get_function_temporary(
     size_t function_index,
     size_t temporary_index) const
 {
+    // hold the lock while reading, so the result cannot be observed half-converted
+    mi::base::Recursive_lock::Block block(get_pending_lock());
+
+    compile_pending_function_body(function_index);
+
     if (Function_info const *func = get_function_info(function_index)) {
         if (temporary_index < func->get_temporary_count()) {
             return func->get_temporary(temporary_index);
@@ -3116,6 +3235,11 @@ char const *Generated_code_dag::get_function_temporary_name(
     size_t function_index,
     size_t temporary_index) const
 {
+    // hold the lock while reading, so the result cannot be observed half-converted
+    mi::base::Recursive_lock::Block block(get_pending_lock());
+
+    compile_pending_function_body(function_index);
+
     if (Function_info const *func = get_function_info(function_index)) {
         if (temporary_index < func->get_temporary_count()) {
             return func->get_temporary_name(temporary_index);
@@ -3128,12 +3252,33 @@ char const *Generated_code_dag::get_function_temporary_name(
 DAG_node const *Generated_code_dag::get_function_body(
     size_t function_index) const
 {
+    // hold the lock while reading, so the result cannot be observed half-converted
+    mi::base::Recursive_lock::Block block(get_pending_lock());
+
+    compile_pending_function_body(function_index);
+
     if (Function_info const *func = get_function_info(function_index)) {
         return func->get_body();
     }
     return NULL;
 }
 
+// Check if the body of the function at function_index was not converted yet.
+bool Generated_code_dag::is_function_body_pending(
+    size_t function_index) const
+{
+    if ((m_options & LAZY_FUNCTION_BODIES) == 0) {
+        return false;
+    }
+
+    mi::base::Recursive_lock::Block block(get_pending_lock());
+
+    if (Function_info const *func = get_function_info(function_index)) {
+        return func->is_body_pending();
+    }
+    return false;
+}
+
 // Get the number of annotations of the material at material_index.
 size_t Generated_code_dag::get_material_annotation_count(
     size_t material_index) const
@@ -6573,6 +6718,11 @@ void Generated_code_dag::serialize(
     ISerializer           *serializer,
     MDL_binary_serializer *bin_serializer) const
 {
+    // deferred function bodies cannot be serialized, convert them now and keep other
+    // threads from converting bodies while the DAG is written
+    mi::base::Recursive_lock::Block block(get_pending_lock());
+    compile_pending_function_bodies();
+
     DAG_serializer dag_serializer(get_allocator(), serializer, bin_serializer);
 
     // mark the start of the DAG
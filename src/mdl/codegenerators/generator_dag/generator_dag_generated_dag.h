@@ -32,6 +32,7 @@
 #include <cstring>
 
 #include <mi/base/handle.h>
+#include <mi/base/lock.h>
 #include <mi/mdl/mdl_generated_dag.h>
 #include <mi/mdl/mdl_streams.h>
 #include <mi/mdl/mdl_printers.h>
@@ -129,6 +130,8 @@ public:
         EXPOSE_NAMES_OF_LET_EXPRESSIONS = 0x0010,
         /// If set, target material model compilation mode is used.
         TARGET_MATERIAL_MODEL_MODE      = 0x0020,
+        /// If set, function bodies are converted on first access.
+        LAZY_FUNCTION_BODIES            = 0x0040,
     };
 
     /// Bit set of compile options.
@@ -393,6 +396,9 @@ public:
         , m_temporaries(alloc)
         , m_temporary_names(alloc)
         , m_body(NULL)
+        , m_pending_body(NULL)
+        , m_pending_decl(NULL)
+        , m_pending_module()
         , m_refs(alloc)
         , m_hash()
         , m_properties(0u)
@@ -422,6 +428,21 @@ public:
         /// Set the material body.
         void set_body(DAG_node const *body) { m_body = body; }
 
+        /// Defer the conversion of the function body.
+        ///
+        /// \param expr        the single expression body of the function
+        /// \param proto_decl  the declaration providing the accessible parameters
+        /// \param owner       the module owning the function declaration
+        void set_pending_body(
+            IExpression const          *expr,
+            IDeclaration_function const *proto_decl,
+            IModule const              *owner)
+        {
+            m_pending_body   = expr;
+            m_pending_decl   = proto_decl;
+            m_pending_module = mi::base::make_handle_dup(owner);
+        }
+
         /// Set the function properties.
         void set_properties(unsigned props) { m_properties = props; }
 
@@ -482,6 +503,9 @@ public:
         /// Get the material body.
         DAG_node const *get_body() const { return m_body; }
 
+        /// Returns true if the conversion of the function body was deferred.
+        bool is_body_pending() const { return m_pending_body != NULL; }
+
         /// Get the references count.
         size_t get_ref_count() const { return m_refs.size(); }
 
@@ -507,6 +531,9 @@ public:
         Dag_vector            m_temporaries;     ///< The function temporaries.
         String_vector         m_temporary_names; ///< The function temporary names.
         DAG_node const        *m_body;           ///< The IR body of the function.
+        IExpression const     *m_pending_body;   ///< The not yet converted body or NULL.
+        IDeclaration_function const *m_pending_decl; ///< The prototype of the pending body.
+        mi::base::Handle<IModule const> m_pending_module; ///< The owner of the pending body.
         String_vector         m_refs;            ///< The references of a function.
         DAG_hash              m_hash;            ///< The function hash value.
         unsigned              m_properties;      ///< The property flags of this function.
@@ -1799,6 +1826,9 @@ public:
         mi::base::Uuid const &interface_id) const MDL_FINAL;
 
     /// Get the node IR-node factory of this code DAG.
+    ///
+    /// \note If function bodies are converted lazily, the factory is modified by the
+    ///       conversion; callers must not use it concurrently with the function body getters.
     DAG_node_factory_impl *get_node_factory() MDL_FINAL;
 
     /// Get the number of annotations of the function at function_index.
@@ -1890,6 +1920,13 @@ public:
     DAG_node const *get_function_body(
         size_t function_index) const MDL_FINAL;
 
+    /// Check if the body of the function at function_index was not converted yet.
+    ///
+    /// \param function_index      The index of the function.
+    /// \returns                   True if the body will be converted on the next access.
+    bool is_function_body_pending(
+        size_t function_index) const MDL_FINAL;
+
     /// Get the number of annotations of the material at material_index.
     /// \param material_index      The index of the material.
     /// \returns                   The number of annotations.
@@ -2683,6 +2720,25 @@ private:
     /// \param func_index  the index of the processed function
     void build_function_temporaries(int func_index);
 
+    /// Get the lock protecting the state modified by deferred body conversions.
+    ///
+    /// Converting a pending body modifies the function info, the node factory and the
+    /// imports of this code DAG. Every reader of this state must hold the returned lock.
+    ///
+    /// \returns the pending lock or NULL if function bodies are not converted lazily
+    mi::base::Recursive_lock *get_pending_lock() const;
+
+    /// Convert the body of a function whose conversion was deferred, if any.
+    ///
+    /// Does nothing if the body was already converted or if the import entries of the
+    /// compiled module are not available.
+    ///
+    /// \param func_index  the index of the function
+    void compile_pending_function_body(size_t func_index) const;
+
+    /// Convert all function bodies whose conversion was deferred.
+    void compile_pending_function_bodies() const;
+
     /// Add a material temporary.
     ///
     /// \param mat_index    The index of the material.
@@ -2989,6 +3045,16 @@ private:
     /// If true, an error was detected during construction.
     bool m_error_detected;
 
+    /// The compiled module, retained while function bodies are pending.
+    mutable mi::base::Handle<IModule const> m_pending_module;
+
+    /// The number of functions whose body conversion was deferred.
+    mutable size_t m_pending_body_count;
+
+    /// Protects the conversion of pending function bodies, recursive because the conversion
+    /// itself accesses the function body.
+    mutable mi::base::Recursive_lock m_pending_lock;
+
     typedef vector<Resource_tag_tuple>::Type Resource_tag_map;
 
     /// The resource tag map, mapping accessible resources to tags.
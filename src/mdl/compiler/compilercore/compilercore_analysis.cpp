@@ -35,9 +35,13 @@
 #include <cstring>
 
 #include <algorithm>
+#include <condition_variable>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <utility>
 #include <base/system/main/types.h>
+#include <base/data/thread_pool/i_thread_pool.h>
 
 #include <mi/mdl/mdl_translator_plugin.h>
 
@@ -1282,10 +1286,13 @@ class Imported_module_cache : public IModule_cache
 public:
     /// Constructor.
     ///
-    /// \param mod    the module whose import list should be looked up
-    /// \param cache  a higher level module cache or NULL
-    Imported_module_cache(Module const &mod, IModule_cache *cache)
-    : m_mod(mod), m_cache(cache)
+    /// \param mod               the module whose import list should be looked up
+    /// \param cache             a higher level module cache or NULL
+    /// \param use_import_table  if false, only the name of the module is checked (to detect
+    ///                          cyclic imports), used by preloader jobs: mod is then an empty
+    ///                          placeholder, never the module being analyzed concurrently
+    Imported_module_cache(Module const &mod, IModule_cache *cache, bool use_import_table = true)
+    : m_mod(mod), m_cache(cache), m_use_import_table(use_import_table)
     {
     }
 
@@ -1310,7 +1317,8 @@ public:
         IModule_cache_lookup_handle *cache_lookup_handle) const MDL_FINAL
     {
         bool direct;
-        Module const *imp_mod = m_mod.find_imported_module(absname, direct);
+        Module const *imp_mod =
+            m_use_import_table ? m_mod.find_imported_module(absname, direct) : NULL;
 
         if (imp_mod != NULL) {
             // reference count is not increased by find_imported_mode(), do it here
@@ -1344,10 +1352,301 @@ private:
 
     /// A higher level module cache or NULL.
     IModule_cache *m_cache;
+
+    /// If false, the import list of m_mod is not used.
+    bool m_use_import_table;
 };
 
 }  // anon namespace
 
+/// Loads the modules imported by a module on the shared thread pool while the module is analyzed.
+///
+/// The analysis takes a preloaded module when it reaches the corresponding import declaration
+/// and only blocks if the module is still being loaded. The modules are loaded by jobs of the
+/// shared thread pool. Loading the same module from several threads is serialized by the module
+/// cache.
+class Import_preloader {
+    /// A module to load by a job of the thread pool.
+    struct Task : public MI::THREAD_POOL::Job_base {
+        /// Constructor.
+        Task(
+            IAllocator       *alloc,
+            Import_preloader *preloader,
+            char const       *import_name,
+            Position const   *pos,
+            Thread_context   *ctx,
+            Module const     *cycle_marker,
+            IModule_cache    *cache)
+        : Job_base(1)
+        , preloader(preloader)
+        , import_name(import_name, alloc)
+        , pos(pos)
+        , ctx(ctx, mi::base::DUP_INTERFACE)
+        , cache(*cycle_marker, cache, /*use_import_table=*/false)
+        , result(NULL)
+        , abs_name(alloc)
+        , done(false)
+        {
+        }
+
+        /// Loads the module.
+        void execute_fragment(size_t /*index*/) MDL_FINAL
+        {
+            preloader->load(this);
+        }
+
+        /// Called by the thread pool after the module was loaded, the last access to the task.
+        void job_finished() MDL_FINAL
+        {
+            preloader->finish(this);
+        }
+
+        /// The preloader owning this task.
+        Import_preloader *preloader;
+
+        /// The name of the module as requested by the import declaration.
+        string import_name;
+
+        /// The position of the import declaration.
+        Position const *pos;
+
+        /// The thread context of the loading thread.
+        mi::base::Handle<Thread_context> ctx;
+
+        /// The module cache of the loading thread, reports the module being analyzed as the
+        /// not yet analyzed cycle marker.
+        Imported_module_cache cache;
+
+        /// The loaded module, owned by the task until taken.
+        Module const *result;
+
+        /// The absolute name of the loaded module.
+        string abs_name;
+
+        /// Set once the thread pool has finished the task.
+        bool done;
+    };
+
+    typedef list<Task *>::Type Task_list;
+
+public:
+    /// Constructor.
+    ///
+    /// \param compiler      the MDL compiler
+    /// \param module        the module whose imports are loaded
+    /// \param cache         the module cache of the analysis
+    /// \param vroot         the virtual root package of the analysis if any
+    /// \param max_threads   the maximum number of modules preloaded concurrently by the compiler
+    Import_preloader(
+        MDL           *compiler,
+        Module        *module,
+        IModule_cache *cache,
+        char const    *vroot,
+        int           max_threads)
+    : m_builder(module->get_allocator())
+    , m_compiler(compiler)
+    , m_module(*module)
+    , m_cycle_marker(compiler->create_module(
+        module->get_name(), module->get_filename(), module->get_mdl_version(),
+        Module::MF_STANDARD))
+    , m_pool(MI::THREAD_POOL::get_shared_thread_pool())
+    , m_cache(cache)
+    , m_vroot(vroot != NULL ? vroot : "", module->get_allocator())
+    , m_has_vroot(vroot != NULL)
+    , m_max_threads(max_threads)
+    , m_tasks(module->get_allocator())
+    , m_mutex()
+    , m_cond()
+    {
+    }
+
+    /// Destructor, waits for all tasks.
+    ~Import_preloader()
+    {
+        for (Task_list::iterator it(m_tasks.begin()), end(m_tasks.end()); it != end; ++it) {
+            Task *task = *it;
+            wait(task);
+            if (task->result != NULL) {
+                task->result->release();
+            }
+            m_builder.destroy(task);
+        }
+        m_cycle_marker->release();
+    }
+
+    /// Check if a module is already preloaded.
+    ///
+    /// \param import_name  the name of the module as requested by the import declaration
+    bool is_preloaded(char const *import_name) const
+    {
+        return find_task(import_name) != NULL;
+    }
+
+    /// Start loading a module by a job of the thread pool.
+    ///
+    /// \param import_name  the name of the module as requested by the import declaration
+    /// \param pos          the position of the import declaration
+    /// \param ctx          the thread context to be used by the job
+    ///
+    /// \return false if the maximum number of modules is already being preloaded
+    bool start(char const *import_name, Position const *pos, Thread_context *ctx)
+    {
+        if (!m_compiler->acquire_import_thread(m_max_threads)) {
+            return false;
+        }
+
+        Task *task = m_builder.create<Task>(
+            m_builder.get_allocator(), this, import_name, pos, ctx, m_cycle_marker, m_cache);
+        m_tasks.push_back(task);
+
+        m_pool->submit(task);
+        return true;
+    }
+
+    /// Take a preloaded module, waits until it is loaded.
+    ///
+    /// \param import_name  the name of the module as requested by the import declaration
+    /// \param abs_name     the absolute name of the module as resolved by the analysis
+    /// \param ctx          the thread context of the analysis
+    ///
+    /// \return the module (with increased reference count) or NULL if it was not preloaded or
+    ///         failed to load
+    Module const *take(char const *import_name, char const *abs_name, Thread_context &ctx)
+    {
+        Task *task = find_task(import_name);
+        if (task == NULL) {
+            return NULL;
+        }
+
+        wait(task);
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        Module const *mod = task->result;
+        task->result = NULL;
+        if (mod != NULL && task->abs_name != abs_name) {
+            // resolved differently, should not happen
+            mod->release();
+            mod = NULL;
+        }
+        if (mod != NULL) {
+            // the compile time of the import is not part of the time of the current module
+            ctx.add_module_load_time(task->ctx->get_module_load_time());
+        }
+        return mod;
+    }
+
+private:
+    /// Find the task of a module.
+    Task *find_task(char const *import_name) const
+    {
+        for (Task_list::const_iterator it(m_tasks.begin()), end(m_tasks.end()); it != end; ++it) {
+            if ((*it)->import_name == import_name) {
+                return *it;
+            }
+        }
+        return NULL;
+    }
+
+    /// Wait until a task is done.
+    ///
+    /// If called from a job of the thread pool, e.g., the analysis of a module preloaded itself,
+    /// the pool is notified such that it can execute other jobs, in particular this task.
+    void wait(Task *task)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (task->done) {
+            return;
+        }
+        m_pool->suspend_current_job();
+        while (!task->done) {
+            m_cond.wait(lock);
+        }
+        m_pool->resume_current_job();
+    }
+
+    /// Resolve and compile a module, runs as job of the thread pool.
+    void load(Task *task)
+    {
+        // messages of the resolver are reported by the analysis, which resolves the name again
+        Messages_impl messages(m_builder.get_allocator(), m_module.get_filename());
+        File_resolver resolver(
+            *m_compiler,
+            m_cache,
+            m_compiler->get_external_resolver(),
+            m_compiler->get_search_path(),
+            m_compiler->get_search_path_lock(),
+            messages,
+            task->ctx->get_front_path(),
+            m_has_vroot ? m_vroot.c_str() : NULL);
+
+        mi::base::Handle<IMDL_import_result> import_result(m_compiler->resolve_import(
+            resolver,
+            task->import_name.c_str(),
+            &m_module,
+            task->pos,
+            task->ctx.get()));
+
+        Module const *mod = NULL;
+        if (import_result.is_valid_interface()) {
+            mod = m_compiler->compile_module(*task->ctx.get(), *import_result.get(), &task->cache);
+        }
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        task->result = mod;
+        if (import_result.is_valid_interface()) {
+            task->abs_name = import_result->get_absolute_name();
+        }
+        m_compiler->release_import_thread();
+    }
+
+    /// Mark a task as done, the task might be destroyed as soon as the lock is released.
+    void finish(Task *task)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        task->done = true;
+        m_cond.notify_all();
+    }
+
+private:
+    /// The builder for tasks.
+    Allocator_builder m_builder;
+
+    /// The MDL compiler.
+    MDL *m_compiler;
+
+    /// The module whose imports are loaded.
+    Module &m_module;
+
+    /// An empty module with the name of m_module that is never analyzed. Returned to the jobs if
+    /// they try to import m_module again, which reports the cyclic import without passing the
+    /// module being analyzed to another thread.
+    Module *m_cycle_marker;
+
+    /// The thread pool executing the tasks.
+    std::shared_ptr<MI::THREAD_POOL::Thread_pool> m_pool;
+
+    /// The module cache of the analysis.
+    IModule_cache *m_cache;
+
+    /// The virtual root package of the analysis.
+    string m_vroot;
+
+    /// True, if the analysis has a virtual root package.
+    bool m_has_vroot;
+
+    /// The maximum number of modules preloaded concurrently.
+    int m_max_threads;
+
+    /// The tasks, only modified by the analysis thread.
+    Task_list m_tasks;
+
+    /// Protects the results of the tasks.
+    std::mutex m_mutex;
+
+    /// Signaled when a task is done.
+    std::condition_variable m_cond;
+};
+
 /* --------------------------------- Analysis ---------------------------------- */
 
 // Enter an imported definition.
@@ -2659,6 +2958,7 @@ NT_analysis::NT_analysis(
 , m_has_array_assignment(module.get_mdl_version() >= IMDL::MDL_VERSION_1_3)
 , m_has_auto_return(false)
 , m_module_cache(cache)
+, m_import_preloader(NULL)
 , m_annotated_def(NULL)
 , m_deduced_type(NULL)
 , m_next_param_idx(0)
@@ -2679,6 +2979,14 @@ NT_analysis::NT_analysis(
 {
 }
 
+// Destructor.
+NT_analysis::~NT_analysis()
+{
+    if (m_import_preloader != NULL) {
+        m_builder.destroy(m_import_preloader);
+    }
+}
+
 // Returns the definition of a symbol at the at a given scope.
 Definition *NT_analysis::get_definition_at_scope(ISymbol const *sym, Scope *scope) const
 {
@@ -3449,12 +3757,15 @@ static bool is_empty(char const *s)
     return s == NULL || s[0] == '\0';
 }
 
-// Find and load a module to import.
-Module const *NT_analysis::load_module_to_import(
+// Compute the name of a module to import as passed to the resolver.
+string NT_analysis::get_import_module_name(
     IQualified_name const *rel_name,
-    bool                  ignore_last)
+    bool                  ignore_last,
+    bool                  &is_absolute,
+    bool                  &is_weak,
+    bool                  &is_weak_16)
 {
-    bool is_absolute = rel_name->is_absolute();
+    is_absolute = rel_name->is_absolute();
 
     string import_name(is_absolute ? "::" : "", m_builder.get_allocator());
 
@@ -3489,8 +3800,8 @@ Module const *NT_analysis::load_module_to_import(
         import_name += sym->get_name();
     }
 
-    bool is_weak    = false;
-    bool is_weak_16 = false;
+    is_weak    = false;
+    is_weak_16 = false;
 
     // from MDL 1.6 weak imports do not exists
     if (!is_absolute && import_name[0] != '.') {
@@ -3509,6 +3820,138 @@ Module const *NT_analysis::load_module_to_import(
         }
     }
 
+    return import_name;
+}
+
+// Start loading the modules imported by the current module by jobs of the shared thread pool.
+void NT_analysis::preload_imports()
+{
+    int max_threads = m_compiler->get_compiler_int_option(
+        &m_ctx, MDL::option_parallel_import_threads, /*def_value=*/0);
+    if (max_threads <= 0 || m_module_cache == NULL) {
+        return;
+    }
+
+    // relative imports are checked for pre 1.3 restrictions during the analysis
+    if (m_module.get_mdl_version() < IMDL::MDL_VERSION_1_3) {
+        return;
+    }
+
+    // namespace aliases are entered during the analysis, skip imports that might use them
+    typedef ptr_hash_set<ISymbol const>::Type Symbol_set;
+    Symbol_set aliases(0, Symbol_set::hasher(), Symbol_set::key_equal(), get_allocator());
+
+    typedef vector<std::pair<IQualified_name const *, bool> >::Type Name_vec;
+    Name_vec names(get_allocator());
+
+    for (int i = 0, n = m_module.get_declaration_count(); i < n; ++i) {
+        IDeclaration const *decl = m_module.get_declaration(i);
+
+        if (IDeclaration_namespace_alias const *alias_decl =
+                as<IDeclaration_namespace_alias>(decl)) {
+            aliases.insert(alias_decl->get_alias()->get_symbol());
+        } else if (IDeclaration_import const *import_decl = as<IDeclaration_import>(decl)) {
+            if (IQualified_name const *mod_name = import_decl->get_module_name()) {
+                // using <mod_name> import ..
+                names.push_back(std::make_pair(mod_name, /*ignore_last=*/false));
+            } else {
+                // import ...
+                for (int j = 0, m = import_decl->get_name_count(); j < m; ++j) {
+                    IQualified_name const *qname = import_decl->get_name(j);
+                    if (qname->get_component_count() > 1) {
+                        names.push_back(std::make_pair(qname, /*ignore_last=*/true));
+                    }
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0, n = names.size(); i < n; ++i) {
+        IQualified_name const *rel_name    = names[i].first;
+        bool                  ignore_last = names[i].second;
+
+        if (is_error(rel_name)) {
+            continue;
+        }
+
+        bool uses_alias = false;
+        for (int j = 0, m = rel_name->get_component_count(); j < m; ++j) {
+            if (aliases.find(rel_name->get_component(j)->get_symbol()) != aliases.end()) {
+                uses_alias = true;
+                break;
+            }
+        }
+        if (uses_alias) {
+            continue;
+        }
+
+        bool is_absolute = false;
+        bool is_weak     = false;
+        bool is_weak_16  = false;
+
+        string import_name(
+            get_import_module_name(rel_name, ignore_last, is_absolute, is_weak, is_weak_16));
+
+        // weak imports prior to MDL 1.6 might be resolved twice
+        if (is_weak && !is_weak_16) {
+            continue;
+        }
+
+        if (is_absolute) {
+            // built-in modules are always available, foreign modules are translated
+            if (m_compiler->find_builtin_module(import_name) != NULL ||
+                m_compiler->is_foreign_module(import_name.c_str()) != NULL)
+            {
+                continue;
+            }
+
+            // already loaded
+            mi::base::Handle<IModule const> cached(
+                m_module_cache->lookup(import_name.c_str(), NULL));
+            if (cached.is_valid_interface()) {
+                continue;
+            }
+        }
+
+        if (m_import_preloader == NULL) {
+            m_import_preloader = m_builder.create<Import_preloader>(
+                m_compiler,
+                &m_module,
+                m_module_cache,
+                m_ctx.get_virtual_root_package(),
+                max_threads);
+        } else if (m_import_preloader->is_preloaded(import_name.c_str())) {
+            continue;
+        }
+
+        mi::base::Handle<Thread_context> ctx(
+            m_compiler->create_thread_context(
+                *this, m_ctx.get_front_path(), m_ctx.get_user_data()));
+
+        if (!m_import_preloader->start(
+                import_name.c_str(), &rel_name->access_position(), ctx.get()))
+        {
+            // too many modules are preloaded already, load the remaining imports during the analysis
+            break;
+        }
+    }
+}
+
+// Find and load a module to import.
+Module const *NT_analysis::load_module_to_import(
+    IQualified_name const *rel_name,
+    bool                  ignore_last)
+{
+    bool is_absolute = false;
+    bool is_weak     = false;
+    bool is_weak_16  = false;
+
+    string import_name(
+        get_import_module_name(rel_name, ignore_last, is_absolute, is_weak, is_weak_16));
+
+    // the name as requested, the resolver might change import_name below
+    string const requested_name(import_name);
+
     IMDL_foreign_module_translator *translator = is_absolute ?
         m_compiler->is_foreign_module(import_name.c_str()) : NULL;
 
@@ -3603,7 +4046,12 @@ Module const *NT_analysis::load_module_to_import(
 
     Imported_module_cache cache(m_module, m_module_cache);
 
-    {
+    if (m_import_preloader != NULL && translator == NULL) {
+        // wait for the module if it is loaded by a preloader job
+        imp_mod = m_import_preloader->take(requested_name.c_str(), abs_name, m_ctx);
+    }
+
+    if (imp_mod == NULL) {
         // Create a new context here: we don't want the compilation errors to be appended
         // to the current context.
         mi::base::Handle<Thread_context> ctx(
@@ -3617,6 +4065,9 @@ Module const *NT_analysis::load_module_to_import(
             // compile this (already resolved) module
             imp_mod = m_compiler->compile_module(*ctx.get(), *import_result.get(), &cache);
         }
+
+        // the compile time of the import is not part of the time of the current module
+        m_ctx.add_module_load_time(ctx->get_module_load_time());
     }
 
     if (imp_mod == NULL) {
@@ -16372,10 +16823,19 @@ void NT_analysis::run()
             string("::<builtins>", get_allocator())));
 
         visit_material_default(*this);
+
+        // start loading the imports while the declarations before them are analyzed
+        preload_imports();
     }
 
     visit(&m_module);
 
+    // all imports are processed, release modules that were not taken
+    if (m_import_preloader != NULL) {
+        m_builder.destroy(m_import_preloader);
+        m_import_preloader = NULL;
+    }
+
     // leave global scope
     m_def_tab->leave_scope();
 
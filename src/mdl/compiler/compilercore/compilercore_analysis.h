@@ -65,6 +65,7 @@ class Dependence_graph;
 class Messages_impl;
 class Err_location;
 class Thread_context;
+class Import_preloader;
 
 struct Resource_table_key;
 
@@ -969,6 +970,28 @@ private:
         Module const   *imp_mod,
         Position const &pos);
 
+    /// Compute the name of a module to import as passed to the resolver.
+    ///
+    /// \param rel_name       the (relative) name of the module
+    /// \param ignore_last    if true, the last simple name of the rel_name
+    ///                       is not part of the module name
+    /// \param is_absolute    set to true if the name is absolute
+    /// \param is_weak        set to true for a weak import
+    /// \param is_weak_16     set to true for a weak import in MDL 1.6 or later
+    string get_import_module_name(
+        IQualified_name const *rel_name,
+        bool                  ignore_last,
+        bool                  &is_absolute,
+        bool                  &is_weak,
+        bool                  &is_weak_16);
+
+    /// Start loading the modules imported by the current module by jobs of the shared thread pool.
+    ///
+    /// Does nothing unless the option MDL::option_parallel_import_threads is set. Imports using
+    /// namespace aliases, pre MDL 1.6 weak imports and foreign modules are loaded during the
+    /// analysis only.
+    void preload_imports();
+
     /// Find and load a module to if possible.
     ///
     /// \param rel_name       the (relative) name of the module
@@ -1984,6 +2007,9 @@ public:
         Thread_context   &ctx,
         IModule_cache    *cache);
 
+    /// Destructor.
+    ~NT_analysis();
+
 private:
     /// The currently processed "preset-overload".
     IExpression_call const *m_preset_overload;
@@ -2046,6 +2072,9 @@ private:
     /// The current module cache.
     IModule_cache *m_module_cache;
 
+    /// The preloader of imported modules if any.
+    Import_preloader *m_import_preloader;
+
     /// The current annotated definition.
     Definition *m_annotated_def;
 
@@ -1260,6 +1260,9 @@ bool Archive_builder::create_zip_archive()
 
     set_archive_name(arc_name);
 
+    // an open container would keep the old file alive
+    MDL_zip_container_cache::remove(arc_name.c_str());
+
     // create the writable stream
     zip_error_t ze;
     zip_source_t *src = zip_source_file_create(arc_name.c_str(), 0, -1, &ze);
@@ -1559,6 +1562,9 @@ void Archive_extractor::extract(
 
     set_archive_name(arc_name);
 
+    // an open container would keep the old file alive
+    MDL_zip_container_cache::remove(arc_name.c_str());
+
     // create the the stream
     zip_error_t ze;
     zip_error_init(&ze);
@@ -2125,6 +2131,16 @@ MDL_zip_container_archive *MDL_zip_container_archive::open(
     MDL_zip_container_error_code  &err,
     bool                          with_manifest)
 {
+    // only containers with a parsed manifest are shared, parsing it later is not thread-safe
+    if (with_manifest) {
+        if (MDL_zip_container *c = MDL_zip_container_cache::lookup(
+            alloc, path, header_supported_read_version.prefix))
+        {
+            err = EC_OK;
+            return static_cast<MDL_zip_container_archive *>(c);
+        }
+    }
+
     MDL_zip_container_header header_info = header_supported_read_version;
     zip_t* za = MDL_zip_container::open(alloc, path, err, header_info);
 
@@ -2170,6 +2186,10 @@ MDL_zip_container_archive *MDL_zip_container_archive::open(
     }
 
     archiv->m_header = header_info;
+
+    if (with_manifest) {
+        MDL_zip_container_cache::insert(archiv);
+    }
     return archiv;
 }
 
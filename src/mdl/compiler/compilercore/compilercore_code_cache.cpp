@@ -29,8 +29,17 @@
 #include "pch.h"
 
 #include "compilercore_code_cache.h"
+#include "compilercore_file_utils.h"
 
 #include <cstdint>
+#include <cstdio>
+#include <algorithm>
+
+#include <mi/base/miwindows.h>
+
+#ifndef MI_PLATFORM_WINDOWS
+#include <unistd.h>
+#endif
 
 namespace mi {
 namespace mdl {
@@ -102,6 +111,7 @@ Code_cache::Cache_entry::Cache_entry(
             }
 
             cur_info->arg_block_index = entry.func_infos[i].arg_block_index;
+            cur_info->state_usage     = entry.func_infos[i].state_usage;
 
             cur_info->num_df_handles = entry.func_infos[i].num_df_handles;
             if (cur_info->num_df_handles == 0) {
@@ -140,29 +150,254 @@ Code_cache::Cache_entry::~Cache_entry()
 }
 
 
+namespace {
+
+/// The magic number of disk tier entries ("MDCC").
+static uint32_t const DISK_MAGIC = 0x4343444du;
+
+/// The version of the disk tier entry format. Increase if the layout changes.
+static uint32_t const DISK_FORMAT_VERSION = 1u;
+
+/// The file extension of disk tier entries.
+static char const DISK_EXTENSION[] = ".mdlcc";
+
+/// Low water mark of the disk tier in percent of the maximum size used after eviction.
+static size_t const DISK_LOW_WATER_PERCENT = 90u;
+
+/// Helper class to write the disk tier format into a byte vector.
+class Blob_writer {
+public:
+    /// Constructor.
+    explicit Blob_writer(vector<char>::Type &blob) : m_blob(blob) {}
+
+    /// Write raw data.
+    void write(void const *data, size_t size)
+    {
+        char const *p = static_cast<char const *>(data);
+        m_blob.insert(m_blob.end(), p, p + size);
+    }
+
+    /// Write an unsigned 32bit value.
+    void write_u32(uint32_t v) { write(&v, sizeof(v)); }
+
+    /// Write an unsigned 64bit value.
+    void write_u64(uint64_t v) { write(&v, sizeof(v)); }
+
+    /// Write a size prefixed data block.
+    void write_block(char const *data, size_t size)
+    {
+        write_u64(size);
+        if (size > 0)
+            write(data, size);
+    }
+
+    /// Write a string.
+    void write_string(char const *s)
+    {
+        write_block(s, strlen(s));
+    }
+
+private:
+    vector<char>::Type &m_blob;
+};
+
+/// Helper class to read the disk tier format from a byte vector with bounds checks.
+class Blob_reader {
+public:
+    /// Constructor.
+    Blob_reader(char const *data, size_t size)
+    : m_data(data), m_size(size), m_pos(0), m_ok(true)
+    {
+    }
+
+    /// Read raw data, returns a pointer into the blob or NULL on error.
+    char const *read(size_t size)
+    {
+        if (!m_ok || size > m_size - m_pos) {
+            m_ok = false;
+            return NULL;
+        }
+        char const *p = m_data + m_pos;
+        m_pos += size;
+        return p;
+    }
+
+    /// Read an unsigned 32bit value.
+    uint32_t read_u32()
+    {
+        uint32_t v = 0;
+        if (char const *p = read(sizeof(v)))
+            memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    /// Read an unsigned 64bit value.
+    uint64_t read_u64()
+    {
+        uint64_t v = 0;
+        if (char const *p = read(sizeof(v)))
+            memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    /// Read a size prefixed data block.
+    char const *read_block(size_t &size)
+    {
+        uint64_t s = read_u64();
+        if (!m_ok || s > m_size - m_pos) {
+            m_ok = false;
+            size = 0;
+            return NULL;
+        }
+        size = size_t(s);
+        return read(size);
+    }
+
+    /// Read a string into the given storage.
+    char const *read_string(string &res)
+    {
+        size_t size = 0;
+        char const *p = read_block(size);
+        if (p == NULL)
+            res.clear();
+        else
+            res.assign(p, size);
+        return res.c_str();
+    }
+
+    /// Returns true if no error occurred so far.
+    bool ok() const { return m_ok; }
+
+    /// Returns true if the whole blob was consumed.
+    bool at_end() const { return m_pos == m_size; }
+
+private:
+    char const *m_data;
+    size_t     m_size;
+    size_t     m_pos;
+    bool       m_ok;
+};
+
+/// Read a whole file into a byte vector.
+static bool read_file(
+    IAllocator         *alloc,
+    char const         *path,
+    vector<char>::Type &data)
+{
+    FILE *f = fopen_utf8(alloc, path, "rb");
+    if (f == NULL)
+        return false;
+
+    bool res = false;
+    if (fseek(f, 0, SEEK_END) == 0) {
+        long size = ftell(f);
+        if (size > 0 && fseek(f, 0, SEEK_SET) == 0) {
+            data.resize(size_t(size));
+            res = fread(data.data(), 1, data.size(), f) == data.size();
+        }
+    }
+    fclose(f);
+    return res;
+}
+
+/// A file of the disk tier, used for eviction.
+struct Disk_file {
+    /// Constructor.
+    Disk_file(string const &name, size_t size, long long mtime)
+    : name(name), size(size), mtime(mtime)
+    {
+    }
+
+    string    name;
+    size_t    size;
+    long long mtime;
+
+    bool operator<(Disk_file const &other) const
+    {
+        return mtime < other.mtime;
+    }
+};
+
+}  // anonymous
+
 // Lookup a data blob.
 Code_cache::Entry const *Code_cache::lookup(unsigned char const key[16]) const
 {
-    mi::base::Lock::Block block(&m_cache_lock);
+    {
+        mi::base::Lock::Block block(&m_cache_lock);
+
+        Search_map::const_iterator it = m_search_map.find(Key(key));
+        if (it != m_search_map.end()) {
+            // found
+            Cache_entry *p = it->second;
+            to_front(*p);
+            ++m_stats.memory_hits;
+            return p;
+        }
+        if (!has_disk_tier()) {
+            ++m_stats.misses;
+            return NULL;
+        }
+    }
+
+    // not in memory, try the disk tier without holding the cache lock
+    return lookup_disk(key);
+}
+
+// Enter a data blob.
+bool Code_cache::enter(unsigned char const key[16], Entry const &entry)
+{
+    {
+        mi::base::Lock::Block block(&m_cache_lock);
+
+        enter_memory(key, entry);
+    }
+
+    if (has_disk_tier()) {
+        // write through to the disk tier, outside the cache lock
+        vector<char>::Type blob(get_allocator());
+        serialize_entry(key, entry, blob);
+
+        if (blob.size() <= m_max_disk_size && write_disk(key, blob)) {
+            mi::base::Lock::Block block(&m_cache_lock);
+            ++m_stats.disk_writes;
+        }
+    }
+    return true;
+}
+
+// Retrieve the statistics of this cache.
+void Code_cache::get_statistics(Statistics &stats) const
+{
+    {
+        mi::base::Lock::Block block(&m_cache_lock);
+
+        stats = m_stats;
+        stats.memory_size = m_curr_size;
+    }
+    {
+        mi::base::Lock::Block block(&m_disk_lock);
+
+        stats.disk_size = m_curr_disk_size;
+    }
+}
 
+// Enter an entry into the memory tier.
+Code_cache::Cache_entry *Code_cache::enter_memory(
+    unsigned char const               key[16],
+    mi::mdl::ICode_cache::Entry const &entry) const
+{
     Search_map::const_iterator it = m_search_map.find(Key(key));
     if (it != m_search_map.end()) {
-        // found
+        // already entered, possibly by another thread
         Cache_entry *p = it->second;
         to_front(*p);
         return p;
     }
-    return NULL;
-}
-
-// Enter a data blob.
-bool Code_cache::enter(unsigned char const key[16], Entry const &entry)
-{
-    mi::base::Lock::Block block(&m_cache_lock);
 
     // don't try to enter it if it doesn't fit into the cache at all
     if (entry.get_cache_data_size() > m_max_size)
-        return false;
+        return NULL;
 
     m_curr_size += entry.get_cache_data_size();
     strip_size();
@@ -170,13 +405,14 @@ bool Code_cache::enter(unsigned char const key[16], Entry const &entry)
     Cache_entry *res = new_entry(entry, key);
 
     m_search_map.insert(Search_map::value_type(res->m_key, res));
-    return true;
+    return res;
 }
 
 // Create a new entry and put it in front.
 // Assumes that current size has already been updated.
 Code_cache::Cache_entry *Code_cache::new_entry(
-    mi::mdl::ICode_cache::Entry const &entry, unsigned char const key[16])
+    mi::mdl::ICode_cache::Entry const &entry,
+    unsigned char const               key[16]) const
 {
     Allocator_builder builder(get_allocator());
 
@@ -220,7 +456,7 @@ void Code_cache::to_front(Cache_entry &entry) const
 }
 
 // Drop entries from the end until size is reached.
-void Code_cache::strip_size()
+void Code_cache::strip_size() const
 {
     Allocator_builder builder(get_allocator());
 
@@ -238,10 +474,317 @@ void Code_cache::strip_size()
     }
 }
 
+// Get the file name of the disk tier entry for the given key.
+string Code_cache::get_disk_file_name(unsigned char const key[16]) const
+{
+    static char const hex[] = "0123456789abcdef";
+
+    char name[2 * 16 + sizeof(DISK_EXTENSION)];
+    for (size_t i = 0; i < 16; ++i) {
+        name[2 * i]     = hex[key[i] >> 4];
+        name[2 * i + 1] = hex[key[i] & 15];
+    }
+    memcpy(&name[2 * 16], DISK_EXTENSION, sizeof(DISK_EXTENSION));
+
+    return join_path(m_disk_path, string(name, get_allocator()));
+}
+
+// Serialize an entry into the disk tier format.
+void Code_cache::serialize_entry(
+    unsigned char const               key[16],
+    mi::mdl::ICode_cache::Entry const &entry,
+    vector<char>::Type                &blob) const
+{
+    blob.reserve(entry.get_cache_data_size() + 64 + m_version_tag.size());
+
+    Blob_writer w(blob);
+
+    // header
+    w.write_u32(DISK_MAGIC);
+    w.write_u32(DISK_FORMAT_VERSION);
+    w.write_block(m_version_tag.c_str(), m_version_tag.size());
+    w.write(key, 16);
+
+    // payload
+    w.write_block(entry.code, entry.code_size);
+    w.write_block(entry.const_seg, entry.const_seg_size);
+    w.write_block(entry.arg_layout, entry.arg_layout_size);
+    w.write_u32(entry.render_state_usage);
+
+    w.write_u64(entry.mapped_string_size);
+    for (size_t i = 0; i < entry.mapped_string_size; ++i) {
+        w.write_string(entry.mapped_strings[i]);
+    }
+
+    w.write_u64(entry.func_info_size);
+    for (size_t i = 0; i < entry.func_info_size; ++i) {
+        Entry::Func_info const &info = entry.func_infos[i];
+
+        w.write_string(info.name);
+        w.write_u32(uint32_t(info.dist_kind));
+        w.write_u32(uint32_t(info.func_kind));
+        for (int j = 0; j < int(mi::mdl::IGenerated_code_executable::PL_NUM_LANGUAGES); ++j) {
+            w.write_string(info.prototypes[j]);
+        }
+        w.write_u64(info.arg_block_index);
+        w.write_u32(info.state_usage);
+        w.write_u64(info.num_df_handles);
+        for (size_t j = 0; j < info.num_df_handles; ++j) {
+            w.write_string(info.df_handles[j]);
+        }
+    }
+}
+
+// Load an entry from the disk tier and enter it into the memory tier.
+Code_cache::Cache_entry const *Code_cache::lookup_disk(unsigned char const key[16]) const
+{
+    IAllocator *alloc = get_allocator();
+
+    string fname(get_disk_file_name(key));
+
+    vector<char>::Type data(alloc);
+    bool found = read_file(alloc, fname.c_str(), data);
+
+    Blob_reader r(data.data(), data.size());
+
+    if (found) {
+        found =
+            r.read_u32() == DISK_MAGIC &&
+            r.read_u32() == DISK_FORMAT_VERSION;
+    }
+    if (found) {
+        // entries produced by a different version are treated as misses and overwritten later
+        size_t tag_size = 0;
+        char const *tag = r.read_block(tag_size);
+        found =
+            r.ok() &&
+            tag_size == m_version_tag.size() &&
+            memcmp(tag, m_version_tag.c_str(), tag_size) == 0;
+    }
+    if (found) {
+        char const *file_key = r.read(16);
+        found = file_key != NULL && memcmp(file_key, key, 16) == 0;
+    }
+
+    if (!found) {
+        mi::base::Lock::Block block(&m_cache_lock);
+        ++m_stats.misses;
+        return NULL;
+    }
+
+    Entry::Func_info empty_info;
+    memset(&empty_info, 0, sizeof(empty_info));
+
+    size_t code_size = 0, const_seg_size = 0, arg_layout_size = 0;
+    char const *code       = r.read_block(code_size);
+    char const *const_seg  = r.read_block(const_seg_size);
+    char const *arg_layout = r.read_block(arg_layout_size);
+    unsigned render_state_usage = r.read_u32();
+
+    // every string needs at least its size prefix, so this bounds the counts
+    size_t n_strings = size_t(std::min<uint64_t>(r.read_u64(), data.size() / 8));
+    vector<string>::Type mapped_string_data(n_strings, string(alloc), alloc);
+    Small_VLA<char const *, 8> mapped_strings(alloc, n_strings);
+    for (size_t i = 0; i < n_strings; ++i) {
+        mapped_strings[i] = r.read_string(mapped_string_data[i]);
+    }
+
+    size_t n_infos = size_t(std::min<uint64_t>(r.read_u64(), data.size() / 8));
+    size_t const n_langs = size_t(mi::mdl::IGenerated_code_executable::PL_NUM_LANGUAGES);
+    vector<string>::Type info_string_data(alloc);
+    vector<size_t>::Type info_handle_counts(n_infos, size_t(0), alloc);
+    Small_VLA<Entry::Func_info, 8> func_infos(alloc, n_infos);
+
+    // first pass: read all strings, the pointers are fixed up afterwards because the
+    // string vector might be reallocated
+    for (size_t i = 0; i < n_infos && r.ok(); ++i) {
+        Entry::Func_info &info = func_infos[i];
+        info = empty_info;
+
+        info_string_data.push_back(string(alloc));
+        r.read_string(info_string_data.back());
+        info.dist_kind =
+            mi::mdl::IGenerated_code_executable::Distribution_kind(r.read_u32());
+        info.func_kind =
+            mi::mdl::IGenerated_code_executable::Function_kind(r.read_u32());
+        for (size_t j = 0; j < n_langs; ++j) {
+            info_string_data.push_back(string(alloc));
+            r.read_string(info_string_data.back());
+        }
+        info.arg_block_index = size_t(r.read_u64());
+        info.state_usage     = r.read_u32();
+
+        size_t n_handles = size_t(std::min<uint64_t>(r.read_u64(), data.size() / 8));
+        info_handle_counts[i] = n_handles;
+        for (size_t j = 0; j < n_handles && r.ok(); ++j) {
+            info_string_data.push_back(string(alloc));
+            r.read_string(info_string_data.back());
+        }
+    }
+
+    if (!r.ok() || !r.at_end()) {
+        // truncated or otherwise broken file, drop it
+        remove_file_utf8(alloc, fname.c_str());
+
+        mi::base::Lock::Block block(&m_cache_lock);
+        ++m_stats.misses;
+        return NULL;
+    }
+
+    size_t n_total_handles = 0;
+    for (size_t i = 0; i < n_infos; ++i) {
+        n_total_handles += info_handle_counts[i];
+    }
+
+    // for simplicity, allocate at least one element
+    Small_VLA<char const *, 8> handle_list(alloc, n_total_handles > 0 ? n_total_handles : 1);
+
+    size_t str_idx = 0, handle_idx = 0;
+    for (size_t i = 0; i < n_infos; ++i) {
+        Entry::Func_info &info = func_infos[i];
+
+        info.name = info_string_data[str_idx++].c_str();
+        for (size_t j = 0; j < n_langs; ++j) {
+            info.prototypes[j] = info_string_data[str_idx++].c_str();
+        }
+        info.num_df_handles = info_handle_counts[i];
+        info.df_handles     = &handle_list[handle_idx];
+        for (size_t j = 0; j < info.num_df_handles; ++j) {
+            handle_list[handle_idx++] = info_string_data[str_idx++].c_str();
+        }
+    }
+
+    Entry entry(
+        code, code_size,
+        const_seg, const_seg_size,
+        arg_layout, arg_layout_size,
+        mapped_strings.data(), n_strings,
+        render_state_usage,
+        func_infos.data(), n_infos);
+
+    // keep the disk tier LRU ordered by modification time
+    touch_file_utf8(alloc, fname.c_str());
+
+    mi::base::Lock::Block block(&m_cache_lock);
+
+    Cache_entry *res = enter_memory(key, entry);
+    if (res == NULL) {
+        // does not fit into the memory tier
+        ++m_stats.misses;
+        return NULL;
+    }
+    ++m_stats.disk_hits;
+    return res;
+}
+
+// Write a serialized entry to the disk tier.
+bool Code_cache::write_disk(unsigned char const key[16], vector<char>::Type const &blob)
+{
+    IAllocator *alloc = get_allocator();
+
+    string fname(get_disk_file_name(key));
+
+    unsigned counter = 0;
+    {
+        mi::base::Lock::Block block(&m_disk_lock);
+        counter = m_tmp_counter++;
+    }
+
+    // the temporary name must be unique across all processes sharing the directory
+    char suffix[64];
+    snprintf(suffix, sizeof(suffix), ".%lu.%u.tmp", get_process_id(), counter);
+    string tmp_name(fname);
+    tmp_name += suffix;
+
+    FILE *f = fopen_utf8(alloc, tmp_name.c_str(), "wb");
+    if (f == NULL)
+        return false;
+
+    bool ok = fwrite(blob.data(), 1, blob.size(), f) == blob.size();
+    ok = fclose(f) == 0 && ok;
+
+    if (!ok || !rename_file_utf8(alloc, tmp_name.c_str(), fname.c_str())) {
+        remove_file_utf8(alloc, tmp_name.c_str());
+        return false;
+    }
+
+    bool need_strip = false;
+    {
+        mi::base::Lock::Block block(&m_disk_lock);
+        m_curr_disk_size += blob.size();
+        need_strip = m_curr_disk_size > m_max_disk_size;
+    }
+    if (need_strip)
+        strip_disk_size();
+    return true;
+}
+
+// Drop the oldest files from the disk tier until its size is below the limit.
+void Code_cache::strip_disk_size()
+{
+    IAllocator *alloc = get_allocator();
+
+    // other processes write into the same directory, so rescan it to get the real size
+    vector<Disk_file>::Type files(alloc);
+    size_t total_size = 0;
+
+    Directory dir(alloc);
+    if (!dir.open(m_disk_path.c_str()))
+        return;
+
+    size_t const ext_len = sizeof(DISK_EXTENSION) - 1;
+    for (;;) {
+        char const *name = dir.read();
+        if (dir.eof() || name == NULL)
+            break;
+
+        size_t len = strlen(name);
+        if (len <= ext_len || strcmp(name + len - ext_len, DISK_EXTENSION) != 0)
+            continue;
+
+        string    fname(join_path(m_disk_path, string(name, alloc)));
+        size_t    size  = 0;
+        long long mtime = 0;
+        if (!get_file_info_utf8(alloc, fname.c_str(), size, mtime))
+            continue;
+
+        total_size += size;
+        files.push_back(Disk_file(fname, size, mtime));
+    }
+    dir.close();
+
+    size_t low_water = m_max_disk_size / 100u * DISK_LOW_WATER_PERCENT;
+    size_t n_evicted = 0;
+
+    if (total_size > m_max_disk_size) {
+        std::sort(files.begin(), files.end());
+
+        for (size_t i = 0, n = files.size(); i < n && total_size > low_water; ++i) {
+            // removal might fail if another process just removed or reads the file
+            if (remove_file_utf8(alloc, files[i].name.c_str())) {
+                total_size -= files[i].size;
+                ++n_evicted;
+            }
+        }
+    }
+
+    {
+        mi::base::Lock::Block block(&m_disk_lock);
+        m_curr_disk_size = total_size;
+    }
+    if (n_evicted > 0) {
+        mi::base::Lock::Block block(&m_cache_lock);
+        m_stats.disk_evictions += n_evicted;
+    }
+}
+
 // Constructor.
 Code_cache::Code_cache(
     IAllocator *alloc,
-    size_t     max_size)
+    size_t     max_size,
+    char const *disk_path,
+    size_t     max_disk_size,
+    char const *version_tag)
 : Base(alloc)
 , m_cache_lock()
 , m_head(NULL)
@@ -249,7 +792,23 @@ Code_cache::Code_cache(
 , m_search_map(Search_map::key_compare(), alloc)
 , m_max_size(max_size)
 , m_curr_size(0)
+, m_disk_path(alloc)
+, m_version_tag(version_tag != NULL ? version_tag : "", alloc)
+, m_max_disk_size(max_disk_size)
+, m_curr_disk_size(0)
+, m_tmp_counter(0)
+, m_disk_lock()
 {
+    memset(&m_stats, 0, sizeof(m_stats));
+
+    if (disk_path != NULL && disk_path[0] != '\0' && max_disk_size > 0) {
+        if (is_directory_utf8(alloc, disk_path) || mkdir_utf8(alloc, disk_path)) {
+            m_disk_path = disk_path;
+
+            // determine the initial size of the disk tier and evict if it is too big
+            strip_disk_size();
+        }
+    }
 }
 
 // Destructor.
@@ -106,10 +106,21 @@ public:
     // Enter a data blob.
     bool enter(unsigned char const key[16], Entry const &entry) MDL_FINAL;
 
+    // Retrieve the statistics of this cache.
+    void get_statistics(Statistics &stats) const MDL_FINAL;
+
 private:
     /// Create a new entry and put it in front.
     /// Assumes that current size has already been updated.
-    Cache_entry *new_entry(mi::mdl::ICode_cache::Entry const &entry, unsigned char const key[16]);
+    Cache_entry *new_entry(
+        mi::mdl::ICode_cache::Entry const &entry,
+        unsigned char const               key[16]) const;
+
+    /// Enter an entry into the memory tier.
+    /// Assumes that the cache lock is held.
+    Cache_entry *enter_memory(
+        unsigned char const               key[16],
+        mi::mdl::ICode_cache::Entry const &entry) const;
 
     /// Remove an entry from the list.
     void remove_from_list(Cache_entry &entry) const;
@@ -124,17 +135,65 @@ private:
     }
 
     // Drop entries from the end until size is reached.
-    void strip_size();
+    void strip_size() const;
+
+    /// Get the file name of the disk tier entry for the given key.
+    string get_disk_file_name(unsigned char const key[16]) const;
+
+    /// Serialize an entry into the disk tier format.
+    ///
+    /// \param key    the key of the entry
+    /// \param entry  the entry to serialize
+    /// \param blob   the serialized data
+    void serialize_entry(
+        unsigned char const               key[16],
+        mi::mdl::ICode_cache::Entry const &entry,
+        vector<char>::Type                &blob) const;
+
+    /// Load an entry from the disk tier and enter it into the memory tier.
+    ///
+    /// \param key  the key of the entry
+    ///
+    /// \return the new memory tier entry or NULL if the disk tier does not contain the key
+    Cache_entry const *lookup_disk(unsigned char const key[16]) const;
+
+    /// Write a serialized entry to the disk tier.
+    ///
+    /// The entry is written into a temporary file first which is then atomically renamed,
+    /// so concurrent readers in other processes never observe partially written entries.
+    ///
+    /// \param key   the key of the entry
+    /// \param blob  the serialized entry
+    ///
+    /// \return true on success
+    bool write_disk(unsigned char const key[16], vector<char>::Type const &blob);
+
+    /// Drop the oldest files from the disk tier until its size is below the limit.
+    void strip_disk_size();
 
 public:
     /// Constructor.
+    ///
+    /// \param alloc          the allocator
+    /// \param max_size       the maximum size of the memory tier in bytes
+    /// \param disk_path      if non-NULL and non-empty, the UTF8 encoded path of the directory
+    ///                       holding the persistent disk tier; it is created if necessary
+    /// \param max_disk_size  the maximum size of the disk tier in bytes
+    /// \param version_tag    a string identifying the producer of the cached code; disk tier
+    ///                       entries with a different tag are ignored
     Code_cache(
         IAllocator *alloc,
-        size_t     max_size);
+        size_t     max_size,
+        char const *disk_path = NULL,
+        size_t     max_disk_size = 0,
+        char const *version_tag = NULL);
 
     /// Destructor.
     virtual ~Code_cache();
 
+    /// Returns true if this cache has a disk tier.
+    bool has_disk_tier() const { return !m_disk_path.empty(); }
+
 private:
     mutable mi::base::Lock m_cache_lock;
 
@@ -150,7 +209,28 @@ private:
     size_t m_max_size;
 
     /// Current size.
-    size_t m_curr_size;
+    mutable size_t m_curr_size;
+
+    /// The directory of the disk tier, empty if disabled.
+    string m_disk_path;
+
+    /// The version tag written into and checked for all disk tier entries.
+    string m_version_tag;
+
+    /// Maximum size of the disk tier.
+    size_t m_max_disk_size;
+
+    /// Current (estimated) size of the disk tier, protected by m_disk_lock.
+    size_t m_curr_disk_size;
+
+    /// Counter to create unique temporary file names, protected by m_disk_lock.
+    unsigned m_tmp_counter;
+
+    /// Lock for the disk tier bookkeeping.
+    mutable mi::base::Lock m_disk_lock;
+
+    /// Statistics, protected by m_cache_lock.
+    mutable Statistics m_stats;
 };
 
 }  // mdl
@@ -63,6 +63,13 @@ MDL_zip_container_mdle *MDL_zip_container_mdle::open(
     char const                   *path,
     MDL_zip_container_error_code &err)
 {
+    if (MDL_zip_container *c = MDL_zip_container_cache::lookup(
+        alloc, path, header_supported_read_version.prefix))
+    {
+        err = EC_OK;
+        return static_cast<MDL_zip_container_mdle *>(c);
+    }
+
     MDL_zip_container_header header_info = header_supported_read_version;
     zip_t* za = MDL_zip_container::open(alloc, path, err, header_info);
 
@@ -75,6 +82,10 @@ MDL_zip_container_mdle *MDL_zip_container_mdle::open(
     MDL_zip_container_mdle *mdle = builder.create<MDL_zip_container_mdle>(alloc, path, za);
     if (mdle != NULL) {
         mdle->m_header = header_info;
+
+        if (err == EC_OK) {
+            MDL_zip_container_cache::insert(mdle);
+        }
     }
     return mdle;
 }
@@ -478,6 +489,10 @@ bool Encapsulate_tool::create_encapsulated_module(
     // create the writable stream
     zip_error_t ze;
     string file_path = join_path(string(dest_path, get_allocator()), file_name);
+
+    // an open container would keep the old file alive
+    MDL_zip_container_cache::remove(file_path.c_str());
+
     zip_source_t *src = zip_source_file_create(file_path.c_str(), 0, -1, &ze);
     if (src == NULL) {
         translate_zip_error(mdle_name, ze);
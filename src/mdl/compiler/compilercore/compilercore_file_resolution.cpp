@@ -301,10 +301,10 @@ File_resource_reader::~File_resource_reader()
 
 namespace {
 
-/// Implementation of the IInput_stream interface using FILE I/O.
-class Simple_file_input_stream : public Allocator_interface_implement<IInput_stream>
+/// Implementation of the IBlock_input_stream interface using FILE I/O.
+class Simple_file_input_stream : public Allocator_interface_implement<IBlock_input_stream>
 {
-    typedef Allocator_interface_implement<IInput_stream> Base;
+    typedef Allocator_interface_implement<IBlock_input_stream> Base;
 public:
     /// Constructor.
     ///
@@ -335,6 +335,13 @@ public:
         return fgetc(m_file->get_file());
     }
 
+    /// Read a block of characters from the input stream.
+    /// \returns    The number of characters read, 0 at the end of the stream.
+    size_t read(char *buffer, size_t size) MDL_FINAL
+    {
+        return fread(buffer, 1, size, m_file->get_file());
+    }
+
     /// Get the name of the file on which this input stream operates.
     /// \returns    The name of the file or null if the stream does not operate on a file.
     char const *get_filename() MDL_FINAL
@@ -492,6 +499,191 @@ static char const *get_string_based_prefix()
 #endif // MI_PLATFORM_WINDOWS
 }
 
+// Constructor.
+File_resolution_cache::File_resolution_cache(IAllocator *alloc)
+: m_alloc(alloc)
+, m_lock()
+, m_entries(0, Entry_map::hasher(), Entry_map::key_equal(), alloc)
+, m_nr_negative_entries(0)
+, m_archive_indexes(0, Archive_index_map::hasher(), Archive_index_map::key_equal(), alloc)
+, m_generations(0, Generation_map::hasher(), Generation_map::key_equal(), alloc)
+, m_epoch(0)
+, m_stats()
+{
+}
+
+// Get the generation of a set of search paths.
+unsigned File_resolution_cache::get_search_path_generation(
+    String_vec const &paths,
+    String_vec const &resource_paths)
+{
+    // '\n' cannot be part of a path, use it as separator
+    string key(m_alloc);
+    for (size_t i = 0, n = paths.size(); i < n; ++i) {
+        key.append(paths[i]);
+        key.append('\n');
+    }
+    key.append('\n');
+    for (size_t i = 0, n = resource_paths.size(); i < n; ++i) {
+        key.append(resource_paths[i]);
+        key.append('\n');
+    }
+
+    mi::base::Lock::Block block(&m_lock);
+
+    Generation_map::const_iterator it(m_generations.find(key));
+    if (it != m_generations.end()) {
+        return it->second;
+    }
+    unsigned generation = unsigned(m_generations.size());
+    m_generations.insert(Generation_map::value_type(key, generation));
+    return generation;
+}
+
+// Lookup a result.
+bool File_resolution_cache::lookup(
+    string const &key,
+    string       &result,
+    size_t       &epoch)
+{
+    mi::base::Lock::Block block(&m_lock);
+
+    ++m_stats.m_lookups;
+    epoch = m_epoch;
+
+    Entry_map::const_iterator it(m_entries.find(key));
+    if (it == m_entries.end()) {
+        return false;
+    }
+    ++m_stats.m_hits;
+    m_stats.m_fs_calls_saved += it->second.m_fs_calls;
+    result = it->second.m_result;
+    return true;
+}
+
+// Insert a result.
+void File_resolution_cache::insert(
+    size_t       epoch,
+    string const &key,
+    string const &result,
+    size_t       fs_calls)
+{
+    mi::base::Lock::Block block(&m_lock);
+
+    m_stats.m_fs_calls += fs_calls;
+
+    // the result might be outdated, if the cache was invalidated while it was computed
+    if (epoch != m_epoch) {
+        return;
+    }
+
+    if (result.empty()) {
+        // files might have been added meanwhile, do not keep too many negative results
+        if (m_nr_negative_entries >= MAX_NEGATIVE_ENTRIES) {
+            drop_negative_entries();
+        }
+        if (m_entries.insert(Entry_map::value_type(key, Entry(result, fs_calls))).second) {
+            ++m_nr_negative_entries;
+        }
+    } else {
+        m_entries.insert(Entry_map::value_type(key, Entry(result, fs_calls)));
+    }
+}
+
+// Drop all cached negative results.
+void File_resolution_cache::drop_negative_entries()
+{
+    for (Entry_map::iterator it(m_entries.begin()); it != m_entries.end();) {
+        if (it->second.m_result.empty()) {
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    m_nr_negative_entries = 0;
+    ++m_stats.m_negative_flushes;
+}
+
+// Get the names of all archives (without the ".mdr" extension) in a search root.
+bool File_resolution_cache::get_archives(
+    string const &root,
+    String_vec   &archives,
+    size_t       &fs_calls)
+{
+    size_t epoch = 0;
+    {
+        mi::base::Lock::Block block(&m_lock);
+
+        ++m_stats.m_lookups;
+        epoch = m_epoch;
+
+        Archive_index_map::const_iterator it(m_archive_indexes.find(root));
+        if (it != m_archive_indexes.end()) {
+            ++m_stats.m_hits;
+            ++m_stats.m_fs_calls_saved;
+            archives = it->second.m_archives;
+            return it->second.m_exists;
+        }
+    }
+
+    // list the root without holding the lock
+    Archive_index index(m_alloc, false);
+
+    ++fs_calls;
+    Directory dir(m_alloc);
+    if (dir.open(root.c_str(), "*.mdr")) {
+        index.m_exists = true;
+
+        for (char const *entry = dir.read(); entry != NULL; entry = dir.read()) {
+            string e(entry, m_alloc);
+            size_t l = e.size();
+
+            if (l < 5) {
+                continue;
+            }
+            if (e[l - 4] != '.' || e[l - 3] != 'm' || e[l - 2] != 'd' || e[l - 1] != 'r') {
+                continue;
+            }
+
+            // remove .mdr
+            index.m_archives.push_back(e.substr(0, l - 4));
+        }
+        dir.close();
+    }
+
+    {
+        mi::base::Lock::Block block(&m_lock);
+
+        ++m_stats.m_fs_calls;
+        if (epoch == m_epoch) {
+            m_archive_indexes.insert(Archive_index_map::value_type(root, index));
+        }
+    }
+
+    archives = index.m_archives;
+    return index.m_exists;
+}
+
+// Drop all cached results.
+void File_resolution_cache::invalidate()
+{
+    mi::base::Lock::Block block(&m_lock);
+
+    ++m_epoch;
+    ++m_stats.m_invalidations;
+    m_entries.clear();
+    m_nr_negative_entries = 0;
+    m_archive_indexes.clear();
+}
+
+// Get the statistics.
+File_resolution_cache::Statistics File_resolution_cache::get_statistics() const
+{
+    mi::base::Lock::Block block(&m_lock);
+
+    return m_stats;
+}
+
 // Constructor.
 File_resolver::File_resolver(
     MDL const                                &mdl,
@@ -521,6 +713,9 @@ File_resolver::File_resolver(
 , m_last_msg_idx(0)
 , m_pathes_read(false)
 , m_resolving_resource(false)
+, m_cache(mdl.get_file_resolution_cache())
+, m_search_path_generation(0)
+, m_fs_calls(0)
 {
 }
 
@@ -681,6 +876,7 @@ bool File_resolver::archive_contains(
     bool res = false;
 
     MDL_zip_container_error_code err = EC_OK;
+    ++m_fs_calls;
     if (MDL_zip_container_archive *archive = MDL_zip_container_archive::open(
         m_alloc, archive_name, err, false))
     {
@@ -705,6 +901,7 @@ bool File_resolver::archive_contains_mask(
     bool res = false;
 
     MDL_zip_container_error_code err = EC_OK;
+    ++m_fs_calls;
     if (MDL_zip_container_archive *archive = MDL_zip_container_archive::open(
         m_alloc, archive_name, err, false))
     {
@@ -1278,6 +1475,7 @@ bool File_resolver::is_killed(
     dir_path.append(os_separator());
     dir_path.append(package);
 
+    ++m_fs_calls;
     if (is_directory_utf8(m_alloc, dir_path.c_str())) {
         error(
             ARCHIVE_CONFLICT,
@@ -1381,12 +1579,9 @@ bool File_resolver::is_killed(
     return false;
 }
 
-// Search the given path in all MDL search paths and return the complete path if found
-string File_resolver::search_mdl_path(
-    char const *file_mask,
-    bool       in_resource_path,
-    char const *front_path,
-    bool       file_mask_is_regex)
+// Read the MDL search paths and resource paths, if not done yet.
+void File_resolver::read_search_paths(
+    char const *front_path)
 {
     // Calls to IMDL_search_path are not thread-safe.
     // Ensure that at least this compiler will serialize it.
@@ -1424,10 +1619,54 @@ string File_resolver::search_mdl_path(
                         convert_slashes_to_os_separators(string(path, m_alloc)));
                 }
             }
+
+            m_search_path_generation =
+                m_cache.get_search_path_generation(m_paths, m_resource_paths);
         }
         m_pathes_read = true;
     }
+}
+
+// Search the given path in all MDL search paths and return the complete path if found
+string File_resolver::search_mdl_path(
+    char const *file_mask,
+    bool       in_resource_path,
+    char const *front_path,
+    bool       file_mask_is_regex)
+{
+    read_search_paths(front_path);
+
+    string key(m_alloc);
+    char buf[32];
+    snprintf(buf, sizeof(buf), "S%u%c%c:",
+        m_search_path_generation, in_resource_path ? 'r' : 'm', file_mask_is_regex ? 'x' : 'f');
+    key.append(buf);
+    key.append(file_mask);
+
+    string result(m_alloc);
+    size_t epoch = 0;
+    if (m_cache.lookup(key, result, epoch)) {
+        return result;
+    }
+
+    size_t n_msgs     = m_msgs.get_message_count();
+    size_t n_fs_calls = m_fs_calls;
+
+    result = search_mdl_path_uncached(file_mask, in_resource_path, file_mask_is_regex);
+
+    // do not cache results that issued messages, these must be reported again
+    if (m_msgs.get_message_count() == n_msgs) {
+        m_cache.insert(epoch, key, result, m_fs_calls - n_fs_calls);
+    }
+    return result;
+}
 
+// Search the given path in all MDL search paths without using the resolution cache.
+string File_resolver::search_mdl_path_uncached(
+    char const *file_mask,
+    bool       in_resource_path,
+    bool       file_mask_is_regex)
+{
     // the archive name ('.' separators)
     string archive_path = to_archive(file_mask);
 
@@ -1448,8 +1687,8 @@ string File_resolver::search_mdl_path(
         m_killed_packages.clear();
 
         if (!in_resource_path) {
-            Directory dir(m_alloc);
-            if (!dir.open(path, "*.mdr")) {
+            String_vec root_archives(m_alloc);
+            if (!m_cache.get_archives(*it, root_archives, m_fs_calls)) {
                 // directory does not exist
                 continue;
             }
@@ -1457,19 +1696,8 @@ string File_resolver::search_mdl_path(
             String_map archives(String_map::key_compare(), get_allocator());
 
             // collect all archives first for the KILL test
-            for (char const *entry = dir.read(); entry != NULL; entry = dir.read()) {
-                string e(entry, m_alloc);
-                size_t l = e.size();
-
-                if (l < 5) {
-                    continue;
-                }
-                if (e[l - 4] != '.' || e[l - 3] != 'm' || e[l - 2] != 'd' || e[l - 1] != 'r') {
-                    continue;
-                }
-
-                // remove .mdr
-                archives.insert(String_map::value_type(e.substr(0, l - 4), true));
+            for (size_t i = 0, n = root_archives.size(); i < n; ++i) {
+                archives.insert(String_map::value_type(root_archives[i], true));
             }
 
             // search for archives
@@ -1517,7 +1745,6 @@ string File_resolver::search_mdl_path(
                     }
                 }
             }
-            dir.close();
         }
 
         // no archives
@@ -1525,6 +1752,7 @@ string File_resolver::search_mdl_path(
         if (!file_mask_is_regex) {
             string joined_file_name = join_path(string(path, m_alloc), string(file_mask, m_alloc));
             if (!is_killed(file_mask)) {
+                ++m_fs_calls;
                 if (is_file_utf8(m_alloc, joined_file_name.c_str())) {
                     places.push_back(convert_slashes_to_os_separators(joined_file_name));
                     ++n_places;
@@ -1532,6 +1760,7 @@ string File_resolver::search_mdl_path(
             }
         } else {
             if (!is_killed(file_mask)) {
+                ++m_fs_calls;
                 if (has_file_utf8(m_alloc, path, file_mask)) {
                     string joined_file_mask = join_path(
                         string(path, m_alloc), string(file_mask, m_alloc));
@@ -1582,6 +1811,33 @@ bool File_resolver::file_exists(
     char const *fname,
     bool       is_regex) const
 {
+    string key(is_regex ? "Px:" : "Pf:", m_alloc);
+    key.append(fname);
+
+    string result(m_alloc);
+    size_t epoch = 0;
+    if (m_cache.lookup(key, result, epoch)) {
+        return !result.empty();
+    }
+
+    size_t n_fs_calls = m_fs_calls;
+    bool   res        = file_exists_uncached(fname, is_regex);
+
+    // negative results are cached as empty strings
+    if (res) {
+        result = "1";
+    }
+    m_cache.insert(epoch, key, result, m_fs_calls - n_fs_calls);
+    return res;
+}
+
+// Check if the given file name (UTF8 encoded) names a file on the file system or inside
+// an archive without using the resolution cache.
+bool File_resolver::file_exists_uncached(
+    char const *fname,
+    bool       is_regex) const
+{
+    ++m_fs_calls;
     char const *p_archive = strstr(fname, ".mdr:");
     char const *p_mdle = (p_archive == NULL) ? strstr(fname, ".mdle:") : NULL;
 
@@ -2401,6 +2657,12 @@ bool File_resolver::exists(
 // Read a memory block from the resource.
 Uint64 Buffered_archive_resource_reader::read(void *ptr, Uint64 size)
 {
+    size_t view_size = 0;
+    if (m_file->get_container_file()->get_view_data(view_size) != NULL) {
+        // reading from a mapped container is a plain copy, buffering would only add another one
+        return m_file->get_container_file()->read(ptr, size);
+    }
+
     // first, empty the buffer
     size_t prefix_size = m_buf_size - m_curr_pos;
     if (prefix_size > 0) {
@@ -2455,7 +2717,7 @@ bool Buffered_archive_resource_reader::seek(Sint64 offset, Position origin)
     m_curr_pos = m_buf_size = 0;
 
     // now seek
-    return m_file->get_container_file()->seek(offset, origin) != 0;
+    return m_file->get_container_file()->seek(offset, origin) == 0;
 }
 
 // Get the UTF8 encoded name of the resource on which this reader operates.
@@ -127,6 +127,172 @@ private:
     unsigned char udim_mode;
 };
 
+/// Caches the results of file resolution, shared by all file resolvers of a compiler.
+///
+/// Searches in the MDL search paths are keyed by the search path generation (an id of the set of
+/// search paths in effect), the kind of the search and the file mask. Probes of resolved file
+/// names (on the file system or inside archives) are keyed by the name. Both positive and
+/// negative results are cached. Results whose computation issued messages (conflicts, broken
+/// archives) are not cached, so these messages are reported by every resolution.
+///
+/// Changes of the search paths are detected by the generation, changes of the file system are
+/// not: these require an explicit invalidate(). Since files might be added while the compiler is
+/// running, at most MAX_NEGATIVE_ENTRIES negative results are kept; all of them are dropped if
+/// this limit is reached.
+class File_resolution_cache {
+    typedef vector<string>::Type String_vec;
+
+public:
+    /// The maximum number of cached negative results.
+    static size_t const MAX_NEGATIVE_ENTRIES = 4096;
+
+    /// Statistics of the cache.
+    ///
+    /// The MDL SDK integration logs them when the MDLC module shuts down.
+    struct Statistics {
+        size_t m_lookups;           ///< Number of lookups.
+        size_t m_hits;              ///< Number of lookups answered by the cache.
+        size_t m_fs_calls;          ///< Number of file system calls done to fill the cache.
+        size_t m_fs_calls_saved;    ///< Number of file system calls saved by cache hits.
+        size_t m_invalidations;     ///< Number of invalidations.
+        size_t m_negative_flushes;  ///< Number of times the negative results were dropped.
+
+        /// Constructor.
+        Statistics()
+        : m_lookups(0)
+        , m_hits(0)
+        , m_fs_calls(0)
+        , m_fs_calls_saved(0)
+        , m_invalidations(0)
+        , m_negative_flushes(0)
+        {
+        }
+    };
+
+    /// Get the generation of a set of search paths.
+    ///
+    /// \param paths           the MDL search paths
+    /// \param resource_paths  the MDL resource paths
+    unsigned get_search_path_generation(
+        String_vec const &paths,
+        String_vec const &resource_paths);
+
+    /// Lookup a result.
+    ///
+    /// \param[in]  key     the key
+    /// \param[out] result  the cached result, empty for negative results
+    /// \param[out] epoch   the current epoch, must be passed to insert() on a miss
+    ///
+    /// \return true on hit
+    bool lookup(
+        string const &key,
+        string       &result,
+        size_t       &epoch);
+
+    /// Insert a result.
+    ///
+    /// \param epoch     the epoch returned by the failed lookup()
+    /// \param key       the key
+    /// \param result    the result, empty for negative results
+    /// \param fs_calls  the number of file system calls needed to compute the result
+    void insert(
+        size_t       epoch,
+        string const &key,
+        string const &result,
+        size_t       fs_calls);
+
+    /// Get the names of all archives (without the ".mdr" extension) in a search root.
+    ///
+    /// Only the archives are indexed, other files and directories of the search root are probed
+    /// by the file resolver directly.
+    ///
+    /// \param[in]  root      the search root
+    /// \param[out] archives  the archive names
+    /// \param[out] fs_calls  incremented by the number of file system calls done
+    ///
+    /// \return false if the search root does not exist
+    bool get_archives(
+        string const &root,
+        String_vec   &archives,
+        size_t       &fs_calls);
+
+    /// Drop all cached results.
+    void invalidate();
+
+    /// Get the statistics.
+    Statistics get_statistics() const;
+
+    /// Constructor.
+    ///
+    /// \param alloc  the allocator
+    explicit File_resolution_cache(IAllocator *alloc);
+
+private:
+    // non copyable
+    File_resolution_cache(File_resolution_cache const &) MDL_DELETED_FUNCTION;
+    File_resolution_cache &operator=(File_resolution_cache const &) MDL_DELETED_FUNCTION;
+
+private:
+    /// A cached result.
+    struct Entry {
+        /// Constructor.
+        Entry(string const &result, size_t fs_calls)
+        : m_result(result)
+        , m_fs_calls(fs_calls)
+        {
+        }
+
+        string m_result;    ///< The result, empty for negative results.
+        size_t m_fs_calls;  ///< The number of file system calls needed to compute the result.
+    };
+
+    /// The archive index of a search root.
+    struct Archive_index {
+        /// Constructor.
+        Archive_index(IAllocator *alloc, bool exists)
+        : m_archives(alloc)
+        , m_exists(exists)
+        {
+        }
+
+        String_vec m_archives;  ///< The names of all archives in this root.
+        bool       m_exists;    ///< True if the root exists.
+    };
+
+    typedef hash_map<string, Entry, string_hash<string> >::Type         Entry_map;
+    typedef hash_map<string, Archive_index, string_hash<string> >::Type Archive_index_map;
+    typedef hash_map<string, unsigned, string_hash<string> >::Type      Generation_map;
+
+    /// Drop all cached negative results.
+    ///
+    /// \note The caller needs to hold m_lock.
+    void drop_negative_entries();
+
+    /// The allocator.
+    IAllocator *m_alloc;
+
+    /// Protects all data.
+    mutable mi::base::Lock m_lock;
+
+    /// The cached results.
+    Entry_map m_entries;
+
+    /// The number of negative results in m_entries.
+    size_t m_nr_negative_entries;
+
+    /// The archive indexes of all search roots.
+    Archive_index_map m_archive_indexes;
+
+    /// The generations of all seen search path sets.
+    Generation_map m_generations;
+
+    /// The epoch, incremented by every invalidation.
+    size_t m_epoch;
+
+    /// The statistics.
+    Statistics m_stats;
+};
+
 /// Implements file resolution.
 class File_resolver {
     typedef set<string>::Type       String_set;
@@ -462,6 +628,33 @@ private:
     bool is_killed(
         char const *file_mask);
 
+    /// Read the MDL search paths and resource paths, if not done yet.
+    ///
+    /// \param front_path  if non-NULL, search this MDL path first
+    void read_search_paths(
+        char const *front_path);
+
+    /// Search the given path in all MDL search paths without using the resolution cache.
+    ///
+    /// \param file_mask           the path to search (maybe a regex)
+    /// \param is_resource         true if search in extra resource path
+    /// \param file_mask_is_regex  if true the path to search is a regex
+    ///
+    /// \return the absolute path or mask if found
+    string search_mdl_path_uncached(
+        char const *file_mask,
+        bool       in_resource_path,
+        bool       file_mask_is_regex);
+
+    /// Check if the given file name (UTF8 encoded) names a file on the file system or inside
+    /// an archive without using the resolution cache.
+    ///
+    /// \param fname     a file name
+    /// \param is_regex  if true, threat fname as a regular expression
+    bool file_exists_uncached(
+        char const *fname,
+        bool       is_regex) const;
+
     /// Search the given path in all MDL search paths and return the absolute path if found.
     ///
     /// \param file_mask           the path to search (maybe a regex)
@@ -581,6 +774,15 @@ private:
 
     /// True if we are resolving a resource, false if we are resolving a module.
     bool m_resolving_resource;
+
+    /// The resolution cache of the compiler.
+    File_resolution_cache &m_cache;
+
+    /// The generation of the search paths in the resolution cache.
+    unsigned m_search_path_generation;
+
+    /// Number of file system calls done by this resolver.
+    mutable size_t m_fs_calls;
 };
 
 
@@ -39,10 +39,15 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 
-#ifndef MI_PLATFORM_WINDOWS
+#ifdef MI_PLATFORM_WINDOWS
+#include <sys/utime.h>
+#else
 #include <unistd.h>
 #include <dirent.h>
 #include <errno.h>
+#include <utime.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 #endif
 
 namespace mi {
@@ -266,6 +271,95 @@ bool mkdir_utf8(
     return true;
 }
 
+// Removes a file from the file system.
+bool remove_file_utf8(
+    IAllocator *alloc,
+    char const *path)
+{
+#ifdef MI_PLATFORM_WINDOWS
+    wstring p(alloc);
+    utf8_to_utf16(p, path);
+
+    return ::_wremove(p.c_str()) == 0;
+#else
+    // assume native UTF8-support
+    return ::remove(path) == 0;
+#endif
+}
+
+// Atomically renames a file, replacing an existing destination file.
+bool rename_file_utf8(
+    IAllocator *alloc,
+    char const *src_path,
+    char const *dst_path)
+{
+#ifdef MI_PLATFORM_WINDOWS
+    wstring src(alloc);
+    utf8_to_utf16(src, src_path);
+
+    wstring dst(alloc);
+    utf8_to_utf16(dst, dst_path);
+
+    return ::MoveFileExW(src.c_str(), dst.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#else
+    // assume native UTF8-support, rename() replaces atomically on POSIX
+    return ::rename(src_path, dst_path) == 0;
+#endif
+}
+
+// Retrieve the size and the modification time of a file.
+bool get_file_info_utf8(
+    IAllocator *alloc,
+    char const *path,
+    size_t     &size,
+    long long  &mtime)
+{
+#ifdef MI_PLATFORM_WINDOWS
+    struct _stat64 st;
+
+    wstring p(alloc);
+    utf8_to_utf16(p, path);
+
+    if (::_wstat64(p.c_str(), &st) != 0)
+        return false;
+#else
+    struct stat st;
+
+    // assume native UTF8-support
+    if (::stat(path, &st) != 0)
+        return false;
+#endif
+    size  = size_t(st.st_size);
+    mtime = (long long)st.st_mtime;
+    return true;
+}
+
+// Set the modification time of a file to the current time.
+bool touch_file_utf8(
+    IAllocator *alloc,
+    char const *path)
+{
+#ifdef MI_PLATFORM_WINDOWS
+    wstring p(alloc);
+    utf8_to_utf16(p, path);
+
+    return ::_wutime(p.c_str(), NULL) == 0;
+#else
+    // assume native UTF8-support
+    return ::utime(path, NULL) == 0;
+#endif
+}
+
+// Get the id of the current process.
+unsigned long get_process_id()
+{
+#ifdef MI_PLATFORM_WINDOWS
+    return (unsigned long)GetCurrentProcessId();
+#else
+    return (unsigned long)getpid();
+#endif
+}
+
 // Get the current working directory
 string get_cwd(IAllocator *alloc)
 {
@@ -697,5 +791,95 @@ bool Directory::rewind()
 
 #endif // MI_PLATFORM_WINDOWS
 
+// Map a file into memory.
+Mapped_file *Mapped_file::open(
+    IAllocator *alloc,
+    char const *path)
+{
+    void   *data = NULL;
+    size_t size  = 0;
+
+#ifdef MI_PLATFORM_WINDOWS
+    wstring p(alloc);
+    utf8_to_utf16(p, path);
+
+    HANDLE file = ::CreateFileW(
+        p.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE)
+        return NULL;
+
+    LARGE_INTEGER file_size;
+    if (!::GetFileSizeEx(file, &file_size) || file_size.QuadPart <= 0) {
+        ::CloseHandle(file);
+        return NULL;
+    }
+    size = size_t(file_size.QuadPart);
+
+    HANDLE mapping = ::CreateFileMappingW(file, NULL, PAGE_READONLY, 0, 0, NULL);
+    ::CloseHandle(file);
+    if (mapping == NULL)
+        return NULL;
+
+    // the view keeps the mapping alive
+    data = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    ::CloseHandle(mapping);
+    if (data == NULL)
+        return NULL;
+#else
+    // assume native UTF8-support
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return NULL;
+
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return NULL;
+    }
+    size = size_t(st.st_size);
+
+    // the mapping keeps the file alive
+    data = ::mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED)
+        return NULL;
+#endif
+
+    Allocator_builder builder(alloc);
+    return builder.create<Mapped_file>(
+        alloc, static_cast<unsigned char const *>(data), size);
+}
+
+// Unmap a file.
+void Mapped_file::close(Mapped_file *f)
+{
+    if (f != NULL) {
+        Allocator_builder builder(f->m_alloc);
+        builder.destroy(f);
+    }
+}
+
+// Constructor.
+Mapped_file::Mapped_file(
+    IAllocator          *alloc,
+    unsigned char const *data,
+    size_t              size)
+: m_alloc(alloc)
+, m_data(data)
+, m_size(size)
+{
+}
+
+// Destructor.
+Mapped_file::~Mapped_file()
+{
+#ifdef MI_PLATFORM_WINDOWS
+    ::UnmapViewOfFile(m_data);
+#else
+    ::munmap(const_cast<unsigned char *>(m_data), m_size);
+#endif
+}
+
 }  // mdl
 }  // mi
@@ -112,6 +112,51 @@ bool mkdir_utf8(
     IAllocator *alloc,
     char const *path);
 
+/// Removes a file from the file system.
+///
+/// \param alloc  an allocator
+/// \param path   an UTF8 encoded file path
+bool remove_file_utf8(
+    IAllocator *alloc,
+    char const *path);
+
+/// Atomically renames a file, replacing an existing destination file.
+///
+/// \param alloc     an allocator
+/// \param src_path  an UTF8 encoded file path of the file to rename
+/// \param dst_path  an UTF8 encoded file path of the new name
+bool rename_file_utf8(
+    IAllocator *alloc,
+    char const *src_path,
+    char const *dst_path);
+
+/// Retrieve the size and the modification time of a file.
+///
+/// \param alloc       an allocator
+/// \param path        an UTF8 encoded file path
+/// \param[out] size   the size of the file in bytes
+/// \param[out] mtime  the modification time of the file in seconds since the epoch
+///
+/// \return true on success, false if the file does not exist
+bool get_file_info_utf8(
+    IAllocator *alloc,
+    char const *path,
+    size_t     &size,
+    long long  &mtime);
+
+/// Set the modification time of a file to the current time.
+///
+/// \param alloc  an allocator
+/// \param path   an UTF8 encoded file path
+bool touch_file_utf8(
+    IAllocator *alloc,
+    char const *path);
+
+/// Get the id of the current process.
+///
+/// Used to create temporary file names that are unique across processes.
+unsigned long get_process_id();
+
 /// Retrieve the current working directory.
 ///
 /// \param alloc  an allocator
@@ -224,6 +269,49 @@ private:
     bool       m_eof;          ///< hit EOF while reading?
 };
 
+/// A read-only memory mapping of a whole file.
+class Mapped_file
+{
+    friend class Allocator_builder;
+public:
+    /// Map a file into memory.
+    ///
+    /// \param alloc  the allocator
+    /// \param path   an UTF8 encoded file path
+    ///
+    /// \return the mapping or NULL if the file could not be mapped, empty files cannot be mapped
+    static Mapped_file *open(
+        IAllocator *alloc,
+        char const *path);
+
+    /// Unmap a file.
+    static void close(Mapped_file *f);
+
+    /// Get the mapped data.
+    unsigned char const *get_data() const { return m_data; }
+
+    /// Get the size of the mapped data.
+    size_t get_size() const { return m_size; }
+
+private:
+    /// Constructor.
+    Mapped_file(
+        IAllocator          *alloc,
+        unsigned char const *data,
+        size_t              size);
+
+    /// Destructor.
+    ~Mapped_file();
+
+    // non copyable
+    Mapped_file(Mapped_file const &) MDL_DELETED_FUNCTION;
+    Mapped_file &operator=(Mapped_file const &) MDL_DELETED_FUNCTION;
+
+private:
+    IAllocator          *m_alloc;  ///< The allocator.
+    unsigned char const *m_data;   ///< The mapped data.
+    size_t              m_size;    ///< The size of the mapped data.
+};
 
 }  // mdl
 }  // mi
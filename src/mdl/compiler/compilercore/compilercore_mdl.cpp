@@ -29,9 +29,12 @@
 #include "pch.h"
 
 #include <cfloat>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 
 #include <mi/base/lock.h>
+#include <mi/neuraylib/version.h>
 
 #include <mi/mdl/mdl_translator_plugin.h>
 
@@ -42,6 +45,7 @@
 #include "compilercore_debug_tools.h"
 #include "compilercore_encapsulator.h"
 #include "compilercore_factories.h"
+#include "compilercore_hash.h"
 #include "compilercore_malloc_allocator.h"
 #include "compilercore_modules.h"
 #include "compilercore_options.h"
@@ -58,6 +62,8 @@
 #include "compilercore_archiver.h"
 #include "compilercore_comparator.h"
 #include "compilercore_module_transformer.h"
+#include "compilercore_file_utils.h"
+#include "compilercore_zip_utils.h"
 #include "compilercore_mdl.h"
 
 #include "mdl_module.h"
@@ -88,6 +94,8 @@ char const *MDL::option_state_wavelength_base_max     = MDL_OPTION_STATE_WAVELEN
 char const *MDL::option_user_data                     = MDL_OPTION_USER_DATA;
 char const *MDL::option_keep_original_resource_file_paths
                                                   = MDL_OPTION_KEEP_ORIGINAL_RESOURCE_FILE_PATHS;
+char const *MDL::option_module_image_cache_path       = MDL_OPTION_MODULE_IMAGE_CACHE_PATH;
+char const *MDL::option_parallel_import_threads       = MDL_OPTION_PARALLEL_IMPORT_THREADS;
 
 // forward
 class Jitted_code;
@@ -369,6 +377,273 @@ static mi::mdl::MDL *create_mdl(IAllocator *alloc)
     return p;
 }
 
+/// The embedded source of a builtin module.
+struct Builtin_module_source {
+    char const          *name;   ///< The absolute module name.
+    unsigned char const *data;   ///< The encoded source.
+    size_t              size;    ///< The size of the encoded source.
+    unsigned            flags;   ///< The module property flags.
+};
+
+/// The builtin modules in the order they must be loaded.
+Builtin_module_source const builtin_module_sources[] = {
+    // state.mdl must be first due to dependencies of material structs to state::normal
+    { "::state",  mdl_module_state,  sizeof(mdl_module_state),  Module::MF_IS_STDLIB },
+    // tex.mdl next, this defines the gamma_mode enum
+    { "::tex",    mdl_module_tex,    sizeof(mdl_module_tex),    Module::MF_IS_STDLIB },
+    { "::limits", mdl_module_limits, sizeof(mdl_module_limits), Module::MF_IS_STDLIB },
+    { "::anno",   mdl_module_anno,   sizeof(mdl_module_anno),   Module::MF_IS_STDLIB },
+    { "::math",   mdl_module_math,   sizeof(mdl_module_math),   Module::MF_IS_STDLIB },
+    { "::df",     mdl_module_df,     sizeof(mdl_module_df),     Module::MF_IS_STDLIB },
+    { "::scene",  mdl_module_scene,  sizeof(mdl_module_scene),  Module::MF_IS_STDLIB },
+    { "::debug",  mdl_module_debug,  sizeof(mdl_module_debug),
+        Module::MF_IS_STDLIB | Module::MF_IS_DEBUG },
+    // std.mdl after all the above
+    { "::std",    mdl_module_std,    sizeof(mdl_module_std),    Module::MF_IS_STDLIB },
+    // finally builtins.mdl
+    { "::<builtins>", mdl_module_builtins, sizeof(mdl_module_builtins),
+        Module::MF_IS_STDLIB | Module::MF_IS_BUILTIN },
+    // nvidia::baking.mdl, which is NOT a stdlib module
+    { "::nvidia::baking", mdl_module_nvidia_baking, sizeof(mdl_module_nvidia_baking),
+        Module::MF_IS_STDLIB | Module::MF_IS_OWNED },
+    // base.mdl, this must be hashed
+    { "::base",   mdl_module_base,   sizeof(mdl_module_base),
+        Module::MF_IS_OWNED | Module::MF_IS_HASHED },
+};
+
+/// Magic number of builtin module snapshot files.
+char const snapshot_magic[8] = { 'M', 'D', 'L', 'S', 'N', 'A', 'P', '1' };
+
+/// Version of the builtin module snapshot format.
+///
+/// The binary serialization of modules is not versioned itself, increment this version whenever
+/// it changes.
+mi::Uint32 const snapshot_format_version = 1;
+
+/// Computes the key identifying builtin module snapshots written by this SDK version.
+///
+/// The key covers the snapshot format version, the SDK version, and the embedded module sources.
+void compute_snapshot_key(unsigned char key[16])
+{
+    MD5_hasher hasher;
+    hasher.update(
+        reinterpret_cast<unsigned char const *>(snapshot_magic), sizeof(snapshot_magic));
+    hasher.update(snapshot_format_version);
+    hasher.update(MI_NEURAYLIB_PRODUCT_VERSION_STRING);
+    hasher.update(mi::Uint32(sizeof(void *)));
+    for (size_t i = 0, n = dimension_of(builtin_module_sources); i < n; ++i) {
+        Builtin_module_source const &src = builtin_module_sources[i];
+        hasher.update(src.name);
+        hasher.update(mi::Uint32(src.flags));
+        hasher.update(src.data, src.size);
+    }
+    hasher.final(key);
+}
+
+/// Reads an unsigned 32bit value in little endian order.
+bool read_uint32(unsigned char const *&p, unsigned char const *end, mi::Uint32 &v)
+{
+    if (size_t(end - p) < 4) {
+        return false;
+    }
+    v = mi::Uint32(p[0]) | (mi::Uint32(p[1]) << 8) | (mi::Uint32(p[2]) << 16) |
+        (mi::Uint32(p[3]) << 24);
+    p += 4;
+    return true;
+}
+
+/// Magic number of module image files.
+char const module_image_magic[8] = { 'M', 'D', 'L', 'I', 'M', 'A', 'G', '1' };
+
+/// Version of the module and code DAG image format.
+///
+/// The binary serialization of modules and code DAGs is not versioned itself, increment this
+/// version whenever it changes.
+mi::Uint32 const module_image_format_version = 1;
+
+/// Magic number of code DAG image files.
+char const code_dag_image_magic[8] = { 'M', 'D', 'L', 'D', 'A', 'G', 'I', '1' };
+
+/// The compiler options that influence the result of parsing and analyzing a module.
+char const * const module_image_options[] = {
+    MDL_OPTION_WARN,
+    MDL_OPTION_OPT_LEVEL,
+    MDL_OPTION_STRICT,
+    MDL_OPTION_EXPERIMENTAL_FEATURES,
+    MDL_OPTION_RESOLVE_RESOURCES,
+    MDL_OPTION_LIMITS_FLOAT_MIN,
+    MDL_OPTION_LIMITS_FLOAT_MAX,
+    MDL_OPTION_LIMITS_DOUBLE_MIN,
+    MDL_OPTION_LIMITS_DOUBLE_MAX,
+    MDL_OPTION_STATE_WAVELENGTH_BASE_MAX,
+    MDL_OPTION_KEEP_ORIGINAL_RESOURCE_FILE_PATHS,
+};
+
+/// Compute the key of a code DAG image from the image key of its module and the code generator
+/// options.
+///
+/// \return false if the module has no image key
+bool compute_code_dag_image_key(
+    Module const  *mod,
+    char const    *options_key,
+    unsigned char key[16])
+{
+    unsigned char image_key[16];
+    if (mod == NULL || !mod->get_image_key(image_key)) {
+        return false;
+    }
+
+    MD5_hasher hasher;
+    hasher.update(
+        reinterpret_cast<unsigned char const *>(code_dag_image_magic),
+        sizeof(code_dag_image_magic));
+    hasher.update(image_key, sizeof(image_key));
+    hasher.update(options_key);
+    hasher.final(key);
+    return true;
+}
+
+/// Reads a whole file.
+bool read_file(IAllocator *alloc, char const *file_name, vector<unsigned char>::Type &data)
+{
+    FILE *f = fopen_utf8(alloc, file_name, "rb");
+    if (f == NULL) {
+        return false;
+    }
+
+    unsigned char buf[64 * 1024];
+    for (size_t n; (n = fread(buf, 1, sizeof(buf), f)) > 0;) {
+        data.insert(data.end(), buf, buf + n);
+    }
+    bool ok = ferror(f) == 0;
+    fclose(f);
+    return ok;
+}
+
+/// Writes a file atomically, other processes might read it concurrently.
+void write_file_atomic(
+    IAllocator                        *alloc,
+    string const                      &file_name,
+    vector<unsigned char>::Type const &data)
+{
+    static mi::base::Atom32 tmp_counter;
+
+    char suffix[64];
+    snprintf(
+        suffix, sizeof(suffix), ".%lu.%u.tmp", get_process_id(), unsigned(tmp_counter++));
+    string tmp_name(file_name);
+    tmp_name += suffix;
+
+    FILE *f = fopen_utf8(alloc, tmp_name.c_str(), "wb");
+    if (f == NULL) {
+        return;
+    }
+
+    bool ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+    ok = fclose(f) == 0 && ok;
+
+    if (!ok || !rename_file_utf8(alloc, tmp_name.c_str(), file_name.c_str())) {
+        remove_file_utf8(alloc, tmp_name.c_str());
+    }
+}
+
+/// Appends an unsigned 32bit value in little endian order.
+void append_uint32(vector<unsigned char>::Type &data, mi::Uint32 v)
+{
+    data.push_back((unsigned char)(v));
+    data.push_back((unsigned char)(v >> 8));
+    data.push_back((unsigned char)(v >> 16));
+    data.push_back((unsigned char)(v >> 24));
+}
+
+/// Appends a block of bytes.
+void append_bytes(vector<unsigned char>::Type &data, void const *p, size_t size)
+{
+    unsigned char const *b = static_cast<unsigned char const *>(p);
+    data.insert(data.end(), b, b + size);
+}
+
+/// Appends the content of a buffer serializer.
+void append_serialized(vector<unsigned char>::Type &data, Buffer_serializer const &bs)
+{
+    append_uint32(data, mi::Uint32(bs.get_size()));
+    append_bytes(data, bs.get_data(), bs.get_size());
+}
+
+/// Appends the digest of the content of a buffer serializer followed by the content.
+void append_serialized_with_digest(
+    vector<unsigned char>::Type &data,
+    Buffer_serializer const     &bs)
+{
+    unsigned char digest[16];
+    MD5_hasher hasher;
+    hasher.update(bs.get_data(), bs.get_size());
+    hasher.final(digest);
+
+    append_bytes(data, digest, sizeof(digest));
+    append_serialized(data, bs);
+}
+
+/// Reads serialized content written by append_serialized_with_digest(), which must extend to
+/// the end of the data.
+///
+/// The deserializers do not check their input, hence corrupted content is rejected here.
+///
+/// \return false if the content is truncated or does not match its digest
+bool read_serialized_with_digest(
+    unsigned char const *&p,
+    unsigned char const *end,
+    mi::Uint32          &size)
+{
+    unsigned char digest[16];
+    if (size_t(end - p) < sizeof(digest)) {
+        return false;
+    }
+    memcpy(digest, p, sizeof(digest));
+    p += sizeof(digest);
+
+    if (!read_uint32(p, end, size) || size_t(end - p) != size) {
+        return false;
+    }
+
+    unsigned char content_digest[16];
+    MD5_hasher hasher;
+    hasher.update(p, size);
+    hasher.final(content_digest);
+    return memcmp(digest, content_digest, sizeof(digest)) == 0;
+}
+
+/// Compute the key of a module image from the key of its source and the keys of its imports.
+///
+/// \return false if a non-builtin import has no image key
+bool compute_module_image_import_key(
+    unsigned char const src_key[16],
+    Module const        *mod,
+    unsigned char       key[16])
+{
+    MD5_hasher hasher;
+    hasher.update(src_key, 16);
+    for (int i = 0, n = mod->get_import_count(); i < n; ++i) {
+        mi::base::Handle<Module const> imp(mod->get_import(i));
+        if (!imp.is_valid_interface()) {
+            return false;
+        }
+        if (imp->is_builtins() || imp->is_stdlib() || imp->is_compiler_owned()) {
+            // these are part of the build and already covered by the source key
+            continue;
+        }
+
+        unsigned char imp_key[16];
+        if (!imp->get_image_key(imp_key)) {
+            return false;
+        }
+        hasher.update(imp->get_name());
+        hasher.update(imp_key, sizeof(imp_key));
+    }
+    hasher.final(key);
+    return true;
+}
+
 }  // anonymous
 
 
@@ -386,7 +661,10 @@ MDL::MDL(IAllocator *alloc)
 , m_external_resolver()
 , m_global_lock()
 , m_search_path_lock()
+, m_file_resolution_cache(m_builder.create<File_resolution_cache>(alloc))
 , m_weak_module_lock()
+, m_import_thread_lock()
+, m_n_import_threads(0)
 , m_predefined_types_build(false)
 , m_jitted_code(NULL)
 , m_translator_list(alloc)
@@ -394,161 +672,424 @@ MDL::MDL(IAllocator *alloc)
     create_options();
     create_builtin_semantics();
 
-    // create built-in modules
-    mi::base::Handle<Thread_context> ctx(create_thread_context());
+    // MI_MDL_STDLIB_SNAPSHOT names a snapshot file of the builtin modules. If it does not exist
+    // or was written by a different build, the builtin modules are loaded from source and the
+    // snapshot is (re-)written.
+    char const *snapshot = getenv("MI_MDL_STDLIB_SNAPSHOT");
+    if (snapshot != NULL && snapshot[0] == '\0') {
+        snapshot = NULL;
+    }
 
-    // load state.mdl,
-    // must be first due to dependencies of material structs to state::normal
-    {
-        mi::base::Handle<Buffer_Input_stream> s(m_builder.create<Encoded_buffer_Input_stream>(
-            m_builder.get_allocator(),
-            mdl_module_state, sizeof(mdl_module_state), ""));
-        Module *state_mod = load_module(
-            NULL, ctx.get(), "::state", s.get(), Module::MF_IS_STDLIB);
+    if (snapshot == NULL || !load_builtin_modules_from_snapshot(snapshot)) {
+        // create built-in modules
+        mi::base::Handle<Thread_context> ctx(create_thread_context());
+        load_builtin_modules(ctx.get());
 
-        // takes ownership
-        register_builtin_module(state_mod);
+        if (snapshot != NULL) {
+            write_builtin_modules_snapshot(snapshot);
+        }
     }
+}
+
+// Destructor.
+MDL::~MDL()
+{
+    terminate_jitted_code_singleton(m_jitted_code);
+    m_builder.destroy(m_file_resolution_cache);
+
+    // cached containers use our allocator
+    MDL_zip_container_cache::flush(get_allocator());
+}
+
+// Load all builtin modules from their embedded sources.
+void MDL::load_builtin_modules(Thread_context *ctx)
+{
+    for (size_t i = 0, n = dimension_of(builtin_module_sources); i < n; ++i) {
+        Builtin_module_source const &src = builtin_module_sources[i];
 
-    // load tex.mdl next, this defines the gamma_mode enum
-    {
         mi::base::Handle<Buffer_Input_stream> s(m_builder.create<Encoded_buffer_Input_stream>(
-            m_builder.get_allocator(),
-            mdl_module_tex, sizeof(mdl_module_tex), ""));
-        Module *tex_mod = load_module(
-            NULL, ctx.get(), "::tex", s.get(), Module::MF_IS_STDLIB);
+            m_builder.get_allocator(), src.data, src.size, ""));
+        Module *mod = load_module(NULL, ctx, src.name, s.get(), src.flags);
 
         // takes ownership
-        register_builtin_module(tex_mod);
+        register_builtin_module(mod);
     }
+}
 
-    // load limits.mdl
-    {
-        mi::base::Handle<Buffer_Input_stream> s(m_builder.create<Encoded_buffer_Input_stream>(
-            m_builder.get_allocator(),
-            mdl_module_limits, sizeof(mdl_module_limits), ""));
-        Module *limits_mod = load_module(
-            NULL, ctx.get(), "::limits", s.get(), Module::MF_IS_STDLIB);
+// Load all builtin modules from a snapshot file.
+bool MDL::load_builtin_modules_from_snapshot(char const *file_name)
+{
+    MDL_ASSERT(m_builtin_modules.empty());
 
-        // takes ownership
-        register_builtin_module(limits_mod);
+    vector<unsigned char>::Type data(get_allocator());
+    if (!read_file(get_allocator(), file_name, data)) {
+        return false;
     }
 
-    // load anno.mdl
+    unsigned char key[16];
+    compute_snapshot_key(key);
+
+    // Validate the whole file before any module is created: the deserializer does not check its
+    // input, so the payload is protected by a digest.
+    unsigned char const *p   = data.data();
+    unsigned char const *end = p + data.size();
+    size_t const header_size = sizeof(snapshot_magic) + sizeof(key) + 16;
+    if (size_t(end - p) < header_size ||
+        memcmp(p, snapshot_magic, sizeof(snapshot_magic)) != 0 ||
+        memcmp(p + sizeof(snapshot_magic), key, sizeof(key)) != 0)
     {
-        mi::base::Handle<Buffer_Input_stream> s(m_builder.create<Encoded_buffer_Input_stream>(
-            m_builder.get_allocator(),
-            mdl_module_anno, sizeof(mdl_module_anno), ""));
-        Module *anno_mod = load_module(
-            NULL, ctx.get(), "::anno", s.get(), Module::MF_IS_STDLIB);
+        return false;
+    }
 
-        // takes ownership
-        register_builtin_module(anno_mod);
+    unsigned char digest[16];
+    MD5_hasher hasher;
+    hasher.update(p + header_size, size_t(end - p) - header_size);
+    hasher.final(digest);
+    if (memcmp(p + sizeof(snapshot_magic) + sizeof(key), digest, sizeof(digest)) != 0) {
+        return false;
     }
+    p += header_size;
 
-    // load math.mdl
-    {
-        mi::base::Handle<Buffer_Input_stream> s(m_builder.create<Encoded_buffer_Input_stream>(
-            m_builder.get_allocator(),
-            mdl_module_math, sizeof(mdl_module_math), ""));
-        Module *math_mod = load_module(
-            NULL, ctx.get(), "::math", s.get(), Module::MF_IS_STDLIB);
+    size_t const n_modules = dimension_of(builtin_module_sources);
+    mi::Uint32 count = 0;
+    if (!read_uint32(p, end, count) || count != n_modules) {
+        return false;
+    }
 
-        // takes ownership
-        register_builtin_module(math_mod);
+    unsigned char const *blobs[dimension_of(builtin_module_sources)];
+    mi::Uint32          sizes[dimension_of(builtin_module_sources)];
+    for (size_t i = 0; i < n_modules; ++i) {
+        if (!read_uint32(p, end, sizes[i]) || size_t(end - p) < sizes[i]) {
+            return false;
+        }
+        blobs[i] = p;
+        p += sizes[i];
+    }
+    if (p != end) {
+        return false;
     }
 
-    // load df.mdl
-    {
-        mi::base::Handle<Buffer_Input_stream> s(m_builder.create<Encoded_buffer_Input_stream>(
-            m_builder.get_allocator(),
-            mdl_module_df, sizeof(mdl_module_df), ""));
-        Module *df_mod = load_module(
-            NULL, ctx.get(), "::df", s.get(), Module::MF_IS_STDLIB);
+    for (size_t i = 0; i < n_modules; ++i) {
+        // every builtin module is serialized with the preceding builtin modules as known modules,
+        // see write_builtin_modules_snapshot()
+        Buffer_deserializer     ds(get_allocator(), blobs[i], sizes[i]);
+        MDL_binary_deserializer bin_deserializer(get_allocator(), &ds, this);
+        Module_deserializer     mod_deserializer(get_allocator(), &ds, &bin_deserializer, this);
+
+        Module const *mod = NULL;
+        if (bin_deserializer.read_section_tag() == Serializer::ST_MODULE_START) {
+            mod = Module::deserialize(mod_deserializer);
+        }
+        if (mod == NULL ||
+            strcmp(mod->get_name(), builtin_module_sources[i].name) != 0 ||
+            mod->get_unique_id() != i + 1)
+        {
+            // a snapshot with a valid digest but unexpected content, e.g., written by a
+            // modified build with the same version: discard the modules loaded so far
+            if (mod != NULL) {
+                mod->release();
+            }
+            m_builtin_modules.clear();
+            m_builtin_module_indexes.clear();
+            m_next_module_id = 0;
+            return false;
+        }
 
         // takes ownership
-        register_builtin_module(df_mod);
+        register_builtin_module(mod);
     }
+    return true;
+}
 
-    // load scene.mdl
-    {
-        mi::base::Handle<Buffer_Input_stream> s(m_builder.create<Encoded_buffer_Input_stream>(
-            m_builder.get_allocator(),
-            mdl_module_scene, sizeof(mdl_module_scene), ""));
-        Module *scene_mod = load_module(
-            NULL, ctx.get(), "::scene", s.get(), Module::MF_IS_STDLIB);
+// Write a snapshot of all builtin modules to a file.
+void MDL::write_builtin_modules_snapshot(char const *file_name) const
+{
+    size_t const n_modules = m_builtin_modules.size();
+    MDL_ASSERT(n_modules == dimension_of(builtin_module_sources));
 
-        // takes ownership
-        register_builtin_module(scene_mod);
+    vector<unsigned char>::Type payload(get_allocator());
+    append_uint32(payload, mi::Uint32(n_modules));
+
+    for (size_t i = 0; i < n_modules; ++i) {
+        // register only the preceding builtin modules, such that this module is written
+        // completely while references to its imports are written as tags
+        Buffer_serializer     bs(get_allocator());
+        MDL_binary_serializer bin_serializer(get_allocator(), this, &bs, i);
+        Module_serializer     mod_serializer(get_allocator(), &bs, &bin_serializer);
+
+        m_builtin_modules[i]->serialize(mod_serializer);
+
+        append_serialized(payload, bs);
     }
 
-    // load debug.mdl
-    {
-        mi::base::Handle<Buffer_Input_stream> s(m_builder.create<Encoded_buffer_Input_stream>(
-            m_builder.get_allocator(),
-            mdl_module_debug, sizeof(mdl_module_debug), ""));
-        Module *debug_mod = load_module(
-            NULL, ctx.get(), "::debug", s.get(), Module::MF_IS_STDLIB | Module::MF_IS_DEBUG);
+    unsigned char key[16];
+    compute_snapshot_key(key);
 
-        // takes ownership
-        register_builtin_module(debug_mod);
+    unsigned char digest[16];
+    MD5_hasher hasher;
+    hasher.update(payload.data(), payload.size());
+    hasher.final(digest);
+
+    vector<unsigned char>::Type data(get_allocator());
+    append_bytes(data, snapshot_magic, sizeof(snapshot_magic));
+    append_bytes(data, key, sizeof(key));
+    append_bytes(data, digest, sizeof(digest));
+    append_bytes(data, payload.data(), payload.size());
+
+    // other processes might read the snapshot concurrently
+    write_file_atomic(get_allocator(), string(file_name, get_allocator()), data);
+}
+
+// Compute the key of the image of a module that is not yet compiled.
+void MDL::compute_module_image_key(
+    Thread_context const               &ctx,
+    char const                         *module_name,
+    char const                         *file_name,
+    vector<unsigned char>::Type const  &src,
+    unsigned char                      key[16]) const
+{
+    MD5_hasher hasher;
+    hasher.update(
+        reinterpret_cast<unsigned char const *>(module_image_magic), sizeof(module_image_magic));
+    hasher.update(module_image_format_version);
+    hasher.update(MI_NEURAYLIB_PRODUCT_VERSION_STRING);
+    hasher.update(mi::Uint32(sizeof(void *)));
+
+    for (size_t i = 0, n = dimension_of(module_image_options); i < n; ++i) {
+        hasher.update(module_image_options[i]);
+        hasher.update(get_compiler_option(&ctx, module_image_options[i]));
     }
+    hasher.update(ctx.get_front_path());
+    hasher.update(ctx.get_virtual_root_package());
 
-    // load std.mdl after all the above
+    // the analysis resolves imports and resources, their resolution depends on these settings
     {
-        mi::base::Handle<Buffer_Input_stream> s(m_builder.create<Encoded_buffer_Input_stream>(
-            m_builder.get_allocator(),
-            mdl_module_std, sizeof(mdl_module_std), ""));
-        Module *std_mod = load_module(
-            NULL, ctx.get(), "::std", s.get(), Module::MF_IS_STDLIB);
+        mi::base::Lock::Block block(&m_search_path_lock);
+
+        IMDL_search_path::Path_set const sets[] = {
+            IMDL_search_path::MDL_SEARCH_PATH, IMDL_search_path::MDL_RESOURCE_PATH };
+        for (size_t k = 0, m = dimension_of(sets); k < m; ++k) {
+            size_t n = m_search_path->get_search_path_count(sets[k]);
+            hasher.update(mi::Uint64(n));
+            for (size_t i = 0; i < n; ++i) {
+                hasher.update(m_search_path->get_search_path(sets[k], i));
+            }
+        }
+    }
+    hasher.update(mi::Uint32(m_external_resolver.is_valid_interface()));
+    hasher.update(mi::Uint32(ctx.get_resource_restriction_handler() != NULL));
 
-        // takes ownership
-        register_builtin_module(std_mod);
+    hasher.update(module_name);
+    hasher.update(file_name);
+    hasher.update(mi::Uint64(src.size()));
+    hasher.update(src.data(), src.size());
+    hasher.final(key);
+}
+
+// Get the file name of a module image cache entry.
+string MDL::get_module_image_file_name(
+    char const *cache_path,
+    char const *module_name,
+    char const *ext) const
+{
+    // one entry per module name, a changed module replaces its outdated image
+    unsigned char key[16];
+    MD5_hasher hasher;
+    hasher.update(module_name);
+    hasher.final(key);
+
+    static char const hex[] = "0123456789abcdef";
+
+    string name(get_allocator());
+    for (size_t i = 0; i < 16; ++i) {
+        name += hex[key[i] >> 4];
+        name += hex[key[i] & 15];
     }
-    // finally load builtins.mdl
+    name += ext;
+
+    return join_path(string(cache_path, get_allocator()), name);
+}
+
+// Load a module from the module image cache.
+Module *MDL::load_module_image(
+    Thread_context      &ctx,
+    IModule_cache       *module_cache,
+    char const          *module_name,
+    char const          *cache_path,
+    unsigned char const src_key[16])
+{
+    IAllocator *alloc = get_allocator();
+
+    vector<unsigned char>::Type data(alloc);
+    if (!read_file(
+            alloc,
+            get_module_image_file_name(cache_path, module_name, ".mdlimg").c_str(),
+            data))
     {
-        mi::base::Handle<Buffer_Input_stream> s(m_builder.create<Encoded_buffer_Input_stream>(
-            m_builder.get_allocator(),
-            mdl_module_builtins, sizeof(mdl_module_builtins), ""));
-        Module *builtins_mod = load_module(
-            NULL, ctx.get(), "::<builtins>", s.get(),
-            Module::MF_IS_STDLIB | Module::MF_IS_BUILTIN);
+        return NULL;
+    }
 
-        // takes ownership
-        register_builtin_module(builtins_mod);
+    // layout: magic, source key, image key, digest, size, serialized module
+    unsigned char const *p   = data.data();
+    unsigned char const *end = p + data.size();
+    if (size_t(end - p) < sizeof(module_image_magic) + 16 + 16 ||
+        memcmp(p, module_image_magic, sizeof(module_image_magic)) != 0 ||
+        memcmp(p + sizeof(module_image_magic), src_key, 16) != 0)
+    {
+        // no image of this source
+        return NULL;
     }
+    p += sizeof(module_image_magic) + 16;
+
+    unsigned char image_key[16];
+    memcpy(image_key, p, sizeof(image_key));
+    p += sizeof(image_key);
 
-    // now load nvidia::baking.mdl, which is NOT a stdlib module
+    mi::Uint32 size = 0;
+    if (!read_serialized_with_digest(p, end, size)) {
+        // corrupted image, compile the module instead
+        return NULL;
+    }
+
+    Buffer_deserializer ds(alloc, p, size);
+    mi::base::Handle<Module> mod(
+        const_cast<Module *>(impl_cast<Module>(deserialize_module(&ds))));
+    if (!mod.is_valid_interface() ||
+        !mod->is_valid() ||
+        !mod->is_analyzed() ||
+        strcmp(mod->get_name(), module_name) != 0)
     {
-        mi::base::Handle<Buffer_Input_stream> s(m_builder.create<Encoded_buffer_Input_stream>(
-            m_builder.get_allocator(),
-            mdl_module_nvidia_baking, sizeof(mdl_module_nvidia_baking), ""));
-        Module *baking_mod = load_module(
-            NULL, ctx.get(), "::nvidia::baking", s.get(),
-            Module::MF_IS_STDLIB | Module::MF_IS_OWNED);
+        return NULL;
+    }
 
-        // takes ownership
-        register_builtin_module(baking_mod);
+    // Load the imports. The image can only be used if they are unchanged, which is verified
+    // by the image key that covers the image keys of all imports.
+    mi::base::Handle<Thread_context> imp_ctx(create_thread_context());
+    imp_ctx->set_front_path(ctx.get_front_path());
+    imp_ctx->set_virtual_root_package(ctx.get_virtual_root_package());
+    for (size_t i = 0, n = dimension_of(module_image_options); i < n; ++i) {
+        if (char const *value = get_compiler_option(&ctx, module_image_options[i])) {
+            imp_ctx->access_options().set_option(module_image_options[i], value);
+        }
     }
 
-    // currently load base.mdl, this must be hashed
+    for (size_t i = 0, n = mod->m_imported_modules.size(); i < n; ++i) {
+        Module::Import_entry &entry = mod->m_imported_modules[i];
+        if (entry.get_module() != NULL) {
+            // builtin modules are restored by the deserializer
+            continue;
+        }
+
+        mi::base::Handle<Module const> imp(
+            compile_module(*imp_ctx.get(), entry.get_absolute_name(), module_cache));
+        if (!imp.is_valid_interface() || !imp->is_valid()) {
+            return NULL;
+        }
+        entry.enter_module(m_weak_module_lock, imp.get());
+    }
+
+    unsigned char key[16];
+    if (!compute_module_image_import_key(src_key, mod.get(), key) ||
+        memcmp(key, image_key, sizeof(key)) != 0)
     {
-        mi::base::Handle<Buffer_Input_stream> s(m_builder.create<Encoded_buffer_Input_stream>(
-            m_builder.get_allocator(),
-            mdl_module_base, sizeof(mdl_module_base), ""));
-        Module *base_mod = load_module(
-            NULL, ctx.get(), "::base", s.get(), Module::MF_IS_OWNED | Module::MF_IS_HASHED);
+        // at least one import has changed
+        return NULL;
+    }
 
-        // takes ownership
-        register_builtin_module(base_mod);
+    // pass on the messages of loading the imports, e.g., deprecation warnings
+    ctx.access_messages_impl().copy_messages(imp_ctx->access_messages());
+
+    mod->m_has_image_key = true;
+    memcpy(mod->m_image_key, key, sizeof(key));
+
+    mod->retain();
+    return mod.get();
+}
+
+// Store a module into the module image cache.
+void MDL::store_module_image(
+    Module              *mod,
+    char const          *cache_path,
+    unsigned char const src_key[16]) const
+{
+    if (!mod->is_valid() || !mod->is_analyzed()) {
+        return;
     }
 
+    // an image can only be validated if all its imports have images themselves
+    unsigned char image_key[16];
+    if (!compute_module_image_import_key(src_key, mod, image_key)) {
+        return;
+    }
+
+    IAllocator *alloc = get_allocator();
+
+    Buffer_serializer bs(alloc);
+    serialize_module(mod, &bs, /*include_dependencies=*/false);
+
+    vector<unsigned char>::Type data(alloc);
+    append_bytes(data, module_image_magic, sizeof(module_image_magic));
+    append_bytes(data, src_key, 16);
+    append_bytes(data, image_key, sizeof(image_key));
+    append_serialized_with_digest(data, bs);
+
+    write_file_atomic(
+        alloc, get_module_image_file_name(cache_path, mod->get_name(), ".mdlimg"), data);
+
+    mod->m_has_image_key = true;
+    memcpy(mod->m_image_key, image_key, sizeof(image_key));
 }
 
-// Destructor.
-MDL::~MDL()
+// Compile a module using the module image cache.
+Module *MDL::compile_module_with_image_cache(
+    Thread_context &ctx,
+    IModule_cache  *module_cache,
+    char const     *module_name,
+    IInput_stream  *input,
+    char const     *cache_path)
 {
-    terminate_jitted_code_singleton(m_jitted_code);
+    IAllocator *alloc = get_allocator();
+
+    // only plain files are cached, archives and MDLE files have their own containers
+    mi::base::Handle<IArchive_input_stream> archive_input(
+        input->get_interface<IArchive_input_stream>());
+    mi::base::Handle<IMdle_input_stream> mdle_input(
+        input->get_interface<IMdle_input_stream>());
+    if (archive_input.is_valid_interface() || mdle_input.is_valid_interface()) {
+        return load_module(module_cache, &ctx, module_name, input, Module::MF_STANDARD);
+    }
+
+    char const *file_name = input->get_filename();
+
+    vector<unsigned char>::Type src(alloc);
+    mi::base::Handle<IBlock_input_stream> block_input(
+        input->get_interface<IBlock_input_stream>());
+    if (block_input.is_valid_interface()) {
+        char buf[64 * 1024];
+        for (size_t n; (n = block_input->read(buf, sizeof(buf))) > 0;) {
+            src.insert(src.end(), buf, buf + n);
+        }
+    } else {
+        for (int c; (c = input->read_char()) != -1;) {
+            src.push_back((unsigned char)c);
+        }
+    }
+
+    unsigned char src_key[16];
+    compute_module_image_key(
+        ctx, module_name, file_name != NULL ? file_name : "", src, src_key);
+
+    if (Module *mod = load_module_image(ctx, module_cache, module_name, cache_path, src_key)) {
+        return mod;
+    }
+
+    mi::base::Handle<IInput_stream> buffer(m_builder.create<Buffer_Input_stream>(
+        alloc, reinterpret_cast<char const *>(src.data()), src.size(), file_name));
+    Module *mod = load_module(module_cache, &ctx, module_name, buffer.get(), Module::MF_STANDARD);
+    if (mod != NULL) {
+        store_module_image(mod, cache_path, src_key);
+    }
+    return mod;
 }
 
 // Get the type factory.
@@ -566,7 +1107,6 @@ Module *MDL::create_module(
 {
     // FIXME: check for name already in use
 
-    // TODO: this must be thread safe if create_module should be thread safe
     // Don't use number 0, this is reserved for "owner module".
     size_t id = ++m_next_module_id;
 
@@ -612,6 +1152,12 @@ void MDL::install_search_path(IMDL_search_path *search_path)
     m_search_path = search_path;
 }
 
+// Invalidate the results of file resolution cached by this compiler.
+void MDL::invalidate_file_resolution_cache()
+{
+    m_file_resolution_cache->invalidate();
+}
+
 // Register built-in modules at a module cache.
 void MDL::register_builtin_module_at_cache(IModule_cache *cache)
 {
@@ -1069,6 +1615,10 @@ void MDL::create_options()
 
     m_options.add_option(option_keep_original_resource_file_paths, "false",
         "Keep original resource file paths as is.");
+    m_options.add_option(option_module_image_cache_path, NULL,
+        "Directory of the module image cache, disabled if not set");
+    m_options.add_option(option_parallel_import_threads, "0",
+        "Maximum number of threads loading imports concurrently, 0 disables it");
     m_options.add_interface_option(option_user_data,
         "User data interface passed to callbacks.");
 
@@ -1096,6 +1646,10 @@ Module *MDL::load_module(
         }
     }
 
+    // the time waiting for the cache above is not spent on this module
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    double import_time = ctx != NULL ? ctx->get_module_load_time() : 0.0;
+
     Module *mod =
         create_module(module_name, s->get_filename(), IMDL::MDL_DEFAULT_VERSION, flags);
     if (mod == NULL) {
@@ -1120,6 +1674,8 @@ Module *MDL::load_module(
     parser.set_module(mod, get_compiler_bool_option(ctx, option_experimental_features, false));
     parser.Parse();
 
+    mod->m_phase_times.parse = seconds_since(start);
+
     mi::base::Handle<IArchive_input_stream> iarchvice_s(s->get_interface<IArchive_input_stream>());
     if (iarchvice_s.is_valid_interface()) {
         // this module was loaded from an archive, mark it
@@ -1138,6 +1694,12 @@ Module *MDL::load_module(
     }
 
     mod->analyze(cache, ctx);
+
+    if (ctx != NULL) {
+        // account only for this module, its imports have already added their own time
+        ctx->add_module_load_time(
+            seconds_since(start) - (ctx->get_module_load_time() - import_time));
+    }
     return mod;
 }
 
@@ -1355,8 +1917,15 @@ Module const *MDL::compile_module(
         return NULL;
     }
 
-    // load and compile the actual module
-    Module *mod = load_module(module_cache, &ctx, mname.c_str(), input.get(), Module::MF_STANDARD);
+    // load and compile the actual module, use the module image cache if enabled
+    Module *mod = NULL;
+    char const *cache_path = m_options.get_string_option(option_module_image_cache_path);
+    if (cache_path != NULL && cache_path[0] != '\0') {
+        mod = compile_module_with_image_cache(
+            ctx, module_cache, mname.c_str(), input.get(), cache_path);
+    } else {
+        mod = load_module(module_cache, &ctx, mname.c_str(), input.get(), Module::MF_STANDARD);
+    }
 
     // notify waiting threads about success or failure
     report_module_loading_result(mod, cb);
@@ -1718,6 +2287,85 @@ IGenerated_code_dag const *MDL::deserialize_code_dag(IDeserializer *ds)
     return mi::mdl::deserialize_code_dag(ds, bin_deserializer, this);
 }
 
+// Load a code DAG from the module image cache.
+IGenerated_code_dag *MDL::load_cached_code_dag(
+    IModule const *module,
+    char const    *options_key)
+{
+    char const *cache_path = m_options.get_string_option(option_module_image_cache_path);
+    if (cache_path == NULL || cache_path[0] == '\0') {
+        return NULL;
+    }
+
+    unsigned char key[16];
+    if (!compute_code_dag_image_key(impl_cast<Module>(module), options_key, key)) {
+        return NULL;
+    }
+
+    IAllocator *alloc = get_allocator();
+
+    vector<unsigned char>::Type data(alloc);
+    if (!read_file(
+            alloc,
+            get_module_image_file_name(cache_path, module->get_name(), ".mdldag").c_str(),
+            data))
+    {
+        return NULL;
+    }
+
+    // layout: magic, key, digest, size, serialized code DAG
+    unsigned char const *p   = data.data();
+    unsigned char const *end = p + data.size();
+    if (size_t(end - p) < sizeof(code_dag_image_magic) + sizeof(key) ||
+        memcmp(p, code_dag_image_magic, sizeof(code_dag_image_magic)) != 0 ||
+        memcmp(p + sizeof(code_dag_image_magic), key, sizeof(key)) != 0)
+    {
+        return NULL;
+    }
+    p += sizeof(code_dag_image_magic) + sizeof(key);
+
+    mi::Uint32 size = 0;
+    if (!read_serialized_with_digest(p, end, size)) {
+        // corrupted image, compile the code DAG instead
+        return NULL;
+    }
+
+    Buffer_deserializer ds(alloc, p, size);
+    return const_cast<IGenerated_code_dag *>(deserialize_code_dag(&ds));
+}
+
+// Store a code DAG into the module image cache.
+void MDL::store_cached_code_dag(
+    IModule const             *module,
+    IGenerated_code_dag const *code,
+    char const                *options_key)
+{
+    char const *cache_path = m_options.get_string_option(option_module_image_cache_path);
+    if (cache_path == NULL || cache_path[0] == '\0') {
+        return;
+    }
+
+    unsigned char key[16];
+    if (code == NULL ||
+        !compute_code_dag_image_key(impl_cast<Module>(module), options_key, key))
+    {
+        return;
+    }
+
+    IAllocator *alloc = get_allocator();
+
+    Buffer_serializer bs(alloc);
+    serialize_code_dag(code, &bs);
+
+    vector<unsigned char>::Type data(alloc);
+    append_bytes(data, code_dag_image_magic, sizeof(code_dag_image_magic));
+    append_bytes(data, key, sizeof(key));
+    append_serialized_with_digest(data, bs);
+
+    write_file_atomic(
+        alloc, get_module_image_file_name(cache_path, module->get_name(), ".mdldag"), data);
+}
+
 // Create a new MDL lambda function.
 ILambda_function *MDL::create_lambda_function(
     ILambda_function::Lambda_execution_context context)
@@ -2621,6 +3269,27 @@ mi::base::Lock &MDL::get_search_path_lock() const
     return m_search_path_lock;
 }
 
+// Reserve one of the threads loading imports concurrently.
+bool MDL::acquire_import_thread(int max_threads)
+{
+    mi::base::Lock::Block block(&m_import_thread_lock);
+
+    if (m_n_import_threads >= max_threads) {
+        return false;
+    }
+    ++m_n_import_threads;
+    return true;
+}
+
+// Release a thread reserved by acquire_import_thread().
+void MDL::release_import_thread()
+{
+    mi::base::Lock::Block block(&m_import_thread_lock);
+
+    MDL_ASSERT(m_n_import_threads > 0);
+    --m_n_import_threads;
+}
+
 // Get the Jitted code singleton.
 Jitted_code *MDL::get_jitted_code()
 {
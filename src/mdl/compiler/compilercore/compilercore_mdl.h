@@ -29,6 +29,8 @@
 #ifndef MDL_COMPILERCORE_MDL_H
 #define MDL_COMPILERCORE_MDL_H 1
 
+#include <atomic>
+
 #include <mi/base/handle.h>
 #include <mi/base/lock.h>
 #include <mi/mdl/mdl_mdl.h>
@@ -47,6 +49,7 @@ namespace mdl {
 
 class Analysis;
 class IMDL_import_result;
+class File_resolution_cache;
 class File_resolver;
 class Jitted_code;
 class Messages_impl;
@@ -209,6 +212,12 @@ public:
     /// The name of the option to keep resource file paths as is.
     static char const *option_keep_original_resource_file_paths;
 
+    /// The name of the option that sets the directory of the module image cache.
+    static char const *option_module_image_cache_path;
+
+    /// The name of the option that sets the maximum number of threads loading imports.
+    static char const *option_parallel_import_threads;
+
     /// Get the type factory.
     Type_factory *get_type_factory() const MDL_FINAL;
 
@@ -232,6 +241,9 @@ public:
     /// life time. Any previously set helper will be released now.
     void install_search_path(IMDL_search_path *search_path) MDL_FINAL;
 
+    /// Invalidate the results of file resolution cached by this compiler.
+    void invalidate_file_resolution_cache() MDL_FINAL;
+
     /// Load a module with a given name.
     ///
     /// \param context       The thread context for this operation.
@@ -372,6 +384,26 @@ public:
     /// \return the code DAG
     IGenerated_code_dag const *deserialize_code_dag(IDeserializer *ds) MDL_FINAL;
 
+    /// Load the code DAG of a module from the module image cache.
+    ///
+    /// \param module       the module, must have been compiled with the module image cache
+    /// \param options_key  a string identifying all options the code DAG was generated with
+    ///
+    /// \return the code DAG or NULL if there is no matching entry
+    IGenerated_code_dag *load_cached_code_dag(
+        IModule const *module,
+        char const    *options_key) MDL_FINAL;
+
+    /// Store the code DAG of a module in the module image cache.
+    ///
+    /// \param module       the module the code DAG was generated from
+    /// \param code         the code DAG
+    /// \param options_key  a string identifying all options the code DAG was generated with
+    void store_cached_code_dag(
+        IModule const             *module,
+        IGenerated_code_dag const *code,
+        char const                *options_key) MDL_FINAL;
+
     /// Create a new MDL lambda function.
     ///
     /// \param context  the execution context for this lambda function.
@@ -730,6 +762,16 @@ public:
     /// Get the search path lock.
     mi::base::Lock &get_search_path_lock() const;
 
+    /// Reserve one of the threads loading imports concurrently.
+    ///
+    /// \param max_threads  the maximum number of such threads
+    ///
+    /// \return true if a thread was reserved, false if all are in use
+    bool acquire_import_thread(int max_threads);
+
+    /// Release a thread reserved by acquire_import_thread().
+    void release_import_thread();
+
     /// Get the Jitted code singleton.
     ///
     /// \note Does NOT increase the reference count of the returned
@@ -739,6 +781,11 @@ public:
     /// Get the search path helper.
     mi::base::Handle<IMDL_search_path> const &get_search_path() const { return m_search_path; }
 
+    /// Get the file resolution cache of this compiler.
+    File_resolution_cache &get_file_resolution_cache() const {
+        return *m_file_resolution_cache;
+    }
+
     /// Get the external entity resolver.
     mi::base::Handle<IEntity_resolver> const &get_external_resolver() const {
         return m_external_resolver;
@@ -799,6 +846,93 @@ private:
     /// Create all options (and default values) of the compiler.
     void create_options();
 
+    /// Load all builtin modules from their embedded sources.
+    ///
+    /// \param ctx  the thread context
+    void load_builtin_modules(Thread_context *ctx);
+
+    /// Load all builtin modules from a snapshot file.
+    ///
+    /// \param file_name  the name of the snapshot file
+    ///
+    /// \return true on success, false if the file does not exist, was written by a
+    ///         different SDK version, or is corrupt; no module was loaded in that case
+    bool load_builtin_modules_from_snapshot(char const *file_name);
+
+    /// Write a snapshot of all builtin modules to a file.
+    ///
+    /// \param file_name  the name of the snapshot file
+    void write_builtin_modules_snapshot(char const *file_name) const;
+
+    /// Compute the key of the image of a module that is not yet compiled.
+    ///
+    /// The key covers the image format and SDK version, the compiler options, the search paths,
+    /// the resource resolution settings, and the module source.
+    ///
+    /// \param ctx          the current thread context
+    /// \param module_name  the absolute name of the module
+    /// \param file_name    the file name of the module
+    /// \param src          the source of the module
+    /// \param[out] key     the key
+    void compute_module_image_key(
+        Thread_context const               &ctx,
+        char const                         *module_name,
+        char const                         *file_name,
+        vector<unsigned char>::Type const  &src,
+        unsigned char                      key[16]) const;
+
+    /// Get the file name of a module image cache entry.
+    ///
+    /// \param cache_path   the directory of the module image cache
+    /// \param module_name  the absolute name of the module
+    /// \param ext          the file extension of the entry
+    string get_module_image_file_name(
+        char const *cache_path,
+        char const *module_name,
+        char const *ext) const;
+
+    /// Load a module from the module image cache.
+    ///
+    /// \param ctx           the current thread context
+    /// \param module_cache  the module cache if any
+    /// \param module_name   the absolute name of the module
+    /// \param cache_path    the directory of the module image cache
+    /// \param src_key       the key of the module source, see compute_module_image_key()
+    ///
+    /// \return the module or NULL if there is no image or it is outdated
+    Module *load_module_image(
+        Thread_context      &ctx,
+        IModule_cache       *module_cache,
+        char const          *module_name,
+        char const          *cache_path,
+        unsigned char const src_key[16]);
+
+    /// Store a module in the module image cache and set its image key.
+    ///
+    /// \param mod         the (valid) module
+    /// \param cache_path  the directory of the module image cache
+    /// \param src_key     the key of the module source, see compute_module_image_key()
+    void store_module_image(
+        Module              *mod,
+        char const          *cache_path,
+        unsigned char const src_key[16]) const;
+
+    /// Load and compile a module through the module image cache.
+    ///
+    /// \param ctx           the current thread context
+    /// \param module_cache  the module cache if any
+    /// \param module_name   the absolute name of the module
+    /// \param input         the input stream of the module source
+    /// \param cache_path    the directory of the module image cache
+    ///
+    /// \return the module
+    Module *compile_module_with_image_cache(
+        Thread_context &ctx,
+        IModule_cache  *module_cache,
+        char const     *module_name,
+        IInput_stream  *input,
+        char const     *cache_path);
+
     /// Load a module from a stream.
     ///
     /// \param cache        if non-NULL, a module cache of already loaded modules
@@ -837,8 +971,8 @@ private:
     /// The builder for all created interface.
     mutable Allocator_builder m_builder;
 
-    /// Next unique module id.
-    size_t m_next_module_id;
+    /// Next unique module id, modules are also created by the jobs preloading imports.
+    std::atomic<size_t> m_next_module_id;
 
     /// Arena for the compiler.
     Memory_arena m_arena;
@@ -879,9 +1013,18 @@ private:
     /// The search path lock for this compiler.
     mutable mi::base::Lock m_search_path_lock;
 
+    /// The cache of file resolution results, shared by all resolvers of this compiler.
+    File_resolution_cache *m_file_resolution_cache;
+
     /// The shared lock for all module's weak import tables.
     mutable mi::base::Lock m_weak_module_lock;
 
+    /// The lock for m_n_import_threads.
+    mi::base::Lock m_import_thread_lock;
+
+    /// The number of threads currently loading imports.
+    int m_n_import_threads;
+
     /// Set to true after predefined types are created.
     bool m_predefined_types_build;
 
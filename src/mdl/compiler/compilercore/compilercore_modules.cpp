@@ -204,6 +204,9 @@ Module::Module(
 , m_is_compiler_owned((flags & (MF_IS_STDLIB|MF_IS_OWNED)) != 0)
 , m_is_debug((flags & MF_IS_DEBUG) != 0)
 , m_is_hashed((flags & MF_IS_HASHED) != 0)
+, m_phase_times()
+, m_has_image_key(false)
+, m_image_key()
 , m_sema_version(NULL)
 , m_mdl_version(version)
 , m_msg_list(alloc, file_name)
@@ -329,12 +332,22 @@ bool Module::analyze(
         ctx  = hctx.get();
     }
 
+    // imported modules are compiled during name and type analysis, exclude their time
+    double                                import_time = ctx->get_module_load_time();
+    std::chrono::steady_clock::time_point start       = std::chrono::steady_clock::now();
+
     NT_analysis nt_analysis(m_compiler, *this, *ctx, cache);
     nt_analysis.run();
 
+    m_phase_times.nt = seconds_since(start) - (ctx->get_module_load_time() - import_time);
+    start = std::chrono::steady_clock::now();
+
     Sema_analysis sema_analysis(m_compiler, *this, *ctx);
     sema_analysis.run();
 
+    m_phase_times.sema = seconds_since(start);
+    start = std::chrono::steady_clock::now();
+
     Optimizer::run(
         m_compiler,
         *this,
@@ -342,6 +355,8 @@ bool Module::analyze(
         nt_analysis,
         sema_analysis.get_statement_info_data());
 
+    m_phase_times.opt = seconds_since(start);
+
     // run the checker
     MDL_ASSERT(
         Module_checker::check(m_compiler, this, /*verbose=*/false) && "Module check failed");
@@ -380,6 +395,16 @@ void Module::get_all_function_hashes(
 }
 
 
+// Get the key of the module image cache entry of this module.
+bool Module::get_image_key(unsigned char key[16]) const
+{
+    if (!m_has_image_key) {
+        return false;
+    }
+    memcpy(key, m_image_key, sizeof(m_image_key));
+    return true;
+}
+
 // Check if the module has been analyzed.
 bool Module::is_analyzed() const
 {
@@ -3609,7 +3634,21 @@ Module const *Module::deserialize(Module_deserializer &deserializer)
     IMDL::MDL_version mdl_version = IMDL::MDL_version(deserializer.read_encoded_tag());
     DOUT(("version: %u\n", mdl_version));
 
-    Module *mod = deserializer.create_module(mdl_version, is_analyzed);
+    // Standard library modules are only deserialized from builtin module snapshots. The empty
+    // module must be analyzed like a standard library module then, in particular it must not
+    // import the (not yet existing) ::<builtins> module. Compiler owned modules must not
+    // reference the compiler.
+    unsigned flags = Module::MF_STANDARD;
+    if (is_compiler_owned) {
+        flags |= Module::MF_IS_OWNED;
+    }
+    if (is_stdlib) {
+        flags |= Module::MF_IS_STDLIB;
+    }
+    if (is_builtins) {
+        flags |= Module::MF_IS_BUILTIN;
+    }
+    Module *mod = deserializer.create_module(mdl_version, is_analyzed, flags);
     deserializer.register_module(t, mod);
 
     mod->set_filename(filename.c_str());
@@ -151,6 +151,16 @@ public:
 
     typedef set<Function_hash>::Type Function_hash_set;
 
+    /// Wall clock times of the compiler phases for this module in seconds.
+    ///
+    /// The time spent on compiling imported modules is not included.
+    struct Phase_times {
+        double parse;  ///< Scanning and parsing.
+        double nt;     ///< Name and type analysis.
+        double sema;   ///< Semantic analysis.
+        double opt;    ///< Optimization.
+    };
+
     /// An archive version.
     class Archive_version {
     public:
@@ -227,6 +237,18 @@ public:
     /// Check if the module has been analyzed.
     bool is_analyzed() const MDL_FINAL;
 
+    /// Get the compiler phase times of this module.
+    ///
+    /// All times are zero for modules that were not compiled from source in this process.
+    Phase_times const &get_phase_times() const { return m_phase_times; }
+
+    /// Get the key of the module image cache entry of this module.
+    ///
+    /// \param[out] key  the key
+    ///
+    /// \return false if this module was not compiled through the module image cache
+    bool get_image_key(unsigned char key[16]) const;
+
     /// Check if the module contents are valid.
     bool is_valid() const MDL_FINAL;
 
@@ -1267,6 +1289,15 @@ private:
     /// Set if this module has function hashes.
     bool m_is_hashed;
 
+    /// The compiler phase times of this module.
+    Phase_times m_phase_times;
+
+    /// Set if this module was compiled through the module image cache.
+    bool m_has_image_key;
+
+    /// The key of the module image cache entry of this module, see get_image_key().
+    unsigned char m_image_key[16];
+
     /// The semantic version if any.
     Semantic_version const *m_sema_version;
 
@@ -531,7 +531,8 @@ Entity_serializer::Entity_serializer(
 MDL_binary_serializer::MDL_binary_serializer(
     IAllocator  *alloc,
     MDL const   *compiler,
-    ISerializer *serializer)
+    ISerializer *serializer,
+    size_t      n_builtins)
 : Entity_serializer(alloc, serializer)
 , m_modules(alloc)
 , m_id_map(0, Id_map::hasher(), Id_map::key_equal(), alloc)
@@ -542,7 +543,11 @@ MDL_binary_serializer::MDL_binary_serializer(
     Tag_t t, check(0);
 #endif
 
-    for (size_t i = 0, n = compiler->get_builtin_module_count(); i < n; ++i) {
+    size_t n = compiler->get_builtin_module_count();
+    if (n_builtins < n) {
+        n = n_builtins;
+    }
+    for (size_t i = 0; i < n; ++i) {
         Module const *builtin_mod = compiler->get_builtin_module(i);
 #ifdef ENABLE_ASSERT
         t =
@@ -3830,10 +3835,12 @@ void Module_deserializer::read_unreferenced_init_expressions(Module &mod)
 // Creates a new (empty) module.
 Module *Module_deserializer::create_module(
     IMDL::MDL_version mdl_version,
-    bool              analyzed)
+    bool              analyzed,
+    unsigned          flags)
 {
     // create an new empty module
-    Module *mod = m_compiler->create_module(/*context=*/NULL, /*module_name=*/NULL, mdl_version);
+    Module *mod = m_compiler->create_module(
+        /*module_name=*/NULL, /*file_name=*/NULL, mdl_version, flags);
 
     if (analyzed) {
         // analyze it, this will create all the predefined entities the deserializer needs
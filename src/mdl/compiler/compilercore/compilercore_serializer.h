@@ -646,10 +646,13 @@ public:
     /// \param alloc       the allocator
     /// \param compiler    the compiler
     /// \param serializer  the serializer used to write the low level data.
+    /// \param n_builtins  the number of builtin modules that are known by the reader,
+    ///                    all builtin modules if larger than their count
     MDL_binary_serializer(
         IAllocator  *alloc,
         MDL const   *compiler,
-        ISerializer *serializer);
+        ISerializer *serializer,
+        size_t      n_builtins = ~size_t(0));
 
 private:
     /// pointer serializer for imported modules.
@@ -1344,6 +1347,8 @@ public:
 
     /// Constructor.
     ///
+    /// All builtin modules currently registered at the compiler are known by the deserializer.
+    ///
     /// \param alloc         the allocator
     /// \param deserializer  the deserializer used to write the low level data.
     /// \param compiler      the compiler
@@ -1642,11 +1647,13 @@ public:
     ///
     /// \param mdl_version  the MDL language level of the module
     /// \param analyzed     true, if an analyzed module will be deserialized
+    /// \param flags        module property flags affecting the analysis of the empty module
     ///
     /// \return a new empty module
     Module *create_module(
         IMDL::MDL_version mdl_version,
-        bool              analyzed);
+        bool              analyzed,
+        unsigned          flags);
 
     /// Constructor.
     ///
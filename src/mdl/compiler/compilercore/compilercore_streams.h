@@ -38,6 +38,21 @@
 namespace mi {
 namespace mdl {
 
+/// The interface of an input stream that can read blocks of characters.
+class IBlock_input_stream : public
+    mi::base::Interface_declare<0xa871f6ff,0x6acc,0x4c42,0xa5,0xff,0x58,0xf9,0xac,0xbd,0x4c,0xf9,
+    IInput_stream>
+{
+public:
+    /// Read a block of characters from the input stream.
+    ///
+    /// \param buffer  the destination buffer
+    /// \param size    the size of the destination buffer
+    ///
+    /// \returns    The number of characters read, 0 at the end of the stream.
+    virtual size_t read(char *buffer, size_t size) = 0;
+};
+
 /// Implementation of the IInput_stream interface using FILE I/O.
 class File_Input_stream : public Allocator_interface_implement<IInput_stream>
 {
@@ -114,6 +114,7 @@ Thread_context::Thread_context(
 , m_repl_module_name(alloc)
 , m_repl_file_name(alloc)
 , m_all_warnings_are_off(false)
+, m_module_load_time(0.0)
 {
     // copy options
     for (int i = 0, n = options->get_option_count(); i < n; ++i) {
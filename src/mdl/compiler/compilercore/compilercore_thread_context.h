@@ -183,6 +183,14 @@ public:
     /// Return true if all warnings are disabled.
     bool all_warnings_are_off() const { return m_all_warnings_are_off; }
 
+    /// Get the time spent compiling modules from source on this context in seconds.
+    ///
+    /// Every module contributes only its own time, not the time of its imports.
+    double get_module_load_time() const { return m_module_load_time; }
+
+    /// Add the time spent compiling one module from source on this context.
+    void add_module_load_time(double seconds) { m_module_load_time += seconds; }
+
 private:
     /// Constructor.
     ///
@@ -220,6 +228,9 @@ private:
 
     /// If true, disable all warnings.
     bool m_all_warnings_are_off;
+
+    /// The time spent compiling modules from source.
+    double m_module_load_time;
 };
 
 }  // mdl
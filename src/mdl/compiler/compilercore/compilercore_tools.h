@@ -29,6 +29,8 @@
 #ifndef MDL_COMPILERCORE_TOOLS_H
 #define MDL_COMPILERCORE_TOOLS_H 1
 
+#include <chrono>
+
 #include <mi/mdl/mdl_types.h>
 
 #include "compilercore_mdl.h"
@@ -54,6 +56,12 @@ class IType_array_size;
 template<typename T, size_t n>
 inline size_t dimension_of(T (&c)[n]) { return n; }
 
+/// Returns the seconds elapsed since the given time point.
+inline double seconds_since(std::chrono::steady_clock::time_point const &start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
 /// RAII-like store/restore facility for lvalues.
 template<typename T>
 class Store {
@@ -340,7 +340,7 @@ Uint64 MDL_zip_resource_reader::tell()
 // Reposition stream position indicator.
 bool MDL_zip_resource_reader::seek(Sint64 offset, Position origin)
 {
-    return m_file->get_container_file()->seek(offset, origin) != 0;
+    return m_file->get_container_file()->seek(offset, origin) == 0;
 }
 
 // Get the UTF8 encoded name of the resource on which this reader operates.
@@ -371,6 +371,15 @@ bool MDL_zip_resource_reader::get_resource_hash(unsigned char hash[16])
     return false;
 }
 
+// Get the data of the resource if it is stored uncompressed in a mapped container.
+unsigned char const *MDL_zip_resource_reader::get_mapped_data(Uint64 &size) const
+{
+    size_t view_size = 0;
+    unsigned char const *data = m_file->get_container_file()->get_view_data(view_size);
+    size = data != NULL ? Uint64(view_size) : 0;
+    return data;
+}
+
 // Constructor.
 MDL_zip_resource_reader::MDL_zip_resource_reader(
     IAllocator  *alloc,
@@ -393,6 +402,18 @@ MDL_zip_resource_reader::~MDL_zip_resource_reader()
 
 // ------------------------------------------------------------------------------------------------
 
+/// Read a 16bit little endian value.
+static inline unsigned read_le16(unsigned char const *p)
+{
+    return unsigned(p[0]) | (unsigned(p[1]) << 8);
+}
+
+/// Read a 32bit little endian value.
+static inline size_t read_le32(unsigned char const *p)
+{
+    return size_t(p[0]) | (size_t(p[1]) << 8) | (size_t(p[2]) << 16) | (size_t(p[3]) << 24);
+}
+
 static MDL_zip_container_error_code translate_zip_error(zip_error_t const &ze)
 {
     switch (ze.zip_err)
@@ -572,12 +593,99 @@ MDL_zip_container::MDL_zip_container(
 , m_za(za)
 , m_header("\0\0\0\0", 4, 0, 0)
 , m_has_resource_hashes(supports_resource_hashes)
+, m_mapping(NULL)
+, m_stored_members(alloc)
+, m_lock()
+, m_refcount(1)
 {
+    map_stored_members();
 }
 
 // Destructor
 MDL_zip_container::~MDL_zip_container()
 {
+    Mapped_file::close(m_mapping);
+}
+
+// Map the container file and locate the members stored uncompressed inside it.
+void MDL_zip_container::map_stored_members()
+{
+    m_mapping = Mapped_file::open(m_alloc, m_path.c_str());
+    if (m_mapping == NULL) {
+        // members are read through libzip only
+        return;
+    }
+
+    // the zip data starts behind the container header, all zip offsets are relative to it
+    unsigned char const *zip  = m_mapping->get_data() + 8;
+    size_t              size  = m_mapping->get_size() - 8;
+
+    // find the end of central directory record, it might be followed by a comment
+    size_t const eocd_size = 22;
+    if (m_mapping->get_size() < 8 + eocd_size) {
+        return;
+    }
+    size_t eocd = size - eocd_size;
+    size_t min_eocd = size > eocd_size + 0xFFFF ? size - eocd_size - 0xFFFF : 0;
+    for (;; --eocd) {
+        if (read_le32(zip + eocd) == 0x06054b50) {
+            break;
+        }
+        if (eocd == min_eocd) {
+            return;
+        }
+    }
+
+    size_t n_entries = read_le16(zip + eocd + 10);
+    size_t cd_size   = read_le32(zip + eocd + 12);
+    size_t cd_ofs    = read_le32(zip + eocd + 16);
+    if (n_entries == 0xFFFF || cd_ofs == 0xFFFFFFFF || cd_ofs > size || cd_size > size - cd_ofs) {
+        // ZIP64 archives are read through libzip only
+        return;
+    }
+
+    Stored_member_vector members(m_alloc);
+    members.reserve(n_entries);
+
+    unsigned char const *p   = zip + cd_ofs;
+    unsigned char const *end = p + cd_size;
+    for (size_t i = 0; i < n_entries; ++i) {
+        if (size_t(end - p) < 46 || read_le32(p) != 0x02014b50) {
+            return;
+        }
+        unsigned flags       = read_le16(p + 8);
+        unsigned method      = read_le16(p + 10);
+        size_t   comp_size   = read_le32(p + 20);
+        size_t   size_uncomp = read_le32(p + 24);
+        size_t   name_len    = read_le16(p + 28);
+        size_t   extra_len   = read_le16(p + 30);
+        size_t   comment_len = read_le16(p + 32);
+        size_t   local_ofs   = read_le32(p + 42);
+
+        if (size_t(end - p) < 46 + name_len + extra_len + comment_len) {
+            return;
+        }
+
+        Stored_member member = { p + 46, name_len, NULL, 0 };
+
+        // only unencrypted members without compression can be viewed directly
+        if (method == ZIP_CM_STORE && (flags & 1) == 0 && comp_size == size_uncomp &&
+            local_ofs < size && size - local_ofs >= 30 &&
+            read_le32(zip + local_ofs) == 0x04034b50)
+        {
+            size_t data_ofs = local_ofs + 30 +
+                read_le16(zip + local_ofs + 26) + read_le16(zip + local_ofs + 28);
+            if (data_ofs <= size && size - data_ofs >= comp_size) {
+                member.data = zip + data_ofs;
+                member.size = comp_size;
+            }
+        }
+        members.push_back(member);
+
+        p += 46 + name_len + extra_len + comment_len;
+    }
+
+    m_stored_members.swap(members);
 }
 
 // Open a container file.
@@ -680,6 +788,10 @@ zip_t *MDL_zip_container::open(
 // Close an MDL container.
 void MDL_zip_container::close()
 {
+    if (--m_refcount != 0) {
+        return;
+    }
+
     zip_close(m_za);
 
     Allocator_builder builder(m_alloc);
@@ -689,12 +801,14 @@ void MDL_zip_container::close()
 // Get the number of files inside an container.
 int MDL_zip_container::get_num_entries()
 {
+    mi::base::Lock::Block block(&m_lock);
     return zip_get_num_files(m_za);
 }
 
 // Get the i'th file name inside an container.
 char const *MDL_zip_container::get_entry_name(int i)
 {
+    mi::base::Lock::Block block(&m_lock);
     return zip_get_name(m_za, i, ZIP_FL_ENC_STRICT);
 }
 
@@ -705,6 +819,8 @@ bool MDL_zip_container::contains(
     // ZIP uses '/'
     string forward(file_name, m_alloc);
     forward = convert_os_separators_to_slashes(forward);
+
+    mi::base::Lock::Block block(&m_lock);
     return zip_name_locate(m_za, forward.c_str(), ZIP_FL_ENC_STRICT) != -1;
 }
 
@@ -715,6 +831,8 @@ bool MDL_zip_container::contains_mask(
     // ZIP uses '/'
     string forward(file_mask, m_alloc);
     forward = convert_os_separators_to_slashes(forward);
+
+    mi::base::Lock::Block block(&m_lock);
     for (int i = 0, n = zip_get_num_files(m_za); i < n; ++i) {
         char const *file_name = zip_get_name(m_za, i, ZIP_FL_ENC_STRICT);
 
@@ -730,7 +848,7 @@ MDL_zip_container_file *MDL_zip_container::file_open(char const *name) const
     // ZIP uses '/'
     string zip_name(name, m_alloc);
     zip_name = convert_os_separators_to_slashes(zip_name);
-    return MDL_zip_container_file::open(m_alloc, m_za, zip_name.c_str());
+    return MDL_zip_container_file::open(this, zip_name.c_str());
 }
 
 // Compute the MD5 hash for a file inside a container.
@@ -783,20 +901,165 @@ size_t MDL_zip_container::file_length(FILE *fp)
 
 // ------------------------------------------------------------------------------------------------
 
+namespace {
+
+/// An entry of the container cache.
+struct Container_cache_entry {
+    MDL_zip_container *container;   ///< The cached container or NULL if this entry is free.
+    size_t            file_size;    ///< The size of the container file when it was opened.
+    long long         file_mtime;   ///< The modification time of the file when it was opened.
+    unsigned          last_use;     ///< The last use stamp.
+};
+
+/// The maximum number of cached containers.
+size_t const container_cache_size = 16;
+
+/// The container cache, protected by g_container_cache_lock.
+Container_cache_entry g_container_cache[container_cache_size];
+
+/// The current use stamp of the container cache.
+unsigned g_container_cache_stamp = 0;
+
+/// The lock protecting the container cache.
+mi::base::Lock g_container_cache_lock;
+
+/// Drop the cache reference of an entry.
+void drop_container_cache_entry(Container_cache_entry &e)
+{
+    if (e.container != NULL) {
+        e.container->close();
+        e.container = NULL;
+    }
+}
+
+}  // anonymous
+
+// Look up an open container.
+MDL_zip_container *MDL_zip_container_cache::lookup(
+    IAllocator *alloc,
+    char const *path,
+    char const prefix[4])
+{
+    size_t    file_size  = 0;
+    long long file_mtime = 0;
+    if (!get_file_info_utf8(alloc, path, file_size, file_mtime)) {
+        return NULL;
+    }
+
+    mi::base::Lock::Block block(&g_container_cache_lock);
+
+    for (size_t i = 0; i < container_cache_size; ++i) {
+        Container_cache_entry &e = g_container_cache[i];
+        if (e.container == NULL ||
+            e.container->get_allocator() != alloc ||
+            strcmp(e.container->get_container_name(), path) != 0 ||
+            memcmp(e.container->get_header().prefix, prefix, 4) != 0)
+        {
+            continue;
+        }
+
+        if (e.file_size != file_size || e.file_mtime != file_mtime) {
+            // the container file was changed
+            drop_container_cache_entry(e);
+            return NULL;
+        }
+
+        e.last_use = ++g_container_cache_stamp;
+        e.container->retain();
+        return e.container;
+    }
+    return NULL;
+}
+
+// Insert an open container, the cache acquires its own reference.
+void MDL_zip_container_cache::insert(MDL_zip_container *container)
+{
+    size_t    file_size  = 0;
+    long long file_mtime = 0;
+    if (!get_file_info_utf8(
+            container->get_allocator(), container->get_container_name(), file_size, file_mtime))
+    {
+        return;
+    }
+
+    mi::base::Lock::Block block(&g_container_cache_lock);
+
+    // replace an outdated entry of the same container or the least recently used one
+    Container_cache_entry *victim = &g_container_cache[0];
+    for (size_t i = 0; i < container_cache_size; ++i) {
+        Container_cache_entry &e = g_container_cache[i];
+        if (e.container == NULL) {
+            if (victim->container != NULL) {
+                victim = &e;
+            }
+            continue;
+        }
+        if (e.container->get_allocator() == container->get_allocator() &&
+            strcmp(e.container->get_container_name(), container->get_container_name()) == 0)
+        {
+            victim = &e;
+            break;
+        }
+        if (victim->container != NULL && e.last_use < victim->last_use) {
+            victim = &e;
+        }
+    }
+
+    drop_container_cache_entry(*victim);
+
+    container->retain();
+    victim->container  = container;
+    victim->file_size  = file_size;
+    victim->file_mtime = file_mtime;
+    victim->last_use   = ++g_container_cache_stamp;
+}
+
+// Drop a container from the cache.
+void MDL_zip_container_cache::remove(char const *path)
+{
+    mi::base::Lock::Block block(&g_container_cache_lock);
+
+    for (size_t i = 0; i < container_cache_size; ++i) {
+        Container_cache_entry &e = g_container_cache[i];
+        if (e.container != NULL && strcmp(e.container->get_container_name(), path) == 0) {
+            drop_container_cache_entry(e);
+        }
+    }
+}
+
+// Drop all containers that were opened with the given allocator.
+void MDL_zip_container_cache::flush(IAllocator *alloc)
+{
+    mi::base::Lock::Block block(&g_container_cache_lock);
+
+    for (size_t i = 0; i < container_cache_size; ++i) {
+        Container_cache_entry &e = g_container_cache[i];
+        if (e.container != NULL && e.container->get_allocator() == alloc) {
+            drop_container_cache_entry(e);
+        }
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+
 // Trash buffer.
 char MDL_zip_container_file::g_trash[1024];
 
 // Constructor.
 MDL_zip_container_file::MDL_zip_container_file(
-    IAllocator   *alloc,
-    zip_t        *za,
-    zip_file_t   *f,
-    zip_uint64_t index,
-    zip_uint64_t file_len,
-    bool         no_seek)
+    IAllocator          *alloc,
+    zip_t               *za,
+    mi::base::Lock      *lock,
+    zip_file_t          *f,
+    zip_uint64_t        index,
+    zip_uint64_t        file_len,
+    bool                no_seek,
+    unsigned char const *view)
 : m_alloc(alloc)
 , m_za(za)
+, m_lock(lock)
 , m_f(f)
+, m_view(view)
 , m_index(index)
 , m_ofs(0)
 , m_file_len(file_len)
@@ -807,8 +1070,10 @@ MDL_zip_container_file::MDL_zip_container_file(
 // Destructor.
 MDL_zip_container_file::~MDL_zip_container_file()
 {
-    if (m_f != NULL)
+    if (m_f != NULL) {
+        mi::base::Lock::Block block(m_lock);
         zip_fclose(m_f);
+    }
 }
 
 // Close a file inside an archive.
@@ -821,11 +1086,20 @@ void MDL_zip_container_file::close()
 // Read from a file inside an archive.
 zip_int64_t MDL_zip_container_file::read(void *buffer, zip_uint64_t len)
 {
+    if (m_view != NULL) {
+        zip_uint64_t n = m_file_len - m_ofs;
+        if (len < n)
+            n = len;
+        memcpy(buffer, m_view + m_ofs, size_t(n));
+        m_ofs += n;
+        return zip_int64_t(n);
+    }
     if (m_f == NULL) {
         // happens, if reopen failed
         return -1;
     }
 
+    mi::base::Lock::Block block(m_lock);
     zip_int64_t res = zip_fread(m_f, buffer, len);
 
     if (res > 0)
@@ -836,10 +1110,11 @@ zip_int64_t MDL_zip_container_file::read(void *buffer, zip_uint64_t len)
 // Seek inside a file inside an archive.
 zip_int64_t MDL_zip_container_file::seek(zip_int64_t offset, int origin)
 {
-    if (m_have_seek_tell) {
+    if (m_view == NULL && m_have_seek_tell) {
+        mi::base::Lock::Block block(m_lock);
         return zip_fseek(m_f, offset, origin);
     }
-    if (m_f == NULL) {
+    if (m_view == NULL && m_f == NULL) {
         // happens, if reopen failed
         return -1;
     }
@@ -871,8 +1146,15 @@ zip_int64_t MDL_zip_container_file::seek(zip_int64_t offset, int origin)
     if (nofs > m_file_len)
         nofs = m_file_len;
 
+    if (m_view != NULL) {
+        // views support real seeks
+        m_ofs = nofs;
+        return 0;
+    }
+
     if (nofs < m_file_len) {
         // seek backwards, reopen
+        mi::base::Lock::Block block(m_lock);
         zip_fclose(m_f);
 
         m_f = zip_fopen_index(m_za, m_index, 0);
@@ -899,7 +1181,11 @@ zip_int64_t MDL_zip_container_file::seek(zip_int64_t offset, int origin)
 // Get the current file position.
 zip_int64_t MDL_zip_container_file::tell()
 {
+    if (m_view != NULL) {
+        return zip_int64_t(m_ofs);
+    }
     if (m_have_seek_tell) {
+        mi::base::Lock::Block block(m_lock);
         return zip_ftell(m_f);
     }
     if (m_f == NULL) {
@@ -915,6 +1201,8 @@ unsigned char const *MDL_zip_container_file::get_extra_field(
     zip_uint16_t extra_field_id,
     size_t       &length)
 {
+    mi::base::Lock::Block block(m_lock);
+
     zip_uint16_t lenp = 0;
     zip_uint8_t const *data = zip_file_extra_field_get_by_id(
         m_za,
@@ -932,16 +1220,41 @@ unsigned char const *MDL_zip_container_file::get_extra_field(
     return NULL;
 }
 
+// Get the data of this file if it is a view into the mapped container file.
+unsigned char const *MDL_zip_container_file::get_view_data(size_t &size) const
+{
+    size = m_view != NULL ? size_t(m_file_len) : 0;
+    return m_view;
+}
+
 // Opens a file inside a container.
 MDL_zip_container_file *MDL_zip_container_file::open(
-    IAllocator *alloc,
-    zip_t      *za,
-    char const *name)
+    MDL_zip_container const *container,
+    char const              *name)
 {
+    IAllocator *alloc = container->m_alloc;
+    zip_t      *za    = container->m_za;
+
+    mi::base::Lock::Block block(&container->m_lock);
+
     zip_int64_t index = zip_name_locate(za, name, 0);
     if (index < 0) {
         return NULL;
     }
+
+    // serve members stored uncompressed directly from the mapped container file
+    if (size_t(index) < container->m_stored_members.size()) {
+        MDL_zip_container::Stored_member const &m = container->m_stored_members[index];
+        size_t name_len = strlen(name);
+        if (m.data != NULL && m.name_len == name_len && memcmp(m.name, name, name_len) == 0) {
+            Allocator_builder builder(alloc);
+
+            return builder.create<MDL_zip_container_file>(
+                alloc, za, &container->m_lock, (zip_file_t *)NULL, zip_uint64_t(index),
+                zip_uint64_t(m.size), /*no_seek=*/false, m.data);
+        }
+    }
+
     zip_file_t *f = zip_fopen_index(za, index, 0);
     if (f == NULL) {
         return NULL;
@@ -970,7 +1283,9 @@ MDL_zip_container_file *MDL_zip_container_file::open(
 
     Allocator_builder builder(alloc);
 
-    return builder.create<MDL_zip_container_file>(alloc, za, f, index, file_len, forbid_seek);
+    return builder.create<MDL_zip_container_file>(
+        alloc, za, &container->m_lock, f, zip_uint64_t(index), file_len, forbid_seek,
+        (unsigned char const *)NULL);
 }
 
 //-------------------------------------------------------------------------------------------------
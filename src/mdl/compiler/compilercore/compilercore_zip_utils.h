@@ -29,6 +29,9 @@
 #ifndef MDL_COMPILERCORE_ZIP_UTILS_H
 #define MDL_COMPILERCORE_ZIP_UTILS_H 1
 
+#include <mi/base/lock.h>
+#include <mi/base/atom.h>
+
 #include "compilercore_allocator.h"
 #include <base/lib/libzip/zip.h>
 #include <mi/mdl/mdl_entity_resolver.h>
@@ -38,6 +41,7 @@ namespace mi {
 namespace mdl {
 
 class File_handle;
+class Mapped_file;
 class MDL_zip_container;
 class MDL_zip_container_file;
 
@@ -160,9 +164,9 @@ private:
 // --------------------------------------------------------------------------
 
 /// Implementation of a resource reader from a file.
-class MDL_zip_resource_reader : public Allocator_interface_implement<IMDL_resource_reader>
+class MDL_zip_resource_reader : public Allocator_interface_implement<IMDL_mapped_resource_reader>
 {
-    typedef Allocator_interface_implement<IMDL_resource_reader> Base;
+    typedef Allocator_interface_implement<IMDL_mapped_resource_reader> Base;
 public:
     /// Read a memory block from the resource.
     ///
@@ -198,6 +202,11 @@ public:
     /// \return true if this resource has an associated hash value, false otherwise
     bool get_resource_hash(unsigned char hash[16]) MDL_FINAL;
 
+    /// Get the data of the resource if it is stored uncompressed in a mapped container.
+    ///
+    /// \param[out] size  the size of the resource data in bytes
+    unsigned char const *get_mapped_data(Uint64 &size) const MDL_FINAL;
+
     /// Constructor.
     ///
     /// \param alloc             the allocator
@@ -254,11 +263,17 @@ enum MDL_zip_container_error_code
 class MDL_zip_container
 {
     friend class Allocator_builder;
+    friend class MDL_zip_container_file;
 
 public:
     /// Close an MDL archive.
+    ///
+    /// Containers are reference counted, the container is destroyed with its last reference.
     void close();
 
+    /// Acquire a new reference, must be released by close().
+    void retain() const { ++m_refcount; }
+
     /// Get the number of files inside an archive. 
     int get_num_entries();
 
@@ -301,6 +316,9 @@ public:
     /// Returns true if this container supports resource hashes.
     bool has_resource_hashes() const { return m_has_resource_hashes; }
 
+    /// Get the header of this container.
+    MDL_zip_container_header const &get_header() const { return m_header; }
+
 protected:
     /// Constructor.
     explicit MDL_zip_container(
@@ -330,6 +348,9 @@ private:
     // Get the length of a file from the file pointer.
     static size_t file_length(FILE *fp);
 
+    /// Map the container file and locate the members stored uncompressed inside it.
+    void map_stored_members();
+
     // non copyable
     MDL_zip_container(MDL_zip_container const &) MDL_DELETED_FUNCTION;
     MDL_zip_container &operator=(MDL_zip_container const &) MDL_DELETED_FUNCTION;
@@ -349,6 +370,61 @@ protected:
 
     /// True, if this container supports resource hashes.
     bool m_has_resource_hashes;
+
+private:
+    /// A member stored uncompressed inside the mapped container file.
+    struct Stored_member {
+        unsigned char const *name;      ///< The name inside the central directory.
+        size_t              name_len;   ///< The length of the name.
+        unsigned char const *data;      ///< The data or NULL if the member is not stored.
+        size_t              size;       ///< The size of the data.
+    };
+
+    typedef vector<Stored_member>::Type Stored_member_vector;
+
+    /// The memory mapping of the container file if any.
+    Mapped_file *m_mapping;
+
+    /// The members of the container, in central directory order.
+    Stored_member_vector m_stored_members;
+
+    /// Serializes all libzip operations, containers are shared between threads.
+    mutable mi::base::Lock m_lock;
+
+    /// The reference count.
+    mutable mi::base::Atom32 m_refcount;
+};
+
+/// A process wide cache of open MDL containers.
+///
+/// Keeps recently used archives and MDLE files open, so repeated member lookups neither reopen
+/// the container file nor parse its central directory and manifest again.
+class MDL_zip_container_cache
+{
+public:
+    /// Look up an open container.
+    ///
+    /// \param alloc   the allocator the container must have been opened with
+    /// \param path    the UTF8 encoded container path
+    /// \param prefix  the expected header prefix of the container
+    ///
+    /// \return a new reference to the container or NULL if it is not cached or the file has
+    ///         changed since it was opened
+    static MDL_zip_container *lookup(
+        IAllocator *alloc,
+        char const *path,
+        char const prefix[4]);
+
+    /// Insert an open container, the cache acquires its own reference.
+    static void insert(MDL_zip_container *container);
+
+    /// Drop a container from the cache, must be called before a container file is written.
+    ///
+    /// \param path  the UTF8 encoded container path
+    static void remove(char const *path);
+
+    /// Drop all containers that were opened with the given allocator.
+    static void flush(IAllocator *alloc);
 };
 
 /// Helper class for file from an archive.
@@ -386,31 +462,41 @@ public:
     /// \return                 content of the extra field. Memory is managed by the zip archive.
     unsigned char const *get_extra_field(zip_uint16_t extra_field_id, size_t &length);
 
+    /// Get the data of this file if it is a view into the mapped container file.
+    ///
+    /// \param[out] size  the size of the data
+    ///
+    /// \return the data or NULL if this file is read through libzip
+    unsigned char const *get_view_data(size_t &size) const;
+
 private:
     /// Opens a file inside a container.
     ///
-    /// \param alloc  the allocator
-    /// \param za     the zip archive handle
-    /// \param name   the name inside the container (full path using '/' as separator)
+    /// \param container  the container
+    /// \param name       the name inside the container (full path using '/' as separator)
     static MDL_zip_container_file *open(
-        IAllocator *alloc,
-        zip_t      *za,
-        char const *name);
+        MDL_zip_container const *container,
+        char const              *name);
 
     /// Constructor.
     ///
-    /// \param alloc    the allocator
-    /// \param za       the zip archive handle
-    /// \param f        the zip file handle
-    /// \param index    the associated index of the file inside the zip archive
-    /// \param no_seek  if true, seek operation is not possible
+    /// \param alloc      the allocator
+    /// \param za         the zip archive handle
+    /// \param lock       the lock serializing libzip operations on za
+    /// \param f          the zip file handle, NULL for views
+    /// \param index      the associated index of the file inside the zip archive
+    /// \param file_len   the length of the file
+    /// \param no_seek    if true, seek operation is not possible
+    /// \param view       if non-NULL, the data of the file inside the mapped container file
     explicit MDL_zip_container_file(
-        IAllocator  *alloc,
-        zip_t       * za,
-        zip_file_t  *f,
-        zip_uint64_t index,
-        zip_uint64_t file_len,
-        bool         no_seek);
+        IAllocator          *alloc,
+        zip_t               *za,
+        mi::base::Lock      *lock,
+        zip_file_t          *f,
+        zip_uint64_t        index,
+        zip_uint64_t        file_len,
+        bool                no_seek,
+        unsigned char const *view);
 
     /// Destructor.
     virtual ~MDL_zip_container_file();
@@ -422,9 +508,15 @@ private:
     /// The archive handle.
     zip_t        *m_za;
 
-    /// The file handle.
+    /// The lock serializing libzip operations on the archive handle.
+    mi::base::Lock *m_lock;
+
+    /// The file handle, NULL for views.
     zip_file_t   *m_f;
 
+    /// If non-NULL, the data of this file inside the mapped container file.
+    unsigned char const *m_view;
+
     /// The index of the file inside the archive.
     zip_uint64_t m_index;
 
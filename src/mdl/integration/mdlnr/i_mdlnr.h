@@ -107,6 +107,11 @@ public:
     /// Indicates whether an attempt is made to expose names of let expressions.
     virtual bool get_expose_names_of_let_expressions() const = 0;
 
+    /// Indicates whether function bodies are converted into code DAGs on first access only.
+    ///
+    /// Configured via the registry key "mdl_lazy_function_bodies".
+    virtual bool get_lazy_function_bodies() const = 0;
+
     /// Returns the module wait queue.
     virtual MDL::Mdl_module_wait_queue* get_module_wait_queue() const = 0;
 };
@@ -29,6 +29,8 @@
 #include "pch.h"
 
 #include <map>
+#include <string>
+#include <thread>
 
 #include <mi/base/ilogger.h>
 #include <mi/base/plugin.h>
@@ -44,6 +46,7 @@
 #include <base/util/registry/i_config_registry.h>
 #include <base/data/serial/i_serializer.h>
 #include <base/system/stlext/i_stlext_no_unused_variable_warning.h>
+#include <base/system/version/i_version.h>
 
 #include "mdlnr.h"
 #include "mdlnr_search_path.h"
@@ -53,7 +56,9 @@
 #include <mdl/compiler/compilercore/compilercore_fatal.h>
 #include <mdl/compiler/compilercore/compilercore_debug_tools.h>
 #include <mdl/compiler/compilercore/compilercore_mdl.h>
+#include <mdl/compiler/compilercore/compilercore_file_resolution.h>
 #include <mdl/compiler/compilercore/compilercore_file_utils.h>
+#include <mdl/compiler/compilercore/compilercore_tools.h>
 #include <mdl/compiler/compilercore/compilercore_code_cache.h>
 #include <mdl/compiler/compilercore/compilercore_errors.h>
 
@@ -196,6 +201,7 @@ Mdlc_module_impl::Mdlc_module_impl()
   , m_code_cache(0)
   , m_implicit_cast_enabled(true)
   , m_expose_names_of_let_expressions(true)
+  , m_lazy_function_bodies(false)
   , m_module_wait_queue(0)
 {
 }
@@ -229,6 +235,9 @@ bool Mdlc_module_impl::init()
             mi::mdl::MDL::option_opt_level, std::to_string(opt_level).c_str());
     }
 
+    // function bodies are converted eagerly by default
+    registry.get_value("mdl_lazy_function_bodies", m_lazy_function_bodies);
+
     // neuray always runs in "relaxed" mode for compatibility with old releases
     options.set_option(mi::mdl::MDL::option_strict, "false");
 
@@ -236,6 +245,22 @@ bool Mdlc_module_impl::init()
     MDL_ASSERT(mi::mdl::DEPRECATED_ENTITY == 275);
     options.set_option(mi::mdl::MDL::option_warn, "275=off");
 
+    // the module image cache is disabled by default
+    std::string image_cache_path;
+    if (registry.get_value("mdl_module_image_cache_path", image_cache_path)
+        && !image_cache_path.empty()) {
+        options.set_option(
+            mi::mdl::MDL::option_module_image_cache_path, image_cache_path.c_str());
+    }
+
+    // imports are loaded concurrently by default, up to one thread per core, the module cache of
+    // the MDL integration lets threads wait for modules loaded by other threads. The registry key
+    // "mdl_parallel_import_threads" overrides the number of threads, 0 disables the preloading.
+    int import_threads = static_cast<int>(std::thread::hardware_concurrency());
+    registry.get_value("mdl_parallel_import_threads", import_threads);
+    options.set_option(
+        mi::mdl::MDL::option_parallel_import_threads, std::to_string(import_threads).c_str());
+
 
 
     mi::mdl::Allocator_builder builder(m_allocator.get());
@@ -246,7 +271,23 @@ bool Mdlc_module_impl::init()
         cache_size = v;
     }
 
-    m_code_cache = builder.create<mi::mdl::Code_cache>(m_allocator.get(), cache_size);
+    // the persistent disk tier is disabled by default, 1GB size limit if enabled
+    std::string cache_path;
+    registry.get_value("mdl_target_code_cache_path", cache_path);
+    size_t disk_cache_size = 1024*1024*1024;
+    if (registry.get_value("mdl_target_code_cache_disk_size", v)) {
+        disk_cache_size = v;
+    }
+
+    // disk tier entries are only valid for the exact same build
+    std::string version_tag = std::string(VERSION::get_platform_version()) + " " + MI_PLATFORM;
+
+    m_code_cache = builder.create<mi::mdl::Code_cache>(
+        m_allocator.get(),
+        cache_size,
+        cache_path.c_str(),
+        disk_cache_size,
+        version_tag.c_str());
 
     m_module_wait_queue = new MDL::Mdl_module_wait_queue();
 
@@ -258,6 +299,15 @@ void Mdlc_module_impl::exit()
 {
 
     if (m_mdl) {
+        // report the file resolution cache statistics once, on the I/O category at stat level
+        mi::mdl::File_resolution_cache::Statistics stats(
+            mi::mdl::impl_cast<mi::mdl::MDL>(m_mdl)->get_file_resolution_cache().get_statistics());
+        LOG::mod_log->stat(M_MDLC, LOG::ILogger::C_IO,
+            "File resolution cache: %zu lookups, %zu hits, %zu file system calls, "
+            "%zu file system calls saved, %zu invalidations, %zu negative flushes",
+            stats.m_lookups, stats.m_hits, stats.m_fs_calls,
+            stats.m_fs_calls_saved, stats.m_invalidations, stats.m_negative_flushes);
+
         m_mdl->release();
         m_mdl = nullptr;
     }
@@ -358,6 +408,11 @@ bool Mdlc_module_impl::get_expose_names_of_let_expressions() const
     return m_expose_names_of_let_expressions;
 }
 
+bool Mdlc_module_impl::get_lazy_function_bodies() const
+{
+    return m_lazy_function_bodies;
+}
+
 MDL::Mdl_module_wait_queue* Mdlc_module_impl::get_module_wait_queue() const
 {
     return m_module_wait_queue;
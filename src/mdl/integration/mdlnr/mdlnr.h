@@ -85,6 +85,8 @@ public:
 
     bool get_expose_names_of_let_expressions() const;
 
+    bool get_lazy_function_bodies() const;
+
     MDL::Mdl_module_wait_queue* get_module_wait_queue() const;
 
 private:
@@ -119,6 +121,9 @@ private:
     /// Flag that indicates whether the integration should insert casts when needed (and possible).
     bool m_expose_names_of_let_expressions;
 
+    /// Flag that indicates whether function bodies are converted on first access only.
+    bool m_lazy_function_bodies;
+
     /// The module wait queue.
     MDL::Mdl_module_wait_queue *m_module_wait_queue;
 
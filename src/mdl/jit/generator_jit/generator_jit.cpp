@@ -156,6 +156,11 @@ static void fill_default_cg_options(
         "",
         "Comma-separated list of names of functions which will be visible in the generated code "
         "(empty string means no special restriction).");
+    options.add_option(
+        MDL_JIT_OPTION_NUM_CODEGEN_PARTITIONS,
+        "1",
+        "The maximum number of partitions generated PTX code is compiled in parallel "
+        "(1 disables splitting, 0 uses one partition per hardware thread)");
 
     options.add_binary_option(
         MDL_JIT_BINOPTION_LLVM_STATE_MODULE,
@@ -1338,6 +1343,7 @@ void Code_generator_jit::enter_code_into_cache(
         info.dist_kind = code->get_distribution_kind(i);
         info.func_kind = code->get_function_kind(i);
         info.arg_block_index = code->get_function_arg_block_layout_index(i);
+        info.state_usage = code->get_function_state_usage(i);
 
         for (int j = 0 ; j < int(IGenerated_code_executable::PL_NUM_LANGUAGES); ++j) {
             char const *prototype = code->get_function_prototype(
@@ -29,9 +29,7 @@
 
 #include "pch.h"
 
-#include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/IR/Module.h>
-#include <llvm/Support/MemoryBuffer.h>
 
 #include "mdl/compiler/compilercore/compilercore_tools.h"
 #include "mdl/compiler/compilercore/compilercore_assert.h"
@@ -91,18 +89,16 @@ std::unique_ptr<llvm::Module> LLVM_code_generator::load_libbsdf(
         return nullptr;
     }
 
-    std::unique_ptr<llvm::MemoryBuffer> mem(llvm::MemoryBuffer::getMemBuffer(
-        llvm::StringRef((char const *) bitcode, bitcode_size),
-        "libbsdf",
-        /*RequiresNullTerminator=*/ false));
-
-    auto mod = llvm::parseBitcodeFile(*mem.get(), llvm_context);
+    // only the functions needed by the compiled distribution functions are materialized,
+    // see load_and_link_libbsdf()
+    std::unique_ptr<llvm::Module> mod(load_bitcode_library(
+        llvm_context, bitcode, bitcode_size, "libbsdf", /*lazy=*/true));
     if (!mod) {
         error(PARSING_LIBBSDF_MODULE_FAILED, Error_params(get_allocator()));
         MDL_ASSERT(!"Parsing libbsdf failed");
         return nullptr;
     }
-    return std::move(mod.get());
+    return mod;
 }
 
 }  // mdl
@@ -29,9 +29,7 @@
 #include "pch.h"
 
 
-#include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/IR/Module.h>
-#include <llvm/Support/MemoryBuffer.h>
 
 #include "mdl/compiler/compilercore/compilercore_tools.h"
 #include "mdl/compiler/compilercore/compilercore_assert.h"
@@ -97,17 +95,15 @@ std::unique_ptr<llvm::Module> LLVM_code_generator::load_libdevice(
 
     unsigned char const *data = get_libdevice(size, min_ptx_version);
 
-    std::unique_ptr<llvm::MemoryBuffer> mem(llvm::MemoryBuffer::getMemBuffer(
-        llvm::StringRef((char const *)data, size),
-        "libdevice",
-        /*RequiresNullTerminator=*/ false));
-    auto module = llvm::parseBitcodeFile(*mem.get(), llvm_context);
+    // only a small part of libdevice is used by any module, so materialize it lazily
+    std::unique_ptr<llvm::Module> module(load_bitcode_library(
+        llvm_context, data, size, "libdevice", /*lazy=*/true));
     if (!module) {
         error(PARSING_LIBDEVICE_MODULE_FAILED, Error_params(get_allocator()));
         MDL_ASSERT(!"Parsing libdevice failed");
         return nullptr;
     }
-    return std::move(module.get());
+    return module;
 }
 
 }  // mdl
@@ -30,9 +30,7 @@
 #include "pch.h"
 
 #include <llvm/ADT/SetVector.h>
-#include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/IR/Module.h>
-#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Transforms/Utils/Cloning.h>
 #include <llvm/Linker/Linker.h>
 
@@ -51,17 +49,18 @@ namespace mdl {
 std::unique_ptr<llvm::Module> LLVM_code_generator::load_libmdlrt(
     llvm::LLVMContext &llvm_context)
 {
-    std::unique_ptr<llvm::MemoryBuffer> mem(llvm::MemoryBuffer::getMemBuffer(
-        llvm::StringRef((char const *) libmdlrt_bitcode, dimension_of(libmdlrt_bitcode)),
+    std::unique_ptr<llvm::Module> mod(load_bitcode_library(
+        llvm_context,
+        libmdlrt_bitcode,
+        dimension_of(libmdlrt_bitcode),
         "libmdlrt",
-        /*RequiresNullTerminator=*/ false));
-    auto mod = llvm::parseBitcodeFile(*mem.get(), llvm_context);
+        /*lazy=*/true));
     if (!mod) {
         error(PARSING_LIBBSDF_MODULE_FAILED, Error_params(get_allocator()));
         MDL_ASSERT(!"Parsing libmdlrt failed");
         return nullptr;
     }
-    return std::move(mod.get());
+    return mod;
 }
 
 // Load and link libmdlrt into the current LLVM module.
@@ -90,7 +89,8 @@ bool LLVM_code_generator::load_and_link_libmdlrt(llvm::Module *llvm_module)
             old_func_names.insert(string(f.getName().begin(), f.getName().end(), get_allocator()));
     }
 
-    if (llvm::Linker::linkModules(*llvm_module, std::move(libmdlrt))) {
+    // libmdlrt is loaded lazily, only the referenced functions are linked
+    if (link_bitcode_library(*llvm_module, std::move(libmdlrt), /*only_needed=*/true)) {
         // true means linking has failed
         error(LINKING_LIBMDLRT_FAILED, "unknown linker error");
         MDL_ASSERT(!"Linking libmdlrt failed");
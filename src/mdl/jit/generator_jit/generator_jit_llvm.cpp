@@ -33,12 +33,19 @@
 
 #include <base/system/stlext/i_stlext_restore.h>
 #include <base/system/stlext/i_stlext_binary_cast.h>
+#include <base/data/thread_pool/i_thread_pool.h>
 
 #include <vector>
 #include <algorithm>
+#include <chrono>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
 
 #include <llvm/ADT/StringMap.h>
 #include <llvm/ADT/Triple.h>
+#include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/Bitcode/BitcodeWriter.h>
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/ExecutionEngine/JITEventListener.h>
@@ -73,6 +80,7 @@
 #include <llvm/Transforms/IPO.h>
 #include <llvm/Transforms/IPO/AlwaysInliner.h>
 #include <llvm/Transforms/IPO/PassManagerBuilder.h>
+#include <llvm/Transforms/Utils/Cloning.h>
 #include <llvm/Linker/Linker.h>
 
 #include <mi/mdl/mdl_generated_dag.h>
@@ -1240,6 +1248,8 @@ LLVM_code_generator::LLVM_code_generator(
 , m_num_texture_results(num_texture_results)
 , m_sm_version(target_lang == TL_PTX ? sm_version : 0)
 , m_min_ptx_version(0)
+, m_num_codegen_partitions(
+    unsigned(options.get_int_option(MDL_JIT_OPTION_NUM_CODEGEN_PARTITIONS)))
 , m_state_usage_analysis(*this)
 , m_enable_full_debug(enable_debug)
 , m_enable_type_debug(target_lang == TL_HLSL)
@@ -9439,6 +9449,100 @@ void LLVM_code_generator::create_module(char const *mod_name, char const *mod_fn
     m_func_pass_manager->doInitialization();
 }
 
+namespace {
+
+/// Protects the bitcode library statistics.
+mi::base::Lock g_bitcode_library_stats_lock;
+
+/// The process-wide bitcode library statistics.
+Bitcode_library_statistics g_bitcode_library_stats;
+
+/// Count the function definitions of a module, including not yet materialized ones.
+size_t count_function_definitions(llvm::Module const &mod)
+{
+    size_t n = 0;
+    for (llvm::Function const &f : mod.functions()) {
+        if (!f.isDeclaration()) {
+            ++n;
+        }
+    }
+    return n;
+}
+
+}  // anonymous
+
+// Get the process-wide statistics about loading and linking the bitcode libraries.
+Bitcode_library_statistics LLVM_code_generator::get_bitcode_library_statistics()
+{
+    mi::base::Lock::Block block(&g_bitcode_library_stats_lock);
+    return g_bitcode_library_stats;
+}
+
+// Load a bitcode library from an embedded buffer.
+std::unique_ptr<llvm::Module> LLVM_code_generator::load_bitcode_library(
+    llvm::LLVMContext   &llvm_context,
+    unsigned char const *data,
+    size_t              size,
+    char const          *name,
+    bool                lazy)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    llvm::MemoryBufferRef buffer(llvm::StringRef((char const *)data, size), name);
+
+    // the lazy loader references the buffer, which is fine for the embedded libraries
+    llvm::Expected<std::unique_ptr<llvm::Module> > mod = lazy
+        ? llvm::getLazyBitcodeModule(buffer, llvm_context)
+        : llvm::parseBitcodeFile(buffer, llvm_context);
+    if (!mod) {
+        llvm::consumeError(mod.takeError());
+        return nullptr;
+    }
+
+    double load_time = seconds_since(start);
+    size_t n_funcs   = count_function_definitions(*mod.get());
+
+    {
+        mi::base::Lock::Block block(&g_bitcode_library_stats_lock);
+        ++g_bitcode_library_stats.m_nr_loads;
+        if (lazy) {
+            ++g_bitcode_library_stats.m_nr_lazy_loads;
+        }
+        g_bitcode_library_stats.m_nr_functions += n_funcs;
+        g_bitcode_library_stats.m_load_time    += load_time;
+    }
+    return std::move(mod.get());
+}
+
+// Link a bitcode library into a module and update the library statistics.
+bool LLVM_code_generator::link_bitcode_library(
+    llvm::Module                  &dst,
+    std::unique_ptr<llvm::Module> lib,
+    bool                          only_needed)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    size_t n_before = count_function_definitions(dst);
+
+    // for lazily loaded libraries, only the referenced functions (and their dependencies)
+    // are materialized and linked
+    if (llvm::Linker::linkModules(
+            dst,
+            std::move(lib),
+            only_needed ? llvm::Linker::LinkOnlyNeeded : llvm::Linker::None))
+    {
+        return true;
+    }
+
+    size_t n_linked  = count_function_definitions(dst) - n_before;
+    double link_time = seconds_since(start);
+
+    mi::base::Lock::Block block(&g_bitcode_library_stats_lock);
+    g_bitcode_library_stats.m_nr_linked_functions += n_linked;
+    g_bitcode_library_stats.m_link_time           += link_time;
+    return false;
+}
+
 /// Load and link user-defined renderer module into the given LLVM module.
 bool LLVM_code_generator::load_and_link_renderer_module(llvm::Module *llvm_module)
 {
@@ -9564,12 +9668,14 @@ llvm::Module *LLVM_code_generator::finalize_module()
             // avoid LLVM warning on console about mixing different data layouts
             libdevice->setDataLayout(llvm_module->getDataLayout());
 
-            // set required attributes on libdevice functions
+            // set required attributes on libdevice functions, the attributes are kept when
+            // the function bodies are materialized
             for (llvm::Function &func : libdevice->functions()) {
                 set_llvm_function_attributes(&func);
             }
 
-            if (llvm::Linker::linkModules(*llvm_module, std::move(libdevice))) {
+            // libdevice is loaded lazily, only the referenced functions are linked
+            if (link_bitcode_library(*llvm_module, std::move(libdevice), /*only_needed=*/true)) {
                 // true means linking has failed
                 error(LINKING_LIBDEVICE_FAILED, "unknown linking error");
                 MDL_ASSERT(!"Linking libdevice failed");
@@ -9661,16 +9767,227 @@ MDL_JIT_module_key LLVM_code_generator::jit_compile(llvm::Module *module)
     return module_key;
 }
 
-// Compile the given module into PTX code.
-void LLVM_code_generator::ptx_compile(
-    llvm::Module *module,
-    string       &code)
+namespace {
+
+/// Get the name of the function or variable declared or defined by a top-level PTX directive.
+std::string get_ptx_symbol_name(std::string const &line)
+{
+    size_t pos = line.find(".func ");
+    if (pos == std::string::npos) {
+        pos = line.find(".entry ");
+    }
+    if (pos != std::string::npos) {
+        // skip the directive and the return value parameter, if any
+        pos = line.find_first_not_of(' ', line.find(' ', pos));
+        if (pos != std::string::npos && line[pos] == '(') {
+            pos = line.find(')', pos);
+            if (pos != std::string::npos) {
+                pos = line.find_first_not_of(' ', pos + 1);
+            }
+        }
+        if (pos == std::string::npos) {
+            return std::string();
+        }
+        return line.substr(pos, line.find_first_of(" \t(", pos) - pos);
+    }
+
+    // a variable: the name precedes the array size, the initializer or the semicolon
+    std::string decl(line.substr(0, line.find_first_of("[=;")));
+    size_t last = decl.find_last_not_of(" \t");
+    if (last == std::string::npos) {
+        return std::string();
+    }
+    size_t first = decl.find_last_of(" \t", last);
+    first = first == std::string::npos ? 0 : first + 1;
+    return decl.substr(first, last + 1 - first);
+}
+
+/// Split PTX code into lines.
+std::vector<std::string> split_ptx_lines(std::string const &ptx)
+{
+    std::vector<std::string> lines;
+    size_t pos = 0;
+    while (pos < ptx.size()) {
+        size_t end = ptx.find('\n', pos);
+        if (end == std::string::npos) {
+            end = ptx.size();
+        }
+        lines.push_back(ptx.substr(pos, end - pos));
+        pos = end + 1;
+    }
+    return lines;
+}
+
+/// Check if a top-level PTX line starts the declaration or definition of a function.
+bool is_ptx_function_start(std::string const &line)
+{
+    return !line.empty() && line[0] == '.' &&
+        (line.find(".func ") != std::string::npos || line.find(".entry ") != std::string::npos);
+}
+
+/// Merge the PTX code of the partitions of a module into the PTX code of the whole module.
+///
+/// All non-local variables are defined in the first partition and local names are unique
+/// among the partitions, so only the headers and the declarations must be fixed: external
+/// declarations of functions defined in a later partition become prototypes as in a single
+/// module, all other repeated declarations are dropped.
+void merge_ptx_partitions(std::vector<std::string> const &parts, string &code)
+{
+    std::vector<std::vector<std::string> > part_lines;
+    std::set<std::string> defined_funcs, defined_vars;
+
+    for (std::string const &part : parts) {
+        part_lines.push_back(split_ptx_lines(part));
+
+        bool in_body = false;
+        for (std::string const &line : part_lines.back()) {
+            if (in_body) {
+                in_body = line != "}";
+            } else if (line == "{") {
+                in_body = true;
+            } else if (is_ptx_function_start(line)) {
+                if (line.compare(0, 8, ".extern ") != 0) {
+                    defined_funcs.insert(get_ptx_symbol_name(line));
+                }
+            } else if (!line.empty() && line[0] == '.' &&
+                line.compare(0, 8, ".extern ") != 0 &&
+                line[line.size() - 1] == ';')
+            {
+                defined_vars.insert(get_ptx_symbol_name(line));
+            }
+        }
+    }
+
+    std::set<std::string> declared_funcs, declared_vars;
+    for (size_t p = 0, n = part_lines.size(); p < n; ++p) {
+        std::vector<std::string> const &lines = part_lines[p];
+
+        size_t i = 0;
+        if (p > 0) {
+            // the header was already emitted by the first partition
+            while (i < lines.size() && lines[i].compare(0, 14, ".address_size ") != 0) {
+                ++i;
+            }
+            ++i;
+        }
+
+        bool in_body = false;
+        while (i < lines.size()) {
+            std::string const &line = lines[i];
+
+            if (in_body) {
+                in_body = line != "}";
+            } else if (line == "{") {
+                in_body = true;
+            } else if (is_ptx_function_start(line)) {
+                size_t end = i;
+                while (end < lines.size() && lines[end] != ";" && lines[end] != "{") {
+                    ++end;
+                }
+                std::string name(get_ptx_symbol_name(line));
+                bool is_decl = end < lines.size() && lines[end] == ";";
+                if (!is_decl) {
+                    declared_funcs.insert(name);
+                } else if (!declared_funcs.insert(name).second) {
+                    // already declared or defined in front of this partition
+                    i = end + 1;
+                    continue;
+                }
+                if (is_decl && defined_funcs.count(name) != 0 &&
+                    line.compare(0, 8, ".extern ") == 0)
+                {
+                    code.append(".visible ");
+                    code.append(line.c_str() + 8);
+                    code.append("\n");
+                    ++i;
+                }
+                for (; i < end; ++i) {
+                    code.append(lines[i].c_str());
+                    code.append("\n");
+                }
+                continue;
+            } else if (line.compare(0, 8, ".extern ") == 0) {
+                std::string name(get_ptx_symbol_name(line));
+                if (defined_vars.count(name) != 0 || !declared_vars.insert(name).second) {
+                    ++i;
+                    continue;
+                }
+            }
+            code.append(line.c_str());
+            code.append("\n");
+            ++i;
+        }
+    }
+}
+
+}  // anonymous
+
+/// Generates the PTX code of the partitions of a module, one partition per fragment.
+class LLVM_code_generator::Codegen_partition_job : public MI::THREAD_POOL::Job_base
+{
+public:
+    /// Constructor.
+    ///
+    /// \param code_gen  the code generator, only used to create the target machines
+    /// \param bitcodes  the bitcode of the partitions
+    Codegen_partition_job(
+        LLVM_code_generator const      &code_gen,
+        std::vector<std::string> const &bitcodes)
+    : Job_base(bitcodes.size())
+    , ptx(bitcodes.size())
+    , succeeded(bitcodes.size(), 0)
+    , m_code_gen(code_gen)
+    , m_bitcodes(bitcodes)
+    {
+    }
+
+    /// Generate the PTX code of one partition in its own LLVM context.
+    void execute_fragment(size_t i) MDL_FINAL
+    {
+        llvm::LLVMContext context;
+        llvm::Expected<std::unique_ptr<llvm::Module> > part = llvm::parseBitcodeFile(
+            llvm::MemoryBufferRef(m_bitcodes[i], "<ptx-partition>"), context);
+        if (!part) {
+            llvm::consumeError(part.takeError());
+            return;
+        }
+
+        std::unique_ptr<llvm::TargetMachine> target_machine(
+            m_code_gen.create_ptx_target_machine());
+        {
+            llvm::raw_string_ostream SOut(ptx[i]);
+            llvm::buffer_ostream Out(SOut);
+
+            llvm::legacy::PassManager pm;
+            if (target_machine->addPassesToEmitFile(
+                pm, Out, nullptr, llvm::TargetMachine::CGFT_AssemblyFile))
+            {
+                return;
+            }
+            pm.run(**part);
+        }
+        succeeded[i] = 1;
+    }
+
+    /// The PTX code of the partitions.
+    std::vector<std::string> ptx;
+
+    /// Non-zero for every partition whose code was generated successfully.
+    std::vector<char> succeeded;
+
+private:
+    /// The code generator.
+    LLVM_code_generator const &m_code_gen;
+
+    /// The bitcode of the partitions.
+    std::vector<std::string> const &m_bitcodes;
+};
+
+// Create a new target machine for PTX code generation with the current settings.
+llvm::TargetMachine *LLVM_code_generator::create_ptx_target_machine() const
 {
     char mcpu[16];
     char features[16];
-    {
-    raw_string_ostream SOut(code);
-    llvm::buffer_ostream Out(SOut);
 
     bool       is64bit   = get_target_layout_data()->getPointerSizeInBits() == 64;
     char const *march    = is64bit ? "nvptx64" : "nvptx";
@@ -9725,17 +10042,152 @@ void LLVM_code_generator::ptx_compile(
     if (m_finite_math) {
         options.NoInfsFPMath = options.NoNaNsFPMath = true;
     }
-    std::unique_ptr<llvm::TargetMachine> target_machine(target->createTargetMachine(
+    return target->createTargetMachine(
         triple, mcpu, features, options,
-        llvm::None, llvm::None, OLvl));
-    llvm::legacy::PassManager pm;
+        llvm::None, llvm::None, OLvl);
+}
+
+// Compile the given module into PTX code by splitting it into partitions that are
+// compiled in parallel and merging the results.
+bool LLVM_code_generator::ptx_compile_partitioned(
+    llvm::Module *module,
+    unsigned     n_partitions,
+    string       &code)
+{
+    // debug information cannot be merged on PTX level
+    if (module->debug_compile_units_begin() != module->debug_compile_units_end()) {
+        return false;
+    }
+
+    // weak and similar definitions might be dropped by partitions not using them
+    for (llvm::GlobalValue &gv : module->global_values()) {
+        if (!gv.isDeclaration() && !gv.hasLocalLinkage() &&
+            !gv.hasExternalLinkage() && !gv.hasAppendingLinkage())
+        {
+            return false;
+        }
+    }
+
+    // mutable internal variables must exist only once, but sharing them among partitions would
+    // make them visible outside of the generated code
+    for (llvm::GlobalVariable &var : module->globals()) {
+        if (var.hasLocalLinkage() && !var.isConstant()) {
+            return false;
+        }
+    }
 
-    // set the data layout
+    std::unique_ptr<llvm::TargetMachine> target_machine(create_ptx_target_machine());
     module->setDataLayout(target_machine->createDataLayout());
 
-    target_machine->addPassesToEmitFile(pm, Out, nullptr, llvm::TargetMachine::CGFT_AssemblyFile);
+    llvm::ValueToValueMapTy vmap;
+    std::unique_ptr<llvm::Module> source(llvm::CloneModule(*module, vmap));
+
+    // the entry points are distributed over the partitions
+    std::vector<std::pair<size_t, llvm::Function *> > roots;
+    for (llvm::Function &func : source->functions()) {
+        if (!func.isDeclaration() && !func.hasLocalLinkage()) {
+            roots.push_back(std::make_pair(size_t(func.getInstructionCount()), &func));
+        }
+    }
+    if (roots.size() < 2) {
+        return false;
+    }
+    n_partitions = std::min(n_partitions, unsigned(roots.size()));
+
+    // assign the biggest entry points first, always to the smallest partition
+    std::stable_sort(
+        roots.begin(), roots.end(),
+        [](std::pair<size_t, llvm::Function *> const &a,
+           std::pair<size_t, llvm::Function *> const &b) { return a.first > b.first; });
+
+    std::map<llvm::GlobalValue const *, unsigned> owner;
+    std::vector<size_t> partition_size(n_partitions, 0);
+    for (std::pair<size_t, llvm::Function *> const &root : roots) {
+        size_t idx = std::min_element(partition_size.begin(), partition_size.end()) -
+            partition_size.begin();
+        partition_size[idx] += root.first + 1;
+        owner[root.second] = unsigned(idx);
+    }
+
+    // local functions and constants are copied into every partition using them, so they need
+    // names
+    for (llvm::GlobalValue &gv : source->global_values()) {
+        if (gv.hasLocalLinkage() && !gv.hasName()) {
+            gv.setName("__unnamed");
+        }
+    }
+
+    // create the partitions, serialized because they must be moved into their own contexts
+    std::vector<std::string> bitcodes(n_partitions);
+    for (unsigned i = 0; i < n_partitions; ++i) {
+        llvm::ValueToValueMapTy part_vmap;
+        std::unique_ptr<llvm::Module> part(llvm::CloneModule(
+            *source, part_vmap, [&owner, i](llvm::GlobalValue const *gv) {
+                auto it = owner.find(gv);
+                if (it != owner.end()) {
+                    return it->second == i;
+                }
+                return i == 0 || gv->hasLocalLinkage() || gv->getName().startswith("llvm.");
+            }));
+
+        // remove the copied local entities not used in this partition
+        llvm::legacy::PassManager mpm;
+        mpm.add(llvm::createGlobalDCEPass());
+        mpm.run(*part);
+
+        if (i > 0) {
+            // local names must be unique in the merged PTX code
+            std::string suffix("$" + std::to_string(i));
+            for (llvm::GlobalValue &gv : part->global_values()) {
+                if (gv.hasLocalLinkage()) {
+                    gv.setName(gv.getName().str() + suffix);
+                }
+            }
+        }
+
+        llvm::raw_string_ostream bc_out(bitcodes[i]);
+        llvm::WriteBitcodeToFile(*part, bc_out);
+        bc_out.flush();
+    }
+    source.reset();
+
+    Codegen_partition_job job(*this, bitcodes);
+    MI::THREAD_POOL::get_shared_thread_pool()->execute(&job);
+
+    for (char ok : job.succeeded) {
+        if (!ok) {
+            return false;
+        }
+    }
+
+    merge_ptx_partitions(job.ptx, code);
+    return true;
+}
+
+// Compile the given module into PTX code.
+void LLVM_code_generator::ptx_compile(
+    llvm::Module *module,
+    string       &code)
+{
+    unsigned n_partitions = m_num_codegen_partitions;
+    if (n_partitions == 0) {
+        n_partitions = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    if (n_partitions <= 1 || !ptx_compile_partitioned(module, n_partitions, code)) {
+        raw_string_ostream SOut(code);
+        llvm::buffer_ostream Out(SOut);
+
+        std::unique_ptr<llvm::TargetMachine> target_machine(create_ptx_target_machine());
+        llvm::legacy::PassManager pm;
+
+        // set the data layout
+        module->setDataLayout(target_machine->createDataLayout());
+
+        target_machine->addPassesToEmitFile(
+            pm, Out, nullptr, llvm::TargetMachine::CGFT_AssemblyFile);
 
-    pm.run(*module);
+        pm.run(*module);
     }
 
 #if 0 // dump generated PTX to file
@@ -50,6 +50,7 @@ namespace llvm {
     class ExecutionEngine;
     class Function;
     class Module;
+    class TargetMachine;
     namespace legacy {
         class FunctionPassManager;
     }
@@ -84,6 +85,28 @@ class MDL_JIT;
 
 using MDL_JIT_module_key = uint64_t;
 
+/// Process-wide statistics about loading and linking the bitcode libraries (libbsdf, libdevice,
+/// libmdlrt) into generated code.
+struct Bitcode_library_statistics {
+    size_t m_nr_loads;              ///< Number of library loads.
+    size_t m_nr_lazy_loads;         ///< Number of library loads with lazy function materialization.
+    size_t m_nr_functions;          ///< Number of function definitions in all loaded libraries.
+    size_t m_nr_linked_functions;   ///< Number of function definitions linked into modules.
+    double m_load_time;             ///< Seconds spent loading library bitcode.
+    double m_link_time;             ///< Seconds spent linking libraries.
+
+    /// Constructor.
+    Bitcode_library_statistics()
+    : m_nr_loads(0)
+    , m_nr_lazy_loads(0)
+    , m_nr_functions(0)
+    , m_nr_linked_functions(0)
+    , m_load_time(0.0)
+    , m_link_time(0.0)
+    {
+    }
+};
+
 /// The Jitted code interface holds jitted code.
 class IJitted_code : public
     mi::base::Interface_declare<0x933809eb,0x0449,0x4c29,0xaf,0x04,0xc4,0x90,0x1e,0xaa,0xd3,0x3e>
@@ -1546,6 +1569,29 @@ public:
     /// \param code         will be filled with the PTX code
     void ptx_compile(llvm::Module *module, string &code);
 
+    /// Create a new target machine for PTX code generation with the current settings.
+    ///
+    /// \note Only reads the code generator settings, so it can be called from several threads.
+    ///
+    /// \returns the target machine, owned by the caller
+    llvm::TargetMachine *create_ptx_target_machine() const;
+
+    /// Generates the PTX code of partitions on the shared thread pool.
+    class Codegen_partition_job;
+
+    /// Compile the given module into PTX code by splitting it into partitions that are
+    /// compiled in parallel and merging the results.
+    ///
+    /// \param module        the LLVM module to compile, only its data layout is set
+    /// \param n_partitions  the maximum number of partitions
+    /// \param code          will be filled with the PTX code
+    ///
+    /// \returns false if the module cannot be split, \c code is not modified then
+    bool ptx_compile_partitioned(
+        llvm::Module *module,
+        unsigned     n_partitions,
+        string       &code);
+
     /// Compile the given module into HLSL code.
     ///
     /// \param module       the LLVM module to JIT compile
@@ -1825,6 +1871,13 @@ public:
     /// \param jitted_code  the Jitted_code object containing the JIT
     static void register_native_runtime_functions(Jitted_code *jitted_code);
 
+    /// Get the process-wide statistics about loading and linking the bitcode libraries.
+    ///
+    /// Functions of lazily loaded libraries which are not linked into a module are never
+    /// materialized, so (m_nr_functions - m_nr_linked_functions) is the number of function bodies
+    /// whose loading and linking was saved.
+    static Bitcode_library_statistics get_bitcode_library_statistics();
+
     /// Get the number of error messages.
     size_t get_error_message_count();
 
@@ -2414,6 +2467,26 @@ private:
     llvm::Function *get_libbsdf_function(
         DAG_call const *dag_call);
 
+    /// Get the name of the libbsdf function implementing the given DAG call, without the
+    /// distribution function state suffix.
+    ///
+    /// \param[in]  dag_call   the DAG call of a distribution function
+    /// \param[out] func_name  the name of the libbsdf function
+    ///
+    /// \returns false if libbsdf does not support the distribution function
+    bool get_libbsdf_function_name(
+        DAG_call const *dag_call,
+        string         &func_name);
+
+    /// Collect the names of the libbsdf functions required by the main functions of a
+    /// distribution function, as returned by get_libbsdf_function_name().
+    ///
+    /// \param dist_func  the distribution function
+    /// \param names      the names will be added here
+    void collect_libbsdf_function_names(
+        Distribution_function const                  &dist_func,
+        hash_set<string, string_hash<string> >::Type &names);
+
     /// Generate a call to an expression lambda function.
     ///
     /// \param ctx                 the function context
@@ -3163,6 +3236,8 @@ private:
 
     /// Load libdevice.
     ///
+    /// The function bodies are materialized lazily, link it with llvm::Linker::LinkOnlyNeeded.
+    ///
     /// \param[in]  llvm_context     the context for the loader
     /// \param[out] min_ptx_version  if non-zero, the minimum PTX version required for the library
     std::unique_ptr<llvm::Module> load_libdevice(
@@ -3186,6 +3261,8 @@ private:
 
     /// Load the libbsdf LLVM module.
     ///
+    /// The function bodies are materialized lazily, see load_and_link_libbsdf().
+    ///
     /// \param llvm_context  the context for the loader
     /// \param hsm           df handle type to use, which will be used to select the libbsdf version
     std::unique_ptr<llvm::Module> load_libbsdf(
@@ -3194,9 +3271,40 @@ private:
 
     /// Load the libmdlrt LLVM module.
     ///
+    /// The function bodies are materialized lazily, link it with llvm::Linker::LinkOnlyNeeded.
+    ///
     /// \param llvm_context  the context for the loader
     std::unique_ptr<llvm::Module> load_libmdlrt(llvm::LLVMContext &llvm_context);
 
+    /// Load a bitcode library from an embedded buffer.
+    ///
+    /// \param llvm_context  the context for the loader
+    /// \param data          the bitcode, must outlive the returned module if lazy is true
+    /// \param size          the size of the bitcode in bytes
+    /// \param name          the name of the library
+    /// \param lazy          if true, function bodies are only materialized when needed
+    ///
+    /// \returns the module or NULL if the bitcode could not be parsed
+    static std::unique_ptr<llvm::Module> load_bitcode_library(
+        llvm::LLVMContext   &llvm_context,
+        unsigned char const *data,
+        size_t              size,
+        char const          *name,
+        bool                lazy);
+
+    /// Link a bitcode library into a module and update the library statistics.
+    ///
+    /// \param dst          the destination module
+    /// \param lib          the library module, will be consumed
+    /// \param only_needed  if true, only functions referenced by dst (and their dependencies)
+    ///                     will be materialized and linked
+    ///
+    /// \returns true if linking has failed (as llvm::Linker::linkModules())
+    static bool link_bitcode_library(
+        llvm::Module                  &dst,
+        std::unique_ptr<llvm::Module> lib,
+        bool                          only_needed);
+
     /// Determines the semantics for a libbsdf df function name.
     ///
     /// \param name      the name of the function
@@ -3238,13 +3346,22 @@ private:
         int            df_param_idx,
         IType::Kind    kind);
 
-    /// Load and link libbsdf into the current LLVM module.
+    /// Load and link the libbsdf functions required by a distribution function into the current
+    /// LLVM module.
     /// It maps the types from libbsdf to our types and resolves referenced API functions
     /// to our intrinsics.
-    /// \param hsm       df handle type to use, which will be used to select the libbsdf version
+    ///
+    /// libbsdf is loaded lazily. Only the functions implementing the distribution functions used
+    /// by \p dist_func, which are not yet part of the module, are materialized and linked,
+    /// together with the functions they depend on.
+    ///
+    /// \param hsm        df handle type to use, which will be used to select the libbsdf version
+    /// \param dist_func  the distribution function to be compiled
     ///
     /// \returns false if there was any error.
-    bool load_and_link_libbsdf(mdl::Df_handle_slot_mode hsm);
+    bool load_and_link_libbsdf(
+        mdl::Df_handle_slot_mode    hsm,
+        Distribution_function const &dist_func);
 
     /// Returns the set of context data flags to use for functions used with distribution functions.
     LLVM_context_data::Flags get_df_function_flags(const llvm::Function *func);
@@ -3698,6 +3815,9 @@ private:
     /// If non-zero, the minimum PTX version required.
     unsigned m_min_ptx_version;
 
+    /// The maximum number of partitions for parallel PTX code generation, 0 for one per thread.
+    unsigned m_num_codegen_partitions;
+
     /// Analysis object storing state usage information per function and updating
     State_usage_analysis m_state_usage_analysis;
 
@@ -37,6 +37,7 @@
 #include <llvm/Transforms/Utils/Cloning.h>
 #include <llvm/Transforms/Utils/BasicBlockUtils.h>
 #include <llvm/Linker/Linker.h>
+#include <llvm/Support/Error.h>
 
 #include "mdl/compiler/compilercore/compilercore_errors.h"
 #include "mdl/codegenerators/generator_dag/generator_dag_lambda_function.h"
@@ -1171,10 +1172,8 @@ llvm::Module *LLVM_code_generator::compile_distribution_function(
         }
     }
 
-    // load libbsdf into the current module, if it was not initialized, yet
-    if (m_type_bsdf_sample_data == NULL &&
-        !load_and_link_libbsdf(m_link_libbsdf_df_handle_slot_mode))
-    {
+    // load the libbsdf functions required by this distribution function into the current module
+    if (!load_and_link_libbsdf(m_link_libbsdf_df_handle_slot_mode, dist_func)) {
         // drop the module and give up
         drop_llvm_module(m_module);
         m_dist_func = NULL;
@@ -1549,11 +1548,25 @@ LLVM_code_generator::get_dist_func_state_from_call(llvm::CallInst *call)
 // Get the BSDF function for the given semantics and the current distribution function state
 // from the BSDF library.
 llvm::Function *LLVM_code_generator::get_libbsdf_function(DAG_call const *dag_call)
+{
+    string func_name(get_allocator());
+    if (!get_libbsdf_function_name(dag_call, func_name)) {
+        return NULL;  // unsupported DF, should be mapped to black DF
+    }
+
+    func_name = "gen_" + func_name + get_dist_func_state_suffix();
+    return m_module->getFunction(func_name.c_str());
+}
+
+// Get the name of the libbsdf function implementing the given DAG call, without the
+// distribution function state suffix.
+bool LLVM_code_generator::get_libbsdf_function_name(
+    DAG_call const *dag_call,
+    string         &func_name)
 {
     IDefinition::Semantics sema = dag_call->get_semantic();
     IType::Kind kind = dag_call->get_type()->get_kind();
 
-    string func_name(get_allocator());
     string suffix(get_allocator());
 
     // check for tint(color, color, bsdf) overload
@@ -1657,13 +1670,59 @@ llvm::Function *LLVM_code_generator::get_libbsdf_function(DAG_call const *dag_ca
                 "chiang_hair_bsdf")
 
     default:
-        return NULL;  // unsupported DF, should be mapped to black DF
+        return false;
     }
 
     #undef SEMA_CASE
 
-    func_name = "gen_" + func_name + get_dist_func_state_suffix();
-    return m_module->getFunction(func_name.c_str());
+    return true;
+}
+
+// Collect the names of the libbsdf functions required by the main functions of a
+// distribution function.
+void LLVM_code_generator::collect_libbsdf_function_names(
+    Distribution_function const                  &dist_func,
+    hash_set<string, string_hash<string> >::Type &names)
+{
+    ptr_hash_set<DAG_node const>::Type visited(get_allocator());
+    vector<DAG_node const *>::Type     worklist(get_allocator());
+
+    for (size_t i = 0, n = dist_func.get_main_function_count(); i < n; ++i) {
+        mi::base::Handle<ILambda_function> main_func(dist_func.get_main_function(i));
+        worklist.push_back(main_func->get_body());
+    }
+
+    while (!worklist.empty()) {
+        DAG_node const *node = worklist.back();
+        worklist.pop_back();
+        if (!visited.insert(node).second) {
+            continue;
+        }
+
+        DAG_call const *call = as<DAG_call>(node);
+        if (call == NULL) {
+            continue;
+        }
+
+        switch (call->get_type()->get_kind()) {
+        case IType::TK_BSDF:
+        case IType::TK_HAIR_BSDF:
+        case IType::TK_EDF:
+            {
+                string func_name(get_allocator());
+                if (get_libbsdf_function_name(call, func_name)) {
+                    names.insert(func_name);
+                }
+            }
+            break;
+        default:
+            break;
+        }
+
+        for (int i = 0, n = call->get_argument_count(); i < n; ++i) {
+            worklist.push_back(call->get_argument(i));
+        }
+    }
 }
 
 // Determines the semantics for a libbsdf df function name.
@@ -2276,12 +2335,147 @@ LLVM_context_data::Flags LLVM_code_generator::get_df_function_flags(const llvm::
     return flags;
 }
 
-// Load and link libbsdf into the current LLVM module.
-bool LLVM_code_generator::load_and_link_libbsdf(mdl::Df_handle_slot_mode hsm)
+namespace {
+
+/// Add all functions referenced by a value to a worklist, looking through constant expressions.
+void collect_referenced_functions(
+    llvm::Value                               *v,
+    llvm::SmallVectorImpl<llvm::Function *>   &worklist)
+{
+    if (llvm::Function *f = llvm::dyn_cast<llvm::Function>(v)) {
+        worklist.push_back(f);
+    } else if (llvm::GlobalAlias *a = llvm::dyn_cast<llvm::GlobalAlias>(v)) {
+        collect_referenced_functions(a->getAliasee(), worklist);
+    } else if (llvm::isa<llvm::GlobalValue>(v)) {
+        // global variables are handled by materialize_needed_functions()
+    } else if (llvm::Constant *c = llvm::dyn_cast<llvm::Constant>(v)) {
+        for (llvm::Value *op : c->operands()) {
+            collect_referenced_functions(op, worklist);
+        }
+    }
+}
+
+/// Materialize the functions in a worklist and all functions they depend on in a lazily loaded
+/// module, and drop all other function definitions, which are never materialized.
+///
+/// \returns false if materializing a function failed
+bool materialize_needed_functions(
+    llvm::Module                            &lib,
+    llvm::SmallVectorImpl<llvm::Function *> &worklist)
+{
+    // functions referenced by global variables are always needed
+    for (llvm::GlobalVariable &gv : lib.globals()) {
+        if (gv.hasInitializer()) {
+            collect_referenced_functions(gv.getInitializer(), worklist);
+        }
+    }
+
+    llvm::SmallPtrSet<llvm::Function *, 32> needed;
+    while (!worklist.empty()) {
+        llvm::Function *f = worklist.pop_back_val();
+        if (!needed.insert(f).second) {
+            continue;
+        }
+        if (llvm::Error err = f->materialize()) {
+            llvm::consumeError(std::move(err));
+            return false;
+        }
+        if (f->hasPersonalityFn()) {
+            collect_referenced_functions(f->getPersonalityFn(), worklist);
+        }
+        for (llvm::BasicBlock &bb : *f) {
+            for (llvm::Instruction &inst : bb) {
+                for (llvm::Value *op : inst.operands()) {
+                    collect_referenced_functions(op, worklist);
+                }
+            }
+        }
+    }
+
+    for (llvm::Module::iterator it = lib.begin(), end = lib.end(); it != end;) {
+        llvm::Function &f = *it++;
+        if (needed.count(&f) == 0) {
+            // not materialized, so only referenced by other dropped functions
+            f.deleteBody();
+            if (f.use_empty()) {
+                f.eraseFromParent();
+            }
+        }
+    }
+    return true;
+}
+
+}  // anonymous
+
+// Load and link the libbsdf functions required by a distribution function into the current
+// LLVM module.
+bool LLVM_code_generator::load_and_link_libbsdf(
+    mdl::Df_handle_slot_mode    hsm,
+    Distribution_function const &dist_func)
 {
+    // libbsdf might already have been linked for other distribution functions of this module
+    bool first_link = m_type_bsdf_sample_data == NULL;
+
+    hash_set<string, string_hash<string> >::Type df_names(get_allocator());
+    collect_libbsdf_function_names(dist_func, df_names);
+
+    vector<string>::Type missing_names(get_allocator());
+    for (string const &name : df_names) {
+        // the DF API functions are renamed to "gen_<name><state>" after linking
+        string gen_name("gen_" + name + "_sample");
+        string gen_factor_name("gen_" + name + "_get_factor");
+        if (first_link ||
+            (m_module->getFunction(gen_name.c_str()) == NULL &&
+                m_module->getFunction(gen_factor_name.c_str()) == NULL))
+        {
+            missing_names.push_back(name);
+        }
+    }
+    if (!first_link && missing_names.empty()) {
+        return true;
+    }
+
     std::unique_ptr<llvm::Module> libbsdf(load_libbsdf(m_llvm_context, hsm));
     MDL_ASSERT(libbsdf != NULL);
 
+    // collect the functions to be linked: the requested DFs in all states and, on the first link,
+    // the functions used by the code generator directly
+    static char const * const state_suffixes[] = {
+        "_sample", "_evaluate", "_pdf", "_auxiliary", "_get_factor"
+    };
+    llvm::SmallVector<llvm::Function *, 64> worklist;
+    for (string const &name : missing_names) {
+        for (char const *suffix : state_suffixes) {
+            string func_name(name + suffix);
+            if (llvm::Function *f = libbsdf->getFunction(func_name.c_str())) {
+                worklist.push_back(f);
+            }
+        }
+    }
+    if (first_link) {
+        for (llvm::Function &f : libbsdf->functions()) {
+            llvm::StringRef name = f.getName();
+            if (name.startswith("black_") ||
+                (m_target_lang == TL_HLSL && name.startswith("mdl_bsdf_")))
+            {
+                worklist.push_back(&f);
+            }
+        }
+    } else {
+        // the global variables of the previous link are already part of the module
+        for (llvm::GlobalVariable &gv : libbsdf->globals()) {
+            if (!gv.isDeclaration()) {
+                gv.setLinkage(llvm::GlobalValue::InternalLinkage);
+            }
+        }
+    }
+
+    if (!materialize_needed_functions(*libbsdf, worklist)) {
+        error(PARSING_LIBBSDF_MODULE_FAILED, Error_params(get_allocator()));
+        MDL_ASSERT(!"Parsing libbsdf failed");
+        return false;
+    }
+
     // clear target triple to avoid LLVM warning on console about mixing different targets
     // when linking libbsdf ("x86_x64-pc-win32") with libdevice ("nvptx-unknown-unknown").
     // Using an nvptx target for libbsdf would cause struct parameters to be split, which we
@@ -2301,35 +2495,38 @@ bool LLVM_code_generator::load_and_link_libbsdf(mdl::Df_handle_slot_mode hsm)
         }
     }
 
-    if (llvm::Linker::linkModules(*m_module, std::move(libbsdf))) {
+    // the unneeded functions have already been dropped, link all remaining ones
+    if (link_bitcode_library(*m_module, std::move(libbsdf), /*only_needed=*/false)) {
         // true means linking has failed
         error(LINKING_LIBBSDF_FAILED, "unknown linker error");
         MDL_ASSERT(!"Linking libbsdf failed");
         return false;
     }
 
-    m_float3_struct_type = m_module->getTypeByName("struct.float3");
-    if (m_float3_struct_type == NULL) {
-        // name was lost during linking? get it from
-        //    void @black_bsdf_sample(
-        //        %struct.BSDF_sample_data* nocapture %data,
-        //        %class.State* nocapture readnone %state,
-        //        %struct.float3* nocapture readnone %inherited_normal)
-
-        llvm::Function *func = m_module->getFunction("black_bsdf_sample");
-        MDL_ASSERT(func);
-        llvm::FunctionType *func_type = func->getFunctionType();
-        m_float3_struct_type = llvm::cast<llvm::StructType>(
-            func_type->getParamType(2)->getPointerElementType());
-        MDL_ASSERT(m_float3_struct_type);
-    }
+    if (first_link) {
+        m_float3_struct_type = m_module->getTypeByName("struct.float3");
+        if (m_float3_struct_type == NULL) {
+            // name was lost during linking? get it from
+            //    void @black_bsdf_sample(
+            //        %struct.BSDF_sample_data* nocapture %data,
+            //        %class.State* nocapture readnone %state,
+            //        %struct.float3* nocapture readnone %inherited_normal)
+
+            llvm::Function *func = m_module->getFunction("black_bsdf_sample");
+            MDL_ASSERT(func);
+            llvm::FunctionType *func_type = func->getFunctionType();
+            m_float3_struct_type = llvm::cast<llvm::StructType>(
+                func_type->getParamType(2)->getPointerElementType());
+            MDL_ASSERT(m_float3_struct_type);
+        }
 
 
-    create_bsdf_function_types();
-    create_edf_function_types();
+        create_bsdf_function_types();
+        create_edf_function_types();
 
-    m_bsdf_param_metadata_id = m_llvm_context.getMDKindID("libbsdf.bsdf_param");
-    m_edf_param_metadata_id = m_llvm_context.getMDKindID("libbsdf.edf_param");
+        m_bsdf_param_metadata_id = m_llvm_context.getMDKindID("libbsdf.bsdf_param");
+        m_edf_param_metadata_id = m_llvm_context.getMDKindID("libbsdf.edf_param");
+    }
 
     llvm::Type *int_type = m_type_mapper.get_int_type();
     unsigned alloca_addr_space = m_module->getDataLayout().getAllocaAddrSpace();
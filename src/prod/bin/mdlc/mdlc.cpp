@@ -47,6 +47,13 @@
 #include <cstring>
 #include <cstdio>
 #include <cstdlib>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <thread>
 #include <vector>
 
 #include <mi/base/handle.h>
@@ -59,9 +66,12 @@
 
 #include <string>
 #include <algorithm>
+#include <base/data/thread_pool/i_thread_pool.h>
 #include <base/system/version/i_version.h>
 
 #include <mdl/compiler/compilercore/compilercore_mdl.h>
+#include <mdl/compiler/compilercore/compilercore_modules.h>
+#include <mdl/compiler/compilercore/compilercore_tools.h>
 
 #include "search_path.h"
 #include "getopt.h"
@@ -92,6 +102,9 @@ using mi::mdl::IOutput_stream;
 using mi::mdl::IInput_stream;
 using mi::mdl::IThread_context;
 using mi::mdl::IMDL_module_transformer;
+using mi::mdl::IModule_cache;
+using mi::mdl::IModule_cache_lookup_handle;
+using mi::mdl::IModule_loaded_callback;
 
 
 using namespace std;
@@ -108,6 +121,230 @@ static void print_messages(Messages const &msgs, IPrinter *printer)
     }
 }
 
+namespace {
+
+/// A module cache shared by all threads of a parallel compilation.
+///
+/// Every module is compiled by only one thread at a time, other threads importing it wait
+/// until it is available. Modules that fail to compile are not cached, every importer compiles
+/// them again to report the errors, exactly as without the cache. Waiting threads are reported
+/// as blocked to the thread pool, so the pool keeps the number of working threads constant.
+class Shared_module_cache : public IModule_cache, public IModule_loaded_callback
+{
+    /// The lookup handle, only remembers the name and whether the calling thread loads it.
+    class Lookup_handle : public IModule_cache_lookup_handle
+    {
+    public:
+        /// Constructor.
+        Lookup_handle() : m_name(), m_processing(false) {}
+
+        /// Destructor.
+        virtual ~Lookup_handle() {}
+
+        /// Get an identifier to be used throughout the loading of a module.
+        char const *get_lookup_name() const MDL_FINAL { return m_name.c_str(); }
+
+        /// Returns true if this handle belongs to context that loads module.
+        bool is_processing() const MDL_FINAL { return m_processing; }
+
+        /// The name of the module.
+        std::string m_name;
+
+        /// True, if the owner thread loads the module.
+        bool m_processing;
+    };
+
+    typedef std::map<std::string, IModule const *>   Module_map;
+    typedef std::map<std::string, std::thread::id>   Loader_map;
+    typedef std::map<std::thread::id, std::string>   Waiting_map;
+
+public:
+    /// Constructor.
+    ///
+    /// \param pool  the thread pool executing the compilation
+    Shared_module_cache(MI::THREAD_POOL::Thread_pool *pool)
+    : m_pool(pool)
+    , m_mutex()
+    , m_cond()
+    , m_modules()
+    , m_loaders()
+    , m_waiting()
+    {
+    }
+
+    /// Destructor.
+    ~Shared_module_cache()
+    {
+        for (Module_map::const_iterator it(m_modules.begin()), end(m_modules.end());
+            it != end;
+            ++it)
+        {
+            it->second->release();
+        }
+    }
+
+    /// Create an \c IModule_cache_lookup_handle for this \c IModule_cache implementation.
+    IModule_cache_lookup_handle *create_lookup_handle() const MDL_FINAL
+    {
+        return new Lookup_handle();
+    }
+
+    /// Free a handle created by \c create_lookup_handle.
+    void free_lookup_handle(IModule_cache_lookup_handle *handle) const MDL_FINAL
+    {
+        delete static_cast<Lookup_handle *>(handle);
+    }
+
+    /// Lookup a module, waits if another thread is currently loading it.
+    IModule const *lookup(
+        char const                  *absname,
+        IModule_cache_lookup_handle *handle) const MDL_FINAL
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        std::thread::id self = std::this_thread::get_id();
+
+        for (;;) {
+            Module_map::const_iterator it(m_modules.find(absname));
+            if (it != m_modules.end()) {
+                it->second->retain();
+                return it->second;
+            }
+            if (handle == NULL) {
+                return NULL;
+            }
+
+            Lookup_handle *h = static_cast<Lookup_handle *>(handle);
+            h->m_name = absname;
+
+            Loader_map::const_iterator lit(m_loaders.find(absname));
+            if (lit == m_loaders.end()) {
+                // this thread loads the module
+                m_loaders[absname] = self;
+                h->m_processing = true;
+                return NULL;
+            }
+            if (is_waiting_for(lit->second, self)) {
+                // cyclic import, waiting would never end: let the compiler report a failure
+                h->m_processing = false;
+                return NULL;
+            }
+
+            m_waiting[self] = absname;
+            m_pool->suspend_current_job();
+            m_cond.wait(lock);
+            m_pool->resume_current_job();
+            m_waiting.erase(self);
+        }
+    }
+
+    /// Get the module loading callback.
+    IModule_loaded_callback *get_module_loading_callback() const MDL_FINAL
+    {
+        return const_cast<Shared_module_cache *>(this);
+    }
+
+    /// Called when a module was loaded successfully.
+    bool register_module(IModule const *module) MDL_FINAL
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        std::string name(module->get_name());
+        if (m_modules.insert(Module_map::value_type(name, module)).second) {
+            module->retain();
+        }
+        m_loaders.erase(name);
+        m_cond.notify_all();
+        return true;
+    }
+
+    /// Called when a module was not found or when loading failed.
+    void module_loading_failed(IModule_cache_lookup_handle const &handle) MDL_FINAL
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        Loader_map::iterator it(m_loaders.find(handle.get_lookup_name()));
+        if (it != m_loaders.end() && it->second == std::this_thread::get_id()) {
+            // waiting threads will try to load it themselves
+            m_loaders.erase(it);
+            m_cond.notify_all();
+        }
+    }
+
+    /// Check if the built-in modules are already registered.
+    bool is_builtin_module_registered(char const *absname) const MDL_FINAL
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_modules.find(absname) != m_modules.end();
+    }
+
+private:
+    /// Check if thread \p t (transitively) waits for a module loaded by thread \p self.
+    bool is_waiting_for(std::thread::id t, std::thread::id self) const
+    {
+        for (size_t i = 0, n = m_loaders.size(); i <= n; ++i) {
+            if (t == self) {
+                return true;
+            }
+            Waiting_map::const_iterator wit(m_waiting.find(t));
+            if (wit == m_waiting.end()) {
+                return false;
+            }
+            Loader_map::const_iterator lit(m_loaders.find(wit->second));
+            if (lit == m_loaders.end()) {
+                return false;
+            }
+            t = lit->second;
+        }
+        return false;
+    }
+
+    /// The thread pool executing the compilation.
+    MI::THREAD_POOL::Thread_pool *m_pool;
+
+    /// Protects all maps.
+    mutable std::mutex m_mutex;
+
+    /// Signaled when a module was registered or its loading failed.
+    mutable std::condition_variable m_cond;
+
+    /// The successfully loaded modules.
+    Module_map m_modules;
+
+    /// The modules currently loaded and the threads loading them.
+    mutable Loader_map m_loaders;
+
+    /// The threads waiting for a module and the name of that module.
+    mutable Waiting_map m_waiting;
+};
+
+/// Compiles the input modules of mdlc on the shared thread pool.
+///
+/// Every fragment is one worker that takes the next not yet processed input module until all
+/// are done, hence the number of fragments limits the number of concurrent compilations.
+class Compile_job : public MI::THREAD_POOL::Job_base
+{
+public:
+    /// Constructor.
+    ///
+    /// \param count    the number of workers
+    /// \param worker   the worker function
+    Compile_job(size_t count, std::function<void()> const &worker)
+    : Job_base(count)
+    , m_worker(worker)
+    {
+    }
+
+    void execute_fragment(size_t index) final
+    {
+        m_worker();
+    }
+
+private:
+    /// The worker function.
+    std::function<void()> m_worker;
+};
+
+} // anonymous
 
 Mdlc::Mdlc(char const *program_name)
 : m_program(program_name)
@@ -123,6 +360,9 @@ Mdlc::Mdlc(char const *program_name)
 , m_target_lang(TL_NONE)
 , m_input_modules()
 , m_inline(false)
+, m_jobs(1)
+, m_time_report()
+, m_output_lock()
 {
 }
 
@@ -201,6 +441,12 @@ void Mdlc::usage()
         "  --plugin <filename>\n"
         "  -l\n"
         "\tLoads the given plugin.\n"
+        "  --jobs <n>\n"
+        "  -j <n>\n"
+        "\tCompile the given modules using <n> threads and a shared module cache,\n"
+        "\t0 uses one thread per CPU core.\n"
+        "  --time-report <file>\n"
+        "\tWrite the compile times of the given modules as CSV to <file>, '-' for stdout.\n"
         "  --help\n"
         "  -?"
         "\tThis help.\n",
@@ -225,11 +471,13 @@ int Mdlc::run(int argc, char *argv[])
         /*12*/ { "internal-space",         mi::getopt::REQUIRED_ARGUMENT, NULL, 0 },
         /*13*/ { "show-positions",         mi::getopt::NO_ARGUMENT,       NULL, 0 },
         /*14*/ { "show-resource-table",    mi::getopt::NO_ARGUMENT,       NULL, 0 },
-        /*16*/ { "inline",                 mi::getopt::NO_ARGUMENT,       NULL, 'i' },
-        /*17*/ { "plugin",                 mi::getopt::REQUIRED_ARGUMENT, NULL, 'l' },
-        /*18*/ { "help",                   mi::getopt::NO_ARGUMENT,       NULL, '?' },
-       
-        /*19*/ { NULL,                     0,                             NULL, 0 }
+        /*15*/ { "inline",                 mi::getopt::NO_ARGUMENT,       NULL, 'i' },
+        /*16*/ { "plugin",                 mi::getopt::REQUIRED_ARGUMENT, NULL, 'l' },
+        /*17*/ { "help",                   mi::getopt::NO_ARGUMENT,       NULL, '?' },
+        /*18*/ { "jobs",                   mi::getopt::REQUIRED_ARGUMENT, NULL, 'j' },
+        /*19*/ { "time-report",            mi::getopt::REQUIRED_ARGUMENT, NULL, 0 },
+
+        /*20*/ { NULL,                     0,                             NULL, 0 }
     };
 
     bool opt_error = false;
@@ -248,7 +496,7 @@ int Mdlc::run(int argc, char *argv[])
     std::vector<std::string> plugin_filenames;
 
     while (
-        (c = mi::getopt::getopt_long(argc, argv, "O:W:Vvip:Ct:d:B:l:?", long_options, &longidx)) != -1
+        (c = mi::getopt::getopt_long(argc, argv, "O:W:Vvip:Ct:d:B:l:j:?", long_options, &longidx)) != -1
     ) {
         switch (c) {
         case 'O':
@@ -358,6 +606,25 @@ int Mdlc::run(int argc, char *argv[])
         case 'l':
             plugin_filenames.push_back(mi::getopt::optarg);
             break;
+        case 'j':
+            {
+                char const *s = mi::getopt::optarg;
+                char *end = NULL;
+                unsigned long jobs = strtoul(s, &end, 10);
+                if (end == s || *end != '\0' || jobs > 1024) {
+                    fprintf(
+                        stderr,
+                        "%s error: invalid number of jobs (%s)\n",
+                        argv[0],
+                        s);
+                    opt_error = true;
+                } else if (jobs == 0) {
+                    m_jobs = std::max(1u, std::thread::hardware_concurrency());
+                } else {
+                    m_jobs = unsigned(jobs);
+                }
+            }
+            break;
         case '\0':
             switch (longidx) {
             case 2:
@@ -392,9 +659,12 @@ int Mdlc::run(int argc, char *argv[])
             case 14:
                 m_show_resource_table = true;
                 break;
-            case 17:
+            case 16:
                 plugin_filenames.push_back(mi::getopt::optarg);
                 break;
+            case 19:
+                m_time_report = mi::getopt::optarg;
+                break;
             default:
                 fprintf(
                     stderr,
@@ -451,29 +721,31 @@ int Mdlc::run(int argc, char *argv[])
         m_input_modules.push_back(argv[i]);
     }
 
-    for (String_list::const_iterator it(m_input_modules.begin()), end(m_input_modules.end());
-         it != end;
-         ++it)
-    {
-        std::string const &input_module = *it;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
-        size_t errors = 0;
-        mi::base::Handle<IModule const> module;
+    Report_vector reports;
+    bool success = process_all(reports);
 
-        if (is_binary(input_module.c_str())) {
-            module = mi::base::make_handle(load_binary(input_module.c_str(), errors));
-        } else {
-            module = mi::base::make_handle(compile(input_module.c_str(), errors));
-        }
-        if (!module.is_valid_interface())
-            return EXIT_FAILURE;
-        err_count += errors;
-
-        if (m_check_root.empty()) {
-            // compile
-            if (!backend(module.get()))
-                return EXIT_FAILURE;
-        }
+    if (m_verbose) {
+        fprintf(
+            stderr,
+            "%s: processed %u modules in %.3fs using %u threads\n",
+            m_program,
+            unsigned(reports.size()),
+            mi::mdl::seconds_since(start),
+            m_jobs);
+    }
+
+    if (!m_time_report.empty() && !write_time_report(reports)) {
+        success = false;
+    }
+
+    if (!success) {
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0, n = reports.size(); i < n; ++i) {
+        err_count += unsigned(reports[i].errors);
     }
 
     if (!m_check_root.empty()) {
@@ -496,17 +768,143 @@ int Mdlc::run(int argc, char *argv[])
     return err_count == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
 }
 
+// Compile all input modules using the given number of threads.
+bool Mdlc::process_all(Report_vector &reports)
+{
+    std::vector<std::string> inputs(m_input_modules.begin(), m_input_modules.end());
+    reports.resize(inputs.size(), Module_report());
+
+    if (m_jobs <= 1 || inputs.size() <= 1) {
+        mi::base::Handle<IThread_context> ctx(m_imdl->create_thread_context());
+
+        for (size_t i = 0, n = inputs.size(); i < n; ++i) {
+            if (!process(ctx.get(), inputs[i], /*cache=*/NULL, reports[i])) {
+                reports.resize(i + 1);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Every worker uses its own thread context, imports are compiled only once
+    std::shared_ptr<MI::THREAD_POOL::Thread_pool> pool(MI::THREAD_POOL::get_shared_thread_pool());
+    Shared_module_cache cache(pool.get());
+    std::atomic<size_t> next(0);
+    std::atomic<bool>   failed(false);
+
+    auto worker = [&]() {
+        mi::base::Handle<IThread_context> ctx(m_imdl->create_thread_context());
+
+        for (size_t i = next++; i < inputs.size() && !failed; i = next++) {
+            if (!process(ctx.get(), inputs[i], &cache, reports[i])) {
+                failed = true;
+            }
+        }
+    };
+
+    Compile_job job(std::min(size_t(m_jobs), inputs.size()), worker);
+    pool->execute(&job);
+    return !failed;
+}
+
+// Compile one input module and run the backend on it.
+bool Mdlc::process(
+    IThread_context   *ctx,
+    std::string const &input_module,
+    IModule_cache     *cache,
+    Module_report     &report)
+{
+    report.name = input_module;
+
+    size_t errors = 0;
+    mi::base::Handle<IModule const> module;
+
+    if (is_binary(input_module.c_str())) {
+        module = mi::base::make_handle(load_binary(input_module.c_str(), errors));
+    } else {
+        module = mi::base::make_handle(compile(ctx, input_module.c_str(), errors, cache));
+    }
+    if (!module.is_valid_interface())
+        return false;
+
+    mi::mdl::Module::Phase_times const &times =
+        mi::mdl::impl_cast<mi::mdl::Module>(module.get())->get_phase_times();
+    report.parse  = times.parse;
+    report.nt     = times.nt;
+    report.sema   = times.sema;
+    report.opt    = times.opt;
+    report.errors = errors;
+
+    if (m_check_root.empty()) {
+        // target output of concurrently compiled modules must not interleave
+        std::unique_lock<std::mutex> lock(m_output_lock, std::defer_lock);
+        if (m_jobs > 1 && m_target_lang != TL_NONE) {
+            lock.lock();
+        }
+
+        // compile
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        bool res = backend(module.get());
+        report.backend = mi::mdl::seconds_since(start);
+
+        if (!res)
+            return false;
+    }
+    return true;
+}
+
+// Write the timing report as CSV.
+bool Mdlc::write_time_report(Report_vector const &reports)
+{
+    bool  to_stdout = m_time_report == "-";
+    FILE *f         = to_stdout ? stdout : fopen(m_time_report.c_str(), "w");
+    if (f == NULL) {
+        fprintf(
+            stderr,
+            "%s error: failed to open time report '%s' for writing\n",
+            m_program,
+            m_time_report.c_str());
+        return false;
+    }
+
+    // times are in seconds and exclude the compilation of imports
+    fprintf(f, "module,parse,nt_analysis,sema_analysis,optimize,backend,errors\n");
+    for (size_t i = 0, n = reports.size(); i < n; ++i) {
+        Module_report const &r = reports[i];
+        fprintf(
+            f,
+            "%s,%.6f,%.6f,%.6f,%.6f,%.6f,%u\n",
+            r.name.c_str(),
+            r.parse,
+            r.nt,
+            r.sema,
+            r.opt,
+            r.backend,
+            unsigned(r.errors));
+    }
+
+    if (!to_stdout) {
+        fclose(f);
+    }
+    return true;
+}
+
 // Compile one module.
-IModule const *Mdlc::compile(char const *module_name, size_t &errors)
+IModule const *Mdlc::compile(
+    IThread_context *ctx,
+    char const      *module_name,
+    size_t          &errors,
+    IModule_cache   *cache)
 {
-    mi::base::Handle<IThread_context> ctx(m_imdl->create_thread_context());
-    IModule const *module = m_imdl->load_module(ctx.get(), module_name, /*cache=*/NULL);
+    IModule const *module = m_imdl->load_module(ctx, module_name, cache);
 
     mi::base::Handle<IOutput_stream> os_stderr(m_imdl->create_std_stream(IMDL::OS_STDERR));
     mi::base::Handle<IPrinter> printer(m_imdl->create_printer(os_stderr.get()));
 
     printer->enable_color(m_syntax_coloring);
 
+    std::unique_lock<std::mutex> lock(m_output_lock);
+
     Messages const &msgs = ctx->access_messages();
     print_messages(msgs, printer.get());
 
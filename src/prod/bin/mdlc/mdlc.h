@@ -33,11 +33,15 @@
 
 #include <string>
 #include <list>
+#include <mutex>
+#include <vector>
 
 namespace mi {
     namespace mdl {
         class IMDL;
         class IModule;
+        class IModule_cache;
+        class IThread_context;
         class IGenerated_code;
         class ISyntax_coloring;
         class Options;
@@ -81,15 +85,59 @@ public:
     int run(int argc, char *argv[]);
 
 private:
+    /// Timing and result of one input module.
+    struct Module_report {
+        std::string name;     ///< The module name as given on the command line.
+        double      parse;    ///< Parse time in seconds.
+        double      nt;       ///< Name and type analysis time in seconds.
+        double      sema;     ///< Semantic analysis time in seconds.
+        double      opt;      ///< Optimization time in seconds.
+        double      backend;  ///< Backend time in seconds.
+        size_t      errors;   ///< The number of errors.
+    };
+
+    typedef std::vector<Module_report> Report_vector;
+
     /// Prints usage.
     void usage();
 
     /// Compile one module.
+    /// \param      ctx             The thread context to use.
     /// \param      module_name     The name of the module to compile.
     /// \param      errors          The number of errors detected during compilation.
+    /// \param      cache           The module cache to use or NULL.
     /// \returns                    NULL: Some serious error occurred and no modules was created.
     ///                             The created module.
-    mi::mdl::IModule const *compile(char const *module_name, size_t &errors);
+    mi::mdl::IModule const *compile(
+        mi::mdl::IThread_context *ctx,
+        char const               *module_name,
+        size_t                   &errors,
+        mi::mdl::IModule_cache   *cache);
+
+    /// Compile one input module and run the backend on it.
+    ///
+    /// \param      ctx             The thread context to use.
+    /// \param      input_module    The name of the module or binary to compile.
+    /// \param      cache           The module cache to use or NULL.
+    /// \param      report          Receives the timing and the number of errors.
+    /// \returns                    false: Some serious error occurred.
+    bool process(
+        mi::mdl::IThread_context *ctx,
+        std::string const        &input_module,
+        mi::mdl::IModule_cache   *cache,
+        Module_report            &report);
+
+    /// Compile all input modules using the given number of threads.
+    ///
+    /// \param      reports         Receives one report per input module, in input order.
+    /// \returns                    false: Some serious error occurred.
+    bool process_all(Report_vector &reports);
+
+    /// Write the timing report as CSV.
+    ///
+    /// \param      reports         The reports of all input modules.
+    /// \returns                    false: The report file could not be written.
+    bool write_time_report(Report_vector const &reports);
 
     // Apply backend options.
     void apply_backend_options(mi::mdl::Options &opts);
@@ -166,6 +214,15 @@ private:
 
     /// If set and target equals MDL, inline all imports except for stdlib/builtins
     bool m_inline;
+
+    /// The number of threads used to compile the input modules.
+    unsigned m_jobs;
+
+    /// If non empty, the file the timing report is written to, "-" for stdout.
+    std::string m_time_report;
+
+    /// Serializes diagnostics and target output of concurrently compiled modules.
+    std::mutex m_output_lock;
 };
 
 #endif
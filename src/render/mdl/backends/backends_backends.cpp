@@ -92,6 +92,7 @@ public:
     /// \param selector     the selector of the texture
     /// \param type         the type of the texture
     /// \param df_data_kind the \c DF data kind of the texture
+    /// \param session_id   the session ID assigned by the resource registry, or \c 0
     virtual void register_texture(
         size_t                                     index,
         bool                                       is_resolved,
@@ -100,7 +101,8 @@ public:
         float                                      gamma,
         char const                                 *selector,
         mi::neuraylib::ITarget_code::Texture_shape type,
-        mi::mdl::IValue_texture::Bsdf_data_kind    df_data_kind) = 0;
+        mi::mdl::IValue_texture::Bsdf_data_kind    df_data_kind,
+        size_t                                     session_id) = 0;
 
     /// Return the number of texture resources.
     virtual size_t get_texture_count() const = 0;
@@ -120,11 +122,13 @@ public:
     /// \param name         the DB name of this index, if this resource has been resolved,
     ///                     the unresolved mdl url otherwise
     /// \param owner_module the owner module name of the resource
+    /// \param session_id   the session ID assigned by the resource registry, or \c 0
     virtual void register_light_profile(
         size_t                                     index,
         bool                                       is_resolved,
         char const                                 *name,
-        char const                                 *owner_module) = 0;
+        char const                                 *owner_module,
+        size_t                                     session_id) = 0;
 
     /// Return the number of light profile resources.
     virtual size_t get_light_profile_count() const = 0;
@@ -144,11 +148,13 @@ public:
     /// \param name         the DB name of this index, if this resource has been resolved,
     ///                     the unresolved mdl url otherwise
     /// \param owner_module the owner module name of the resource
+    /// \param session_id   the session ID assigned by the resource registry, or \c 0
     virtual void register_bsdf_measurement(
         size_t                                     index,
         bool                                       is_resolved,
         char const                                 *name,
-        char const                                 *owner_module) = 0;
+        char const                                 *owner_module,
+        size_t                                     session_id) = 0;
 
     /// Return the number of BSDF measurement resources.
     virtual size_t get_bsdf_measurement_count() const = 0;
@@ -226,6 +232,7 @@ public:
     , m_bm_idx(m_bm_idx_store)
     , m_keep_unresolved_resources(keep_unresolved_resources)
     , m_store_df_data(store_df_data)
+    , m_registry(NULL)
     {
     }
 
@@ -263,6 +270,7 @@ public:
     , m_bm_idx(bm_idx)
     , m_keep_unresolved_resources(keep_unresolved_resources)
     , m_store_df_data(store_df_data)
+    , m_registry(NULL)
     {
     }
 
@@ -276,7 +284,8 @@ public:
             m_register.register_texture(
                 0, false, "", "", 0.0f, "",
                 mi::neuraylib::ITarget_code::Texture_shape_invalid,
-                mi::mdl::IValue_texture::BDK_NONE);
+                mi::mdl::IValue_texture::BDK_NONE,
+                /*session_id=*/0);
         }
 
         if (mi::mdl::IValue_texture const *tex = mi::mdl::as<mi::mdl::IValue_texture>(v)) {
@@ -304,32 +313,73 @@ public:
                 is_resolved = tag_value != 0;
             }
 
-            // TODO
-            // We are currently fetching the first frame and it's uv tiles as a workaround.
-            // The texture attributes and also the uv-tiles for a frame depend
-            // on the frame, so using width, height, and depth is wrong.
-            mi::Size first_frame_number;
-            mi::Sint32 first_uvtile_u;
-            mi::Sint32 first_uvtile_v;
-            int first_frame, last_frame;
-            if (get_first_tile(
-                m_db_transaction, DB::Tag(tag_value), first_frame_number, first_uvtile_u, first_uvtile_v))
-            {
-                MI::MDL::get_texture_attributes(
-                    m_db_transaction, DB::Tag(tag_value), first_frame_number,
-                    first_uvtile_u, first_uvtile_v, valid, width, height, depth, first_frame, last_frame);
+            mi::mdl::IValue_texture::gamma_mode gamma_mode = tex->get_gamma_mode();
+            mi::mdl::IType_texture::Shape shape = tex->get_type()->get_shape();
+            const char* selector = tex->get_selector();
+
+            // resources already resolved by an earlier compilation are taken from the registry
+            Resource_registry::Entry reg_entry;
+            std::string registry_key;
+            bool known = false;
+            if (m_registry != NULL) {
+                if (!name)
+                    name = resource_to_name(tag_value, tex);
+                registry_key =
+                    std::string(name) + '_' +
+                    std::to_string(unsigned(gamma_mode)) + '_' +
+                    std::to_string(unsigned(shape)) + "_" +
+                    selector;
+                known = m_registry->lookup(
+                    m_db_transaction,
+                    Resource_registry::RK_TEXTURE,
+                    registry_key,
+                    DB::Tag(tag_value),
+                    reg_entry);
+                if (known) {
+                    valid  = reg_entry.m_valid;
+                    width  = reg_entry.m_width;
+                    height = reg_entry.m_height;
+                    depth  = reg_entry.m_depth;
+                }
             }
-            else {
-                valid = false;
+
+            if (!known) {
+                // TODO
+                // We are currently fetching the first frame and it's uv tiles as a workaround.
+                // The texture attributes and also the uv-tiles for a frame depend
+                // on the frame, so using width, height, and depth is wrong.
+                mi::Size first_frame_number;
+                mi::Sint32 first_uvtile_u;
+                mi::Sint32 first_uvtile_v;
+                int first_frame, last_frame;
+                if (get_first_tile(
+                    m_db_transaction, DB::Tag(tag_value), first_frame_number, first_uvtile_u, first_uvtile_v))
+                {
+                    MI::MDL::get_texture_attributes(
+                        m_db_transaction, DB::Tag(tag_value), first_frame_number,
+                        first_uvtile_u, first_uvtile_v, valid, width, height, depth, first_frame, last_frame);
+                }
+                else {
+                    valid = false;
+                }
             }
 
             if (valid || m_keep_unresolved_resources) {
                 if (!name)
                     name = resource_to_name(tag_value, tex);
 
-                mi::mdl::IValue_texture::gamma_mode gamma_mode = tex->get_gamma_mode();
-                mi::mdl::IType_texture::Shape shape = tex->get_type()->get_shape();
-                const char* selector = tex->get_selector();
+                if (m_registry != NULL && !known) {
+                    reg_entry.m_tag = DB::Tag(tag_value);
+                    reg_entry.m_dep_tag = get_texture_image(DB::Tag(tag_value));
+                    reg_entry.m_name = name;
+                    reg_entry.m_is_resolved = is_resolved;
+                    reg_entry.m_valid = valid;
+                    reg_entry.m_width = width;
+                    reg_entry.m_height = height;
+                    reg_entry.m_depth = depth;
+                    m_registry->insert(
+                        m_db_transaction, Resource_registry::RK_TEXTURE, registry_key, reg_entry);
+                }
 
                 bool new_entry = true;
                 size_t tex_idx;
@@ -368,7 +418,8 @@ public:
                         gamma,
                         selector,
                         get_texture_shape(tex->get_type()),
-                        tex->get_bsdf_data_kind());
+                        tex->get_bsdf_data_kind(),
+                        reg_entry.m_index);
                 }
                 m_lambda->map_tex_resource(
                     tex->get_kind(),
@@ -440,7 +491,8 @@ public:
     {
         if (m_register.get_light_profile_count() == 0) {
             // index 0 is always the only invalid light profile index
-            m_register.register_light_profile(0, /*is_resolved=*/false, "", "");
+            m_register.register_light_profile(
+                0, /*is_resolved=*/false, "", "", /*session_id=*/0);
         }
 
         if (mi::mdl::IValue_resource const *r = mi::mdl::as<mi::mdl::IValue_resource>(v)) {
@@ -453,20 +505,34 @@ public:
                 tag_value = m_lambda->get_resource_tag(r);
             }
 
-            MI::MDL::get_light_profile_attributes(
-                m_db_transaction, DB::Tag(tag_value), valid, power, maximum);
+            // resources already resolved by an earlier compilation are taken from the registry
+            Resource_registry::Entry reg_entry;
+            char const *name = resource_to_name(tag_value, r);
+            bool known = m_registry != NULL && m_registry->lookup(
+                m_db_transaction,
+                Resource_registry::RK_LIGHT_PROFILE,
+                name,
+                DB::Tag(tag_value),
+                reg_entry);
+            if (known) {
+                valid   = reg_entry.m_valid;
+                power   = reg_entry.m_power;
+                maximum = reg_entry.m_maximum;
+            } else {
+                MI::MDL::get_light_profile_attributes(
+                    m_db_transaction, DB::Tag(tag_value), valid, power, maximum);
+            }
 
             if (valid || m_keep_unresolved_resources) {
-                char const *name = resource_to_name(tag_value, r);
-                if (m_additional_lambda != NULL) {
-                    m_additional_lambda->map_lp_resource(
-                        r->get_kind(),
-                        r->get_string_value(),
-                        tag_value,
-                        m_lp_idx,
-                        /*valid=*/true,
-                        power,
-                        maximum);
+                if (m_registry != NULL && !known) {
+                    reg_entry.m_tag = DB::Tag(tag_value);
+                    reg_entry.m_name = name;
+                    reg_entry.m_is_resolved = tag_value != 0;
+                    reg_entry.m_valid = valid;
+                    reg_entry.m_power = power;
+                    reg_entry.m_maximum = maximum;
+                    m_registry->insert(
+                        m_db_transaction, Resource_registry::RK_LIGHT_PROFILE, name, reg_entry);
                 }
 
                 bool new_entry = true;
@@ -491,7 +557,7 @@ public:
 
                 if (new_entry) {
                     m_register.register_light_profile(
-                        lp_idx, /*is_resolved=*/tag_value != 0, name, "");
+                        lp_idx, /*is_resolved=*/tag_value != 0, name, "", reg_entry.m_index);
                 }
 
                 m_lambda->map_lp_resource(
@@ -502,6 +568,16 @@ public:
                     /*valid=*/true,
                     power,
                     maximum);
+                if (m_additional_lambda != NULL) {
+                    m_additional_lambda->map_lp_resource(
+                        r->get_kind(),
+                        r->get_string_value(),
+                        tag_value,
+                        lp_idx,
+                        /*valid=*/true,
+                        power,
+                        maximum);
+                }
 
                 return;
             }
@@ -534,7 +610,8 @@ public:
     {
         if (m_register.get_bsdf_measurement_count() == 0) {
             // index 0 is always the only invalid bsdf measurement index
-            m_register.register_bsdf_measurement(0, /*is_resolved=*/false, "", "");
+            m_register.register_bsdf_measurement(
+                0, /*is_resolved=*/false, "", "", /*session_id=*/0);
         }
 
         if (mi::mdl::IValue_resource const *r = mi::mdl::as<mi::mdl::IValue_resource>(v)) {
@@ -546,13 +623,30 @@ public:
                 tag_value = m_lambda->get_resource_tag(r);
             }
 
-            MI::MDL::get_bsdf_measurement_attributes(m_db_transaction, DB::Tag(tag_value), valid);
+            // resources already resolved by an earlier compilation are taken from the registry
+            Resource_registry::Entry reg_entry;
+            char const *name = resource_to_name(tag_value, r);
+            bool known = m_registry != NULL && m_registry->lookup(
+                m_db_transaction,
+                Resource_registry::RK_BSDF_MEASUREMENT,
+                name,
+                DB::Tag(tag_value),
+                reg_entry);
+            if (known) {
+                valid = reg_entry.m_valid;
+            } else {
+                MI::MDL::get_bsdf_measurement_attributes(
+                    m_db_transaction, DB::Tag(tag_value), valid);
+            }
 
             if (valid) {
-                char const *name = resource_to_name(tag_value, r);
-                if (m_additional_lambda != NULL) {
-                    m_additional_lambda->map_bm_resource(
-                        r->get_kind(), r->get_string_value(), tag_value, m_bm_idx, /*valid=*/true);
+                if (m_registry != NULL && !known) {
+                    reg_entry.m_tag = DB::Tag(tag_value);
+                    reg_entry.m_name = name;
+                    reg_entry.m_is_resolved = tag_value != 0;
+                    reg_entry.m_valid = valid;
+                    m_registry->insert(
+                        m_db_transaction, Resource_registry::RK_BSDF_MEASUREMENT, name, reg_entry);
                 }
 
                 bool new_entry = true;
@@ -577,10 +671,14 @@ public:
 
                 if (new_entry) {
                     m_register.register_bsdf_measurement(
-                        bm_idx, /*is_resolved=*/tag_value != 0, name, "");
+                        bm_idx, /*is_resolved=*/tag_value != 0, name, "", reg_entry.m_index);
                 }
                 m_lambda->map_bm_resource(
                     r->get_kind(), r->get_string_value(), tag_value, bm_idx, /*valid=*/true);
+                if (m_additional_lambda != NULL) {
+                    m_additional_lambda->map_bm_resource(
+                        r->get_kind(), r->get_string_value(), tag_value, bm_idx, /*valid=*/true);
+                }
 
                 return;
             }
@@ -597,8 +695,23 @@ public:
         m_additional_lambda = additional_lambda;
     }
 
+    /// Set the resource registry sharing resolved resources and assigning session IDs, if any.
+    void set_resource_registry(Resource_registry *registry) {
+        m_registry = registry;
+    }
+
 private:
 
+    /// Get the image of a texture, if any.
+    DB::Tag get_texture_image(DB::Tag tag)
+    {
+        if (!tag || m_db_transaction->get_class_id(tag) != TEXTURE::ID_TEXTURE)
+            return DB::Tag();
+
+        DB::Access<TEXTURE::Texture> db_texture(tag, m_db_transaction);
+        return db_texture->get_image();
+    }
+
     /// Get the DB name of a resource.
     char const *resource_to_name(int tag_value, mi::mdl::IValue_resource const *r)
     {
@@ -675,6 +788,9 @@ private:
 
     /// If true, DF data textures are stored into the database.
     bool m_store_df_data;
+
+    /// If non-NULL, the registry sharing resolved resources and assigning session IDs.
+    Resource_registry *m_registry;
 };
 
 /// Converts a MI::MDL::IType to a mi::mdl::IType.
@@ -1460,11 +1576,13 @@ public:
             size_t                                   index,
             std::string const                        &name,
             std::string const                        &owner_module,
-            bool                                     is_resolved)
+            bool                                     is_resolved,
+            size_t                                   session_id)
         : m_index(index)
         , m_name(name)
         , m_owner_module(owner_module)
         , m_is_resolved(is_resolved)
+        , m_session_id(session_id)
         {
         }
 
@@ -1472,6 +1590,7 @@ public:
         std::string  m_name;
         std::string  m_owner_module;
         bool         m_is_resolved;
+        size_t       m_session_id;
     };
 
 
@@ -1484,8 +1603,9 @@ public:
             float                                      gamma,
             std::string const                          &selector,
             mi::neuraylib::ITarget_code::Texture_shape type,
-            mi::mdl::IValue_texture::Bsdf_data_kind    df_data_kind)
-        : Res_entry(index, name, owner_module, is_resolved)
+            mi::mdl::IValue_texture::Bsdf_data_kind    df_data_kind,
+            size_t                                     session_id)
+        : Res_entry(index, name, owner_module, is_resolved, session_id)
         , m_gamma(gamma)
         , m_selector(selector)
         , m_type(type)
@@ -1531,6 +1651,8 @@ public:
     /// \param gamma        the gamma value of the texture
     /// \param selector     the selector of the texture
     /// \param type         the type of the texture
+    /// \param df_data_kind the \c DF data kind of the texture
+    /// \param session_id   the session ID assigned by the resource registry, or \c 0
     void register_texture(
         size_t                                     index,
         bool                                       is_resolved,
@@ -1539,7 +1661,8 @@ public:
         float                                      gamma,
         char const                                 *selector,
         mi::neuraylib::ITarget_code::Texture_shape type,
-        mi::mdl::IValue_texture::Bsdf_data_kind    df_data_kind) override
+        mi::mdl::IValue_texture::Bsdf_data_kind    df_data_kind,
+        size_t                                     session_id) override
     {
         m_texture_table.push_back(
             Texture_entry(
@@ -1550,7 +1673,8 @@ public:
                 gamma,
                 selector,
                 type,
-                df_data_kind));
+                df_data_kind,
+                session_id));
 
         // Is a body resource and body resources count has not been marked as invalid?
         if (!m_in_argument_mode && m_body_texture_count != ~0ull)
@@ -1581,13 +1705,16 @@ public:
     /// \param name         the DB name of this index, if this resource has been resolved,
     ///                     the unresolved mdl url otherwise
     /// \param owner_module the owner module name of the resource
+    /// \param session_id   the session ID assigned by the resource registry, or \c 0
     void register_light_profile(
         size_t                                     index,
         bool                                       is_resolved,
         char const                                 *name,
-        char const                                 *owner_module) override
+        char const                                 *owner_module,
+        size_t                                     session_id) override
     {
-        m_light_profile_table.push_back(Res_entry(index, name, owner_module, is_resolved));
+        m_light_profile_table.push_back(
+            Res_entry(index, name, owner_module, is_resolved, session_id));
 
         // Is a body resource and body resources count has not been marked as invalid?
         if (!m_in_argument_mode && m_body_light_profile_count != ~0ull)
@@ -1618,13 +1745,16 @@ public:
     /// \param name         the DB name of this index, if this resource has been resolved,
     ///                     the unresolved mdl url otherwise
     /// \param owner_module the owner module name of the resource
+    /// \param session_id   the session ID assigned by the resource registry, or \c 0
     void register_bsdf_measurement(
         size_t                                     index,
         bool                                       is_resolved,
         char const                                 *name,
-        char const                                 *owner_module) override
+        char const                                 *owner_module,
+        size_t                                     session_id) override
     {
-        m_bsdf_measurement_table.push_back(Res_entry(index, name, owner_module, is_resolved));
+        m_bsdf_measurement_table.push_back(
+            Res_entry(index, name, owner_module, is_resolved, session_id));
 
         // Is a body resource and body resources count has not been marked as invalid?
         if (!m_in_argument_mode && m_body_bsdf_measurement_count != ~0ull)
@@ -1721,7 +1851,8 @@ static void fill_resource_tables(Target_code_register const &tc_reg, Target_code
             entry.m_gamma,
             entry.m_selector,
             entry.m_type,
-            entry.m_df_data_kind);
+            entry.m_df_data_kind,
+            entry.m_session_id);
     }
 
     typedef Target_code_register::Resource_table RT;
@@ -1734,7 +1865,8 @@ static void fill_resource_tables(Target_code_register const &tc_reg, Target_code
         tc->add_light_profile_index(
             entry.m_index,
             entry.m_is_resolved ? entry.m_name : "",
-            !entry.m_is_resolved ? entry.m_name : "");
+            !entry.m_is_resolved ? entry.m_name : "",
+            entry.m_session_id);
     }
 
     RT const &bm_table = tc_reg.get_bsdf_measurement_table();
@@ -1744,7 +1876,8 @@ static void fill_resource_tables(Target_code_register const &tc_reg, Target_code
         tc->add_bsdf_measurement_index(
             entry.m_index,
             entry.m_is_resolved ? entry.m_name : "",
-            !entry.m_is_resolved ? entry.m_name : "");
+            !entry.m_is_resolved ? entry.m_name : "",
+            entry.m_session_id);
     }
 
     tc->set_body_resource_counts(
@@ -1753,6 +1886,87 @@ static void fill_resource_tables(Target_code_register const &tc_reg, Target_code
         tc_reg.get_body_bsdf_measurement_count());
 }
 
+// ------------------------- Resource registry -------------------------
+
+// Constructor.
+Resource_registry::Resource_registry()
+: m_lock()
+{
+    // session ID 0 is always the invalid resource
+    for (size_t i = 0; i <= RK_LAST; ++i)
+        m_next_index[i] = 1;
+}
+
+// Destructor.
+Resource_registry::~Resource_registry()
+{
+}
+
+// Look up a resource.
+bool Resource_registry::lookup(
+    DB::Transaction   *transaction,
+    Kind              kind,
+    std::string const &key,
+    DB::Tag           tag,
+    Entry             &entry) const
+{
+    {
+        mi::base::Lock::Block block(&m_lock);
+
+        Entry_map const &map = m_entries[kind];
+        Entry_map::const_iterator it(map.find(key));
+        if (it == map.end())
+            return false;
+        entry = it->second;
+    }
+
+    // the key might be bound to another DB element by now
+    if (entry.m_tag != tag)
+        return false;
+
+    // check that neither the resource nor the element it depends on has been edited
+    if (entry.m_tag.is_valid() && transaction->get_tag_version(entry.m_tag) != entry.m_version)
+        return false;
+    if (entry.m_dep_tag.is_valid() &&
+            transaction->get_tag_version(entry.m_dep_tag) != entry.m_dep_version)
+        return false;
+    return true;
+}
+
+// Register a resolved resource.
+void Resource_registry::insert(
+    DB::Transaction   *transaction,
+    Kind              kind,
+    std::string const &key,
+    Entry             &entry)
+{
+    if (entry.m_tag.is_valid())
+        entry.m_version = transaction->get_tag_version(entry.m_tag);
+    if (entry.m_dep_tag.is_valid())
+        entry.m_dep_version = transaction->get_tag_version(entry.m_dep_tag);
+
+    mi::base::Lock::Block block(&m_lock);
+
+    Entry_map &map = m_entries[kind];
+    Entry_map::iterator it(map.find(key));
+    if (it != map.end()) {
+        // a re-resolved resource replaces its outdated entry, but keeps its session ID
+        entry.m_index = it->second.m_index;
+        it->second = entry;
+    } else {
+        entry.m_index = m_next_index[kind]++;
+        map.insert(Entry_map::value_type(key, entry));
+    }
+}
+
+// Get the number of session IDs handed out for the given resource kind.
+size_t Resource_registry::get_index_count(Kind kind) const
+{
+    mi::base::Lock::Block block(&m_lock);
+
+    return m_next_index[kind];
+}
+
 // --------------------- Target argument block class --------------------
 
 Target_argument_block::Target_argument_block(mi::Size arg_block_size)
@@ -2123,6 +2337,12 @@ Link_unit::Link_unit(
 , m_strings_mapped_to_ids(llvm_be.get_strings_mapped_to_ids())
 , m_calc_derivatives(llvm_be.get_calc_derivatives())
 , m_internal_space(context->get_option<std::string>(MDL_CTX_OPTION_INTERNAL_SPACE))
+, m_dedup_materials(llvm_be.get_dedup_materials())
+, m_dedup_map()
+, m_arg_block_unit_indices()
+, m_material_count(0)
+, m_dedup_material_count(0)
+, m_resource_registry(llvm_be.get_resource_registry(), mi::base::DUP_INTERFACE)
 {
 }
 
@@ -2195,6 +2415,7 @@ mi::Sint32 Link_unit::add_environment(
         m_res_index_map,
         !resolve_resources,
         resolve_resources);
+    enumerator.set_resource_registry(m_resource_registry.get());
     lambda->enumerate_resources(resolver, enumerator, lambda->get_body());
     if (!resolve_resources)
         lambda->set_has_resource_attributes(false);
@@ -2464,6 +2685,7 @@ mi::Sint32 Link_unit::add_material_single_init(
         *m_tc_reg, root_lambda.get(), m_transaction, m_tex_idx,
         m_lp_idx, m_bm_idx, m_res_index_map,
         !resolve_resources, resolve_resources);
+    enumerator.set_resource_registry(m_resource_registry.get());
 
     for (size_t i = 0, n = dist_func->get_main_function_count(); i < n; ++i) {
         mi::base::Handle<mi::mdl::ILambda_function> main_func(
@@ -2566,19 +2788,7 @@ mi::Sint32 Link_unit::add_material_single_init(
     // Was a target argument block layout created for this entity?
     if (arg_block_index != size_t(~0)) {
         // Add it to the target code and remember the arguments of the compiled material
-        mi::base::Handle<mi::mdl::IGenerated_code_value_layout const> layout(
-            m_unit->get_arg_block_layout(arg_block_index));
-        mi::Size index = m_target_code->add_argument_block_layout(
-            mi::base::make_handle(
-            new Target_value_layout(layout.get(), m_strings_mapped_to_ids)).get());
-        ASSERT(M_BACKENDS, index == arg_block_index && "Unit and target code should be in sync");
-
-        m_arg_block_comp_material_args.push_back(
-            mi::base::make_handle(compiled_material->get_arguments()));
-        ASSERT(M_BACKENDS, index == m_arg_block_comp_material_args.size() - 1 &&
-               "Unit and arg block material arg list should be in sync");
-
-        (void) index;  // avoid warning about unused variable
+        arg_block_index = add_argument_block(arg_block_index, compiled_material);
     }
 
     // pass out the block index
@@ -2596,15 +2806,88 @@ mi::Sint32 Link_unit::add_material(
     mi::Size                                      description_count,
     MDL::Execution_context                       *context)
 {
+    std::string dedup_key;
+    if (m_dedup_materials) {
+        dedup_key = get_dedup_key(
+            compiled_material, function_descriptions, description_count, context);
+
+        Dedup_map::const_iterator it(m_dedup_map.find(dedup_key));
+        if (it != m_dedup_map.end()) {
+            // a material with the same structure was already added, only its arguments differ
+            Dedup_entry const &entry = it->second;
+
+            size_t arg_block_index = entry.arg_block_index;
+            if (arg_block_index != size_t(~0)) {
+                // register the resources of the arguments, the bodies are identical
+                bool resolve_resources =
+                    get_context_option<bool>(context, MDL_CTX_OPTION_RESOLVE_RESOURCES);
+                mi::base::Handle<mi::mdl::ILambda_function> lambda(
+                    m_compiler->create_lambda_function(mi::mdl::ILambda_function::LEC_CORE));
+                Lambda_builder builder(
+                    m_compiler.get(),
+                    m_transaction,
+                    m_compile_consts,
+                    m_calc_derivatives);
+                Function_enumerator enumerator(
+                    *m_tc_reg, lambda.get(), m_transaction, m_tex_idx,
+                    m_lp_idx, m_bm_idx, m_res_index_map,
+                    !resolve_resources, resolve_resources);
+                enumerator.set_resource_registry(m_resource_registry.get());
+                m_tc_reg->set_in_argument_mode(true);
+                builder.enumerate_resource_arguments(lambda.get(), compiled_material, enumerator);
+
+                arg_block_index = add_argument_block(
+                    m_arg_block_unit_indices[arg_block_index], compiled_material);
+            }
+
+            for (mi::Size i = 0; i < description_count; ++i) {
+                function_descriptions[i].function_index       = entry.function_indices[i];
+                function_descriptions[i].distribution_kind    = entry.distribution_kinds[i];
+                function_descriptions[i].argument_block_index = arg_block_index;
+                function_descriptions[i].return_code          = 0;
+            }
+            ++m_material_count;
+            ++m_dedup_material_count;
+            return 0;
+        }
+    }
+
+    mi::Sint32 res;
+
     // adding a group of functions with a single init function?
     if (description_count > 0 &&
         function_descriptions[0].path != NULL &&
         strcmp(function_descriptions[0].path, "init") == 0)
     {
-        return add_material_single_init(
+        res = add_material_single_init(
+            compiled_material, function_descriptions, description_count, context);
+    } else {
+        res = add_material_multi_init(
             compiled_material, function_descriptions, description_count, context);
     }
 
+    if (res == 0 && m_dedup_materials) {
+        ++m_material_count;
+
+        if (!dedup_key.empty()) {
+            Dedup_entry &entry = m_dedup_map[dedup_key];
+            entry.arg_block_index = description_count > 0
+                ? function_descriptions[0].argument_block_index : ~0;
+            for (mi::Size i = 0; i < description_count; ++i) {
+                entry.function_indices.push_back(function_descriptions[i].function_index);
+                entry.distribution_kinds.push_back(function_descriptions[i].distribution_kind);
+            }
+        }
+    }
+    return res;
+}
+
+mi::Sint32 Link_unit::add_material_multi_init(
+    MDL::Mdl_compiled_material const             *compiled_material,
+    mi::neuraylib::Target_function_description   *function_descriptions,
+    mi::Size                                      description_count,
+    MDL::Execution_context                       *context)
+{
     if (compiled_material == NULL) {
         MDL::add_context_error(context, "Invalid parameters (NULL pointer).", -1);
         return -1;
@@ -2779,6 +3062,7 @@ mi::Sint32 Link_unit::add_material(
                     *m_tc_reg, root_lambda.get(), m_transaction, m_tex_idx,
                     m_lp_idx, m_bm_idx, m_res_index_map,
                     !resolve_resources, resolve_resources);
+                enumerator.set_resource_registry(m_resource_registry.get());
                 root_lambda->enumerate_resources(resolver, enumerator, main_func->get_body());
                 if (!resolve_resources)
                     root_lambda->set_has_resource_attributes(false);
@@ -2847,6 +3131,7 @@ mi::Sint32 Link_unit::add_material(
                     *m_tc_reg, lambda.get(), m_transaction, m_tex_idx,
                     m_lp_idx, m_bm_idx, m_res_index_map,
                     !resolve_resources, resolve_resources);
+                enumerator.set_resource_registry(m_resource_registry.get());
                 lambda->enumerate_resources(resolver, enumerator, lambda->get_body());
                 if (!resolve_resources)
                     lambda->set_has_resource_attributes(false);
@@ -2870,6 +3155,7 @@ mi::Sint32 Link_unit::add_material(
             *m_tc_reg, add_list_items[i].lambda_func.get(), m_transaction, m_tex_idx,
             m_lp_idx, m_bm_idx, m_res_index_map,
             !resolve_resources, resolve_resources);
+        enumerator.set_resource_registry(m_resource_registry.get());
 
         // ... also enumerate resources from arguments ...
         if (compiled_material->get_parameter_count() != 0) {
@@ -2920,22 +3206,9 @@ mi::Sint32 Link_unit::add_material(
     }
 
     // Was a target argument block layout created for this entity?
-    if (arg_block_index != size_t(~0))
-    {
+    if (arg_block_index != size_t(~0)) {
         // Add it to the target code and remember the arguments of the compiled material
-        mi::base::Handle<mi::mdl::IGenerated_code_value_layout const> layout(
-            m_unit->get_arg_block_layout(arg_block_index));
-        mi::Size index = m_target_code->add_argument_block_layout(
-            mi::base::make_handle(
-            new Target_value_layout(layout.get(), m_strings_mapped_to_ids)).get());
-        ASSERT(M_BACKENDS, index == arg_block_index && "Unit and target code should be in sync");
-
-        m_arg_block_comp_material_args.push_back(
-            mi::base::make_handle(compiled_material->get_arguments()));
-        ASSERT(M_BACKENDS, index == m_arg_block_comp_material_args.size() - 1 &&
-               "Unit and arg block material arg list should be in sync");
-
-        (void) index;  // avoid warning about unused variable
+        arg_block_index = add_argument_block(arg_block_index, compiled_material);
     }
 
     // pass out the block index
@@ -2948,6 +3221,79 @@ mi::Sint32 Link_unit::add_material(
     return 0;
 }
 
+// Add a new target argument block for the arguments of a compiled material.
+size_t Link_unit::add_argument_block(
+    size_t                            unit_index,
+    MDL::Mdl_compiled_material const *compiled_material)
+{
+    mi::base::Handle<mi::mdl::IGenerated_code_value_layout const> layout(
+        m_unit->get_arg_block_layout(unit_index));
+    mi::Size index = m_target_code->add_argument_block_layout(
+        mi::base::make_handle(
+        new Target_value_layout(layout.get(), m_strings_mapped_to_ids)).get());
+
+    m_arg_block_comp_material_args.push_back(
+        mi::base::make_handle(compiled_material->get_arguments()));
+    ASSERT(M_BACKENDS, index == m_arg_block_comp_material_args.size() - 1 &&
+           "Target code and arg block material arg list should be in sync");
+
+    // without deduplication, unit and target code are in sync
+    m_arg_block_unit_indices.push_back(unit_index);
+    ASSERT(M_BACKENDS, (m_dedup_material_count != 0 || index == unit_index) &&
+           "Unit and target code should be in sync");
+
+    return size_t(index);
+}
+
+// Compute the key used to find materials with the same structure.
+std::string Link_unit::get_dedup_key(
+    MDL::Mdl_compiled_material const                 *compiled_material,
+    mi::neuraylib::Target_function_description const *function_descriptions,
+    mi::Size                                          description_count,
+    MDL::Execution_context                           *context) const
+{
+    if (compiled_material == NULL || description_count == 0)
+        return std::string();
+
+    // the hash covers the structure of all slots, but not the argument values
+    mi::base::Uuid hash = compiled_material->get_hash();
+    if (hash.m_id1 == 0 && hash.m_id2 == 0 && hash.m_id3 == 0 && hash.m_id4 == 0)
+        return std::string();
+
+    std::stringstream sstr;
+    sstr << std::hex << hash.m_id1 << '.' << hash.m_id2 << '.' << hash.m_id3 << '.'
+         << hash.m_id4 << std::dec;
+
+    // the argument block layout depends on the parameters
+    for (mi::Size i = 0, n = compiled_material->get_parameter_count(); i < n; ++i) {
+        sstr << ';' << compiled_material->get_parameter_name(i);
+    }
+
+    sstr << '|' << get_context_option<bool>(context, MDL_CTX_OPTION_RESOLVE_RESOURCES)
+         << get_context_option<bool>(context, MDL_CTX_OPTION_INCLUDE_GEO_NORMAL);
+
+    for (mi::Size i = 0; i < description_count; ++i) {
+        if (function_descriptions[i].path == NULL)
+            return std::string();
+        sstr << '|' << function_descriptions[i].path;
+    }
+    return sstr.str();
+}
+
+// Get the index of the target argument block layout in the target code for every argument
+// block layout index of the MDL link unit.
+std::vector<size_t> Link_unit::get_arg_block_index_map() const
+{
+    std::vector<size_t> res(m_unit->get_arg_block_layout_count(), ~size_t(0));
+    for (size_t i = m_arg_block_unit_indices.size(); i > 0; --i) {
+        // the first target argument block using a unit layout belongs to the functions
+        size_t unit_index = m_arg_block_unit_indices[i - 1];
+        if (unit_index < res.size())
+            res[unit_index] = i - 1;
+    }
+    return res;
+}
+
 // Get the number of functions inside this link unit.
 mi::Size Link_unit::get_num_functions() const
 {
@@ -2976,7 +3322,10 @@ mi::neuraylib::ITarget_code::Function_kind Link_unit::get_function_kind(mi::Size
 // unit if used.
 mi::Size Link_unit::get_function_arg_block_layout_index(mi::Size i) const
 {
-    return mi::Size(m_unit->get_function_arg_block_layout_index(size_t(i)));
+    size_t index = m_unit->get_function_arg_block_layout_index(size_t(i));
+    if (index == size_t(~0) || m_dedup_material_count == 0)
+        return mi::Size(index);
+    return mi::Size(get_arg_block_index_map()[index]);
 }
 
 // Get the number of target argument block layouts used by this link unit.
@@ -3025,7 +3374,8 @@ Mdl_llvm_backend::Mdl_llvm_backend(
     mi::mdl::IMDL                                  *compiler,
     mi::mdl::ICode_generator_jit                   *jit,
     mi::mdl::ICode_cache                           *code_cache,
-    bool                                           string_ids)
+    bool                                           string_ids,
+    Resource_registry                              *registry)
   : m_kind(kind),
     m_sm_version(20),
     m_num_texture_spaces(32),  // by default the number of texture spaces is 32
@@ -3038,7 +3388,11 @@ Mdl_llvm_backend::Mdl_llvm_backend(
     m_output_target_lang(true),
     m_strings_mapped_to_ids(string_ids),
     m_calc_derivatives(false),
-    m_use_builtin_resource_handler(true)
+    m_use_builtin_resource_handler(true),
+    m_use_alias_tables(false),
+    m_dedup_materials(false),
+    m_resource_registry(registry, mi::base::DUP_INTERFACE),
+    m_share_resource_indices(false)
 {
     mi::mdl::Options &options = m_jit->access_options();
 
@@ -3081,6 +3435,9 @@ Mdl_llvm_backend::Mdl_llvm_backend(
     // by default we do NOT include the uniform state
     options.set_option(MDL_JIT_OPTION_INCLUDE_UNIFORM_STATE, "false");
 
+    // by default we generate PTX code in one partition
+    options.set_option(MDL_JIT_OPTION_NUM_CODEGEN_PARTITIONS, "1");
+
     // by default we use vtable tex_lookup calls
     options.set_option(MDL_JIT_OPTION_TEX_LOOKUP_CALL_MODE, "vtable");
 
@@ -3308,6 +3665,31 @@ mi::Sint32 Mdl_llvm_backend::set_option(
         return 0;
     }
 
+    if (strcmp(name, "deduplicate_materials") == 0) {
+        if (strcmp(value, "off") == 0) {
+            m_dedup_materials = false;
+        } else if (strcmp(value, "on") == 0) {
+            m_dedup_materials = true;
+        } else {
+            return -2;
+        }
+        return 0;
+    }
+
+    if (strcmp(name, "share_resource_indices") == 0) {
+        if (strcmp(value, "off") == 0) {
+            m_share_resource_indices = false;
+        } else if (strcmp(value, "on") == 0) {
+            // needs a registry shared by all backends
+            if (!m_resource_registry.is_valid_interface())
+                return -2;
+            m_share_resource_indices = true;
+        } else {
+            return -2;
+        }
+        return 0;
+    }
+
 
     switch (m_kind) {
     case mi::neuraylib::IMdl_backend_api::MB_CUDA_PTX:
@@ -3359,6 +3741,14 @@ mi::Sint32 Mdl_llvm_backend::set_option(
             jit_options.set_option(MDL_JIT_OPTION_TEX_LOOKUP_CALL_MODE, value);
             return 0;
         }
+        if (strcmp(name, "num_codegen_partitions") == 0) {
+            unsigned v = 0;
+            if (sscanf(value, "%u", &v) != 1) {
+                return -2;
+            }
+            jit_options.set_option(MDL_JIT_OPTION_NUM_CODEGEN_PARTITIONS, value);
+            return 0;
+        }
         break;
 
     case mi::neuraylib::IMdl_backend_api::MB_LLVM_IR:
@@ -3403,6 +3793,18 @@ mi::Sint32 Mdl_llvm_backend::set_option(
             jit_options.set_option(MDL_JIT_USE_BUILTIN_RESOURCE_HANDLER_CPU, value);
             return 0;
         }
+        if (strcmp(name, "use_alias_tables") == 0) {
+            if (strcmp(value, "on") == 0) {
+                m_use_alias_tables = true;
+            }
+            else if (strcmp(value, "off") == 0) {
+                m_use_alias_tables = false;
+            }
+            else {
+                return -2;
+            }
+            return 0;
+        }
         break;
 
     case mi::neuraylib::IMdl_backend_api::MB_HLSL:
@@ -3520,6 +3922,7 @@ mi::neuraylib::ITarget_code const *Mdl_llvm_backend::translate_environment(
     Target_code_register tc_reg;
     Function_enumerator enumerator(tc_reg, lambda.get(), transaction,
         !resolve_resources, resolve_resources);
+    enumerator.set_resource_registry(get_resource_registry());
     lambda->enumerate_resources(resolver, enumerator, lambda->get_body());
     if (!resolve_resources)
         lambda->set_has_resource_attributes(false);
@@ -3595,6 +3998,7 @@ mi::neuraylib::ITarget_code const *Mdl_llvm_backend::translate_environment(
         m_strings_mapped_to_ids,
         m_calc_derivatives,
         m_use_builtin_resource_handler,
+        m_use_alias_tables,
         m_kind);
 
     // Enter the resource-table here
@@ -3657,6 +4061,7 @@ mi::neuraylib::ITarget_code const *Mdl_llvm_backend::translate_material_expressi
     Target_code_register tc_reg;
     Function_enumerator enumerator(tc_reg, lambda.get(), transaction,
         !resove_resources, resove_resources);
+    enumerator.set_resource_registry(get_resource_registry());
     lambda->enumerate_resources(resolver, enumerator, lambda->get_body());
     if (!resove_resources)
         lambda->set_has_resource_attributes(false);
@@ -3737,6 +4142,7 @@ mi::neuraylib::ITarget_code const *Mdl_llvm_backend::translate_material_expressi
         m_strings_mapped_to_ids,
         m_calc_derivatives,
         m_use_builtin_resource_handler,
+        m_use_alias_tables,
         m_kind);
 
     // Enter the resource-table here
@@ -3810,6 +4216,7 @@ const mi::neuraylib::ITarget_code* Mdl_llvm_backend::translate_material_df(
     Target_code_register tc_reg;
     Function_enumerator enumerator(tc_reg, root_lambda.get(), transaction,
         !resolve_resources, resolve_resources);
+    enumerator.set_resource_registry(get_resource_registry());
     for (size_t i = 0, n = dist_func->get_main_function_count(); i < n; ++i) {
         mi::base::Handle<mi::mdl::ILambda_function> main_func(
             dist_func->get_main_function(i));
@@ -3892,6 +4299,7 @@ const mi::neuraylib::ITarget_code* Mdl_llvm_backend::translate_material_df(
         m_strings_mapped_to_ids,
         m_calc_derivatives,
         m_use_builtin_resource_handler,
+        m_use_alias_tables,
         m_kind);
 
     // Enter the resource-table here
@@ -4000,7 +4408,20 @@ mi::neuraylib::ITarget_code const *Mdl_llvm_backend::translate_link_unit(
     }
 
     mi::base::Handle<Target_code> tc(lu->get_target_code());
-    tc->finalize(code.get(), lu->get_transaction(), m_calc_derivatives);
+    tc->finalize(code.get(), lu->get_transaction(), m_calc_derivatives, m_use_alias_tables);
+
+    if (lu->get_deduplicated_material_count() != 0) {
+        // target argument blocks were added for deduplicated materials, so the indices of the
+        // unit do not match the ones of the target code anymore
+        tc->remap_argument_block_indices(lu->get_arg_block_index_map());
+
+        std::stringstream sstr;
+        sstr << "Link unit: " << lu->get_deduplicated_material_count() << " of "
+             << lu->get_material_count() << " materials reused the code of a material "
+             << "with the same structure (deduplication ratio "
+             << lu->get_deduplication_ratio() << ").";
+        MDL::add_info_message(context, sstr.str());
+    }
 
     // Enter the resource-table here
     fill_resource_tables(*lu->get_tc_reg(), tc.get());
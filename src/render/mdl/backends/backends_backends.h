@@ -37,6 +37,7 @@
 
 #include <mi/base/handle.h>
 #include <mi/base/interface_implement.h>
+#include <mi/base/lock.h>
 #include <mi/mdl/mdl_code_generators.h>
 #include <mi/mdl/mdl_mdl.h>
 #include <mi/neuraylib/icanvas.h>
@@ -44,6 +45,7 @@
 #include <mi/neuraylib/imdl_backend_api.h>
 #include <mi/neuraylib/itile.h>
 
+#include <base/data/db/i_db_tag.h>
 #include <io/scene/dbimage/i_dbimage.h>
 
 namespace mi {
@@ -70,6 +72,134 @@ namespace BACKENDS {
 class Link_unit;
 class Target_code;
 
+/// A registry of the resources referenced by target codes.
+///
+/// The registry is shared by all backends created from the same MDL backend API. It remembers
+/// the resolved attributes of textures, light profiles and BSDF measurements, so a resource
+/// already seen by an earlier compilation is not resolved again as long as its DB elements are
+/// unchanged.
+///
+/// It also assigns a session ID to each resource, which stays the same across all link units
+/// and target codes. The resource indices used by the generated code stay dense per target
+/// code, the target codes map them to the session IDs.
+class Resource_registry : public mi::base::Interface_implement<mi::base::IInterface>
+{
+public:
+    /// The kinds of registered resources.
+    enum Kind {
+        RK_TEXTURE,
+        RK_LIGHT_PROFILE,
+        RK_BSDF_MEASUREMENT,
+        RK_LAST = RK_BSDF_MEASUREMENT
+    };
+
+    /// A registered resource.
+    struct Entry {
+        /// Constructor.
+        Entry()
+        : m_index(0)
+        , m_tag()
+        , m_version()
+        , m_dep_tag()
+        , m_dep_version()
+        , m_is_resolved(false)
+        , m_valid(false)
+        , m_width(0)
+        , m_height(0)
+        , m_depth(0)
+        , m_power(0.0f)
+        , m_maximum(0.0f)
+        {
+        }
+
+        /// The session ID of the resource, assigned on registration.
+        size_t m_index;
+
+        /// The DB tag of the resource, invalid for unresolved resources.
+        DB::Tag m_tag;
+
+        /// The version of the resource when it was resolved.
+        DB::Tag_version m_version;
+
+        /// The DB element the attributes also depend on (the image of a texture), if any.
+        DB::Tag m_dep_tag;
+
+        /// The version of the dependent DB element when the resource was resolved.
+        DB::Tag_version m_dep_version;
+
+        /// The DB name of the resource if resolved, its MDL url otherwise.
+        std::string m_name;
+
+        /// True, if the resource has been resolved and exists in the DB.
+        bool m_is_resolved;
+
+        /// True, if the resource is valid.
+        bool m_valid;
+
+        /// The resolution of a texture.
+        int m_width, m_height, m_depth;
+
+        /// The power and the maximum of a light profile.
+        float m_power, m_maximum;
+    };
+
+    /// Constructor.
+    Resource_registry();
+
+    /// Look up a resource.
+    ///
+    /// \param transaction  the current transaction
+    /// \param kind         the kind of the resource
+    /// \param key          the key of the resource
+    /// \param tag          the DB tag the resource is currently bound to
+    /// \param[out] entry   receives the registered resource
+    ///
+    /// \return true, if the resource is known and its DB elements did not change since it was
+    ///         resolved, false otherwise
+    bool lookup(
+        DB::Transaction *transaction,
+        Kind            kind,
+        std::string     const &key,
+        DB::Tag         tag,
+        Entry           &entry) const;
+
+    /// Register a resolved resource.
+    ///
+    /// Replaces an outdated entry registered under the same key, which keeps its session ID.
+    /// Otherwise the next free session ID is assigned. The versions of the DB elements are taken
+    /// from the given transaction.
+    ///
+    /// \param transaction  the current transaction
+    /// \param kind         the kind of the resource
+    /// \param key          the key of the resource
+    /// \param entry        the resolved resource, its session ID and versions are updated
+    void insert(
+        DB::Transaction *transaction,
+        Kind            kind,
+        std::string     const &key,
+        Entry           &entry);
+
+    /// Get the number of session IDs handed out for the given resource kind, including the
+    /// invalid ID \c 0.
+    size_t get_index_count(Kind kind) const;
+
+private:
+    /// Destructor.
+    ~Resource_registry();
+
+private:
+    typedef std::map<std::string, Entry> Entry_map;
+
+    /// The lock protecting the registry.
+    mutable mi::base::Lock m_lock;
+
+    /// The registered resources by kind.
+    Entry_map m_entries[RK_LAST + 1];
+
+    /// The next free session ID by kind.
+    size_t m_next_index[RK_LAST + 1];
+};
+
 /// LLVM-IR based backends.
 class Mdl_llvm_backend
 {
@@ -82,12 +212,14 @@ public:
     /// \param jit             The JIT code generator.
     /// \param code_cache      If non-NULL, the code cache.
     /// \param string_ids      If True, string arguments are mapped to string identifiers.
+    /// \param registry        If non-NULL, the resource registry shared by all backends.
     Mdl_llvm_backend(
         mi::neuraylib::IMdl_backend_api::Mdl_backend_kind kind,
         mi::mdl::IMDL* compiler,
         mi::mdl::ICode_generator_jit* jit,
         mi::mdl::ICode_cache *code_cache,
-        bool string_ids);
+        bool string_ids,
+        Resource_registry *registry = NULL);
 
     // API methods
 
@@ -176,6 +308,14 @@ public:
     /// If true, derivatives should be calculated.
     bool get_calc_derivatives() const { return m_calc_derivatives; }
 
+    /// If true, link units share the generated code of materials with the same structure.
+    bool get_dedup_materials() const { return m_dedup_materials; }
+
+    /// Get the shared resource registry if resource indices should be shared, NULL otherwise.
+    Resource_registry *get_resource_registry() const {
+        return m_share_resource_indices ? m_resource_registry.get() : NULL;
+    }
+
 private:
     /// The backend kind.
     mi::neuraylib::IMdl_backend_api::Mdl_backend_kind m_kind;
@@ -215,6 +355,19 @@ private:
 
     /// If true, use the builtin resource handler when running native code
     bool m_use_builtin_resource_handler;
+
+    /// If true, the builtin resource handler samples BSDF measurements and light profiles
+    /// with alias tables
+    bool m_use_alias_tables;
+
+    /// If true, link units share the generated code of materials with the same structure.
+    bool m_dedup_materials;
+
+    /// The resource registry shared by all backends, if any.
+    mi::base::Handle<Resource_registry> m_resource_registry;
+
+    /// If true, resources get session IDs and resolved attributes from the resource registry.
+    bool m_share_resource_indices;
 };
 
 
@@ -55,6 +55,7 @@ class Execution_context;
 namespace BACKENDS {
 
 class Mdl_llvm_backend;
+class Resource_registry;
 class Target_code_register;
 class Target_code;
 
@@ -287,10 +288,70 @@ public:
         return m_internal_space.c_str();
     }
 
+    /// Get the number of materials added to this link unit while material deduplication
+    /// was enabled.
+    mi::Size get_material_count() const { return m_material_count; }
+
+    /// Get the number of materials which reused the generated functions of a previously added
+    /// material with the same structure.
+    mi::Size get_deduplicated_material_count() const { return m_dedup_material_count; }
+
+    /// Get the ratio of deduplicated materials to all materials added with deduplication
+    /// enabled, or 0 if no such material was added.
+    mi::Float32 get_deduplication_ratio() const {
+        return m_material_count == 0
+            ? 0.0f : mi::Float32(m_dedup_material_count) / mi::Float32(m_material_count);
+    }
+
+    /// Get the index of the target argument block layout in the target code for every argument
+    /// block layout index of the MDL link unit.
+    std::vector<size_t> get_arg_block_index_map() const;
+
     /// Destructor.
     ~Link_unit();
 
 private:
+    /// Add (multiple) MDL distribution functions and expressions of a material to this link unit
+    /// without an init function, see #add_material().
+    mi::Sint32 add_material_multi_init(
+        MDL::Mdl_compiled_material const             *i_material,
+        mi::neuraylib::Target_function_description   *function_descriptions,
+        mi::Size                                      function_count,
+        MDL::Execution_context                       *context);
+
+    /// Add a new target argument block for the arguments of a compiled material.
+    ///
+    /// \param unit_index         the index of the argument block layout in the MDL link unit
+    /// \param compiled_material  the compiled material providing the arguments
+    ///
+    /// \return the index of the target argument block in the target code
+    size_t add_argument_block(
+        size_t                            unit_index,
+        MDL::Mdl_compiled_material const *compiled_material);
+
+    /// Compute the key used to find materials with the same structure.
+    ///
+    /// \return the key or an empty string if the material cannot be deduplicated
+    std::string get_dedup_key(
+        MDL::Mdl_compiled_material const                 *compiled_material,
+        mi::neuraylib::Target_function_description const *function_descriptions,
+        mi::Size                                          function_count,
+        MDL::Execution_context                           *context) const;
+
+    /// The functions generated for a material, shared by all materials with the same structure.
+    struct Dedup_entry {
+        /// The index of the target argument block of the first material or ~0 if none.
+        size_t arg_block_index;
+
+        /// The function indices of the requested functions.
+        std::vector<size_t> function_indices;
+
+        /// The distribution kinds of the requested functions.
+        std::vector<mi::neuraylib::ITarget_code::Distribution_kind> distribution_kinds;
+    };
+
+    typedef std::map<std::string, Dedup_entry> Dedup_map;
+
     /// The MDL compiler.
     mi::base::Handle<mi::mdl::IMDL> m_compiler;
 
@@ -341,6 +402,25 @@ private:
 
     /// The internal space seen when this link unit was created.
     std::string m_internal_space;
+
+    /// If true, materials with the same structure share their generated functions.
+    bool m_dedup_materials;
+
+    /// The shared functions of all materials added so far, by structure.
+    Dedup_map m_dedup_map;
+
+    /// The index of the argument block layout in the MDL link unit for every target argument
+    /// block layout of the target code.
+    std::vector<size_t> m_arg_block_unit_indices;
+
+    /// The number of materials added with deduplication enabled.
+    mi::Size m_material_count;
+
+    /// The number of materials that reused the functions of another material.
+    mi::Size m_dedup_material_count;
+
+    /// If valid, the registry sharing resolved resources with all target codes.
+    mi::base::Handle<Resource_registry> m_resource_registry;
 };
 
 } // namespace BACKENDS
@@ -33,6 +33,8 @@
 #include <mi/mdl/mdl_code_generators.h>
 #include <mi/neuraylib/icompiled_material.h>
 #include <mi/neuraylib/ibuffer.h>
+#include <render/mdl/runtime/i_mdlrt_bsdf_measurement.h>
+#include <render/mdl/runtime/i_mdlrt_light_profile.h>
 #include <render/mdl/runtime/i_mdlrt_resource_handler.h>
 #include <io/scene/mdl_elements/i_mdl_elements_compiled_material.h>
 #include <io/scene/mdl_elements/i_mdl_elements_utilities.h>
@@ -49,6 +51,27 @@ namespace MI {
 namespace BACKENDS {
 
 namespace {
+
+/// Copies a memory block identified by a pointer and a length into a mi::neuraylib::IBuffer.
+class Copy_buffer
+    : public mi::base::Interface_implement<mi::neuraylib::IBuffer>,
+    public boost::noncopyable
+{
+public:
+    Copy_buffer(const mi::Uint8* data, mi::Size data_size)
+        : m_data(data, data + data_size)
+    {
+    }
+    const mi::Uint8* get_data() const { return m_data.data(); }
+    mi::Size get_data_size() const { return m_data.size(); }
+private:
+    const std::vector<mi::Uint8> m_data;
+};
+
+// the alias tables of the runtime are handed out as the API type
+static_assert(sizeof(MDLRT::Alias_entry) == sizeof(mi::neuraylib::Alias_table_entry),
+    "alias table entries differ in size");
+
 // ---------------------- Internal target resource callback class ---------------------
 
 /// Implementation of the internal version of the #mi::neuraylib::ITarget_resource_callback
@@ -138,13 +161,14 @@ Target_code::Target_code(
     bool string_ids,
     bool use_derivatives,
     bool use_builtin_resource_handler,
+    bool use_alias_tables,
     mi::neuraylib::IMdl_backend_api::Mdl_backend_kind be_kind)
   : Target_code()
 {
     m_backend_kind = be_kind;
     m_string_args_mapped_to_ids = string_ids;
     m_use_builtin_resource_handler = use_builtin_resource_handler;
-    finalize(code, transaction, use_derivatives);
+    finalize(code, transaction, use_derivatives, use_alias_tables);
 
     size_t num_layouts = code->get_captured_argument_layouts_count();
     m_cap_arg_blocks.resize(num_layouts); // already prepare the empty argument block slots
@@ -184,7 +208,8 @@ Target_code::~Target_code()
 void Target_code::finalize(
     mi::mdl::IGenerated_code_executable* code,
     DB::Transaction* transaction,
-    bool use_derivatives)
+    bool use_derivatives,
+    bool use_alias_tables)
 {
     m_native_code = mi::base::make_handle(
         code->get_interface<mi::mdl::IGenerated_code_lambda_function>());
@@ -192,7 +217,7 @@ void Target_code::finalize(
 
     if (m_native_code.is_valid_interface()) {
         if(m_use_builtin_resource_handler)
-            m_rh = new MDLRT::Resource_handler(use_derivatives);
+            m_rh = new MDLRT::Resource_handler(use_derivatives, use_alias_tables);
 
         m_native_code->init(transaction, NULL, m_rh);
     } else {
@@ -441,6 +466,14 @@ mi::neuraylib::Df_data_kind Target_code::get_texture_df_data_kind(Size index) co
     return mi::neuraylib::DFK_INVALID;
 }
 
+Size Target_code::get_texture_session_id(Size index) const
+{
+    if (index < m_texture_table.size()) {
+        return m_texture_table[index].get_session_id();
+    }
+    return 0;
+}
+
 mi::Size Target_code::get_light_profile_count() const
 {
     return m_light_profile_table.size();
@@ -475,6 +508,14 @@ const char* Target_code::get_light_profile_owner_module(mi::Size index) const
     return NULL;
 }
 
+Size Target_code::get_light_profile_session_id(Size index) const
+{
+    if (index < m_light_profile_table.size()) {
+        return m_light_profile_table[index].get_session_id();
+    }
+    return 0;
+}
+
 Size Target_code::get_bsdf_measurement_count() const
 {
     return m_bsdf_measurement_table.size();
@@ -509,6 +550,117 @@ const char* Target_code::get_bsdf_measurement_owner_module(mi::Size index) const
     return NULL;
 }
 
+Size Target_code::get_bsdf_measurement_session_id(Size index) const
+{
+    if (index < m_bsdf_measurement_table.size()) {
+        return m_bsdf_measurement_table[index].get_session_id();
+    }
+    return 0;
+}
+
+const mi::neuraylib::IBuffer* Target_code::get_light_profile_cdfs(
+    mi::neuraylib::ITransaction* transaction,
+    Size index) const
+{
+    return get_light_profile_sampling_data(transaction, index, /*alias_tables=*/false);
+}
+
+const mi::neuraylib::IBuffer* Target_code::get_light_profile_alias_tables(
+    mi::neuraylib::ITransaction* transaction,
+    Size index) const
+{
+    return get_light_profile_sampling_data(transaction, index, /*alias_tables=*/true);
+}
+
+const mi::neuraylib::IBuffer* Target_code::get_bsdf_measurement_cdfs(
+    mi::neuraylib::ITransaction* transaction,
+    Size index,
+    mi::neuraylib::Mbsdf_part part) const
+{
+    return get_bsdf_measurement_sampling_data(transaction, index, part, /*alias_tables=*/false);
+}
+
+const mi::neuraylib::IBuffer* Target_code::get_bsdf_measurement_alias_tables(
+    mi::neuraylib::ITransaction* transaction,
+    Size index,
+    mi::neuraylib::Mbsdf_part part) const
+{
+    return get_bsdf_measurement_sampling_data(transaction, index, part, /*alias_tables=*/true);
+}
+
+// Computes the CDFs or the alias tables for sampling a light profile resource.
+const mi::neuraylib::IBuffer* Target_code::get_light_profile_sampling_data(
+    mi::neuraylib::ITransaction* transaction,
+    Size index,
+    bool alias_tables) const
+{
+    if (transaction == NULL || index >= m_light_profile_table.size())
+        return NULL;
+
+    NEURAY::Transaction_impl* transaction_impl =
+        static_cast<NEURAY::Transaction_impl*>(transaction);
+    DB::Transaction* db_transaction = transaction_impl->get_db_transaction();
+    ASSERT(M_BACKENDS, db_transaction);
+
+    DB::Tag tag = db_transaction->name_to_tag(m_light_profile_table[index].get_db_name());
+    if (!tag || db_transaction->get_class_id(tag) != LIGHTPROFILE::ID_LIGHTPROFILE)
+        return NULL;
+
+    // invalid light profiles have no grid to sample
+    DB::Typed_tag<LIGHTPROFILE::Lightprofile> typed_tag(tag);
+    if (!DB::Access<LIGHTPROFILE::Lightprofile>(typed_tag, db_transaction)->is_valid())
+        return NULL;
+
+    // the runtime computes the same data for the native backend
+    MDLRT::Light_profile light_profile(typed_tag, db_transaction, alias_tables);
+
+    size_t size = 0;
+    const float* cdfs = light_profile.get_cdf_data(size);
+    if (!alias_tables)
+        return new Copy_buffer(reinterpret_cast<const mi::Uint8*>(cdfs), size * sizeof(float));
+    return new Copy_buffer(
+        reinterpret_cast<const mi::Uint8*>(light_profile.get_alias_data()),
+        size * sizeof(MDLRT::Alias_entry));
+}
+
+// Computes the CDFs or the alias tables for sampling a part of a BSDF measurement resource.
+const mi::neuraylib::IBuffer* Target_code::get_bsdf_measurement_sampling_data(
+    mi::neuraylib::ITransaction* transaction,
+    Size index,
+    mi::neuraylib::Mbsdf_part part,
+    bool alias_tables) const
+{
+    if (transaction == NULL || index >= m_bsdf_measurement_table.size())
+        return NULL;
+
+    NEURAY::Transaction_impl* transaction_impl =
+        static_cast<NEURAY::Transaction_impl*>(transaction);
+    DB::Transaction* db_transaction = transaction_impl->get_db_transaction();
+    ASSERT(M_BACKENDS, db_transaction);
+
+    DB::Tag tag = db_transaction->name_to_tag(m_bsdf_measurement_table[index].get_db_name());
+    if (!tag || db_transaction->get_class_id(tag) != BSDFM::ID_BSDF_MEASUREMENT)
+        return NULL;
+
+    // the runtime computes the same data for the native backend
+    MDLRT::Bsdf_measurement bsdf_measurement(
+        DB::Typed_tag<BSDFM::Bsdf_measurement>(tag), db_transaction, alias_tables);
+
+    mi::mdl::stdlib::Mbsdf_part rt_part = part == mi::neuraylib::MBSDF_DATA_TRANSMISSION
+        ? mi::mdl::stdlib::mbsdf_data_transmission
+        : mi::mdl::stdlib::mbsdf_data_reflection;
+
+    size_t size = 0;
+    const float* cdfs = bsdf_measurement.get_sample_data(rt_part, size);
+    if (cdfs == NULL)
+        return NULL;
+    if (!alias_tables)
+        return new Copy_buffer(reinterpret_cast<const mi::Uint8*>(cdfs), size * sizeof(float));
+    return new Copy_buffer(
+        reinterpret_cast<const mi::Uint8*>(bsdf_measurement.get_alias_data(rt_part)),
+        size * sizeof(MDLRT::Alias_entry));
+}
+
 // Returns the number of string constants used by the target code.
 Size Target_code::get_string_constant_count() const
 {
@@ -805,7 +957,8 @@ void Target_code::add_texture_index(
     float gamma,
     const std::string& selector,
     Texture_shape shape,
-    mi::mdl::IValue_texture::Bsdf_data_kind df_data_kind)
+    mi::mdl::IValue_texture::Bsdf_data_kind df_data_kind,
+    size_t session_id)
 {
     if( index >= m_texture_table.size()) {
         m_texture_table.resize(index + 1, Target_code::Texture_info(
@@ -815,51 +968,56 @@ void Target_code::add_texture_index(
             /*gamma=*/0.0f,
             /*selector=*/selector,
             /*texture_shape=*/Texture_shape_invalid,
-            /*df_data_kind=*/ mi::mdl::IValue_texture::BDK_NONE));
+            /*df_data_kind=*/ mi::mdl::IValue_texture::BDK_NONE,
+            /*session_id=*/0));
     }
 
     std::string owner = MDL::get_resource_owner_prefix( mdl_url);
     std::string url   = MDL::strip_resource_owner_prefix( mdl_url);
     m_texture_table[index] = Target_code::Texture_info(
-        name, url, owner, gamma, selector, shape, df_data_kind);
+        name, url, owner, gamma, selector, shape, df_data_kind, session_id);
 }
 
 // Registers a used light profile index.
 void Target_code::add_light_profile_index(
     size_t index,
     const std::string& name,
-    const std::string& mdl_url)
+    const std::string& mdl_url,
+    size_t session_id)
 {
     if( index >= m_light_profile_table.size()) {
         m_light_profile_table.resize( index + 1,
             Target_code::Resource_info(
             /*db_name=*/"",
             /*mdl_url=*/"",
-            /*owner=*/""));
+            /*owner=*/"",
+            /*session_id=*/0));
     }
 
     std::string owner = MDL::get_resource_owner_prefix( mdl_url);
     std::string url   = MDL::strip_resource_owner_prefix( mdl_url);
     m_light_profile_table[index] = Target_code::Resource_info(
-        name, url, owner);
+        name, url, owner, session_id);
 }
 
 // Registers a used bsdf measurement index.
 void Target_code::add_bsdf_measurement_index(
     size_t index,
     const std::string& name,
-    const std::string& mdl_url)
+    const std::string& mdl_url,
+    size_t session_id)
 {
     if( index >= m_bsdf_measurement_table.size()) {
         m_bsdf_measurement_table.resize(index + 1, Target_code::Resource_info(
             /*db_name=*/"",
             /*mdl_url=*/"",
-            /*owner=*/""));
+            /*owner=*/"",
+            /*session_id=*/0));
     }
 
     std::string owner = MDL::get_resource_owner_prefix( mdl_url);
     std::string url   = MDL::strip_resource_owner_prefix( mdl_url);
-    m_bsdf_measurement_table[index] = Target_code::Resource_info( name, url, owner);
+    m_bsdf_measurement_table[index] = Target_code::Resource_info( name, url, owner, session_id);
 }
 
 // Registers a used string constant index.
@@ -1033,6 +1191,16 @@ mi::Size Target_code::add_argument_block_layout(Target_value_layout *layout)
     return m_cap_arg_layouts.size() - 1;
 }
 
+// Replace the target argument block indices of all callable functions.
+void Target_code::remap_argument_block_indices(std::vector<size_t> const &index_map)
+{
+    for (size_t i = 0, n = m_callable_function_infos.size(); i < n; ++i) {
+        Callable_function_info &info = m_callable_function_infos[i];
+        if (info.m_arg_block_index < index_map.size())
+            info.m_arg_block_index = index_map[info.m_arg_block_index];
+    }
+}
+
 // Get the string identifier for a given string inside the constant table or 0
 // if the string is not known.
 mi::Uint32 Target_code::get_string_index(char const* string) const
@@ -1303,22 +1471,6 @@ namespace {
     static const std::string MDL_SDK_VERSION = VERSION::get_platform_version();
     static const std::string MDL_SDK_OS = VERSION::get_platform_os();
 
-    /// Wraps a memory block identified by a pointer and a length as mi::neuraylib::IBuffer.
-    class Copy_buffer
-        : public mi::base::Interface_implement<mi::neuraylib::IBuffer>,
-        public boost::noncopyable
-    {
-    public:
-        Copy_buffer(const mi::Uint8* data, mi::Size data_size)
-            : m_data(data, data + data_size)
-        {
-        }
-        const mi::Uint8* get_data() const { return m_data.data(); }
-        mi::Size get_data_size() const { return m_data.size(); }
-    private:
-        const std::vector<mi::Uint8> m_data;
-    };
-
 } // anonymous namespace
 
 /// Variant of SERIAL::write(...,const std::vector<T>&).
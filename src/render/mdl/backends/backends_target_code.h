@@ -147,6 +147,8 @@ public:
     /// \param use_derivatives  True if derivative support is enabled for the generated code
     /// \param use_builtin_resource_handler True, if the builtin texture runtime is supposed to be
     ///                         used when running x86 code.
+    /// \param use_alias_tables True, if the builtin texture runtime samples BSDF measurements
+    ///                         and light profiles with alias tables.
     /// \param be_kind     Kind of back-end that created this target code object.
     Target_code(
         mi::mdl::IGenerated_code_executable* code,
@@ -154,6 +156,7 @@ public:
         bool string_ids,
         bool use_derivatives,
         bool use_builtin_resource_handler,
+        bool use_alias_tables,
         mi::neuraylib::IMdl_backend_api::Mdl_backend_kind be_kind);
 
 
@@ -169,7 +172,8 @@ public:
     /// Finalization method for link mode for executable code.
     void finalize( mi::mdl::IGenerated_code_executable* code,
         MI::DB::Transaction* transaction,
-        bool use_derivatives);
+        bool use_derivatives,
+        bool use_alias_tables);
 
 
     // API methods
@@ -269,6 +273,9 @@ public:
     ///                   index, or \c DFK_INVALID if \p index is out of range.
     mi::neuraylib::Df_data_kind get_texture_df_data_kind(Size index) const override;
 
+    /// Returns the session ID of a texture resource used by the target code.
+    Size get_texture_session_id(Size index) const override;
+
     /// Returns the number of constant data initializers.
     Size get_ro_data_segment_count() const override;
 
@@ -385,6 +392,17 @@ public:
     ///                   module is not provided.
     const char* get_light_profile_owner_module(Size index) const override;
 
+    /// Returns the session ID of a light profile resource used by the target code.
+    Size get_light_profile_session_id(Size index) const override;
+
+    /// Returns the CDFs for sampling a light profile resource used by the target code.
+    const mi::neuraylib::IBuffer* get_light_profile_cdfs(
+        mi::neuraylib::ITransaction* transaction, Size index) const override;
+
+    /// Returns the alias tables for sampling a light profile resource used by the target code.
+    const mi::neuraylib::IBuffer* get_light_profile_alias_tables(
+        mi::neuraylib::ITransaction* transaction, Size index) const override;
+
     /// Returns the number of BSDF measurement resources used by the target code.
     Size get_bsdf_measurement_count() const override;
 
@@ -414,6 +432,23 @@ public:
     ///                   module is not provided.
     const char* get_bsdf_measurement_owner_module(Size index) const override;
 
+    /// Returns the session ID of a BSDF measurement resource used by the target code.
+    Size get_bsdf_measurement_session_id(Size index) const override;
+
+    /// Returns the CDFs for sampling a part of a BSDF measurement resource used by the target
+    /// code.
+    const mi::neuraylib::IBuffer* get_bsdf_measurement_cdfs(
+        mi::neuraylib::ITransaction* transaction,
+        Size index,
+        mi::neuraylib::Mbsdf_part part) const override;
+
+    /// Returns the alias tables for sampling a part of a BSDF measurement resource used by the
+    /// target code.
+    const mi::neuraylib::IBuffer* get_bsdf_measurement_alias_tables(
+        mi::neuraylib::ITransaction* transaction,
+        Size index,
+        mi::neuraylib::Mbsdf_part part) const override;
+
     /// Returns the number of string constants used by the target code.
     Size get_string_constant_count() const override;
 
@@ -724,6 +759,7 @@ public:
     /// \param selector              texture selector
     /// \param shape                 the texture shape of the texture
     /// \param sema                  the semantic of the texture, typically \c DS_UNKNOWN.
+    /// \param session_id            the session ID assigned by the resource registry, or \c 0
     void add_texture_index(
         size_t index,
         const std::string& name,
@@ -731,27 +767,32 @@ public:
         float gamma,
         const std::string& selector,
         Texture_shape shape,
-        mi::mdl::IValue_texture::Bsdf_data_kind df_data_kind);
+        mi::mdl::IValue_texture::Bsdf_data_kind df_data_kind,
+        size_t session_id);
 
     /// Registers a used light profile index.
     ///
     /// \param index  the texture index as used in compiled code
     /// \param name   the name of the DB element this index refers to.
     /// \param mdl_url               the mdl url.
+    /// \param session_id            the session ID assigned by the resource registry, or \c 0
     void add_light_profile_index(
         size_t index,
         const std::string& name,
-        const std::string& mdl_url);
+        const std::string& mdl_url,
+        size_t session_id);
 
     /// Registers a used bsdf measurement index.
     ///
     /// \param index  the texture index as used in compiled code
     /// \param name   the name of the DB element this index refers to.
     /// \param mdl_url               the mdl url.
+    /// \param session_id            the session ID assigned by the resource registry, or \c 0
     void add_bsdf_measurement_index(
         size_t index,
         const std::string& name,
-        const std::string& mdl_url);
+        const std::string& mdl_url,
+        size_t session_id);
 
     /// Registers a used string constant index.
     ///
@@ -799,6 +840,11 @@ public:
     /// \return  The index of the added layout.
     mi::Size add_argument_block_layout(Target_value_layout *layout);
 
+    /// Replace the target argument block indices of all callable functions.
+    ///
+    /// \param index_map  The new index for every old index, indices not in the map are kept
+    void remap_argument_block_indices(std::vector<size_t> const &index_map);
+
     /// Returns true if string values in the argument block are mapped to IDs.
     bool string_args_mapped_to_ids() const { return m_string_args_mapped_to_ids; }
 
@@ -855,10 +901,12 @@ private:
         Resource_info(
             std::string const &db_name,
             std::string const &mdl_url,
-            std::string const &owner)
+            std::string const &owner,
+            size_t session_id)
         : m_db_name(db_name)
         , m_mdl_url(mdl_url)
         , m_owner_module(owner)
+        , m_session_id(session_id)
         {
         }
 
@@ -867,6 +915,7 @@ private:
             : m_db_name()
             , m_mdl_url()
             , m_owner_module()
+            , m_session_id(0)
         {
         }
 
@@ -888,6 +937,12 @@ private:
             return m_owner_module.c_str();
         }
 
+        /// Get the session ID of the resource, or \c 0 if none was assigned.
+        size_t get_session_id() const
+        {
+            return m_session_id;
+        }
+
         /// Required for serialization.
         MI::SERIAL::Class_id get_class_id() const final
         {
@@ -911,6 +966,10 @@ private:
 
         /// The owner module name of the resource.
         std::string m_owner_module;
+
+        /// The session ID assigned by the resource registry, or \c 0. Not serialized, as it is
+        /// only valid within the current session.
+        size_t m_session_id;
     };
 
     /// Helper value type for texture entries.
@@ -923,8 +982,9 @@ private:
             float gamma,
             std::string const &selector,
             Texture_shape shape,
-            mi::mdl::IValue_texture::Bsdf_data_kind df_data_kind)
-        : Resource_info(db_name, mdl_url, owner)
+            mi::mdl::IValue_texture::Bsdf_data_kind df_data_kind,
+            size_t session_id)
+        : Resource_info(db_name, mdl_url, owner, session_id)
         , m_gamma(gamma)
         , m_selector(selector)
         , m_texture_shape(shape)
@@ -979,6 +1039,19 @@ private:
         mi::mdl::IValue_texture::Bsdf_data_kind m_df_data_kind;
     };
 
+    // Computes the CDFs or the alias tables for sampling a light profile resource.
+    const mi::neuraylib::IBuffer* get_light_profile_sampling_data(
+        mi::neuraylib::ITransaction* transaction,
+        Size index,
+        bool alias_tables) const;
+
+    // Computes the CDFs or the alias tables for sampling a part of a BSDF measurement resource.
+    const mi::neuraylib::IBuffer* get_bsdf_measurement_sampling_data(
+        mi::neuraylib::ITransaction* transaction,
+        Size index,
+        mi::neuraylib::Mbsdf_part part,
+        bool alias_tables) const;
+
     // reduce redundant code be wrapping bsdf, edf, ... calls
     mi::Sint32 execute_df_init_function(
         mi::neuraylib::ITarget_code::Distribution_kind dist_kind,
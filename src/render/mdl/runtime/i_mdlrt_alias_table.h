@@ -0,0 +1,87 @@
+/******************************************************************************
+ * Copyright (c) 2014-2022, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+/** \file
+ ** \brief Alias tables for sampling discrete distributions in constant time.
+ **/
+
+#ifndef RENDER_MDL_RUNTIME_I_MDLRT_ALIAS_TABLE_H
+#define RENDER_MDL_RUNTIME_I_MDLRT_ALIAS_TABLE_H
+
+#include <algorithm>
+
+namespace MI {
+namespace MDLRT {
+
+/// An entry of an alias table.
+///
+/// A bin is selected by first choosing an entry uniformly and then either keeping it with
+/// probability \c q or switching to \c alias otherwise.
+struct Alias_entry
+{
+    float    q;      // probability to keep this bin
+    unsigned alias;  // bin to select otherwise
+};
+
+/// Builds an alias table for the discrete distribution given by a normalized CDF.
+///
+/// The probabilities are derived from the differences of consecutive CDF values, so that they
+/// match the probabilities computed from the CDF for the PDF. If the CDF does not describe a
+/// valid distribution, the table selects all bins uniformly.
+///
+/// \param cdf    the CDF with \p n entries
+/// \param n      the number of bins
+/// \param table  the resulting alias table with \p n entries
+void build_alias_table(const float* cdf, unsigned n, Alias_entry* table);
+
+/// Selects a bin of an alias table.
+///
+/// \param table  the alias table with \p n entries
+/// \param n      the number of bins
+/// \param xi     a uniform random number in [0, 1], rescaled to [0, 1] for re-usage
+/// \return       the selected bin
+inline unsigned sample_alias_table(const Alias_entry* table, unsigned n, float& xi)
+{
+    const float x = xi * float(n);
+    const unsigned idx = std::min(unsigned(x), n - 1);
+    const float f = x - float(idx);
+
+    const Alias_entry& entry = table[idx];
+    if (f < entry.q || entry.q >= 1.0f)
+    {
+        xi = f / entry.q;
+        return idx;
+    }
+
+    xi = (f - entry.q) / (1.0f - entry.q);
+    return entry.alias;
+}
+
+}  // MDLRT
+}  // MI
+
+#endif //RENDER_MDL_RUNTIME_I_MDLRT_ALIAS_TABLE_H
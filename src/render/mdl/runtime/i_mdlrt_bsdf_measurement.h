@@ -39,6 +39,8 @@
 #include <base/data/db/i_db_access.h>
 #include <io/scene/bsdf_measurement/i_bsdf_measurement.h>
 
+#include "i_mdlrt_alias_table.h"
+
 namespace MI {
 
 namespace DB { class Transaction; }
@@ -52,7 +54,10 @@ public:
     typedef mi::mdl::stdlib::Mbsdf_part Mbsdf_part;
 
     Bsdf_measurement();
-    Bsdf_measurement(Tag_type const &tag, DB::Transaction *trans);
+    Bsdf_measurement(
+        Tag_type const &tag,
+        DB::Transaction *trans,
+        bool use_alias_tables = false);
     virtual ~Bsdf_measurement();
 
     bool is_valid() const { return m_bsdf_measurement->is_valid(); }
@@ -73,9 +78,22 @@ public:
 
     mi::Float32_4 albedos(const mi::Float32_2& theta_phi) const;
 
+    /// Returns the CDFs for sampling the given part, or \c NULL if the part has no data.
+    ///
+    /// \param      part  the part of the measurement
+    /// \param[out] size  receives the number of floats
+    const float* get_sample_data(Mbsdf_part part, size_t &size) const;
+
+    /// Returns the alias tables for the CDFs of the given part, or \c NULL if they were not
+    /// built. The tables have as many entries as the CDFs.
+    const Alias_entry* get_alias_data(Mbsdf_part part) const;
+
 protected:
 
-    void prepare_mbsdfs_part(Mbsdf_part part, const mi::neuraylib::IBsdf_isotropic_data*);
+    void prepare_mbsdfs_part(
+        Mbsdf_part part,
+        const mi::neuraylib::IBsdf_isotropic_data*,
+        bool use_alias_tables);
     mi::Float32_2 albedo(const mi::Float32_2& theta_phi, Mbsdf_part part) const;
 
     DB::Access<BSDFM::Bsdf_measurement>      m_bsdf_measurement;      // the underlying bsdf meas.
@@ -85,6 +103,7 @@ protected:
     float*          m_eval_data[2];               // uses filter mode cudaFilterModeLinear
     float           m_max_albedo[2];              // max albedo used to limit the multiplier
     float*          m_sample_data[2];             // CDFs for sampling a BSDF measurement
+    Alias_entry*    m_alias_data[2];              // optional alias tables for the CDFs above
     float*          m_albedo_data[2];             // max albedo for each theta (isotropic)
 
     mi::Uint32_2    m_angular_resolution[2];      // size of the dataset, needed for texel access
@@ -38,6 +38,8 @@
 #include <base/data/db/i_db_access.h>
 #include <io/scene/lightprofile/i_lightprofile.h>
 
+#include "i_mdlrt_alias_table.h"
+
 namespace MI {
 
 namespace DB { class Transaction; }
@@ -51,7 +53,7 @@ public:
 
     Light_profile();
 
-    Light_profile(Tag_type const &tag, DB::Transaction *trans);
+    Light_profile(Tag_type const &tag, DB::Transaction *trans, bool use_alias_tables = false);
     virtual ~Light_profile();
 
     float get_power() const { return m_light_profile->get_power(); }
@@ -64,6 +66,19 @@ public:
     mi::Float32_3 sample(const mi::Float32_3& xi) const;
     mi::Float32 pdf(const mi::Float32_2& theta_phi) const;
 
+    /// Returns the CDFs for sampling, one for theta followed by one for phi per theta cell.
+    ///
+    /// \param[out] size  receives the number of floats
+    const float* get_cdf_data(size_t &size) const
+    {
+        size = (m_res_t - 1) * m_res_p;
+        return m_cdf_data;
+    }
+
+    /// Returns the alias tables for the CDFs, or \c NULL if they were not built. The tables
+    /// have as many entries as the CDFs.
+    const Alias_entry* get_alias_data() const { return m_alias_data; }
+
 protected:
     DB::Access<LIGHTPROFILE::Lightprofile>       m_light_profile;        // the underlying light profile
     DB::Access<LIGHTPROFILE::Lightprofile_impl>  m_light_profile_impl;   // the underlying light profile
@@ -76,6 +91,7 @@ protected:
     float   m_total_power;                  // power of the light source to be able to rescale
 
     float*  m_cdf_data;                     // CDFs for sampling a light profile
+    Alias_entry* m_alias_data;              // optional alias tables for the CDFs above
 };
 
 }  // MDLRT
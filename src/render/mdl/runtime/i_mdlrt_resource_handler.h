@@ -47,9 +47,12 @@ class Resource_handler : public mi::mdl::IResource_handler {
 public:
     /// Constructor.
     ///
-    /// \param use_derivatives  true if derivative texturing functions will be used
-    Resource_handler(bool use_derivatives=false)
+    /// \param use_derivatives   true if derivative texturing functions will be used
+    /// \param use_alias_tables  true if BSDF measurements and light profiles are sampled with
+    ///                          alias tables instead of binary searches in their CDFs
+    Resource_handler(bool use_derivatives=false, bool use_alias_tables=false)
         : m_use_derivatives(use_derivatives)
+        , m_use_alias_tables(use_alias_tables)
     {
     }
 
@@ -611,6 +614,9 @@ public:
 private:
     /// Specifies, whether derivative texture functions will be used.
     bool m_use_derivatives;
+
+    /// Specifies, whether BSDF measurements and light profiles build alias tables for sampling.
+    bool m_use_alias_tables;
 };
 
 }  // MDLRT
@@ -37,7 +37,7 @@
 
 #include <io/scene/texture/i_texture.h>
 #include <io/scene/dbimage/i_dbimage.h>
-#include <io/image/image/i_image_access_canvas.h>
+#include <io/image/image/i_image_texel_view.h>
 
 #include <map>
 #include <vector>
@@ -147,7 +147,7 @@ private:
 
     struct Uvtile {
         // Vector of mipmap levels. Only one element if \c m_use_derivatives is \c false.
-        std::vector<IMAGE::Access_canvas> m_canvas;
+        std::vector<IMAGE::Texel_view> m_canvas;
         std::vector<mi::Uint32_3> m_resolution;
         float m_gamma;
     };
@@ -228,7 +228,7 @@ public:
 
 private:
     struct Frame {
-        IMAGE::Access_canvas m_canvas;
+        IMAGE::Texel_view m_canvas;
         mi::Uint32_3 m_resolution;
         float m_gamma;
     };
@@ -252,7 +252,7 @@ public:
     mi::Spectrum lookup_color(const mi::Float32_3& coord) const;
 
 private:
-    IMAGE::Access_canvas m_canvas;
+    IMAGE::Texel_view m_canvas;
     mi::Uint32_3 m_resolution;
     float m_gamma;
 };
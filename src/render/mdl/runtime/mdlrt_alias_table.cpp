@@ -0,0 +1,104 @@
+/******************************************************************************
+ * Copyright (c) 2014-2022, NVIDIA CORPORATION. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *  * Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ *  * Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *  * Neither the name of NVIDIA CORPORATION nor the names of its
+ *    contributors may be used to endorse or promote products derived
+ *    from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+/** \file
+ ** \brief
+ **/
+
+#include "pch.h"
+
+#include "i_mdlrt_alias_table.h"
+
+#include <vector>
+
+namespace MI {
+namespace MDLRT {
+
+void build_alias_table(const float* cdf, unsigned n, Alias_entry* table)
+{
+    // probabilities of the bins, scaled such that the average is one
+    std::vector<double> scaled(n);
+    double sum = 0.0;
+    float prev = 0.0f;
+    for (unsigned i = 0; i < n; ++i)
+    {
+        float p = cdf[i] - prev;
+        prev = cdf[i];
+        if (!(p > 0.0f)) // also handles NaNs
+            p = 0.0f;
+        scaled[i] = p;
+        sum += p;
+    }
+
+    if (!(sum > 0.0))
+    {
+        for (unsigned i = 0; i < n; ++i)
+            table[i] = Alias_entry{1.0f, i};
+        return;
+    }
+
+    // Vose's method: pair each bin below the average with one above the average
+    std::vector<unsigned> small, large;
+    small.reserve(n);
+    large.reserve(n);
+
+    const double scale = double(n) / sum;
+    for (unsigned i = 0; i < n; ++i)
+    {
+        scaled[i] *= scale;
+        if (scaled[i] < 1.0)
+            small.push_back(i);
+        else
+            large.push_back(i);
+    }
+
+    while (!small.empty() && !large.empty())
+    {
+        const unsigned s = small.back();
+        small.pop_back();
+        const unsigned l = large.back();
+
+        table[s] = Alias_entry{float(scaled[s]), l};
+
+        scaled[l] = (scaled[l] + scaled[s]) - 1.0;
+        if (scaled[l] < 1.0)
+        {
+            large.pop_back();
+            small.push_back(l);
+        }
+    }
+
+    // the remaining bins are at the average, up to rounding errors
+    for (unsigned l : large)
+        table[l] = Alias_entry{1.0f, l};
+    for (unsigned s : small)
+        table[s] = Alias_entry{1.0f, s};
+}
+
+}  // MDLRT
+}  // MI
+
@@ -51,6 +51,7 @@ Bsdf_measurement::Bsdf_measurement()
         m_has_data[i] = 0u;
         m_eval_data[i] = nullptr;
         m_sample_data[i] = nullptr;
+        m_alias_data[i] = nullptr;
         m_albedo_data[i] = nullptr;
         m_max_albedo[i] = 0.0f;
         m_angular_resolution[i] = mi::Uint32_2{0u, 0u};
@@ -59,7 +60,10 @@ Bsdf_measurement::Bsdf_measurement()
     }
 }
 
-Bsdf_measurement::Bsdf_measurement(Tag_type const  &bm_t, DB::Transaction *trans)
+Bsdf_measurement::Bsdf_measurement(
+    Tag_type const  &bm_t,
+    DB::Transaction *trans,
+    bool            use_alias_tables)
     : Bsdf_measurement()
 {
     m_bsdf_measurement = DB::Access<BSDFM::Bsdf_measurement>(bm_t, trans);
@@ -70,13 +74,15 @@ Bsdf_measurement::Bsdf_measurement(Tag_type const  &bm_t, DB::Transaction *trans
     mi::base::Handle<const mi::neuraylib::IBsdf_isotropic_data> dataset(
         m_bsdf_measurement_impl->get_reflection<const mi::neuraylib::IBsdf_isotropic_data>());
     if(dataset)
-        prepare_mbsdfs_part(mi::mdl::stdlib::mbsdf_data_reflection, dataset.get());
+        prepare_mbsdfs_part(
+            mi::mdl::stdlib::mbsdf_data_reflection, dataset.get(), use_alias_tables);
 
     // handle transmission
     dataset = mi::base::Handle<const mi::neuraylib::IBsdf_isotropic_data>(
         m_bsdf_measurement_impl->get_transmission<const mi::neuraylib::IBsdf_isotropic_data>());
     if (dataset)
-        prepare_mbsdfs_part(mi::mdl::stdlib::mbsdf_data_reflection, dataset.get());
+        prepare_mbsdfs_part(
+            mi::mdl::stdlib::mbsdf_data_transmission, dataset.get(), use_alias_tables);
 }
 
 Bsdf_measurement::~Bsdf_measurement()
@@ -87,13 +93,34 @@ Bsdf_measurement::~Bsdf_measurement()
         {
             delete[] m_eval_data[i];
             delete[] m_sample_data[i];
+            delete[] m_alias_data[i];
             delete[] m_albedo_data[i];
         }
     }
 }
 
+const float* Bsdf_measurement::get_sample_data(Mbsdf_part part, size_t &size) const
+{
+    unsigned part_idx = static_cast<unsigned>(part);
+    if (m_has_data[part_idx] == 0u) {
+        size = 0;
+        return nullptr;
+    }
+
+    // one CDF for theta_out per theta_in, one CDF for phi_out per theta_in x theta_out
+    const mi::Uint32_2 &res = m_angular_resolution[part_idx];
+    size = size_t(res.x) * res.x * (1 + res.y);
+    return m_sample_data[part_idx];
+}
+
+const Alias_entry* Bsdf_measurement::get_alias_data(Mbsdf_part part) const
+{
+    return m_alias_data[static_cast<unsigned>(part)];
+}
+
 void Bsdf_measurement::prepare_mbsdfs_part(Mbsdf_part part, 
-                                           const mi::neuraylib::IBsdf_isotropic_data* dataset)
+                                           const mi::neuraylib::IBsdf_isotropic_data* dataset,
+                                           bool use_alias_tables)
 {
     unsigned part_idx = static_cast<unsigned>(part);
 
@@ -210,6 +237,26 @@ void Bsdf_measurement::prepare_mbsdfs_part(Mbsdf_part part,
     m_albedo_data[part_idx] = albedo_data;
     m_max_albedo[part_idx] = max_albedo;
 
+    // optionally, build alias tables with the same layout as the CDFs, which allow to select
+    // theta_out and phi_out in constant time
+    if (use_alias_tables)
+    {
+        Alias_entry* alias_data = new Alias_entry[sample_data_size];
+        for (unsigned int t_in = 0; t_in < res.x; ++t_in)
+        {
+            const unsigned int offset_theta = t_in * res.x;
+            build_alias_table(
+                sample_data_theta + offset_theta, res.x, alias_data + offset_theta);
+
+            for (unsigned int t_out = 0; t_out < res.x; ++t_out)
+            {
+                const unsigned int offset_phi = cdf_theta_size + (offset_theta + t_out) * res.y;
+                build_alias_table(sample_data + offset_phi, res.y, alias_data + offset_phi);
+            }
+        }
+        m_alias_data[part_idx] = alias_data;
+    }
+
 
     // ----------------------------------------------------------------------------------------
     // prepare evaluation data:
@@ -398,6 +445,7 @@ mi::Float32_3 Bsdf_measurement::sample(const mi::Float32_2& theta_phi_out,
     // CDF data
     mi::Uint32_2 res = m_angular_resolution[part_index];
     const float* sample_data = m_sample_data[part_index];
+    const Alias_entry* alias_data = m_alias_data[part_index];
 
     // compute the theta_in index (flipping input and output, BSDFs are symmetric)
     unsigned idx_theta_in = unsigned(theta_phi_out.x * M_ONE_OVER_PI * 2.0f * float(res.x));
@@ -407,23 +455,38 @@ mi::Float32_3 Bsdf_measurement::sample(const mi::Float32_2& theta_phi_out,
     //-------------------------------------------
     float xi0 = xi.x;
     const float* cdf_theta = sample_data + idx_theta_in * res.x;
-    unsigned idx_theta_out = sample_cdf(cdf_theta, res.x, xi0);       // binary search
+    unsigned idx_theta_out;
+    float prob_theta;
+    if (alias_data)
+    {
+        idx_theta_out = sample_alias_table(                             // table lookup
+            alias_data + idx_theta_in * res.x, res.x, xi0);             // (rescales xi0)
 
-    float prob_theta = cdf_theta[idx_theta_out];
-    if (idx_theta_out > 0)
+        prob_theta = cdf_theta[idx_theta_out];
+        if (idx_theta_out > 0)
+            prob_theta -= cdf_theta[idx_theta_out - 1];
+    }
+    else
     {
-        const float tmp = cdf_theta[idx_theta_out - 1];
-        prob_theta -= tmp;
-        xi0 -= tmp;
+        idx_theta_out = sample_cdf(cdf_theta, res.x, xi0);              // binary search
+
+        prob_theta = cdf_theta[idx_theta_out];
+        if (idx_theta_out > 0)
+        {
+            const float tmp = cdf_theta[idx_theta_out - 1];
+            prob_theta -= tmp;
+            xi0 -= tmp;
+        }
+        xi0 /= prob_theta; // rescale for re-usage
     }
-    xi0 /= prob_theta; // rescale for re-usage
 
     // sample phi_out
     //-------------------------------------------
     float xi1 = xi.y;
-    const float* cdf_phi = sample_data +
+    const unsigned offset_phi =
         (res.x * res.x) +                                // CDF theta block
         (idx_theta_in * res.x + idx_theta_out) * res.y;  // selected CDF phi
+    const float* cdf_phi = sample_data + offset_phi;
 
 // select which half-circle to choose with probability 0.5
     const bool flip = (xi1 > 0.5f);
@@ -431,15 +494,30 @@ mi::Float32_3 Bsdf_measurement::sample(const mi::Float32_2& theta_phi_out,
         xi1 = 1.0f - xi1;
     xi1 *= 2.0f;
 
-    unsigned idx_phi_out = sample_cdf(cdf_phi, res.y, xi1);           // binary search
-    float prob_phi = cdf_phi[idx_phi_out];
-    if (idx_phi_out > 0)
+    unsigned idx_phi_out;
+    float prob_phi;
+    if (alias_data)
     {
-        const float tmp = cdf_phi[idx_phi_out - 1];
-        prob_phi -= tmp;
-        xi1 -= tmp;
+        idx_phi_out = sample_alias_table(                               // table lookup
+            alias_data + offset_phi, res.y, xi1);                       // (rescales xi1)
+
+        prob_phi = cdf_phi[idx_phi_out];
+        if (idx_phi_out > 0)
+            prob_phi -= cdf_phi[idx_phi_out - 1];
+    }
+    else
+    {
+        idx_phi_out = sample_cdf(cdf_phi, res.y, xi1);                  // binary search
+
+        prob_phi = cdf_phi[idx_phi_out];
+        if (idx_phi_out > 0)
+        {
+            const float tmp = cdf_phi[idx_phi_out - 1];
+            prob_phi -= tmp;
+            xi1 -= tmp;
+        }
+        xi1 /= prob_phi; // rescale for re-usage
     }
-    xi1 /= prob_phi; // rescale for re-usage
 
     // compute theta and phi out
     //-------------------------------------------
@@ -43,14 +43,18 @@ namespace MI {
 namespace MDLRT {
 
 Light_profile::Light_profile()
+: m_cdf_data(nullptr)
+, m_alias_data(nullptr)
 {
 }
 
 Light_profile::Light_profile(
     Tag_type const  &tex_t,
-    DB::Transaction *trans)
+    DB::Transaction *trans,
+    bool            use_alias_tables)
 : m_light_profile(tex_t, trans)
 , m_light_profile_impl(m_light_profile->get_impl_tag(), trans)
+, m_alias_data(nullptr)
 {
     m_res_t = m_light_profile->get_resolution_theta();
     m_res_p = m_light_profile->get_resolution_phi();
@@ -126,12 +130,27 @@ Light_profile::Light_profile(
         m_cdf_data[t] = sum_theta ? (m_cdf_data[t] / sum_theta) : m_cdf_data[t];
 
     m_cdf_data[m_res_t - 2] = 1.0f;
+
+    // optionally, build alias tables with the same layout as the CDFs, which allow to select
+    // theta and phi in constant time
+    if (use_alias_tables)
+    {
+        m_alias_data = new Alias_entry[cdf_data_size];
+        build_alias_table(m_cdf_data, unsigned(m_res_t - 1), m_alias_data);
+        for (unsigned int t = 0; t < m_res_t - 1; ++t)
+        {
+            const size_t offset_phi = (m_res_t - 1) + t * (m_res_p - 1);
+            build_alias_table(
+                m_cdf_data + offset_phi, unsigned(m_res_p - 1), m_alias_data + offset_phi);
+        }
+    }
 }
 
 Light_profile::~Light_profile()
 {
     if (m_cdf_data) 
         delete[] m_cdf_data;
+    delete[] m_alias_data;
 }
 
 
@@ -215,32 +234,61 @@ mi::Float32_3 Light_profile::sample(const mi::Float32_3& xi) const
     //-------------------------------------------
     float xi0 = xi.x;
     const float* cdf_data_theta = m_cdf_data;                           // CDF theta
-    unsigned idx_theta = sample_cdf(cdf_data_theta, m_res_t - 1, xi0);  // binary search
+    unsigned idx_theta;
+    float prob_theta;
+    if (m_alias_data)
+    {
+        idx_theta = sample_alias_table(m_alias_data, m_res_t - 1, xi0); // table lookup
 
-    float prob_theta = cdf_data_theta[idx_theta];
-    if (idx_theta > 0)
+        prob_theta = cdf_data_theta[idx_theta];
+        if (idx_theta > 0)
+            prob_theta -= cdf_data_theta[idx_theta - 1];
+    }
+    else
     {
-        const float tmp = cdf_data_theta[idx_theta - 1];
-        prob_theta -= tmp;
-        xi0 -= tmp;
+        idx_theta = sample_cdf(cdf_data_theta, m_res_t - 1, xi0);       // binary search
+
+        prob_theta = cdf_data_theta[idx_theta];
+        if (idx_theta > 0)
+        {
+            const float tmp = cdf_data_theta[idx_theta - 1];
+            prob_theta -= tmp;
+            xi0 -= tmp;
+        }
+        xi0 /= prob_theta; // rescale for re-usage
     }
-    xi0 /= prob_theta; // rescale for re-usage
 
     // sample phi_out
     //-------------------------------------------
     float xi1 = xi.y;
-    const float* cdf_data_phi = cdf_data_theta + (m_res_t - 1)          // CDF theta block
+    const size_t offset_phi = (m_res_t - 1)                             // CDF theta block
         + (idx_theta * (m_res_p - 1));                                  // selected CDF for phi
+    const float* cdf_data_phi = cdf_data_theta + offset_phi;
 
-    unsigned idx_phi = sample_cdf(cdf_data_phi, m_res_p - 1, xi1);      // binary search
-    float prob_phi = cdf_data_phi[idx_phi];
-    if (idx_phi > 0)
+    unsigned idx_phi;
+    float prob_phi;
+    if (m_alias_data)
     {
-        const float tmp = cdf_data_phi[idx_phi - 1];
-        prob_phi -= tmp;
-        xi1 -= tmp;
+        idx_phi = sample_alias_table(                                   // table lookup
+            m_alias_data + offset_phi, m_res_p - 1, xi1);
+
+        prob_phi = cdf_data_phi[idx_phi];
+        if (idx_phi > 0)
+            prob_phi -= cdf_data_phi[idx_phi - 1];
+    }
+    else
+    {
+        idx_phi = sample_cdf(cdf_data_phi, m_res_p - 1, xi1);           // binary search
+
+        prob_phi = cdf_data_phi[idx_phi];
+        if (idx_phi > 0)
+        {
+            const float tmp = cdf_data_phi[idx_phi - 1];
+            prob_phi -= tmp;
+            xi1 -= tmp;
+        }
+        xi1 /= prob_phi; // rescale for re-usage
     }
-    xi1 /= prob_phi; // rescale for re-usage
 
     // compute theta and phi
     //-------------------------------------------
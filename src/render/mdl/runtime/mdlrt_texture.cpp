@@ -219,7 +219,7 @@ unsigned int texremapzll(
 }
 
 mi::Float32_4 interpolate_biquintic(
-    const IMAGE::Access_canvas &canvas,
+    const IMAGE::Texel_view &canvas,
     const mi::Uint32_3 &texture_res,
     const mi::mdl::stdlib::Tex_wrap_mode wrap_u,
     const mi::mdl::stdlib::Tex_wrap_mode wrap_v,
@@ -354,8 +354,9 @@ mi::Float32_4 interpolate_biquintic(
 mi::neuraylib::ICanvas* convert_to_fp_type_with_linear_gamma(
     IMAGE::Image_module* image_module, const mi::neuraylib::ICanvas* input, mi::Float32 gamma)
 {
-    // Choose floating-point pixel type.
-    IMAGE::Pixel_type pixel_type = IMAGE::convert_pixel_type_string_to_enum(input->get_type());
+    // Choose floating-point pixel type (based on the decompressed type for block-compressed data).
+    IMAGE::Pixel_type pixel_type = IMAGE::get_decompressed_pixel_type(
+        IMAGE::convert_pixel_type_string_to_enum(input->get_type()));
     switch (pixel_type) {
         case IMAGE::PT_RGB:
         case IMAGE::PT_RGBE:
@@ -379,6 +380,16 @@ mi::neuraylib::ICanvas* convert_to_fp_type_with_linear_gamma(
         case IMAGE::PT_FLOAT32:
             // no change necessary
             break;
+        case IMAGE::PT_BC1:
+        case IMAGE::PT_BC2:
+        case IMAGE::PT_BC3:
+        case IMAGE::PT_BC4:
+        case IMAGE::PT_BC4S:
+        case IMAGE::PT_BC5:
+        case IMAGE::PT_BC5S:
+        case IMAGE::PT_BC6H:
+        case IMAGE::PT_BC6HS:
+        case IMAGE::PT_BC7:
         case IMAGE::PT_UNDEF:
             ASSERT(M_BACKENDS, false);
             break;
@@ -477,7 +488,7 @@ Texture_2d::Texture_2d(
                 uvtile.m_gamma = 1.0f;
             }
 
-            uvtile.m_canvas[0] = IMAGE::Access_canvas(canvas.get(), true);
+            uvtile.m_canvas[0] = IMAGE::Texel_view(canvas.get());
             uvtile.m_resolution[0] = mi::Uint32_3(
                 canvas->get_resolution_x(), canvas->get_resolution_y(), 0);
 
@@ -493,7 +504,7 @@ Texture_2d::Texture_2d(
 
             for (mi::Uint32 k = 1; k < n_levels; ++k) {
                 const auto& level = mipmaps[k-1];
-                uvtile.m_canvas[k] = IMAGE::Access_canvas(level.get(), true);
+                uvtile.m_canvas[k] = IMAGE::Texel_view(level.get());
                 uvtile.m_resolution[k] = mi::Uint32_3(
                   canvas->get_resolution_x(), canvas->get_resolution_y(), 0);
             }
@@ -867,7 +878,7 @@ Texture_3d::Texture_3d(
         mi::base::Handle<const IMAGE::IMipmap> mipmap(
             image_impl->get_mipmap(i, /*uvtile_id*/ 0));
         mi::base::Handle<const mi::neuraylib::ICanvas> canvas(mipmap->get_level(0));
-        frame.m_canvas = IMAGE::Access_canvas(canvas.get(), true);
+        frame.m_canvas = IMAGE::Texel_view(canvas.get());
 
         frame.m_resolution = mi::Uint32_3(
             canvas->get_resolution_x(), canvas->get_resolution_y(), canvas->get_layers_size());
@@ -1080,7 +1091,7 @@ Texture_cube::Texture_cube(
     mi::base::Handle<const IMAGE::IMipmap> mipmap(image->get_mipmap(
         transaction, /*frame_id*/0, /*uvtile_id*/0));
     mi::base::Handle<const mi::neuraylib::ICanvas> canvas(mipmap->get_level(/*level*/0));
-    m_canvas = IMAGE::Access_canvas(canvas.get(), true);
+    m_canvas = IMAGE::Texel_view(canvas.get());
 
     m_resolution = mi::Uint32_3(canvas->get_resolution_x(), canvas->get_resolution_y(), 0);
 
@@ -180,24 +180,47 @@ bool Image::load_header(
             // Supported compressed formats
             case FOURCC_DXT1:
                 compress_format = DXTC1;
-                pixel_type = IMAGE::PT_RGBA;
+                pixel_type = IMAGE::PT_BC1;
                 gamma = get_default_gamma( pixel_type);
                 return true;
             case FOURCC_DXT3:
                 compress_format = DXTC3;
-                pixel_type = IMAGE::PT_RGBA;
+                pixel_type = IMAGE::PT_BC2;
                 gamma = get_default_gamma( pixel_type);
                 return true;
             case FOURCC_DXT5:
                 compress_format = DXTC5;
-                pixel_type = IMAGE::PT_RGBA;
+                pixel_type = IMAGE::PT_BC3;
+                gamma = get_default_gamma( pixel_type);
+                return true;
+            case FOURCC_BC4U:
+            case FOURCC_ATI1:
+                compress_format = BC4U;
+                pixel_type = IMAGE::PT_BC4;
+                gamma = get_default_gamma( pixel_type);
+                return true;
+            case FOURCC_BC4S:
+                compress_format = BC4S;
+                pixel_type = IMAGE::PT_BC4S;
+                gamma = get_default_gamma( pixel_type);
+                return true;
+            case FOURCC_BC5U:
+            case FOURCC_ATI2:
+                compress_format = BC5U;
+                pixel_type = IMAGE::PT_BC5;
+                gamma = 1.0f; // typically used for normal maps
+                return true;
+            case FOURCC_BC5S:
+                compress_format = BC5S;
+                pixel_type = IMAGE::PT_BC5S;
                 gamma = get_default_gamma( pixel_type);
                 return true;
 
             // DX10 header
             case FOURCC_DX10: {
                 is_header_dx10 = true;
-                return load_header_dx10( reader, header_dx10, pixel_type, gamma);
+                return load_header_dx10(
+                    reader, header_dx10, pixel_type, gamma, compress_format);
             }
 
 
@@ -282,7 +305,8 @@ bool Image::load_header_dx10(
     mi::neuraylib::IReader* reader,
     Header_dx10& header_dx10,
     IMAGE::Pixel_type& pixel_type,
-    mi::Float32& gamma)
+    mi::Float32& gamma,
+    Dds_compress_fmt& compress_format)
 {
     if( !reader)
         return false;
@@ -295,12 +319,89 @@ bool Image::load_header_dx10(
         return false;
     }
 
+    // Only the block-compressed formats are supported. Typeless formats are treated like their
+    // UNORM (or UF16) counterparts.
+    switch( header_dx10.m_dxgi_format) {
+        case DXGI_FORMAT_BC1_TYPELESS:
+        case DXGI_FORMAT_BC1_UNORM:
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+            compress_format = DXTC1;
+            pixel_type = IMAGE::PT_BC1;
+            break;
+        case DXGI_FORMAT_BC2_TYPELESS:
+        case DXGI_FORMAT_BC2_UNORM:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:
+            compress_format = DXTC3;
+            pixel_type = IMAGE::PT_BC2;
+            break;
+        case DXGI_FORMAT_BC3_TYPELESS:
+        case DXGI_FORMAT_BC3_UNORM:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+            compress_format = DXTC5;
+            pixel_type = IMAGE::PT_BC3;
+            break;
+        case DXGI_FORMAT_BC4_TYPELESS:
+        case DXGI_FORMAT_BC4_UNORM:
+            compress_format = BC4U;
+            pixel_type = IMAGE::PT_BC4;
+            break;
+        case DXGI_FORMAT_BC4_SNORM:
+            compress_format = BC4S;
+            pixel_type = IMAGE::PT_BC4S;
+            break;
+        case DXGI_FORMAT_BC5_TYPELESS:
+        case DXGI_FORMAT_BC5_UNORM:
+            compress_format = BC5U;
+            pixel_type = IMAGE::PT_BC5;
+            break;
+        case DXGI_FORMAT_BC5_SNORM:
+            compress_format = BC5S;
+            pixel_type = IMAGE::PT_BC5S;
+            break;
+        case DXGI_FORMAT_BC6H_TYPELESS:
+        case DXGI_FORMAT_BC6H_UF16:
+            compress_format = BC6HU;
+            pixel_type = IMAGE::PT_BC6H;
+            break;
+        case DXGI_FORMAT_BC6H_SF16:
+            compress_format = BC6HS;
+            pixel_type = IMAGE::PT_BC6HS;
+            break;
+        case DXGI_FORMAT_BC7_TYPELESS:
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            compress_format = BC7;
+            pixel_type = IMAGE::PT_BC7;
+            break;
+        default: {
+            std::string message = "Unsupported DDS subformat "
+                + get_dxgi_format_string( header_dx10.m_dxgi_format) + ".";
+            log( mi::base::MESSAGE_SEVERITY_ERROR, message.c_str());
+            return false;
+        }
+    }
 
-    std::string message = "Unsupported DDS subformat "
-        + get_dxgi_format_string( header_dx10.m_dxgi_format) + ".";
-    log( mi::base::MESSAGE_SEVERITY_ERROR, message.c_str());
-    return false;
+    if( header_dx10.m_array_size > 1)
+        log( mi::base::MESSAGE_SEVERITY_WARNING,
+            "DDS texture arrays are not supported, using only the first element.");
+
+    switch( header_dx10.m_dxgi_format) {
+        case DXGI_FORMAT_BC1_UNORM_SRGB:
+        case DXGI_FORMAT_BC2_UNORM_SRGB:
+        case DXGI_FORMAT_BC3_UNORM_SRGB:
+        case DXGI_FORMAT_BC7_UNORM_SRGB:
+            gamma = 2.2f;
+            break;
+        case DXGI_FORMAT_BC5_TYPELESS:
+        case DXGI_FORMAT_BC5_UNORM:
+            gamma = 1.0f; // typically used for normal maps
+            break;
+        default:
+            gamma = get_default_gamma( pixel_type);
+            break;
+    }
 
+    return true;
 }
 
 bool Image::load( mi::neuraylib::IReader* reader)
@@ -351,9 +452,10 @@ bool Image::load( mi::neuraylib::IReader* reader)
             if( halfs)
                 expand_half( buffer);
 
-            // Create miplevel
+            // Create miplevel (blocks of compressed surfaces are kept top-down)
             Surface surface( width, height, depth, buffer.size(), &buffer[0]);
-            flip_surface( surface);
+            if( !is_compressed())
+                flip_surface( surface);
 
             m_texture.add_surface( surface);
 
@@ -462,22 +564,35 @@ bool Image::save( mi::neuraylib::IWriter* writer)
 
     header.m_ddspf.m_size = sizeof( Pixel_format);
 
+    // BC6H and BC7 have no FourCC code and require the DX10 header.
+    Header_dx10 header_dx10;
+    memset( &header_dx10, 0, sizeof( Header_dx10));
+    bool is_header_dx10 = false;
+
     if( is_compressed()) {
+        header.m_ddspf.m_flags = DDSF_FOURCC;
         switch( m_compress_format) {
-            case DXTC1:
-                header.m_ddspf.m_flags = DDSF_FOURCC;
-                header.m_ddspf.m_four_cc = FOURCC_DXT1;
-                break;
-            case DXTC3:
-                header.m_ddspf.m_flags = DDSF_FOURCC;
-                header.m_ddspf.m_four_cc = FOURCC_DXT3;
-                break;
-            case DXTC5:
-                header.m_ddspf.m_flags = DDSF_FOURCC;
-                header.m_ddspf.m_four_cc = FOURCC_DXT5;
-                break;
-            default:
+            case DXTC1: header.m_ddspf.m_four_cc = FOURCC_DXT1; break;
+            case DXTC3: header.m_ddspf.m_four_cc = FOURCC_DXT3; break;
+            case DXTC5: header.m_ddspf.m_four_cc = FOURCC_DXT5; break;
+            case BC4U:  header.m_ddspf.m_four_cc = FOURCC_BC4U; break;
+            case BC4S:  header.m_ddspf.m_four_cc = FOURCC_BC4S; break;
+            case BC5U:  header.m_ddspf.m_four_cc = FOURCC_BC5U; break;
+            case BC5S:  header.m_ddspf.m_four_cc = FOURCC_BC5S; break;
+            case BC6HU: header_dx10.m_dxgi_format = DXGI_FORMAT_BC6H_UF16;  break;
+            case BC6HS: header_dx10.m_dxgi_format = DXGI_FORMAT_BC6H_SF16;  break;
+            case BC7:   header_dx10.m_dxgi_format = DXGI_FORMAT_BC7_UNORM;  break;
+            case DXTC_none:
                 assert( false);
+                break;
+        }
+        if( header_dx10.m_dxgi_format != DXGI_FORMAT_UNKNOWN) {
+            is_header_dx10 = true;
+            header.m_ddspf.m_four_cc = FOURCC_DX10;
+            header_dx10.m_resource_dimension = m_texture_type == TEXTURE_3D
+                ? DDS_DIMENSION_TEXTURE3D : DDS_DIMENSION_TEXTURE2D;
+            header_dx10.m_misc_flag = m_texture_type == TEXTURE_CUBEMAP ? DDS_RESOURCE_MISC_TEXTURECUBE : 0;
+            header_dx10.m_array_size = 1;
         }
     } else {
         header.m_ddspf.m_flags = (get_components() == 4) ? DDSF_RGBA : DDSF_RGB;
@@ -526,6 +641,16 @@ bool Image::save( mi::neuraylib::IWriter* writer)
         return false;
     }
 
+    // Write the DDS DX10 header
+    if( is_header_dx10) {
+        bytes_written = writer->write(
+            reinterpret_cast<const char*>( &header_dx10), sizeof( Header_dx10));
+        if( bytes_written != sizeof( Header_dx10)) {
+            clear();
+            return false;
+        }
+    }
+
     if( !is_cubemap()) {
 
         // Loop over the miplevels
@@ -533,8 +658,9 @@ bool Image::save( mi::neuraylib::IWriter* writer)
 
             Surface& surface = m_texture.get_surface( s);
 
-            // Prepare the miplevel for export
-            flip_surface( surface);
+            // Prepare the miplevel for export (blocks of compressed surfaces are already top-down)
+            if( !is_compressed())
+                flip_surface( surface);
 
             // Export the miplevel
             bytes_written = writer->write(
@@ -579,148 +705,50 @@ bool Image::save( mi::neuraylib::IWriter* writer)
     return true;
 }
 
+Dds_compress_fmt Image::get_compress_format( IMAGE::Pixel_type pixel_type)
+{
+    switch( pixel_type) {
+        case IMAGE::PT_BC1:   return DXTC1;
+        case IMAGE::PT_BC2:   return DXTC3;
+        case IMAGE::PT_BC3:   return DXTC5;
+        case IMAGE::PT_BC4:   return BC4U;
+        case IMAGE::PT_BC4S:  return BC4S;
+        case IMAGE::PT_BC5:   return BC5U;
+        case IMAGE::PT_BC5S:  return BC5S;
+        case IMAGE::PT_BC6H:  return BC6HU;
+        case IMAGE::PT_BC6HS: return BC6HS;
+        case IMAGE::PT_BC7:   return BC7;
+        default:              return DXTC_none;
+    }
+}
+
 mi::Uint32 Image::get_layer_size( mi::Uint32 width, mi::Uint32 height)
 {
     return is_compressed()
-        ? ((width+3)/4) * ((height+3)/4) * (m_compress_format == DXTC1 ? 8 : 16)
+        ? ((width+3)/4) * ((height+3)/4) * get_bytes_per_block( m_compress_format)
             : width * height * IMAGE::get_bytes_per_pixel( m_pixel_type);
 }
 
 void Image::flip_surface( Surface& surface)
 {
-    if( !is_compressed()) {
-
-        mi::Uint32 layer_size = surface.get_size() / surface.get_depth();
-        mi::Uint32 row_size   = layer_size/surface.get_height();
-
-        for( mi::Uint32 z = 0; z < surface.get_depth(); ++z) {
-
-            mi::Uint8* top    = surface.get_pixels() + z * layer_size;
-            mi::Uint8* bottom = top + (layer_size-row_size);
-
-            for( mi::Uint32 y = 0; y < surface.get_height() / 2; ++y) {
-                swap( bottom, top, row_size);
-                top    += row_size;
-                bottom -= row_size;
-            }
-        }
-
-    } else {
-
-        mi::Uint32 block_size;
-        void (*flip_blocks)(DXT_color_block*, mi::Uint32);
-
-        switch( m_compress_format) {
-            case DXTC1:
-                block_size = 8; //-V525 PVS
-                flip_blocks = &Image::flip_blocks_dxtc1;
-                break;
-            case DXTC3:
-                block_size = 16;
-                flip_blocks = &Image::flip_blocks_dxtc3;
-                break;
-            case DXTC5:
-                block_size = 16;
-                flip_blocks = &Image::flip_blocks_dxtc5;
-                break;
-            default:
-                return;
-        }
-
-        mi::Uint32 blocks_x   = surface.get_width()  / 4;
-        mi::Uint32 blocks_y   = surface.get_height() / 4;
-        mi::Uint32 row_size   = blocks_x * block_size;
-        mi::Uint32 layer_size = row_size * blocks_y;
+    assert( !is_compressed());
 
-        for( mi::Uint32 z = 0; z < surface.get_depth(); ++z) {
-
-            for( mi::Uint32 y = 0; y < blocks_y / 2; ++y) {
+    mi::Uint32 layer_size = surface.get_size() / surface.get_depth();
+    mi::Uint32 row_size   = layer_size/surface.get_height();
 
-                DXT_color_block* top = reinterpret_cast<DXT_color_block*>(
-                    surface.get_pixels() + z * layer_size + y * row_size);
-                DXT_color_block* bottom = reinterpret_cast<DXT_color_block*>(
-                    surface.get_pixels() + z * layer_size + (blocks_y-y-1) * row_size);
-                flip_blocks( top, blocks_x);
-                flip_blocks( bottom, blocks_x);
-                swap( bottom, top, row_size);
-            }
+    for( mi::Uint32 z = 0; z < surface.get_depth(); ++z) {
 
-            if( blocks_y % 2 == 1) {
+        mi::Uint8* top    = surface.get_pixels() + z * layer_size;
+        mi::Uint8* bottom = top + (layer_size-row_size);
 
-                DXT_color_block* middle = reinterpret_cast<DXT_color_block*>(
-                    surface.get_pixels() + z * layer_size + blocks_y/2 * row_size);
-                flip_blocks( middle, blocks_x);
-
-            }
+        for( mi::Uint32 y = 0; y < surface.get_height() / 2; ++y) {
+            swap( bottom, top, row_size);
+            top    += row_size;
+            bottom -= row_size;
         }
     }
 }
 
-void Image::flip_blocks_dxtc1( DXT_color_block* line, mi::Uint32 num_blocks)
-{
-    DXT_color_block* block = line;
-
-    for( mi::Uint32 i = 0; i < num_blocks; ++i) {
-        std::swap( block->m_row[0], block->m_row[3]);
-        std::swap( block->m_row[1], block->m_row[2]);
-        block++;
-    }
-}
-
-void Image::flip_blocks_dxtc3( DXT_color_block* line, mi::Uint32 num_blocks)
-{
-    DXT_color_block* block = line;
-
-    for( mi::Uint32 i = 0; i < num_blocks; ++i) {
-
-        DXT3_alpha_block* alpha_block = reinterpret_cast<DXT3_alpha_block*>( block);
-        std::swap( alpha_block->m_row[0], alpha_block->m_row[3]);
-        std::swap( alpha_block->m_row[1], alpha_block->m_row[2]);
-        block++;
-
-        std::swap( block->m_row[0], block->m_row[3]);
-        std::swap( block->m_row[1], block->m_row[2]);
-        block++;
-    }
-}
-
-void Image::flip_blocks_dxtc5( DXT_color_block* line, mi::Uint32 num_blocks)
-{
-    DXT_color_block* block = line;
-    for( mi::Uint32 i = 0; i < num_blocks; ++i) {
-
-        flip_dxt5_alpha( reinterpret_cast<DXT5_alpha_block*>( block));
-        block++;
-
-        std::swap( block->m_row[0], block->m_row[3]);
-        std::swap( block->m_row[1], block->m_row[2]);
-        block++;
-    }
-}
-
-void Image::flip_dxt5_alpha( DXT5_alpha_block* block)
-{
-    // Read next 48 bits (3 bits per pixel) of block into a mi::Uint64 for easier manipulation.
-    mi::Uint64 bits = 0;
-    for( int i = 5; i >= 0; --i) {
-        bits <<= 8;
-        bits |= block->m_row[i];
-    }
-
-    // Swap the rows.
-    mi::Uint64 flipped_bits = 0;
-    flipped_bits |= (bits >> 36) & 0x0fffull;
-    flipped_bits |= (bits >> 12) & 0x0fff000ull;
-    flipped_bits |= (bits << 12) & 0x0fff000000ull;
-    flipped_bits |= (bits << 36) & 0x0fff000000000ull;
-
-    // Write flipped bits back.
-    for( int i = 0; i < 6; ++i) {
-        block->m_row[i] = static_cast<mi::Uint8>( flipped_bits & 0xff);
-        flipped_bits >>= 8;
-    }
-}
-
 void Image::reorder_rgb_or_rgba( Header& header)
 {
     if( is_compressed())
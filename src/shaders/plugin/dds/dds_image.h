@@ -44,8 +44,9 @@ namespace DDS {
 
 /// An image (in DDS terms) is a wrapper around a DDS texture.
 ///
-/// Note that this classes does not take care of compression. If the data is compressed and you need
-/// it uncompressed, you have to apply the Dxt_decompressor yourself.
+/// Note that this classes does not take care of compression. Compressed data is kept as blocks in
+/// the top-down order of DDS, which matches the layout of the block-compressed IMAGE pixel types.
+/// Only uncompressed data is flipped.
 class Image
 {
 public:
@@ -77,7 +78,6 @@ public:
     /// \param pixel_type[out]        The pixel type (decoded from the header) is stored here.
     /// \param gamma[out]             The gamma value (decoded form the header) is stored here.
     /// \param compress_format[out]   The compression format (dec. from the header) is stored here.
-    ///                               Only valid for non-DX10 headers.
     /// \return                       \c true if the file format can be read, \c false otherwise.
     static bool load_header(
         mi::neuraylib::IReader* reader,
@@ -129,6 +129,11 @@ public:
     /// Indicates whether the image is compressed.
     bool is_compressed() const { return m_compress_format != DXTC_none; }
 
+    /// Returns the compression format for a pixel type.
+    ///
+    /// Returns DXTC_none for pixel types that are not block-compressed.
+    static Dds_compress_fmt get_compress_format( IMAGE::Pixel_type pixel_type);
+
     /// Returns the number of surfaces.
     mi::Uint32 get_num_surfaces() const
     {
@@ -159,34 +164,23 @@ private:
     /// \param header_dx10[out]       The DX10 header information is stored here.
     /// \param pixel_type[out]        The pixel type (decoded from the header) is stored here.
     /// \param gamma[out]             The gamma value (decoded from the header) is stored here.
+    /// \param compress_format[out]   The compression format (dec. from the header) is stored here.
     /// \return                       \c true if the file format can be read, \c false otherwise.
     static bool load_header_dx10(
         mi::neuraylib::IReader* reader,
         Header_dx10& header_dx10,
         IMAGE::Pixel_type& pixel_type,
-        mi::Float32& gamma);
-
+        mi::Float32& gamma,
+        Dds_compress_fmt& compress_format);
 
     /// Returns the size of an surface with the given width and height and depth 1.
     ///
     /// Takes compression into account (if the surface is compressed).
     mi::Uint32 get_layer_size( mi::Uint32 width, mi::Uint32 height);
 
-    /// Flips surface around X axis.
+    /// Flips an uncompressed surface around X axis.
     void flip_surface( Surface& surface);
 
-    /// Flips DXTC1 blocks.
-    static void flip_blocks_dxtc1( DXT_color_block* line, mi::Uint32 num_blocks);
-
-    /// Flips DXTC3 blocks.
-    static void flip_blocks_dxtc3( DXT_color_block* line, mi::Uint32 num_blocks);
-
-    /// Flips DXTC5 blocks.
-    static void flip_blocks_dxtc5( DXT_color_block* line, mi::Uint32 num_blocks);
-
-    /// Flips a DXTC5 alpha block.
-    static void flip_dxt5_alpha( DXT5_alpha_block* block);
-
     /// Reorders uncompressed DDS RGB(A) pixel data into neuray RGB(A) component order
     ///
     /// The DDS RGB(A) pixel data actually might not be in RGB(A) order, but in a different order.
@@ -220,7 +214,8 @@ private:
     /// them to layers of the same texture (like a 3D texture of depth 6).
     ///
     /// Also notethat  DDS stores images top-down, while neuray stores them bottom-up. Hence, all
-    /// images have to be flipped, except for cubemaps, which are stored top-down in neuray.
+    /// images have to be flipped, except for cubemaps, which are stored top-down in neuray, and
+    /// compressed images, whose blocks are stored top-down in neuray as well.
     Texture m_texture;
 };
 
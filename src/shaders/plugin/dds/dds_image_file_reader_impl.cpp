@@ -30,7 +30,6 @@
 
 #include "dds_image_file_reader_impl.h"
 
-#include "dds_decompress.h"
 #include "dds_utilities.h"
 
 #include <mi/neuraylib/iimage_api.h>
@@ -41,6 +40,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 
 namespace MI {
 
@@ -133,28 +133,10 @@ mi::neuraylib::ITile* Image_file_reader_impl::read(
 
     } else {
 
-        // Compressed images
-        mi::Uint32 bytes_per_pixel = get_bytes_per_pixel( m_pixel_type);
-        mi::Uint32 bytes_per_layer = image_width * image_height * bytes_per_pixel;
-
-        Dxt_decompressor decompressor;
-        decompressor.set_source_format( m_image.get_compressed_format(), image_width, image_height);
-        decompressor.set_target_format( get_components_per_pixel( m_pixel_type), image_width);
-
-        mi::Uint32 block_height = decompressor.get_block_dimension();
-        mi::Uint32 bytes_per_block = image_width * block_height * bytes_per_pixel;
-
-        const mi::Uint8* src = surface.get_pixels() + z * surface.get_size() / 6;
-        const mi::Uint8* buffer1 = decompressor.get_buffer();
-        mi::Uint8* buffer2 = new mi::Uint8[bytes_per_layer];
-
-        for( mi::Uint32 block = 0; block < decompressor.get_block_count_y(); ++block) {
-            decompressor.decompress_blockline( src, block);
-            memcpy( buffer2 + block * bytes_per_block, buffer1, bytes_per_block);
-        }
-
-        copy_from_dds_to_tile( buffer2, image_width, image_height, tile.get());
-        delete[] buffer2;
+        // Compressed images are passed on as blocks, which are stored top-down like in DDS.
+        mi::Size bytes_per_layer = surface.get_size() / surface.get_depth();
+        assert( bytes_per_layer == get_data_size( m_pixel_type, image_width, image_height));
+        memcpy( tile->get_data(), surface.get_pixels() + z * bytes_per_layer, bytes_per_layer);
     }
 
     tile->retain();
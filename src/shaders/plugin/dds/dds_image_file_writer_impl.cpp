@@ -38,6 +38,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstring>
 
 namespace MI {
 
@@ -72,7 +73,7 @@ Image_file_writer_impl::Image_file_writer_impl(
         mi::Uint32 width  = std::max( m_resolution_x >> i, 1u);
         mi::Uint32 height = std::max( m_resolution_y >> i, 1u);
         mi::Uint32 depth  = std::max( m_nr_of_layers >> i, 1u);
-        mi::Uint32 bytes_per_level = width * height * depth * get_bytes_per_pixel( m_pixel_type);
+        mi::Size bytes_per_level = get_data_size( m_pixel_type, width, height) * depth;
         m_level[i].resize( bytes_per_level);
     }
 }
@@ -82,7 +83,7 @@ Image_file_writer_impl::~Image_file_writer_impl()
     mi::Uint32 width  = m_resolution_x;
     mi::Uint32 height = m_resolution_y;
     mi::Uint32 depth  = m_nr_of_layers;
-    mi::Uint32 bytes_per_level = width * height * depth * get_bytes_per_pixel( m_pixel_type);
+    mi::Size bytes_per_level = get_data_size( m_pixel_type, width, height) * depth;
 
     Texture texture;
 
@@ -94,11 +95,12 @@ Image_file_writer_impl::~Image_file_writer_impl()
         width  = std::max( width  / 2, 1u);
         height = std::max( height / 2, 1u);
         depth  = std::max( depth  / 2, 1u);
-        bytes_per_level = width * height * depth * get_bytes_per_pixel( m_pixel_type);
+        bytes_per_level = get_data_size( m_pixel_type, width, height) * depth;
     }
 
     Image image;
-    image.create( m_pixel_type, m_gamma, texture, m_is_cubemap);
+    image.create(
+        m_pixel_type, m_gamma, texture, m_is_cubemap, Image::get_compress_format( m_pixel_type));
     if( !image.save( m_writer)) {
         log( mi::base::MESSAGE_SEVERITY_ERROR,
             "The image plugin \"dds\" failed to export an image.");
@@ -182,8 +184,13 @@ bool Image_file_writer_impl::write(
 
     mi::Uint32 image_width     = get_resolution_x( level);
     mi::Uint32 image_height    = get_resolution_y( level);
-    mi::Uint32 bytes_per_pixel = IMAGE::get_bytes_per_pixel( m_pixel_type);
-    mi::Uint32 bytes_per_layer = image_width * image_height * bytes_per_pixel;
+    mi::Size   bytes_per_layer = get_data_size( m_pixel_type, image_width, image_height);
+
+    // Compressed tiles are passed through as blocks.
+    if( IMAGE::is_compressed_pixel_type( m_pixel_type)) {
+        memcpy( &m_level[level][0] + z * bytes_per_layer, tile->get_data(), bytes_per_layer);
+        return true;
+    }
 
     copy_from_tile_to_dds(
         tile, &m_level[level][0] + z * bytes_per_layer, image_width, image_height);
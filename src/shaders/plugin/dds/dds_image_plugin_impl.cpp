@@ -91,6 +91,17 @@ const char* Image_plugin_impl::get_supported_type( mi::Uint32 index) const
 {
     if( index == 0) return "Rgba";
     if( index == 1) return "Rgb";
+    // Block-compressed pixel types are only exported without conversion (pass-through).
+    if( index == 2) return "Bc1";
+    if( index == 3) return "Bc2";
+    if( index == 4) return "Bc3";
+    if( index == 5) return "Bc4";
+    if( index == 6) return "Bc4s";
+    if( index == 7) return "Bc5";
+    if( index == 8) return "Bc5s";
+    if( index == 9) return "Bc6h";
+    if( index == 10) return "Bc6hs";
+    if( index == 11) return "Bc7";
     return 0;
 }
 
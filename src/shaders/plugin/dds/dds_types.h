@@ -62,6 +62,13 @@ const mi::Uint32 FOURCC_BC4U            = 0x55344342l; // "BC4U" in reverse orde
 const mi::Uint32 FOURCC_BC4S            = 0x53344342l; // "BC4S" in reverse order
 const mi::Uint32 FOURCC_BC5U            = 0x55354342l; // "BC5U" in reverse order
 const mi::Uint32 FOURCC_BC5S            = 0x53354342l; // "BC5S" in reverse order
+const mi::Uint32 FOURCC_ATI1            = 0x31495441l; // "ATI1" in reverse order
+const mi::Uint32 FOURCC_ATI2            = 0x32495441l; // "ATI2" in reverse order
+
+// DX10 header resource dimensions and flags
+const mi::Uint32 DDS_DIMENSION_TEXTURE2D       = 3;
+const mi::Uint32 DDS_DIMENSION_TEXTURE3D       = 4;
+const mi::Uint32 DDS_RESOURCE_MISC_TEXTURECUBE = 0x00000004l;
 
 // floating point formats
 const mi::Uint32 DDSF_R16F              = 111;
@@ -249,29 +256,39 @@ enum Texture_type
 
 enum Dds_compress_fmt {
     DXTC_none,
-    DXTC1,
-    DXTC3,
-    DXTC5
-};
-
-struct DXT_color_block
-{
-    mi::Uint16 m_col0;
-    mi::Uint16 m_col1;
-    mi::Uint8  m_row[4];
+    DXTC1,     // BC1
+    DXTC3,     // BC2
+    DXTC5,     // BC3
+    BC4U,      // one unsigned channel
+    BC4S,      // one signed channel
+    BC5U,      // two unsigned channels
+    BC5S,      // two signed channels
+    BC6HU,     // unsigned half-float RGB
+    BC6HS,     // signed half-float RGB
+    BC7        // RGBA with per-block modes
 };
 
-struct DXT3_alpha_block
+/// Returns the number of bytes per 4x4 block for the given compression format.
+inline mi::Uint32 get_bytes_per_block( Dds_compress_fmt format)
 {
-    mi::Uint16 m_row[4];
-};
-
-struct DXT5_alpha_block
-{
-    mi::Uint8 m_alpha0;
-    mi::Uint8 m_alpha1;
-    mi::Uint8 m_row[6];
-};
+    switch( format) {
+        case DXTC1:
+        case BC4U:
+        case BC4S:
+            return 8;
+        case DXTC3:
+        case DXTC5:
+        case BC5U:
+        case BC5S:
+        case BC6HU:
+        case BC6HS:
+        case BC7:
+            return 16;
+        case DXTC_none:
+            return 0;
+    }
+    return 0;
+}
 
 struct Pixel_format
 {
@@ -35,6 +35,7 @@
 #include <mi/neuraylib/ireader.h>
 #include <mi/neuraylib/itile.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <io/image/image/i_image_utilities.h>
@@ -44,6 +45,157 @@ namespace MI {
 
 namespace FREEIMAGE {
 
+namespace {
+
+/// Returns the flags for FreeImage_LoadFromHandle() and FreeImage_LoadFromMemory().
+int get_load_flags( FREE_IMAGE_FORMAT format)
+{
+    int flags = 0;
+    // Import JPEGs with full accuracy (to get identical results as with the default settings of
+    // the JPEG library).
+    if( format == FIF_JPEG)
+        flags |= JPEG_ACCURATE;
+    // Import PNGs ignoring the gamma value (that is what our old PNG plugin did).
+    if( format == FIF_PNG)
+        flags |= PNG_IGNOREGAMMA;
+    return flags;
+}
+
+/// Iterates the chain of image file directories (IFDs) of a classic or BigTIFF file.
+///
+/// Only the header and the directories are read, not the image data.
+class Tiff_directory_reader
+{
+public:
+    /// Reads the file header and positions the iterator at the first directory.
+    Tiff_directory_reader( mi::neuraylib::IReader* reader)
+      : m_reader( reader), m_big_endian( false), m_big_tiff( false), m_offset( 0)
+    {
+        unsigned char header[16];
+        if( !read( 0, header, 8))
+            return;
+        if( header[0] == 'M' && header[1] == 'M')
+            m_big_endian = true;
+        else if( header[0] != 'I' || header[1] != 'I')
+            return;
+
+        const mi::Uint32 magic = get( header + 2, 2);
+        if( magic == 42) {
+            m_offset = get( header + 4, 4);
+        } else if( magic == 43) {
+            // BigTIFF: offset size 8, reserved 0, followed by the 8-byte offset of the first IFD.
+            if( get( header + 4, 2) != 8 || !read( 8, header + 8, 8))
+                return;
+            m_big_tiff = true;
+            m_offset = get( header + 8, 8);
+        }
+    }
+
+    /// Indicates whether the current directory exists.
+    bool is_valid() const { return m_offset != 0; }
+
+    /// Advances to the next directory. Returns \c false if there is none.
+    bool next()
+    {
+        if( !is_valid())
+            return false;
+        const mi::Uint64 entry_count = get_entry_count();
+        const mi::Uint64 count_size = m_big_tiff ? 8 : 2;
+        const mi::Uint64 entry_size = m_big_tiff ? 20 : 12;
+        unsigned char buffer[8];
+        if( entry_count == 0
+            || !read( m_offset + count_size + entry_count * entry_size, buffer, m_big_tiff ? 8 : 4))
+            m_offset = 0;
+        else
+            m_offset = get( buffer, m_big_tiff ? 8 : 4);
+        return is_valid();
+    }
+
+    /// Returns the values of the ImageWidth and ImageLength tags of the current directory.
+    bool get_resolution( mi::Uint32& width, mi::Uint32& height)
+    {
+        const mi::Uint64 entry_count = get_entry_count();
+        const mi::Uint64 count_size = m_big_tiff ? 8 : 2;
+        const mi::Uint64 entry_size = m_big_tiff ? 20 : 12;
+        bool has_width = false;
+        bool has_height = false;
+
+        // Tags are sorted in ascending order, ImageWidth (256) and ImageLength (257) come early.
+        for( mi::Uint64 i = 0; i < entry_count && !(has_width && has_height); ++i) {
+            unsigned char entry[20];
+            if( !read( m_offset + count_size + i * entry_size, entry, entry_size))
+                return false;
+            const mi::Uint32 tag = get( entry, 2);
+            if( tag > 257)
+                break;
+            if( tag != 256 && tag != 257)
+                continue;
+
+            // The value is stored inline for types SHORT (3), LONG (4), and LONG8 (16).
+            const mi::Uint32 type = get( entry + 2, 2);
+            const unsigned char* value = entry + (m_big_tiff ? 12 : 8);
+            mi::Uint64 result = 0;
+            if( type == 3)
+                result = get( value, 2);
+            else if( type == 4)
+                result = get( value, 4);
+            else if( type == 16 && m_big_tiff)
+                result = get( value, 8);
+            else
+                return false;
+            if( result == 0 || result > 0xffffffffull)
+                return false;
+
+            if( tag == 256) {
+                width = static_cast<mi::Uint32>( result);
+                has_width = true;
+            } else {
+                height = static_cast<mi::Uint32>( result);
+                has_height = true;
+            }
+        }
+
+        return has_width && has_height;
+    }
+
+private:
+    /// Returns the number of entries of the current directory (0 in case of failure).
+    mi::Uint64 get_entry_count()
+    {
+        unsigned char buffer[8];
+        if( !read( m_offset, buffer, m_big_tiff ? 8 : 2))
+            return 0;
+        return get( buffer, m_big_tiff ? 8 : 2);
+    }
+
+    /// Reads \p size bytes at \p offset into \p buffer.
+    bool read( mi::Uint64 offset, unsigned char* buffer, mi::Uint64 size)
+    {
+        if( offset > 0x7fffffffffffffffull || !m_reader->seek_absolute( mi::Sint64( offset)))
+            return false;
+        return m_reader->read( reinterpret_cast<char*>( buffer), mi::Sint64( size))
+            == mi::Sint64( size);
+    }
+
+    /// Decodes an unsigned integer of \p size bytes in the byte order of the file.
+    mi::Uint64 get( const unsigned char* buffer, mi::Uint32 size) const
+    {
+        mi::Uint64 result = 0;
+        for( mi::Uint32 i = 0; i < size; ++i) {
+            const mi::Uint32 j = m_big_endian ? i : size - 1 - i;
+            result = (result << 8) | buffer[j];
+        }
+        return result;
+    }
+
+    mi::neuraylib::IReader* m_reader;
+    bool m_big_endian;
+    bool m_big_tiff;
+    mi::Uint64 m_offset;
+};
+
+} // namespace
+
 Image_file_reader_impl::Image_file_reader_impl(
     mi::neuraylib::IImage_api* image_api,
     mi::neuraylib::IReader* reader,
@@ -54,59 +206,48 @@ Image_file_reader_impl::Image_file_reader_impl(
     m_resolution_y( 1),
     m_format( format),
     m_bitmap( 0),
-    m_bitmap_pixel_type( 0)
+    m_bitmap_pixel_type( 0),
+    m_is_valid( false),
+    m_miplevels( 1)
 {
     FreeImageIO io = construct_io_for_reading();
     m_format = FreeImage_GetFileTypeFromHandle( &io, static_cast<fi_handle>( reader));
     assert( m_format == format);
 
-    int flags = 0;
-    // Import JPEGs with full accuracy (to get identical results as with the default settings of
-    // the JPEG library).
-    if( m_format == FIF_JPEG)
-        flags |= JPEG_ACCURATE;
-    // Import PNGs ignoring the gamma value (that is what our old PNG plugin did).
-    if( m_format == FIF_PNG)
-        flags |= PNG_IGNOREGAMMA;
-    // Delay pixel loading (if supported for this format). Disable delayed pixel loading for TIFF
-    // files (see bug 12086 or https://sourceforge.net/p/freeimage/bugs/233/).
+    // Only probe the header (if supported for this format). Disable delayed pixel loading for TIFF
+    // files (see bug 12086 or https://sourceforge.net/p/freeimage/bugs/233/). For these formats
+    // the loaded pixels are kept for the first call of read().
+    int flags = get_load_flags( m_format);
     if( m_format != FIF_TIFF && FreeImage_FIFSupportsNoPixels( m_format))
         flags |= FIF_LOAD_NOPIXELS;
 
-    m_bitmap = FreeImage_LoadFromHandle(
-        m_format, &io, static_cast<fi_handle>( m_reader.get()), flags);
-
+    m_bitmap = load_bitmap( flags);
     if( !m_bitmap) {
         m_resolution_x = 1;
         m_resolution_y = 1;
         return;
     }
 
+    // The conversion into the pixel type, if needed, is deferred to read().
     bool convert = true; // avoid compiler warning
     m_bitmap_pixel_type = convert_freeimage_pixel_type_to_neuray_pixel_type( m_bitmap, convert);
 
-    if( convert && FreeImage_HasPixels( m_bitmap)) {
-        FIBITMAP* new_bitmap;
-        if( strcmp( m_bitmap_pixel_type, "Rgb") == 0)
-            new_bitmap = FreeImage_ConvertTo24Bits( m_bitmap);
-        else if( strcmp( m_bitmap_pixel_type, "Rgba") == 0)
-            new_bitmap = FreeImage_ConvertTo32Bits( m_bitmap);
-        else if( strcmp( m_bitmap_pixel_type, "Rgb_fp") == 0)
-            new_bitmap = FreeImage_ConvertToRGBF( m_bitmap);
-        else {
-            assert( false);
-            new_bitmap = FreeImage_ConvertToRGBF( m_bitmap);
-        }
-        FreeImage_Unload( m_bitmap);
-        m_bitmap = new_bitmap;
-    }
-
     m_resolution_x = FreeImage_GetWidth( m_bitmap);
     m_resolution_y = FreeImage_GetHeight( m_bitmap);
+    m_is_valid = true;
 
     // For one-dimensional DDS textures the height is incorrectly reported as 0.
     if( format == FIF_DDS && m_resolution_y == 0)
         m_resolution_y = 1;
+
+    // Multi-page TIFF files might store a mipmap pyramid in their pages.
+    if( m_format == FIF_TIFF)
+        m_miplevels = count_miplevels();
+
+    if( !FreeImage_HasPixels( m_bitmap)) {
+        FreeImage_Unload( m_bitmap);
+        m_bitmap = 0;
+    }
 }
 
 Image_file_reader_impl::~Image_file_reader_impl()
@@ -122,28 +263,28 @@ const char* Image_file_reader_impl::get_type() const
 
 mi::Uint32 Image_file_reader_impl::get_resolution_x( mi::Uint32 level) const
 {
-    if( level > 0)
+    if( level >= m_miplevels)
         return 0;
-    return m_resolution_x;
+    return std::max( m_resolution_x >> level, 1u);
 }
 
 mi::Uint32 Image_file_reader_impl::get_resolution_y( mi::Uint32 level) const
 {
-    if( level > 0)
+    if( level >= m_miplevels)
         return 0;
-    return m_resolution_y;
+    return std::max( m_resolution_y >> level, 1u);
 }
 
 mi::Uint32 Image_file_reader_impl::get_layers_size( mi::Uint32 level) const
 {
-    if( level > 0)
+    if( level >= m_miplevels)
         return 0;
     return 1;
 }
 
 mi::Uint32 Image_file_reader_impl::get_miplevels() const
 {
-    return 1;
+    return m_miplevels;
 }
 
 bool Image_file_reader_impl::get_is_cubemap() const
@@ -159,58 +300,103 @@ mi::Float32 Image_file_reader_impl::get_gamma() const
 
 mi::neuraylib::ITile* Image_file_reader_impl::read( mi::Uint32 z, mi::Uint32 level) const
 {
-    if( !m_bitmap || z != 0 || level != 0)
+    if( !m_is_valid || z != 0 || level >= m_miplevels)
         return nullptr;
 
-    if( !FreeImage_HasPixels( m_bitmap)) {
+    mi::base::Lock::Block block( &m_lock);
 
-        FreeImage_Unload( m_bitmap);
+    if( level > 0)
+        return read_page( level);
+
+    // Take the bitmap loaded by the constructor, if any, or decode the image again. The bitmap is
+    // released after its pixels have been copied, such that the image is not kept in memory twice
+    // as long as the tile is alive.
+    FIBITMAP* bitmap = m_bitmap;
+    m_bitmap = 0;
+    if( !bitmap) {
+        bitmap = load_bitmap( get_load_flags( m_format));
+        if( !bitmap)
+            return nullptr;
+    }
 
-        int flags = 0;
-        // Import JPEGs with full accuracy (to get identical results as with the default settings of
-        // the JPEG library).
-        if( m_format == FIF_JPEG)
-            flags |= JPEG_ACCURATE;
-        // Import PNGs ignoring the gamma value (that is what our old PNG plugin did).
-        if( m_format == FIF_PNG)
-            flags |= PNG_IGNOREGAMMA;
+    return create_tile( bitmap, 0, /*release_bitmap*/ true);
+}
 
-        m_reader->seek_absolute( 0);
-        FreeImageIO io = construct_io_for_reading();
-        m_bitmap = FreeImage_LoadFromHandle(
-            m_format, &io, static_cast<fi_handle>( m_reader.get()), flags);
+mi::neuraylib::ITile* Image_file_reader_impl::read_page( mi::Uint32 level) const
+{
+    if( !m_reader->supports_absolute_access())
+        return nullptr;
 
-        if( !m_bitmap)
-            return nullptr;
+    m_reader->seek_absolute( 0);
+    FreeImageIO io = construct_io_for_reading();
+    FIMULTIBITMAP* multi_bitmap = FreeImage_OpenMultiBitmapFromHandle(
+        m_format, &io, static_cast<fi_handle>( m_reader.get()), get_load_flags( m_format));
+    if( !multi_bitmap)
+        return nullptr;
 
-        bool convert = true; // avoid compiler warning
-        const char* pixel_type
-            = convert_freeimage_pixel_type_to_neuray_pixel_type( m_bitmap, convert);
-        assert( strcmp( m_bitmap_pixel_type, pixel_type) == 0);
-        (void) pixel_type;
-
-        if( convert) {
-            FIBITMAP* new_bitmap;
-            if( strcmp( m_bitmap_pixel_type, "Rgb") == 0)
-                new_bitmap = FreeImage_ConvertTo24Bits( m_bitmap);
-            else if( strcmp( m_bitmap_pixel_type, "Rgba") == 0)
-                new_bitmap = FreeImage_ConvertTo32Bits( m_bitmap);
-            else if( strcmp( m_bitmap_pixel_type, "Rgb_fp") == 0)
-                new_bitmap = FreeImage_ConvertToRGBF( m_bitmap);
-            else {
-                assert( false);
-                new_bitmap = FreeImage_ConvertToRGBF( m_bitmap);
-            }
-            FreeImage_Unload( m_bitmap);
-            m_bitmap = new_bitmap;
+    mi::neuraylib::ITile* tile = nullptr;
+    FIBITMAP* bitmap = FreeImage_LockPage( multi_bitmap, static_cast<int>( level));
+    if( bitmap) {
+        tile = create_tile( bitmap, level, /*release_bitmap*/ false);
+        FreeImage_UnlockPage( multi_bitmap, bitmap, FALSE);
+    }
+
+    FreeImage_CloseMultiBitmap( multi_bitmap, 0);
+    return tile;
+}
+
+mi::neuraylib::ITile* Image_file_reader_impl::create_tile(
+    FIBITMAP* bitmap, mi::Uint32 level, bool release_bitmap) const
+{
+    const mi::Uint32 width  = get_resolution_x( level);
+    const mi::Uint32 height = get_resolution_y( level);
+
+    bool convert = true; // avoid compiler warning
+    const char* pixel_type = convert_freeimage_pixel_type_to_neuray_pixel_type( bitmap, convert);
+    bool success = true;
+
+    if( level > 0) {
+        // The pages of multi-page files have been checked for their resolution only. They might
+        // still use a pixel type different from the first page, which is handled by converting
+        // them to the pixel type of the first page (if supported by convert_bitmap()).
+        success = FreeImage_GetWidth( bitmap) == width && FreeImage_GetHeight( bitmap) == height;
+        if( success && strcmp( m_bitmap_pixel_type, pixel_type) != 0) {
+            convert = true;
+            success =    strcmp( m_bitmap_pixel_type, "Rgb"   ) == 0
+                      || strcmp( m_bitmap_pixel_type, "Rgba"  ) == 0
+                      || strcmp( m_bitmap_pixel_type, "Rgb_fp") == 0;
         }
+    } else
+        assert( strcmp( m_bitmap_pixel_type, pixel_type) == 0);
 
+    // Convert palettized and 16 bit images row by row while copying them into the tile. Other
+    // images that need a conversion are converted before the tile is allocated, such that at most
+    // two copies of the image exist at any time.
+    const bool convert_directly = success && convert
+        && supports_direct_conversion( bitmap, m_bitmap_pixel_type);
+    if( success && convert && !convert_directly) {
+        FIBITMAP* new_bitmap = convert_bitmap( bitmap, m_bitmap_pixel_type);
+        if( release_bitmap)
+            FreeImage_Unload( bitmap);
+        bitmap = new_bitmap;
+        release_bitmap = true;
+        success = bitmap != 0;
+    }
+
+    if( !success) {
+        if( bitmap && release_bitmap)
+            FreeImage_Unload( bitmap);
+        return nullptr;
     }
 
     mi::base::Handle<mi::neuraylib::ITile> tile(
-        m_image_api->create_tile( m_bitmap_pixel_type, m_resolution_x, m_resolution_y));
+        m_image_api->create_tile( m_bitmap_pixel_type, width, height));
 
-    bool success = copy_from_bitmap_to_tile( m_bitmap, tile.get());
+    success = convert_directly
+        ? convert_from_bitmap_to_tile( bitmap, tile.get())
+        : copy_from_bitmap_to_tile( bitmap, tile.get());
+    if( release_bitmap)
+        FreeImage_Unload( bitmap);
     if( !success)
         return nullptr;
 
@@ -218,6 +404,69 @@ mi::neuraylib::ITile* Image_file_reader_impl::read( mi::Uint32 z, mi::Uint32 lev
     return tile.get();
 }
 
+mi::Uint32 Image_file_reader_impl::count_miplevels() const
+{
+    if( !m_reader->supports_absolute_access())
+        return 1;
+
+    // Only the resolution of the pages is needed here. Walk the chain of image file directories
+    // (IFDs) of the TIFF file and read the width and height tags instead of opening the file as
+    // multi-page bitmap: FreeImage_LockPage() would decode the pixels of each page since
+    // FIF_LOAD_NOPIXELS is unreliable for TIFF files (see bug 12086 or
+    // https://sourceforge.net/p/freeimage/bugs/233/), and page 0 has already been loaded by the
+    // constructor.
+    Tiff_directory_reader directories( m_reader.get());
+    if( !directories.is_valid())
+        return 1;
+
+    mi::Uint32 miplevels = 1;
+    mi::Uint32 width  = m_resolution_x;
+    mi::Uint32 height = m_resolution_y;
+
+    // Skip page 0. The last miplevel has width and height 1.
+    while( directories.next() && (width > 1 || height > 1)) {
+
+        width  = std::max( width  >> 1, 1u);
+        height = std::max( height >> 1, 1u);
+
+        mi::Uint32 page_width  = 0;
+        mi::Uint32 page_height = 0;
+        if( !directories.get_resolution( page_width, page_height))
+            break;
+        if( page_width != width || page_height != height)
+            break;
+
+        ++miplevels;
+    }
+
+    return miplevels;
+}
+
+FIBITMAP* Image_file_reader_impl::load_bitmap( int flags) const
+{
+    if( m_reader->supports_absolute_access())
+        m_reader->seek_absolute( 0);
+
+    // Decode directly from memory if the reader provides the entire file as lookahead data, e.g.,
+    // for memory-mapped resources in MDL archives.
+    const mi::Sint64 file_size = m_reader->get_file_size();
+    if( m_reader->supports_lookahead() && file_size > 0 && file_size <= 0xffffffffLL) {
+        const char* buffer = nullptr;
+        if( m_reader->lookahead( file_size, &buffer) >= file_size && buffer) {
+            FIMEMORY* memory = FreeImage_OpenMemory(
+                reinterpret_cast<BYTE*>( const_cast<char*>( buffer)),
+                static_cast<DWORD>( file_size));
+            FIBITMAP* bitmap = FreeImage_LoadFromMemory( m_format, memory, flags);
+            FreeImage_CloseMemory( memory);
+            return bitmap;
+        }
+    }
+
+    FreeImageIO io = construct_io_for_reading();
+    return FreeImage_LoadFromHandle(
+        m_format, &io, static_cast<fi_handle>( m_reader.get()), flags);
+}
+
 bool Image_file_reader_impl::write(
     const mi::neuraylib::ITile* tile, mi::Uint32 z, mi::Uint32 level)
 {
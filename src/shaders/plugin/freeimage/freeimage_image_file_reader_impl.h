@@ -79,6 +79,24 @@ public:
         mi::Uint32 level);
 
 private:
+    /// Loads the bitmap from the beginning of #m_reader with the given flags.
+    FIBITMAP* load_bitmap( int flags) const;
+
+    /// Returns the number of miplevels stored as pages of a multi-page file.
+    ///
+    /// Page \c i is considered to be miplevel \c i if the resolutions of all pages up to \c i
+    /// are halved from page to page. Only supported for TIFF files. The resolution of the pages is
+    /// taken from the image file directories, the pages themselves are not loaded.
+    mi::Uint32 count_miplevels() const;
+
+    /// Reads the given page of a multi-page file as miplevel \p level.
+    mi::neuraylib::ITile* read_page( mi::Uint32 level) const;
+
+    /// Copies (and converts, if needed) the bitmap representing miplevel \p level into a new tile.
+    ///
+    /// If \p release_bitmap is \c true, the bitmap is released as early as possible.
+    mi::neuraylib::ITile* create_tile(
+        FIBITMAP* bitmap, mi::Uint32 level, bool release_bitmap) const;
 
     /// API component IImage_api.
     mi::base::Handle<mi::neuraylib::IImage_api> m_image_api;
@@ -95,11 +113,21 @@ private:
     /// The format of the image.
     FREE_IMAGE_FORMAT m_format;
 
-    /// The actual image.
+    /// The image loaded by the constructor for formats without header-only loading, released by
+    /// the first call of read(). \c NULL otherwise.
     mutable FIBITMAP* m_bitmap;
 
-    /// The pixel type of m_bitmap.
+    /// The pixel type of the image (after conversion).
     const char* m_bitmap_pixel_type;
+
+    /// Indicates whether the header of the image could be read.
+    bool m_is_valid;
+
+    /// The number of miplevels in the file.
+    mi::Uint32 m_miplevels;
+
+    /// Serializes read(), which releases #m_bitmap and seeks in the shared #m_reader.
+    mutable mi::base::Lock m_lock;
 };
 
 } // namespace FREEIMAGE
@@ -339,6 +339,114 @@ bool copy_from_bitmap_to_tile( FIBITMAP* bitmap, mi::neuraylib::ITile* tile)
         return false;
 }
 
+FIBITMAP* convert_bitmap( FIBITMAP* bitmap, const char* pixel_type)
+{
+    if( strcmp( pixel_type, "Rgb") == 0)
+        return FreeImage_ConvertTo24Bits( bitmap);
+    if( strcmp( pixel_type, "Rgba") == 0)
+        return FreeImage_ConvertTo32Bits( bitmap);
+    if( strcmp( pixel_type, "Rgb_fp") == 0)
+        return FreeImage_ConvertToRGBF( bitmap);
+
+    assert( false);
+    return FreeImage_ConvertToRGBF( bitmap);
+}
+
+bool supports_direct_conversion( FIBITMAP* bitmap, const char* pixel_type)
+{
+    if( FreeImage_GetImageType( bitmap) != FIT_BITMAP)
+        return false;
+
+    const bool rgb  = strcmp( pixel_type, "Rgb" ) == 0;
+    const bool rgba = strcmp( pixel_type, "Rgba") == 0;
+
+    const unsigned int bpp = FreeImage_GetBPP( bitmap);
+    if( bpp == 1 || bpp == 4 || bpp == 8)
+        return (rgb || rgba) && FreeImage_GetPalette( bitmap);
+    if( bpp == 16)
+        return rgb;
+    return false;
+}
+
+bool convert_from_bitmap_to_tile( FIBITMAP* bitmap, mi::neuraylib::ITile* tile)
+{
+    const char* const pixel_type = tile->get_type();
+    if( !supports_direct_conversion( bitmap, pixel_type))
+        return false;
+
+    // Compute the rectangular region that is to be converted
+    const mi::Uint32 tile_width  = tile->get_resolution_x();
+    const mi::Uint32 tile_height = tile->get_resolution_y();
+    const mi::Uint32 bitmap_width  = FreeImage_GetWidth( bitmap);
+    const mi::Uint32 bitmap_height = FreeImage_GetHeight( bitmap);
+    const mi::Uint32 x_end = std::min( tile_width,  bitmap_width);
+    const mi::Uint32 y_end = std::min( tile_height, bitmap_height);
+
+    const mi::Uint32 bytes_per_pixel = get_bytes_per_pixel( pixel_type);
+    assert( bytes_per_pixel == 3 || bytes_per_pixel == 4);
+    mi::Uint8* const dest_start = static_cast<mi::Uint8*>( tile->get_data());
+    const unsigned int bpp = FreeImage_GetBPP( bitmap);
+
+    if( bpp == 16) {
+
+        // Same expansion of the 5/6 bit components as FreeImage_ConvertTo24Bits().
+        const bool is_565 = FreeImage_GetRedMask( bitmap) == FI16_565_RED_MASK
+            && FreeImage_GetGreenMask( bitmap) == FI16_565_GREEN_MASK
+            && FreeImage_GetBlueMask( bitmap) == FI16_565_BLUE_MASK;
+
+        for( mi::Uint32 y = 0; y < y_end; ++y) {
+            const WORD* src = reinterpret_cast<const WORD*>( FreeImage_GetScanLine( bitmap, y));
+            mi::Uint8* dest = dest_start + static_cast<size_t>( y) * tile_width * 3;
+            for( mi::Uint32 x = 0; x < x_end; ++x, dest += 3) {
+                const WORD c = src[x];
+                if( is_565) {
+                    dest[0] = static_cast<mi::Uint8>(
+                        (((c & FI16_565_RED_MASK) >> FI16_565_RED_SHIFT) * 0xFF) / 0x1F);
+                    dest[1] = static_cast<mi::Uint8>(
+                        (((c & FI16_565_GREEN_MASK) >> FI16_565_GREEN_SHIFT) * 0xFF) / 0x3F);
+                    dest[2] = static_cast<mi::Uint8>(
+                        (((c & FI16_565_BLUE_MASK) >> FI16_565_BLUE_SHIFT) * 0xFF) / 0x1F);
+                } else {
+                    dest[0] = static_cast<mi::Uint8>(
+                        (((c & FI16_555_RED_MASK) >> FI16_555_RED_SHIFT) * 0xFF) / 0x1F);
+                    dest[1] = static_cast<mi::Uint8>(
+                        (((c & FI16_555_GREEN_MASK) >> FI16_555_GREEN_SHIFT) * 0xFF) / 0x1F);
+                    dest[2] = static_cast<mi::Uint8>(
+                        (((c & FI16_555_BLUE_MASK) >> FI16_555_BLUE_SHIFT) * 0xFF) / 0x1F);
+                }
+            }
+        }
+        return true;
+    }
+
+    // Palettized bitmaps: look up the palette, and for "Rgba" the transparency table (same as
+    // FreeImage_ConvertTo32Bits() for transparent bitmaps).
+    const RGBQUAD* palette = FreeImage_GetPalette( bitmap);
+    const BYTE* table = FreeImage_GetTransparencyTable( bitmap);
+    const unsigned int table_size = table ? FreeImage_GetTransparencyCount( bitmap) : 0;
+
+    for( mi::Uint32 y = 0; y < y_end; ++y) {
+        const BYTE* src = FreeImage_GetScanLine( bitmap, y);
+        mi::Uint8* dest = dest_start + static_cast<size_t>( y) * tile_width * bytes_per_pixel;
+        for( mi::Uint32 x = 0; x < x_end; ++x, dest += bytes_per_pixel) {
+            unsigned int index;
+            if( bpp == 8)
+                index = src[x];
+            else if( bpp == 4)
+                index = (x & 1) ? (src[x >> 1] & 0x0F) : (src[x >> 1] >> 4);
+            else
+                index = (src[x >> 3] & (0x80 >> (x & 7))) != 0 ? 1 : 0;
+            const RGBQUAD& c = palette[index];
+            dest[0] = c.rgbRed;
+            dest[1] = c.rgbGreen;
+            dest[2] = c.rgbBlue;
+            if( bytes_per_pixel == 4)
+                dest[3] = index < table_size ? table[index] : 0xFF;
+        }
+    }
+    return true;
+}
+
 bool copy_from_tile_to_bitmap( const mi::neuraylib::ITile* tile, FIBITMAP* bitmap)
 {
     // Compute the rectangular region that is to be copied
@@ -62,6 +62,29 @@ const char* convert_freeimage_pixel_type_to_neuray_pixel_type( FREE_IMAGE_TYPE t
 /// Converts a FreeImage pixel type to a neuray pixel type.
 const char* convert_freeimage_pixel_type_to_neuray_pixel_type( FIBITMAP* bitmap, bool& convert);
 
+/// Converts a bitmap to the given neuray pixel type (one of "Rgb", "Rgba", or "Rgb_fp").
+///
+/// Returns a new bitmap, or \c NULL in case of failure. The passed bitmap is not released.
+FIBITMAP* convert_bitmap( FIBITMAP* bitmap, const char* pixel_type);
+
+/// Indicates whether #convert_from_bitmap_to_tile() supports the given bitmap and pixel type.
+///
+/// This is the case for palettized bitmaps with 1, 4, or 8 bits per pixel, and for 16 bits per
+/// pixel bitmaps converted to "Rgb".
+bool supports_direct_conversion( FIBITMAP* bitmap, const char* pixel_type);
+
+/// Converts a rectangular region of pixels from a FreeImage bitmap to a neuray API tile.
+///
+/// The pixels are converted row by row directly into the tile, i.e., without the intermediate
+/// bitmap created by #convert_bitmap(). The result is identical to converting the bitmap with
+/// #convert_bitmap() and copying it with #copy_from_bitmap_to_tile().
+///
+/// \param bitmap   The FreeImage bitmap to read the pixels from, see
+///                 #supports_direct_conversion().
+/// \param tile     The tile to write the pixels to.
+/// \return         \c true in case of success, \c false otherwise.
+bool convert_from_bitmap_to_tile( FIBITMAP* bitmap, mi::neuraylib::ITile* tile);
+
 /// Copies a rectangular region of pixels from a FreeImage bitmap to a neuray API tile.
 ///
 /// This method assumes that the FreeImage bitmap and the neuray API tile use the same pixel type.